@@ -0,0 +1,175 @@
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+#include "WAVM/Inline/BasicTypes.h"
+#include "WAVM/Inline/GroupedHashTable.h"
+#include "WAVM/Inline/HashMap.h"
+#include "WAVM/Inline/HashSet.h"
+#include "WAVM/Inline/IndexMap.h"
+#include "WAVM/Platform/Clock.h"
+
+using namespace WAVM;
+
+// Compares the HashMap and HashSet operations of the Robin Hood HashTable layout to the
+// GroupedHashTable layout, for string keys like export and symbol names, and for pointer keys like
+// the GC's object sets. IndexMap, which the runtime uses for the IDs of compartment objects, is
+// measured with the Robin Hood layout it is built on. Prints a CSV line for each benchmark with the average time of an operation.
+
+// Each benchmark is repeated until it has run for at least this many microseconds.
+static constexpr U64 minBenchmarkMicroseconds = 200 * 1000;
+
+// The result of the benchmarks is accumulated into this, so the compiler can't remove them.
+static volatile Uptr benchmarkSink = 0;
+
+template<typename Benchmark> static void runBenchmark(const char *name, const char *layout, Uptr numElements, Uptr numOperationsPerRun, Benchmark &&benchmark) {
+    Uptr numRuns = 0;
+    const U64 startTime = Platform::getMonotonicClock();
+    U64 endTime;
+    do {
+        benchmarkSink += benchmark();
+        ++numRuns;
+        endTime = Platform::getMonotonicClock();
+    } while (endTime - startTime < minBenchmarkMicroseconds);
+
+    const double nanosecondsPerOperation = double(endTime - startTime) * 1000.0 / double(numRuns * numOperationsPerRun);
+    printf("%s,%s,%" PRIuPTR ",%.2f\n", name, layout, numElements, nanosecondsPerOperation);
+}
+
+static std::vector<std::string> createStringKeys(Uptr numKeys, const char *prefix) {
+    std::vector<std::string> keys;
+    for (Uptr keyIndex = 0; keyIndex < numKeys; ++keyIndex) {
+        keys.push_back(std::string(prefix) + "_export_name_" + std::to_string(keyIndex));
+    }
+    return keys;
+}
+
+static std::vector<void *> createPointerKeys(Uptr numKeys) {
+    std::vector<void *> keys;
+    for (Uptr keyIndex = 0; keyIndex < numKeys; ++keyIndex) {
+        keys.push_back(reinterpret_cast<void *>((keyIndex + 1) * 48));
+    }
+    return keys;
+}
+
+template<typename AllocPolicy> static void benchmarkStringMap(const char *layout, Uptr numElements) {
+    const std::vector<std::string> keys = createStringKeys(numElements, "present");
+    const std::vector<std::string> missingKeys = createStringKeys(numElements, "missing");
+
+    HashMap<std::string, Uptr, DefaultHashPolicy<std::string>, AllocPolicy> map;
+    for (Uptr keyIndex = 0; keyIndex < numElements; ++keyIndex) {
+        map.addOrFail(keys[keyIndex], keyIndex);
+    }
+
+    runBenchmark("HashMap<std::string>::add", layout, numElements, numElements, [&] {
+        HashMap<std::string, Uptr, DefaultHashPolicy<std::string>, AllocPolicy> addMap;
+        for (Uptr keyIndex = 0; keyIndex < numElements; ++keyIndex) {
+            addMap.add(keys[keyIndex], keyIndex);
+        }
+        return addMap.size();
+    });
+    runBenchmark("HashMap<std::string>::get(hit)", layout, numElements, numElements, [&] {
+        Uptr sum = 0;
+        for (const std::string &key : keys) {
+            sum += *map.get(key);
+        }
+        return sum;
+    });
+    runBenchmark("HashMap<std::string>::get(miss)", layout, numElements, numElements, [&] {
+        Uptr numFound = 0;
+        for (const std::string &key : missingKeys) {
+            numFound += map.get(key) != nullptr;
+        }
+        return numFound;
+    });
+}
+
+template<typename AllocPolicy> static void benchmarkPointerSet(const char *layout, Uptr numElements) {
+    const std::vector<void *> keys = createPointerKeys(numElements * 2);
+
+    HashSet<void *, DefaultHashPolicy<void *>, AllocPolicy> set;
+    for (Uptr keyIndex = 0; keyIndex < numElements; ++keyIndex) {
+        set.addOrFail(keys[keyIndex]);
+    }
+
+    runBenchmark("HashSet<void*>::add", layout, numElements, numElements, [&] {
+        HashSet<void *, DefaultHashPolicy<void *>, AllocPolicy> addSet;
+        for (Uptr keyIndex = 0; keyIndex < numElements; ++keyIndex) {
+            addSet.add(keys[keyIndex]);
+        }
+        return addSet.size();
+    });
+    runBenchmark("HashSet<void*>::contains(hit)", layout, numElements, numElements, [&] {
+        Uptr numFound = 0;
+        for (Uptr keyIndex = 0; keyIndex < numElements; ++keyIndex) {
+            numFound += set.contains(keys[keyIndex]);
+        }
+        return numFound;
+    });
+    runBenchmark("HashSet<void*>::contains(miss)", layout, numElements, numElements, [&] {
+        Uptr numFound = 0;
+        for (Uptr keyIndex = numElements; keyIndex < numElements * 2; ++keyIndex) {
+            numFound += set.contains(keys[keyIndex]);
+        }
+        return numFound;
+    });
+    runBenchmark("HashSet<void*>::remove+add", layout, numElements, numElements * 2, [&] {
+        for (Uptr keyIndex = 0; keyIndex < numElements; ++keyIndex) {
+            set.removeOrFail(keys[keyIndex]);
+            set.addOrFail(keys[keyIndex]);
+        }
+        return set.size();
+    });
+    runBenchmark("HashSet<void*>::iterate", layout, numElements, numElements, [&] {
+        Uptr sum = 0;
+        for (void *element : set) {
+            sum += reinterpret_cast<Uptr>(element);
+        }
+        return sum;
+    });
+}
+
+static void benchmarkIndexMap(Uptr numElements) {
+    IndexMap<Uptr, Uptr> map(0, UINTPTR_MAX - 1);
+    std::vector<Uptr> indices;
+    for (Uptr elementIndex = 0; elementIndex < numElements; ++elementIndex) {
+        indices.push_back(map.add(UINTPTR_MAX, elementIndex));
+    }
+
+    runBenchmark("IndexMap<Uptr>::add", "robinHood", numElements, numElements, [&] {
+        IndexMap<Uptr, Uptr> addMap(0, UINTPTR_MAX - 1);
+        for (Uptr elementIndex = 0; elementIndex < numElements; ++elementIndex) {
+            addMap.add(UINTPTR_MAX, elementIndex);
+        }
+        return addMap.size();
+    });
+    runBenchmark("IndexMap<Uptr>::operator[]", "robinHood", numElements, numElements, [&] {
+        const IndexMap<Uptr, Uptr> &constMap = map;
+        Uptr sum = 0;
+        for (Uptr index : indices) {
+            sum += constMap[index];
+        }
+        return sum;
+    });
+    runBenchmark("IndexMap<Uptr>::remove+insert", "robinHood", numElements, numElements * 2, [&] {
+        for (Uptr elementIndex = 0; elementIndex < numElements; ++elementIndex) {
+            map.removeOrFail(indices[elementIndex]);
+            map.insertOrFail(indices[elementIndex], elementIndex);
+        }
+        return map.size();
+    });
+}
+
+int main(int argc, char **argv) {
+    printf("benchmark,layout,numElements,nanosecondsPerOperation\n");
+    for (Uptr numElements : {Uptr(16), Uptr(1000), Uptr(100000)}) {
+        benchmarkStringMap<DefaultHashTableAllocPolicy>("robinHood", numElements);
+        benchmarkStringMap<GroupedHashTableAllocPolicy>("grouped", numElements);
+        benchmarkPointerSet<DefaultHashTableAllocPolicy>("robinHood", numElements);
+        benchmarkPointerSet<GroupedHashTableAllocPolicy>("grouped", numElements);
+        benchmarkIndexMap(numElements);
+    }
+    return EXIT_SUCCESS;
+}
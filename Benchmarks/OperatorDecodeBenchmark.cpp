@@ -0,0 +1,151 @@
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "WAVM/IR/Operators.h"
+#include "WAVM/IR/Types.h"
+#include "WAVM/Inline/BasicTypes.h"
+#include "WAVM/Inline/Serialization.h"
+#include "WAVM/Platform/Clock.h"
+
+using namespace WAVM;
+using namespace WAVM::IR;
+
+// Compares the size and decoding throughput of the fixed and compact operator encodings, for a
+// pseudo-random sequence of operators with a mix and immediate values like typical compiled code.
+// Prints a CSV line for each encoding with the average size and decoding time of an operator.
+
+// Each benchmark is repeated until it has run for at least this many microseconds.
+static constexpr U64 minBenchmarkMicroseconds = 200 * 1000;
+
+// The result of the benchmarks is accumulated into this, so the compiler can't remove them.
+static volatile Uptr benchmarkSink = 0;
+
+// A linear congruential generator, so that both encodings are given the same operators.
+struct Random {
+    Random(U64 inState) : state(inState) {
+    }
+
+    U32 next(U32 range) {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        return U32((state >> 33) % range);
+    }
+
+private:
+    U64 state;
+};
+
+template<typename Encoding> static std::vector<U8> encodeOperators(Uptr numOperators) {
+    Serialization::ArrayOutputStream byteStream;
+    BasicOperatorEncoderStream<Encoding> encoder(byteStream);
+    Random random(1);
+    for (Uptr operatorIndex = 0; operatorIndex < numOperators; ++operatorIndex) {
+        const U32 kind = random.next(100);
+        if (kind < 25) {
+            encoder.get_local({random.next(16)});
+        } else if (kind < 32) {
+            encoder.set_local({random.next(16)});
+        } else if (kind < 36) {
+            encoder.tee_local({random.next(16)});
+        } else if (kind < 46) {
+            encoder.i32_const({I32(random.next(2048)) - 1024});
+        } else if (kind < 48) {
+            encoder.i64_const({I64(random.next(UINT32_MAX)) << 8});
+        } else if (kind < 49) {
+            encoder.f64_const({F64(random.next(1000)) * 0.5});
+        } else if (kind < 62) {
+            encoder.i32_add();
+        } else if (kind < 66) {
+            encoder.i32_and_();
+        } else if (kind < 69) {
+            encoder.i32_eqz();
+        } else if (kind < 76) {
+            encoder.i32_load({2, random.next(64) * 4});
+        } else if (kind < 80) {
+            encoder.i32_store({2, random.next(64) * 4});
+        } else if (kind < 82) {
+            encoder.i32_load8_u({0, random.next(256)});
+        } else if (kind < 86) {
+            encoder.br_if({random.next(4)});
+        } else if (kind < 87) {
+            encoder.br({random.next(4)});
+        } else if (kind < 91) {
+            encoder.call({random.next(500)});
+        } else if (kind < 92) {
+            encoder.get_global({random.next(4)});
+        } else if (kind < 95) {
+            ControlStructureImm imm;
+            imm.type.format = IndexedBlockType::noParametersOrResult;
+            encoder.block(imm);
+        } else if (kind < 96) {
+            ControlStructureImm imm;
+            imm.type.format = IndexedBlockType::noParametersOrResult;
+            encoder.loop(imm);
+        } else {
+            encoder.end();
+        }
+    }
+    return byteStream.getBytes();
+}
+
+// Accumulates a checksum of the decoded immediates, so the decoder can't skip decoding them.
+struct ChecksumVisitor {
+    typedef void Result;
+
+    Uptr checksum = 0;
+
+    template<typename Imm> void visitImm(const Imm &imm) {
+        U64 bits = 0;
+        memcpy(&bits, &imm, sizeof(Imm) < sizeof(bits) ? sizeof(Imm) : sizeof(bits));
+        checksum += Uptr(bits);
+    }
+
+    void visitImm(const NoImm &imm) {
+        ++checksum;
+    }
+
+#define VISIT_OPCODE(_, name, nameString, Imm, ...)                                                \
+    void name(Imm imm)                                                                             \
+    {                                                                                              \
+        visitImm(imm);                                                                             \
+    }
+    ENUM_OPERATORS(VISIT_OPCODE)
+#undef VISIT_OPCODE
+
+    void unknown(Opcode opcode) {
+        abort();
+    }
+};
+
+template<typename Encoding> static void benchmarkDecode(const char *encodingName, Uptr numOperators) {
+    const std::vector<U8> codeBytes = encodeOperators<Encoding>(numOperators);
+
+    Uptr numRuns = 0;
+    const U64 startTime = Platform::getMonotonicClock();
+    U64 endTime;
+    do {
+        ChecksumVisitor visitor;
+        BasicOperatorDecoderStream<Encoding> decoder(codeBytes.data(), codeBytes.size());
+        while (decoder) {
+            decoder.decodeOp(visitor);
+        };
+        benchmarkSink += visitor.checksum;
+        ++numRuns;
+        endTime = Platform::getMonotonicClock();
+    } while (endTime - startTime < minBenchmarkMicroseconds);
+
+    const double bytesPerOperator = double(codeBytes.size()) / double(numOperators);
+    const double nanosecondsPerOperator = double(endTime - startTime) * 1000.0 / double(numRuns * numOperators);
+    printf("decode,%s,%" PRIuPTR ",%.2f,%.2f\n", encodingName, numOperators, bytesPerOperator, nanosecondsPerOperator);
+}
+
+int main(int argc, char **argv) {
+    printf("benchmark,encoding,numOperators,bytesPerOperator,nanosecondsPerOperator\n");
+    for (Uptr numOperators : {Uptr(1000), Uptr(1000000)}) {
+        benchmarkDecode<FixedOperatorEncoding>("fixed", numOperators);
+        benchmarkDecode<CompactOperatorEncoding>("compact", numOperators);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,288 @@
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "WAVM/IR/Module.h"
+#include "WAVM/IR/Types.h"
+#include "WAVM/IR/Value.h"
+#include "WAVM/Inline/BasicTypes.h"
+#include "WAVM/LLVMJIT/LLVMJIT.h"
+#include "WAVM/Platform/Clock.h"
+#include "WAVM/Platform/Memory.h"
+#include "WAVM/Runtime/Runtime.h"
+#include "WAVM/WASTParse/WASTParse.h"
+
+using namespace WAVM;
+using namespace WAVM::IR;
+using namespace WAVM::Runtime;
+
+// Measures the runtime's hot paths: invoking guest functions, instantiating modules, and guest code
+// that calls through tables and accesses linear memory. Prints a CSV line for each benchmark with
+// the benchmark's name, its parameter, and the measured value and unit.
+
+// Each benchmark is repeated until it has run for at least this many microseconds.
+static constexpr U64 minBenchmarkMicroseconds = 200 * 1000;
+
+// The result of the benchmarks is accumulated into this, so the compiler can't remove them.
+static volatile Uptr benchmarkSink = 0;
+
+static const char benchmarkModuleText[] = R"(
+(module
+  (type $unary (func (param i32) (result i32)))
+  (memory (export "memory") 16 65536)
+  (table 2 2 anyfunc)
+  (elem (i32.const 0) $identity $increment)
+
+  (func $identity (export "identity") (param i32) (result i32)
+    (get_local 0))
+
+  (func $increment (param i32) (result i32)
+    (i32.add (get_local 0) (i32.const 1)))
+
+  (func (export "callIndirect") (param $numCalls i32) (result i32)
+    (local $i i32)
+    (local $sum i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $i) (get_local $numCalls)))
+        (set_local $sum (i32.add (get_local $sum)
+          (call_indirect (type $unary) (get_local $i) (i32.and (get_local $i) (i32.const 1)))))
+        (set_local $i (i32.add (get_local $i) (i32.const 1)))
+        (br $loop)))
+    (get_local $sum))
+
+  (func (export "store") (param $numBytes i32) (result i32)
+    (local $address i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $address) (get_local $numBytes)))
+        (i64.store (get_local $address) (i64.extend_u/i32 (get_local $address)))
+        (set_local $address (i32.add (get_local $address) (i32.const 8)))
+        (br $loop)))
+    (get_local $address))
+
+  (func (export "load") (param $numBytes i32) (result i32)
+    (local $address i32)
+    (local $sum i64)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $address) (get_local $numBytes)))
+        (set_local $sum (i64.add (get_local $sum) (i64.load (get_local $address))))
+        (set_local $address (i32.add (get_local $address) (i32.const 8)))
+        (br $loop)))
+    (i32.wrap/i64 (get_local $sum)))
+)
+)";
+
+static void printResult(const char *name, const char *parameter, double value, const char *unit) {
+    printf("%s,%s,%.2f,%s\n", name, parameter, value, unit);
+}
+
+// Repeats a benchmark until it has run for minBenchmarkMicroseconds or maxRuns times, and returns
+// the average microseconds of a run. The benchmarks that leak an object on each run, like
+// createCompartment, use maxRuns to bound the leak.
+template<typename Benchmark> static double timeBenchmark(Uptr maxRuns, Benchmark &&benchmark) {
+    Uptr numRuns = 0;
+    const U64 startTime = Platform::getMonotonicClock();
+    U64 endTime;
+    do {
+        benchmarkSink += benchmark();
+        ++numRuns;
+        endTime = Platform::getMonotonicClock();
+    } while (endTime - startTime < minBenchmarkMicroseconds && numRuns < maxRuns);
+    return double(endTime - startTime) / double(numRuns);
+}
+
+template<typename Benchmark> static void runLatencyBenchmark(const char *name, const char *parameter, Uptr numOperationsPerRun, Uptr maxRuns, Benchmark &&benchmark) {
+    const double microsecondsPerRun = timeBenchmark(maxRuns, std::forward<Benchmark>(benchmark));
+    printResult(name, parameter, microsecondsPerRun * 1000.0 / double(numOperationsPerRun), "ns/op");
+}
+
+template<typename Benchmark> static void runThroughputBenchmark(const char *name, const char *parameter, Uptr numBytesPerRun, Benchmark &&benchmark) {
+    const double microsecondsPerRun = timeBenchmark(UINTPTR_MAX, std::forward<Benchmark>(benchmark));
+    printResult(name, parameter, double(numBytesPerRun) / microsecondsPerRun, "MB/s");
+}
+
+static Function *getExportedFunction(ModuleInstance *moduleInstance, const char *name) {
+    Function *function = asFunctionNullable(getInstanceExport(moduleInstance, name));
+    if (!function) {
+        fprintf(stderr, "The benchmark module doesn't export %s\n", name);
+        exit(EXIT_FAILURE);
+    }
+    return function;
+}
+
+static void benchmarkInvoke(Context *context, ModuleInstance *moduleInstance) {
+    Function *identity = getExportedFunction(moduleInstance, "identity");
+
+    constexpr Uptr numCallsPerRun = 1000;
+    runLatencyBenchmark("invokeFunctionChecked", "i32->i32", numCallsPerRun, UINTPTR_MAX, [&] {
+        Uptr sum = 0;
+        for (Uptr callIndex = 0; callIndex < numCallsPerRun; ++callIndex) {
+            sum += Uptr(invokeFunctionChecked(context, identity, {Value(I32(callIndex))})[0].i32);
+        }
+        return sum;
+    });
+    runLatencyBenchmark("invokeFunctionUnchecked", "i32->i32", numCallsPerRun, UINTPTR_MAX, [&] {
+        Uptr sum = 0;
+        for (Uptr callIndex = 0; callIndex < numCallsPerRun; ++callIndex) {
+            UntaggedValue argument = I32(callIndex);
+            sum += Uptr(invokeFunctionUnchecked(context, identity, &argument)->i32);
+        }
+        return sum;
+    });
+}
+
+static void benchmarkInvokeThunkContention(ModuleInstance *moduleInstance) {
+    const FunctionType functionType = getFunctionType(getExportedFunction(moduleInstance, "identity"));
+
+    // Each thread looks up the thunk for the same function type, which is the common case of a host
+    // calling the same export from a pool of threads.
+    constexpr Uptr numLookupsPerThread = 100000;
+    for (Uptr numThreads : {Uptr(1), Uptr(2), Uptr(4), Uptr(8)}) {
+        const std::string parameter = std::to_string(numThreads) + " threads";
+        runLatencyBenchmark("getInvokeThunk", parameter.c_str(), numLookupsPerThread * numThreads, UINTPTR_MAX, [&] {
+            std::atomic<Uptr> sum{0};
+            std::vector<std::thread> threads;
+            for (Uptr threadIndex = 0; threadIndex < numThreads; ++threadIndex) {
+                threads.emplace_back([&] {
+                    Uptr threadSum = 0;
+                    for (Uptr lookupIndex = 0; lookupIndex < numLookupsPerThread; ++lookupIndex) {
+                        threadSum += reinterpret_cast<Uptr>(LLVMJIT::getInvokeThunk(functionType));
+                    }
+                    sum.fetch_add(threadSum, std::memory_order_relaxed);
+                });
+            }
+            for (std::thread &thread : threads) {
+                thread.join();
+            }
+            return sum.load(std::memory_order_relaxed);
+        });
+    }
+}
+
+static void benchmarkCreation(ModuleConstRefParam module) {
+    // Compartments are never deleted, and each reserves address space for its runtime data, so only
+    // a bounded number of them are created.
+    runLatencyBenchmark("createCompartment", "", 1, 256, [&] {
+        return reinterpret_cast<Uptr>(createCompartment());
+    });
+
+    Compartment *compartment = createCompartment();
+
+    constexpr Uptr numContextsPerRun = 100;
+    runLatencyBenchmark("createContext", "", numContextsPerRun, 100, [&] {
+        Uptr sum = 0;
+        for (Uptr contextIndex = 0; contextIndex < numContextsPerRun; ++contextIndex) {
+            sum += reinterpret_cast<Uptr>(createContext(compartment));
+        }
+        return sum;
+    });
+    collectGarbage(compartment);
+
+    // Collect the instances every few runs, so their memories don't accumulate.
+    Uptr numInstances = 0;
+    runLatencyBenchmark("instantiateModule", "", 1, UINTPTR_MAX, [&] {
+        ModuleInstance *moduleInstance = instantiateModule(compartment, module, {}, "benchmark");
+        if (++numInstances % 64 == 0) {
+            collectGarbage(compartment);
+        }
+        return reinterpret_cast<Uptr>(moduleInstance);
+    });
+    collectGarbage(compartment);
+}
+
+static void benchmarkCallIndirect(Context *context, ModuleInstance *moduleInstance) {
+    Function *callIndirect = getExportedFunction(moduleInstance, "callIndirect");
+
+    constexpr Uptr numCallsPerRun = 1000000;
+    runLatencyBenchmark("call_indirect", "i32->i32", numCallsPerRun, UINTPTR_MAX, [&] {
+        UntaggedValue argument = U32(numCallsPerRun);
+        return Uptr(invokeFunctionUnchecked(context, callIndirect, &argument)->i32);
+    });
+}
+
+static void benchmarkMemoryAccess(Context *context, ModuleInstance *moduleInstance) {
+    Function *store = getExportedFunction(moduleInstance, "store");
+    Function *load = getExportedFunction(moduleInstance, "load");
+
+    // The instance's memory has 16 pages, so the largest size fits without growing it.
+    for (Uptr numBytes : {Uptr(64 * 1024), Uptr(1024 * 1024)}) {
+        const std::string parameter = std::to_string(numBytes / 1024) + "KB";
+        runThroughputBenchmark("i64.store", parameter.c_str(), numBytes, [&] {
+            UntaggedValue argument = U32(numBytes);
+            return Uptr(invokeFunctionUnchecked(context, store, &argument)->i32);
+        });
+        runThroughputBenchmark("i64.load", parameter.c_str(), numBytes, [&] {
+            UntaggedValue argument = U32(numBytes);
+            return Uptr(invokeFunctionUnchecked(context, load, &argument)->i32);
+        });
+    }
+}
+
+static void benchmarkMemoryGrow() {
+    Compartment *compartment = createCompartment();
+
+    // Each run grows a new memory one page at a time, since a memory can't shrink.
+    constexpr Uptr numGrowsPerRun = 1024;
+    runLatencyBenchmark("memory.grow", "1 page", numGrowsPerRun, UINTPTR_MAX, [&] {
+        Memory *memory = createMemory(compartment, MemoryType(false, SizeConstraints{0, 65536}), "benchmark");
+        Uptr sum = 0;
+        for (Uptr growIndex = 0; growIndex < numGrowsPerRun; ++growIndex) {
+            sum += Uptr(growMemory(memory, 1));
+        }
+        collectGarbage(compartment);
+        return sum;
+    });
+}
+
+static void benchmarkBulkMemory() {
+    // The sizes span each of the kernels' tiers, up to a size larger than most caches.
+    constexpr Uptr maxNumBytes = 64 * 1024 * 1024;
+    std::vector<U8> source(maxNumBytes, 1);
+    std::vector<U8> dest(maxNumBytes);
+    for (Uptr numBytes : {Uptr(256), Uptr(4 * 1024), Uptr(256 * 1024), Uptr(maxNumBytes)}) {
+        const std::string parameter = numBytes >= 1024 * 1024 ? std::to_string(numBytes / (1024 * 1024)) + "MB" : numBytes >= 1024 ? std::to_string(numBytes / 1024) + "KB" : std::to_string(numBytes) + "B";
+        runThroughputBenchmark("memory.copy", parameter.c_str(), numBytes, [&] {
+            Platform::copyMemoryBytes(dest.data(), source.data(), numBytes);
+            return Uptr(dest[numBytes - 1]);
+        });
+        runThroughputBenchmark("memory.fill", parameter.c_str(), numBytes, [&] {
+            Platform::fillMemoryBytes(dest.data(), 2, numBytes);
+            return Uptr(dest[numBytes - 1]);
+        });
+    }
+}
+
+int main(int argc, char **argv) {
+    IR::Module irModule;
+    if (!WAST::parseModule(benchmarkModuleText, sizeof(benchmarkModuleText), irModule)) {
+        fprintf(stderr, "Couldn't parse the benchmark module\n");
+        return EXIT_FAILURE;
+    }
+    ModuleRef module = compileModule(irModule);
+
+    Compartment *compartment = createCompartment();
+    Context *context = createContext(compartment);
+    ModuleInstance *moduleInstance = instantiateModule(compartment, module, {}, "benchmark");
+    if (!context || !moduleInstance) {
+        fprintf(stderr, "Couldn't instantiate the benchmark module\n");
+        return EXIT_FAILURE;
+    }
+    addGCRoot(asObject(context));
+    addGCRoot(asObject(moduleInstance));
+
+    printf("benchmark,parameter,value,unit\n");
+    benchmarkInvoke(context, moduleInstance);
+    benchmarkInvokeThunkContention(moduleInstance);
+    benchmarkCreation(module);
+    benchmarkCallIndirect(context, moduleInstance);
+    benchmarkMemoryAccess(context, moduleInstance);
+    benchmarkMemoryGrow();
+    benchmarkBulkMemory();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,153 @@
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+
+#include "Lexer.h"
+#include "WAVM/IR/Module.h"
+#include "WAVM/Inline/BasicTypes.h"
+#include "WAVM/NFA/NFA.h"
+#include "WAVM/Platform/Clock.h"
+#include "WAVM/WASTParse/WASTParse.h"
+
+using namespace WAVM;
+using namespace WAVM::WAST;
+
+// Measures the throughput of lexing and parsing WebAssembly text, for a generated module with a mix
+// of instructions like the text format of compiled code. Prints a CSV line for each benchmark with
+// the benchmark's name, its parameter, and the measured value and unit.
+
+// Each benchmark is repeated until it has run for at least this many microseconds.
+static constexpr U64 minBenchmarkMicroseconds = 200 * 1000;
+
+// The result of the benchmarks is accumulated into this, so the compiler can't remove them.
+static volatile Uptr benchmarkSink = 0;
+
+template<typename Benchmark> static void runThroughputBenchmark(const char *name, const char *parameter, Uptr numBytesPerRun, Benchmark &&benchmark) {
+    Uptr numRuns = 0;
+    const U64 startTime = Platform::getMonotonicClock();
+    U64 endTime;
+    do {
+        benchmarkSink += benchmark();
+        ++numRuns;
+        endTime = Platform::getMonotonicClock();
+    } while (endTime - startTime < minBenchmarkMicroseconds);
+
+    const double megabytesPerSecond = double(numBytesPerRun) * double(numRuns) / double(endTime - startTime);
+    printf("%s,%s,%.2f,MB/s\n", name, parameter, megabytesPerSecond);
+}
+
+// Generates the text of a module with the given number of functions. The string includes the null
+// terminator that the lexer requires.
+static std::string generateModuleText(Uptr numFunctions) {
+    std::string text = "(module\n  (memory 1)\n";
+    for (Uptr functionIndex = 0; functionIndex < numFunctions; ++functionIndex) {
+        const std::string index = std::to_string(functionIndex);
+        text += "  (func $f" + index + " (param $a i32) (param $b i32) (result i32)\n";
+        text += "    (local $sum i32)\n";
+        text += "    (set_local $sum (i32.add (get_local $a) (i32.const " + index + ")))\n";
+        text += "    (block $done\n";
+        text += "      (br_if $done (i32.eqz (get_local $b)))\n";
+        text += "      (i32.store offset=16 (get_local $a) (i32.mul (get_local $sum) (get_local $b)))\n";
+        text += "      (set_local $sum (i32.load8_u offset=4 (get_local $b))))\n";
+        text += "    (f64.store (i32.const 8) (f64.const 1.5e" + std::to_string(functionIndex % 16) + "))\n";
+        text += "    (get_local $sum))\n";
+    }
+    text += ")\n";
+    text += '\0';
+    return text;
+}
+
+// Generates the text of a module with the given number of functions that each store many float
+// constants, like the text format of numeric code. The string includes the null terminator that the
+// lexer requires.
+static std::string generateConstantModuleText(Uptr numFunctions) {
+    std::string text = "(module\n  (memory 1)\n";
+    char constantText[64];
+    for (Uptr functionIndex = 0; functionIndex < numFunctions; ++functionIndex) {
+        text += "  (func $f" + std::to_string(functionIndex) + "\n";
+        for (Uptr constantIndex = 0; constantIndex < 16; ++constantIndex) {
+            const double value = double(functionIndex * 16 + constantIndex + 1) / 7.0;
+            if (constantIndex % 4 == 3) {
+                snprintf(constantText, sizeof(constantText), "%a", value);
+            } else {
+                snprintf(constantText, sizeof(constantText), "%.17g", value);
+            }
+            text += "    (f64.store (i32.const 8) (f64.const " + std::string(constantText) + "))\n";
+            snprintf(constantText, sizeof(constantText), "%.9g", value * 1e-20);
+            text += "    (f32.store (i32.const 16) (f32.const " + std::string(constantText) + "))\n";
+        }
+        text += "  )\n";
+    }
+    text += ")\n";
+    text += '\0';
+    return text;
+}
+
+// Feeds a text through a DFA token by token, skipping the spaces and newlines between them like the
+// lexer, and returns a sum of the terminal states that were reached.
+template<typename Machine> static Uptr feedTokens(const Machine &machine, const std::string &text) {
+    const char *nextChar = text.c_str();
+    const char *end = nextChar + text.size() - 1;
+    Uptr terminalStateSum = 0;
+    while (nextChar < end) {
+        if (*nextChar == ' ' || *nextChar == '\n') {
+            ++nextChar;
+            continue;
+        }
+        const NFA::StateIndex terminalState = machine.feed(nextChar);
+        terminalStateSum += Uptr(U16(terminalState));
+        if (terminalState == NFA::unmatchedCharacterTerminal) {
+            ++nextChar;
+        }
+    }
+    return terminalStateSum;
+}
+
+int main(int argc, char **argv) {
+    printf("benchmark,parameter,value,unit\n");
+
+    const NFA::Machine lexerMachine = createLexerMachine();
+    const NFA::CompactMachine compactLexerMachine(lexerMachine);
+    for (Uptr numFunctions : {Uptr(100), Uptr(10000)}) {
+        const std::string text = generateModuleText(numFunctions);
+        const std::string parameter = std::to_string(numFunctions) + " functions";
+
+        runThroughputBenchmark("WAST::lex", parameter.c_str(), text.size(), [&] {
+            LineInfo *lineInfo = nullptr;
+            Token *tokens = lex(text.c_str(), text.size(), lineInfo);
+            const Uptr firstTokenType = Uptr(tokens[0].type);
+            freeTokens(tokens);
+            freeLineInfo(lineInfo);
+            return firstTokenType;
+        });
+
+        runThroughputBenchmark("NFA::Machine::feed", parameter.c_str(), text.size(), [&] {
+            return feedTokens(lexerMachine, text);
+        });
+
+        runThroughputBenchmark("NFA::CompactMachine::feed", parameter.c_str(), text.size(), [&] {
+            return feedTokens(compactLexerMachine, text);
+        });
+
+        runThroughputBenchmark("WAST::parseModule", parameter.c_str(), text.size(), [&] {
+            IR::Module irModule;
+            if (!parseModule(text.c_str(), text.size(), irModule)) {
+                fprintf(stderr, "Couldn't parse the generated module\n");
+                exit(EXIT_FAILURE);
+            }
+            return irModule.functions.defs.size();
+        });
+
+        const std::string constantText = generateConstantModuleText(numFunctions);
+        runThroughputBenchmark("WAST::parseModule constants", parameter.c_str(), constantText.size(), [&] {
+            IR::Module irModule;
+            if (!parseModule(constantText.c_str(), constantText.size(), irModule)) {
+                fprintf(stderr, "Couldn't parse the generated module\n");
+                exit(EXIT_FAILURE);
+            }
+            return irModule.functions.defs.size();
+        });
+    }
+    return EXIT_SUCCESS;
+}
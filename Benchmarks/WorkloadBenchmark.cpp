@@ -0,0 +1,159 @@
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "WAVM/IR/Module.h"
+#include "WAVM/IR/Validate.h"
+#include "WAVM/IR/Value.h"
+#include "WAVM/Inline/BasicTypes.h"
+#include "WAVM/LLVMJIT/LLVMJIT.h"
+#include "WAVM/Platform/Clock.h"
+#include "WAVM/Runtime/Runtime.h"
+#include "WAVM/WASTParse/WASTParse.h"
+
+using namespace WAVM;
+using namespace WAVM::IR;
+using namespace WAVM::Runtime;
+
+// Runs the workload .wast files given on the command line, such as those in Benchmarks/Workloads,
+// at each JIT optimization level. A workload is a module without imports that exports a run
+// function with no parameters and an i32 result. Prints a CSV line for each workload and
+// optimization level with the time to parse, validate and compile the module, the size of its
+// object code, and the median time of a call to run after a warm-up call.
+
+static constexpr Uptr defaultNumRunIterations = 10;
+
+static const char *const optimizationLevelNames[] = {"O0", "O1", "O2", "O3"};
+
+static bool readTextFile(const char *filename, std::vector<char> &outText) {
+    FILE *file = fopen(filename, "rb");
+    if (!file) {
+        fprintf(stderr, "Couldn't read %s\n", filename);
+        return false;
+    }
+    char buffer[65536];
+    Uptr numBytesRead;
+    while ((numBytesRead = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        outText.insert(outText.end(), buffer, buffer + numBytesRead);
+    }
+    fclose(file);
+
+    // The text parser requires the text to be null-terminated.
+    outText.push_back(0);
+    return true;
+}
+
+static U64 getMedian(std::vector<U64> samples) {
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+static bool runWorkload(const char *filename, Uptr numRunIterations) {
+    std::vector<char> text;
+    if (!readTextFile(filename, text)) {
+        return false;
+    }
+
+    U64 startTime = Platform::getMonotonicClock();
+    IR::Module irModule;
+    if (!WAST::parseModule(text.data(), text.size(), irModule)) {
+        fprintf(stderr, "Couldn't parse %s\n", filename);
+        return false;
+    }
+    const U64 parseMicroseconds = Platform::getMonotonicClock() - startTime;
+
+    startTime = Platform::getMonotonicClock();
+    try {
+        DeferredCodeValidationState deferredCodeValidationState;
+        validatePreCodeSections(irModule);
+        validateFunctionDefs(irModule, deferredCodeValidationState);
+        validatePostCodeSections(irModule, deferredCodeValidationState);
+    } catch (const ValidationException &exception) {
+        fprintf(stderr, "Couldn't validate %s: %s\n", filename, exception.message.c_str());
+        return false;
+    }
+    const U64 validateMicroseconds = Platform::getMonotonicClock() - startTime;
+
+    // Name the workload by the file name without its directory or extension.
+    std::string workloadName = filename;
+    const Uptr lastSlashIndex = workloadName.find_last_of("/\\");
+    if (lastSlashIndex != std::string::npos) {
+        workloadName = workloadName.substr(lastSlashIndex + 1);
+    }
+    const Uptr extensionIndex = workloadName.rfind(".wast");
+    if (extensionIndex != std::string::npos) {
+        workloadName = workloadName.substr(0, extensionIndex);
+    }
+
+    for (Uptr levelIndex = 0; levelIndex < 4; ++levelIndex) {
+        // Each level's module is destroyed before the next level is compiled, so the in-process
+        // module cache doesn't return it.
+        LLVMJIT::CompileOptions compileOptions;
+        compileOptions.optimizationLevel = LLVMJIT::OptimizationLevel(levelIndex);
+        startTime = Platform::getMonotonicClock();
+        ModuleRef module = Runtime::compileModule(irModule, compileOptions);
+        const U64 compileMicroseconds = Platform::getMonotonicClock() - startTime;
+        const Uptr numObjectCodeBytes = getModuleObjectCodeSize(module);
+
+        Compartment *compartment = createCompartment();
+        Context *context = createContext(compartment);
+        ModuleInstance *moduleInstance = instantiateModule(compartment, module, {}, std::string(workloadName));
+        Function *runFunction = moduleInstance ? asFunctionNullable(getInstanceExport(moduleInstance, "run")) : nullptr;
+        if (!context || !runFunction || getFunctionType(runFunction) != FunctionType(TypeTuple(ValueType::i32), TypeTuple())) {
+            fprintf(stderr, "%s doesn't export a run function of type () -> i32\n", filename);
+            return false;
+        }
+
+        // Call the run function once before timing it, so the timed calls measure the steady state
+        // of the workload instead of the first accesses to its code and memory.
+        std::vector<U64> runMicroseconds;
+        bool trapped = false;
+        for (Uptr iterationIndex = 0; iterationIndex <= numRunIterations && !trapped; ++iterationIndex) {
+            startTime = Platform::getMonotonicClock();
+            trapped = catchTraps([&] { invokeFunctionChecked(context, runFunction, {}); }, [&](const Trap &trap) {
+                fprintf(stderr, "%s trapped\n", filename);
+            });
+            if (iterationIndex > 0) {
+                runMicroseconds.push_back(Platform::getMonotonicClock() - startTime);
+            }
+        }
+        if (trapped) {
+            return false;
+        }
+
+        printf("%s,%s,%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIuPTR ",%" PRIu64 "\n", workloadName.c_str(), optimizationLevelNames[levelIndex], parseMicroseconds, validateMicroseconds, compileMicroseconds, numObjectCodeBytes, getMedian(runMicroseconds));
+        fflush(stdout);
+
+        module.reset();
+        collectGarbage(compartment);
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    Uptr numRunIterations = defaultNumRunIterations;
+    std::vector<const char *> filenames;
+    for (int argIndex = 1; argIndex < argc; ++argIndex) {
+        if (!strcmp(argv[argIndex], "--iterations") && argIndex + 1 < argc && atoi(argv[argIndex + 1]) > 0) {
+            numRunIterations = Uptr(atoi(argv[++argIndex]));
+        } else {
+            filenames.push_back(argv[argIndex]);
+        }
+    }
+    if (!filenames.size()) {
+        fprintf(stderr, "Usage: WorkloadBenchmark [--iterations N] <workload.wast>...\n");
+        return EXIT_FAILURE;
+    }
+
+    printf("workload,optimizationLevel,parseMicroseconds,validateMicroseconds,compileMicroseconds,objectCodeBytes,runMicroseconds\n");
+    for (const char *filename : filenames) {
+        if (!runWorkload(filename, numRunIterations)) {
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,3316 @@
+;; A large module: 400 small functions with a mix of integer, float and memory operations, as in
+;; the bulk of a compiled application, and a run function that calls each of them. It measures
+;; compile time more than execution time.
+
+(module
+  (memory 1)
+  (func $f0 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 3)) (i32.const 0)))
+    (i32.store offset=0 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=4 (i32.const 0))))
+
+  (func $f1 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 1.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 2)))
+      (else (i32.sub (get_local $t) (i32.const 1)))))
+
+  (func $f2 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f3 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=3 (i32.const 256)))
+    (i32.store8 offset=3 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f2 (get_local $x))))
+
+  (func $f4 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 31)) (i32.const 4)))
+    (i32.store offset=16 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=20 (i32.const 0))))
+
+  (func $f5 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 5.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 6)))
+      (else (i32.sub (get_local $t) (i32.const 5)))))
+
+  (func $f6 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f7 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=7 (i32.const 256)))
+    (i32.store8 offset=7 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f6 (get_local $x))))
+
+  (func $f8 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 59)) (i32.const 8)))
+    (i32.store offset=32 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=36 (i32.const 0))))
+
+  (func $f9 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 9.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 10)))
+      (else (i32.sub (get_local $t) (i32.const 9)))))
+
+  (func $f10 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f11 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=11 (i32.const 256)))
+    (i32.store8 offset=11 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f10 (get_local $x))))
+
+  (func $f12 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 87)) (i32.const 12)))
+    (i32.store offset=48 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=52 (i32.const 0))))
+
+  (func $f13 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 13.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 14)))
+      (else (i32.sub (get_local $t) (i32.const 13)))))
+
+  (func $f14 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f15 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=15 (i32.const 256)))
+    (i32.store8 offset=15 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f14 (get_local $x))))
+
+  (func $f16 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 115)) (i32.const 16)))
+    (i32.store offset=64 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=68 (i32.const 0))))
+
+  (func $f17 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 17.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 18)))
+      (else (i32.sub (get_local $t) (i32.const 17)))))
+
+  (func $f18 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f19 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=19 (i32.const 256)))
+    (i32.store8 offset=19 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f18 (get_local $x))))
+
+  (func $f20 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 143)) (i32.const 20)))
+    (i32.store offset=80 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=84 (i32.const 0))))
+
+  (func $f21 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 21.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 22)))
+      (else (i32.sub (get_local $t) (i32.const 21)))))
+
+  (func $f22 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f23 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=23 (i32.const 256)))
+    (i32.store8 offset=23 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f22 (get_local $x))))
+
+  (func $f24 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 171)) (i32.const 24)))
+    (i32.store offset=96 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=100 (i32.const 0))))
+
+  (func $f25 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 25.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 26)))
+      (else (i32.sub (get_local $t) (i32.const 25)))))
+
+  (func $f26 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f27 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=27 (i32.const 256)))
+    (i32.store8 offset=27 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f26 (get_local $x))))
+
+  (func $f28 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 199)) (i32.const 28)))
+    (i32.store offset=112 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=116 (i32.const 0))))
+
+  (func $f29 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 29.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 30)))
+      (else (i32.sub (get_local $t) (i32.const 29)))))
+
+  (func $f30 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f31 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=31 (i32.const 256)))
+    (i32.store8 offset=31 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f30 (get_local $x))))
+
+  (func $f32 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 227)) (i32.const 32)))
+    (i32.store offset=128 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=132 (i32.const 0))))
+
+  (func $f33 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 33.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 3)))
+      (else (i32.sub (get_local $t) (i32.const 33)))))
+
+  (func $f34 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f35 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=35 (i32.const 256)))
+    (i32.store8 offset=35 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f34 (get_local $x))))
+
+  (func $f36 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 255)) (i32.const 36)))
+    (i32.store offset=144 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=148 (i32.const 0))))
+
+  (func $f37 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 37.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 7)))
+      (else (i32.sub (get_local $t) (i32.const 37)))))
+
+  (func $f38 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f39 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=39 (i32.const 256)))
+    (i32.store8 offset=39 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f38 (get_local $x))))
+
+  (func $f40 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 283)) (i32.const 40)))
+    (i32.store offset=160 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=164 (i32.const 0))))
+
+  (func $f41 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 41.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 11)))
+      (else (i32.sub (get_local $t) (i32.const 41)))))
+
+  (func $f42 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f43 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=43 (i32.const 256)))
+    (i32.store8 offset=43 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f42 (get_local $x))))
+
+  (func $f44 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 311)) (i32.const 44)))
+    (i32.store offset=176 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=180 (i32.const 0))))
+
+  (func $f45 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 45.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 15)))
+      (else (i32.sub (get_local $t) (i32.const 45)))))
+
+  (func $f46 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f47 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=47 (i32.const 256)))
+    (i32.store8 offset=47 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f46 (get_local $x))))
+
+  (func $f48 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 339)) (i32.const 48)))
+    (i32.store offset=192 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=196 (i32.const 0))))
+
+  (func $f49 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 49.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 19)))
+      (else (i32.sub (get_local $t) (i32.const 49)))))
+
+  (func $f50 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f51 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=51 (i32.const 256)))
+    (i32.store8 offset=51 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f50 (get_local $x))))
+
+  (func $f52 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 367)) (i32.const 52)))
+    (i32.store offset=208 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=212 (i32.const 0))))
+
+  (func $f53 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 53.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 23)))
+      (else (i32.sub (get_local $t) (i32.const 53)))))
+
+  (func $f54 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f55 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=55 (i32.const 256)))
+    (i32.store8 offset=55 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f54 (get_local $x))))
+
+  (func $f56 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 395)) (i32.const 56)))
+    (i32.store offset=224 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=228 (i32.const 0))))
+
+  (func $f57 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 57.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 27)))
+      (else (i32.sub (get_local $t) (i32.const 57)))))
+
+  (func $f58 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f59 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=59 (i32.const 256)))
+    (i32.store8 offset=59 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f58 (get_local $x))))
+
+  (func $f60 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 423)) (i32.const 60)))
+    (i32.store offset=240 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=244 (i32.const 0))))
+
+  (func $f61 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 61.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 31)))
+      (else (i32.sub (get_local $t) (i32.const 61)))))
+
+  (func $f62 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f63 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=63 (i32.const 256)))
+    (i32.store8 offset=63 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f62 (get_local $x))))
+
+  (func $f64 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 451)) (i32.const 64)))
+    (i32.store offset=0 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=4 (i32.const 0))))
+
+  (func $f65 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 65.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 4)))
+      (else (i32.sub (get_local $t) (i32.const 65)))))
+
+  (func $f66 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f67 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=67 (i32.const 256)))
+    (i32.store8 offset=67 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f66 (get_local $x))))
+
+  (func $f68 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 479)) (i32.const 68)))
+    (i32.store offset=16 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=20 (i32.const 0))))
+
+  (func $f69 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 69.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 8)))
+      (else (i32.sub (get_local $t) (i32.const 69)))))
+
+  (func $f70 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f71 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=71 (i32.const 256)))
+    (i32.store8 offset=71 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f70 (get_local $x))))
+
+  (func $f72 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 507)) (i32.const 72)))
+    (i32.store offset=32 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=36 (i32.const 0))))
+
+  (func $f73 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 73.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 12)))
+      (else (i32.sub (get_local $t) (i32.const 73)))))
+
+  (func $f74 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f75 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=75 (i32.const 256)))
+    (i32.store8 offset=75 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f74 (get_local $x))))
+
+  (func $f76 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 535)) (i32.const 76)))
+    (i32.store offset=48 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=52 (i32.const 0))))
+
+  (func $f77 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 77.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 16)))
+      (else (i32.sub (get_local $t) (i32.const 77)))))
+
+  (func $f78 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f79 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=79 (i32.const 256)))
+    (i32.store8 offset=79 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f78 (get_local $x))))
+
+  (func $f80 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 563)) (i32.const 80)))
+    (i32.store offset=64 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=68 (i32.const 0))))
+
+  (func $f81 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 81.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 20)))
+      (else (i32.sub (get_local $t) (i32.const 81)))))
+
+  (func $f82 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f83 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=83 (i32.const 256)))
+    (i32.store8 offset=83 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f82 (get_local $x))))
+
+  (func $f84 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 591)) (i32.const 84)))
+    (i32.store offset=80 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=84 (i32.const 0))))
+
+  (func $f85 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 85.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 24)))
+      (else (i32.sub (get_local $t) (i32.const 85)))))
+
+  (func $f86 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f87 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=87 (i32.const 256)))
+    (i32.store8 offset=87 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f86 (get_local $x))))
+
+  (func $f88 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 619)) (i32.const 88)))
+    (i32.store offset=96 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=100 (i32.const 0))))
+
+  (func $f89 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 89.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 28)))
+      (else (i32.sub (get_local $t) (i32.const 89)))))
+
+  (func $f90 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f91 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=91 (i32.const 256)))
+    (i32.store8 offset=91 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f90 (get_local $x))))
+
+  (func $f92 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 647)) (i32.const 92)))
+    (i32.store offset=112 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=116 (i32.const 0))))
+
+  (func $f93 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 93.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 1)))
+      (else (i32.sub (get_local $t) (i32.const 93)))))
+
+  (func $f94 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f95 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=95 (i32.const 256)))
+    (i32.store8 offset=95 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f94 (get_local $x))))
+
+  (func $f96 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 675)) (i32.const 96)))
+    (i32.store offset=128 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=132 (i32.const 0))))
+
+  (func $f97 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 97.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 5)))
+      (else (i32.sub (get_local $t) (i32.const 97)))))
+
+  (func $f98 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f99 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=99 (i32.const 256)))
+    (i32.store8 offset=99 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f98 (get_local $x))))
+
+  (func $f100 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 703)) (i32.const 100)))
+    (i32.store offset=144 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=148 (i32.const 0))))
+
+  (func $f101 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 101.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 9)))
+      (else (i32.sub (get_local $t) (i32.const 101)))))
+
+  (func $f102 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f103 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=103 (i32.const 256)))
+    (i32.store8 offset=103 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f102 (get_local $x))))
+
+  (func $f104 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 731)) (i32.const 104)))
+    (i32.store offset=160 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=164 (i32.const 0))))
+
+  (func $f105 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 105.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 13)))
+      (else (i32.sub (get_local $t) (i32.const 105)))))
+
+  (func $f106 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f107 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=107 (i32.const 256)))
+    (i32.store8 offset=107 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f106 (get_local $x))))
+
+  (func $f108 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 759)) (i32.const 108)))
+    (i32.store offset=176 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=180 (i32.const 0))))
+
+  (func $f109 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 109.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 17)))
+      (else (i32.sub (get_local $t) (i32.const 109)))))
+
+  (func $f110 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f111 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=111 (i32.const 256)))
+    (i32.store8 offset=111 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f110 (get_local $x))))
+
+  (func $f112 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 787)) (i32.const 112)))
+    (i32.store offset=192 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=196 (i32.const 0))))
+
+  (func $f113 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 113.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 21)))
+      (else (i32.sub (get_local $t) (i32.const 113)))))
+
+  (func $f114 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f115 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=115 (i32.const 256)))
+    (i32.store8 offset=115 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f114 (get_local $x))))
+
+  (func $f116 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 815)) (i32.const 116)))
+    (i32.store offset=208 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=212 (i32.const 0))))
+
+  (func $f117 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 117.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 25)))
+      (else (i32.sub (get_local $t) (i32.const 117)))))
+
+  (func $f118 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f119 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=119 (i32.const 256)))
+    (i32.store8 offset=119 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f118 (get_local $x))))
+
+  (func $f120 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 843)) (i32.const 120)))
+    (i32.store offset=224 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=228 (i32.const 0))))
+
+  (func $f121 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 121.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 29)))
+      (else (i32.sub (get_local $t) (i32.const 121)))))
+
+  (func $f122 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f123 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=123 (i32.const 256)))
+    (i32.store8 offset=123 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f122 (get_local $x))))
+
+  (func $f124 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 871)) (i32.const 124)))
+    (i32.store offset=240 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=244 (i32.const 0))))
+
+  (func $f125 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 125.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 2)))
+      (else (i32.sub (get_local $t) (i32.const 125)))))
+
+  (func $f126 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f127 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=127 (i32.const 256)))
+    (i32.store8 offset=127 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f126 (get_local $x))))
+
+  (func $f128 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 899)) (i32.const 128)))
+    (i32.store offset=0 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=4 (i32.const 0))))
+
+  (func $f129 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 129.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 6)))
+      (else (i32.sub (get_local $t) (i32.const 129)))))
+
+  (func $f130 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f131 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=131 (i32.const 256)))
+    (i32.store8 offset=131 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f130 (get_local $x))))
+
+  (func $f132 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 927)) (i32.const 132)))
+    (i32.store offset=16 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=20 (i32.const 0))))
+
+  (func $f133 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 133.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 10)))
+      (else (i32.sub (get_local $t) (i32.const 133)))))
+
+  (func $f134 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f135 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=135 (i32.const 256)))
+    (i32.store8 offset=135 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f134 (get_local $x))))
+
+  (func $f136 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 955)) (i32.const 136)))
+    (i32.store offset=32 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=36 (i32.const 0))))
+
+  (func $f137 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 137.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 14)))
+      (else (i32.sub (get_local $t) (i32.const 137)))))
+
+  (func $f138 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f139 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=139 (i32.const 256)))
+    (i32.store8 offset=139 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f138 (get_local $x))))
+
+  (func $f140 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 983)) (i32.const 140)))
+    (i32.store offset=48 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=52 (i32.const 0))))
+
+  (func $f141 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 141.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 18)))
+      (else (i32.sub (get_local $t) (i32.const 141)))))
+
+  (func $f142 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f143 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=143 (i32.const 256)))
+    (i32.store8 offset=143 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f142 (get_local $x))))
+
+  (func $f144 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 1011)) (i32.const 144)))
+    (i32.store offset=64 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=68 (i32.const 0))))
+
+  (func $f145 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 145.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 22)))
+      (else (i32.sub (get_local $t) (i32.const 145)))))
+
+  (func $f146 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f147 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=147 (i32.const 256)))
+    (i32.store8 offset=147 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f146 (get_local $x))))
+
+  (func $f148 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 1039)) (i32.const 148)))
+    (i32.store offset=80 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=84 (i32.const 0))))
+
+  (func $f149 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 149.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 26)))
+      (else (i32.sub (get_local $t) (i32.const 149)))))
+
+  (func $f150 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f151 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=151 (i32.const 256)))
+    (i32.store8 offset=151 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f150 (get_local $x))))
+
+  (func $f152 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 1067)) (i32.const 152)))
+    (i32.store offset=96 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=100 (i32.const 0))))
+
+  (func $f153 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 153.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 30)))
+      (else (i32.sub (get_local $t) (i32.const 153)))))
+
+  (func $f154 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f155 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=155 (i32.const 256)))
+    (i32.store8 offset=155 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f154 (get_local $x))))
+
+  (func $f156 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 1095)) (i32.const 156)))
+    (i32.store offset=112 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=116 (i32.const 0))))
+
+  (func $f157 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 157.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 3)))
+      (else (i32.sub (get_local $t) (i32.const 157)))))
+
+  (func $f158 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f159 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=159 (i32.const 256)))
+    (i32.store8 offset=159 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f158 (get_local $x))))
+
+  (func $f160 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 1123)) (i32.const 160)))
+    (i32.store offset=128 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=132 (i32.const 0))))
+
+  (func $f161 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 161.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 7)))
+      (else (i32.sub (get_local $t) (i32.const 161)))))
+
+  (func $f162 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f163 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=163 (i32.const 256)))
+    (i32.store8 offset=163 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f162 (get_local $x))))
+
+  (func $f164 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 1151)) (i32.const 164)))
+    (i32.store offset=144 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=148 (i32.const 0))))
+
+  (func $f165 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 165.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 11)))
+      (else (i32.sub (get_local $t) (i32.const 165)))))
+
+  (func $f166 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f167 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=167 (i32.const 256)))
+    (i32.store8 offset=167 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f166 (get_local $x))))
+
+  (func $f168 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 1179)) (i32.const 168)))
+    (i32.store offset=160 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=164 (i32.const 0))))
+
+  (func $f169 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 169.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 15)))
+      (else (i32.sub (get_local $t) (i32.const 169)))))
+
+  (func $f170 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f171 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=171 (i32.const 256)))
+    (i32.store8 offset=171 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f170 (get_local $x))))
+
+  (func $f172 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 1207)) (i32.const 172)))
+    (i32.store offset=176 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=180 (i32.const 0))))
+
+  (func $f173 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 173.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 19)))
+      (else (i32.sub (get_local $t) (i32.const 173)))))
+
+  (func $f174 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f175 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=175 (i32.const 256)))
+    (i32.store8 offset=175 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f174 (get_local $x))))
+
+  (func $f176 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 1235)) (i32.const 176)))
+    (i32.store offset=192 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=196 (i32.const 0))))
+
+  (func $f177 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 177.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 23)))
+      (else (i32.sub (get_local $t) (i32.const 177)))))
+
+  (func $f178 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f179 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=179 (i32.const 256)))
+    (i32.store8 offset=179 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f178 (get_local $x))))
+
+  (func $f180 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 1263)) (i32.const 180)))
+    (i32.store offset=208 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=212 (i32.const 0))))
+
+  (func $f181 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 181.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 27)))
+      (else (i32.sub (get_local $t) (i32.const 181)))))
+
+  (func $f182 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f183 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=183 (i32.const 256)))
+    (i32.store8 offset=183 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f182 (get_local $x))))
+
+  (func $f184 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 1291)) (i32.const 184)))
+    (i32.store offset=224 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=228 (i32.const 0))))
+
+  (func $f185 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 185.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 31)))
+      (else (i32.sub (get_local $t) (i32.const 185)))))
+
+  (func $f186 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f187 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=187 (i32.const 256)))
+    (i32.store8 offset=187 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f186 (get_local $x))))
+
+  (func $f188 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 1319)) (i32.const 188)))
+    (i32.store offset=240 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=244 (i32.const 0))))
+
+  (func $f189 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 189.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 4)))
+      (else (i32.sub (get_local $t) (i32.const 189)))))
+
+  (func $f190 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f191 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=191 (i32.const 256)))
+    (i32.store8 offset=191 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f190 (get_local $x))))
+
+  (func $f192 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 1347)) (i32.const 192)))
+    (i32.store offset=0 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=4 (i32.const 0))))
+
+  (func $f193 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 193.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 8)))
+      (else (i32.sub (get_local $t) (i32.const 193)))))
+
+  (func $f194 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f195 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=195 (i32.const 256)))
+    (i32.store8 offset=195 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f194 (get_local $x))))
+
+  (func $f196 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 1375)) (i32.const 196)))
+    (i32.store offset=16 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=20 (i32.const 0))))
+
+  (func $f197 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 197.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 12)))
+      (else (i32.sub (get_local $t) (i32.const 197)))))
+
+  (func $f198 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f199 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=199 (i32.const 256)))
+    (i32.store8 offset=199 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f198 (get_local $x))))
+
+  (func $f200 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 1403)) (i32.const 200)))
+    (i32.store offset=32 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=36 (i32.const 0))))
+
+  (func $f201 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 201.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 16)))
+      (else (i32.sub (get_local $t) (i32.const 201)))))
+
+  (func $f202 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f203 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=203 (i32.const 256)))
+    (i32.store8 offset=203 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f202 (get_local $x))))
+
+  (func $f204 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 1431)) (i32.const 204)))
+    (i32.store offset=48 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=52 (i32.const 0))))
+
+  (func $f205 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 205.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 20)))
+      (else (i32.sub (get_local $t) (i32.const 205)))))
+
+  (func $f206 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f207 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=207 (i32.const 256)))
+    (i32.store8 offset=207 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f206 (get_local $x))))
+
+  (func $f208 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 1459)) (i32.const 208)))
+    (i32.store offset=64 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=68 (i32.const 0))))
+
+  (func $f209 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 209.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 24)))
+      (else (i32.sub (get_local $t) (i32.const 209)))))
+
+  (func $f210 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f211 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=211 (i32.const 256)))
+    (i32.store8 offset=211 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f210 (get_local $x))))
+
+  (func $f212 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 1487)) (i32.const 212)))
+    (i32.store offset=80 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=84 (i32.const 0))))
+
+  (func $f213 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 213.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 28)))
+      (else (i32.sub (get_local $t) (i32.const 213)))))
+
+  (func $f214 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f215 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=215 (i32.const 256)))
+    (i32.store8 offset=215 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f214 (get_local $x))))
+
+  (func $f216 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 1515)) (i32.const 216)))
+    (i32.store offset=96 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=100 (i32.const 0))))
+
+  (func $f217 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 217.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 1)))
+      (else (i32.sub (get_local $t) (i32.const 217)))))
+
+  (func $f218 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f219 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=219 (i32.const 256)))
+    (i32.store8 offset=219 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f218 (get_local $x))))
+
+  (func $f220 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 1543)) (i32.const 220)))
+    (i32.store offset=112 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=116 (i32.const 0))))
+
+  (func $f221 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 221.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 5)))
+      (else (i32.sub (get_local $t) (i32.const 221)))))
+
+  (func $f222 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f223 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=223 (i32.const 256)))
+    (i32.store8 offset=223 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f222 (get_local $x))))
+
+  (func $f224 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 1571)) (i32.const 224)))
+    (i32.store offset=128 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=132 (i32.const 0))))
+
+  (func $f225 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 225.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 9)))
+      (else (i32.sub (get_local $t) (i32.const 225)))))
+
+  (func $f226 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f227 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=227 (i32.const 256)))
+    (i32.store8 offset=227 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f226 (get_local $x))))
+
+  (func $f228 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 1599)) (i32.const 228)))
+    (i32.store offset=144 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=148 (i32.const 0))))
+
+  (func $f229 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 229.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 13)))
+      (else (i32.sub (get_local $t) (i32.const 229)))))
+
+  (func $f230 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f231 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=231 (i32.const 256)))
+    (i32.store8 offset=231 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f230 (get_local $x))))
+
+  (func $f232 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 1627)) (i32.const 232)))
+    (i32.store offset=160 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=164 (i32.const 0))))
+
+  (func $f233 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 233.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 17)))
+      (else (i32.sub (get_local $t) (i32.const 233)))))
+
+  (func $f234 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f235 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=235 (i32.const 256)))
+    (i32.store8 offset=235 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f234 (get_local $x))))
+
+  (func $f236 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 1655)) (i32.const 236)))
+    (i32.store offset=176 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=180 (i32.const 0))))
+
+  (func $f237 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 237.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 21)))
+      (else (i32.sub (get_local $t) (i32.const 237)))))
+
+  (func $f238 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f239 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=239 (i32.const 256)))
+    (i32.store8 offset=239 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f238 (get_local $x))))
+
+  (func $f240 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 1683)) (i32.const 240)))
+    (i32.store offset=192 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=196 (i32.const 0))))
+
+  (func $f241 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 241.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 25)))
+      (else (i32.sub (get_local $t) (i32.const 241)))))
+
+  (func $f242 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f243 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=243 (i32.const 256)))
+    (i32.store8 offset=243 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f242 (get_local $x))))
+
+  (func $f244 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 1711)) (i32.const 244)))
+    (i32.store offset=208 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=212 (i32.const 0))))
+
+  (func $f245 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 245.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 29)))
+      (else (i32.sub (get_local $t) (i32.const 245)))))
+
+  (func $f246 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f247 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=247 (i32.const 256)))
+    (i32.store8 offset=247 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f246 (get_local $x))))
+
+  (func $f248 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 1739)) (i32.const 248)))
+    (i32.store offset=224 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=228 (i32.const 0))))
+
+  (func $f249 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 249.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 2)))
+      (else (i32.sub (get_local $t) (i32.const 249)))))
+
+  (func $f250 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f251 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=251 (i32.const 256)))
+    (i32.store8 offset=251 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f250 (get_local $x))))
+
+  (func $f252 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 1767)) (i32.const 252)))
+    (i32.store offset=240 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=244 (i32.const 0))))
+
+  (func $f253 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 253.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 6)))
+      (else (i32.sub (get_local $t) (i32.const 253)))))
+
+  (func $f254 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f255 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=255 (i32.const 256)))
+    (i32.store8 offset=255 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f254 (get_local $x))))
+
+  (func $f256 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 1795)) (i32.const 256)))
+    (i32.store offset=0 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=4 (i32.const 0))))
+
+  (func $f257 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 257.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 10)))
+      (else (i32.sub (get_local $t) (i32.const 257)))))
+
+  (func $f258 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f259 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=3 (i32.const 256)))
+    (i32.store8 offset=3 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f258 (get_local $x))))
+
+  (func $f260 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 1823)) (i32.const 260)))
+    (i32.store offset=16 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=20 (i32.const 0))))
+
+  (func $f261 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 261.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 14)))
+      (else (i32.sub (get_local $t) (i32.const 261)))))
+
+  (func $f262 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f263 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=7 (i32.const 256)))
+    (i32.store8 offset=7 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f262 (get_local $x))))
+
+  (func $f264 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 1851)) (i32.const 264)))
+    (i32.store offset=32 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=36 (i32.const 0))))
+
+  (func $f265 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 265.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 18)))
+      (else (i32.sub (get_local $t) (i32.const 265)))))
+
+  (func $f266 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f267 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=11 (i32.const 256)))
+    (i32.store8 offset=11 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f266 (get_local $x))))
+
+  (func $f268 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 1879)) (i32.const 268)))
+    (i32.store offset=48 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=52 (i32.const 0))))
+
+  (func $f269 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 269.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 22)))
+      (else (i32.sub (get_local $t) (i32.const 269)))))
+
+  (func $f270 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f271 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=15 (i32.const 256)))
+    (i32.store8 offset=15 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f270 (get_local $x))))
+
+  (func $f272 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 1907)) (i32.const 272)))
+    (i32.store offset=64 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=68 (i32.const 0))))
+
+  (func $f273 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 273.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 26)))
+      (else (i32.sub (get_local $t) (i32.const 273)))))
+
+  (func $f274 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f275 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=19 (i32.const 256)))
+    (i32.store8 offset=19 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f274 (get_local $x))))
+
+  (func $f276 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 1935)) (i32.const 276)))
+    (i32.store offset=80 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=84 (i32.const 0))))
+
+  (func $f277 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 277.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 30)))
+      (else (i32.sub (get_local $t) (i32.const 277)))))
+
+  (func $f278 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f279 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=23 (i32.const 256)))
+    (i32.store8 offset=23 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f278 (get_local $x))))
+
+  (func $f280 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 1963)) (i32.const 280)))
+    (i32.store offset=96 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=100 (i32.const 0))))
+
+  (func $f281 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 281.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 3)))
+      (else (i32.sub (get_local $t) (i32.const 281)))))
+
+  (func $f282 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f283 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=27 (i32.const 256)))
+    (i32.store8 offset=27 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f282 (get_local $x))))
+
+  (func $f284 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 1991)) (i32.const 284)))
+    (i32.store offset=112 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=116 (i32.const 0))))
+
+  (func $f285 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 285.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 7)))
+      (else (i32.sub (get_local $t) (i32.const 285)))))
+
+  (func $f286 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f287 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=31 (i32.const 256)))
+    (i32.store8 offset=31 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f286 (get_local $x))))
+
+  (func $f288 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 2019)) (i32.const 288)))
+    (i32.store offset=128 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=132 (i32.const 0))))
+
+  (func $f289 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 289.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 11)))
+      (else (i32.sub (get_local $t) (i32.const 289)))))
+
+  (func $f290 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f291 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=35 (i32.const 256)))
+    (i32.store8 offset=35 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f290 (get_local $x))))
+
+  (func $f292 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 2047)) (i32.const 292)))
+    (i32.store offset=144 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=148 (i32.const 0))))
+
+  (func $f293 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 293.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 15)))
+      (else (i32.sub (get_local $t) (i32.const 293)))))
+
+  (func $f294 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f295 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=39 (i32.const 256)))
+    (i32.store8 offset=39 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f294 (get_local $x))))
+
+  (func $f296 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 2075)) (i32.const 296)))
+    (i32.store offset=160 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=164 (i32.const 0))))
+
+  (func $f297 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 297.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 19)))
+      (else (i32.sub (get_local $t) (i32.const 297)))))
+
+  (func $f298 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f299 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=43 (i32.const 256)))
+    (i32.store8 offset=43 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f298 (get_local $x))))
+
+  (func $f300 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 2103)) (i32.const 300)))
+    (i32.store offset=176 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=180 (i32.const 0))))
+
+  (func $f301 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 301.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 23)))
+      (else (i32.sub (get_local $t) (i32.const 301)))))
+
+  (func $f302 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f303 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=47 (i32.const 256)))
+    (i32.store8 offset=47 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f302 (get_local $x))))
+
+  (func $f304 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 2131)) (i32.const 304)))
+    (i32.store offset=192 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=196 (i32.const 0))))
+
+  (func $f305 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 305.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 27)))
+      (else (i32.sub (get_local $t) (i32.const 305)))))
+
+  (func $f306 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f307 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=51 (i32.const 256)))
+    (i32.store8 offset=51 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f306 (get_local $x))))
+
+  (func $f308 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 2159)) (i32.const 308)))
+    (i32.store offset=208 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=212 (i32.const 0))))
+
+  (func $f309 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 309.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 31)))
+      (else (i32.sub (get_local $t) (i32.const 309)))))
+
+  (func $f310 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f311 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=55 (i32.const 256)))
+    (i32.store8 offset=55 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f310 (get_local $x))))
+
+  (func $f312 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 2187)) (i32.const 312)))
+    (i32.store offset=224 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=228 (i32.const 0))))
+
+  (func $f313 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 313.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 4)))
+      (else (i32.sub (get_local $t) (i32.const 313)))))
+
+  (func $f314 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f315 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=59 (i32.const 256)))
+    (i32.store8 offset=59 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f314 (get_local $x))))
+
+  (func $f316 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 2215)) (i32.const 316)))
+    (i32.store offset=240 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=244 (i32.const 0))))
+
+  (func $f317 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 317.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 8)))
+      (else (i32.sub (get_local $t) (i32.const 317)))))
+
+  (func $f318 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f319 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=63 (i32.const 256)))
+    (i32.store8 offset=63 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f318 (get_local $x))))
+
+  (func $f320 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 2243)) (i32.const 320)))
+    (i32.store offset=0 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=4 (i32.const 0))))
+
+  (func $f321 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 321.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 12)))
+      (else (i32.sub (get_local $t) (i32.const 321)))))
+
+  (func $f322 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f323 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=67 (i32.const 256)))
+    (i32.store8 offset=67 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f322 (get_local $x))))
+
+  (func $f324 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 2271)) (i32.const 324)))
+    (i32.store offset=16 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=20 (i32.const 0))))
+
+  (func $f325 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 325.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 16)))
+      (else (i32.sub (get_local $t) (i32.const 325)))))
+
+  (func $f326 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f327 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=71 (i32.const 256)))
+    (i32.store8 offset=71 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f326 (get_local $x))))
+
+  (func $f328 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 2299)) (i32.const 328)))
+    (i32.store offset=32 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=36 (i32.const 0))))
+
+  (func $f329 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 329.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 20)))
+      (else (i32.sub (get_local $t) (i32.const 329)))))
+
+  (func $f330 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f331 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=75 (i32.const 256)))
+    (i32.store8 offset=75 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f330 (get_local $x))))
+
+  (func $f332 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 2327)) (i32.const 332)))
+    (i32.store offset=48 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=52 (i32.const 0))))
+
+  (func $f333 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 333.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 24)))
+      (else (i32.sub (get_local $t) (i32.const 333)))))
+
+  (func $f334 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f335 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=79 (i32.const 256)))
+    (i32.store8 offset=79 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f334 (get_local $x))))
+
+  (func $f336 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 2355)) (i32.const 336)))
+    (i32.store offset=64 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=68 (i32.const 0))))
+
+  (func $f337 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 337.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 28)))
+      (else (i32.sub (get_local $t) (i32.const 337)))))
+
+  (func $f338 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f339 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=83 (i32.const 256)))
+    (i32.store8 offset=83 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f338 (get_local $x))))
+
+  (func $f340 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 2383)) (i32.const 340)))
+    (i32.store offset=80 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=84 (i32.const 0))))
+
+  (func $f341 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 341.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 1)))
+      (else (i32.sub (get_local $t) (i32.const 341)))))
+
+  (func $f342 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f343 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=87 (i32.const 256)))
+    (i32.store8 offset=87 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f342 (get_local $x))))
+
+  (func $f344 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 2411)) (i32.const 344)))
+    (i32.store offset=96 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=100 (i32.const 0))))
+
+  (func $f345 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 345.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 5)))
+      (else (i32.sub (get_local $t) (i32.const 345)))))
+
+  (func $f346 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f347 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=91 (i32.const 256)))
+    (i32.store8 offset=91 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f346 (get_local $x))))
+
+  (func $f348 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 2439)) (i32.const 348)))
+    (i32.store offset=112 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=116 (i32.const 0))))
+
+  (func $f349 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 349.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 9)))
+      (else (i32.sub (get_local $t) (i32.const 349)))))
+
+  (func $f350 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f351 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=95 (i32.const 256)))
+    (i32.store8 offset=95 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f350 (get_local $x))))
+
+  (func $f352 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 2467)) (i32.const 352)))
+    (i32.store offset=128 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=132 (i32.const 0))))
+
+  (func $f353 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 353.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 13)))
+      (else (i32.sub (get_local $t) (i32.const 353)))))
+
+  (func $f354 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f355 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=99 (i32.const 256)))
+    (i32.store8 offset=99 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f354 (get_local $x))))
+
+  (func $f356 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 2495)) (i32.const 356)))
+    (i32.store offset=144 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=148 (i32.const 0))))
+
+  (func $f357 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 357.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 17)))
+      (else (i32.sub (get_local $t) (i32.const 357)))))
+
+  (func $f358 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f359 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=103 (i32.const 256)))
+    (i32.store8 offset=103 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f358 (get_local $x))))
+
+  (func $f360 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 2523)) (i32.const 360)))
+    (i32.store offset=160 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=164 (i32.const 0))))
+
+  (func $f361 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 361.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 21)))
+      (else (i32.sub (get_local $t) (i32.const 361)))))
+
+  (func $f362 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f363 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=107 (i32.const 256)))
+    (i32.store8 offset=107 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f362 (get_local $x))))
+
+  (func $f364 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 2551)) (i32.const 364)))
+    (i32.store offset=176 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=180 (i32.const 0))))
+
+  (func $f365 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 365.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 25)))
+      (else (i32.sub (get_local $t) (i32.const 365)))))
+
+  (func $f366 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f367 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=111 (i32.const 256)))
+    (i32.store8 offset=111 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f366 (get_local $x))))
+
+  (func $f368 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 2579)) (i32.const 368)))
+    (i32.store offset=192 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=196 (i32.const 0))))
+
+  (func $f369 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 369.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 29)))
+      (else (i32.sub (get_local $t) (i32.const 369)))))
+
+  (func $f370 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f371 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=115 (i32.const 256)))
+    (i32.store8 offset=115 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f370 (get_local $x))))
+
+  (func $f372 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 2607)) (i32.const 372)))
+    (i32.store offset=208 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=212 (i32.const 0))))
+
+  (func $f373 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 373.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 2)))
+      (else (i32.sub (get_local $t) (i32.const 373)))))
+
+  (func $f374 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f375 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=119 (i32.const 256)))
+    (i32.store8 offset=119 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f374 (get_local $x))))
+
+  (func $f376 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 2635)) (i32.const 376)))
+    (i32.store offset=224 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=228 (i32.const 0))))
+
+  (func $f377 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 377.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 6)))
+      (else (i32.sub (get_local $t) (i32.const 377)))))
+
+  (func $f378 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f379 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=123 (i32.const 256)))
+    (i32.store8 offset=123 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f378 (get_local $x))))
+
+  (func $f380 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 2663)) (i32.const 380)))
+    (i32.store offset=240 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=244 (i32.const 0))))
+
+  (func $f381 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 381.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 10)))
+      (else (i32.sub (get_local $t) (i32.const 381)))))
+
+  (func $f382 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f383 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=127 (i32.const 256)))
+    (i32.store8 offset=127 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f382 (get_local $x))))
+
+  (func $f384 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 2691)) (i32.const 384)))
+    (i32.store offset=0 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=4 (i32.const 0))))
+
+  (func $f385 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 385.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 14)))
+      (else (i32.sub (get_local $t) (i32.const 385)))))
+
+  (func $f386 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f387 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=131 (i32.const 256)))
+    (i32.store8 offset=131 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f386 (get_local $x))))
+
+  (func $f388 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 2719)) (i32.const 388)))
+    (i32.store offset=16 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=20 (i32.const 0))))
+
+  (func $f389 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 389.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 18)))
+      (else (i32.sub (get_local $t) (i32.const 389)))))
+
+  (func $f390 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f391 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=135 (i32.const 256)))
+    (i32.store8 offset=135 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f390 (get_local $x))))
+
+  (func $f392 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 2747)) (i32.const 392)))
+    (i32.store offset=32 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=36 (i32.const 0))))
+
+  (func $f393 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 393.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 22)))
+      (else (i32.sub (get_local $t) (i32.const 393)))))
+
+  (func $f394 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 6)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f395 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=139 (i32.const 256)))
+    (i32.store8 offset=139 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f394 (get_local $x))))
+
+  (func $f396 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.add (i32.mul (get_local $x) (i32.const 2775)) (i32.const 396)))
+    (i32.store offset=48 (i32.const 0) (get_local $t))
+    (i32.xor (get_local $t) (i32.load offset=52 (i32.const 0))))
+
+  (func $f397 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.trunc_s/f64 (f64.mul (f64.convert_s/i32 (i32.and (get_local $x) (i32.const 65535))) (f64.const 397.5))))
+    (if (result i32) (i32.and (get_local $t) (i32.const 1))
+      (then (i32.rotl (get_local $t) (i32.const 26)))
+      (else (i32.sub (get_local $t) (i32.const 397)))))
+
+  (func $f398 (param $x i32) (result i32)
+    (local $t i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $t) (i32.const 10)))
+        (set_local $x (i32.add (i32.shl (get_local $x) (i32.const 1)) (get_local $t)))
+        (set_local $t (i32.add (get_local $t) (i32.const 1)))
+        (br $loop)))
+    (get_local $x))
+
+  (func $f399 (param $x i32) (result i32)
+    (local $t i32)
+    (set_local $t (i32.load8_u offset=143 (i32.const 256)))
+    (i32.store8 offset=143 (i32.const 256) (i32.add (get_local $t) (get_local $x)))
+    (i32.add (get_local $t) (call $f398 (get_local $x))))
+
+  (func (export "run") (result i32)
+    (local $sum i32)
+    (local $iteration i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $iteration) (i32.const 100)))
+        (set_local $sum (i32.add (get_local $sum) (call $f0 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f1 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f2 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f3 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f4 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f5 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f6 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f7 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f8 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f9 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f10 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f11 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f12 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f13 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f14 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f15 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f16 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f17 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f18 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f19 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f20 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f21 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f22 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f23 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f24 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f25 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f26 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f27 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f28 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f29 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f30 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f31 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f32 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f33 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f34 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f35 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f36 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f37 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f38 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f39 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f40 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f41 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f42 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f43 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f44 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f45 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f46 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f47 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f48 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f49 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f50 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f51 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f52 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f53 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f54 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f55 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f56 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f57 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f58 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f59 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f60 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f61 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f62 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f63 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f64 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f65 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f66 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f67 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f68 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f69 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f70 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f71 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f72 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f73 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f74 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f75 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f76 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f77 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f78 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f79 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f80 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f81 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f82 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f83 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f84 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f85 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f86 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f87 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f88 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f89 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f90 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f91 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f92 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f93 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f94 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f95 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f96 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f97 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f98 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f99 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f100 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f101 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f102 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f103 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f104 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f105 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f106 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f107 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f108 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f109 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f110 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f111 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f112 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f113 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f114 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f115 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f116 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f117 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f118 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f119 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f120 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f121 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f122 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f123 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f124 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f125 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f126 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f127 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f128 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f129 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f130 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f131 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f132 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f133 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f134 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f135 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f136 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f137 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f138 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f139 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f140 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f141 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f142 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f143 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f144 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f145 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f146 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f147 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f148 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f149 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f150 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f151 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f152 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f153 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f154 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f155 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f156 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f157 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f158 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f159 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f160 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f161 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f162 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f163 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f164 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f165 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f166 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f167 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f168 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f169 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f170 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f171 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f172 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f173 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f174 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f175 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f176 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f177 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f178 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f179 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f180 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f181 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f182 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f183 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f184 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f185 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f186 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f187 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f188 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f189 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f190 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f191 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f192 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f193 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f194 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f195 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f196 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f197 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f198 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f199 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f200 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f201 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f202 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f203 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f204 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f205 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f206 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f207 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f208 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f209 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f210 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f211 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f212 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f213 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f214 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f215 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f216 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f217 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f218 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f219 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f220 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f221 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f222 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f223 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f224 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f225 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f226 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f227 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f228 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f229 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f230 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f231 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f232 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f233 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f234 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f235 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f236 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f237 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f238 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f239 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f240 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f241 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f242 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f243 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f244 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f245 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f246 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f247 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f248 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f249 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f250 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f251 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f252 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f253 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f254 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f255 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f256 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f257 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f258 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f259 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f260 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f261 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f262 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f263 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f264 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f265 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f266 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f267 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f268 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f269 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f270 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f271 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f272 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f273 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f274 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f275 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f276 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f277 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f278 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f279 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f280 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f281 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f282 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f283 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f284 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f285 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f286 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f287 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f288 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f289 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f290 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f291 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f292 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f293 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f294 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f295 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f296 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f297 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f298 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f299 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f300 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f301 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f302 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f303 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f304 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f305 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f306 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f307 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f308 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f309 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f310 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f311 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f312 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f313 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f314 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f315 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f316 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f317 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f318 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f319 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f320 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f321 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f322 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f323 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f324 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f325 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f326 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f327 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f328 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f329 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f330 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f331 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f332 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f333 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f334 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f335 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f336 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f337 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f338 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f339 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f340 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f341 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f342 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f343 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f344 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f345 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f346 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f347 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f348 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f349 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f350 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f351 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f352 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f353 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f354 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f355 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f356 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f357 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f358 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f359 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f360 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f361 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f362 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f363 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f364 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f365 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f366 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f367 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f368 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f369 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f370 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f371 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f372 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f373 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f374 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f375 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f376 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f377 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f378 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f379 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f380 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f381 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f382 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f383 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f384 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f385 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f386 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f387 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f388 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f389 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f390 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f391 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f392 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f393 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f394 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f395 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f396 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f397 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f398 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $sum (i32.add (get_local $sum) (call $f399 (i32.add (get_local $sum) (get_local $iteration)))))
+        (set_local $iteration (i32.add (get_local $iteration) (i32.const 1)))
+        (br $loop)))
+    (get_local $sum))
+)
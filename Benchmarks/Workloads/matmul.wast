@@ -0,0 +1,78 @@
+;; A compute kernel: multiplies two 48x48 matrices of f64s 8 times, and returns a checksum of the
+;; product. The matrices are stored row-major at addresses 0, 18432 and 36864.
+
+(module
+  (memory 1)
+
+  (func $init (param $n i32)
+    (local $i i32)
+    (local $j i32)
+    (local $address i32)
+    (set_local $i (i32.const 0))
+    (block $rowsDone
+      (loop $rows
+        (br_if $rowsDone (i32.ge_u (get_local $i) (get_local $n)))
+        (set_local $j (i32.const 0))
+        (block $columnsDone
+          (loop $columns
+            (br_if $columnsDone (i32.ge_u (get_local $j) (get_local $n)))
+            (set_local $address (i32.shl (i32.add (i32.mul (get_local $i) (get_local $n)) (get_local $j)) (i32.const 3)))
+            (f64.store offset=0 (get_local $address)
+              (f64.convert_u/i32 (i32.add (get_local $i) (get_local $j))))
+            (f64.store offset=18432 (get_local $address)
+              (f64.sub (f64.convert_u/i32 (get_local $i)) (f64.convert_u/i32 (get_local $j))))
+            (set_local $j (i32.add (get_local $j) (i32.const 1)))
+            (br $columns)))
+        (set_local $i (i32.add (get_local $i) (i32.const 1)))
+        (br $rows))))
+
+  (func $multiply (param $n i32)
+    (local $i i32)
+    (local $j i32)
+    (local $k i32)
+    (local $sum f64)
+    (set_local $i (i32.const 0))
+    (block $rowsDone
+      (loop $rows
+        (br_if $rowsDone (i32.ge_u (get_local $i) (get_local $n)))
+        (set_local $j (i32.const 0))
+        (block $columnsDone
+          (loop $columns
+            (br_if $columnsDone (i32.ge_u (get_local $j) (get_local $n)))
+            (set_local $sum (f64.const 0))
+            (set_local $k (i32.const 0))
+            (block $innerDone
+              (loop $inner
+                (br_if $innerDone (i32.ge_u (get_local $k) (get_local $n)))
+                (set_local $sum (f64.add (get_local $sum)
+                  (f64.mul
+                    (f64.load offset=0 (i32.shl (i32.add (i32.mul (get_local $i) (get_local $n)) (get_local $k)) (i32.const 3)))
+                    (f64.load offset=18432 (i32.shl (i32.add (i32.mul (get_local $k) (get_local $n)) (get_local $j)) (i32.const 3))))))
+                (set_local $k (i32.add (get_local $k) (i32.const 1)))
+                (br $inner)))
+            (f64.store offset=36864 (i32.shl (i32.add (i32.mul (get_local $i) (get_local $n)) (get_local $j)) (i32.const 3))
+              (get_local $sum))
+            (set_local $j (i32.add (get_local $j) (i32.const 1)))
+            (br $columns)))
+        (set_local $i (i32.add (get_local $i) (i32.const 1)))
+        (br $rows))))
+
+  (func (export "run") (result i32)
+    (local $iteration i32)
+    (local $address i32)
+    (local $checksum f64)
+    (call $init (i32.const 48))
+    (block $iterationsDone
+      (loop $iterations
+        (br_if $iterationsDone (i32.ge_u (get_local $iteration) (i32.const 8)))
+        (call $multiply (i32.const 48))
+        (set_local $iteration (i32.add (get_local $iteration) (i32.const 1)))
+        (br $iterations)))
+    (block $sumDone
+      (loop $sum
+        (br_if $sumDone (i32.ge_u (get_local $address) (i32.const 18432)))
+        (set_local $checksum (f64.add (get_local $checksum) (f64.load offset=36864 (get_local $address))))
+        (set_local $address (i32.add (get_local $address) (i32.const 8)))
+        (br $sum)))
+    (i32.trunc_s/f64 (f64.div (get_local $checksum) (f64.const 1024))))
+)
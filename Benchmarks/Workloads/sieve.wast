@@ -0,0 +1,49 @@
+;; A compute kernel: counts the primes below 500000 with the sieve of Eratosthenes, using a byte per
+;; number starting at address 0.
+
+(module
+  (memory 8)
+
+  (func (export "run") (result i32)
+    (local $limit i32)
+    (local $i i32)
+    (local $multiple i32)
+    (local $numPrimes i32)
+    (set_local $limit (i32.const 500000))
+
+    ;; Mark every number as a candidate.
+    (set_local $i (i32.const 0))
+    (block $clearDone
+      (loop $clear
+        (br_if $clearDone (i32.ge_u (get_local $i) (get_local $limit)))
+        (i32.store8 (get_local $i) (i32.const 1))
+        (set_local $i (i32.add (get_local $i) (i32.const 1)))
+        (br $clear)))
+
+    ;; Cross out the multiples of each prime.
+    (set_local $i (i32.const 2))
+    (block $sieveDone
+      (loop $sieve
+        (br_if $sieveDone (i32.ge_u (i32.mul (get_local $i) (get_local $i)) (get_local $limit)))
+        (if (i32.load8_u (get_local $i))
+          (then
+            (set_local $multiple (i32.mul (get_local $i) (get_local $i)))
+            (block $crossDone
+              (loop $cross
+                (br_if $crossDone (i32.ge_u (get_local $multiple) (get_local $limit)))
+                (i32.store8 (get_local $multiple) (i32.const 0))
+                (set_local $multiple (i32.add (get_local $multiple) (get_local $i)))
+                (br $cross)))))
+        (set_local $i (i32.add (get_local $i) (i32.const 1)))
+        (br $sieve)))
+
+    ;; Count the numbers that weren't crossed out.
+    (set_local $i (i32.const 2))
+    (block $countDone
+      (loop $count
+        (br_if $countDone (i32.ge_u (get_local $i) (get_local $limit)))
+        (set_local $numPrimes (i32.add (get_local $numPrimes) (i32.load8_u (get_local $i))))
+        (set_local $i (i32.add (get_local $i) (i32.const 1)))
+        (br $count)))
+    (get_local $numPrimes))
+)
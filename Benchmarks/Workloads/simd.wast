@@ -0,0 +1,52 @@
+;; SIMD code: computes y = a*x + y over arrays of 8192 f32s with f32x4 operations 64 times, and
+;; returns the sum of y. x is stored at address 0 and y at address 32768.
+
+(module
+  (memory 1)
+
+  (func $init
+    (local $i i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $i) (i32.const 8192)))
+        (f32.store offset=0 (i32.shl (get_local $i) (i32.const 2)) (f32.convert_u/i32 (i32.and (get_local $i) (i32.const 15))))
+        (f32.store offset=32768 (i32.shl (get_local $i) (i32.const 2)) (f32.const 1))
+        (set_local $i (i32.add (get_local $i) (i32.const 1)))
+        (br $loop))))
+
+  (func $saxpy (param $a f32)
+    (local $address i32)
+    (local $aSplat v128)
+    (set_local $aSplat (f32x4.splat (get_local $a)))
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $address) (i32.const 32768)))
+        (v128.store offset=32768 (get_local $address)
+          (f32x4.add
+            (f32x4.mul (get_local $aSplat) (v128.load offset=0 (get_local $address)))
+            (v128.load offset=32768 (get_local $address))))
+        (set_local $address (i32.add (get_local $address) (i32.const 16)))
+        (br $loop))))
+
+  (func (export "run") (result i32)
+    (local $iteration i32)
+    (local $address i32)
+    (local $sum v128)
+    (call $init)
+    (block $iterationsDone
+      (loop $iterations
+        (br_if $iterationsDone (i32.ge_u (get_local $iteration) (i32.const 64)))
+        (call $saxpy (f32.const 0.001))
+        (set_local $iteration (i32.add (get_local $iteration) (i32.const 1)))
+        (br $iterations)))
+    (block $sumDone
+      (loop $sumLoop
+        (br_if $sumDone (i32.ge_u (get_local $address) (i32.const 32768)))
+        (set_local $sum (f32x4.add (get_local $sum) (v128.load offset=32768 (get_local $address))))
+        (set_local $address (i32.add (get_local $address) (i32.const 16)))
+        (br $sumLoop)))
+    (i32.trunc_u/f32
+      (f32.add
+        (f32.add (f32x4.extract_lane 0 (get_local $sum)) (f32x4.extract_lane 1 (get_local $sum)))
+        (f32.add (f32x4.extract_lane 2 (get_local $sum)) (f32x4.extract_lane 3 (get_local $sum))))))
+)
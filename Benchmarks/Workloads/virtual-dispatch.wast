@@ -0,0 +1,82 @@
+;; Virtual method calls laid out the way Emscripten compiles C++: each object starts with a pointer
+;; to its class's vtable in linear memory, and a vtable holds the table indices of the class's
+;; methods, which are called with call_indirect. The objects are an array of 4096 shapes of three
+;; classes starting at address 1024: a vtable pointer followed by two i32 fields.
+
+(module
+  (type $getter (func (param i32) (result i32)))
+  (type $setter (func (param i32 i32) (result i32)))
+  (memory 2)
+  (table 7 7 anyfunc)
+
+  ;; The vtables of Circle, Square and Triangle, at addresses 16, 24 and 32: area, then scale.
+  (elem (i32.const 1) $Circle_area $Circle_scale $Square_area $Square_scale $Triangle_area $Triangle_scale)
+  (data (i32.const 16) "\01\00\00\00\02\00\00\00\03\00\00\00\04\00\00\00\05\00\00\00\06\00\00\00")
+
+  (func $Circle_area (type $getter) (param $this i32) (result i32)
+    (i32.mul (i32.const 3) (i32.mul (i32.load offset=4 (get_local $this)) (i32.load offset=4 (get_local $this)))))
+
+  (func $Circle_scale (type $setter) (param $this i32) (param $factor i32) (result i32)
+    (local $radius i32)
+    (set_local $radius (i32.add (i32.and (i32.mul (i32.load offset=4 (get_local $this)) (get_local $factor)) (i32.const 255)) (i32.const 1)))
+    (i32.store offset=4 (get_local $this) (get_local $radius))
+    (get_local $radius))
+
+  (func $Square_area (type $getter) (param $this i32) (result i32)
+    (i32.mul (i32.load offset=4 (get_local $this)) (i32.load offset=4 (get_local $this))))
+
+  (func $Square_scale (type $setter) (param $this i32) (param $factor i32) (result i32)
+    (local $side i32)
+    (set_local $side (i32.add (i32.and (i32.add (i32.load offset=4 (get_local $this)) (get_local $factor)) (i32.const 127)) (i32.const 1)))
+    (i32.store offset=4 (get_local $this) (get_local $side))
+    (get_local $side))
+
+  (func $Triangle_area (type $getter) (param $this i32) (result i32)
+    (i32.shr_u (i32.mul (i32.load offset=4 (get_local $this)) (i32.load offset=8 (get_local $this))) (i32.const 1)))
+
+  (func $Triangle_scale (type $setter) (param $this i32) (param $factor i32) (result i32)
+    (local $base i32)
+    (set_local $base (i32.add (i32.rem_u (i32.mul (i32.load offset=4 (get_local $this)) (get_local $factor)) (i32.const 97)) (i32.const 1)))
+    (i32.store offset=4 (get_local $this) (get_local $base))
+    (i32.store offset=8 (get_local $this) (i32.add (get_local $base) (i32.const 2)))
+    (get_local $base))
+
+  (func $construct (param $numObjects i32)
+    (local $i i32)
+    (local $object i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (get_local $i) (get_local $numObjects)))
+        (set_local $object (i32.add (i32.const 1024) (i32.shl (get_local $i) (i32.const 4))))
+        (i32.store offset=0 (get_local $object) (i32.add (i32.const 16) (i32.shl (i32.rem_u (get_local $i) (i32.const 3)) (i32.const 3))))
+        (i32.store offset=4 (get_local $object) (i32.add (i32.rem_u (get_local $i) (i32.const 17)) (i32.const 1)))
+        (i32.store offset=8 (get_local $object) (i32.add (i32.rem_u (get_local $i) (i32.const 13)) (i32.const 1)))
+        (set_local $i (i32.add (get_local $i) (i32.const 1)))
+        (br $loop))))
+
+  (func (export "run") (result i32)
+    (local $iteration i32)
+    (local $i i32)
+    (local $object i32)
+    (local $vtable i32)
+    (local $sum i32)
+    (call $construct (i32.const 4096))
+    (block $iterationsDone
+      (loop $iterations
+        (br_if $iterationsDone (i32.ge_u (get_local $iteration) (i32.const 64)))
+        (set_local $i (i32.const 0))
+        (block $objectsDone
+          (loop $objects
+            (br_if $objectsDone (i32.ge_u (get_local $i) (i32.const 4096)))
+            (set_local $object (i32.add (i32.const 1024) (i32.shl (get_local $i) (i32.const 4))))
+            (set_local $vtable (i32.load (get_local $object)))
+            (set_local $sum (i32.add (get_local $sum)
+              (call_indirect (type $getter) (get_local $object) (i32.load offset=0 (get_local $vtable)))))
+            (set_local $sum (i32.xor (get_local $sum)
+              (call_indirect (type $setter) (get_local $object) (i32.const 3) (i32.load offset=4 (get_local $vtable)))))
+            (set_local $i (i32.add (get_local $i) (i32.const 1)))
+            (br $objects)))
+        (set_local $iteration (i32.add (get_local $iteration) (i32.const 1)))
+        (br $iterations)))
+    (get_local $sum))
+)
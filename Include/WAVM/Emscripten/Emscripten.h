@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "WAVM/IR/Value.h"
@@ -13,18 +14,52 @@ namespace WAVM {
 
 namespace WAVM {
     namespace Emscripten {
+        struct OutputStreams;
+        struct Threads;
+
+        // How much an instance's memory is grown by when its dynamic allocations reach the end of
+        // it. The memory is grown by its current size if doubleSize is set, clamped to
+        // [minGrowthPages, maxGrowthPages], and by at least enough pages for the allocation.
+        struct MemoryGrowthPolicy {
+            bool doubleSize = true;
+            Uptr minGrowthPages = 16;
+            Uptr maxGrowthPages = 1024;
+
+            // The number of pages the memory is grown to when the instance is created.
+            Uptr precommitPages = 0;
+        };
+
         struct Instance {
             Runtime::GCPointer<Runtime::ModuleInstance> env;
             Runtime::GCPointer<Runtime::ModuleInstance> asm2wasm;
             Runtime::GCPointer<Runtime::ModuleInstance> global;
 
             Runtime::GCPointer<Runtime::Memory> emscriptenMemory;
+            Runtime::GCPointer<Runtime::Table> emscriptenTable;
+            MemoryGrowthPolicy memoryGrowthPolicy;
+
+            // The module instance that initializeGlobals was called for, which the guest's threads
+            // call into.
+            Runtime::GCPointer<Runtime::ModuleInstance> moduleInstance;
+
+            // The guest threads created with pthread_create.
+            std::shared_ptr<Threads> threads;
+
+            // The buffers for the instance's output to stdout and stderr, which are flushed when
+            // the instance is destroyed.
+            std::shared_ptr<OutputStreams> outputStreams;
+
+            // Waits for the guest threads to exit before the objects they use are destroyed.
+            EMSCRIPTEN_API ~Instance();
         };
 
-        EMSCRIPTEN_API Instance *instantiate(Runtime::Compartment *compartment, const IR::Module &module);
+        EMSCRIPTEN_API Instance *instantiate(Runtime::Compartment *compartment, const IR::Module &module, const MemoryGrowthPolicy &memoryGrowthPolicy = MemoryGrowthPolicy());
 
         EMSCRIPTEN_API void initializeGlobals(Runtime::Context *context, const IR::Module &module, Runtime::ModuleInstance *moduleInstance);
 
+        // Writes out the output the instance has buffered for stdout and stderr.
+        EMSCRIPTEN_API void flushOutput(Instance *instance);
+
         EMSCRIPTEN_API void injectCommandArgs(Emscripten::Instance *instance, const std::vector<const char *> &argStrings, std::vector<IR::Value> &outInvokeArgs);
     }
 }
@@ -12,6 +12,13 @@
 #include "WAVM/Inline/BasicTypes.h"
 #include "WAVM/Inline/Errors.h"
 
+namespace WAVM {
+    namespace Serialization {
+        struct InputStream;
+        struct OutputStream;
+    }
+}
+
 namespace WAVM {
     namespace IR {
         enum class Opcode : U16;
@@ -102,11 +109,79 @@ namespace WAVM {
 
         typedef InitializerExpressionBase<Uptr> InitializerExpression;
 
+        // An array of bytes in a module: either a vector owned by the array, or a view of bytes in
+        // the backing buffer of the module. Copying a view copies the pointer to the bytes, so a view
+        // is only valid while the Module it was loaded into, or a copy of it, holds the buffer.
+        struct ModuleBytes {
+            ModuleBytes() : viewBytes(nullptr), numViewBytes(0) {
+            }
+
+            ModuleBytes(std::vector<U8> &&inOwnedBytes)
+                    : ownedBytes(std::move(inOwnedBytes)), viewBytes(nullptr), numViewBytes(0) {
+            }
+
+            // Creates a view of numBytes bytes that are owned by something else.
+            static ModuleBytes view(const U8 *bytes, Uptr numBytes) {
+                ModuleBytes result;
+                result.viewBytes = bytes;
+                result.numViewBytes = numBytes;
+                return result;
+            }
+
+            ModuleBytes &operator=(std::vector<U8> &&inOwnedBytes) {
+                ownedBytes = std::move(inOwnedBytes);
+                viewBytes = nullptr;
+                numViewBytes = 0;
+                return *this;
+            }
+
+            // Replaces the bytes with an owned copy of [begin, end).
+            void assign(const U8 *begin, const U8 *end) {
+                ownedBytes.assign(begin, end);
+                viewBytes = nullptr;
+                numViewBytes = 0;
+            }
+
+            bool isView() const {
+                return viewBytes != nullptr;
+            }
+
+            const U8 *data() const {
+                return viewBytes ? viewBytes : ownedBytes.data();
+            }
+
+            Uptr size() const {
+                return viewBytes ? numViewBytes : ownedBytes.size();
+            }
+
+            bool empty() const {
+                return size() == 0;
+            }
+
+            const U8 *begin() const {
+                return data();
+            }
+
+            const U8 *end() const {
+                return data() + size();
+            }
+
+            const U8 &operator[](Uptr index) const {
+                wavmAssert(index < size());
+                return data()[index];
+            }
+
+        private:
+            std::vector<U8> ownedBytes;
+            const U8 *viewBytes;
+            Uptr numViewBytes;
+        };
+
         // A function definition
         struct FunctionDef {
             IndexedFunctionType type;
             std::vector<ValueType> nonParameterLocalTypes;
-            std::vector<U8> code;
+            ModuleBytes code;
             std::vector<std::vector<Uptr>> branchTables;
         };
 
@@ -157,7 +232,7 @@ namespace WAVM {
             bool isActive;
             Uptr memoryIndex;
             InitializerExpression baseOffset;
-            std::vector<U8> data;
+            ModuleBytes data;
         };
 
         // An elem segment: a literal sequence of function indices that is copied into a Runtime::Table
@@ -172,7 +247,7 @@ namespace WAVM {
         // A user-defined module section as an array of bytes
         struct UserSection {
             std::string name;
-            std::vector<U8> data;
+            ModuleBytes data;
         };
 
         // An index-space for imports and definitions of a specific kind.
@@ -227,6 +302,11 @@ namespace WAVM {
 
             Uptr startFunctionIndex;
 
+            // If set, the buffer that the ModuleBytes views in the module point into, e.g. the file
+            // it was loaded from. Setting it before deserializeModule or WASM::parseModule makes them
+            // load the byte arrays into the module as views of the input instead of copying them.
+            std::shared_ptr<const void> backingBuffer;
+
             Module() : startFunctionIndex(UINTPTR_MAX) {
             }
 
@@ -282,5 +362,16 @@ namespace WAVM {
 
         // Serializes a DisassemblyNames structure and adds it to the module as a name section.
         IR_API void setDisassemblyNames(Module &module, const DisassemblyNames &names);
+
+        // Serializes a module to a WAVM-specific lossless encoding of the IR. This is not the
+        // WebAssembly binary format, and is only meant to be read back by the same version of WAVM.
+        IR_API void serializeModule(Serialization::OutputStream &stream, const Module &module);
+
+        // Deserializes a module written by serializeModule. Throws
+        // Serialization::FatalSerializationException if the input is malformed. The resulting module
+        // is not validated. If outModule has a backingBuffer, the stream must read directly from the
+        // memory it holds, e.g. a MemoryInputStream over it, and the code, data, and user section
+        // bytes are views of that memory.
+        IR_API void deserializeModule(Serialization::InputStream &stream, Module &outModule);
     }
 }
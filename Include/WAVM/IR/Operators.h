@@ -8,6 +8,7 @@
 #include "WAVM/IR/Types.h"
 #include "WAVM/Inline/Assert.h"
 #include "WAVM/Inline/BasicTypes.h"
+#include "WAVM/Inline/Errors.h"
 #include "WAVM/Inline/Serialization.h"
 #include "WAVM/Platform/Defines.h"
 
@@ -122,10 +123,337 @@ namespace WAVM {
             };
         };
 
+        // The maximum number of bytes an operator takes in any encoding.
+        static constexpr Uptr maxEncodedOperatorBytes = 40;
+
+        // An encoding that stores each operator as its OpcodeAndImm struct. Decoding an operator is a
+        // single copy, but every operator takes at least two bytes, and most immediates are padded to
+        // several times the size of their encoding in the WebAssembly binary format.
+        struct FixedOperatorEncoding {
+            static Opcode decodeOpcode(const U8 *&nextByte) {
+                Opcode opcode;
+                memcpy(&opcode, nextByte, sizeof(Opcode));
+                nextByte += sizeof(Opcode);
+                return opcode;
+            }
+
+            static Uptr encodeOpcode(U8 *outBytes, Opcode opcode) {
+                memcpy(outBytes, &opcode, sizeof(Opcode));
+                return sizeof(Opcode);
+            }
+
+            static void decodeImm(const U8 *&nextByte, NoImm &outImm) {
+            }
+
+            template<typename Imm> static void decodeImm(const U8 *&nextByte, Imm &outImm) {
+                memcpy(&outImm, nextByte, sizeof(Imm));
+                nextByte += sizeof(Imm);
+            }
+
+            static Uptr encodeImm(U8 *outBytes, const NoImm &imm) {
+                return 0;
+            }
+
+            template<typename Imm> static Uptr encodeImm(U8 *outBytes, const Imm &imm) {
+                memcpy(outBytes, &imm, sizeof(Imm));
+                return sizeof(Imm);
+            }
+        };
+
+        // An encoding that stores the opcode of each operator in one byte if it's no greater than
+        // maxSingleByteOpcode, and otherwise in two bytes starting with its prefix byte. Indices and
+        // offsets are stored as unsigned LEB128, and integer literals as zigzag-encoded LEB128, so a
+        // typical operator takes 1-3 bytes. The decoder doesn't check the encoding, which was written
+        // by the encoder.
+        struct CompactOperatorEncoding {
+            static Opcode decodeOpcode(const U8 *&nextByte) {
+                const U8 firstByte = *nextByte++;
+                if (firstByte <= U8(Opcode::maxSingleByteOpcode)) {
+                    return Opcode(firstByte);
+                } else {
+                    return Opcode((U16(firstByte) << 8) | *nextByte++);
+                }
+            }
+
+            static Uptr encodeOpcode(U8 *outBytes, Opcode opcode) {
+                if (U16(opcode) <= U16(Opcode::maxSingleByteOpcode)) {
+                    outBytes[0] = U8(opcode);
+                    return 1;
+                } else {
+                    wavmAssert((U16(opcode) >> 8) > U16(Opcode::maxSingleByteOpcode));
+                    outBytes[0] = U8(U16(opcode) >> 8);
+                    outBytes[1] = U8(opcode);
+                    return 2;
+                }
+            }
+
+            static FORCEINLINE U64 decodeVarUInt(const U8 *&nextByte) {
+                // Most indices and offsets fit in a single byte.
+                U8 byte = *nextByte++;
+                U64 value = byte & 0x7f;
+                Uptr shift = 7;
+                while (byte & 0x80) {
+                    byte = *nextByte++;
+                    value |= U64(byte & 0x7f) << shift;
+                    shift += 7;
+                };
+                return value;
+            }
+
+            static Uptr encodeVarUInt(U8 *outBytes, U64 value) {
+                Uptr numBytes = 0;
+                while (value >= 0x80) {
+                    outBytes[numBytes++] = U8(value | 0x80);
+                    value >>= 7;
+                };
+                outBytes[numBytes++] = U8(value);
+                return numBytes;
+            }
+
+            template<typename Value> static void decodeBytes(const U8 *&nextByte, Value &outValue) {
+                memcpy(&outValue, nextByte, sizeof(Value));
+                nextByte += sizeof(Value);
+            }
+
+            template<typename Value> static Uptr encodeBytes(U8 *outBytes, const Value &value) {
+                memcpy(outBytes, &value, sizeof(Value));
+                return sizeof(Value);
+            }
+
+            static void decodeImm(const U8 *&nextByte, NoImm &outImm) {
+            }
+
+            static void decodeImm(const U8 *&nextByte, MemoryImm &outImm) {
+                outImm.memoryIndex = Uptr(decodeVarUInt(nextByte));
+            }
+
+            static void decodeImm(const U8 *&nextByte, TableImm &outImm) {
+                outImm.tableIndex = Uptr(decodeVarUInt(nextByte));
+            }
+
+            static void decodeImm(const U8 *&nextByte, ControlStructureImm &outImm) {
+                outImm.type.format = IndexedBlockType::Format(*nextByte++);
+                switch (outImm.type.format) {
+                    case IndexedBlockType::noParametersOrResult:
+                        break;
+                    case IndexedBlockType::oneResult:
+                        outImm.type.resultType = ValueType(*nextByte++);
+                        break;
+                    case IndexedBlockType::functionType:
+                        outImm.type.index = Uptr(decodeVarUInt(nextByte));
+                        break;
+                    default:
+                        Errors::unreachable();
+                };
+            }
+
+            static void decodeImm(const U8 *&nextByte, BranchImm &outImm) {
+                outImm.targetDepth = Uptr(decodeVarUInt(nextByte));
+            }
+
+            static void decodeImm(const U8 *&nextByte, BranchTableImm &outImm) {
+                outImm.defaultTargetDepth = Uptr(decodeVarUInt(nextByte));
+                outImm.branchTableIndex = Uptr(decodeVarUInt(nextByte));
+            }
+
+            static void decodeImm(const U8 *&nextByte, LiteralImm<I32> &outImm) {
+                const U32 zigzag = U32(decodeVarUInt(nextByte));
+                outImm.value = I32(zigzag >> 1) ^ -I32(zigzag & 1);
+            }
+
+            static void decodeImm(const U8 *&nextByte, LiteralImm<I64> &outImm) {
+                const U64 zigzag = decodeVarUInt(nextByte);
+                outImm.value = I64(zigzag >> 1) ^ -I64(zigzag & 1);
+            }
+
+            static void decodeImm(const U8 *&nextByte, LiteralImm<F32> &outImm) {
+                decodeBytes(nextByte, outImm.value);
+            }
+
+            static void decodeImm(const U8 *&nextByte, LiteralImm<F64> &outImm) {
+                decodeBytes(nextByte, outImm.value);
+            }
+
+            static void decodeImm(const U8 *&nextByte, LiteralImm<V128> &outImm) {
+                decodeBytes(nextByte, outImm.value);
+            }
+
+            template<bool isGlobal> static void decodeImm(const U8 *&nextByte, GetOrSetVariableImm<isGlobal> &outImm) {
+                outImm.variableIndex = Uptr(decodeVarUInt(nextByte));
+            }
+
+            static void decodeImm(const U8 *&nextByte, FunctionImm &outImm) {
+                outImm.functionIndex = Uptr(decodeVarUInt(nextByte));
+            }
+
+            static void decodeImm(const U8 *&nextByte, CallIndirectImm &outImm) {
+                outImm.type.index = Uptr(decodeVarUInt(nextByte));
+                outImm.tableIndex = Uptr(decodeVarUInt(nextByte));
+            }
+
+            template<Uptr naturalAlignmentLog2> static void decodeImm(const U8 *&nextByte, LoadOrStoreImm<naturalAlignmentLog2> &outImm) {
+                outImm.alignmentLog2 = *nextByte++;
+                outImm.offset = U32(decodeVarUInt(nextByte));
+            }
+
+            template<Uptr numLanes> static void decodeImm(const U8 *&nextByte, LaneIndexImm<numLanes> &outImm) {
+                outImm.laneIndex = *nextByte++;
+            }
+
+            template<Uptr numLanes> static void decodeImm(const U8 *&nextByte, ShuffleImm<numLanes> &outImm) {
+                decodeBytes(nextByte, outImm.laneIndices);
+            }
+
+            template<Uptr naturalAlignmentLog2> static void decodeImm(const U8 *&nextByte, AtomicLoadOrStoreImm<naturalAlignmentLog2> &outImm) {
+                outImm.alignmentLog2 = *nextByte++;
+                outImm.offset = U32(decodeVarUInt(nextByte));
+            }
+
+            static void decodeImm(const U8 *&nextByte, ExceptionTypeImm &outImm) {
+                outImm.exceptionTypeIndex = Uptr(decodeVarUInt(nextByte));
+            }
+
+            static void decodeImm(const U8 *&nextByte, RethrowImm &outImm) {
+                outImm.catchDepth = Uptr(decodeVarUInt(nextByte));
+            }
+
+            static void decodeImm(const U8 *&nextByte, DataSegmentAndMemImm &outImm) {
+                outImm.dataSegmentIndex = Uptr(decodeVarUInt(nextByte));
+                outImm.memoryIndex = Uptr(decodeVarUInt(nextByte));
+            }
+
+            static void decodeImm(const U8 *&nextByte, DataSegmentImm &outImm) {
+                outImm.dataSegmentIndex = Uptr(decodeVarUInt(nextByte));
+            }
+
+            static void decodeImm(const U8 *&nextByte, ElemSegmentAndTableImm &outImm) {
+                outImm.elemSegmentIndex = Uptr(decodeVarUInt(nextByte));
+                outImm.tableIndex = Uptr(decodeVarUInt(nextByte));
+            }
+
+            static void decodeImm(const U8 *&nextByte, ElemSegmentImm &outImm) {
+                outImm.elemSegmentIndex = Uptr(decodeVarUInt(nextByte));
+            }
+
+            static Uptr encodeImm(U8 *outBytes, const NoImm &imm) {
+                return 0;
+            }
+
+            static Uptr encodeImm(U8 *outBytes, const MemoryImm &imm) {
+                return encodeVarUInt(outBytes, imm.memoryIndex);
+            }
+
+            static Uptr encodeImm(U8 *outBytes, const TableImm &imm) {
+                return encodeVarUInt(outBytes, imm.tableIndex);
+            }
+
+            static Uptr encodeImm(U8 *outBytes, const ControlStructureImm &imm) {
+                outBytes[0] = U8(imm.type.format);
+                switch (imm.type.format) {
+                    case IndexedBlockType::noParametersOrResult:
+                        return 1;
+                    case IndexedBlockType::oneResult:
+                        outBytes[1] = U8(imm.type.resultType);
+                        return 2;
+                    case IndexedBlockType::functionType:
+                        return 1 + encodeVarUInt(outBytes + 1, imm.type.index);
+                    default:
+                        Errors::unreachable();
+                };
+            }
+
+            static Uptr encodeImm(U8 *outBytes, const BranchImm &imm) {
+                return encodeVarUInt(outBytes, imm.targetDepth);
+            }
+
+            static Uptr encodeImm(U8 *outBytes, const BranchTableImm &imm) {
+                const Uptr numBytes = encodeVarUInt(outBytes, imm.defaultTargetDepth);
+                return numBytes + encodeVarUInt(outBytes + numBytes, imm.branchTableIndex);
+            }
+
+            static Uptr encodeImm(U8 *outBytes, const LiteralImm<I32> &imm) {
+                return encodeVarUInt(outBytes, (U32(imm.value) << 1) ^ U32(imm.value >> 31));
+            }
+
+            static Uptr encodeImm(U8 *outBytes, const LiteralImm<I64> &imm) {
+                return encodeVarUInt(outBytes, (U64(imm.value) << 1) ^ U64(imm.value >> 63));
+            }
+
+            static Uptr encodeImm(U8 *outBytes, const LiteralImm<F32> &imm) {
+                return encodeBytes(outBytes, imm.value);
+            }
+
+            static Uptr encodeImm(U8 *outBytes, const LiteralImm<F64> &imm) {
+                return encodeBytes(outBytes, imm.value);
+            }
+
+            static Uptr encodeImm(U8 *outBytes, const LiteralImm<V128> &imm) {
+                return encodeBytes(outBytes, imm.value);
+            }
+
+            template<bool isGlobal> static Uptr encodeImm(U8 *outBytes, const GetOrSetVariableImm<isGlobal> &imm) {
+                return encodeVarUInt(outBytes, imm.variableIndex);
+            }
+
+            static Uptr encodeImm(U8 *outBytes, const FunctionImm &imm) {
+                return encodeVarUInt(outBytes, imm.functionIndex);
+            }
+
+            static Uptr encodeImm(U8 *outBytes, const CallIndirectImm &imm) {
+                const Uptr numBytes = encodeVarUInt(outBytes, imm.type.index);
+                return numBytes + encodeVarUInt(outBytes + numBytes, imm.tableIndex);
+            }
+
+            template<Uptr naturalAlignmentLog2> static Uptr encodeImm(U8 *outBytes, const LoadOrStoreImm<naturalAlignmentLog2> &imm) {
+                outBytes[0] = imm.alignmentLog2;
+                return 1 + encodeVarUInt(outBytes + 1, imm.offset);
+            }
+
+            template<Uptr numLanes> static Uptr encodeImm(U8 *outBytes, const LaneIndexImm<numLanes> &imm) {
+                outBytes[0] = imm.laneIndex;
+                return 1;
+            }
+
+            template<Uptr numLanes> static Uptr encodeImm(U8 *outBytes, const ShuffleImm<numLanes> &imm) {
+                return encodeBytes(outBytes, imm.laneIndices);
+            }
+
+            template<Uptr naturalAlignmentLog2> static Uptr encodeImm(U8 *outBytes, const AtomicLoadOrStoreImm<naturalAlignmentLog2> &imm) {
+                outBytes[0] = imm.alignmentLog2;
+                return 1 + encodeVarUInt(outBytes + 1, imm.offset);
+            }
+
+            static Uptr encodeImm(U8 *outBytes, const ExceptionTypeImm &imm) {
+                return encodeVarUInt(outBytes, imm.exceptionTypeIndex);
+            }
+
+            static Uptr encodeImm(U8 *outBytes, const RethrowImm &imm) {
+                return encodeVarUInt(outBytes, imm.catchDepth);
+            }
+
+            static Uptr encodeImm(U8 *outBytes, const DataSegmentAndMemImm &imm) {
+                const Uptr numBytes = encodeVarUInt(outBytes, imm.dataSegmentIndex);
+                return numBytes + encodeVarUInt(outBytes + numBytes, imm.memoryIndex);
+            }
+
+            static Uptr encodeImm(U8 *outBytes, const DataSegmentImm &imm) {
+                return encodeVarUInt(outBytes, imm.dataSegmentIndex);
+            }
+
+            static Uptr encodeImm(U8 *outBytes, const ElemSegmentAndTableImm &imm) {
+                const Uptr numBytes = encodeVarUInt(outBytes, imm.elemSegmentIndex);
+                return numBytes + encodeVarUInt(outBytes + numBytes, imm.tableIndex);
+            }
+
+            static Uptr encodeImm(U8 *outBytes, const ElemSegmentImm &imm) {
+                return encodeVarUInt(outBytes, imm.elemSegmentIndex);
+            }
+        };
+
         // Decodes an operator from an input stream and dispatches by opcode.
-        struct OperatorDecoderStream {
-            OperatorDecoderStream(const std::vector<U8> &codeBytes)
-                    : nextByte(codeBytes.data()), end(codeBytes.data() + codeBytes.size()) {
+        template<typename Encoding> struct BasicOperatorDecoderStream {
+            BasicOperatorDecoderStream(const U8 *codeBytes, Uptr numCodeBytes)
+                    : nextByte(codeBytes), end(codeBytes + numCodeBytes) {
             }
 
             operator bool() const {
@@ -133,27 +461,31 @@ namespace WAVM {
             }
 
             template<typename Visitor> typename Visitor::Result decodeOp(Visitor &visitor) {
-                wavmAssert(nextByte + sizeof(Opcode) <= end);
-                Opcode opcode;
-                memcpy(&opcode, nextByte, sizeof(Opcode));
+                wavmAssert(nextByte < end);
+                const Opcode opcode = Encoding::decodeOpcode(nextByte);
                 switch (opcode) {
 #define VISIT_OPCODE(opcode, name, nameString, Imm, ...)                                           \
     case Opcode::name:                                                                             \
     {                                                                                              \
-        wavmAssert(nextByte + sizeof(OpcodeAndImm<Imm>) <= end);                                   \
-        OpcodeAndImm<Imm> encodedOperator;                                                         \
-        memcpy(&encodedOperator, nextByte, sizeof(OpcodeAndImm<Imm>));                             \
-        nextByte += sizeof(OpcodeAndImm<Imm>);                                                     \
-        return visitor.name(encodedOperator.imm);                                                  \
+        Imm imm;                                                                                   \
+        Encoding::decodeImm(nextByte, imm);                                                        \
+        wavmAssert(nextByte <= end);                                                               \
+        return visitor.name(imm);                                                                  \
     }
                     ENUM_OPERATORS(VISIT_OPCODE)
 #undef VISIT_OPCODE
                     default:
-                        nextByte += sizeof(Opcode);
                         return visitor.unknown(opcode);
                 }
             }
 
+            // Returns the opcode of the next operator, without consuming it.
+            Opcode peekOpcode() const {
+                wavmAssert(nextByte < end);
+                const U8 *opcodeByte = nextByte;
+                return Encoding::decodeOpcode(opcodeByte);
+            }
+
             template<typename Visitor> typename Visitor::Result decodeOpWithoutConsume(Visitor &visitor) {
                 const U8 *savedNextByte = nextByte;
                 typename Visitor::Result result = decodeOp(visitor);
@@ -167,19 +499,18 @@ namespace WAVM {
         };
 
         // Encodes an operator to an output stream.
-        struct OperatorEncoderStream {
-            OperatorEncoderStream(Serialization::OutputStream &inByteStream) : byteStream(inByteStream) {
+        template<typename Encoding> struct BasicOperatorEncoderStream {
+            BasicOperatorEncoderStream(Serialization::OutputStream &inByteStream) : byteStream(inByteStream) {
             }
 
 #define VISIT_OPCODE(_, name, nameString, Imm, ...)                                                \
     void name(Imm imm = {})                                                                        \
     {                                                                                              \
-        OpcodeAndImm<Imm> encodedOperator;                                                         \
-        encodedOperator.opcode = Opcode::name;                                                     \
-        encodedOperator.imm = imm;                                                                 \
-        memcpy((OpcodeAndImm<Imm>*)byteStream.advance(sizeof(OpcodeAndImm<Imm>)),                  \
-               &encodedOperator,                                                                   \
-               sizeof(OpcodeAndImm<Imm>));                                                         \
+        U8 encodedOperator[maxEncodedOperatorBytes];                                               \
+        Uptr numEncodedBytes = Encoding::encodeOpcode(encodedOperator, Opcode::name);              \
+        numEncodedBytes += Encoding::encodeImm(encodedOperator + numEncodedBytes, imm);            \
+        wavmAssert(numEncodedBytes <= maxEncodedOperatorBytes);                                    \
+        memcpy(byteStream.advance(numEncodedBytes), encodedOperator, numEncodedBytes);             \
     }
 
             ENUM_OPERATORS(VISIT_OPCODE)
@@ -190,6 +521,11 @@ namespace WAVM {
             Serialization::OutputStream &byteStream;
         };
 
+        // The encoding of FunctionDef::code.
+        typedef CompactOperatorEncoding OperatorEncoding;
+        typedef BasicOperatorDecoderStream<OperatorEncoding> OperatorDecoderStream;
+        typedef BasicOperatorEncoderStream<OperatorEncoding> OperatorEncoderStream;
+
         IR_API const char *getOpcodeName(Opcode opcode);
 
         struct NonParametricOpSignatures {
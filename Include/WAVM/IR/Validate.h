@@ -16,6 +16,13 @@ namespace WAVM {
             Uptr requiredNumDataSegments = 0;
         };
 
+        // Merges the deferred validation state of code validated separately, e.g. on another thread.
+        inline void mergeDeferredCodeValidationState(DeferredCodeValidationState &state, const DeferredCodeValidationState &otherState) {
+            if (otherState.requiredNumDataSegments > state.requiredNumDataSegments) {
+                state.requiredNumDataSegments = otherState.requiredNumDataSegments;
+            }
+        }
+
         struct ValidationException {
             std::string message;
 
@@ -67,6 +74,36 @@ namespace WAVM {
             InnerStream &innerStream;
         };
 
+        // Adapts a visitor for OperatorDecoderStream so that each decoded operator is validated
+        // before the visitor is called for it. This lets a consumer of a function definition's
+        // encoded code, e.g. the LLVM IR emitter, validate the code in the same decoding pass.
+        template<typename InnerVisitor> struct CodeValidationProxyVisitor {
+            typedef typename InnerVisitor::Result Result;
+
+            CodeValidationProxyVisitor(CodeValidationStream &inCodeValidationStream, InnerVisitor &inInnerVisitor)
+                    : codeValidationStream(inCodeValidationStream), innerVisitor(inInnerVisitor) {
+            }
+
+#define VISIT_OPCODE(_, name, nameString, Imm, ...)                                                \
+    Result name(Imm imm)                                                                           \
+    {                                                                                              \
+        codeValidationStream.name(imm);                                                            \
+        return innerVisitor.name(imm);                                                             \
+    }
+
+            ENUM_OPERATORS(VISIT_OPCODE)
+
+#undef VISIT_OPCODE
+
+            Result unknown(Opcode opcode) {
+                throw ValidationException("unknown opcode");
+            }
+
+        private:
+            CodeValidationStream &codeValidationStream;
+            InnerVisitor &innerVisitor;
+        };
+
         IR_API void validateTypes(const IR::Module &module);
 
         IR_API void validateImports(const IR::Module &module);
@@ -89,6 +126,12 @@ namespace WAVM {
 
         IR_API void validateDataSegments(const IR::Module &module, const DeferredCodeValidationState &deferredCodeValidationState);
 
+        // Validates the encoded code of all the module's function definitions, e.g. of a module that
+        // wasn't validated as it was decoded. The function definitions are validated in parallel if
+        // the module has enough code. Throws the ValidationException for the first invalid function
+        // definition.
+        IR_API void validateFunctionDefs(const IR::Module &module, DeferredCodeValidationState &deferredCodeValidationState);
+
         inline void validatePreCodeSections(const IR::Module &module) {
             validateTypes(module);
             validateImports(module);
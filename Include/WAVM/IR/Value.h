@@ -166,39 +166,61 @@ namespace WAVM {
             }
         };
 
-        // A boxed value: may hold any value that can be returned from a function invoked through the
-        // runtime.
+        // A boxed tuple of values: may hold any values that can be returned from a function invoked
+        // through the runtime.
         struct ValueTuple {
-            std::vector<Value> values;
-
-            ValueTuple(ValueType inType, UntaggedValue inValue) : values({Value(inType, inValue)}) {
+            ValueTuple(ValueType inType, UntaggedValue inValue) : numValues(0) {
+                push_back(Value(inType, inValue));
             }
 
-            ValueTuple(TypeTuple types, UntaggedValue *inValues) {
-                values.reserve(types.size());
+            ValueTuple(TypeTuple types, UntaggedValue *inValues) : numValues(0) {
                 for (ValueType type : types) {
-                    values.push_back(Value(type, *inValues++));
+                    push_back(Value(type, *inValues++));
                 }
             }
 
-            ValueTuple(const Value &inValue) : values({inValue}) {
+            ValueTuple(const Value &inValue) : numValues(0) {
+                push_back(inValue);
             }
 
-            ValueTuple() {
+            ValueTuple() : numValues(0) {
             }
 
             Uptr size() const {
-                return values.size();
+                return numValues;
             }
 
             Value &operator[](Uptr index) {
+                wavmAssert(index < numValues);
                 return values[index];
             }
 
             const Value &operator[](Uptr index) const {
+                wavmAssert(index < numValues);
                 return values[index];
             }
 
+            Value *begin() {
+                return values;
+            }
+
+            Value *end() {
+                return values + numValues;
+            }
+
+            const Value *begin() const {
+                return values;
+            }
+
+            const Value *end() const {
+                return values + numValues;
+            }
+
+            void push_back(const Value &value) {
+                errorUnless(numValues < maxReturnValues);
+                values[numValues++] = value;
+            }
+
             friend std::string asString(const ValueTuple &valueTuple) {
                 std::string result = "(";
                 for (Uptr elementIndex = 0; elementIndex < valueTuple.size(); ++elementIndex) {
@@ -226,6 +248,14 @@ namespace WAVM {
             friend bool operator!=(const ValueTuple &left, const ValueTuple &right) {
                 return !(left == right);
             }
+
+        private:
+            // The values are stored inline, so a tuple that holds the results of a function doesn't
+            // allocate. They aren't initialized until they are added to the tuple.
+            Uptr numValues;
+            union {
+                Value values[maxReturnValues];
+            };
         };
     }
 }
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include "WAVM/Inline/Assert.h"
+#include "WAVM/Inline/BasicTypes.h"
+#include "WAVM/Inline/Lock.h"
+#include "WAVM/Platform/Mutex.h"
+
+namespace WAVM {
+    // Maps non-overlapping address ranges to values. Lookups don't take a lock or allocate, so they
+    // may be done from a signal handler, and don't contend with each other: the ranges are kept in an
+    // immutable sorted array, which is replaced by a modified copy on each add or remove.
+    // Value must be trivially copyable.
+    template<typename Value> struct AddressRangeIndex {
+        struct Range {
+            Uptr begin;
+            Uptr end;
+            Value value;
+        };
+
+        AddressRangeIndex() : snapshot(new Snapshot), numActiveReaders(0) {}
+
+        ~AddressRangeIndex() {
+            delete snapshot.load(std::memory_order_acquire);
+            for (const Snapshot *retiredSnapshot : retiredSnapshots) {
+                delete retiredSnapshot;
+            }
+        }
+
+        AddressRangeIndex(const AddressRangeIndex &) = delete;
+
+        void operator=(const AddressRangeIndex &) = delete;
+
+        // Adds a range, which must not overlap any range already in the index.
+        void add(Uptr begin, Uptr end, Value value) {
+            addRanges({{begin, end, value}});
+        }
+
+        // Adds several ranges with a single copy of the index. The ranges must not overlap each
+        // other or any range already in the index.
+        void addRanges(std::vector<Range> &&newRanges) {
+            std::sort(newRanges.begin(), newRanges.end(), [](const Range &left, const Range &right) {
+                return left.begin < right.begin;
+            });
+
+            Lock<Platform::Mutex> writerLock(writerMutex);
+            const Snapshot *oldSnapshot = snapshot.load(std::memory_order_acquire);
+
+            Snapshot *newSnapshot = new Snapshot;
+            newSnapshot->ranges.resize(oldSnapshot->ranges.size() + newRanges.size());
+            std::merge(oldSnapshot->ranges.begin(), oldSnapshot->ranges.end(), newRanges.begin(), newRanges.end(), newSnapshot->ranges.begin(), [](const Range &left, const Range &right) {
+                return left.begin < right.begin;
+            });
+            for (Uptr rangeIndex = 0; rangeIndex < newSnapshot->ranges.size(); ++rangeIndex) {
+                wavmAssert(newSnapshot->ranges[rangeIndex].begin < newSnapshot->ranges[rangeIndex].end);
+                wavmAssert(!rangeIndex || newSnapshot->ranges[rangeIndex - 1].end <= newSnapshot->ranges[rangeIndex].begin);
+            }
+
+            publish(oldSnapshot, newSnapshot);
+        }
+
+        // Removes the range that starts at the given address.
+        void removeOrFail(Uptr begin) {
+            removeRangesOrFail({begin});
+        }
+
+        // Removes several ranges, identified by their begin addresses, with a single copy of the
+        // index.
+        void removeRangesOrFail(std::vector<Uptr> &&begins) {
+            std::sort(begins.begin(), begins.end());
+
+            Lock<Platform::Mutex> writerLock(writerMutex);
+            const Snapshot *oldSnapshot = snapshot.load(std::memory_order_acquire);
+
+            Snapshot *newSnapshot = new Snapshot;
+            newSnapshot->ranges.reserve(oldSnapshot->ranges.size());
+            for (const Range &range : oldSnapshot->ranges) {
+                if (!std::binary_search(begins.begin(), begins.end(), range.begin)) {
+                    newSnapshot->ranges.push_back(range);
+                }
+            }
+            wavmAssert(newSnapshot->ranges.size() + begins.size() == oldSnapshot->ranges.size());
+
+            publish(oldSnapshot, newSnapshot);
+        }
+
+        // Finds the range that contains an address.
+        bool find(Uptr address, Range &outRange) const {
+            numActiveReaders.fetch_add(1, std::memory_order_seq_cst);
+            const Snapshot *currentSnapshot = snapshot.load(std::memory_order_seq_cst);
+
+            bool found = false;
+            auto rangeIt = std::upper_bound(currentSnapshot->ranges.begin(), currentSnapshot->ranges.end(), address, [](Uptr address, const Range &range) {
+                return address < range.begin;
+            });
+            if (rangeIt != currentSnapshot->ranges.begin() && address < (rangeIt - 1)->end) {
+                outRange = *(rangeIt - 1);
+                found = true;
+            }
+
+            numActiveReaders.fetch_sub(1, std::memory_order_seq_cst);
+            return found;
+        }
+
+    private:
+        struct Snapshot {
+            std::vector<Range> ranges;
+        };
+
+        Platform::Mutex writerMutex;
+        std::atomic<const Snapshot *> snapshot;
+        mutable std::atomic<Uptr> numActiveReaders;
+
+        // Snapshots that have been replaced, but may still be in use by a reader. Only accessed
+        // while holding writerMutex.
+        std::vector<const Snapshot *> retiredSnapshots;
+
+        void publish(const Snapshot *oldSnapshot, const Snapshot *newSnapshot) {
+            snapshot.store(newSnapshot, std::memory_order_seq_cst);
+            retiredSnapshots.push_back(oldSnapshot);
+
+            // A reader increments numActiveReaders before loading the snapshot pointer, so if there
+            // are no active readers after the new snapshot is published, no reader can be using a
+            // retired snapshot. This never waits for readers: if there are any, the retired
+            // snapshots are freed by a later add or remove.
+            if (!numActiveReaders.load(std::memory_order_seq_cst)) {
+                for (const Snapshot *retiredSnapshot : retiredSnapshots) {
+                    delete retiredSnapshot;
+                }
+                retiredSnapshots.clear();
+            }
+        }
+    };
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "WAVM/Inline/Assert.h"
+#include "WAVM/Inline/BasicTypes.h"
+
+namespace WAVM {
+    // A bump allocator for many small objects with the same lifetime. Everything allocated from it is
+    // freed at once when it's destroyed, and the objects created with create are destroyed then, in
+    // the reverse order of their creation.
+    struct Arena {
+        Arena(Uptr inMinSegmentNumBytes = 16 * 1024)
+                : segments(nullptr), nextByte(nullptr), endByte(nullptr), destructors(nullptr),
+                  nextSegmentNumBytes(inMinSegmentNumBytes) {
+        }
+
+        Arena(const Arena &) = delete;
+
+        void operator=(const Arena &) = delete;
+
+        ~Arena() {
+            for (Destructor *destructor = destructors; destructor; destructor = destructor->next) {
+                destructor->destroy(destructor->object);
+            }
+
+            Segment *segment = segments;
+            while (segment) {
+                Segment *nextSegment = segment->next;
+                free(segment);
+                segment = nextSegment;
+            }
+        }
+
+        // Allocates numBytes of uninitialized memory, aligned to alignment, which must be a power of
+        // two no greater than alignof(max_align_t).
+        void *allocate(Uptr numBytes, Uptr alignment = alignof(max_align_t)) {
+            wavmAssert(alignment && !(alignment & (alignment - 1)) && alignment <= alignof(max_align_t));
+            U8 *result = reinterpret_cast<U8 *>((reinterpret_cast<Uptr>(nextByte) + alignment - 1) & ~(alignment - 1));
+            if (!nextByte || numBytes > Uptr(endByte - result)) {
+                return allocateSegment(numBytes);
+            }
+            nextByte = result + numBytes;
+            return result;
+        }
+
+        // Constructs an object in the arena, which is destroyed when the arena is.
+        template<typename Object, typename... Args> Object *create(Args &&... args) {
+            Object *object = new(allocate(sizeof(Object), alignof(Object))) Object(std::forward<Args>(args)...);
+            if (!std::is_trivially_destructible<Object>::value) {
+                Destructor *destructor = new(allocate(sizeof(Destructor), alignof(Destructor))) Destructor;
+                destructor->next = destructors;
+                destructor->destroy = [](void *destroyedObject) {
+                    static_cast<Object *>(destroyedObject)->~Object();
+                };
+                destructor->object = object;
+                destructors = destructor;
+            }
+            return object;
+        }
+
+        // Copies numChars chars into the arena.
+        const char *copyChars(const char *chars, Uptr numChars) {
+            char *result = static_cast<char *>(allocate(numChars, 1));
+            if (numChars) {
+                memcpy(result, chars, numChars);
+            }
+            return result;
+        }
+
+    private:
+        // The arena grows by segments of at least this many bytes, and each segment is larger than
+        // the last until they reach this size.
+        static constexpr Uptr maxSegmentNumBytes = 1024 * 1024;
+
+        struct Segment {
+            Segment *next;
+        };
+
+        struct Destructor {
+            Destructor *next;
+
+            void (*destroy)(void *);
+
+            void *object;
+        };
+
+        // The segment's bytes start after its header, aligned to max_align_t.
+        static constexpr Uptr segmentHeaderNumBytes = (sizeof(Segment) + alignof(max_align_t) - 1) & ~(alignof(max_align_t) - 1);
+
+        Segment *segments;
+        U8 *nextByte;
+        U8 *endByte;
+        Destructor *destructors;
+        Uptr nextSegmentNumBytes;
+
+        void *allocateSegment(Uptr numBytes) {
+            const Uptr segmentNumBytes = std::max(numBytes, nextSegmentNumBytes);
+            Segment *segment = static_cast<Segment *>(malloc(segmentHeaderNumBytes + segmentNumBytes));
+            errorUnless(segment);
+            segment->next = segments;
+            segments = segment;
+
+            U8 *result = reinterpret_cast<U8 *>(segment) + segmentHeaderNumBytes;
+            if (segmentNumBytes - numBytes >= Uptr(endByte - nextByte) || !nextByte) {
+                // Allocate from the new segment if it has more free bytes left than the current one.
+                nextByte = result + numBytes;
+                endByte = result + segmentNumBytes;
+            }
+            nextSegmentNumBytes = std::min(nextSegmentNumBytes * 2, maxSegmentNumBytes);
+            return result;
+        }
+    };
+}
@@ -0,0 +1,262 @@
+#pragma once
+
+#include <string.h>
+#include <utility>
+
+#include "WAVM/Inline/Assert.h"
+#include "WAVM/Inline/BasicTypes.h"
+#include "WAVM/Inline/OptionalStorage.h"
+
+namespace WAVM {
+    // A map with the same interface as IndexMap, for indices that are allocated densely from
+    // minIndex. The elements are stored in an array indexed by index - minIndex, and the array
+    // entries without an element are linked into a free list, so adding, removing and looking up an
+    // element take O(1) time, and iterating over the elements walks the array in index order.
+    //
+    //   The array only extends to the highest allocated index: removing the element at the end of
+    // it shrinks it past any entries below without elements. The most recently freed index is
+    // reused first, so a map whose elements are created and destroyed repeatedly stays dense.
+    template<typename Index, typename Element> struct DenseIndexMap {
+        DenseIndexMap(Index inMinIndex, Index inMaxIndex)
+                : minIndex(inMinIndex), maxIndex(inMaxIndex), slots(nullptr), numSlots(0), numAllocatedSlots(0),
+                  numElements(0), firstFreeSlotIndex(noSlotIndex) {
+            wavmAssert(maxIndex >= minIndex);
+        }
+
+        DenseIndexMap(const DenseIndexMap &) = delete;
+
+        DenseIndexMap &operator=(const DenseIndexMap &) = delete;
+
+        ~DenseIndexMap() {
+            for (Uptr slotIndex = 0; slotIndex < numSlots; ++slotIndex) {
+                if (slots[slotIndex].isOccupied) {
+                    slots[slotIndex].storage.destruct();
+                }
+            }
+            delete[] slots;
+        }
+
+        // Allocates an index, and adds the element to the map. The most recently freed index is
+        // allocated if there is one, and otherwise the index after the highest allocated index. If
+        // all possible indices are allocated, returns failIndex. Otherwise, returns the index the
+        // element was allocated at.
+        template<typename... Args> Index add(Index failIndex, Args &&... args) {
+            if (firstFreeSlotIndex == noSlotIndex) {
+                // If all possible indices are allocated, return failure.
+                if (numSlots > Uptr(maxIndex - minIndex)) {
+                    return failIndex;
+                }
+                addFreeSlots(numSlots + 1);
+            }
+
+            const Uptr slotIndex = firstFreeSlotIndex;
+            occupySlot(slotIndex, std::forward<Args>(args)...);
+            return Index(minIndex + slotIndex);
+        }
+
+        // Inserts an element at a specific index. If the index is already allocated, asserts.
+        template<typename... Args> void insertOrFail(Index index, Args &&... args) {
+            wavmAssert(index >= minIndex);
+            wavmAssert(index <= maxIndex);
+            const Uptr slotIndex = Uptr(index - minIndex);
+            if (slotIndex >= numSlots) {
+                addFreeSlots(slotIndex + 1);
+            }
+            wavmAssert(!slots[slotIndex].isOccupied);
+            occupySlot(slotIndex, std::forward<Args>(args)...);
+        }
+
+        // Removes an element by index. If there wasn't an allocated at the specified index,
+        // asserts.
+        void removeOrFail(Index index) {
+            wavmAssert(contains(index));
+            const Uptr slotIndex = Uptr(index - minIndex);
+            Slot &slot = slots[slotIndex];
+            slot.storage.destruct();
+            slot.isOccupied = false;
+            linkFreeSlot(slotIndex);
+            --numElements;
+
+            // Shrink the array past the free entries at its end.
+            while (numSlots && !slots[numSlots - 1].isOccupied) {
+                unlinkFreeSlot(numSlots - 1);
+                --numSlots;
+            }
+        }
+
+        // Returns whether the specified index is allocated.
+        bool contains(Index index) const {
+            wavmAssert(index >= minIndex);
+            wavmAssert(index <= maxIndex);
+            const Uptr slotIndex = Uptr(index - minIndex);
+            return slotIndex < numSlots && slots[slotIndex].isOccupied;
+        }
+
+        // Returns the element bound to the specified index. Behavior is undefined for if the index
+        // isn't allocated.
+        const Element &operator[](Index index) const {
+            wavmAssert(contains(index));
+            return slots[Uptr(index - minIndex)].storage.contents;
+        }
+
+        Element &operator[](Index index) {
+            wavmAssert(contains(index));
+            return slots[Uptr(index - minIndex)].storage.contents;
+        }
+
+        // Returns the number of allocated index/element pairs.
+        Uptr size() const {
+            return numElements;
+        }
+
+        Index getMinIndex() const {
+            return minIndex;
+        }
+
+        Index getMaxIndex() const {
+            return maxIndex;
+        }
+
+    private:
+        static constexpr Uptr noSlotIndex = UINTPTR_MAX;
+
+        struct Slot {
+            OptionalStorage<Element> storage;
+            bool isOccupied;
+
+            // If the slot isn't occupied, the previous and next free slots in the free list.
+            Uptr prevFreeSlotIndex;
+            Uptr nextFreeSlotIndex;
+        };
+
+    public:
+        struct Iterator {
+            template<typename, typename> friend struct DenseIndexMap;
+
+            bool operator!=(const Iterator &other) {
+                return slot != other.slot;
+            }
+
+            bool operator==(const Iterator &other) {
+                return slot == other.slot;
+            }
+
+            operator bool() const {
+                return slot < endSlot;
+            }
+
+            void operator++() {
+                do {
+                    ++slot;
+                } while (slot < endSlot && !slot->isOccupied);
+            }
+
+            const Element &operator*() const {
+                wavmAssert(slot->isOccupied);
+                return slot->storage.contents;
+            }
+
+            const Element *operator->() const {
+                wavmAssert(slot->isOccupied);
+                return &slot->storage.contents;
+            }
+
+        private:
+            const Slot *slot;
+            const Slot *endSlot;
+
+            Iterator(const Slot *inSlot, const Slot *inEndSlot) : slot(inSlot), endSlot(inEndSlot) {
+            }
+        };
+
+        Iterator begin() const {
+            // Find the first occupied slot.
+            const Slot *beginSlot = slots;
+            while (beginSlot < slots + numSlots && !beginSlot->isOccupied) {
+                ++beginSlot;
+            };
+            return Iterator(beginSlot, slots + numSlots);
+        }
+
+        Iterator end() const {
+            return Iterator(slots + numSlots, slots + numSlots);
+        }
+
+    private:
+        Index minIndex;
+        Index maxIndex;
+        Slot *slots;
+        Uptr numSlots;
+        Uptr numAllocatedSlots;
+        Uptr numElements;
+        Uptr firstFreeSlotIndex;
+
+        template<typename... Args> void occupySlot(Uptr slotIndex, Args &&... args) {
+            unlinkFreeSlot(slotIndex);
+            Slot &slot = slots[slotIndex];
+            slot.storage.construct(std::forward<Args>(args)...);
+            slot.isOccupied = true;
+            ++numElements;
+        }
+
+        // Extends the array to newNumSlots, and adds the new slots to the free list with the lowest
+        // index first.
+        void addFreeSlots(Uptr newNumSlots) {
+            wavmAssert(newNumSlots > numSlots);
+            if (newNumSlots > numAllocatedSlots) {
+                Uptr newNumAllocatedSlots = numAllocatedSlots ? numAllocatedSlots * 2 : 8;
+                if (newNumAllocatedSlots < newNumSlots) {
+                    newNumAllocatedSlots = newNumSlots;
+                }
+
+                // Move the elements to the new array.
+                Slot *newSlots = new Slot[newNumAllocatedSlots];
+                for (Uptr slotIndex = 0; slotIndex < numSlots; ++slotIndex) {
+                    Slot &oldSlot = slots[slotIndex];
+                    Slot &newSlot = newSlots[slotIndex];
+                    newSlot.isOccupied = oldSlot.isOccupied;
+                    newSlot.prevFreeSlotIndex = oldSlot.prevFreeSlotIndex;
+                    newSlot.nextFreeSlotIndex = oldSlot.nextFreeSlotIndex;
+                    if (oldSlot.isOccupied) {
+                        newSlot.storage.construct(std::move(oldSlot.storage.contents));
+                        oldSlot.storage.destruct();
+                    }
+                }
+                delete[] slots;
+                slots = newSlots;
+                numAllocatedSlots = newNumAllocatedSlots;
+            }
+
+            const Uptr oldNumSlots = numSlots;
+            numSlots = newNumSlots;
+            for (Uptr slotIndex = newNumSlots; slotIndex > oldNumSlots; --slotIndex) {
+                slots[slotIndex - 1].isOccupied = false;
+                linkFreeSlot(slotIndex - 1);
+            }
+        }
+
+        void linkFreeSlot(Uptr slotIndex) {
+            Slot &slot = slots[slotIndex];
+            slot.prevFreeSlotIndex = noSlotIndex;
+            slot.nextFreeSlotIndex = firstFreeSlotIndex;
+            if (firstFreeSlotIndex != noSlotIndex) {
+                slots[firstFreeSlotIndex].prevFreeSlotIndex = slotIndex;
+            }
+            firstFreeSlotIndex = slotIndex;
+        }
+
+        void unlinkFreeSlot(Uptr slotIndex) {
+            Slot &slot = slots[slotIndex];
+            wavmAssert(!slot.isOccupied);
+            if (slot.prevFreeSlotIndex != noSlotIndex) {
+                slots[slot.prevFreeSlotIndex].nextFreeSlotIndex = slot.nextFreeSlotIndex;
+            } else {
+                wavmAssert(firstFreeSlotIndex == slotIndex);
+                firstFreeSlotIndex = slot.nextFreeSlotIndex;
+            }
+            if (slot.nextFreeSlotIndex != noSlotIndex) {
+                slots[slot.nextFreeSlotIndex].prevFreeSlotIndex = slot.prevFreeSlotIndex;
+            }
+        }
+    };
+}
@@ -53,6 +53,21 @@ namespace WAVM {
             return maxIndexPlusOne;
         }
 
+        inline Index getLargestMember() const {
+            // Find the last element that has any bits set.
+            for (Uptr elementIndex = numElements; elementIndex > 0; --elementIndex) {
+                if (elements[elementIndex - 1]) {
+                    // Find the index of the highest set bit in the element using
+                    // countLeadingZeroes.
+                    const Index result = (Index) ((elementIndex - 1) * indicesPerElement + indicesPerElement - 1 -
+                                                  Platform::countLeadingZeroes(elements[elementIndex - 1]));
+                    wavmAssert(contains(result));
+                    return result;
+                }
+            }
+            return maxIndexPlusOne;
+        }
+
         inline Index getSmallestNonMember() const {
             // Find the first element that doesn't have all bits set.
             for (Uptr elementIndex = 0; elementIndex < numElements; ++elementIndex) {
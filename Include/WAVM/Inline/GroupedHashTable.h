@@ -0,0 +1,239 @@
+#pragma once
+
+#include <string.h>
+#include <type_traits>
+
+#include "Assert.h"
+#include "BasicTypes.h"
+#include "HashTable.h"
+#include "WAVM/Platform/Intrinsic.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace WAVM {
+    // The AllocPolicy that selects the GroupedHashTable layout. It keeps the table between 35% and
+    // 87.5% occupied by elements and deleted buckets: probing a group of buckets at once tolerates
+    // a higher load than the Robin Hood probing of HashTable.
+    struct GroupedHashTableAllocPolicy {
+        enum {
+            minBuckets = 16,
+            useGroupProbing = 1
+        };
+
+        static Uptr divideAndRoundUp(Uptr numerator, Uptr denominator) {
+            return (numerator + denominator - 1) / denominator;
+        }
+
+        static Uptr getMaxDesiredBuckets(Uptr numDesiredElements) {
+            const Uptr maxDesiredBuckets =
+                    Uptr(1) << WAVM::Platform::ceilLogTwo(divideAndRoundUp(numDesiredElements * 20, 7));
+            return maxDesiredBuckets < minBuckets ? minBuckets : maxDesiredBuckets;
+        }
+
+        static Uptr getMinDesiredBuckets(Uptr numDesiredElements) {
+            if (numDesiredElements == 0) {
+                return 0;
+            } else {
+                const Uptr minDesiredBuckets =
+                        Uptr(1) << WAVM::Platform::ceilLogTwo(divideAndRoundUp(numDesiredElements * 8, 7));
+                return minDesiredBuckets < minBuckets ? minBuckets : minDesiredBuckets;
+            }
+        }
+    };
+
+    // The control bytes of a group of buckets, which are compared to a byte 16 at a time. A
+    // comparison gives a mask with bucketMaskBits bits for each bucket in the group, of which only
+    // the lowest may be set.
+    struct HashTableGroup {
+        static constexpr Uptr numBuckets = 16;
+
+#if defined(__SSE2__) || defined(_M_X64)
+        static constexpr Uptr bucketMaskBits = 1;
+
+        __m128i controls;
+
+        HashTableGroup(const U8 *inControls)
+                : controls(_mm_loadu_si128(reinterpret_cast<const __m128i *>(inControls))) {
+        }
+
+        U64 match(U8 control) const {
+            return U64(_mm_movemask_epi8(_mm_cmpeq_epi8(controls, _mm_set1_epi8(char(control)))));
+        }
+
+        U64 matchEmptyOrDeleted() const {
+            return U64(_mm_movemask_epi8(controls));
+        }
+#elif defined(__ARM_NEON)
+        static constexpr Uptr bucketMaskBits = 4;
+
+        uint8x16_t controls;
+
+        HashTableGroup(const U8 *inControls) : controls(vld1q_u8(inControls)) {
+        }
+
+        U64 match(U8 control) const {
+            return getMask(vceqq_u8(controls, vdupq_n_u8(control)));
+        }
+
+        U64 matchEmptyOrDeleted() const {
+            return getMask(vcltzq_s8(vreinterpretq_s8_u8(controls)));
+        }
+
+        static U64 getMask(uint8x16_t matches) {
+            // Narrow each 16-bit lane to 8 bits, which leaves 4 bits for each bucket, and keep one.
+            const uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(matches), 4);
+            return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0) & 0x1111111111111111ull;
+        }
+#else
+        static constexpr Uptr bucketMaskBits = 1;
+
+        U8 controls[numBuckets];
+
+        HashTableGroup(const U8 *inControls) {
+            memcpy(controls, inControls, numBuckets);
+        }
+
+        U64 match(U8 control) const {
+            U64 mask = 0;
+            for (Uptr bucketIndex = 0; bucketIndex < numBuckets; ++bucketIndex) {
+                mask |= U64(controls[bucketIndex] == control) << bucketIndex;
+            }
+            return mask;
+        }
+
+        U64 matchEmptyOrDeleted() const {
+            U64 mask = 0;
+            for (Uptr bucketIndex = 0; bucketIndex < numBuckets; ++bucketIndex) {
+                mask |= U64(controls[bucketIndex] >> 7) << bucketIndex;
+            }
+            return mask;
+        }
+#endif
+
+        // The control byte of an occupied bucket is 7 bits derived from its element's hash, and the
+        // control bytes of empty and deleted buckets have the high bit set.
+        static constexpr U8 emptyControl = 0x80;
+        static constexpr U8 deletedControl = 0xfe;
+
+        U64 matchEmpty() const {
+            return match(emptyControl);
+        }
+
+        static Uptr getBucketIndex(U64 mask) {
+            return Uptr(Platform::countTrailingZeroes(mask)) / bucketMaskBits;
+        }
+    };
+
+    // An alternative layout for HashTable with the same interface, selected by an AllocPolicy with
+    // useGroupProbing set, e.g. GroupedHashTableAllocPolicy.
+    //
+    //   Besides the buckets, the table has a control byte for each bucket: 7 bits derived from the
+    // hash of the occupying element, or a marker for an empty or deleted bucket. The buckets are divided
+    // into groups of 16, and the hash of a key selects the group its search starts at. A search
+    // compares the key's 7 bits to all the control bytes of a group at once, and only reads
+    // the buckets whose control byte matches, so it rarely touches a bucket that doesn't hold the
+    // key. If the group has no empty bucket, the search continues to other groups in a triangular
+    // sequence, which visits every group since the number of groups is a power of two.
+    //
+    //   An element may be inserted in any empty or deleted bucket of the first group in its search
+    // sequence that has one. Removing an element empties its bucket if its group already has an
+    // empty bucket, since no search can have continued past the group then; otherwise, the bucket
+    // is marked as deleted, and reused by a later insertion or removed by the next resize.
+    //
+    //   The buckets still store the full hash of their elements, so resizing doesn't need to hash
+    // the keys again, and HashMap and HashSet iterate over buckets the same way for both layouts.
+    template<typename Key, typename Element, typename HashTablePolicy, typename AllocPolicy = GroupedHashTableAllocPolicy> struct GroupedHashTable {
+        typedef HashTableBucket<Element> Bucket;
+
+        GroupedHashTable(Uptr estimatedNumElements = 0);
+
+        GroupedHashTable(const GroupedHashTable &copy);
+
+        GroupedHashTable(GroupedHashTable &&movee);
+
+        ~GroupedHashTable();
+
+        GroupedHashTable &operator=(const GroupedHashTable &copyee);
+
+        GroupedHashTable &operator=(GroupedHashTable &&movee);
+
+        void clear();
+
+        void resize(Uptr newNumBuckets);
+
+        bool remove(Uptr hash, const Key &key);
+
+        const Bucket *getBucketForRead(Uptr hash, const Key &key) const;
+
+        Bucket *getBucketForModify(Uptr hash, const Key &key);
+
+        Bucket &getBucketForAdd(Uptr hash, const Key &key);
+
+        Uptr size() const {
+            return numElements;
+        }
+
+        Uptr numBuckets() const {
+            return hashToBucketIndexMask + 1;
+        }
+
+        Bucket *getBuckets() const {
+            return buckets;
+        }
+
+        // Compute some statistics about the space usage of this hash table. The probe counts are the
+        // number of groups a search for each element visits.
+        void analyzeSpaceUsage(Uptr &outTotalMemoryBytes, Uptr &outMaxProbeCount, F32 &outOccupancy, F32 &outAverageProbeCount) const;
+
+    private:
+        Bucket *buckets;
+        U8 *controls;
+        Uptr numElements;
+        Uptr numDeletedBuckets;
+        Uptr hashToBucketIndexMask;
+
+        // The control byte and group index are taken from the hash multiplied by a large odd
+        // constant, with its high half folded into its low half, so they depend on all the bits of
+        // the hash: some hashes, like the identity hash of a pointer, don't vary in their lowest
+        // bits.
+        static U64 mixHash(Uptr hash) {
+            const U64 product = U64(hash & Bucket::hashMask) * 0x9e3779b97f4a7c15ull;
+            return product ^ (product >> 32);
+        }
+
+        static U8 getControl(Uptr hash) {
+            return U8(mixHash(hash) & 0x7f);
+        }
+
+        Uptr getGroupIndex(Uptr hash) const {
+            return Uptr(mixHash(hash) >> 7) & (hashToBucketIndexMask / HashTableGroup::numBuckets);
+        }
+
+        Uptr getNextGroupIndex(Uptr groupIndex, Uptr probeCount) const {
+            return (groupIndex + probeCount) & (hashToBucketIndexMask / HashTableGroup::numBuckets);
+        }
+
+        void allocateBuckets(Uptr newNumBuckets);
+
+        Bucket &getBucketForWrite(Uptr hash, const Key &key);
+
+        void destruct();
+
+        void copyFrom(const GroupedHashTable &copy);
+
+        void moveFrom(GroupedHashTable &&movee);
+    };
+
+    // The hash table layout selected by an AllocPolicy.
+    template<typename Key, typename Element, typename HashTablePolicy, typename AllocPolicy> using HashTableForAllocPolicy =
+    typename std::conditional<AllocPolicy::useGroupProbing, GroupedHashTable<Key, Element, HashTablePolicy, AllocPolicy>, HashTable<Key, Element, HashTablePolicy, AllocPolicy>>::type;
+
+// The implementation is defined in a separate file.
+
+#include "GroupedHashTableImpl.h"
+
+}
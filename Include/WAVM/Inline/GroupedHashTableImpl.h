@@ -0,0 +1,319 @@
+// IWYU pragma: private, include "Inline/GroupedHashTable.h"
+// You should only include this file indirectly by including HashMap.h.
+
+// Use these macros to compress the boilerplate template declarations in a non-inline member
+// function definition for GroupedHashTable.
+#define HASHTABLE_PARAMETERS                                                                       \
+    typename Key, typename Element, typename HashTablePolicy, typename AllocPolicy
+#define HASHTABLE_ARGUMENTS Key, Element, HashTablePolicy, AllocPolicy
+
+template<HASHTABLE_PARAMETERS> void GroupedHashTable<HASHTABLE_ARGUMENTS>::allocateBuckets(Uptr newNumBuckets) {
+    wavmAssert(!(newNumBuckets & (newNumBuckets - 1)));
+    wavmAssert(!(newNumBuckets % HashTableGroup::numBuckets));
+    buckets = new Bucket[newNumBuckets]();
+    controls = new U8[newNumBuckets];
+    memset(controls, HashTableGroup::emptyControl, newNumBuckets);
+    numDeletedBuckets = 0;
+    hashToBucketIndexMask = newNumBuckets - 1;
+}
+
+template<HASHTABLE_PARAMETERS> void GroupedHashTable<HASHTABLE_ARGUMENTS>::clear() {
+    destruct();
+    buckets = nullptr;
+    controls = nullptr;
+    numElements = 0;
+    numDeletedBuckets = 0;
+    hashToBucketIndexMask = UINTPTR_MAX;
+}
+
+template<HASHTABLE_PARAMETERS> void GroupedHashTable<HASHTABLE_ARGUMENTS>::resize(Uptr newNumBuckets) {
+    const Uptr oldNumBuckets = numBuckets();
+    Bucket *oldBuckets = buckets;
+    U8 *oldControls = controls;
+
+    if (!newNumBuckets) {
+        wavmAssert(!numElements);
+        buckets = nullptr;
+        controls = nullptr;
+        numDeletedBuckets = 0;
+        hashToBucketIndexMask = UINTPTR_MAX;
+    } else {
+        allocateBuckets(newNumBuckets);
+    }
+
+    if (numElements) {
+        wavmAssert(oldBuckets);
+        wavmAssert(buckets);
+
+        // Iterate over the old buckets, and move their contents to the first empty bucket in the
+        // search sequence of their hash. The new buckets don't contain any of the keys, so they
+        // don't need to be compared.
+        for (Uptr oldBucketIndex = 0; oldBucketIndex < oldNumBuckets; ++oldBucketIndex) {
+            Bucket &oldBucket = oldBuckets[oldBucketIndex];
+            if (oldBucket.hashAndOccupancy) {
+                Uptr groupIndex = getGroupIndex(oldBucket.hashAndOccupancy);
+                Uptr probeCount = 0;
+                U64 emptyMask;
+                while (!(emptyMask = HashTableGroup(controls + groupIndex * HashTableGroup::numBuckets).matchEmpty())) {
+                    groupIndex = getNextGroupIndex(groupIndex, ++probeCount);
+                };
+                const Uptr bucketIndex = groupIndex * HashTableGroup::numBuckets + HashTableGroup::getBucketIndex(emptyMask);
+
+                Bucket &newBucket = buckets[bucketIndex];
+                controls[bucketIndex] = getControl(oldBucket.hashAndOccupancy);
+                newBucket.storage.construct(std::move(oldBucket.storage.contents));
+                newBucket.hashAndOccupancy = oldBucket.hashAndOccupancy;
+                oldBucket.storage.destruct();
+            }
+        }
+    }
+
+    // Free the old buckets.
+    delete[] oldBuckets;
+    delete[] oldControls;
+}
+
+template<HASHTABLE_PARAMETERS> bool GroupedHashTable<HASHTABLE_ARGUMENTS>::remove(Uptr hash, const Key &key) {
+    // Find the bucket (if any) holding the key.
+    Bucket *bucket = getBucketForModify(hash, key);
+    if (!bucket) {
+        return false;
+    } else {
+        // Remove the element in the bucket. If its group has an empty bucket, no search continued
+        // past the group, so the bucket can be emptied too. Otherwise, searches that continued
+        // past the group must not stop at it, so mark it as deleted.
+        const Uptr bucketIndex = bucket - buckets;
+        const Uptr groupBeginBucketIndex = bucketIndex & ~(HashTableGroup::numBuckets - 1);
+        if (HashTableGroup(controls + groupBeginBucketIndex).matchEmpty()) {
+            controls[bucketIndex] = HashTableGroup::emptyControl;
+        } else {
+            controls[bucketIndex] = HashTableGroup::deletedControl;
+            ++numDeletedBuckets;
+        }
+        bucket->storage.destruct();
+        bucket->hashAndOccupancy = 0;
+
+        // Decrease the number of elements and resize the table if the occupancy is too low.
+        --numElements;
+        const Uptr maxDesiredBuckets = AllocPolicy::getMaxDesiredBuckets(numElements);
+        if (numBuckets() > maxDesiredBuckets) {
+            resize(maxDesiredBuckets);
+        }
+
+        return true;
+    }
+}
+
+template<HASHTABLE_PARAMETERS> const HashTableBucket <Element> *GroupedHashTable<HASHTABLE_ARGUMENTS>::getBucketForRead(Uptr hash, const Key &key) const {
+    if (!buckets) {
+        return nullptr;
+    }
+
+    const Uptr hashAndOccupancy = hash | Bucket::isOccupiedMask;
+    const U8 control = getControl(hash);
+    Uptr groupIndex = getGroupIndex(hash);
+    Uptr probeCount = 0;
+    while (true) {
+        // Check the buckets in the group whose control byte matches the hash.
+        const HashTableGroup group(controls + groupIndex * HashTableGroup::numBuckets);
+        for (U64 matchMask = group.match(control); matchMask; matchMask &= matchMask - 1) {
+            const Bucket &bucket = buckets[groupIndex * HashTableGroup::numBuckets + HashTableGroup::getBucketIndex(matchMask)];
+            if (bucket.hashAndOccupancy == hashAndOccupancy &&
+                HashTablePolicy::areKeysEqual(HashTablePolicy::getKey(bucket.storage.contents), key)) {
+                return &bucket;
+            }
+        }
+
+        // If the group has an empty bucket, the key would have been inserted in this group or an
+        // earlier one, so return null. Otherwise, continue to the next group.
+        if (group.matchEmpty()) {
+            return nullptr;
+        }
+        groupIndex = getNextGroupIndex(groupIndex, ++probeCount);
+        wavmAssert(probeCount * HashTableGroup::numBuckets < numBuckets());
+    };
+}
+
+template<HASHTABLE_PARAMETERS> HashTableBucket <Element> *GroupedHashTable<HASHTABLE_ARGUMENTS>::getBucketForModify(Uptr hash, const Key &key) {
+    return const_cast<Bucket *>(getBucketForRead(hash, key));
+}
+
+template<HASHTABLE_PARAMETERS> HashTableBucket <Element> &GroupedHashTable<HASHTABLE_ARGUMENTS>::getBucketForAdd(Uptr hash, const Key &key) {
+    // Make sure there's enough space to add a new key to the table. Deleted buckets count toward
+    // the occupancy, since they lengthen searches like elements do; if they are what fills the
+    // table, resizing it to the same number of buckets removes them.
+    const Uptr minDesiredBuckets = AllocPolicy::getMinDesiredBuckets(numElements + numDeletedBuckets + 1);
+    if (numBuckets() < minDesiredBuckets) {
+        resize(AllocPolicy::getMinDesiredBuckets(numElements + 1));
+    }
+
+    // Find the bucket to write the new key to.
+    Bucket &bucket = getBucketForWrite(hash, key);
+
+    // If the bucket is empty, increment the number of elements in the table.
+    // The caller is expected to fill the bucket once this function returns.
+    if (!bucket.hashAndOccupancy) {
+        ++numElements;
+    } else {
+        wavmAssert(bucket.hashAndOccupancy == (hash | Bucket::isOccupiedMask));
+    }
+
+    return bucket;
+}
+
+template<HASHTABLE_PARAMETERS> HashTableBucket <Element> &GroupedHashTable<HASHTABLE_ARGUMENTS>::getBucketForWrite(Uptr hash, const Key &key) {
+    wavmAssert(buckets);
+
+    const Uptr hashAndOccupancy = hash | Bucket::isOccupiedMask;
+    const U8 control = getControl(hash);
+    Uptr groupIndex = getGroupIndex(hash);
+    Uptr probeCount = 0;
+    Uptr insertBucketIndex = UINTPTR_MAX;
+    while (true) {
+        // If a bucket in the group already holds the specified key, return it.
+        const HashTableGroup group(controls + groupIndex * HashTableGroup::numBuckets);
+        for (U64 matchMask = group.match(control); matchMask; matchMask &= matchMask - 1) {
+            Bucket &bucket = buckets[groupIndex * HashTableGroup::numBuckets + HashTableGroup::getBucketIndex(matchMask)];
+            if (bucket.hashAndOccupancy == hashAndOccupancy &&
+                HashTablePolicy::areKeysEqual(HashTablePolicy::getKey(bucket.storage.contents), key)) {
+                return bucket;
+            }
+        }
+
+        // Remember the first empty or deleted bucket in the search sequence, which the key is
+        // inserted in if the search doesn't find it.
+        if (insertBucketIndex == UINTPTR_MAX) {
+            const U64 emptyOrDeletedMask = group.matchEmptyOrDeleted();
+            if (emptyOrDeletedMask) {
+                insertBucketIndex = groupIndex * HashTableGroup::numBuckets + HashTableGroup::getBucketIndex(emptyOrDeletedMask);
+            }
+        }
+
+        if (group.matchEmpty()) {
+            break;
+        }
+        groupIndex = getNextGroupIndex(groupIndex, ++probeCount);
+        wavmAssert(probeCount * HashTableGroup::numBuckets < numBuckets());
+    };
+
+    // Claim the bucket for the key's hash, so later searches check it.
+    wavmAssert(insertBucketIndex != UINTPTR_MAX);
+    if (controls[insertBucketIndex] == HashTableGroup::deletedControl) {
+        --numDeletedBuckets;
+    }
+    controls[insertBucketIndex] = control;
+    return buckets[insertBucketIndex];
+}
+
+template<HASHTABLE_PARAMETERS> void GroupedHashTable<HASHTABLE_ARGUMENTS>::analyzeSpaceUsage(Uptr &outTotalMemoryBytes, Uptr &outMaxProbeCount, F32 &outOccupancy, F32 &outAverageProbeCount) const {
+    outTotalMemoryBytes = (sizeof(Bucket) + sizeof(U8)) * numBuckets() + sizeof(*this);
+    outOccupancy = size() / F32(numBuckets());
+
+    outMaxProbeCount = 0;
+    outAverageProbeCount = 0.0f;
+    for (Uptr bucketIndex = 0; bucketIndex < numBuckets(); ++bucketIndex) {
+        if (buckets[bucketIndex].hashAndOccupancy) {
+            const Uptr bucketGroupIndex = bucketIndex / HashTableGroup::numBuckets;
+            Uptr groupIndex = getGroupIndex(buckets[bucketIndex].hashAndOccupancy);
+            Uptr probeCount = 1;
+            while (groupIndex != bucketGroupIndex) {
+                groupIndex = getNextGroupIndex(groupIndex, probeCount++);
+            };
+
+            outMaxProbeCount = probeCount > outMaxProbeCount ? probeCount : outMaxProbeCount;
+            outAverageProbeCount += probeCount / F32(numElements);
+        }
+    }
+}
+
+template<HASHTABLE_PARAMETERS> GroupedHashTable<HASHTABLE_ARGUMENTS>::GroupedHashTable(Uptr estimatedNumElements)
+        : buckets(nullptr), controls(nullptr), numElements(0), numDeletedBuckets(0), hashToBucketIndexMask(UINTPTR_MAX) {
+    const Uptr numBuckets = AllocPolicy::getMinDesiredBuckets(estimatedNumElements);
+    if (numBuckets) {
+        // Allocate the initial buckets.
+        allocateBuckets(numBuckets);
+    }
+}
+
+template<HASHTABLE_PARAMETERS> GroupedHashTable<HASHTABLE_ARGUMENTS>::GroupedHashTable(const GroupedHashTable &copy) {
+    copyFrom(copy);
+}
+
+template<HASHTABLE_PARAMETERS> GroupedHashTable<HASHTABLE_ARGUMENTS>::GroupedHashTable(GroupedHashTable &&movee) {
+    moveFrom(std::move(movee));
+}
+
+template<HASHTABLE_PARAMETERS> GroupedHashTable<HASHTABLE_ARGUMENTS>::~GroupedHashTable() {
+    destruct();
+}
+
+template<HASHTABLE_PARAMETERS> GroupedHashTable <HASHTABLE_ARGUMENTS> &GroupedHashTable<HASHTABLE_ARGUMENTS>::operator=(const GroupedHashTable <HASHTABLE_ARGUMENTS> &copyee) {
+    // Do nothing if copying from this.
+    if (this != &copyee) {
+        destruct();
+        copyFrom(copyee);
+    }
+    return *this;
+}
+
+template<HASHTABLE_PARAMETERS> GroupedHashTable <HASHTABLE_ARGUMENTS> &GroupedHashTable<HASHTABLE_ARGUMENTS>::operator=(GroupedHashTable <HASHTABLE_ARGUMENTS> &&movee) {
+    // Do nothing if moving from this.
+    if (this != &movee) {
+        destruct();
+        moveFrom(std::move(movee));
+    }
+    return *this;
+}
+
+template<HASHTABLE_PARAMETERS> void GroupedHashTable<HASHTABLE_ARGUMENTS>::destruct() {
+    if (buckets) {
+        for (Uptr bucketIndex = 0; bucketIndex < numBuckets(); ++bucketIndex) {
+            if (buckets[bucketIndex].hashAndOccupancy) {
+                buckets[bucketIndex].storage.destruct();
+            }
+        }
+
+        delete[] buckets;
+        delete[] controls;
+        buckets = nullptr;
+        controls = nullptr;
+    }
+}
+
+template<HASHTABLE_PARAMETERS> void GroupedHashTable<HASHTABLE_ARGUMENTS>::copyFrom(const GroupedHashTable &copy) {
+    numElements = copy.numElements;
+    numDeletedBuckets = copy.numDeletedBuckets;
+    hashToBucketIndexMask = copy.hashToBucketIndexMask;
+
+    if (!copy.buckets) {
+        buckets = nullptr;
+        controls = nullptr;
+    } else {
+        buckets = new Bucket[copy.numBuckets()];
+        controls = new U8[copy.numBuckets()];
+        memcpy(controls, copy.controls, copy.numBuckets());
+        for (Uptr bucketIndex = 0; bucketIndex < numBuckets(); ++bucketIndex) {
+            buckets[bucketIndex].hashAndOccupancy = copy.buckets[bucketIndex].hashAndOccupancy;
+            if (buckets[bucketIndex].hashAndOccupancy) {
+                buckets[bucketIndex].storage.construct(copy.buckets[bucketIndex].storage.contents);
+            }
+        }
+    }
+}
+
+template<HASHTABLE_PARAMETERS> void GroupedHashTable<HASHTABLE_ARGUMENTS>::moveFrom(GroupedHashTable &&movee) {
+    numElements = movee.numElements;
+    numDeletedBuckets = movee.numDeletedBuckets;
+    hashToBucketIndexMask = movee.hashToBucketIndexMask;
+    buckets = movee.buckets;
+    controls = movee.controls;
+
+    movee.numElements = 0;
+    movee.numDeletedBuckets = 0;
+    movee.hashToBucketIndexMask = UINTPTR_MAX;
+    movee.buckets = nullptr;
+    movee.controls = nullptr;
+}
+
+#undef HASHTABLE_PARAMETERS
+#undef HASHTABLE_ARGUMENTS
@@ -3,6 +3,7 @@
 #include "WAVM/Inline/Assert.h"
 #include "WAVM/Inline/BasicTypes.h"
 #include "WAVM/Inline/Hash.h"
+#include "WAVM/Inline/GroupedHashTable.h"
 #include "WAVM/Inline/HashTable.h"
 
 #include <initializer_list>
@@ -18,7 +19,7 @@ namespace WAVM {
     };
 
     template<typename Key, typename Value> struct HashMapIterator {
-        template<typename, typename, typename> friend struct HashMap;
+        template<typename, typename, typename, typename> friend struct HashMap;
 
         typedef HashMapPair<Key, Value> Pair;
 
@@ -41,7 +42,9 @@ namespace WAVM {
         HashMapIterator(const HashTableBucket<Pair> *inBucket, const HashTableBucket<Pair> *inEndBucket);
     };
 
-    template<typename Key, typename Value, typename KeyHashPolicy = DefaultHashPolicy<Key>> struct HashMap {
+    // The AllocPolicy selects the layout of the map's hash table, as well as its occupancy: see
+    // HashTable and GroupedHashTable.
+    template<typename Key, typename Value, typename KeyHashPolicy = DefaultHashPolicy<Key>, typename AllocPolicy = DefaultHashTableAllocPolicy> struct HashMap {
         typedef HashMapPair<Key, Value> Pair;
         typedef HashMapIterator<Key, Value> Iterator;
 
@@ -114,7 +117,7 @@ namespace WAVM {
             }
         };
 
-        HashTable<Key, Pair, HashTablePolicy> table;
+        HashTableForAllocPolicy<Key, Pair, HashTablePolicy, AllocPolicy> table;
     };
 
 // The implementation is defined in a separate file.
@@ -3,13 +3,14 @@
 #include "WAVM/Inline/Assert.h"
 #include "WAVM/Inline/BasicTypes.h"
 #include "WAVM/Inline/Hash.h"
+#include "WAVM/Inline/GroupedHashTable.h"
 #include "WAVM/Inline/HashTable.h"
 
 #include <initializer_list>
 
 namespace WAVM {
     template<typename Element> struct HashSetIterator {
-        template<typename, typename> friend struct HashSet;
+        template<typename, typename, typename> friend struct HashSet;
 
         bool operator!=(const HashSetIterator &other);
 
@@ -30,7 +31,9 @@ namespace WAVM {
         HashSetIterator(const HashTableBucket<Element> *inBucket, const HashTableBucket<Element> *inEndBucket);
     };
 
-    template<typename Element, typename ElementHashPolicy = DefaultHashPolicy<Element>> struct HashSet {
+    // The AllocPolicy selects the layout of the set's hash table, as well as its occupancy: see
+    // HashTable and GroupedHashTable.
+    template<typename Element, typename ElementHashPolicy = DefaultHashPolicy<Element>, typename AllocPolicy = DefaultHashTableAllocPolicy> struct HashSet {
         HashSet(Uptr reserveNumElements = 0);
 
         HashSet(const std::initializer_list<Element> &initializerList);
@@ -87,7 +90,7 @@ namespace WAVM {
             }
         };
 
-        HashTable<Element, Element, HashTablePolicy> table;
+        HashTableForAllocPolicy<Element, Element, HashTablePolicy, AllocPolicy> table;
     };
 
 // The implementation is defined in a separate file.
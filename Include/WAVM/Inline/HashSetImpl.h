@@ -38,11 +38,11 @@ template<typename Element> HashSetIterator<Element>::HashSetIterator(const HashT
         : bucket(inBucket), endBucket(inEndBucket) {
 }
 
-template<typename Element, typename ElementHashPolicy> HashSet<Element, ElementHashPolicy>::HashSet(Uptr reserveNumElements)
+template<typename Element, typename ElementHashPolicy, typename AllocPolicy> HashSet<Element, ElementHashPolicy, AllocPolicy>::HashSet(Uptr reserveNumElements)
         : table(reserveNumElements) {
 }
 
-template<typename Element, typename ElementHashPolicy> HashSet<Element, ElementHashPolicy>::HashSet(const std::initializer_list<Element> &initializerList)
+template<typename Element, typename ElementHashPolicy, typename AllocPolicy> HashSet<Element, ElementHashPolicy, AllocPolicy>::HashSet(const std::initializer_list<Element> &initializerList)
         : table(initializerList.size()) {
     for (const Element &element : initializerList) {
         const bool result = add(element);
@@ -50,7 +50,7 @@ template<typename Element, typename ElementHashPolicy> HashSet<Element, ElementH
     }
 }
 
-template<typename Element, typename ElementHashPolicy> bool HashSet<Element, ElementHashPolicy>::add(const Element &element) {
+template<typename Element, typename ElementHashPolicy, typename AllocPolicy> bool HashSet<Element, ElementHashPolicy, AllocPolicy>::add(const Element &element) {
     const Uptr hash = ElementHashPolicy::getKeyHash(element);
     HashTableBucket<Element> &bucket = table.getBucketForAdd(hash, element);
     if (bucket.hashAndOccupancy != 0) {
@@ -62,7 +62,7 @@ template<typename Element, typename ElementHashPolicy> bool HashSet<Element, Ele
     }
 }
 
-template<typename Element, typename ElementHashPolicy> void HashSet<Element, ElementHashPolicy>::addOrFail(const Element &element) {
+template<typename Element, typename ElementHashPolicy, typename AllocPolicy> void HashSet<Element, ElementHashPolicy, AllocPolicy>::addOrFail(const Element &element) {
     const Uptr hash = ElementHashPolicy::getKeyHash(element);
     HashTableBucket<Element> &bucket = table.getBucketForAdd(hash, element);
     wavmAssert(!bucket.hashAndOccupancy);
@@ -70,16 +70,16 @@ template<typename Element, typename ElementHashPolicy> void HashSet<Element, Ele
     bucket.storage.construct(element);
 }
 
-template<typename Element, typename ElementHashPolicy> bool HashSet<Element, ElementHashPolicy>::remove(const Element &element) {
+template<typename Element, typename ElementHashPolicy, typename AllocPolicy> bool HashSet<Element, ElementHashPolicy, AllocPolicy>::remove(const Element &element) {
     return table.remove(ElementHashPolicy::getKeyHash(element), element);
 }
 
-template<typename Element, typename ElementHashPolicy> void HashSet<Element, ElementHashPolicy>::removeOrFail(const Element &element) {
+template<typename Element, typename ElementHashPolicy, typename AllocPolicy> void HashSet<Element, ElementHashPolicy, AllocPolicy>::removeOrFail(const Element &element) {
     const bool removed = table.remove(ElementHashPolicy::getKeyHash(element), element);
     wavmAssert(removed);
 }
 
-template<typename Element, typename ElementHashPolicy> const Element &HashSet<Element, ElementHashPolicy>::operator[](const Element &element) const {
+template<typename Element, typename ElementHashPolicy, typename AllocPolicy> const Element &HashSet<Element, ElementHashPolicy, AllocPolicy>::operator[](const Element &element) const {
     const Uptr hash = ElementHashPolicy::getKeyHash(element);
     const HashTableBucket<Element> *bucket = table.getBucketForRead(hash, element);
     wavmAssert(bucket);
@@ -87,14 +87,14 @@ template<typename Element, typename ElementHashPolicy> const Element &HashSet<El
     return bucket->storage.contents;
 }
 
-template<typename Element, typename ElementHashPolicy> bool HashSet<Element, ElementHashPolicy>::contains(const Element &element) const {
+template<typename Element, typename ElementHashPolicy, typename AllocPolicy> bool HashSet<Element, ElementHashPolicy, AllocPolicy>::contains(const Element &element) const {
     const Uptr hash = ElementHashPolicy::getKeyHash(element);
     const HashTableBucket<Element> *bucket = table.getBucketForRead(hash, element);
     wavmAssert(!bucket || bucket->hashAndOccupancy == (hash | HashTableBucket<Element>::isOccupiedMask));
     return bucket != nullptr;
 }
 
-template<typename Element, typename ElementHashPolicy> const Element *HashSet<Element, ElementHashPolicy>::get(const Element &element) const {
+template<typename Element, typename ElementHashPolicy, typename AllocPolicy> const Element *HashSet<Element, ElementHashPolicy, AllocPolicy>::get(const Element &element) const {
     const Uptr hash = ElementHashPolicy::getKeyHash(element);
     const HashTableBucket<Element> *bucket = table.getBucketForRead(hash, element);
     if (!bucket) {
@@ -105,11 +105,11 @@ template<typename Element, typename ElementHashPolicy> const Element *HashSet<El
     }
 }
 
-template<typename Element, typename ElementHashPolicy> void HashSet<Element, ElementHashPolicy>::clear() {
+template<typename Element, typename ElementHashPolicy, typename AllocPolicy> void HashSet<Element, ElementHashPolicy, AllocPolicy>::clear() {
     table.clear();
 }
 
-template<typename Element, typename ElementHashPolicy> HashSetIterator <Element> HashSet<Element, ElementHashPolicy>::begin() const {
+template<typename Element, typename ElementHashPolicy, typename AllocPolicy> HashSetIterator <Element> HashSet<Element, ElementHashPolicy, AllocPolicy>::begin() const {
     // Find the first occupied bucket.
     HashTableBucket<Element> *beginBucket = table.getBuckets();
     HashTableBucket<Element> *endBucket = table.getBuckets() + table.numBuckets();
@@ -119,15 +119,15 @@ template<typename Element, typename ElementHashPolicy> HashSetIterator <Element>
     return HashSetIterator<Element>(beginBucket, endBucket);
 }
 
-template<typename Element, typename ElementHashPolicy> HashSetIterator <Element> HashSet<Element, ElementHashPolicy>::end() const {
+template<typename Element, typename ElementHashPolicy, typename AllocPolicy> HashSetIterator <Element> HashSet<Element, ElementHashPolicy, AllocPolicy>::end() const {
     return HashSetIterator<Element>(table.getBuckets() + table.numBuckets(), table.getBuckets() + table.numBuckets());
 }
 
-template<typename Element, typename ElementHashPolicy> Uptr HashSet<Element, ElementHashPolicy>::size() const {
+template<typename Element, typename ElementHashPolicy, typename AllocPolicy> Uptr HashSet<Element, ElementHashPolicy, AllocPolicy>::size() const {
     return table.size();
 }
 
-template<typename Element, typename ElementHashPolicy> void HashSet<Element, ElementHashPolicy>::analyzeSpaceUsage(Uptr &outTotalMemoryBytes, Uptr &outMaxProbeCount, F32 &outOccupancy, F32 &outAverageProbeCount) const {
+template<typename Element, typename ElementHashPolicy, typename AllocPolicy> void HashSet<Element, ElementHashPolicy, AllocPolicy>::analyzeSpaceUsage(Uptr &outTotalMemoryBytes, Uptr &outMaxProbeCount, F32 &outOccupancy, F32 &outAverageProbeCount) const {
     return table.analyzeSpaceUsage(outTotalMemoryBytes, outMaxProbeCount, outOccupancy, outAverageProbeCount);
 }
 
@@ -8,7 +8,8 @@
 namespace WAVM {
     struct DefaultHashTableAllocPolicy {
         enum {
-            minBuckets = 8
+            minBuckets = 8,
+            useGroupProbing = 0
         };
 
         static Uptr divideAndRoundUp(Uptr numerator, Uptr denominator) {
@@ -5,7 +5,8 @@
 
 namespace WAVM {
     // A map that's somewhere between an array and a HashMap.
-    // It's keyed by a range of integers, but sparsely maps those integers to elements.
+    // It's keyed by a range of integers, but sparsely maps those integers to elements. For indices
+    // that are mostly allocated, DenseIndexMap has the same interface with O(1) allocation.
     template<typename Index, typename Element> struct IndexMap {
         IndexMap(Index inMinIndex, Index inMaxIndex) : lastIndex(inMinIndex - 1), minIndex(inMinIndex),
                                                        maxIndex(inMaxIndex) {
@@ -21,4 +21,25 @@ namespace WAVM {
     private:
         Mutex *mutex;
     };
+
+    // RAII-style shared lock of a reader/writer mutex.
+    template<typename Mutex> struct SharedLock {
+        SharedLock(Mutex &inMutex) : mutex(&inMutex) {
+            mutex->lockShared();
+        }
+
+        ~SharedLock() {
+            unlock();
+        }
+
+        void unlock() {
+            if (mutex) {
+                mutex->unlockShared();
+                mutex = nullptr;
+            }
+        }
+
+    private:
+        Mutex *mutex;
+    };
 }
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+
+#include "WAVM/Inline/BasicTypes.h"
+
+namespace WAVM {
+    // Returns the number of threads to use for items that take about numWorkUnits in total, if a
+    // thread is only worth starting for at least minWorkUnitsPerThread of them.
+    inline Uptr getNumParallelThreads(Uptr numWorkUnits, Uptr minWorkUnitsPerThread) {
+        const Uptr numHardwareThreads = std::max(Uptr(std::thread::hardware_concurrency()), Uptr(1));
+        return std::max(std::min(numHardwareThreads, numWorkUnits / minWorkUnitsPerThread), Uptr(1));
+    }
+
+    // Calls body(threadIndex, itemIndex) for each item index in [0, numItems) on numThreads threads,
+    // one of which is the calling thread. Items are started in increasing order. If body throws, no
+    // more items are started, and once the items in progress finish, the exception thrown by the
+    // lowest item index is rethrown: the same exception a serial loop over the items would throw.
+    template<typename Body> void parallelFor(Uptr numItems, Uptr numThreads, Body &&body) {
+        if (numThreads <= 1 || numItems <= 1) {
+            for (Uptr itemIndex = 0; itemIndex < numItems; ++itemIndex) {
+                body(Uptr(0), itemIndex);
+            }
+            return;
+        }
+
+        std::atomic<Uptr> nextItemIndex{0};
+        std::atomic<bool> hasFailed{false};
+        std::vector<Uptr> threadFailedItemIndices(numThreads, UINTPTR_MAX);
+        std::vector<std::exception_ptr> threadExceptions(numThreads);
+        auto threadEntry = [&](Uptr threadIndex) {
+            while (!hasFailed.load(std::memory_order_relaxed)) {
+                const Uptr itemIndex = nextItemIndex++;
+                if (itemIndex >= numItems) {
+                    break;
+                }
+                try {
+                    body(threadIndex, itemIndex);
+                } catch (...) {
+                    threadFailedItemIndices[threadIndex] = itemIndex;
+                    threadExceptions[threadIndex] = std::current_exception();
+                    hasFailed.store(true, std::memory_order_relaxed);
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (Uptr threadIndex = 1; threadIndex < numThreads; ++threadIndex) {
+            threads.emplace_back(threadEntry, threadIndex);
+        }
+        threadEntry(0);
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+
+        // Each thread stops after its first exception, so the lowest failed item index of all the
+        // threads is the first item that failed.
+        Uptr failedThreadIndex = UINTPTR_MAX;
+        for (Uptr threadIndex = 0; threadIndex < numThreads; ++threadIndex) {
+            if (threadExceptions[threadIndex] &&
+                (failedThreadIndex == UINTPTR_MAX ||
+                 threadFailedItemIndices[threadIndex] < threadFailedItemIndices[failedThreadIndex])) {
+                failedThreadIndex = threadIndex;
+            }
+        }
+        if (failedThreadIndex != UINTPTR_MAX) {
+            std::rethrow_exception(threadExceptions[failedThreadIndex]);
+        }
+    }
+}
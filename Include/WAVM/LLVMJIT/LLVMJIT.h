@@ -5,6 +5,7 @@
 #include <vector>
 
 #include "WAVM/IR/Types.h"
+#include "WAVM/IR/Value.h"
 #include "WAVM/Inline/BasicTypes.h"
 #include "WAVM/Inline/HashMap.h"
 #include "WAVM/Runtime/RuntimeData.h"
@@ -29,8 +30,244 @@ namespace WAVM {
 
 namespace WAVM {
     namespace LLVMJIT {
-        // Compiles a module to object code.
-        LLVMJIT_API std::vector<U8> compileModule(const IR::Module &irModule);
+        // How much effort compileModule spends optimizing the generated code.
+        enum class OptimizationLevel : U8 {
+            // Only promote locals to SSA values: the fastest compile, for code that runs briefly.
+            O0,
+            // A few cheap function passes that clean up the emitted IR. The default.
+            O1,
+            // The standard LLVM function and module pipeline, including inlining, GVN, LICM, and the
+            // loop vectorizer.
+            O2,
+            // The O2 pipeline with more aggressive inlining and code generation, and the SLP
+            // vectorizer.
+            O3,
+        };
+
+        // The number of times a conditional branch was taken and not taken.
+        struct BranchProfile {
+            U64 numTaken = 0;
+            U64 numNotTaken = 0;
+        };
+
+        struct CallIndirectTargetProfile {
+            Uptr functionDefIndex;
+            U64 numCalls;
+        };
+
+        // The most called function definitions of the module at a call_indirect, and the number of
+        // calls to other functions.
+        struct CallIndirectProfile {
+            std::vector<CallIndirectTargetProfile> targets;
+            U64 numOtherCalls = 0;
+        };
+
+        // An execution profile of a function definition, counted by code compiled with
+        // CompileOptions::enableProfileCounters. The branches are the function's reachable if and
+        // br_if operators, and the call_indirects its reachable call_indirect operators, both in
+        // the order they occur in the function's code.
+        struct FunctionProfile {
+            U64 numCalls = 0;
+            std::vector<BranchProfile> branches;
+            std::vector<CallIndirectProfile> callIndirects;
+        };
+
+        // An execution profile of a module, indexed by function definition index.
+        struct ModuleProfile {
+            std::vector<FunctionProfile> functionDefs;
+        };
+
+        // The layout of the profile counters of a function definition compiled with
+        // CompileOptions::enableProfileCounters, which is an array of U64 in the function's object
+        // code. The array starts with the number of branches and the number of call_indirects,
+        // followed by a taken and a not taken counter for each branch, and then for each
+        // call_indirect, a pair of Runtime::Function address and call counter for each of the first
+        // numProfiledCallIndirectTargets functions it called, and a counter of the other calls.
+        static constexpr Uptr numProfileCountersHeaderElements = 2;
+        static constexpr Uptr numProfiledCallIndirectTargets = 4;
+        static constexpr Uptr numCallIndirectProfileCounters = numProfiledCallIndirectTargets * 2 + 1;
+
+        // The bindings of a module instance that code specialized to the instance may compile as
+        // constants, instead of as symbols that are bound when the code is loaded.
+        struct InstanceConstants {
+            Uptr moduleInstanceId = UINTPTR_MAX;
+            Uptr tableReferenceBias = 0;
+
+            // The IDs of the instance's tables and memories, indexed by table and memory index.
+            std::vector<Uptr> tableIds;
+            std::vector<Uptr> memoryIds;
+
+            // The values of the instance's immutable globals, indexed by global index. Globals
+            // whose values aren't constant, like mutable globals, have a value of type any.
+            std::vector<IR::Value> globalValues;
+        };
+
+        // The function definition of a module in CompileOptions::linkedModules that a function
+        // import is resolved to.
+        struct LinkedFunctionImport {
+            Uptr linkedModuleIndex = UINTPTR_MAX;
+            Uptr functionDefIndex = UINTPTR_MAX;
+        };
+
+        struct CompileOptions {
+            OptimizationLevel optimizationLevel = OptimizationLevel::O1;
+
+            // If true, each function counts its calls, and calls the tierUpFunction intrinsic when
+            // it has been called tierUpCallThreshold times. The runtime then recompiles the function
+            // in the background at tierUpOptimizationLevel, and sets its
+            // FunctionTierUpState::optimizedCode, after which the baseline code forwards all calls to
+            // the optimized code.
+            bool enableTierUp = false;
+            OptimizationLevel tierUpOptimizationLevel = OptimizationLevel::O2;
+            Uptr tierUpCallThreshold = 1000;
+
+            // If true, memory accesses clamp their address to the number of bytes reserved for the
+            // memory, so an out-of-bounds access faults on the guard page after the reservation.
+            // This allows the code to access memories that only reserve address space for their
+            // maximum size, instead of for any 32-bit address and offset.
+            bool explicitMemoryBoundsChecks = false;
+
+            // If true, linear memory loads and stores are emitted as non-volatile accesses with the
+            // alignment hinted by the WebAssembly code, and TBAA metadata that tells LLVM they don't
+            // alias runtime data. This allows LLVM to forward, eliminate, and vectorize them, but an
+            // out-of-bounds access whose result is unused may be eliminated instead of trapping, and
+            // the memory's state after a trap may not reflect stores the trapping function made
+            // before it. Atomic accesses are always volatile.
+            bool nonVolatileMemoryAccesses = false;
+
+            // If true, each function entry and loop back-edge loads the context's
+            // ContextRuntimeData::interruptRequested flag, and calls the interrupt intrinsic if it
+            // is set. This allows a host thread to preempt long-running code with
+            // Runtime::requestInterrupt.
+            bool enableInterruptChecks = false;
+
+            // If true, each basic block subtracts its number of operators from the context's
+            // ContextRuntimeData::fuel when it is entered, and calls the outOfFuel intrinsic if the
+            // fuel becomes negative. The cost of a block is computed at compile time, so metering
+            // adds one subtract and branch per block.
+            bool enableFuelMetering = false;
+
+            // If true, each function definition is compiled to a stub that calls the
+            // compileLazyFunction intrinsic the first time it is called. The runtime then compiles
+            // the function with these options, and sets its FunctionTierUpState::optimizedCode,
+            // after which the stub forwards all calls to the compiled code. This makes compiling a
+            // module cheap, and only spends time and memory on the functions that are called.
+            bool enableLazyCompilation = false;
+
+            // If true, each function definition is compiled to a stub that calls the
+            // interpretFunction intrinsic until the function has compiled code. The runtime
+            // interprets the function, and once it has been called or looped tierUpCallThreshold
+            // times, compiles it at tierUpOptimizationLevel and sets its
+            // FunctionTierUpState::optimizedCode, after which the stub forwards all calls to the
+            // compiled code. Functions the interpreter doesn't support are compiled like lazily
+            // compiled functions on their first call. Interpreted code doesn't check for interrupts
+            // or meter fuel.
+            bool enableInterpreter = false;
+
+            // If true, functions keep a chain of frame pointers, so a sampling profiler can unwind the
+            // stack from a signal handler. This uses a register in each function.
+            bool enableFramePointers = false;
+
+            // If true, each function increments the numCalls counter in its FunctionMutableData on
+            // entry. If enableCallTiming is also true, it adds the cycle counter ticks between its
+            // entry and return to the inclusiveTicks counter. The counters are read with
+            // Runtime::getFunctionCallCounters.
+            bool enableCallCounters = false;
+            bool enableCallTiming = false;
+
+            // If non-empty, the number of calls to each function definition counted by a profiling
+            // run, such as the FunctionCallCounts::numCalls of code compiled with enableCallCounters,
+            // indexed by function definition index. The function definitions are laid out in order of
+            // decreasing calls, so the hot functions share cache lines and pages at the start of the
+            // code. The functions that weren't called are marked cold, and placed in a separate code
+            // section after the others. Function definitions without a count, such as those added
+            // to the module after the profiling run, are laid out last but aren't marked cold.
+            std::vector<U64> functionDefCallCounts;
+
+            // If true, each function definition counts its calls, how often each of its conditional
+            // branches is taken, and which functions each of its call_indirects calls, in profile
+            // counters that Runtime::getModuleProfile reads. The counters are updated with relaxed
+            // atomic adds, and call_indirect calls an intrinsic to record its target.
+            bool enableProfileCounters = false;
+
+            // If non-null, a profile of a run of the module's code compiled with
+            // enableProfileCounters. Its call counts are emitted as function entry counts, its
+            // branch counts as branch weights, and call_indirect speculates that it calls the
+            // target that received most of its calls. If functionDefCallCounts is empty, the
+            // function definitions are also laid out by the profile's call counts.
+            std::shared_ptr<const ModuleProfile> profile;
+
+            // If non-null, the code is specialized to the module instance with these bindings: its
+            // immutable globals, table and memory offsets, module instance ID and table reference
+            // bias are compiled as constants, so LLVM can fold them and the branches that depend on
+            // them. The code may only be loaded with the same bindings, and isn't cacheable.
+            std::shared_ptr<const InstanceConstants> instanceConstants;
+
+            // The modules that the module's instances import functions from, and for each of the
+            // module's function imports, the definition in linkedModules it is resolved to, or a
+            // default LinkedFunctionImport if it isn't resolved to one. The resolved imports are
+            // called directly, and the definitions they resolve to are compiled into the module as
+            // available_externally copies, so LLVM may inline them. The code must be loaded with a
+            // LinkedModuleBinding for an instance of each linked module. linkedFunctionImports may
+            // be empty if no imports are resolved.
+            std::vector<std::shared_ptr<const IR::Module>> linkedModules;
+            std::vector<LinkedFunctionImport> linkedFunctionImports;
+        };
+
+        // The cost of compiling a function definition.
+        struct FunctionCompileStats {
+            // The number of LLVM IR instructions emitted for the function, and the number left after
+            // the optimization passes, which may include the instructions of inlined callees.
+            Uptr numEmittedInstructions = 0;
+            Uptr numOptimizedInstructions = 0;
+
+            // The time spent emitting the function's IR, and running the function passes on it.
+            // Module passes like the inliner aren't attributed to individual functions.
+            U64 emitMicroseconds = 0;
+            U64 optimizeMicroseconds = 0;
+
+            Uptr numMachineCodeBytes = 0;
+        };
+
+        struct CompileStats {
+            // The time spent in each phase of the compile. When the module is compiled on several
+            // threads, the times are summed over the threads, so they may exceed the elapsed time.
+            U64 emitMicroseconds = 0;
+            U64 optimizeMicroseconds = 0;
+            U64 machineCodeMicroseconds = 0;
+
+            // Indexed by function definition index.
+            std::vector<FunctionCompileStats> functionDefs;
+        };
+
+        // Compiles a module to object code. If outStats is non-null, the cost of each phase and of
+        // each function definition is written to it.
+        LLVMJIT_API std::vector<U8> compileModule(const IR::Module &irModule, const CompileOptions &options = CompileOptions(), CompileStats *outStats = nullptr);
+
+        // Validates and compiles a module that wasn't validated when it was decoded, e.g. IR that was
+        // generated or deserialized. Each function definition is validated as its code is decoded to
+        // emit it, instead of in a separate pass; function definitions that are compiled lazily are
+        // validated up front. Throws IR::ValidationException if the module is invalid.
+        LLVMJIT_API std::vector<U8> validateAndCompileModule(const IR::Module &irModule, const CompileOptions &options = CompileOptions());
+
+        // Compiles a single function definition of a module to object code. When the object code is
+        // loaded, the module's other function definitions must be bound with loadModule's
+        // functionDefs parameter.
+        LLVMJIT_API std::vector<U8> compileFunctionDef(const IR::Module &irModule, Uptr functionDefIndex, const CompileOptions &options);
+
+        // Compiles a contiguous range of a module's function definitions to object code. Only the
+        // function definitions in the range, and the sections that precede the code section, are
+        // read, so the rest of the module may still be being decoded.
+        LLVMJIT_API std::vector<U8> compileFunctionDefs(const IR::Module &irModule, Uptr beginFunctionDefIndex, Uptr endFunctionDefIndex, const CompileOptions &options);
+
+        // Combines the object code produced by compileFunctionDefs for ranges that together cover
+        // all of a module's function definitions into object code that loadModule loads as a whole.
+        LLVMJIT_API std::vector<U8> combineObjectCode(const std::vector<std::vector<U8>> &objectCodes);
+
+        // Returns a string that identifies the target that compileModule generates code for: the
+        // target triple, host CPU name, target attributes, and LLVM version. Object code compiled
+        // for one target spec may not be loaded by a process with a different target spec.
+        LLVMJIT_API std::string getHostTargetSpec();
 
         // An opaque type that can be used to reference a loaded JIT module.
         struct Module;
@@ -68,19 +305,88 @@ namespace WAVM {
             Uptr id;
         };
 
+        // The bindings of the instance of a module in CompileOptions::linkedModules that a module's
+        // resolved function imports are imported from, which the copies of its code inlined into
+        // the module refer to.
+        struct LinkedModuleBinding {
+            std::vector<IR::FunctionType> types;
+            std::vector<FunctionBinding> functionImports;
+            std::vector<FunctionBinding> functionDefs;
+            std::vector<TableBinding> tables;
+            std::vector<MemoryBinding> memories;
+            std::vector<GlobalBinding> globals;
+            std::vector<ExceptionTypeBinding> exceptionTypes;
+            ModuleInstanceBinding moduleInstance;
+            Uptr tableReferenceBias;
+            std::vector<Runtime::FunctionMutableData *> functionDefMutableDatas;
+        };
+
         // Loads a module from object code, and binds its undefined symbols to the provided bindings.
-        LLVMJIT_API std::shared_ptr<Module> loadModule(const std::vector<U8> &objectFileBytes, HashMap<std::string, FunctionBinding> &&wavmIntrinsicsExportMap, std::vector<IR::FunctionType> &&types, std::vector<FunctionBinding> &&functionImports, std::vector<TableBinding> &&tables, std::vector<MemoryBinding> &&memories, std::vector<GlobalBinding> &&globals, std::vector<ExceptionTypeBinding> &&exceptionTypes, ModuleInstanceBinding moduleInstance, Uptr tableReferenceBias, const std::vector<Runtime::FunctionMutableData *> &functionDefMutableDatas);
+        // functionDefs binds function definitions that aren't defined by the object code, e.g. by
+        // object code from compileFunctionDef: it may be empty, and entries with null code are
+        // expected to be defined by the object code.
+        // Each call links a new copy of the code: the code's Runtime::Function prefixes and its
+        // references to the bindings are specific to one module instance. The copy's pages are
+        // placed on numaNode, unless it is Platform::anyNUMANode. If the code was compiled with
+        // CompileOptions::linkedModules, linkedModules binds the symbols of each linked module. If
+        // functionDefMutableDataSlab is non-null, the module takes ownership of it, and frees it
+        // instead of freeing the FunctionMutableData objects in it individually.
+        LLVMJIT_API std::shared_ptr<Module> loadModule(const std::vector<U8> &objectFileBytes, HashMap<std::string, FunctionBinding> &&wavmIntrinsicsExportMap, std::vector<IR::FunctionType> &&types, std::vector<FunctionBinding> &&functionImports, std::vector<FunctionBinding> &&functionDefs, std::vector<TableBinding> &&tables, std::vector<MemoryBinding> &&memories, std::vector<GlobalBinding> &&globals, std::vector<ExceptionTypeBinding> &&exceptionTypes, ModuleInstanceBinding moduleInstance, Uptr tableReferenceBias, const std::vector<Runtime::FunctionMutableData *> &functionDefMutableDatas, Uptr numaNode = UINTPTR_MAX, std::vector<LinkedModuleBinding> &&linkedModules = {}, std::unique_ptr<Runtime::FunctionMutableDataSlab> &&functionDefMutableDataSlab = nullptr);
+
+        // Sets whether modules loaded after the call align their code to the huge page size and
+        // advise the OS to back it with transparent huge pages. Only code sections of at least a huge
+        // page are affected. Disabled by default.
+        LLVMJIT_API void setUseHugePagesForCode(bool useHugePages);
+
+        // Returns the number of bytes of committed pages holding a loaded module's code and data.
+        LLVMJIT_API Uptr getModuleNumImageBytes(const Module *module);
+
+        // Sets whether the address range and debug name of each function in modules and thunks
+        // loaded after the call are appended to /tmp/perf-<pid>.map, so Linux perf can symbolize
+        // samples in JIT code. Entries aren't removed when a module is unloaded. Disabled by default.
+        LLVMJIT_API void setPerfMapEnabled(bool enabled);
 
         // Finds the JIT function whose code contains the given address. If no JIT function contains the
-        // given address, returns null.
+        // given address, returns null. This doesn't lock or allocate, so it may be called from a signal
+        // handler.
         LLVMJIT_API Runtime::Function *getFunctionByAddress(Uptr address);
 
+        // Finds the JIT function whose code contains the given address, and copies its debug name
+        // before the module that contains it can be unloaded. Returns false if no JIT function
+        // contains the given address. Unlike getFunctionByAddress, this locks and allocates.
+        LLVMJIT_API bool getFunctionDebugNameByAddress(Uptr address, std::string &outDebugName);
+
         typedef Runtime::ContextRuntimeData *(*InvokeThunkPointer)(Runtime::Function *, Runtime::ContextRuntimeData *);
 
         // Generates an invoke thunk for a specific function type.
         LLVMJIT_API InvokeThunkPointer getInvokeThunk(IR::FunctionType functionType);
 
+        typedef Runtime::ContextRuntimeData *(*BatchInvokeThunkPointer)(Runtime::Function *, Runtime::ContextRuntimeData *, const IR::UntaggedValue *arguments, Uptr numCalls, IR::UntaggedValue *results);
+
+        // Generates a thunk for a specific function type that calls a function numCalls times,
+        // reading each call's arguments from consecutive UntaggedValues in arguments, and writing
+        // each call's results to consecutive UntaggedValues in results.
+        LLVMJIT_API BatchInvokeThunkPointer getBatchInvokeThunk(IR::FunctionType functionType);
+
         // Generates a thunk to call a native function from generated code.
         LLVMJIT_API Runtime::Function *getIntrinsicThunk(void *nativeFunction, IR::FunctionType functionType, IR::CallingConvention callingConvention, const char *debugName);
+
+        // Describes a native function to generate a thunk for with getIntrinsicThunks.
+        struct IntrinsicThunkDesc {
+            void *nativeFunction;
+            IR::FunctionType functionType;
+            IR::CallingConvention callingConvention;
+            const char *debugName;
+        };
+
+        // Generates thunks to call numDescs native functions from generated code, and writes them
+        // to outThunks. The thunks that weren't already generated are compiled and loaded together
+        // as a single module, instead of one module for each thunk.
+        LLVMJIT_API void getIntrinsicThunks(const IntrinsicThunkDesc *descs, Uptr numDescs, Runtime::Function **outThunks);
+
+        // Generates a function of a specific type that ignores its arguments and calls a native
+        // trap function, which takes no arguments other than the context and doesn't return. The
+        // stubs are cached for each trap function and function type.
+        LLVMJIT_API Runtime::Function *getTrapStub(void *nativeTrapFunction, IR::FunctionType functionType);
     }
 }
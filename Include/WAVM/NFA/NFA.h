@@ -3,6 +3,7 @@
 #include <stdint.h>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "WAVM/Inline/BasicTypes.h"
 #include "WAVM/Inline/DenseStaticIntSet.h"
@@ -44,7 +45,7 @@ namespace WAVM {
 
         // Encapsulates a NFA that has been translated into a DFA that can be efficiently executed.
         struct NFA_API Machine {
-            Machine() : stateAndOffsetToNextStateMap(nullptr), numClasses(0), numStates(0) {
+            Machine() : stateAndOffsetToNextStateMap(nullptr), ownsStateAndOffsetToNextStateMap(false), numClasses(0), numStates(0) {
             }
 
             ~Machine();
@@ -60,6 +61,10 @@ namespace WAVM {
             // Constructs a DFA from the abstract builder object (which is destroyed).
             Machine(Builder *inBuilder);
 
+            // Constructs a DFA from tables written by dumpCppTables. The state transition table isn't
+            // copied, so it must outlive the Machine.
+            Machine(const U32 inCharToOffsetMap[256], const StateIndex *inStateAndOffsetToNextStateMap, Uptr inNumClasses, Uptr inNumStates);
+
             // Feeds characters into the DFA until it reaches a terminal state.
             // Upon reaching a terminal state, the state is returned, and the nextChar pointer
             // is updated to point to the first character not consumed by the DFA.
@@ -94,6 +99,11 @@ namespace WAVM {
             // Dumps the DFA's states and edges to the GraphViz .dot format.
             std::string dumpDFAGraphViz() const;
 
+            // Dumps the DFA's tables as C++ definitions of <name>NumClasses, <name>NumStates,
+            // <name>CharToOffsetMap and <name>StateAndOffsetToNextStateMap, which may be passed to the
+            // table constructor to load the DFA without building it.
+            std::string dumpCppTables(const char *name) const;
+
         private:
             typedef I16 InternalStateIndex;
             enum {
@@ -101,11 +111,61 @@ namespace WAVM {
             };
 
             U32 charToOffsetMap[256];
-            InternalStateIndex *stateAndOffsetToNextStateMap;
+            const InternalStateIndex *stateAndOffsetToNextStateMap;
+            bool ownsStateAndOffsetToNextStateMap;
             Uptr numClasses;
             Uptr numStates;
 
             void moveFrom(Machine &&inMachine);
+
+            friend struct CompactMachine;
+        };
+
+        // A DFA with a row-displaced transition table. Each state has a default transition, and the
+        // transitions that differ from it are stored at an offset for the state into a table shared
+        // by all states, with the state they belong to. The table is much smaller than a Machine's
+        // [charClass][state] table, at the cost of an extra load and comparison for each character.
+        struct NFA_API CompactMachine {
+            CompactMachine() {
+            }
+
+            // Constructs a DFA with the same transitions as a Machine.
+            CompactMachine(const Machine &machine);
+
+            // Feeds characters into the DFA until it reaches a terminal state, like Machine::feed.
+            inline StateIndex feed(const char *&nextChar) const {
+                Iptr state = 0;
+                do {
+                    const StateRow &row = rows[state];
+                    const Slot &slot = slots[row.slotBase + charToClassMap[(U8) *nextChar++]];
+                    state = slot.state == state ? slot.nextState : row.defaultNextState;
+                } while (state >= 0);
+                if (state & edgeDoesntConsumeInputFlag) {
+                    --nextChar;
+                    state &= ~edgeDoesntConsumeInputFlag;
+                }
+                return (StateIndex) state;
+            }
+
+            // Returns the number of bytes used by the DFA's tables.
+            Uptr getNumTableBytes() const {
+                return sizeof(charToClassMap) + rows.size() * sizeof(StateRow) + slots.size() * sizeof(Slot);
+            }
+
+        private:
+            struct StateRow {
+                U32 slotBase;
+                StateIndex defaultNextState;
+            };
+
+            struct Slot {
+                StateIndex state;
+                StateIndex nextState;
+            };
+
+            U8 charToClassMap[256];
+            std::vector<StateRow> rows;
+            std::vector<Slot> slots;
         };
     }
 }
@@ -0,0 +1,11 @@
+#pragma once
+
+#include "WAVM/Inline/BasicTypes.h"
+#include "WAVM/Platform/Defines.h"
+
+namespace WAVM {
+    namespace Platform {
+        // Returns the current value of a clock that never goes backwards, in microseconds.
+        PLATFORM_API U64 getMonotonicClock();
+    }
+}
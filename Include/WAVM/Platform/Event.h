@@ -1,10 +1,13 @@
 #pragma once
 
+#include <atomic>
+
 #include "WAVM/Inline/BasicTypes.h"
 #include "WAVM/Platform/Defines.h"
 
 namespace WAVM {
     namespace Platform {
+        // An event that one thread waits on, and other threads signal.
         struct Event {
             PLATFORM_API Event();
 
@@ -18,13 +21,26 @@ namespace WAVM {
 
             void operator=(Event &&) = delete;
 
+            // Waits until the event is signaled, or until getMonotonicClock() reaches untilTime.
+            // Returns true and resets the event if it was signaled, or false if the wait timed out.
+            // UINT64_MAX waits without a timeout.
+            PLATFORM_API bool wait(U64 untilTime);
+
+            PLATFORM_API void signal();
+
         private:
+#ifdef __linux__
+            // On Linux, the event is a futex word that is 1 if the event is signaled.
+            std::atomic<U32> futexWord;
+#else
             struct PthreadMutex {
                 Uptr data[5];
             } pthreadMutex;
             struct PthreadCond {
                 Uptr data[6];
             } pthreadCond;
+            bool isSignaled;
+#endif
         };
     }
 }
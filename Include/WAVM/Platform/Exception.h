@@ -10,7 +10,10 @@ namespace WAVM {
     namespace Platform {
         struct Signal {
             enum class Type {
-                invalid = 0, accessViolation, stackOverflow, intDivideByZeroOrOverflow, unhandledException
+                invalid = 0, accessViolation, stackOverflow, intDivideByZeroOrOverflow, unhandledException,
+                // A signal delivered by raiseSignal instead of the OS, with a code defined by the
+                // code that raised it.
+                softwareTrap
             };
 
             Type type = Type::invalid;
@@ -23,13 +26,45 @@ namespace WAVM {
                 struct {
                     void *data;
                 } unhandledException;
+
+                struct {
+                    Uptr code;
+                } softwareTrap;
             };
         };
 
         PLATFORM_API bool catchSignals(const std::function<void()> &thunk, const std::function<bool(Signal signal, const CallStack &)> &filter);
 
+        // Delivers a signal to the catchSignals on the calling thread like a fault at
+        // instructionAddress, but without raising it through the OS: the filters are called with a
+        // call stack of just instructionAddress, and the first that accepts the signal is jumped to
+        // directly. This makes checks that are done in software as cheap to fail as a fault. It's a
+        // fatal error if no filter accepts the signal.
+        [[noreturn]] PLATFORM_API void raiseSignal(const Signal &signal, Uptr instructionAddress);
+
         typedef bool (*SignalHandler)(Signal, const CallStack &);
 
+        // Called by the profiling timer's signal handler with the call stack of the interrupted
+        // thread, innermost frame first. It runs in the signal handler, so it must not lock or
+        // allocate.
+        typedef void (*ProfileSampleCallback)(const Uptr *ips, Uptr numFrames);
+
+        // The maximum number of frames in a call stack passed to a ProfileSampleCallback.
+        enum {
+            maxProfileSampleFrames = 64
+        };
+
+        // Starts a timer that interrupts the process every intervalMicroseconds of CPU time it
+        // consumes, and calls the callback with the call stack of the thread that was interrupted.
+        // The call stack is unwound by following frame pointers, so it only extends past the
+        // innermost frame in code compiled with frame pointers, and on threads that have called
+        // catchSignals. Returns false if the timer isn't supported, or is already running.
+        PLATFORM_API bool startProfilingTimer(U64 intervalMicroseconds, ProfileSampleCallback callback);
+
+        // Stops the profiling timer. The callback may still be running on other threads when this
+        // returns.
+        PLATFORM_API void stopProfilingTimer();
+
         PLATFORM_API void registerEHFrames(const U8 *imageBase, const U8 *ehFrames, Uptr numBytes);
 
         PLATFORM_API void deregisterEHFrames(const U8 *imageBase, const U8 *ehFrames, Uptr numBytes);
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "WAVM/Inline/BasicTypes.h"
+#include "WAVM/Platform/Defines.h"
+
+namespace WAVM {
+    namespace Platform {
+        // An opaque type that references a fiber created by createFiber: a function that runs on its
+        // own stack, and may yield back to the code that resumed it.
+        struct Fiber;
+
+        typedef void (*FiberEntry)(void *argument);
+
+        // Creates a fiber that calls fiberEntry(argument) on a stack of at least numStackBytes when
+        // it is first resumed. The stack has inaccessible guard pages below it, so an overflow
+        // raises a stack overflow signal in the fiber.
+        PLATFORM_API Fiber *createFiber(Uptr numStackBytes, FiberEntry fiberEntry, void *argument);
+
+        // Reinitializes a fiber that isn't running to call fiberEntry(argument) when it is next
+        // resumed, reusing its stack. Like destroyFiber, this abandons a fiber that yielded.
+        PLATFORM_API void resetFiber(Fiber *fiber, FiberEntry fiberEntry, void *argument);
+
+        // Frees a fiber that isn't running. If the fiber yielded without returning, its stack is
+        // freed without unwinding it, so the destructors of the objects on it aren't called.
+        PLATFORM_API void destroyFiber(Fiber *fiber);
+
+        // Runs a fiber on the calling thread until it yields or its entry function returns, and
+        // returns true if it returned. If the entry function throws an exception, it is rethrown
+        // here, and a signal raised in the fiber may be caught by a catchSignals enclosing this
+        // call; either ends the fiber. A fiber that ended may not be resumed again until it is
+        // reset. Fibers may be nested: a fiber may
+        // resume another fiber, and the other fiber yields back to it.
+        // A fiber's code may observe the thread_locals of the thread that resumes it, so it should
+        // only be resumed on the thread that first resumed it.
+        PLATFORM_API bool resumeFiber(Fiber *fiber);
+
+        // Switches from the running fiber back to the code that resumed it, and returns when the
+        // fiber is resumed again.
+        PLATFORM_API void yieldFiber();
+
+        // Returns whether a fiber is running: it was resumed, and hasn't yielded or ended since.
+        PLATFORM_API bool isFiberRunning(const Fiber *fiber);
+
+        // Returns the fiber the calling code is running on, or null if it isn't running on a fiber.
+        PLATFORM_API Fiber *getCurrentFiber();
+    }
+}
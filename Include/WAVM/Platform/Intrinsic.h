@@ -43,15 +43,16 @@ namespace WAVM {
             : "memory");
         }
         inline void bytewiseMemMove(U8 *dest, U8 *source, Uptr numBytes) {
-            const Uptr numNonOverlappingBytes = source < dest && source + numBytes > dest ? dest - source : numBytes;
-
-            if (numNonOverlappingBytes != numBytes) {
-                bytewiseMemCopy(
-                        dest + numNonOverlappingBytes,
-                        source + numNonOverlappingBytes, numBytes - numNonOverlappingBytes);
+            if (source < dest && source + numBytes > dest) {
+                // A forward copy would overwrite the source bytes after dest before reading them, so
+                // copy backward from the last byte.
+                asm volatile("std\n\trep movsb\n\tcld"
+                : "=D"(dest), "=S"(source), "=c"(numBytes)
+                : "0"(dest + numBytes - 1), "1"(source + numBytes - 1), "2"(numBytes)
+                : "memory");
+            } else {
+                bytewiseMemCopy(dest, source, numBytes);
             }
-
-            bytewiseMemCopy(dest, source, numNonOverlappingBytes);
         }
     }
 }
@@ -21,8 +21,106 @@ namespace WAVM {
 
         PLATFORM_API void decommitVirtualPages(U8 *baseVirtualAddress, Uptr numPages);
 
+        // Like decommitVirtualPages, but cheaper where the OS can release a mapping's physical pages
+        // without replacing the mapping. Only valid for pages that were committed by
+        // commitVirtualPages, and not mapped by mapPageFileCopyOnWrite.
+        PLATFORM_API void discardVirtualPages(U8 *baseVirtualAddress, Uptr numPages);
+
         PLATFORM_API void freeVirtualPages(U8 *baseVirtualAddress, Uptr numPages);
 
+        // Releases the physical memory of the pages in a range of committed pages that are entirely
+        // zero, and returns the number of pages released. The pages stay committed with the same
+        // access, and are zero-filled again when they are next accessed. Only valid for pages that
+        // were committed by commitVirtualPages, and not mapped by mapPageFileCopyOnWrite, and the
+        // pages must not be written while they are released. Returns 0 where the OS doesn't
+        // guarantee that released pages read as zero.
+        PLATFORM_API Uptr releaseZeroPages(U8 *baseVirtualAddress, Uptr numPages);
+
+        // Asks the OS to reclaim the physical memory of a range of committed pages, e.g. by writing
+        // them to swap or compressing them into a compressed swap cache, without changing their
+        // contents: they are read back when they are next accessed. Returns false if the OS doesn't
+        // support it.
+        PLATFORM_API bool reclaimVirtualPages(U8 *baseVirtualAddress, Uptr numPages);
+
+        // Returns the log2 of the size of the huge pages used to back transparent huge page
+        // mappings, or of the base page size if the OS doesn't support them.
+        PLATFORM_API Uptr getHugePageSizeLog2();
+
+        // Asks the OS to back the pages with transparent huge pages where the range covers whole
+        // aligned huge pages. Returns false if the OS doesn't support it. The advice applies to pages
+        // committed in the range after the call.
+        PLATFORM_API bool adviseHugePages(U8 *baseVirtualAddress, Uptr numPages);
+
         PLATFORM_API void freeAlignedVirtualPages(U8 *unalignedBaseAddress, Uptr numPages, Uptr alignmentLog2);
+
+        // The NUMA node passed to setVirtualPagesNUMANode to give up a preference for a node.
+        static constexpr Uptr anyNUMANode = UINTPTR_MAX;
+
+        // Returns the number of NUMA nodes, or 1 if the OS doesn't report them.
+        PLATFORM_API Uptr getNumNUMANodes();
+
+        // Returns the NUMA node of the CPU the calling thread is running on.
+        PLATFORM_API Uptr getCurrentNUMANode();
+
+        // Asks the OS to back the pages committed in the range after the call with physical memory
+        // on a NUMA node, falling back to other nodes if it has none free. Returns false if the node
+        // doesn't exist, or the OS doesn't support NUMA placement.
+        PLATFORM_API bool setVirtualPagesNUMANode(U8 *baseVirtualAddress, Uptr numPages, Uptr numaNode);
+
+        // A file of pages that can be mapped copy-on-write at multiple addresses, so the mappings
+        // share physical pages until they are written to.
+        struct PageFile;
+
+        // Creates a page file containing a copy of numPages pages starting at baseAddress. Returns
+        // null if the file couldn't be created.
+        PLATFORM_API PageFile *createPageFile(const U8 *baseAddress, Uptr numPages);
+
+        PLATFORM_API void destroyPageFile(PageFile *pageFile);
+
+        // Writes the pages of a page file to an existing file at a page-aligned byte offset, and
+        // extends the file to cover them if it is shorter. Pages that are entirely zero aren't
+        // written, so they are left as holes in file systems that support sparse files. Returns
+        // false if the file couldn't be written.
+        PLATFORM_API bool writePageFile(const PageFile *pageFile, const char *path, U64 offset);
+
+        // Opens a page file backed by numPages pages of a file starting at a page-aligned byte
+        // offset, e.g. written by writePageFile. The pages are read from the file when a mapping
+        // of the page file first accesses them, so the file must not be changed while the page file
+        // is open. Returns null if the file couldn't be opened or is too short.
+        PLATFORM_API PageFile *openPageFile(const char *path, U64 offset, Uptr numPages);
+
+        // Maps the first numPages pages of a page file at baseVirtualAddress, replacing the pages
+        // that were mapped there. The mapped pages are readable and writable, but writes to them
+        // are private to the mapping and don't change the page file.
+        PLATFORM_API bool mapPageFileCopyOnWrite(PageFile *pageFile, U8 *baseVirtualAddress, Uptr numPages);
+
+        // Reverts the pages of a mapping created by mapPageFileCopyOnWrite that were written since
+        // they were mapped to the page file's contents, and returns the number of pages that were
+        // reverted. Where the OS reports which pages of the mapping were written, the other pages are
+        // left mapped, so the cost is proportional to the number of written pages.
+        PLATFORM_API Uptr revertPageFileCopyOnWrite(PageFile *pageFile, U8 *baseVirtualAddress, Uptr numPages);
+
+        // A read-only mapping of a file's contents. The contents aren't copied: the mapping's pages
+        // are read from the file when they are first accessed, and are shared with the page cache and
+        // other processes that map the file.
+        struct MappedFile;
+
+        // Maps the contents of a file read-only. The contents are followed by at least one zero byte
+        // that isn't part of the file, so text parsers may use it as a terminator. Returns null if
+        // the file couldn't be opened or mapped.
+        PLATFORM_API MappedFile *mapFile(const char *path);
+
+        PLATFORM_API const U8 *getMappedFileBytes(const MappedFile *mappedFile);
+        PLATFORM_API Uptr getMappedFileNumBytes(const MappedFile *mappedFile);
+
+        PLATFORM_API void unmapFile(MappedFile *mappedFile);
+
+        // Copies numBytes from source to dest, which may overlap, like memmove, but with a method
+        // chosen for the size: small copies use memmove, medium copies rep movsb, and copies larger
+        // than the last level cache use non-temporal stores, which don't evict the cache's contents.
+        PLATFORM_API void copyMemoryBytes(U8 *dest, const U8 *source, Uptr numBytes);
+
+        // Sets numBytes at dest to value, like memset, with the methods copyMemoryBytes uses.
+        PLATFORM_API void fillMemoryBytes(U8 *dest, U8 value, Uptr numBytes);
     }
 }
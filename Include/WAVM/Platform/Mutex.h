@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+
 #include "WAVM/Inline/Assert.h"
 #include "WAVM/Inline/BasicTypes.h"
 #include "WAVM/Platform/Defines.h"
@@ -29,5 +31,72 @@ namespace WAVM {
                 }
                 pthreadMutex;
         };
+
+        // A mutex for short critical sections. lock spins for a while if the mutex is locked, and
+        // only parks the thread in the kernel if it is still locked after that; unlock only enters
+        // the kernel if a thread may be parked. An uncontended lock and unlock are one atomic
+        // operation each.
+        struct SpinMutex {
+            SpinMutex() : state(0) {}
+
+            SpinMutex(const SpinMutex &) = delete;
+
+            SpinMutex(SpinMutex &&) = delete;
+
+            void operator=(const SpinMutex &) = delete;
+
+            void operator=(SpinMutex &&) = delete;
+
+            void lock() {
+                U32 expectedState = 0;
+                if (!state.compare_exchange_strong(expectedState, 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+                    lockContended();
+                }
+            }
+
+            void unlock() {
+                if (state.exchange(0, std::memory_order_release) == 2) {
+                    unlockContended();
+                }
+            }
+
+        private:
+            // 0 if unlocked, 1 if locked, or 2 if locked and other threads may be parked waiting
+            // for it.
+            std::atomic<U32> state;
+
+            PLATFORM_API void lockContended();
+
+            PLATFORM_API void unlockContended();
+        };
+
+        // A reader/writer mutex, for data that is read much more often than it is written: any
+        // number of threads may hold it shared, or one thread may hold it exclusively.
+        struct RWMutex {
+            PLATFORM_API RWMutex();
+
+            PLATFORM_API ~RWMutex();
+
+            RWMutex(const RWMutex &) = delete;
+
+            RWMutex(RWMutex &&) = delete;
+
+            void operator=(const RWMutex &) = delete;
+
+            void operator=(RWMutex &&) = delete;
+
+            PLATFORM_API void lock();
+
+            PLATFORM_API void unlock();
+
+            PLATFORM_API void lockShared();
+
+            PLATFORM_API void unlockShared();
+
+        private:
+            struct PthreadRWLock {
+                Uptr data[7];
+            } pthreadRWLock;
+        };
     }
 }
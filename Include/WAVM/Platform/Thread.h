@@ -0,0 +1,52 @@
+#pragma once
+
+#include "WAVM/Inline/BasicTypes.h"
+#include "WAVM/Platform/Defines.h"
+
+namespace WAVM {
+    namespace Platform {
+        // An opaque type that references a thread created by createThread.
+        struct Thread;
+
+        typedef I64 (*ThreadEntry)(void *argument);
+
+        // Creates a thread that calls threadEntry(argument), with a stack of at least numStackBytes,
+        // or the platform's default stack size if numStackBytes is zero. The thread must either be
+        // joined or detached.
+        PLATFORM_API Thread *createThread(Uptr numStackBytes, ThreadEntry threadEntry, void *argument);
+
+        // Waits for a thread to exit, frees it, and returns the value returned by its entry
+        // function.
+        PLATFORM_API I64 joinThread(Thread *thread);
+
+        // Frees a thread when it exits, instead of when it is joined.
+        PLATFORM_API void detachThread(Thread *thread);
+
+        // Returns the thread created by createThread that the caller is running on, or null if the
+        // caller is running on a thread that wasn't created by createThread. This only reads a
+        // thread_local, so it is cheap enough to call on hot paths.
+        PLATFORM_API Thread *getCurrentThread();
+
+        // Restricts a thread to run on the given CPU. Returns false if the CPU doesn't exist, or the
+        // platform doesn't support setting thread affinity.
+        PLATFORM_API bool setThreadAffinity(Thread *thread, Uptr cpuIndex);
+
+        // Returns the number of threads the hardware can run concurrently.
+        PLATFORM_API Uptr getNumberOfHardwareThreads();
+
+        // Returns the number of threads the CPUs of a NUMA node can run concurrently, or 0 if the
+        // node doesn't exist or the OS doesn't report its CPUs.
+        PLATFORM_API Uptr getNumberOfNUMANodeHardwareThreads(Uptr numaNode);
+
+        // Restricts the calling thread to run on the CPUs of a NUMA node. Returns false if the node
+        // doesn't exist, or the platform doesn't support setting thread affinity.
+        PLATFORM_API bool setCurrentThreadNUMANode(Uptr numaNode);
+
+        // Yields the rest of the calling thread's time slice to another thread.
+        PLATFORM_API void yieldToAnotherThread();
+
+        // Returns the ID the OS assigned to the calling process, e.g. to give files created by
+        // concurrent processes distinct names.
+        PLATFORM_API Uptr getProcessId();
+    }
+}
@@ -44,6 +44,14 @@ namespace WAVM {
                 return callingConvention;
             }
 
+            const char *getName() const {
+                return name;
+            }
+
+            IR::FunctionType getType() const {
+                return type;
+            }
+
         private:
             const char *name;
             IR::FunctionType type;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <functional>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -32,5 +33,20 @@ namespace WAVM {
         };
 
         RUNTIME_API LinkResult linkModule(const IR::Module &module, Resolver &resolver);
+
+        // A precomputed mapping from a module's imports to the exports of the instances that provide
+        // them. It links the module against other instances of the same providers, e.g. in a new
+        // compartment, without resolving the imports by name or checking their types again.
+        struct LinkPlan;
+        typedef std::shared_ptr<const LinkPlan> LinkPlanRef;
+
+        // Creates a link plan for a module from one instance of each of its providers, given with
+        // the module names they are imported by. If any imports aren't exported by the providers
+        // with the right type, adds them to outMissingImports and returns null.
+        RUNTIME_API LinkPlanRef createLinkPlan(const IR::Module &module, const std::vector<std::pair<std::string, ModuleInstance *>> &providers, std::vector<LinkResult::MissingImport> &outMissingImports);
+
+        // Links a module with a link plan. The providers must be in the same order as they were
+        // given to createLinkPlan, and be instances of the same modules as those providers.
+        RUNTIME_API ImportBindings linkModule(const LinkPlan &linkPlan, const std::vector<ModuleInstance *> &providers);
     }
 }
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <functional>
+
+#include "WAVM/Inline/BasicTypes.h"
+
+namespace WAVM {
+    namespace Runtime {
+        namespace Metrics {
+            // The process-wide counters the runtime keeps. Updating a counter is a relaxed atomic
+            // add, so they are always kept.
+            enum class Counter {
+                numCompiledModules,
+                numCompiledFunctions,
+                numObjectCodeBytes,
+                numObjectCacheHits,
+                numInstantiations,
+                numLinks,
+                numGarbageCollections,
+                numMemoryGrows,
+                numGrownMemoryPages,
+                numTraps,
+                numReleasedZeroPages,
+                numReclaimedPages,
+                num
+            };
+
+            // The process-wide histograms of durations, in microseconds, the runtime keeps.
+            enum class Histogram {
+                moduleCompileMicroseconds,
+                linkMicroseconds,
+                instantiateMicroseconds,
+                garbageCollectionPauseMicroseconds,
+                num
+            };
+
+            // A histogram's samples are counted in buckets of exponentially increasing size: bucket
+            // 0 counts the samples of 0, and bucket i the samples in [2^(i-1), 2^i).
+            enum {
+                numHistogramBuckets = 40
+            };
+
+            struct HistogramSnapshot {
+                U64 numSamples;
+                U64 sum;
+                U64 min;
+                U64 max;
+                U64 buckets[numHistogramBuckets];
+            };
+
+            struct Snapshot {
+                U64 counters[Uptr(Counter::num)];
+                HistogramSnapshot histograms[Uptr(Histogram::num)];
+            };
+
+            // Returns the current values of the counters and histograms. The values are read
+            // without stopping updates, so they may not be consistent with each other.
+            RUNTIME_API Snapshot getSnapshot();
+
+            // Sets the counters and histograms to zero.
+            RUNTIME_API void reset();
+
+            RUNTIME_API const char *getCounterName(Counter counter);
+
+            RUNTIME_API const char *getHistogramName(Histogram histogram);
+
+            // Calls callback with a snapshot every intervalMicroseconds on a background thread, until
+            // it is replaced by another call. A null callback stops the thread.
+            typedef std::function<void(const Snapshot &)> PushCallback;
+
+            RUNTIME_API void setPushCallback(PushCallback &&callback, U64 intervalMicroseconds);
+        }
+    }
+}
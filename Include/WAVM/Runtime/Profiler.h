@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+
+#include "WAVM/Inline/BasicTypes.h"
+
+namespace WAVM {
+    namespace Runtime {
+        namespace Profiler {
+            // Starts sampling the stacks of the threads running guest code samplesPerSecond times per
+            // second of CPU time the process consumes. The stacks only include the callers of the
+            // innermost frame for code compiled with LLVMJIT::CompileOptions::enableFramePointers.
+            // Returns false if the platform doesn't support sampling, or the profiler is already
+            // running.
+            RUNTIME_API bool start(Uptr samplesPerSecond = 100);
+
+            // Stops sampling. The samples taken since the profiler was started or reset are kept.
+            RUNTIME_API void stop();
+
+            // Discards the samples taken so far.
+            RUNTIME_API void reset();
+
+            // Returns the samples taken so far in the collapsed stack format read by flamegraph.pl:
+            // one line per distinct stack, with the function names from outermost to innermost
+            // separated by semicolons, followed by a space and the number of samples. Host code
+            // called by guest code is shown as a [native] frame. Samples that weren't in guest code
+            // are only counted by getNumSamples.
+            RUNTIME_API std::string getCollapsedStacks();
+
+            // Returns the number of samples taken so far, including those that weren't in guest code
+            // and those that were dropped because the sample buffer was full.
+            RUNTIME_API U64 getNumSamples();
+
+            RUNTIME_API U64 getNumDroppedSamples();
+        }
+    }
+}
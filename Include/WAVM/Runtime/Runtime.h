@@ -1,5 +1,10 @@
 #pragma once
 
+#include <string.h>
+#include <atomic>
+#include <functional>
+#include <future>
+#include <initializer_list>
 #include <memory>
 #include <string>
 #include <vector>
@@ -9,12 +14,21 @@
 #include "WAVM/Inline/Assert.h"
 #include "WAVM/Inline/BasicTypes.h"
 #include "WAVM/Platform/Diagnostics.h"
+#include "WAVM/Platform/Intrinsic.h"
 
 // Declare IR::Module to avoid including the definition.
 namespace WAVM {
     namespace IR {
         struct Module;
     }
+    namespace Serialization {
+        struct InputStream;
+        struct OutputStream;
+    }
+    namespace LLVMJIT {
+        struct CompileOptions;
+        struct ModuleProfile;
+    }
 }
 
 // Declare the different kinds of objects. They are only declared as incomplete struct types here,
@@ -148,21 +162,142 @@ namespace WAVM {
         // Decrements the object's counter of root referencers.
         RUNTIME_API void removeGCRoot(Object *object);
 
+        // Does up to about maxWorkUnits of work collecting the compartment's garbage, where a unit is
+        // one object or table element scanned. Returns true if the collection finished, deleting the
+        // objects that were unreachable from the roots when it started; otherwise, the next call
+        // continues the collection. Functions may be called and objects created between calls. The
+        // compartment itself is never deleted.
+        // If youngOnly is true, which is the default, and no collection is in progress, the
+        // collection only considers the objects created since the last collection finished, so its
+        // cost is proportional to the number of new objects instead of to the number of objects in
+        // the compartment. Objects that survived a previous collection are only deleted by a full
+        // collection, with youngOnly false.
+        RUNTIME_API bool collectGarbage(Compartment *compartment, Uptr maxWorkUnits = UINTPTR_MAX, bool youngOnly = true);
+
+        // Finishes any collection in progress and collects all of the compartment's garbage. If no
+        // objects are left in the compartment, deletes it and returns true; otherwise, the objects
+        // that are still referenced by roots keep the compartment alive, and returns false.
+        RUNTIME_API bool tryCollectCompartment(Compartment *compartment);
+
         RUNTIME_API IR::UntaggedValue *invokeFunctionUnchecked(Context *context, Function *function, const IR::UntaggedValue *arguments);
 
-        RUNTIME_API IR::ValueTuple invokeFunctionChecked(Context *context, Function *function, const std::vector<IR::Value> &arguments);
+        // Calls a function with an array of numArguments arguments, and returns its results. Neither
+        // the arguments nor the results are allocated on the heap.
+        RUNTIME_API IR::ValueTuple invokeFunctionChecked(Context *context, Function *function, const IR::Value *arguments, Uptr numArguments);
+
+        inline IR::ValueTuple invokeFunctionChecked(Context *context, Function *function, std::initializer_list<IR::Value> arguments) {
+            return invokeFunctionChecked(context, function, arguments.begin(), arguments.size());
+        }
+
+        inline IR::ValueTuple invokeFunctionChecked(Context *context, Function *function, const std::vector<IR::Value> &arguments) {
+            return invokeFunctionChecked(context, function, arguments.data(), arguments.size());
+        }
+
+        // Calls a function numCalls times from a single thunk. The arguments for call i are read from
+        // arguments[i * numParams ... (i + 1) * numParams), and its results are written to
+        // results[i * numResults ... (i + 1) * numResults).
+        RUNTIME_API void invokeFunctionBatch(Context *context, Function *function, const IR::UntaggedValue *arguments, Uptr numCalls, IR::UntaggedValue *results);
 
         RUNTIME_API IR::FunctionType getFunctionType(Function *function);
 
+        struct ContextRuntimeData;
+
+        // A call to a function in a context with the function's invoke thunk and the layout of its
+        // arguments and results in the context's thunk argument buffer resolved up front, so it may
+        // be invoked repeatedly without decoding the function's type or allocating memory.
+        struct PreparedCall {
+            typedef ContextRuntimeData *(*InvokeThunkPointer)(Function *, ContextRuntimeData *);
+
+            Function *function = nullptr;
+            Context *context = nullptr;
+            ContextRuntimeData *contextRuntimeData = nullptr;
+            InvokeThunkPointer invokeThunk = nullptr;
+            U8 *argAndReturnData = nullptr;
+            IR::FunctionType type;
+            std::vector<U32> paramOffsets;
+            std::vector<U8> paramNumBytes;
+            std::vector<U32> resultOffsets;
+            std::vector<U8> resultNumBytes;
+        };
+
+        // Prepares calls to a function in a context. The PreparedCall may be used until the context
+        // is destroyed.
+        RUNTIME_API PreparedCall prepareCall(Context *context, Function *function);
+
+        // Invokes a prepared call with the given arguments, returning a pointer to the results. The
+        // results are laid out at the PreparedCall's resultOffsets, and are only valid until the next
+        // call in the same context.
+        RUNTIME_API const U8 *invokePreparedCall(const PreparedCall &call, const IR::UntaggedValue *arguments);
+
+        // Invokes a prepared call whose arguments were already written to its argAndReturnData, and
+        // returns a pointer to the results, like invokePreparedCall.
+        RUNTIME_API const U8 *invokePreparedCallWithWrittenArguments(const PreparedCall &call);
+
+        // Prepares calls to a function, checking that it has the type Result(Args...).
+        template<typename Result, typename... Args> PreparedCall prepareTypedCall(Context *context, Function *function) {
+            errorUnless(getFunctionType(function) ==
+                        IR::FunctionType(IR::inferResultType<Result>(), IR::TypeTuple({IR::inferValueType<Args>()...})));
+            return prepareCall(context, function);
+        }
+
+        template<typename Result> struct InvokeTypedResult {
+            static Result read(const U8 *returnData) {
+                Result result;
+                memcpy(&result, returnData, sizeof(Result));
+                return result;
+            }
+        };
+
+        template<> struct InvokeTypedResult<void> {
+            static void read(const U8 *) {}
+        };
+
+        // Invokes a call prepared by prepareTypedCall<Result, Args...>, writing the arguments directly
+        // to the context's thunk argument buffer. Like the other ways to invoke a function, this
+        // calls it on a guest stack if the context has a stack size.
+        template<typename Result, typename... Args> Result invokeTyped(const PreparedCall &call, Args... args) {
+            wavmAssert(call.paramOffsets.size() == sizeof...(Args));
+
+            Uptr argIndex = 0;
+            (void) std::initializer_list<int>{(memcpy(call.argAndReturnData + call.paramOffsets[argIndex++], &args, sizeof(Args)), 0)...};
+
+            const U8 *returnData = invokePreparedCallWithWrittenArguments(call);
+
+            // The first result is always at the start of the return data.
+            return InvokeTypedResult<Result>::read(returnData);
+        }
+
         RUNTIME_API Table *createTable(Compartment *compartment, IR::TableType type, std::string &&debugName);
 
+        // Reads or writes a table element. An index beyond the table's size raises an
+        // outOfBoundsTableAccess trap, which may be caught by catchTraps.
         RUNTIME_API Object *getTableElement(Table *table, Uptr index);
 
         RUNTIME_API Object *setTableElement(Table *table, Uptr index, Object *newValue);
 
         RUNTIME_API Uptr getTableNumElements(Table *table);
 
-        RUNTIME_API Memory *createMemory(Compartment *compartment, IR::MemoryType type, std::string &&debugName);
+        // Creates a memory. If useHugePages is true, the memory's reservation is aligned to the huge
+        // page size, and the OS is asked to back it with transparent huge pages, which reduces TLB
+        // misses for large memories at the cost of committing memory in huge page increments.
+        // If boundedReservation is true, the memory reserves address space for only the type's
+        // maximum size, capped by setMaxBoundedMemoryPages, instead of 8GB; it may then only be
+        // used by modules compiled with LLVMJIT::CompileOptions::explicitMemoryBoundsChecks, and
+        // can't grow beyond the cap.
+        // The memory's pages are placed on numaNode, or on its compartment's NUMA node if numaNode
+        // is UINTPTR_MAX.
+        RUNTIME_API Memory *createMemory(Compartment *compartment, IR::MemoryType type, std::string &&debugName, bool useHugePages = false, bool boundedReservation = false, Uptr numaNode = UINTPTR_MAX);
+
+        // Sets the maximum number of pages reserved by memories with bounded reservations. The
+        // default is IR::maxMemoryPages (4GB).
+        RUNTIME_API void setMaxBoundedMemoryPages(Uptr maxPages);
+
+        // Sets the maximum number of address-space reservations freed by destroyed memories, tables,
+        // and compartments that are kept to be reused by new ones, instead of being unmapped. Each
+        // memory reservation is 8GB of address space, each table reservation is 32GB, and each
+        // compartment reservation is 4GB, aligned to 4GB. The defaults are 64 memory reservations,
+        // 16 table reservations, and 16 compartment reservations, and 0 disables pooling.
+        RUNTIME_API void setReservationPoolSizes(Uptr maxPooledMemoryReservations, Uptr maxPooledTableReservations, Uptr maxPooledCompartmentReservations = 16);
 
         RUNTIME_API U8 *getMemoryBaseAddress(Memory *memory);
 
@@ -176,6 +311,17 @@ namespace WAVM {
 
         RUNTIME_API U8 *getValidatedMemoryOffsetRange(Memory *memory, Uptr offset, Uptr numBytes);
 
+        // Waits on the 32-bit value at an address in the memory, using the same wait lists as the
+        // WebAssembly atomic wait and wake operators, so host code can implement blocking
+        // primitives on the guest's memory. Returns 0 if the thread was woken, 1 if the value
+        // didn't equal expectedValue, or 2 if the wait timed out. The timeout is in nanoseconds: a
+        // negative or non-finite timeout waits forever.
+        RUNTIME_API U32 waitOnAtomicAddress(Memory *memory, U32 address, I32 expectedValue, F64 timeout);
+
+        // Wakes up to numToWake threads waiting on an address in the memory, and returns the number
+        // of threads woken.
+        RUNTIME_API U32 wakeAtomicAddress(Memory *memory, U32 address, U32 numToWake);
+
         template<typename Value> Value &memoryRef(Memory *memory, Uptr offset) {
             return *(Value *) getValidatedMemoryOffsetRange(memory, offset, sizeof(Value));
         }
@@ -184,6 +330,82 @@ namespace WAVM {
             return (Value *) getValidatedMemoryOffsetRange(memory, offset, numElements * sizeof(Value));
         }
 
+        // A contiguous array of values in a memory, returned by MemoryView::span.
+        template<typename Value> struct MemorySpan {
+            Value *data;
+            Uptr size;
+
+            Value *begin() const {
+                return data;
+            }
+
+            Value *end() const {
+                return data + size;
+            }
+
+            Value &operator[](Uptr index) const {
+                wavmAssert(index < size);
+                return data[index];
+            }
+        };
+
+        // A view of a memory's committed bytes that reads the memory's base address and size once,
+        // so a host function may validate many ranges of the memory with a few instructions each,
+        // instead of a getValidatedMemoryOffsetRange call per access. A memory's pages don't move
+        // when it grows, so a view stays valid, but doesn't include the pages committed after it was
+        // created. Like getValidatedMemoryOffsetRange, the ranges are saturated to the committed
+        // bytes: an out-of-bounds range accesses the uncommitted pages that follow them, and faults.
+        struct MemoryView {
+            MemoryView(Memory *memory) : base(getMemoryBaseAddress(memory)), numBytes(getMemoryNumPages(memory) * IR::numBytesPerPage) {
+            }
+
+            U8 *getBase() const {
+                return base;
+            }
+
+            Uptr getNumBytes() const {
+                return numBytes;
+            }
+
+            U8 *getValidatedRange(Uptr offset, Uptr numRangeBytes) const {
+                numRangeBytes = Platform::saturateToBounds(numRangeBytes, numBytes);
+                return base + Platform::saturateToBounds(offset, numBytes - numRangeBytes);
+            }
+
+            template<typename Value> Value &ref(Uptr offset) const {
+                return *(Value *) getValidatedRange(offset, sizeof(Value));
+            }
+
+            template<typename Value> Value *arrayPtr(Uptr offset, Uptr numElements) const {
+                return (Value *) getValidatedRange(offset, U64(numElements) * sizeof(Value));
+            }
+
+            template<typename Value> MemorySpan<Value> span(Uptr offset, Uptr numElements) const {
+                return {arrayPtr<Value>(offset, numElements), numElements};
+            }
+
+            // Calls visitBuffer with a MemorySpan<U8> for each buffer of an array of numIOVecs
+            // iovecs at offset, each a 32-bit address and a 32-bit number of bytes in the memory, to
+            // scatter a read to the buffers or gather a write from them. The iovec array is
+            // validated once, and each buffer once. Returns the total number of bytes in the
+            // buffers.
+            template<typename VisitBuffer> U64 forEachIOVec(Uptr offset, Uptr numIOVecs, VisitBuffer &&visitBuffer) const {
+                const U32 *iovecs = arrayPtr<U32>(offset, U64(numIOVecs) * 2);
+                U64 numBufferBytes = 0;
+                for (Uptr iovecIndex = 0; iovecIndex < numIOVecs; ++iovecIndex) {
+                    const U32 bufferAddress = iovecs[iovecIndex * 2 + 0];
+                    const U32 bufferNumBytes = iovecs[iovecIndex * 2 + 1];
+                    visitBuffer(span<U8>(bufferAddress, bufferNumBytes));
+                    numBufferBytes += bufferNumBytes;
+                }
+                return numBufferBytes;
+            }
+
+        private:
+            U8 *base;
+            Uptr numBytes;
+        };
+
         RUNTIME_API Global *createGlobal(Compartment *compartment, IR::GlobalType type, IR::Value initialValue);
 
         struct ImportBindings {
@@ -198,18 +420,442 @@ namespace WAVM {
         typedef std::shared_ptr<Module> ModuleRef;
         typedef const std::shared_ptr<const Module> &ModuleConstRefParam;
 
+        // Compiles a module. While a module compiled from the same IR with the same options is alive,
+        // compiling the IR again returns a reference to that module instead of compiling it again.
         RUNTIME_API ModuleRef compileModule(const IR::Module &irModule);
 
+        // Compiles a module with non-default options, e.g. a higher optimization level.
+        RUNTIME_API ModuleRef compileModule(const IR::Module &irModule, const LLVMJIT::CompileOptions &options);
+
+        // How urgently an asynchronous compile is needed. The compilation threads run the queued
+        // foreground compiles before any background compiles, which include tier-up recompiles.
+        enum class CompilePriority {
+            foreground,
+            background,
+        };
+
+        // Cancels the asynchronous compiles it is passed to once isCancelled is set.
+        struct CompileCancellation {
+            std::atomic<bool> isCancelled{false};
+        };
+
+        // Compiles a module like compileModule on one of the runtime's compilation threads, and
+        // returns a future for the module. The IR is copied, so it doesn't need to outlive the call.
+        // If the cancellation is set before the compile starts, the compile is skipped and the
+        // future's module is null; a compile that has started runs to completion.
+        RUNTIME_API std::future<ModuleRef> compileModuleAsync(const IR::Module &irModule, const LLVMJIT::CompileOptions &options, CompilePriority priority = CompilePriority::foreground, std::shared_ptr<CompileCancellation> cancellation = nullptr);
+
+        // Validates and compiles a module that wasn't validated when it was decoded, validating its
+        // code in the same pass that compiles it. Throws IR::ValidationException if the module is
+        // invalid. It doesn't use the object cache.
+        RUNTIME_API ModuleRef validateAndCompileModule(const IR::Module &irModule, const LLVMJIT::CompileOptions &options);
+
+        // Compiles modules that are linked together in one compartment, where each module may import
+        // functions from the modules before it by their moduleNames. A function import that resolves
+        // to a function definition of an earlier module with the same type is called directly, and
+        // is compiled with a copy of the definition that LLVM may inline. An instance of one of
+        // the modules must import the resolved functions from one instance of the module they
+        // resolve to. The modules aren't cached, and may not be saved with saveCompiledModule.
+        RUNTIME_API std::vector<ModuleRef> compileLinkedModules(const std::vector<const IR::Module *> &irModules, const std::vector<std::string> &moduleNames, const LLVMJIT::CompileOptions &options);
+
+        // Compiles a module's function definitions on background threads while the module is still
+        // being decoded, e.g. by a WASM::StreamingModuleParser. The compile only reads the function
+        // definitions that have been added, and the sections that precede the code section, so the
+        // rest of the module may be decoded concurrently. It doesn't use the object cache.
+        struct StreamingCompile;
+
+        // Begins a streaming compile of irModule, which must outlive the streaming compile.
+        RUNTIME_API StreamingCompile *beginStreamingCompile(const IR::Module &irModule, const LLVMJIT::CompileOptions &options);
+
+        // Adds a function definition to be compiled, after its code has been decoded. Function
+        // definitions must be added in order.
+        RUNTIME_API void addStreamingCompileFunctionDef(StreamingCompile *streamingCompile, Uptr functionDefIndex);
+
+        // Waits for the function definitions to be compiled, and returns the compiled module. All of
+        // the module's function definitions must have been added, and the module must have been fully
+        // decoded; irModule must be the module passed to beginStreamingCompile, and is moved into the
+        // compiled module. Destroys the streaming compile.
+        RUNTIME_API ModuleRef finishStreamingCompile(StreamingCompile *streamingCompile, IR::Module &&irModule);
+
+        // Waits for any function definitions that are being compiled, and destroys the streaming
+        // compile without creating a module, e.g. if the module turned out to be invalid.
+        RUNTIME_API void abortStreamingCompile(StreamingCompile *streamingCompile);
+
+        // Sets a directory that compileModule uses to cache object code between processes. Cache
+        // entries are keyed by a hash of the IR module, the compile options, and the host target, so
+        // a module that was compiled before skips LLVM entirely. An empty path (the default) disables
+        // the cache.
+        RUNTIME_API void setObjectCacheDirectory(std::string &&path);
+
+        // Sets whether instantiating a module gives the functions, tables, memories and exception
+        // types it defines the names from the module's name section. The names are enabled by
+        // default; disabling them avoids building a string per function definition for every
+        // instance.
+        RUNTIME_API void setDebugNamesEnabled(bool enabled);
+
+        // Returns the IR that a compiled module was compiled from.
+        RUNTIME_API const IR::Module &getModuleIR(ModuleConstRefParam module);
+
+        // Returns the number of bytes of object code the module was compiled to.
+        RUNTIME_API Uptr getModuleObjectCodeSize(ModuleConstRefParam module);
+
+        // Writes a compiled module's IR and object code to a standalone artifact that can be loaded
+        // by loadPrecompiledModule without parsing, validating, or compiling the module again.
+        RUNTIME_API void saveCompiledModule(ModuleConstRefParam module, Serialization::OutputStream &stream);
+
+        // Loads a module written by saveCompiledModule. If the artifact was compiled for a different
+        // target than the host, its object code is discarded and the IR is compiled again. Throws
+        // Serialization::FatalSerializationException if the artifact is malformed.
+        RUNTIME_API ModuleRef loadPrecompiledModule(Serialization::InputStream &stream);
+
+        // Loads a module written by saveCompiledModule from bytes in backingBuffer, which the module
+        // keeps a reference to. The code, data, and user sections of its IR are views of the bytes,
+        // so they aren't copied.
+        RUNTIME_API ModuleRef loadPrecompiledModule(const U8 *bytes, Uptr numBytes, std::shared_ptr<const void> backingBuffer);
+
+        // Returns whether a byte buffer starts with the magic number written by saveCompiledModule.
+        RUNTIME_API bool isPrecompiledModule(const U8 *bytes, Uptr numBytes);
+
+        // Returns a function of a specific type that traps like the unreachable operator when it is
+        // called, e.g. to stub out an import that couldn't be resolved. The stubs are compiled once
+        // for each function type, and may be used in any compartment.
+        RUNTIME_API Function *getUnreachableStub(IR::FunctionType type);
+
         RUNTIME_API ModuleInstance *instantiateModule(Compartment *compartment, ModuleConstRefParam module, ImportBindings &&imports, std::string &&debugName);
 
         RUNTIME_API Function *getStartFunction(ModuleInstance *moduleInstance);
 
+        // A snapshot of the memories and global values defined by an instance of a module, e.g. one
+        // that has run its start function and any other initialization, which new instances of the
+        // module can start from instead of being initialized again.
+        struct InstanceSnapshot;
+        typedef std::shared_ptr<InstanceSnapshot> InstanceSnapshotRef;
+
+        // Captures the contents of the memories defined by a module instance, the values of the
+        // globals it defines as seen by context, and the elements of the tables it defines if they
+        // are all null or functions of the instance. The instance must not be running in another
+        // context. Returns null if the memory contents couldn't be captured.
+        RUNTIME_API InstanceSnapshotRef snapshotModuleInstance(ModuleConstRefParam module, ModuleInstance *moduleInstance, Context *context);
+
+        // Instantiates a module in the state captured by a snapshot of another instance of it. Its
+        // memories are mapped copy-on-write from the snapshot, so instances share the snapshot's
+        // pages until they write to them, its active data segments aren't copied again, and it
+        // has no start function. Its tables are initialized with the functions the snapshot
+        // captured them as referring to, or from the module as by instantiateModule if the snapshot
+        // didn't capture them. Reference-typed globals are initialized from the module, since they
+        // refer to objects of the snapshotted instance.
+        RUNTIME_API ModuleInstance *instantiateModuleFromSnapshot(Compartment *compartment, ModuleConstRefParam module, ImportBindings &&imports, const InstanceSnapshotRef &snapshot, std::string &&debugName);
+
+        // Resets an instance created by instantiateModuleFromSnapshot to the state captured by the
+        // snapshot, so it can be reused instead of instantiating the module again. Only the pages
+        // of its memories that were written since the instance was created or last reset are
+        // restored, so the cost is proportional to the memory that was written rather than to the
+        // memories' sizes. Memories that grew are shrunk back to their snapshot size, the mutable
+        // globals are restored in context, and the tables are restored as when the instance was
+        // created. Tables that grew keep their size, and reference-typed globals keep their values.
+        // The instance must not be running.
+        RUNTIME_API void resetModuleInstance(ModuleInstance *moduleInstance, Context *context, const InstanceSnapshotRef &snapshot);
+
+        // Writes a snapshot to a checkpoint file, so a later process can create instances from it
+        // without running the module's initialization again, e.g. after a restart. The memory
+        // images are written at page-aligned offsets, skipping pages that are entirely zero, and
+        // the tables are written as indices of the instance's functions. The module is referred to
+        // by a hash of its object code, so the checkpoint may be loaded for the same module loaded
+        // from a precompiled module file. Returns false if the file couldn't be written.
+        RUNTIME_API bool saveInstanceSnapshot(const InstanceSnapshotRef &snapshot, const std::string &path);
+
+        // Loads a snapshot of an instance of a module from a checkpoint file written by
+        // saveInstanceSnapshot. The memory images aren't read: instances created from the snapshot
+        // map them copy-on-write from the file, so it must not be changed while the snapshot is
+        // alive. Returns null if the file couldn't be read, or was written for another module.
+        RUNTIME_API InstanceSnapshotRef loadInstanceSnapshot(ModuleConstRefParam module, const std::string &path);
+
         RUNTIME_API Object *getInstanceExport(ModuleInstance *moduleInstance, const std::string &name);
 
-        RUNTIME_API Compartment *createCompartment();
+        // A pool of module instances in a compartment that are created ahead of time by background
+        // threads, so a new instance can be taken from it without instantiating a module, copying
+        // its data segments or running its start function on the calling thread.
+        struct InstancePool;
+
+        // Creates an instance, e.g. by instantiating a module and running its start function. It is
+        // called on the pool's refill threads, and on threads that find the pool empty.
+        typedef std::function<ModuleInstance *(Compartment *compartment)> InstanceFactory;
+
+        // Creates a pool that keeps numInstances instances created by factory ready, and refills
+        // itself on numRefillThreads background threads as instances are taken from it.
+        RUNTIME_API InstancePool *createInstancePool(Compartment *compartment, Uptr numInstances, InstanceFactory &&factory, Uptr numRefillThreads = 1);
+
+        // Takes a ready instance from the pool without locking, or creates one on the calling thread
+        // if the pool is empty. The caller owns a GC root reference to the instance, which it must
+        // release with removeGCRoot when it is done with the instance.
+        RUNTIME_API ModuleInstance *acquireInstance(InstancePool *pool);
+
+        // Stops the pool's refill threads, and releases the instances that weren't taken from it.
+        RUNTIME_API void destroyInstancePool(InstancePool *pool);
+
+        // Creates a compartment. If numaNode isn't UINTPTR_MAX, the compartment's runtime data,
+        // memories and tables, and the code of its module instances, are placed on that NUMA node
+        // instead of on the node of the thread that first touches them, and its executors' workers
+        // run on the node's CPUs. A clone of the compartment is placed on the same node.
+        RUNTIME_API Compartment *createCompartment(Uptr numaNode = UINTPTR_MAX);
+
+        // Returns the NUMA node passed to createCompartment.
+        RUNTIME_API Uptr getCompartmentNUMANode(const Compartment *compartment);
+
+        // Creates a copy of a compartment and all the objects in it. Module instances in the clone
+        // share the compiled code of the originals, so nothing is recompiled, and each object has
+        // the same ID as the original, so the shared code can address it. Contexts aren't cloned:
+        // use cloneContext to copy a context's global values to the new compartment.
+        RUNTIME_API Compartment *cloneCompartment(const Compartment *compartment);
+
+        // Creates a context in a clone of the context's compartment, with the same mutable global
+        // values as the original context.
+        RUNTIME_API Context *cloneContext(const Context *context, Compartment *newCompartment);
 
         RUNTIME_API bool isInCompartment(Object *object, const Compartment *compartment);
 
-        RUNTIME_API Context *createContext(Compartment *compartment);
+        // The bytes of memory committed for the objects in a compartment.
+        struct CompartmentMemoryUsage {
+            // The committed pages of the compartment's memories. Pages mapped copy-on-write from a
+            // snapshot are counted whether or not they have been written.
+            Uptr memoryBytes = 0;
+
+            // The committed pages of the compartment's tables' elements.
+            Uptr tableBytes = 0;
+
+            // The committed pages of the compartment's runtime data, which includes the
+            // ContextRuntimeData of each context.
+            Uptr runtimeDataBytes = 0;
+
+            // The JIT image pages of the compartment's module instances. Clones of an instance in
+            // other compartments share its code, but it is counted in each compartment.
+            Uptr codeBytes = 0;
+
+            Uptr totalBytes = 0;
+        };
+
+        RUNTIME_API CompartmentMemoryUsage getCompartmentMemoryUsage(const Compartment *compartment);
+
+        // Limits the total bytes of memory committed for the objects in a compartment. Once the
+        // limit would be exceeded, growing a memory or table fails as if it were at its maximum
+        // size, and createContext and instantiateModule return null. Memory that is already
+        // committed isn't freed. The default is UINTPTR_MAX, for no limit; a clone of a compartment
+        // has the same limit as the original.
+        RUNTIME_API void setCompartmentMemoryLimit(Compartment *compartment, Uptr maxBytes);
+
+        // Releases physical memory held by an idle compartment without changing what its code
+        // observes, e.g. while it waits for its next request. The pages of its memories and tables
+        // that are entirely zero are released, and are zero-filled again when they are next
+        // accessed. If reclaimColdPages is true, the OS is also asked to reclaim the other pages of
+        // its memories, e.g. by compressing them into a compressed swap cache, from where they are
+        // faulted back in when they are next accessed. Pages of memories mapped from a snapshot
+        // aren't released, since they would revert to the snapshot. The pages stay committed, so
+        // getCompartmentMemoryUsage still counts them. Nothing may run in the compartment during
+        // the call. Returns the number of bytes of zero pages released.
+        RUNTIME_API Uptr parkCompartment(Compartment *compartment, bool reclaimColdPages = false);
+
+        // Creates a context. If numStackBytes is non-zero, calls into the context run on a guest stack
+        // of that size, with guard pages below it, instead of on the calling thread's stack: a guest
+        // that recurses deeply overflows its own stack, and not the host's. The guest stacks are
+        // taken from a pool of freed stacks that is shared by all contexts.
+        RUNTIME_API Context *createContext(Compartment *compartment, Uptr numStackBytes = 0);
+
+        // Called on the thread running in a context, when code compiled with
+        // CompileOptions::enableInterruptChecks observes that an interrupt was requested. The
+        // handler may return to resume the interrupted code, e.g. after yielding the thread to
+        // another guest, or throw a C++ exception to abort it.
+        typedef void (*InterruptHandler)(Context *context);
+
+        // Sets the handler that is called for interrupts in all contexts. If there is no handler,
+        // interrupts are ignored.
+        RUNTIME_API void setInterruptHandler(InterruptHandler handler);
+
+        // Requests that the code running in a context be interrupted at its next function entry or
+        // loop back-edge. May be called from any thread while the context exists; requests made
+        // before the interrupt is handled are coalesced into one.
+        RUNTIME_API void requestInterrupt(Context *context);
+
+        // Sets or gets the fuel left in a context for code compiled with
+        // CompileOptions::enableFuelMetering. A new context starts with INT64_MAX fuel. The fuel
+        // must not be set while code is running in the context.
+        RUNTIME_API void setFuel(Context *context, I64 fuel);
+
+        RUNTIME_API I64 getFuel(const Context *context);
+
+        // Called on the thread running in a context when it runs out of fuel. The handler must
+        // either add fuel with setFuel and return to resume the code, or throw a C++ exception to
+        // abort it. If there is no handler, running out of fuel raises an outOfFuel trap.
+        typedef void (*OutOfFuelHandler)(Context *context);
+
+        RUNTIME_API void setOutOfFuelHandler(OutOfFuelHandler handler);
+
+        // The calls to a function definition of a module instance counted by code compiled with
+        // CompileOptions::enableCallCounters. inclusiveTicks is in the units of the CPU's cycle
+        // counter, and is only counted with CompileOptions::enableCallTiming.
+        struct FunctionCallCounts {
+            std::string debugName;
+            U64 numCalls;
+            U64 inclusiveTicks;
+        };
+
+        // Returns the call counts of each of a module instance's function definitions, indexed by
+        // function definition index. The counts include the calls to a function's lazily compiled
+        // or tier-up optimized code. The counters are read while they may be updated by other
+        // threads, so they may not be consistent with each other.
+        RUNTIME_API std::vector<FunctionCallCounts> getFunctionCallCounts(ModuleInstance *moduleInstance);
+
+        // Sets the call counts and profile counters of a module instance's function definitions to
+        // zero.
+        RUNTIME_API void resetFunctionCallCounts(ModuleInstance *moduleInstance);
+
+        // Returns the execution profile counted by a module instance's code compiled with
+        // CompileOptions::enableProfileCounters, which can be passed as CompileOptions::profile to
+        // compile the module again. Like getFunctionCallCounts, it includes the counts of a
+        // function's lazily compiled or tier-up optimized code.
+        RUNTIME_API LLVMJIT::ModuleProfile getModuleProfile(ModuleInstance *moduleInstance);
+
+        // Recompiles a module instance's functions with the IDs of its tables and memories, and the
+        // values of its immutable numeric globals, including imported ones, folded in as
+        // constants, and forwards calls to its functions to the specialized code. The compile runs
+        // on the calling thread while the instance's code keeps running. Returns false if the
+        // module wasn't compiled with enableTierUp, lazy compilation or the interpreter, which the
+        // specialized code is installed through, or if the instance was destroyed during the
+        // compile.
+        RUNTIME_API bool specializeModuleInstance(ModuleInstance *moduleInstance);
+
+        // Writes a module profile, so it can be saved next to the compiled module and used to compile
+        // it again in a later process.
+        RUNTIME_API void saveModuleProfile(const LLVMJIT::ModuleProfile &profile, Serialization::OutputStream &stream);
+
+        // Reads a module profile written by saveModuleProfile. Throws
+        // Serialization::FatalSerializationException if the profile is malformed.
+        RUNTIME_API void loadModuleProfile(Serialization::InputStream &stream, LLVMJIT::ModuleProfile &outProfile);
+
+        // A trap raised by WebAssembly code, and the function that raised it.
+        struct Trap {
+            enum class Type {
+                // An access to a memory's reserved address space beyond its current size, or to its
+                // guard pages. memory and memoryAddress identify the accessed address.
+                outOfBoundsMemoryAccess,
+                stackOverflow,
+                integerDivideByZeroOrOverflow,
+                // The traps below are detected by checks in the code instead of a hardware fault.
+                unreachable,
+                invalidFloatOperation,
+                // A call_indirect of a table element that is out of bounds, uninitialized, or a
+                // function of the wrong type.
+                invalidIndirectCall,
+                misalignedAtomicMemoryAccess,
+                // A table.get, table.set or table.init of an element beyond the table's size, or a
+                // host call of getTableElement or setTableElement with such an index.
+                outOfBoundsTableAccess,
+                // Code compiled with fuel metering ran out of fuel, and there is no out-of-fuel
+                // handler.
+                outOfFuel,
+            };
+
+            Type type;
+            Function *function;
+            Memory *memory;
+            Uptr memoryAddress;
+        };
+
+        typedef std::function<void(const Trap &)> TrapHandler;
+
+        // Calls thunk, and if WebAssembly code called by it raises a trap on this thread, unwinds the
+        // stack to the call, calls handler with the trap, and returns true. Returns false if thunk
+        // returns normally. The trap is recognized by the signal handler without locking or
+        // allocating, so handling it costs about as much as the signal itself, but the unwound
+        // frames' destructors are not called. Traps detected by checks in the code jump straight
+        // back to the call without raising a signal, so they're cheaper still. Faults in host code
+        // are not caught.
+        RUNTIME_API bool catchTraps(const std::function<void()> &thunk, const TrapHandler &handler);
+
+        // An invocation of a function that runs on its own stack, so a host function it calls may
+        // suspend it, e.g. to wait for I/O, and return control to the code that started or resumed
+        // it. One thread may multiplex many suspended invocations from an event loop. Each
+        // in-flight invocation must use its own context.
+        struct Invocation;
+
+        enum class InvocationState {
+            // A host function called suspendInvocation, and the invocation may be resumed.
+            suspended,
+            // The function returned, and its results may be read with getInvocationResults.
+            returned,
+            // The function raised a trap, which may be read with getInvocationTrap.
+            trapped,
+            // The function threw a C++ exception, which was rethrown to the code that resumed it.
+            threw,
+        };
+
+        // Creates an invocation of a function with the given arguments, and runs it on a pooled guest
+        // stack of numStackBytes until it returns, traps or is suspended. The invocation keeps the
+        // context and function alive until it is destroyed. If the function throws, the invocation
+        // is destroyed and the exception is rethrown.
+        RUNTIME_API Invocation *startInvocation(Context *context, Function *function, const IR::UntaggedValue *arguments, Uptr numStackBytes = 1024 * 1024);
+
+        // Runs a suspended invocation until it returns, traps or is suspended again. An invocation
+        // must be resumed on the thread that started it.
+        RUNTIME_API InvocationState resumeInvocation(Invocation *invocation);
+
+        RUNTIME_API InvocationState getInvocationState(const Invocation *invocation);
+        RUNTIME_API const std::vector<IR::UntaggedValue> &getInvocationResults(const Invocation *invocation);
+        RUNTIME_API const Trap &getInvocationTrap(const Invocation *invocation);
+
+        // Frees an invocation that isn't running. The stack of a suspended invocation is freed
+        // without unwinding it, as if it trapped.
+        RUNTIME_API void destroyInvocation(Invocation *invocation);
+
+        // Returns the invocation that the calling host function was called by, or null if it wasn't
+        // called by an invocation.
+        RUNTIME_API Invocation *getCurrentInvocation();
+
+        // Suspends the current invocation, returning from the startInvocation or resumeInvocation
+        // that ran it, and returns when the invocation is resumed.
+        RUNTIME_API void suspendInvocation();
+
+        RUNTIME_API Context *getInvocationContext(const Invocation *invocation);
+
+        // An executor that runs invocations of a compartment's functions on a pool of worker
+        // threads. Each worker has its own contexts in the compartment, created up front and reused,
+        // and its own deque of tasks: a worker runs its newest task first, and steals the oldest
+        // tasks of other workers when its deque is empty, so tasks are spread across the workers
+        // without a shared lock.
+        struct Executor;
+
+        // Called on a worker thread when an invocation submitted to an executor returns, traps, or
+        // throws a C++ exception. The invocation is destroyed after the completion returns. The
+        // completion must not throw.
+        typedef std::function<void(Invocation *invocation)> InvocationCompletion;
+
+        // Creates an executor with numWorkers worker threads, or one per hardware thread if
+        // numWorkers is zero. Each invocation runs on a stack of numStackBytes. If the compartment
+        // has a NUMA node, the workers run on its CPUs, and there is one per hardware thread of the
+        // node by default.
+        RUNTIME_API Executor *createExecutor(Compartment *compartment, Uptr numWorkers = 0, Uptr numStackBytes = 1024 * 1024);
+
+        // Queues an invocation of a function with the given arguments, which are copied. May be
+        // called from any thread, including from a completion or a host function running on one of
+        // the executor's workers, which queues the invocation on its own deque.
+        RUNTIME_API void submitInvocation(Executor *executor, Function *function, const IR::UntaggedValue *arguments, InvocationCompletion &&completion);
+
+        // Queues a suspended invocation that was submitted to an executor to be resumed on the worker
+        // that started it. May be called from any thread, e.g. by an event loop when the I/O the
+        // invocation is waiting for completes, and before the invocation has finished suspending.
+        RUNTIME_API void scheduleResume(Invocation *invocation);
+
+        // Suspends the current invocation, which must have been submitted to an executor, and queues
+        // it to be resumed after the worker's other ready tasks. An InterruptHandler may call this
+        // to time-slice long-running invocations requested by interruptExecutorWorkers.
+        RUNTIME_API void yieldInvocation();
+
+        // Requests an interrupt in the context of the invocation each of the executor's workers is
+        // running. A request that the invocation doesn't observe before it completes or suspends is
+        // discarded, so it isn't delivered to another invocation that later runs in the context.
+        RUNTIME_API void interruptExecutorWorkers(Executor *executor);
+
+        // Waits for all invocations submitted to the executor to complete, including suspended
+        // invocations, which must be resumed, and then stops its workers and frees it.
+        RUNTIME_API void destroyExecutor(Executor *executor);
     }
 }
@@ -2,6 +2,10 @@
 
 #include <atomic>
 #include <map>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
 
 #include "WAVM/IR/Value.h"
 #include "WAVM/Inline/BasicTypes.h"
@@ -32,20 +36,52 @@ namespace WAVM {
 
         enum {
             maxThunkArgAndReturnBytes = 256,
-            maxGlobalBytes = 4096 - maxThunkArgAndReturnBytes,
+            maxGlobalBytes = 4096 - maxThunkArgAndReturnBytes - sizeof(IR::UntaggedValue),
             maxMutableGlobals = maxGlobalBytes / sizeof(IR::UntaggedValue),
             maxMemories = 255,
-            maxTables = (4096 - maxMemories * sizeof(void *) - sizeof(Compartment *)) / sizeof(void *),
+            maxTables = (8192 - maxMemories * (sizeof(void *) + 2 * sizeof(Uptr)) - sizeof(Compartment *)) / (sizeof(void *) + sizeof(Uptr)),
             compartmentRuntimeDataAlignmentLog2 = 32
         };
 
+        // The minimum number of inaccessible bytes that follow a memory's address space
+        // reservation. Code that clamps an address to the end of the reservation may add an offset
+        // smaller than this to the clamped address.
+        static constexpr Uptr boundedMemoryGuardBytes = 4096;
+
         static_assert(sizeof(IR::UntaggedValue) * IR::maxReturnValues <=
                       maxThunkArgAndReturnBytes, "maxThunkArgAndReturnBytes must be large enough to hold IR::maxReturnValues * "
                                                  "sizeof(UntaggedValue)");
 
+        // Returns whether values of the given types can be passed through ContextRuntimeData's
+        // thunkArgAndReturnData buffer to or from the interpreter, which doesn't support v128
+        // values. The JIT uses it to decide whether to emit an interpreter stub for a function.
+        inline bool canPassValuesToInterpreter(IR::TypeTuple types) {
+            Uptr numBytes = 0;
+            for (IR::ValueType type : types) {
+                if (type == IR::ValueType::v128) {
+                    return false;
+                }
+                const Uptr numValueBytes = IR::getTypeByteWidth(type);
+                numBytes = (numBytes + numValueBytes - 1) & -numValueBytes;
+                numBytes += numValueBytes;
+            }
+            return numBytes <= maxThunkArgAndReturnBytes;
+        }
+
         struct ContextRuntimeData {
             U8 thunkArgAndReturnData[maxThunkArgAndReturnBytes];
             IR::UntaggedValue mutableGlobals[maxMutableGlobals];
+
+            // Non-zero if another thread has requested that code running in the context be
+            // interrupted. Code compiled with interrupt checks polls it on function entry and on
+            // loop back-edges.
+            std::atomic<U32> interruptRequested;
+            U32 padding;
+
+            // The execution budget left for code compiled with fuel metering. Each basic block
+            // subtracts its number of operators when it is entered, and calls the outOfFuel
+            // intrinsic if the result is negative.
+            I64 fuel;
         };
 
         static_assert(sizeof(ContextRuntimeData) == 4096, "");
@@ -53,7 +89,20 @@ namespace WAVM {
         struct CompartmentRuntimeData {
             Compartment *compartment;
             void *memoryBases[maxMemories];
+
+            // The number of bytes reserved for each memory, which generated code compiled with
+            // explicit memory bounds checks clamps addresses to.
+            Uptr memoryNumReservedBytes[maxMemories];
+
+            // The number of committed bytes of each memory, which generated code checks inline
+            // bulk memory operations against. A grow updates this after committing its pages.
+            std::atomic<Uptr> memoryNumBytes[maxMemories];
+
             void *tableBases[maxTables];
+
+            // The number of elements of each table, which generated code checks inline table
+            // accesses against. A grow updates this after committing the new elements' pages.
+            std::atomic<Uptr> tableNumElements[maxTables];
             ContextRuntimeData contexts[1];
         };
 
@@ -77,14 +126,97 @@ namespace WAVM {
             const ObjectKind kind;
         };
 
+        // The state used by tiered compilation of a function. The baseline code of a function that
+        // was compiled with tier-up enabled counts its calls in numCalls, and forwards calls to
+        // optimizedCode once the function has been recompiled.
+        struct FunctionTierUpState {
+            std::atomic<Uptr> numCalls{0};
+            std::atomic<const U8 *> optimizedCode{nullptr};
+        };
+
+        // The counters of the calls to a function, which are only updated by code compiled with
+        // CompileOptions::enableCallCounters. inclusiveTicks is only updated with
+        // CompileOptions::enableCallTiming, and counts the cycle counter ticks between the
+        // function's entry and return, including the time spent in its callees.
+        struct FunctionCallCounters {
+            std::atomic<U64> numCalls{0};
+            std::atomic<U64> inclusiveTicks{0};
+        };
+
+        // The offset of FunctionMutableData::callCounters. Both FunctionTierUpState and
+        // FunctionCallCounters only contain atomics of 8 bytes or less, so callCounters immediately
+        // follows tierUp.
+        static constexpr Uptr functionCallCountersOffset = sizeof(FunctionTierUpState);
+
         struct FunctionMutableData {
+            // These must be the first members: generated code addresses them through the
+            // FunctionMutableData pointer it is bound to.
+            FunctionTierUpState tierUp;
+            FunctionCallCounters callCounters;
+
             LLVMJIT::Module *jitModule = nullptr;
             Runtime::Function *function = nullptr;
             Uptr numCodeBytes = 0;
+            // The number of root references to the function, updated like
+            // GCObject::numRootReferences.
             std::atomic<Uptr> numRootReferences{0};
-            std::string debugName;
 
-            FunctionMutableData(std::string &&inDebugName) : debugName(inDebugName) {}
+            // The function's name for debugging. It refers to ownedDebugName, or to a name shared by
+            // all the instances of a module that outlives the FunctionMutableData.
+            std::string ownedDebugName;
+            const std::string &debugName;
+
+            // The LLVMJIT::InvokeThunkPointer for the function's type, cached by the first invoke of
+            // the function so subsequent invokes don't need to look it up.
+            std::atomic<void *> invokeThunk{nullptr};
+
+            // The profile counters in the function's object code, if it was compiled with
+            // CompileOptions::enableProfileCounters. They are laid out as described by
+            // LLVMJIT::numProfileCountersHeaderElements.
+            std::atomic<U64> *profileCounters = nullptr;
+
+            FunctionMutableData(std::string &&inDebugName) : ownedDebugName(std::move(inDebugName)), debugName(ownedDebugName) {}
+            FunctionMutableData(const std::string *sharedDebugName) : debugName(*sharedDebugName) {}
+        };
+
+        // The FunctionMutableData objects for the function definitions of a module instance, in a
+        // single allocation, so instantiating and freeing a module with many functions doesn't
+        // allocate and free each function's object separately. The names are shared with the other
+        // instances of the module, and are kept alive by the slab. The LLVMJIT::Module the
+        // functions are loaded into owns the slab.
+        struct FunctionMutableDataSlab {
+            // If debugNames is null, all the functions have an empty name.
+            FunctionMutableDataSlab(Uptr inNumFunctions, std::shared_ptr<const std::vector<std::string>> &&inDebugNames)
+                    : numFunctions(inNumFunctions), debugNames(std::move(inDebugNames)) {
+                mutableDatas = static_cast<FunctionMutableData *>(::operator new(numFunctions * sizeof(FunctionMutableData)));
+                for (Uptr functionIndex = 0; functionIndex < numFunctions; ++functionIndex) {
+                    new (&mutableDatas[functionIndex]) FunctionMutableData(debugNames ? &(*debugNames)[functionIndex] : &emptyDebugName);
+                }
+            }
+
+            ~FunctionMutableDataSlab() {
+                for (Uptr functionIndex = 0; functionIndex < numFunctions; ++functionIndex) {
+                    mutableDatas[functionIndex].~FunctionMutableData();
+                }
+                ::operator delete(mutableDatas);
+            }
+
+            FunctionMutableDataSlab(const FunctionMutableDataSlab &) = delete;
+            FunctionMutableDataSlab &operator=(const FunctionMutableDataSlab &) = delete;
+
+            FunctionMutableData *get(Uptr functionIndex) {
+                return &mutableDatas[functionIndex];
+            }
+
+            bool contains(const FunctionMutableData *mutableData) const {
+                return mutableData >= mutableDatas && mutableData < mutableDatas + numFunctions;
+            }
+
+        private:
+            const Uptr numFunctions;
+            FunctionMutableData *mutableDatas;
+            const std::shared_ptr<const std::vector<std::string>> debugNames;
+            const std::string emptyDebugName;
         };
 
         struct Function {
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <functional>
+#include <string>
+
+#include "WAVM/Inline/BasicTypes.h"
+
+namespace WAVM {
+    namespace IR {
+        struct Module;
+    }
+}
+
+namespace WAVM {
+    namespace WASM {
+        // Returns whether a byte buffer starts with the WebAssembly binary format magic number.
+        WASMPARSE_API bool isBinaryModule(const U8 *bytes, Uptr numBytes);
+
+        // Decodes and validates a module in the WebAssembly binary format. Returns false and sets
+        // outErrorMessage (if it is non-null) if the module is malformed or invalid. If outModule has
+        // a backingBuffer, the bytes must be in it, and the module's data segments and user sections
+        // are views of them instead of copies.
+        WASMPARSE_API bool parseModule(const U8 *bytes, Uptr numBytes, IR::Module &outModule, std::string *outErrorMessage = nullptr);
+
+        // Decodes and validates a module in the WebAssembly binary format from bytes that are
+        // provided incrementally, e.g. as they are read from a file or the network. Each function
+        // definition is decoded as soon as all its bytes have been provided, so it may be compiled
+        // while the rest of the module is still arriving.
+        struct StreamingModuleParser;
+
+        // Called with the index of each function definition after its code has been decoded and
+        // validated. The parser doesn't modify the function definition, or the sections that precede
+        // the code section, after calling it.
+        typedef std::function<void(Uptr functionDefIndex)> DecodedFunctionDefCallback;
+
+        // Creates a parser that decodes a module into outModule, which must outlive the parser.
+        WASMPARSE_API StreamingModuleParser *createStreamingModuleParser(IR::Module &outModule, DecodedFunctionDefCallback &&decodedFunctionDefCallback);
+        WASMPARSE_API void destroyStreamingModuleParser(StreamingModuleParser *parser);
+
+        // Provides the next bytes of the module, and decodes as much of the module as they allow.
+        // Returns false and sets outErrorMessage (if it is non-null) if the module is malformed or
+        // invalid; the parser fails all subsequent calls.
+        WASMPARSE_API bool addStreamingModuleBytes(StreamingModuleParser *parser, const U8 *bytes, Uptr numBytes, std::string *outErrorMessage = nullptr);
+
+        // Checks that all the module's bytes have been provided, and does the validation that needs
+        // the whole module. Returns false and sets outErrorMessage (if it is non-null) if the module
+        // is malformed or invalid.
+        WASMPARSE_API bool finishStreamingModuleParser(StreamingModuleParser *parser, std::string *outErrorMessage = nullptr);
+    }
+}
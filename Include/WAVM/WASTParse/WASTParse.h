@@ -34,6 +34,10 @@ namespace WAVM {
             }
         };
 
+        // Parses a module from stringLength characters of WebAssembly text. The lexer needs the text
+        // to end with a zero byte: if the last character isn't zero, the text is copied to a buffer
+        // with one appended. To parse text without copying it, include a zero byte that follows it
+        // in stringLength, e.g. the one that follows the contents of a Platform::mapFile mapping.
         WASTPARSE_API bool parseModule(const char *string, Uptr stringLength, IR::Module &outModule);
     }
 }
@@ -1,23 +1,39 @@
+#include <errno.h>
 #include <math.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 #include <time.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <initializer_list>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #ifndef _WIN32
 
 #include <sys/uio.h>
+#include <unistd.h>
 #include <iostream>
 
+#else
+
+#include <io.h>
+
 #endif
 
 #include "WAVM/Emscripten/Emscripten.h"
 #include "WAVM/IR/Module.h"
+#include "WAVM/Inline/Errors.h"
 #include "WAVM/Inline/FloatComponents.h"
 #include "WAVM/Inline/HashMap.h"
+#include "WAVM/Inline/Lock.h"
+#include "WAVM/Platform/Memory.h"
+#include "WAVM/Platform/Mutex.h"
 #include "WAVM/Runtime/Intrinsics.h"
 
 using namespace WAVM;
@@ -47,7 +63,13 @@ enum {
 };
 
 enum ErrNo {
-    einval = 22
+    eperm = 1,
+    esrch = 3,
+    eagain = 11,
+    ebusy = 16,
+    einval = 22,
+    edeadlk = 35,
+    etimedout = 110
 };
 
 struct MutableGlobals {
@@ -87,19 +109,55 @@ DEFINE_INTRINSIC_GLOBAL(env, "EMT_STACK_MAX", U32, EMT_STACK_MAX, 0)
 DEFINE_INTRINSIC_GLOBAL(env, "eb", I32, eb, 0)
 
 static thread_local Memory *emscriptenMemory = nullptr;
+static thread_local Emscripten::Instance *emscriptenInstance = nullptr;
+
+// Grows the memory so it has at least minNumPages pages, by at least as many pages as the growth
+// policy asks for, so a guest that allocates memory in many small pieces doesn't grow it one page
+// at a time.
+static void growMemoryForDynamicAlloc(Memory *memory, const Emscripten::MemoryGrowthPolicy &policy, Uptr minNumPages) {
+    // Serialize the growth, so threads that allocate concurrently don't each grow the memory.
+    static Platform::Mutex growthMutex;
+    Lock<Platform::Mutex> growthLock(growthMutex);
+
+    const Uptr numPages = getMemoryNumPages(memory);
+    const Uptr maxPages = getMemoryMaxPages(memory);
+    if (minNumPages <= numPages || minNumPages > maxPages) {
+        return;
+    }
 
-static U32 dynamicAlloc(Memory *memory, U32 numBytes) {
-    MutableGlobals &mutableGlobals = memoryRef<MutableGlobals>(memory, MutableGlobals::address);
+    Uptr numGrowthPages = policy.doubleSize ? numPages : 0;
+    if (numGrowthPages > policy.maxGrowthPages) {
+        numGrowthPages = policy.maxGrowthPages;
+    }
+    if (numGrowthPages < policy.minGrowthPages) {
+        numGrowthPages = policy.minGrowthPages;
+    }
+    if (numGrowthPages < minNumPages - numPages) {
+        numGrowthPages = minNumPages - numPages;
+    }
+    if (numGrowthPages > maxPages - numPages) {
+        numGrowthPages = maxPages - numPages;
+    }
 
-    const U32 allocationAddress = mutableGlobals.DYNAMICTOP_PTR;
-    const U32 endAddress = (allocationAddress + numBytes + 15) & -16;
+    growMemory(memory, numGrowthPages);
+}
 
-    mutableGlobals.DYNAMICTOP_PTR = endAddress;
+static U32 dynamicAlloc(Emscripten::Instance *instance, U32 numBytes) {
+    Memory *memory = instance->emscriptenMemory;
+    MutableGlobals &mutableGlobals = memoryRef<MutableGlobals>(memory, MutableGlobals::address);
 
+    // Allocate the memory with a compare-and-swap of DYNAMICTOP_PTR, so threads can allocate
+    // concurrently.
+    std::atomic<U32> &dynamicTop = *reinterpret_cast<std::atomic<U32> *>(&mutableGlobals.DYNAMICTOP_PTR);
+    U32 allocationAddress = dynamicTop.load(std::memory_order_relaxed);
+    U32 endAddress;
+    do {
+        endAddress = (allocationAddress + numBytes + 15) & -16;
+    } while (!dynamicTop.compare_exchange_weak(allocationAddress, endAddress, std::memory_order_relaxed));
+
+    // Keep a page past the end of the allocation, like the memory has always been grown.
     const Uptr endPage = (endAddress + IR::numBytesPerPage - 1) / IR::numBytesPerPage;
-    if (endPage >= getMemoryNumPages(memory) && endPage < getMemoryMaxPages(memory)) {
-        growMemory(memory, endPage - getMemoryNumPages(memory) + 1);
-    }
+    growMemoryForDynamicAlloc(memory, instance->memoryGrowthPolicy, endPage + 1);
 
     return allocationAddress;
 }
@@ -132,40 +190,188 @@ DEFINE_INTRINSIC_FUNCTION(env, "_sysconf", I32, _sysconf, I32 a) {
     }
 }
 
-DEFINE_INTRINSIC_FUNCTION(env, "_pthread_cond_wait", I32, _pthread_cond_wait, I32 a, I32 b) {
-    return 0;
+// Guest mutexes and condition variables are implemented on the words of the guest's
+// pthread_mutex_t and pthread_cond_t, which are zero when statically initialized, and block in the
+// runtime's atomic wait lists, so they work the same for threads in any instance sharing the
+// memory.
+
+static thread_local U32 currentGuestThreadId = 0;
+
+static std::atomic<U32> &guestAtomicU32(Memory *memory, U32 address) {
+    return *reinterpret_cast<std::atomic<U32> *>(memoryArrayPtr<U32>(memory, address, 1));
+}
+
+// The guest's libc initializes a mutex's type in the first word of its pthread_mutex_t, so the lock
+// uses the words libc leaves to the lock implementation. The state word is 0 if the mutex is
+// unlocked, 1 if it is locked, and 2 if it is locked and threads may be waiting for it. A recursive
+// mutex also records its owner, as the thread's ID + 1, and how many more times the owner locked it.
+enum {
+    guestMutexTypeOffset = 0,
+    guestMutexStateOffset = 4,
+    guestMutexOwnerOffset = 8,
+    guestMutexCountOffset = 20,
+
+    guestMutexTypeMask = 3,
+    guestMutexRecursiveType = 1
+};
+
+static bool isGuestMutexRecursive(Memory *memory, U32 mutexAddress) {
+    return (memoryRef<U32>(memory, mutexAddress + guestMutexTypeOffset) & guestMutexTypeMask) == guestMutexRecursiveType;
+}
+
+// Returns true if the calling thread owns a recursive mutex, and counts the additional lock.
+static bool tryRelockGuestMutex(Memory *memory, U32 mutexAddress) {
+    if (!isGuestMutexRecursive(memory, mutexAddress) ||
+        guestAtomicU32(memory, mutexAddress + guestMutexOwnerOffset).load(std::memory_order_relaxed) != currentGuestThreadId + 1) {
+        return false;
+    }
+    ++memoryRef<U32>(memory, mutexAddress + guestMutexCountOffset);
+    return true;
+}
+
+static void setGuestMutexOwner(Memory *memory, U32 mutexAddress) {
+    if (isGuestMutexRecursive(memory, mutexAddress)) {
+        guestAtomicU32(memory, mutexAddress + guestMutexOwnerOffset).store(currentGuestThreadId + 1, std::memory_order_relaxed);
+        memoryRef<U32>(memory, mutexAddress + guestMutexCountOffset) = 0;
+    }
 }
 
-DEFINE_INTRINSIC_FUNCTION(env, "_pthread_cond_broadcast", I32, _pthread_cond_broadcast, I32 a) {
+static void lockGuestMutex(Memory *memory, U32 mutexAddress) {
+    if (tryRelockGuestMutex(memory, mutexAddress)) {
+        return;
+    }
+
+    const U32 stateAddress = mutexAddress + guestMutexStateOffset;
+    std::atomic<U32> &state = guestAtomicU32(memory, stateAddress);
+    U32 previousState = 0;
+    if (!state.compare_exchange_strong(previousState, 1, std::memory_order_acquire)) {
+        if (previousState != 2) {
+            previousState = state.exchange(2, std::memory_order_acquire);
+        }
+        while (previousState != 0) {
+            waitOnAtomicAddress(memory, stateAddress, 2, -1.0);
+            previousState = state.exchange(2, std::memory_order_acquire);
+        }
+    }
+    setGuestMutexOwner(memory, mutexAddress);
+}
+
+static I32 tryLockGuestMutex(Memory *memory, U32 mutexAddress) {
+    if (tryRelockGuestMutex(memory, mutexAddress)) {
+        return 0;
+    }
+
+    U32 previousState = 0;
+    if (!guestAtomicU32(memory, mutexAddress + guestMutexStateOffset).compare_exchange_strong(previousState, 1, std::memory_order_acquire)) {
+        return ErrNo::ebusy;
+    }
+    setGuestMutexOwner(memory, mutexAddress);
     return 0;
 }
 
-static HashMap<U32, I32> pthreadSpecific = {};
-static U32 pthreadSpecificNextKey = 0;
+static I32 unlockGuestMutex(Memory *memory, U32 mutexAddress) {
+    if (isGuestMutexRecursive(memory, mutexAddress)) {
+        std::atomic<U32> &owner = guestAtomicU32(memory, mutexAddress + guestMutexOwnerOffset);
+        if (owner.load(std::memory_order_relaxed) != currentGuestThreadId + 1) {
+            return ErrNo::eperm;
+        }
+        U32 &count = memoryRef<U32>(memory, mutexAddress + guestMutexCountOffset);
+        if (count) {
+            --count;
+            return 0;
+        }
+        owner.store(0, std::memory_order_relaxed);
+    }
 
-DEFINE_INTRINSIC_FUNCTION(env, "_pthread_key_create", I32, _pthread_key_create, U32 key, I32 destructorPtr) {
-    if (key == 0) {
-        return ErrNo::einval;
+    const U32 stateAddress = mutexAddress + guestMutexStateOffset;
+    std::atomic<U32> &state = guestAtomicU32(memory, stateAddress);
+    if (state.fetch_sub(1, std::memory_order_release) != 1) {
+        state.store(0, std::memory_order_release);
+        wakeAtomicAddress(memory, stateAddress, 1);
     }
+    return 0;
+}
+
+DEFINE_INTRINSIC_FUNCTION(env, "_pthread_mutex_lock", I32, _pthread_mutex_lock, U32 mutexAddress) {
+    wavmAssert(emscriptenMemory);
+    lockGuestMutex(emscriptenMemory, mutexAddress);
+    return 0;
+}
 
+DEFINE_INTRINSIC_FUNCTION(env, "_pthread_mutex_trylock", I32, _pthread_mutex_trylock, U32 mutexAddress) {
     wavmAssert(emscriptenMemory);
-    memoryRef<U32>(emscriptenMemory, key) = pthreadSpecificNextKey;
-    pthreadSpecific.set(pthreadSpecificNextKey, 0);
-    pthreadSpecificNextKey++;
+    return tryLockGuestMutex(emscriptenMemory, mutexAddress);
+}
 
+DEFINE_INTRINSIC_FUNCTION(env, "_pthread_mutex_unlock", I32, _pthread_mutex_unlock, U32 mutexAddress) {
+    wavmAssert(emscriptenMemory);
+    return unlockGuestMutex(emscriptenMemory, mutexAddress);
+}
+
+// A condition variable's first word is a sequence number that is incremented by each signal or
+// broadcast, so a waiter that reads it before unlocking the mutex can't miss a wake that happens
+// after.
+static I32 waitOnGuestCondition(Memory *memory, U32 condAddress, U32 mutexAddress, F64 timeout) {
+    const U32 sequence = guestAtomicU32(memory, condAddress).load(std::memory_order_acquire);
+    unlockGuestMutex(memory, mutexAddress);
+    const U32 waitResult = waitOnAtomicAddress(memory, condAddress, I32(sequence), timeout);
+    lockGuestMutex(memory, mutexAddress);
+    return waitResult == 2 ? I32(ErrNo::etimedout) : 0;
+}
+
+static void signalGuestCondition(Memory *memory, U32 condAddress, U32 numToWake) {
+    guestAtomicU32(memory, condAddress).fetch_add(1, std::memory_order_release);
+    wakeAtomicAddress(memory, condAddress, numToWake);
+}
+
+DEFINE_INTRINSIC_FUNCTION(env, "_pthread_cond_wait", I32, _pthread_cond_wait, U32 condAddress, U32 mutexAddress) {
+    wavmAssert(emscriptenMemory);
+    return waitOnGuestCondition(emscriptenMemory, condAddress, mutexAddress, -1.0);
+}
+
+DEFINE_INTRINSIC_FUNCTION(env, "_pthread_cond_timedwait", I32, _pthread_cond_timedwait, U32 condAddress, U32 mutexAddress, U32 absTimeAddress) {
+    wavmAssert(emscriptenMemory);
+
+    // The guest's timespec is a pair of 32-bit seconds and nanoseconds of the realtime clock.
+    const I32 *absTime = memoryArrayPtr<I32>(emscriptenMemory, absTimeAddress, 2);
+    const F64 absTimeNanoseconds = F64(absTime[0]) * 1000000000.0 + F64(absTime[1]);
+    const F64 currentTimeNanoseconds = F64(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+    if (absTimeNanoseconds <= currentTimeNanoseconds) {
+        return ErrNo::etimedout;
+    }
+    return waitOnGuestCondition(emscriptenMemory, condAddress, mutexAddress, absTimeNanoseconds - currentTimeNanoseconds);
+}
+
+DEFINE_INTRINSIC_FUNCTION(env, "_pthread_cond_signal", I32, _pthread_cond_signal, U32 condAddress) {
+    wavmAssert(emscriptenMemory);
+    signalGuestCondition(emscriptenMemory, condAddress, 1);
     return 0;
 }
 
-DEFINE_INTRINSIC_FUNCTION(env, "_pthread_mutex_lock", I32, _pthread_mutex_lock, I32 a) {
+DEFINE_INTRINSIC_FUNCTION(env, "_pthread_cond_broadcast", I32, _pthread_cond_broadcast, U32 condAddress) {
+    wavmAssert(emscriptenMemory);
+    signalGuestCondition(emscriptenMemory, condAddress, UINT32_MAX);
     return 0;
 }
 
-DEFINE_INTRINSIC_FUNCTION(env, "_pthread_mutex_unlock", I32, _pthread_mutex_unlock, I32 a) {
+// Keys are shared by all threads, and each thread has its own values for them. The destructors
+// passed to pthread_key_create aren't called when a thread exits.
+static std::atomic<U32> pthreadSpecificNextKey{0};
+static thread_local HashMap<U32, I32> pthreadSpecific;
+
+DEFINE_INTRINSIC_FUNCTION(env, "_pthread_key_create", I32, _pthread_key_create, U32 key, I32 destructorPtr) {
+    if (key == 0) {
+        return ErrNo::einval;
+    }
+
+    wavmAssert(emscriptenMemory);
+    memoryRef<U32>(emscriptenMemory, key) = pthreadSpecificNextKey++;
+
     return 0;
 }
 
 DEFINE_INTRINSIC_FUNCTION(env, "_pthread_setspecific", I32, _pthread_setspecific, U32 key, I32 value) {
-    if (!pthreadSpecific.contains(key)) {
+    if (key >= pthreadSpecificNextKey.load()) {
         return ErrNo::einval;
     }
     pthreadSpecific.set(key, value);
@@ -177,16 +383,182 @@ DEFINE_INTRINSIC_FUNCTION(env, "_pthread_getspecific", I32, _pthread_getspecific
     return value ? *value : 0;
 }
 
-DEFINE_INTRINSIC_FUNCTION(env, "_pthread_self", I32, _pthread_self) {
+// Each guest thread runs on its own host thread, in its own context, with a stack allocated from
+// the instance's dynamic memory. The main thread is thread 0.
+enum {
+    guestThreadStackNumBytes = 1024 * 1024
+};
+
+struct GuestThread {
+    Emscripten::Instance *instance;
+    GCPointer<Function> startFunction;
+    I32 argument;
+    I32 result;
+    std::thread hostThread;
+
+    // Set by the thread once it no longer uses the instance, so a detached thread can be joined
+    // without waiting.
+    std::atomic<bool> hasExited{false};
+};
+
+namespace WAVM {
+    namespace Emscripten {
+        struct Threads {
+            Compartment *compartment;
+
+            Platform::Mutex mutex;
+            U32 nextThreadId = 1;
+            HashMap<U32, std::shared_ptr<GuestThread>> idToJoinableThreadMap;
+
+            // The threads that were detached, which are still joined before the instance is
+            // destroyed, since they refer to it.
+            std::vector<std::shared_ptr<GuestThread>> detachedThreads;
+
+            // The stacks of exited threads, which are reused by new threads.
+            std::vector<U32> freeStackAddresses;
+        };
+    }
+}
+
+static void guestThreadEntry(std::shared_ptr<GuestThread> thread, U32 threadId) {
+    Emscripten::Instance *instance = thread->instance;
+    emscriptenInstance = instance;
+    emscriptenMemory = instance->emscriptenMemory;
+    currentGuestThreadId = threadId;
+
+    U32 stackAddress;
+    {
+        Lock<Platform::Mutex> threadsLock(instance->threads->mutex);
+        if (instance->threads->freeStackAddresses.size()) {
+            stackAddress = instance->threads->freeStackAddresses.back();
+            instance->threads->freeStackAddresses.pop_back();
+        } else {
+            threadsLock.unlock();
+            stackAddress = dynamicAlloc(instance, guestThreadStackNumBytes);
+        }
+    }
+
+    GCPointer<Context> context = createContext(instance->threads->compartment);
+    Function *establishStackSpace = asFunctionNullable(getInstanceExport(instance->moduleInstance, "establishStackSpace"));
+    if (establishStackSpace &&
+        getFunctionType(establishStackSpace) == FunctionType(TypeTuple{}, TypeTuple{ValueType::i32, ValueType::i32})) {
+        invokeFunctionChecked(context, establishStackSpace, {IR::Value(I32(stackAddress)), IR::Value(I32(stackAddress + guestThreadStackNumBytes))});
+    }
+
+    catchTraps([&] {
+        IR::ValueTuple results = invokeFunctionChecked(context, thread->startFunction, {IR::Value(thread->argument)});
+        thread->result = results.size() == 1 && results[0].type == ValueType::i32 ? results[0].i32 : 0;
+    }, [&](const Trap &trap) {
+        // A trap in a thread takes down the whole program, like a trap in the main thread does.
+        Emscripten::flushOutput(instance);
+        Errors::fatalf("Runtime trap in thread %u", threadId);
+    });
+
+    Lock<Platform::Mutex> threadsLock(instance->threads->mutex);
+    instance->threads->freeStackAddresses.push_back(stackAddress);
+    thread->hasExited.store(true, std::memory_order_release);
+}
+
+// Joins the detached threads that have exited, so the list of detached threads doesn't grow with
+// each thread the guest detaches. The caller must hold the threads' mutex.
+static void joinExitedDetachedThreads(Emscripten::Threads *threads) {
+    std::vector<std::shared_ptr<GuestThread>> &detachedThreads = threads->detachedThreads;
+    for (Uptr threadIndex = 0; threadIndex < detachedThreads.size();) {
+        if (detachedThreads[threadIndex]->hasExited.load(std::memory_order_acquire)) {
+            detachedThreads[threadIndex]->hostThread.join();
+            detachedThreads[threadIndex] = std::move(detachedThreads.back());
+            detachedThreads.pop_back();
+        } else {
+            ++threadIndex;
+        }
+    }
+}
+
+DEFINE_INTRINSIC_FUNCTION(env, "_pthread_create", I32, _pthread_create, U32 threadAddress, U32 attrAddress, U32 startRoutine, I32 argument) {
+    wavmAssert(emscriptenInstance);
+    Emscripten::Instance *instance = emscriptenInstance;
+    if (!instance->moduleInstance) {
+        return ErrNo::eagain;
+    }
+
+    // The start routine is a function pointer: an index into the instance's table.
+    Object *startObject = startRoutine < getTableNumElements(instance->emscriptenTable) ? getTableElement(instance->emscriptenTable, startRoutine) : nullptr;
+    Function *startFunction = startObject ? asFunctionNullable(startObject) : nullptr;
+    if (!startFunction || getFunctionType(startFunction) != FunctionType(TypeTuple{ValueType::i32}, TypeTuple{ValueType::i32})) {
+        return ErrNo::einval;
+    }
+
+    std::shared_ptr<GuestThread> thread = std::make_shared<GuestThread>();
+    thread->instance = instance;
+    thread->startFunction = startFunction;
+    thread->argument = argument;
+    thread->result = 0;
+
+    Lock<Platform::Mutex> threadsLock(instance->threads->mutex);
+    joinExitedDetachedThreads(instance->threads.get());
+    const U32 threadId = instance->threads->nextThreadId++;
+    thread->hostThread = std::thread(guestThreadEntry, thread, threadId);
+    instance->threads->idToJoinableThreadMap.addOrFail(threadId, thread);
+    memoryRef<U32>(emscriptenMemory, threadAddress) = threadId;
     return 0;
 }
 
+// Removes a joinable thread from the instance's threads, and returns it, or null if there isn't a
+// joinable thread with the ID.
+static std::shared_ptr<GuestThread> takeJoinableGuestThread(Emscripten::Instance *instance, U32 threadId) {
+    Lock<Platform::Mutex> threadsLock(instance->threads->mutex);
+    if (!instance->threads->idToJoinableThreadMap.contains(threadId)) {
+        return nullptr;
+    }
+    std::shared_ptr<GuestThread> thread = instance->threads->idToJoinableThreadMap.getOrAdd(threadId);
+    instance->threads->idToJoinableThreadMap.removeOrFail(threadId);
+    return thread;
+}
+
+DEFINE_INTRINSIC_FUNCTION(env, "_pthread_join", I32, _pthread_join, U32 threadId, U32 resultAddress) {
+    wavmAssert(emscriptenInstance);
+    if (threadId == currentGuestThreadId) {
+        return ErrNo::edeadlk;
+    }
+    std::shared_ptr<GuestThread> thread = takeJoinableGuestThread(emscriptenInstance, threadId);
+    if (!thread) {
+        return ErrNo::esrch;
+    }
+
+    thread->hostThread.join();
+    if (resultAddress) {
+        memoryRef<I32>(emscriptenMemory, resultAddress) = thread->result;
+    }
+    return 0;
+}
+
+DEFINE_INTRINSIC_FUNCTION(env, "_pthread_detach", I32, _pthread_detach, U32 threadId) {
+    wavmAssert(emscriptenInstance);
+    std::shared_ptr<GuestThread> thread = takeJoinableGuestThread(emscriptenInstance, threadId);
+    if (!thread) {
+        return ErrNo::esrch;
+    }
+
+    Lock<Platform::Mutex> threadsLock(emscriptenInstance->threads->mutex);
+    joinExitedDetachedThreads(emscriptenInstance->threads.get());
+    emscriptenInstance->threads->detachedThreads.push_back(std::move(thread));
+    return 0;
+}
+
+DEFINE_INTRINSIC_FUNCTION(env, "_pthread_self", I32, _pthread_self) {
+    return I32(currentGuestThreadId);
+}
+
+DEFINE_INTRINSIC_FUNCTION(env, "_pthread_equal", I32, _pthread_equal, U32 a, U32 b) {
+    return a == b ? 1 : 0;
+}
+
 DEFINE_INTRINSIC_FUNCTION(env, "___ctype_b_loc", U32, ___ctype_b_loc) {
     wavmAssert(emscriptenMemory);
     unsigned short data[384] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 2, 2, 2, 2, 2, 2, 2, 2, 8195, 8194, 8194, 8194, 8194, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 24577, 49156, 49156, 49156, 49156, 49156, 49156, 49156, 49156, 49156, 49156, 49156, 49156, 49156, 49156, 49156, 55304, 55304, 55304, 55304, 55304, 55304, 55304, 55304, 55304, 55304, 49156, 49156, 49156, 49156, 49156, 49156, 49156, 54536, 54536, 54536, 54536, 54536, 54536, 50440, 50440, 50440, 50440, 50440, 50440, 50440, 50440, 50440, 50440, 50440, 50440, 50440, 50440, 50440, 50440, 50440, 50440, 50440, 50440, 49156, 49156, 49156, 49156, 49156, 49156, 54792, 54792, 54792, 54792, 54792, 54792, 50696, 50696, 50696, 50696, 50696, 50696, 50696, 50696, 50696, 50696, 50696, 50696, 50696, 50696, 50696, 50696, 50696, 50696, 50696, 50696, 49156, 49156, 49156, 49156, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
     static U32 vmAddress = 0;
     if (vmAddress == 0) {
-        vmAddress = coerce32bitAddress(emscriptenMemory, dynamicAlloc(emscriptenMemory, sizeof(data)));
+        vmAddress = coerce32bitAddress(emscriptenMemory, dynamicAlloc(emscriptenInstance, sizeof(data)));
         memcpy(memoryArrayPtr<U8>(emscriptenMemory, vmAddress, sizeof(data)), data, sizeof(data));
     }
     return vmAddress + sizeof(short) * 128;
@@ -197,7 +569,7 @@ DEFINE_INTRINSIC_FUNCTION(env, "___ctype_toupper_loc", U32, ___ctype_toupper_loc
     I32 data[384] = {128, 129, 130, 131, 132, 133, 134, 135, 136, 137, 138, 139, 140, 141, 142, 143, 144, 145, 146, 147, 148, 149, 150, 151, 152, 153, 154, 155, 156, 157, 158, 159, 160, 161, 162, 163, 164, 165, 166, 167, 168, 169, 170, 171, 172, 173, 174, 175, 176, 177, 178, 179, 180, 181, 182, 183, 184, 185, 186, 187, 188, 189, 190, 191, 192, 193, 194, 195, 196, 197, 198, 199, 200, 201, 202, 203, 204, 205, 206, 207, 208, 209, 210, 211, 212, 213, 214, 215, 216, 217, 218, 219, 220, 221, 222, 223, 224, 225, 226, 227, 228, 229, 230, 231, 232, 233, 234, 235, 236, 237, 238, 239, 240, 241, 242, 243, 244, 245, 246, 247, 248, 249, 250, 251, 252, 253, 254, -1, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 74, 75, 76, 77, 78, 79, 80, 81, 82, 83, 84, 85, 86, 87, 88, 89, 90, 91, 92, 93, 94, 95, 96, 65, 66, 67, 68, 69, 70, 71, 72, 73, 74, 75, 76, 77, 78, 79, 80, 81, 82, 83, 84, 85, 86, 87, 88, 89, 90, 123, 124, 125, 126, 127, 128, 129, 130, 131, 132, 133, 134, 135, 136, 137, 138, 139, 140, 141, 142, 143, 144, 145, 146, 147, 148, 149, 150, 151, 152, 153, 154, 155, 156, 157, 158, 159, 160, 161, 162, 163, 164, 165, 166, 167, 168, 169, 170, 171, 172, 173, 174, 175, 176, 177, 178, 179, 180, 181, 182, 183, 184, 185, 186, 187, 188, 189, 190, 191, 192, 193, 194, 195, 196, 197, 198, 199, 200, 201, 202, 203, 204, 205, 206, 207, 208, 209, 210, 211, 212, 213, 214, 215, 216, 217, 218, 219, 220, 221, 222, 223, 224, 225, 226, 227, 228, 229, 230, 231, 232, 233, 234, 235, 236, 237, 238, 239, 240, 241, 242, 243, 244, 245, 246, 247, 248, 249, 250, 251, 252, 253, 254, 255};
     static U32 vmAddress = 0;
     if (vmAddress == 0) {
-        vmAddress = coerce32bitAddress(emscriptenMemory, dynamicAlloc(emscriptenMemory, sizeof(data)));
+        vmAddress = coerce32bitAddress(emscriptenMemory, dynamicAlloc(emscriptenInstance, sizeof(data)));
         memcpy(memoryArrayPtr<U8>(emscriptenMemory, vmAddress, sizeof(data)), data, sizeof(data));
     }
     return vmAddress + sizeof(I32) * 128;
@@ -208,7 +580,7 @@ DEFINE_INTRINSIC_FUNCTION(env, "___ctype_tolower_loc", U32, ___ctype_tolower_loc
     I32 data[384] = {128, 129, 130, 131, 132, 133, 134, 135, 136, 137, 138, 139, 140, 141, 142, 143, 144, 145, 146, 147, 148, 149, 150, 151, 152, 153, 154, 155, 156, 157, 158, 159, 160, 161, 162, 163, 164, 165, 166, 167, 168, 169, 170, 171, 172, 173, 174, 175, 176, 177, 178, 179, 180, 181, 182, 183, 184, 185, 186, 187, 188, 189, 190, 191, 192, 193, 194, 195, 196, 197, 198, 199, 200, 201, 202, 203, 204, 205, 206, 207, 208, 209, 210, 211, 212, 213, 214, 215, 216, 217, 218, 219, 220, 221, 222, 223, 224, 225, 226, 227, 228, 229, 230, 231, 232, 233, 234, 235, 236, 237, 238, 239, 240, 241, 242, 243, 244, 245, 246, 247, 248, 249, 250, 251, 252, 253, 254, -1, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63, 64, 97, 98, 99, 100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 110, 111, 112, 113, 114, 115, 116, 117, 118, 119, 120, 121, 122, 91, 92, 93, 94, 95, 96, 97, 98, 99, 100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 110, 111, 112, 113, 114, 115, 116, 117, 118, 119, 120, 121, 122, 123, 124, 125, 126, 127, 128, 129, 130, 131, 132, 133, 134, 135, 136, 137, 138, 139, 140, 141, 142, 143, 144, 145, 146, 147, 148, 149, 150, 151, 152, 153, 154, 155, 156, 157, 158, 159, 160, 161, 162, 163, 164, 165, 166, 167, 168, 169, 170, 171, 172, 173, 174, 175, 176, 177, 178, 179, 180, 181, 182, 183, 184, 185, 186, 187, 188, 189, 190, 191, 192, 193, 194, 195, 196, 197, 198, 199, 200, 201, 202, 203, 204, 205, 206, 207, 208, 209, 210, 211, 212, 213, 214, 215, 216, 217, 218, 219, 220, 221, 222, 223, 224, 225, 226, 227, 228, 229, 230, 231, 232, 233, 234, 235, 236, 237, 238, 239, 240, 241, 242, 243, 244, 245, 246, 247, 248, 249, 250, 251, 252, 253, 254, 255};
     static U32 vmAddress = 0;
     if (vmAddress == 0) {
-        vmAddress = coerce32bitAddress(emscriptenMemory, dynamicAlloc(emscriptenMemory, sizeof(data)));
+        vmAddress = coerce32bitAddress(emscriptenMemory, dynamicAlloc(emscriptenInstance, sizeof(data)));
         memcpy(memoryArrayPtr<U8>(emscriptenMemory, vmAddress, sizeof(data)), data, sizeof(data));
     }
     return vmAddress + sizeof(I32) * 128;
@@ -230,7 +602,7 @@ DEFINE_INTRINSIC_FUNCTION(env, "___cxa_guard_acquire", I32, ___cxa_guard_acquire
 
 DEFINE_INTRINSIC_FUNCTION(env, "___cxa_allocate_exception", U32, ___cxa_allocate_exception, U32 size) {
     wavmAssert(emscriptenMemory);
-    return coerce32bitAddress(emscriptenMemory, dynamicAlloc(emscriptenMemory, size));
+    return coerce32bitAddress(emscriptenMemory, dynamicAlloc(emscriptenInstance, size));
 }
 
 static U32 currentLocale = 0;
@@ -244,7 +616,7 @@ DEFINE_INTRINSIC_FUNCTION(env, "_uselocale", I32, _uselocale, I32 locale) {
 DEFINE_INTRINSIC_FUNCTION(env, "_newlocale", U32, _newlocale, I32 mask, I32 locale, I32 base) {
     wavmAssert(emscriptenMemory);
     if (!base) {
-        base = coerce32bitAddress(emscriptenMemory, dynamicAlloc(emscriptenMemory, 4));
+        base = coerce32bitAddress(emscriptenMemory, dynamicAlloc(emscriptenInstance, 4));
     }
     return base;
 }
@@ -261,10 +633,10 @@ DEFINE_INTRINSIC_FUNCTION(env, "_catclose", I32, emscripten__catclose, I32 a) {
     return 0;
 }
 
-DEFINE_INTRINSIC_FUNCTION(env, "_emscripten_memcpy_big", U32, _emscripten_memcpy_big, U32 sourceAddress, U32 destAddress, U32 numBytes) {
+DEFINE_INTRINSIC_FUNCTION(env, "_emscripten_memcpy_big", U32, _emscripten_memcpy_big, U32 destAddress, U32 sourceAddress, U32 numBytes) {
     wavmAssert(emscriptenMemory);
-    memcpy(memoryArrayPtr<U8>(emscriptenMemory, sourceAddress, numBytes), memoryArrayPtr<U8>(emscriptenMemory, destAddress, numBytes), numBytes);
-    return sourceAddress;
+    Platform::copyMemoryBytes(memoryArrayPtr<U8>(emscriptenMemory, destAddress, numBytes), memoryArrayPtr<U8>(emscriptenMemory, sourceAddress, numBytes), numBytes);
+    return destAddress;
 }
 
 enum class ioStreamVMHandle {
@@ -284,8 +656,210 @@ FILE *vmFile(U32 vmHandle) {
     }
 }
 
+// The output an instance writes to stdout and stderr is buffered, so a guest that writes its
+// output in many small pieces doesn't make a system call for each of them. The buffer is written
+// out when it is full, before the instance reads stdin, and when the instance is flushed or the
+// process exits. Output to a terminal is also written out at the end of each line, and output to
+// stderr at the end of each write, so it isn't delayed where a user would notice.
+enum {
+    outputBufferCapacity = 64 * 1024
+};
+
+struct OutputSpan {
+    const U8 *data;
+    Uptr numBytes;
+};
+
+// Writes the buffered bytes followed by the spans to a file, with as few system calls as possible.
+// Returns false if the write failed.
+static bool writeSpans(FILE *file, const U8 *bufferedBytes, Uptr numBufferedBytes, const OutputSpan *spans, Uptr numSpans) {
+    auto getSpan = [&](Uptr index) {
+        return index == 0 ? OutputSpan{bufferedBytes, numBufferedBytes} : spans[index - 1];
+    };
+#ifdef _WIN32
+    for (Uptr spanIndex = 0; spanIndex < numSpans + 1; ++spanIndex) {
+        const OutputSpan span = getSpan(spanIndex);
+        if (fwrite(span.data, 1, span.numBytes, file) < span.numBytes) {
+            return false;
+        }
+    }
+    return fflush(file) == 0;
+#else
+    // Write out anything the host has buffered in the stdio file first, so the output stays in
+    // order.
+    fflush(file);
+
+    // Write the spans directly from the memory they are in, with a vectored write for each group
+    // of maxSpansPerWrite spans, and resume after the last byte written if a write is partial.
+    enum {
+        maxSpansPerWrite = 64
+    };
+    struct iovec iovecs[maxSpansPerWrite];
+    Uptr spanIndex = 0;
+    Uptr numSpanBytesWritten = 0;
+    while (spanIndex < numSpans + 1) {
+        int numIovecs = 0;
+        for (Uptr iovecSpanIndex = spanIndex; iovecSpanIndex < numSpans + 1 && numIovecs < maxSpansPerWrite; ++iovecSpanIndex) {
+            const OutputSpan span = getSpan(iovecSpanIndex);
+            const Uptr offset = iovecSpanIndex == spanIndex ? numSpanBytesWritten : 0;
+            iovecs[numIovecs].iov_base = (void *) (span.data + offset);
+            iovecs[numIovecs].iov_len = span.numBytes - offset;
+            ++numIovecs;
+        }
+
+        const ssize_t result = writev(fileno(file), iovecs, numIovecs);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+
+        // Skip the spans that were written completely.
+        Uptr numBytesWritten = Uptr(result);
+        while (spanIndex < numSpans + 1 && numBytesWritten >= getSpan(spanIndex).numBytes - numSpanBytesWritten) {
+            numBytesWritten -= getSpan(spanIndex).numBytes - numSpanBytesWritten;
+            numSpanBytesWritten = 0;
+            ++spanIndex;
+        }
+        numSpanBytesWritten += numBytesWritten;
+    }
+    return true;
+#endif
+}
+
+struct OutputStream {
+    OutputStream(FILE *inFile, bool inFlushAtEndOfWrite)
+            : file(inFile), flushAtNewline(isatty(fileno(inFile)) != 0), flushAtEndOfWrite(inFlushAtEndOfWrite),
+              buffer(new U8[outputBufferCapacity]), numBufferedBytes(0) {
+    }
+
+    // Writes the spans to the stream. If they fit in the buffer, they are copied into it; otherwise,
+    // the buffer and the spans are written out together. Returns false if the write failed.
+    bool write(const OutputSpan *spans, Uptr numSpans) {
+        Lock<Platform::Mutex> lock(mutex);
+
+        Uptr numBytes = 0;
+        bool hasNewline = false;
+        for (Uptr spanIndex = 0; spanIndex < numSpans; ++spanIndex) {
+            numBytes += spans[spanIndex].numBytes;
+            if (flushAtNewline && !hasNewline) {
+                hasNewline = memchr(spans[spanIndex].data, '\n', spans[spanIndex].numBytes) != nullptr;
+            }
+        }
+
+        if (numBytes > outputBufferCapacity - numBufferedBytes) {
+            const bool succeeded = writeSpans(file, buffer.get(), numBufferedBytes, spans, numSpans);
+            numBufferedBytes = 0;
+            return succeeded;
+        }
+
+        for (Uptr spanIndex = 0; spanIndex < numSpans; ++spanIndex) {
+            memcpy(buffer.get() + numBufferedBytes, spans[spanIndex].data, spans[spanIndex].numBytes);
+            numBufferedBytes += spans[spanIndex].numBytes;
+        }
+        if (hasNewline || flushAtEndOfWrite || numBufferedBytes == outputBufferCapacity) {
+            return flushLocked();
+        }
+        return true;
+    }
+
+    bool flush() {
+        Lock<Platform::Mutex> lock(mutex);
+        return flushLocked();
+    }
+
+private:
+    FILE *const file;
+    const bool flushAtNewline;
+    const bool flushAtEndOfWrite;
+
+    Platform::Mutex mutex;
+    std::unique_ptr<U8[]> buffer;
+    Uptr numBufferedBytes;
+
+    bool flushLocked() {
+        if (!numBufferedBytes) {
+            return true;
+        }
+        const bool succeeded = writeSpans(file, buffer.get(), numBufferedBytes, nullptr, 0);
+        numBufferedBytes = 0;
+        return succeeded;
+    }
+};
+
+// The output streams of all live instances, so they can be flushed when the process exits. They are
+// never freed, so instances destroyed during exit can still remove themselves.
+static Platform::Mutex &getLiveOutputStreamsMutex() {
+    static Platform::Mutex *mutex = new Platform::Mutex;
+    return *mutex;
+}
+
+static std::vector<Emscripten::OutputStreams *> &getLiveOutputStreams() {
+    static std::vector<Emscripten::OutputStreams *> *liveOutputStreams = new std::vector<Emscripten::OutputStreams *>;
+    return *liveOutputStreams;
+}
+
+namespace WAVM {
+    namespace Emscripten {
+        struct OutputStreams {
+            OutputStream stdoutStream{stdout, false};
+            OutputStream stderrStream{stderr, true};
+
+            OutputStreams() {
+                Lock<Platform::Mutex> lock(getLiveOutputStreamsMutex());
+                getLiveOutputStreams().push_back(this);
+            }
+
+            ~OutputStreams() {
+                {
+                    Lock<Platform::Mutex> lock(getLiveOutputStreamsMutex());
+                    std::vector<OutputStreams *> &liveOutputStreams = getLiveOutputStreams();
+                    liveOutputStreams.erase(std::find(liveOutputStreams.begin(), liveOutputStreams.end(), this));
+                }
+                flush();
+            }
+
+            void flush() {
+                stdoutStream.flush();
+                stderrStream.flush();
+            }
+        };
+    }
+}
+
+static void flushLiveOutputStreams() {
+    Lock<Platform::Mutex> lock(getLiveOutputStreamsMutex());
+    for (Emscripten::OutputStreams *outputStreams : getLiveOutputStreams()) {
+        outputStreams->flush();
+    }
+}
+
+// Returns the output stream for a VM file handle, or null if the handle can't be written to.
+static OutputStream *vmOutputStream(U32 vmHandle) {
+    wavmAssert(emscriptenInstance);
+    switch ((ioStreamVMHandle) vmHandle) {
+        case ioStreamVMHandle::StdErr:
+            return &emscriptenInstance->outputStreams->stderrStream;
+        case ioStreamVMHandle::StdIn:
+            return nullptr;
+        default:
+            return &emscriptenInstance->outputStreams->stdoutStream;
+    }
+}
+
+// Returns the input file for a VM file handle. If it is stdin, the instance's stdout is flushed
+// first, so a prompt is written out before the instance waits for input.
+static FILE *vmInputFile(U32 vmHandle) {
+    FILE *file = vmFile(vmHandle);
+    if (file == stdin && emscriptenInstance) {
+        emscriptenInstance->outputStreams->stdoutStream.flush();
+    }
+    return file;
+}
+
 DEFINE_INTRINSIC_FUNCTION(env, "_getc", I32, _getc, I32 file) {
-    return getc(vmFile(file));
+    return getc(vmInputFile(file));
 }
 
 DEFINE_INTRINSIC_FUNCTION(env, "_ungetc", I32, _ungetc, I32 character, I32 file) {
@@ -294,51 +868,49 @@ DEFINE_INTRINSIC_FUNCTION(env, "_ungetc", I32, _ungetc, I32 character, I32 file)
 
 DEFINE_INTRINSIC_FUNCTION(env, "_fread", U32, _fread, U32 destAddress, U32 size, U32 count, I32 file) {
     wavmAssert(emscriptenMemory);
-    return coerce32bitAddress(emscriptenMemory, fread(memoryArrayPtr<U8>(emscriptenMemory, destAddress, U64(size) *
-                                                                                                        U64(count)), U64(size), U64(count), vmFile(file)));
+    const MemoryView memoryView(emscriptenMemory);
+    return coerce32bitAddress(emscriptenMemory, fread(memoryView.arrayPtr<U8>(destAddress, U64(size) * U64(count)), U64(size), U64(count), vmInputFile(file)));
 }
 
 DEFINE_INTRINSIC_FUNCTION(env, "_fwrite", U32, _fwrite, U32 sourceAddress, U32 size, U32 count, I32 file) {
     wavmAssert(emscriptenMemory);
-    return coerce32bitAddress(emscriptenMemory, fwrite(memoryArrayPtr<U8>(emscriptenMemory, sourceAddress, U64(size) *
-                                                                                                           U64(count)), U64(size), U64(count), vmFile(file)));
+    OutputStream *stream = vmOutputStream(file);
+    const MemorySpan<U8> source = MemoryView(emscriptenMemory).span<U8>(sourceAddress, Uptr(U64(size) * U64(count)));
+    const OutputSpan span = {source.data, source.size};
+    if (!stream || !stream->write(&span, 1)) {
+        return 0;
+    }
+    return count;
 }
 
 DEFINE_INTRINSIC_FUNCTION(env, "_fputc", I32, _fputc, I32 character, I32 file) {
-    return fputc(character, vmFile(file));
+    OutputStream *stream = vmOutputStream(file);
+    const U8 byte = U8(character);
+    const OutputSpan span = {&byte, 1};
+    if (!stream || !stream->write(&span, 1)) {
+        return EOF;
+    }
+    return byte;
 }
 
 DEFINE_INTRINSIC_FUNCTION(env, "___syscall146", I32, ___syscall146, I32 file, U32 argsPtr) {
     wavmAssert(emscriptenMemory);
 
     // writev
-    U32 *args = memoryArrayPtr<U32>(emscriptenMemory, argsPtr, 3);
-    U32 iov = args[1];
-    U32 iovcnt = args[2];
-#ifdef _WIN32
-    Uptr count = 0;
-    for(U32 i = 0; i < iovcnt; i++)
-    {
-        U32 base = memoryRef<U32>(emscriptenMemory, iov + i * 8);
-        U32 len = memoryRef<U32>(emscriptenMemory, iov + i * 8 + 4);
-        U32 size
-            = (U32)fwrite(memoryArrayPtr<U8>(emscriptenMemory, base, len), 1, len, vmFile(file));
-        count += size;
-        if(size < len) break;
-    }
-    return coerce32bitAddressSigned(emscriptenMemory, count);
-#else
-    struct iovec *native_iovec = new(alloca(sizeof(iovec) * iovcnt)) struct iovec[iovcnt];
-    for (U32 i = 0; i < iovcnt; i++) {
-        U32 base = memoryRef<U32>(emscriptenMemory, iov + i * 8);
-        U32 len = memoryRef<U32>(emscriptenMemory, iov + i * 8 + 4);
-
-        native_iovec[i].iov_base = memoryArrayPtr<U8>(emscriptenMemory, base, len);
-        native_iovec[i].iov_len = len;
+    const MemoryView memoryView(emscriptenMemory);
+    const MemorySpan<U32> args = memoryView.span<U32>(argsPtr, 3);
+
+    // The spans point directly into the linear memory, so a write that doesn't fit in the buffer
+    // isn't copied.
+    static thread_local std::vector<OutputSpan> spans;
+    spans.clear();
+    const U64 numBytes = memoryView.forEachIOVec(args[1], args[2], [](MemorySpan<U8> buffer) { spans.push_back({buffer.data, buffer.size}); });
+
+    OutputStream *stream = vmOutputStream(file);
+    if (!stream || !stream->write(spans.data(), spans.size())) {
+        return -1;
     }
-    Iptr count = writev(fileno(vmFile(file)), native_iovec, iovcnt);
-    return coerce32bitAddressSigned(emscriptenMemory, count);
-#endif
+    return coerce32bitAddressSigned(emscriptenMemory, numBytes);
 }
 
 DEFINE_INTRINSIC_FUNCTION(asm2wasm, "f64-to-int", I32, f64_to_int, F64 f) {
@@ -384,7 +956,7 @@ DEFINE_INTRINSIC_FUNCTION(asm2wasm, "f64-rem", F64, F64_rems, F64 left, F64 righ
     return (F64) fmod(left, right);
 }
 
-Emscripten::Instance *Emscripten::instantiate(Compartment *compartment, const IR::Module &module) {
+Emscripten::Instance *Emscripten::instantiate(Compartment *compartment, const IR::Module &module, const MemoryGrowthPolicy &memoryGrowthPolicy) {
     MemoryType memoryType(false, SizeConstraints{0, 0});
     if (module.memories.imports.size() && module.memories.imports[0].moduleName == "env" &&
         module.memories.imports[0].exportName == "memory") {
@@ -427,12 +999,60 @@ Emscripten::Instance *Emscripten::instantiate(Compartment *compartment, const IR
     mutableGlobals._stdout = (U32) ioStreamVMHandle::StdOut;
 
     instance->emscriptenMemory = memory;
+    instance->emscriptenTable = table;
+    instance->memoryGrowthPolicy = memoryGrowthPolicy;
+    instance->threads = std::make_shared<Threads>();
+    instance->threads->compartment = compartment;
     emscriptenMemory = instance->emscriptenMemory;
 
+    // Flush the output of the instances that are still alive when the process exits.
+    static std::once_flag registerExitFlushOnce;
+    std::call_once(registerExitFlushOnce, [] { atexit(flushLiveOutputStreams); });
+    instance->outputStreams = std::make_shared<OutputStreams>();
+    emscriptenInstance = instance;
+
+    // Commit the memory the growth policy asks for up front.
+    growMemoryForDynamicAlloc(memory, memoryGrowthPolicy, memoryGrowthPolicy.precommitPages);
+
     return instance;
 }
 
+Emscripten::Instance::~Instance() {
+    // Wait for the guest threads to exit, joined or detached, since they refer to the instance. A
+    // thread may create more threads while the others are joined.
+    if (!threads) {
+        return;
+    }
+    while (true) {
+        std::vector<std::shared_ptr<GuestThread>> guestThreads;
+        {
+            Lock<Platform::Mutex> threadsLock(threads->mutex);
+            for (const auto &pair : threads->idToJoinableThreadMap) {
+                guestThreads.push_back(pair.value);
+            }
+            threads->idToJoinableThreadMap.clear();
+            guestThreads.insert(guestThreads.end(), threads->detachedThreads.begin(), threads->detachedThreads.end());
+            threads->detachedThreads.clear();
+        }
+        if (guestThreads.empty()) {
+            break;
+        }
+        for (const std::shared_ptr<GuestThread> &thread : guestThreads) {
+            thread->hostThread.join();
+        }
+    }
+}
+
+void Emscripten::flushOutput(Instance *instance) {
+    instance->outputStreams->flush();
+}
+
 void Emscripten::initializeGlobals(Context *context, const IR::Module &module, ModuleInstance *moduleInstance) {
+    // Threads created by the instance run in the module instance the globals are initialized for.
+    if (emscriptenInstance) {
+        emscriptenInstance->moduleInstance = moduleInstance;
+    }
+
     // Call the establishStackSpace function to set the Emscripten module's internal stack
     // pointers.
     Function *establishStackSpace = asFunctionNullable(getInstanceExport(moduleInstance, "establishStackSpace"));
@@ -460,10 +1080,10 @@ void Emscripten::injectCommandArgs(Emscripten::Instance *instance, const std::ve
     U8 *emscriptenMemoryBaseAdress = getMemoryBaseAddress(memory);
 
     U32 *argvOffsets = (U32 *) (emscriptenMemoryBaseAdress +
-                                dynamicAlloc(memory, (U32) (sizeof(U32) * (argStrings.size() + 1))));
+                                dynamicAlloc(instance, (U32) (sizeof(U32) * (argStrings.size() + 1))));
     for (Uptr argIndex = 0; argIndex < argStrings.size(); ++argIndex) {
         auto stringSize = strlen(argStrings[argIndex]) + 1;
-        auto stringMemory = emscriptenMemoryBaseAdress + dynamicAlloc(memory, (U32) stringSize);
+        auto stringMemory = emscriptenMemoryBaseAdress + dynamicAlloc(instance, (U32) stringSize);
         memcpy(stringMemory, argStrings[argIndex], stringSize);
         argvOffsets[argIndex] = (U32) (stringMemory - emscriptenMemoryBaseAdress);
     }
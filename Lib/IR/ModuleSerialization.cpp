@@ -0,0 +1,270 @@
+#include <string>
+#include <vector>
+
+#include "WAVM/IR/IR.h"
+#include "WAVM/IR/Module.h"
+#include "WAVM/IR/Types.h"
+#include "WAVM/Inline/Assert.h"
+#include "WAVM/Inline/BasicTypes.h"
+#include "WAVM/Inline/Serialization.h"
+
+using namespace WAVM;
+using namespace WAVM::IR;
+using namespace WAVM::Serialization;
+
+// This is a lossless dump of the IR::Module structure, not the standard WebAssembly binary format:
+// it exists so that the runtime can persist a module next to its compiled object code, and so that
+// a module can be hashed without depending on a particular text or binary encoding of it.
+// Bump this whenever the layout of the serialized data changes.
+static constexpr U32 irModuleSerializationVersion = 2;
+
+static_assert(sizeof(Uptr) == sizeof(U64), "Uptr is serialized as a U64");
+
+// Serializes a byte array with a single copy, instead of the element-at-a-time serializeArray. If
+// loadView is set, the deserialized array is a view of the input stream's bytes instead of a copy.
+template<typename Stream> static void serializeByteArray(Stream &stream, ModuleBytes &bytes, bool loadView) {
+    Uptr numBytes = bytes.size();
+    serializeVarUInt32(stream, numBytes);
+    if (Stream::isInput) {
+        const U8 *inputBytes = stream.advance(numBytes);
+        if (loadView) {
+            bytes = ModuleBytes::view(inputBytes, numBytes);
+        } else {
+            bytes.assign(inputBytes, inputBytes + numBytes);
+        }
+    } else {
+        serializeBytes(stream, const_cast<U8 *>(bytes.data()), numBytes);
+    }
+}
+
+template<typename Stream> static void serialize(Stream &stream, bool &value) {
+    U8 byte = value ? 1 : 0;
+    Serialization::serialize(stream, byte);
+    if (Stream::isInput) {
+        if (byte > 1) {
+            throw FatalSerializationException("invalid bool");
+        }
+        value = byte != 0;
+    }
+}
+
+template<typename Stream> static void serialize(Stream &stream, ValueType &type) {
+    U8 byte = U8(type);
+    Serialization::serialize(stream, byte);
+    if (Stream::isInput) {
+        if (byte > U8(ValueType::nullref)) {
+            throw FatalSerializationException("invalid value type");
+        }
+        type = ValueType(byte);
+    }
+}
+
+template<typename Stream> static void serialize(Stream &stream, ReferenceType &type) {
+    U8 byte = U8(type);
+    Serialization::serialize(stream, byte);
+    type = ReferenceType(byte);
+}
+
+template<typename Stream> static void serialize(Stream &stream, TypeTuple &typeTuple) {
+    std::vector<ValueType> elems(typeTuple.begin(), typeTuple.end());
+    serializeArray(stream, elems, [](Stream &stream, ValueType &elem) {
+        serialize(stream, elem);
+    });
+    if (Stream::isInput) {
+        typeTuple = TypeTuple(elems);
+    }
+}
+
+template<typename Stream> static void serialize(Stream &stream, FunctionType &functionType) {
+    TypeTuple results = functionType.results();
+    TypeTuple params = functionType.params();
+    serialize(stream, results);
+    serialize(stream, params);
+    if (Stream::isInput) {
+        functionType = FunctionType(results, params);
+    }
+}
+
+template<typename Stream> static void serialize(Stream &stream, IndexedFunctionType &type) {
+    Serialization::serialize(stream, type.index);
+}
+
+template<typename Stream> static void serialize(Stream &stream, SizeConstraints &size) {
+    Serialization::serialize(stream, size.min);
+    Serialization::serialize(stream, size.max);
+}
+
+template<typename Stream> static void serialize(Stream &stream, TableType &type) {
+    serialize(stream, type.elementType);
+    serialize(stream, type.isShared);
+    serialize(stream, type.size);
+}
+
+template<typename Stream> static void serialize(Stream &stream, MemoryType &type) {
+    serialize(stream, type.isShared);
+    serialize(stream, type.size);
+}
+
+template<typename Stream> static void serialize(Stream &stream, GlobalType &type) {
+    serialize(stream, type.valueType);
+    serialize(stream, type.isMutable);
+}
+
+template<typename Stream> static void serialize(Stream &stream, ExceptionType &type) {
+    serialize(stream, type.params);
+}
+
+template<typename Stream> static void serialize(Stream &stream, InitializerExpression &expression) {
+    U16 type = U16(expression.type);
+    serializeNativeValue(stream, type);
+    expression.type = InitializerExpression::Type(type);
+    switch (expression.type) {
+        case InitializerExpression::Type::i32_const:
+            Serialization::serialize(stream, expression.i32);
+            break;
+        case InitializerExpression::Type::i64_const:
+            Serialization::serialize(stream, expression.i64);
+            break;
+        case InitializerExpression::Type::f32_const:
+            Serialization::serialize(stream, expression.f32);
+            break;
+        case InitializerExpression::Type::f64_const:
+            Serialization::serialize(stream, expression.f64);
+            break;
+        case InitializerExpression::Type::v128_const:
+            serializeNativeValue(stream, expression.v128);
+            break;
+        case InitializerExpression::Type::get_global:
+            Serialization::serialize(stream, expression.globalRef);
+            break;
+        case InitializerExpression::Type::ref_null:
+        case InitializerExpression::Type::error:
+            break;
+        default:
+            throw FatalSerializationException("invalid initializer expression");
+    };
+}
+
+template<typename Stream, typename Type> static void serialize(Stream &stream, Import<Type> &import) {
+    serialize(stream, import.type);
+    Serialization::serialize(stream, import.moduleName);
+    Serialization::serialize(stream, import.exportName);
+}
+
+template<typename Stream> static void serialize(Stream &stream, FunctionDef &functionDef, bool loadViews) {
+    serialize(stream, functionDef.type);
+    serializeArray(stream, functionDef.nonParameterLocalTypes, [](Stream &stream, ValueType &type) {
+        serialize(stream, type);
+    });
+    serializeByteArray(stream, functionDef.code, loadViews);
+    serializeArray(stream, functionDef.branchTables, [](Stream &stream, std::vector<Uptr> &branchTable) {
+        serializeArray(stream, branchTable, [](Stream &stream, Uptr &targetDepth) {
+            Serialization::serialize(stream, targetDepth);
+        });
+    });
+}
+
+template<typename Stream> static void serialize(Stream &stream, TableDef &tableDef) {
+    serialize(stream, tableDef.type);
+}
+
+template<typename Stream> static void serialize(Stream &stream, MemoryDef &memoryDef) {
+    serialize(stream, memoryDef.type);
+}
+
+template<typename Stream> static void serialize(Stream &stream, GlobalDef &globalDef) {
+    serialize(stream, globalDef.type);
+    serialize(stream, globalDef.initializer);
+}
+
+template<typename Stream> static void serialize(Stream &stream, ExceptionTypeDef &exceptionTypeDef) {
+    serialize(stream, exceptionTypeDef.type);
+}
+
+template<typename Stream> static void serialize(Stream &stream, Export &exportIt) {
+    Serialization::serialize(stream, exportIt.name);
+    U8 kind = U8(exportIt.kind);
+    Serialization::serialize(stream, kind);
+    exportIt.kind = ExternKind(kind);
+    Serialization::serialize(stream, exportIt.index);
+}
+
+template<typename Stream> static void serialize(Stream &stream, DataSegment &dataSegment, bool loadViews) {
+    serialize(stream, dataSegment.isActive);
+    Serialization::serialize(stream, dataSegment.memoryIndex);
+    serialize(stream, dataSegment.baseOffset);
+    serializeByteArray(stream, dataSegment.data, loadViews);
+}
+
+template<typename Stream> static void serialize(Stream &stream, ElemSegment &elemSegment) {
+    serialize(stream, elemSegment.isActive);
+    Serialization::serialize(stream, elemSegment.tableIndex);
+    serialize(stream, elemSegment.baseOffset);
+    serializeArray(stream, elemSegment.indices, [](Stream &stream, Uptr &index) {
+        Serialization::serialize(stream, index);
+    });
+}
+
+template<typename Stream> static void serialize(Stream &stream, UserSection &userSection, bool loadViews) {
+    Serialization::serialize(stream, userSection.name);
+    serializeByteArray(stream, userSection.data, loadViews);
+}
+
+template<typename Stream, typename Definition, typename Type> static void serialize(Stream &stream, IndexSpace<Definition, Type> &indexSpace) {
+    serializeArray(stream, indexSpace.imports, [](Stream &stream, Import<Type> &import) {
+        serialize(stream, import);
+    });
+    serializeArray(stream, indexSpace.defs, [](Stream &stream, Definition &def) {
+        serialize(stream, def);
+    });
+}
+
+template<typename Stream, typename Element> static void serializeElements(Stream &stream, std::vector<Element> &elements) {
+    serializeArray(stream, elements, [](Stream &stream, Element &element) {
+        serialize(stream, element);
+    });
+}
+
+template<typename Stream> static void serializeModuleImpl(Stream &stream, Module &module) {
+    U32 version = irModuleSerializationVersion;
+    Serialization::serialize(stream, version);
+    if (version != irModuleSerializationVersion) {
+        throw FatalSerializationException("unsupported IR module serialization version");
+    }
+
+    // The feature spec is plain data, so just copy its bytes.
+    serializeNativeValue(stream, module.featureSpec);
+
+    // The byte arrays of a module with a backing buffer are views of the input, which is read from
+    // that buffer.
+    const bool loadViews = Stream::isInput && module.backingBuffer;
+
+    serializeElements(stream, module.types);
+    serializeArray(stream, module.functions.imports, [](Stream &stream, FunctionImport &import) {
+        serialize(stream, import);
+    });
+    serializeArray(stream, module.functions.defs, [loadViews](Stream &stream, FunctionDef &functionDef) {
+        serialize(stream, functionDef, loadViews);
+    });
+    serialize(stream, module.tables);
+    serialize(stream, module.memories);
+    serialize(stream, module.globals);
+    serialize(stream, module.exceptionTypes);
+    serializeElements(stream, module.exports);
+    serializeArray(stream, module.dataSegments, [loadViews](Stream &stream, DataSegment &dataSegment) {
+        serialize(stream, dataSegment, loadViews);
+    });
+    serializeElements(stream, module.elemSegments);
+    serializeArray(stream, module.userSections, [loadViews](Stream &stream, UserSection &userSection) {
+        serialize(stream, userSection, loadViews);
+    });
+    Serialization::serialize(stream, module.startFunctionIndex);
+}
+
+void IR::serializeModule(OutputStream &stream, const Module &module) {
+    serializeModuleImpl(stream, const_cast<Module &>(module));
+}
+
+void IR::deserializeModule(InputStream &stream, Module &outModule) {
+    serializeModuleImpl(stream, outModule);
+}
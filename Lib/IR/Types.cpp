@@ -64,6 +64,48 @@ IR::TypeTuple::TypeTuple(const ValueType *inElems, Uptr numElems) {
     impl = getUniqueImpl(numElems, inElems);
 }
 
+// The interned type tuples and function types are each stored in a set that is split into shards by
+// hash, each with its own lock, so threads that intern different types rarely contend. Each thread
+// also caches the types it has interned, so interning a type the thread has seen before doesn't
+// touch the shared sets at all. Interned types are never freed, so cached types stay valid.
+static constexpr Uptr numInternSetShardsLog2 = 4;
+
+template<typename Key, typename HashPolicy> struct InternSet {
+    struct Shard {
+        Platform::RWMutex mutex;
+        HashSet<Key, HashPolicy> keys;
+    };
+
+    Shard shards[Uptr(1) << numInternSetShardsLog2];
+
+    // Returns the interned key equal to localKey, calling createGlobalKey to create it if it isn't
+    // interned yet.
+    template<typename CreateGlobalKey> Key getOrAdd(Key localKey, CreateGlobalKey &&createGlobalKey) {
+        // Select the shard with the hash's high bits: the shard's HashSet uses its low bits.
+        const Uptr hash = HashPolicy::getKeyHash(localKey);
+        Shard &shard = shards[hash >> (sizeof(Uptr) * 8 - numInternSetShardsLog2)];
+
+        // Almost all keys are already in the set, so look them up with a shared lock.
+        {
+            SharedLock<Platform::RWMutex> shardLock(shard.mutex);
+            const Key *key = shard.keys.get(localKey);
+            if (key) {
+                return *key;
+            }
+        }
+
+        // Another thread may have added the key before the exclusive lock was acquired.
+        Lock<Platform::RWMutex> shardLock(shard.mutex);
+        const Key *key = shard.keys.get(localKey);
+        if (key) {
+            return *key;
+        }
+        const Key globalKey = createGlobalKey();
+        shard.keys.addOrFail(globalKey);
+        return globalKey;
+    }
+};
+
 const TypeTuple::Impl *IR::TypeTuple::getUniqueImpl(Uptr numElems, const ValueType *inElems) {
     if (numElems == 0) {
         static Impl emptyImpl(0, nullptr);
@@ -72,19 +114,18 @@ const TypeTuple::Impl *IR::TypeTuple::getUniqueImpl(Uptr numElems, const ValueTy
         const Uptr numImplBytes = Impl::calcNumBytes(numElems);
         Impl *localImpl = new(alloca(numImplBytes)) Impl(numElems, inElems);
 
-        static Platform::Mutex uniqueTypeTupleSetMutex;
-        static HashSet<TypeTuple, TypeTupleHashPolicy> uniqueTypeTupleSet;
-
-        Lock<Platform::Mutex> uniqueTypeTupleSetLock(uniqueTypeTupleSetMutex);
-
-        const TypeTuple *typeTuple = uniqueTypeTupleSet.get(TypeTuple(localImpl));
-        if (typeTuple) {
-            return typeTuple->impl;
-        } else {
-            Impl *globalImpl = new(malloc(numImplBytes)) Impl(*localImpl);
-            uniqueTypeTupleSet.addOrFail(TypeTuple(globalImpl));
-            return globalImpl;
+        static thread_local HashSet<TypeTuple, TypeTupleHashPolicy> threadTypeTupleCache;
+        const TypeTuple *cachedTypeTuple = threadTypeTupleCache.get(TypeTuple(localImpl));
+        if (cachedTypeTuple) {
+            return cachedTypeTuple->impl;
         }
+
+        static InternSet<TypeTuple, TypeTupleHashPolicy> uniqueTypeTupleSet;
+        const TypeTuple typeTuple = uniqueTypeTupleSet.getOrAdd(TypeTuple(localImpl), [localImpl, numImplBytes] {
+            return TypeTuple(new(malloc(numImplBytes)) Impl(*localImpl));
+        });
+        threadTypeTupleCache.addOrFail(typeTuple);
+        return typeTuple.impl;
     }
 }
 
@@ -99,18 +140,17 @@ const FunctionType::Impl *IR::FunctionType::getUniqueImpl(TypeTuple results, Typ
     } else {
         Impl localImpl(results, params);
 
-        static Platform::Mutex uniqueFunctionTypeSetMutex;
-        static HashSet<FunctionType, FunctionTypeHashPolicy> uniqueFunctionTypeSet;
-
-        Lock<Platform::Mutex> uniqueFunctionTypeSetLock(uniqueFunctionTypeSetMutex);
-
-        const FunctionType *functionType = uniqueFunctionTypeSet.get(FunctionType(&localImpl));
-        if (functionType) {
-            return functionType->impl;
-        } else {
-            Impl *globalImpl = new Impl(localImpl);
-            uniqueFunctionTypeSet.addOrFail(FunctionType(globalImpl));
-            return globalImpl;
+        static thread_local HashSet<FunctionType, FunctionTypeHashPolicy> threadFunctionTypeCache;
+        const FunctionType *cachedFunctionType = threadFunctionTypeCache.get(FunctionType(&localImpl));
+        if (cachedFunctionType) {
+            return cachedFunctionType->impl;
         }
+
+        static InternSet<FunctionType, FunctionTypeHashPolicy> uniqueFunctionTypeSet;
+        const FunctionType functionType = uniqueFunctionTypeSet.getOrAdd(FunctionType(&localImpl), [&localImpl] {
+            return FunctionType(new Impl(localImpl));
+        });
+        threadFunctionTypeCache.addOrFail(functionType);
+        return functionType.impl;
     }
 }
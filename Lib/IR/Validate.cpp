@@ -6,6 +6,7 @@
 #include "WAVM/IR/OperatorPrinter.h"
 #include "iostream"
 #include "WAVM/Inline/HashSet.h"
+#include "WAVM/Inline/ParallelFor.h"
 
 #define ENABLE_LOGGING 0
 
@@ -928,3 +929,56 @@ void IR::CodeValidationStream::finish() {
 ENUM_OPERATORS(VISIT_OPCODE)
 
 #undef VISIT_OPCODE
+
+// Adapts a CodeValidationStream to the visitor interface that OperatorDecoderStream expects.
+struct DecodedCodeValidationVisitor {
+    typedef void Result;
+
+    CodeValidationStream &codeValidationStream;
+
+    DecodedCodeValidationVisitor(CodeValidationStream &inCodeValidationStream)
+            : codeValidationStream(inCodeValidationStream) {
+    }
+
+#define VISIT_OPCODE(_, name, nameString, Imm, ...)                                                \
+    void name(Imm imm) { codeValidationStream.name(imm); }
+
+    ENUM_OPERATORS(VISIT_OPCODE)
+
+#undef VISIT_OPCODE
+
+    void unknown(Opcode opcode) {
+        throw ValidationException("unknown opcode");
+    }
+};
+
+// A thread is only started to validate function definitions if it has at least this many bytes of
+// code to validate.
+static constexpr Uptr minValidationCodeBytesPerThread = 64 * 1024;
+
+void IR::validateFunctionDefs(const Module &module, DeferredCodeValidationState &deferredCodeValidationState) {
+    Uptr numCodeBytes = 0;
+    for (const FunctionDef &functionDef : module.functions.defs) {
+        numCodeBytes += functionDef.code.size();
+    }
+
+    // The function definitions are validated independently, each thread with its own deferred
+    // validation state, which are merged when all threads are done.
+    const Uptr numThreads = getNumParallelThreads(numCodeBytes, minValidationCodeBytesPerThread);
+    std::vector<DeferredCodeValidationState> threadDeferredCodeValidationStates(numThreads);
+    parallelFor(module.functions.defs.size(), numThreads, [&](Uptr threadIndex, Uptr functionDefIndex) {
+        const FunctionDef &functionDef = module.functions.defs[functionDefIndex];
+        CodeValidationStream codeValidationStream(module, functionDef, threadDeferredCodeValidationStates[threadIndex]);
+        DecodedCodeValidationVisitor visitor(codeValidationStream);
+        OperatorDecoderStream decoder(functionDef.code.data(), functionDef.code.size());
+        while (decoder) {
+            decoder.decodeOp(visitor);
+        };
+        codeValidationStream.finish();
+    });
+
+    for (const DeferredCodeValidationState &threadDeferredCodeValidationState :
+            threadDeferredCodeValidationStates) {
+        mergeDeferredCodeValidationState(deferredCodeValidationState, threadDeferredCodeValidationState);
+    }
+}
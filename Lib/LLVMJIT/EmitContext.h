@@ -23,9 +23,18 @@ namespace WAVM {
             llvm::Value *contextPointerVariable;
             llvm::Value *memoryBasePointerVariable;
 
-            EmitContext(LLVMContext &inLLVMContext, llvm::Constant *inDefaultMemoryOffset)
+            // If non-null, holds the number of bytes reserved for the default memory, which memory
+            // addresses are clamped to.
+            llvm::Value *memoryNumReservedBytesVariable;
+
+            // If non-null, the TBAA access tag that loadRuntimeData and storeRuntimeData attach to
+            // their accesses.
+            llvm::MDNode *runtimeDataTBAATag;
+
+            EmitContext(LLVMContext &inLLVMContext, llvm::Constant *inDefaultMemoryOffset, bool inExplicitMemoryBoundsChecks = false)
                     : llvmContext(inLLVMContext), irBuilder(inLLVMContext), contextPointerVariable(nullptr),
-                      memoryBasePointerVariable(nullptr), defaultMemoryOffset(inDefaultMemoryOffset) {
+                      memoryBasePointerVariable(nullptr), memoryNumReservedBytesVariable(nullptr), runtimeDataTBAATag(nullptr),
+                      defaultMemoryOffset(inDefaultMemoryOffset), explicitMemoryBoundsChecks(inExplicitMemoryBoundsChecks) {
             }
 
             llvm::Value *loadFromUntypedPointer(llvm::Value *pointer, llvm::Type *valueType, U32 alignment = 1) {
@@ -39,6 +48,25 @@ namespace WAVM {
                 store->setAlignment(alignment);
             }
 
+            // Loads and stores of the compartment and context runtime data, and of other data owned
+            // by the runtime, which can't alias linear memory.
+            llvm::LoadInst *loadRuntimeData(llvm::Value *pointer, llvm::Type *valueType, U32 alignment = 1) {
+                auto load = irBuilder.CreateLoad(irBuilder.CreatePointerCast(pointer, valueType->getPointerTo()));
+                load->setAlignment(alignment);
+                if (runtimeDataTBAATag) {
+                    load->setMetadata(llvm::LLVMContext::MD_tbaa, runtimeDataTBAATag);
+                }
+                return load;
+            }
+
+            void storeRuntimeData(llvm::Value *value, llvm::Value *pointer, U32 alignment = 1) {
+                auto store = irBuilder.CreateStore(value, irBuilder.CreatePointerCast(pointer, value->getType()->getPointerTo()));
+                store->setAlignment(alignment);
+                if (runtimeDataTBAATag) {
+                    store->setMetadata(llvm::LLVMContext::MD_tbaa, runtimeDataTBAATag);
+                }
+            }
+
             llvm::Value *getCompartmentAddress() {
                 // Derive the compartment runtime data from the context address by masking off the lower
                 // 32 bits.
@@ -46,22 +74,38 @@ namespace WAVM {
                         (U64(1) << 32) - 1))), llvmContext.i8PtrType);
             }
 
-            void reloadMemoryBase() {
+            // Loads the default memory's base address and reserved size from the runtime data for this
+            // module instance. A memory's reservation never moves or changes size after it is added
+            // to its compartment, and a call can't switch to a context in another compartment, so
+            // this is only done once per function: the loaded values stay valid across calls,
+            // including calls that grow the memory.
+            void loadMemoryBase() {
                 llvm::Value *compartmentAddress = getCompartmentAddress();
 
-                // Load the defaultMemoryBase and defaultTableBase values from the runtime data for this
-                // module instance.
-
                 if (defaultMemoryOffset) {
-                    irBuilder.CreateStore(loadFromUntypedPointer(irBuilder.CreateInBoundsGEP(compartmentAddress, {defaultMemoryOffset}), llvmContext.i8PtrType, sizeof(U8 *)), memoryBasePointerVariable);
+                    llvm::MDNode *invariantLoadMetadata = llvm::MDNode::get(llvmContext, {});
+                    llvm::LoadInst *memoryBase = loadRuntimeData(irBuilder.CreateInBoundsGEP(compartmentAddress, {defaultMemoryOffset}), llvmContext.i8PtrType, sizeof(U8 *));
+                    memoryBase->setMetadata(llvm::LLVMContext::MD_invariant_load, invariantLoadMetadata);
+                    irBuilder.CreateStore(memoryBase, memoryBasePointerVariable);
+
+                    // The memory's reserved bytes follow the memory bases in CompartmentRuntimeData.
+                    if (memoryNumReservedBytesVariable) {
+                        llvm::Constant *numReservedBytesOffset = llvm::ConstantExpr::getAdd(defaultMemoryOffset, emitLiteral(llvmContext, Uptr(Runtime::maxMemories * sizeof(void *))));
+                        llvm::LoadInst *numReservedBytes = loadRuntimeData(irBuilder.CreateInBoundsGEP(compartmentAddress, {numReservedBytesOffset}), llvmContext.i64Type, sizeof(Uptr));
+                        numReservedBytes->setMetadata(llvm::LLVMContext::MD_invariant_load, invariantLoadMetadata);
+                        irBuilder.CreateStore(numReservedBytes, memoryNumReservedBytesVariable);
+                    }
                 }
             }
 
             void initContextVariables(llvm::Value *initialContextPointer) {
                 memoryBasePointerVariable = irBuilder.CreateAlloca(llvmContext.i8PtrType, nullptr, "memoryBase");
+                if (explicitMemoryBoundsChecks) {
+                    memoryNumReservedBytesVariable = irBuilder.CreateAlloca(llvmContext.i64Type, nullptr, "memoryNumReservedBytes");
+                }
                 contextPointerVariable = irBuilder.CreateAlloca(llvmContext.i8PtrType, nullptr, "context");
                 irBuilder.CreateStore(initialContextPointer, contextPointerVariable);
-                reloadMemoryBase();
+                loadMemoryBase();
             }
 
             // Creates either a call or an invoke if the call occurs inside a try.
@@ -99,9 +143,6 @@ namespace WAVM {
                         auto newContextPointer = irBuilder.CreateExtractValue(returnValue, {0});
                         irBuilder.CreateStore(newContextPointer, contextPointerVariable);
 
-                        // Reload the memory/table base pointers.
-                        reloadMemoryBase();
-
                         if (areResultsReturnedDirectly(calleeType.results())) {
                             // If the results are returned directly, extract them from the returned struct.
                             for (Uptr resultIndex = 0; resultIndex < calleeType.results().size(); ++resultIndex) {
@@ -130,9 +171,6 @@ namespace WAVM {
                         // Update the context variable.
                         irBuilder.CreateStore(newContextPointer, contextPointerVariable);
 
-                        // Reload the memory/table base pointers.
-                        reloadMemoryBase();
-
                         // Load the call result from the returned context.
                         wavmAssert(calleeType.results().size() <= 1);
                         if (calleeType.results().size() == 1) {
@@ -189,6 +227,7 @@ namespace WAVM {
 
         private:
             llvm::Constant *defaultMemoryOffset;
+            bool explicitMemoryBoundsChecks;
         };
     }
 }
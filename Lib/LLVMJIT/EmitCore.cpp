@@ -66,6 +66,12 @@ void EmitFunctionContext::loop(ControlStructureImm imm) {
 
     // Push the loop argument PHIs on the stack.
     pushMultiple((llvm::Value **) parameterPHIs.data(), parameterPHIs.size());
+
+    // Every back-edge branches to the loop body, so checking for interrupts at its start bounds the
+    // time between checks.
+    if (moduleContext.enableInterruptChecks) {
+        emitInterruptCheck();
+    }
 }
 
 void EmitFunctionContext::if_(ControlStructureImm imm) {
@@ -79,7 +85,7 @@ void EmitFunctionContext::if_(ControlStructureImm imm) {
 
     // Pop the if condition from the operand stack.
     auto condition = pop();
-    irBuilder.CreateCondBr(coerceI32ToBool(condition), thenBlock, elseBlock);
+    emitProfiledCondBr(coerceI32ToBool(condition), thenBlock, elseBlock);
 
     // Pop the arguments from the operand stack.
     ValueVector args;
@@ -195,7 +201,7 @@ void EmitFunctionContext::br_if(BranchImm imm) {
     auto falseBlock = llvm::BasicBlock::Create(llvmContext, "br_ifElse", function);
 
     // Emit a conditional branch to either the falseBlock or the target block.
-    irBuilder.CreateCondBr(coerceI32ToBool(condition), target.block, falseBlock);
+    emitProfiledCondBr(coerceI32ToBool(condition), target.block, falseBlock);
 
     // Resume emitting instructions in the falseBlock.
     irBuilder.SetInsertPoint(falseBlock);
@@ -331,7 +337,7 @@ void EmitFunctionContext::call_indirect(CallIndirectImm imm) {
     // Zero extend the function index to the pointer size.
     auto functionIndexZExt = zext(tableElementIndex, llvmContext.iptrType);
 
-    auto tableBasePointer = loadFromUntypedPointer(irBuilder.CreateInBoundsGEP(getCompartmentAddress(), {moduleContext.tableOffsets[imm.tableIndex]}), llvmContext.iptrType->getPointerTo(), sizeof(Uptr));
+    auto tableBasePointer = loadRuntimeData(irBuilder.CreateInBoundsGEP(getCompartmentAddress(), {moduleContext.tableOffsets[imm.tableIndex]}), llvmContext.iptrType->getPointerTo(), sizeof(Uptr));
 
     // Load the anyfunc referenced by the table.
     auto elementPointer = irBuilder.CreateInBoundsGEP(tableBasePointer, {functionIndexZExt});
@@ -345,10 +351,86 @@ void EmitFunctionContext::call_indirect(CallIndirectImm imm) {
     // If the function type doesn't match, trap.
     emitConditionalTrapIntrinsic(irBuilder.CreateICmpNE(calleeTypeId, elementTypeId), "callIndirectFail", FunctionType(TypeTuple(), TypeTuple({ValueType::i32, inferValueType<Uptr>(), ValueType::anyfunc, inferValueType<Uptr>()})), {tableElementIndex, getTableIdFromOffset(llvmContext, moduleContext.tableOffsets[imm.tableIndex]), irBuilder.CreatePointerCast(runtimeFunction, llvmContext.anyrefType), calleeTypeId});
 
+    // Record the callee in the call_indirect's profile counters.
+    const Uptr callIndirectIndex = numCallIndirects++;
+    if (callIndirectCountersPlaceholder) {
+        llvm::Constant *targetCounters = llvm::ConstantExpr::getInBoundsGetElementPtr(llvmContext.i64Type, callIndirectCountersPlaceholder, emitLiteral(llvmContext, Uptr(callIndirectIndex * numCallIndirectProfileCounters)));
+        emitRuntimeIntrinsic("profileCallIndirect", FunctionType(TypeTuple(), TypeTuple({inferValueType<Uptr>(), ValueType::anyfunc})), {llvm::ConstantExpr::getPtrToInt(targetCounters, llvmContext.iptrType), irBuilder.CreatePointerCast(runtimeFunction, llvmContext.anyrefType)});
+    }
+
+    // If the module's elem segments only reference one function of the callee type, check whether
+    // the table element is that function, and if so, call it directly so LLVM may inline it. A
+    // function definition's Runtime::Function immediately precedes its code.
+    Uptr speculativeTargetIndex = moduleContext.speculativeCallIndirectTargets[imm.type.index];
+    llvm::MDNode *speculationBranchWeights = moduleContext.likelyTrueBranchWeights;
+
+    // If the module was compiled with a profile that shows most of the call_indirect's calls went
+    // to one function definition of the callee type, speculate that it calls that function instead.
+    // Otherwise, weight the speculation by how often the profiled calls went to its target.
+    if (functionProfile && callIndirectIndex < functionProfile->callIndirects.size()) {
+        const CallIndirectProfile &callIndirectProfile = functionProfile->callIndirects[callIndirectIndex];
+        U64 numCalls = callIndirectProfile.numOtherCalls;
+        const CallIndirectTargetProfile *hottestTarget = nullptr;
+        for (const CallIndirectTargetProfile &target : callIndirectProfile.targets) {
+            numCalls += target.numCalls;
+            if (target.functionDefIndex < irModule.functions.defs.size() &&
+                irModule.types[irModule.functions.defs[target.functionDefIndex].type.index] == calleeType &&
+                (!hottestTarget || target.numCalls > hottestTarget->numCalls)) {
+                hottestTarget = &target;
+            }
+        }
+
+        if (hottestTarget && hottestTarget->numCalls * 2 > numCalls) {
+            speculativeTargetIndex = irModule.functions.imports.size() + hottestTarget->functionDefIndex;
+            speculationBranchWeights = createProfileBranchWeights(llvmContext, hottestTarget->numCalls, numCalls - hottestTarget->numCalls);
+        } else if (numCalls && speculativeTargetIndex != UINTPTR_MAX) {
+            U64 numSpeculativeTargetCalls = 0;
+            for (const CallIndirectTargetProfile &target : callIndirectProfile.targets) {
+                if (irModule.functions.imports.size() + target.functionDefIndex == speculativeTargetIndex) {
+                    numSpeculativeTargetCalls = target.numCalls;
+                }
+            }
+            speculationBranchWeights = createProfileBranchWeights(llvmContext, numSpeculativeTargetCalls, numCalls - numSpeculativeTargetCalls);
+        }
+    }
+    llvm::BasicBlock *indirectCallBlock = nullptr;
+    llvm::BasicBlock *directCallEndBlock = nullptr;
+    llvm::BasicBlock *endBlock = nullptr;
+    ValueVector directCallResults;
+    if (speculativeTargetIndex != UINTPTR_MAX) {
+        llvm::Function *speculativeTarget = moduleContext.functions[speculativeTargetIndex];
+        llvm::Constant *speculativeRuntimeFunction = llvm::ConstantExpr::getSub(llvm::ConstantExpr::getPtrToInt(speculativeTarget, llvmContext.iptrType), emitLiteral(llvmContext, Uptr(offsetof(Runtime::Function, code))));
+
+        llvm::BasicBlock *directCallBlock = llvm::BasicBlock::Create(llvmContext, "callIndirectDirect", function);
+        indirectCallBlock = llvm::BasicBlock::Create(llvmContext, "callIndirectIndirect", function);
+        endBlock = llvm::BasicBlock::Create(llvmContext, "callIndirectEnd", function);
+        irBuilder.CreateCondBr(irBuilder.CreateICmpEQ(irBuilder.CreatePtrToInt(runtimeFunction, llvmContext.iptrType), speculativeRuntimeFunction), directCallBlock, indirectCallBlock, speculationBranchWeights);
+
+        irBuilder.SetInsertPoint(directCallBlock);
+        directCallResults = emitCallOrInvoke(speculativeTarget, llvm::ArrayRef<llvm::Value *>(llvmArgs, numArguments), calleeType, CallingConvention::wasm, getInnermostUnwindToBlock());
+        directCallEndBlock = irBuilder.GetInsertBlock();
+        irBuilder.CreateBr(endBlock);
+
+        irBuilder.SetInsertPoint(indirectCallBlock);
+    }
+
     // Call the function loaded from the table.
     auto functionPointer = irBuilder.CreatePointerCast(irBuilder.CreateInBoundsGEP(runtimeFunction, emitLiteral(llvmContext, Uptr(offsetof(Runtime::Function, code)))), asLLVMType(llvmContext, calleeType, CallingConvention::wasm)->getPointerTo());
     ValueVector results = emitCallOrInvoke(functionPointer, llvm::ArrayRef<llvm::Value *>(llvmArgs, numArguments), calleeType, CallingConvention::wasm, getInnermostUnwindToBlock());
 
+    // Merge the results of the direct and indirect calls.
+    if (endBlock) {
+        llvm::BasicBlock *indirectCallEndBlock = irBuilder.GetInsertBlock();
+        irBuilder.CreateBr(endBlock);
+        irBuilder.SetInsertPoint(endBlock);
+        for (Uptr resultIndex = 0; resultIndex < results.size(); ++resultIndex) {
+            llvm::PHINode *resultPHI = irBuilder.CreatePHI(results[resultIndex]->getType(), 2);
+            resultPHI->addIncoming(directCallResults[resultIndex], directCallEndBlock);
+            resultPHI->addIncoming(results[resultIndex], indirectCallEndBlock);
+            results[resultIndex] = resultPHI;
+        }
+    }
+
     // Push the results on the operand stack.
     for (llvm::Value *result : results) {
         push(result);
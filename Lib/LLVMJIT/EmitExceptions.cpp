@@ -1,4 +1,5 @@
 #include <stddef.h>
+#include <algorithm>
 #include <memory>
 #include <vector>
 
@@ -13,9 +14,46 @@ using namespace WAVM::IR;
 using namespace WAVM::LLVMJIT;
 using namespace WAVM::Runtime;
 
+void EmitFunctionContext::emitThrowToInnermostHandler(llvm::Value *exceptionTypeId, llvm::Value *exceptionPointer, llvm::Value *isLocalException) {
+    if (tryStack.size()) {
+        // If the exception is thrown inside a try in this function, branch directly to its catch
+        // clauses.
+        TryContext &tryContext = tryStack.back();
+        llvm::BasicBlock *throwBlock = irBuilder.GetInsertBlock();
+        tryContext.exceptionTypeIdPHI->addIncoming(exceptionTypeId, throwBlock);
+        tryContext.exceptionPointerPHI->addIncoming(exceptionPointer, throwBlock);
+        tryContext.isLocalExceptionPHI->addIncoming(isLocalException, throwBlock);
+        irBuilder.CreateBr(tryContext.catchDispatchBlock);
+        return;
+    }
+
+    // Otherwise, the exception leaves the function, so it must be thrown as a C++ exception. An
+    // exception that was caught from a C++ exception is just rethrown, but an exception thrown in
+    // this function is copied from the stack into a new C++ exception.
+    auto throwLocalExceptionBlock = llvm::BasicBlock::Create(llvmContext, "throwLocalException", function);
+    auto rethrowExceptionBlock = llvm::BasicBlock::Create(llvmContext, "rethrowException", function);
+    irBuilder.CreateCondBr(isLocalException, throwLocalExceptionBlock, rethrowExceptionBlock);
+
+    irBuilder.SetInsertPoint(throwLocalExceptionBlock);
+    auto argumentsPointer = irBuilder.CreateInBoundsGEP(exceptionPointer, {emitLiteral(llvmContext, Uptr(offsetof(ExceptionData, arguments)))});
+    emitRuntimeIntrinsic("throwException", FunctionType(TypeTuple{}, TypeTuple{inferValueType<Iptr>(), inferValueType<Iptr>(), ValueType::i32}), {exceptionTypeId, irBuilder.CreatePtrToInt(argumentsPointer, llvmContext.iptrType), emitLiteral(llvmContext, I32(1))});
+    irBuilder.CreateUnreachable();
+
+    irBuilder.SetInsertPoint(rethrowExceptionBlock);
+    emitRuntimeIntrinsic("rethrowException", FunctionType(TypeTuple{}, TypeTuple{inferValueType<Iptr>()}), {irBuilder.CreatePtrToInt(exceptionPointer, llvmContext.iptrType)});
+    irBuilder.CreateUnreachable();
+}
+
 void EmitFunctionContext::endTry() {
     wavmAssert(tryStack.size());
+    wavmAssert(catchStack.size());
     tryStack.pop_back();
+
+    // A try without any catch clauses passes all exceptions on to the enclosing handler.
+    CatchContext &catchContext = catchStack.back();
+    irBuilder.SetInsertPoint(catchContext.nextHandlerBlock);
+    emitThrowToInnermostHandler(catchContext.exceptionTypeId, catchContext.exceptionPointer, catchContext.isLocalException);
+
     catchStack.pop_back();
 }
 
@@ -23,11 +61,9 @@ void EmitFunctionContext::endCatch() {
     wavmAssert(catchStack.size());
     CatchContext &catchContext = catchStack.back();
 
+    // Pass exceptions that didn't match any of the catch clauses on to the enclosing handler.
     irBuilder.SetInsertPoint(catchContext.nextHandlerBlock);
-
-    emitRuntimeIntrinsic("rethrowException", FunctionType(TypeTuple{}, TypeTuple{inferValueType<Iptr>()}), {irBuilder.CreatePtrToInt(catchContext.exceptionPointer, llvmContext.iptrType)});
-
-    irBuilder.CreateUnreachable();
+    emitThrowToInnermostHandler(catchContext.exceptionTypeId, catchContext.exceptionPointer, catchContext.isLocalException);
 
     catchStack.pop_back();
 }
@@ -44,15 +80,28 @@ void EmitFunctionContext::try_(ControlStructureImm imm) {
     FunctionType blockType = resolveBlockType(irModule, imm.type);
 
     auto landingPadBlock = llvm::BasicBlock::Create(llvmContext, "landingPad", function);
+    auto catchDispatchBlock = llvm::BasicBlock::Create(llvmContext, "catchDispatch", function);
     auto originalInsertBlock = irBuilder.GetInsertBlock();
+
+    // The catch clauses dispatch on the type ID and data of an exception that either unwound to the
+    // landing pad, or was thrown in this function and branched directly to the dispatch block.
+    irBuilder.SetInsertPoint(catchDispatchBlock);
+    auto exceptionTypeIdPHI = irBuilder.CreatePHI(llvmContext.iptrType, 2);
+    auto exceptionPointerPHI = irBuilder.CreatePHI(llvmContext.i8PtrType, 2);
+    auto isLocalExceptionPHI = irBuilder.CreatePHI(irBuilder.getInt1Ty(), 2);
+
     irBuilder.SetInsertPoint(landingPadBlock);
     auto landingPadInst = irBuilder.CreateLandingPad(llvm::StructType::get(llvmContext, {llvmContext.i8PtrType, llvmContext.i32Type}), 1);
     auto exceptionPointer = loadFromUntypedPointer(irBuilder.CreateCall(moduleContext.cxaBeginCatchFunction, {irBuilder.CreateExtractValue(landingPadInst, {0})}), llvmContext.i8Type->getPointerTo());
     auto exceptionTypeId = loadFromUntypedPointer(irBuilder.CreateInBoundsGEP(exceptionPointer, {emitLiteral(llvmContext, Uptr(offsetof(ExceptionData, typeId)))}), llvmContext.iptrType);
+    exceptionTypeIdPHI->addIncoming(exceptionTypeId, irBuilder.GetInsertBlock());
+    exceptionPointerPHI->addIncoming(exceptionPointer, irBuilder.GetInsertBlock());
+    isLocalExceptionPHI->addIncoming(irBuilder.getFalse(), irBuilder.GetInsertBlock());
+    irBuilder.CreateBr(catchDispatchBlock);
 
     irBuilder.SetInsertPoint(originalInsertBlock);
-    tryStack.push_back(TryContext{landingPadBlock});
-    catchStack.push_back(CatchContext{nullptr, landingPadInst, landingPadBlock, exceptionTypeId, exceptionPointer});
+    tryStack.push_back(TryContext{landingPadBlock, catchDispatchBlock, exceptionTypeIdPHI, exceptionPointerPHI, isLocalExceptionPHI});
+    catchStack.push_back(CatchContext{nullptr, landingPadInst, catchDispatchBlock, exceptionTypeIdPHI, exceptionPointerPHI, isLocalExceptionPHI});
 
     // Add the platform exception type to the landing pad's type filter.
     landingPadInst->addClause(moduleContext.userExceptionTypeInfo);
@@ -206,34 +255,33 @@ void EmitFunctionContext::catch_all(NoImm) {
 void EmitFunctionContext::throw_(ExceptionTypeImm imm) {
     const IR::ExceptionType &exceptionType = irModule.exceptionTypes.getType(imm.exceptionTypeIndex);
 
+    // Build the exception's ExceptionData in a stack slot for this throw. It is allocated in the
+    // function's entry block, so throwing in a loop doesn't grow the stack. Only one exception
+    // thrown by a given throw can be live at a time, since the catch clauses that receive it can't
+    // execute the throw again without first leaving the clause.
     const Uptr numArgs = exceptionType.params.size();
-    const Uptr numArgBytes = numArgs * sizeof(UntaggedValue);
-    auto argBaseAddress = irBuilder.CreateAlloca(llvmContext.i8Type, emitLiteral(llvmContext, numArgBytes));
-    argBaseAddress->setAlignment(sizeof(UntaggedValue));
-
-    for (Uptr argIndex = 0; argIndex < exceptionType.params.size(); ++argIndex) {
-        auto elementValue = pop();
-        storeToUntypedPointer(elementValue, irBuilder.CreatePointerCast(irBuilder.CreateInBoundsGEP(argBaseAddress, {emitLiteral(llvmContext,
-                                                                                                                                 (numArgs -
-                                                                                                                                  argIndex -
-                                                                                                                                  1) *
-                                                                                                                                 sizeof(UntaggedValue))}), elementValue->getType()->getPointerTo()), sizeof(UntaggedValue));
-    }
+    const Uptr numExceptionDataBytes = offsetof(ExceptionData, arguments) + std::max(numArgs, Uptr(1)) * sizeof(UntaggedValue);
+    llvm::IRBuilder<> entryIRBuilder(entryBlock, entryBlock->begin());
+    auto exceptionPointer = entryIRBuilder.CreateAlloca(llvmContext.i8Type, emitLiteral(llvmContext, numExceptionDataBytes));
+    exceptionPointer->setAlignment(sizeof(UntaggedValue));
 
     llvm::Value *exceptionTypeId = moduleContext.exceptionTypeIds[imm.exceptionTypeIndex];
-    llvm::Value *argsPointerAsInt = irBuilder.CreatePtrToInt(argBaseAddress, llvmContext.iptrType);
+    storeToUntypedPointer(exceptionTypeId, irBuilder.CreatePointerCast(irBuilder.CreateInBoundsGEP(exceptionPointer, {emitLiteral(llvmContext, Uptr(offsetof(ExceptionData, typeId)))}), llvmContext.iptrType->getPointerTo()), sizeof(Uptr));
+    storeToUntypedPointer(llvm::ConstantInt::get(llvmContext.i8Type, 1), irBuilder.CreateInBoundsGEP(exceptionPointer, {emitLiteral(llvmContext, Uptr(offsetof(ExceptionData, isUserException)))}));
 
-    emitRuntimeIntrinsic("throwException", FunctionType(TypeTuple{}, TypeTuple{inferValueType<Iptr>(), inferValueType<Iptr>(), ValueType::i32}), {exceptionTypeId, argsPointerAsInt, emitLiteral(llvmContext, I32(1))});
+    for (Uptr argIndex = 0; argIndex < numArgs; ++argIndex) {
+        auto elementValue = pop();
+        const Uptr argumentOffset = offsetof(ExceptionData, arguments) + sizeof(UntaggedValue) * (numArgs - argIndex - 1);
+        storeToUntypedPointer(elementValue, irBuilder.CreatePointerCast(irBuilder.CreateInBoundsGEP(exceptionPointer, {emitLiteral(llvmContext, argumentOffset)}), elementValue->getType()->getPointerTo()), sizeof(UntaggedValue));
+    }
 
-    irBuilder.CreateUnreachable();
+    emitThrowToInnermostHandler(exceptionTypeId, exceptionPointer, irBuilder.getTrue());
     enterUnreachable();
 }
 
 void EmitFunctionContext::rethrow(RethrowImm imm) {
     wavmAssert(imm.catchDepth < catchStack.size());
     CatchContext &catchContext = catchStack[catchStack.size() - imm.catchDepth - 1];
-    emitRuntimeIntrinsic("rethrowException", FunctionType(TypeTuple{}, TypeTuple{inferValueType<Iptr>()}), {irBuilder.CreatePtrToInt(catchContext.exceptionPointer, llvmContext.iptrType)});
-
-    irBuilder.CreateUnreachable();
+    emitThrowToInnermostHandler(catchContext.exceptionTypeId, catchContext.exceptionPointer, catchContext.isLocalException);
     enterUnreachable();
 }
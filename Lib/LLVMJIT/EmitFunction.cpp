@@ -1,4 +1,5 @@
 #include <stdint.h>
+#include <algorithm>
 #include <initializer_list>
 #include <memory>
 #include <vector>
@@ -8,6 +9,7 @@
 #include "WAVM/IR/OperatorPrinter.h"
 
 PUSH_DISABLE_WARNINGS_FOR_LLVM_HEADERS
+#include "llvm/IR/MDBuilder.h"
 
 POP_DISABLE_WARNINGS_FOR_LLVM_HEADERS
 
@@ -198,6 +200,39 @@ void EmitFunctionContext::enterUnreachable() {
     controlStack.back().isReachable = false;
 }
 
+// A visitor that finds the locals a function's code assigns with set_local or tee_local, so the
+// memory accesses through the locals it never assigns can be bounds checked once per function.
+struct AssignedLocalVisitor {
+    typedef void Result;
+
+    AssignedLocalVisitor(std::vector<bool> &inIsLocalAssigned) : isLocalAssigned(inIsLocalAssigned) {
+    }
+
+#define VISIT_OP(opcode, name, nameString, Imm, ...)                                               \
+    void name(Imm imm) {                                                                           \
+        visit(Opcode::name, imm);                                                                  \
+    }
+
+    ENUM_OPERATORS(VISIT_OP)
+
+#undef VISIT_OP
+
+    void unknown(Opcode) {
+    }
+
+private:
+    std::vector<bool> &isLocalAssigned;
+
+    template<typename Imm> void visit(Opcode, Imm) {
+    }
+
+    void visit(Opcode opcode, GetOrSetVariableImm<false> imm) {
+        if (opcode != Opcode::get_local && imm.variableIndex < isLocalAssigned.size()) {
+            isLocalAssigned[imm.variableIndex] = true;
+        }
+    }
+};
+
 // A do-nothing visitor used to decode past unreachable operators (but supporting logging, and
 // passing the end operator through).
 struct UnreachableOpVisitor {
@@ -266,6 +301,276 @@ private:
     Uptr unreachableControlDepth;
 };
 
+void EmitFunctionContext::emitTierUpPrologue() {
+    // If the function has been recompiled by the tier-up compiler, forward the call to the optimized
+    // code. The tail call reuses this function's arguments and stack frame.
+    llvm::Constant *optimizedCodePointer = llvm::ConstantExpr::getPointerCast(llvm::ConstantExpr::getGetElementPtr(llvmContext.i8Type, functionDefMutableData, emitLiteral(llvmContext, Uptr(offsetof(Runtime::FunctionTierUpState, optimizedCode)))), llvmContext.i8PtrType->getPointerTo());
+    llvm::LoadInst *optimizedCode = irBuilder.CreateLoad(optimizedCodePointer);
+    optimizedCode->setAtomic(llvm::AtomicOrdering::Acquire);
+    optimizedCode->setAlignment(sizeof(void *));
+
+    auto forwardBlock = llvm::BasicBlock::Create(llvmContext, "forwardToOptimizedCode", function);
+    auto countCallBlock = llvm::BasicBlock::Create(llvmContext, "countCall", function);
+    irBuilder.CreateCondBr(irBuilder.CreateICmpNE(optimizedCode, llvm::Constant::getNullValue(llvmContext.i8PtrType)), forwardBlock, countCallBlock, moduleContext.likelyFalseBranchWeights);
+
+    irBuilder.SetInsertPoint(forwardBlock);
+    llvm::SmallVector<llvm::Value *, 8> forwardedArgs;
+    for (llvm::Argument &arg : function->args()) {
+        forwardedArgs.push_back(&arg);
+    }
+    llvm::CallInst *forwardedCall = irBuilder.CreateCall(irBuilder.CreatePointerCast(optimizedCode, function->getType()), forwardedArgs);
+    forwardedCall->setCallingConv(function->getCallingConv());
+    forwardedCall->setTailCallKind(llvm::CallInst::TCK_MustTail);
+    irBuilder.CreateRet(forwardedCall);
+
+    // Otherwise, count the call, and request that the function be recompiled when the count reaches
+    // the threshold. Only the call that increments the count to the threshold makes the request.
+    irBuilder.SetInsertPoint(countCallBlock);
+    llvm::Constant *numCallsPointer = llvm::ConstantExpr::getPointerCast(llvm::ConstantExpr::getGetElementPtr(llvmContext.i8Type, functionDefMutableData, emitLiteral(llvmContext, Uptr(offsetof(Runtime::FunctionTierUpState, numCalls)))), llvmContext.iptrType->getPointerTo());
+    llvm::Value *previousNumCalls = irBuilder.CreateAtomicRMW(llvm::AtomicRMWInst::Add, numCallsPointer, emitLiteral(llvmContext, Uptr(1)), llvm::AtomicOrdering::Monotonic);
+
+    auto tierUpBlock = llvm::BasicBlock::Create(llvmContext, "tierUp", function);
+    auto bodyBlock = llvm::BasicBlock::Create(llvmContext, "body", function);
+    irBuilder.CreateCondBr(irBuilder.CreateICmpEQ(previousNumCalls, emitLiteral(llvmContext, Uptr(moduleContext.tierUpCallThreshold - 1))), tierUpBlock, bodyBlock, moduleContext.likelyFalseBranchWeights);
+
+    irBuilder.SetInsertPoint(tierUpBlock);
+    emitRuntimeIntrinsic("tierUpFunction", FunctionType({}, TypeTuple({inferValueType<Uptr>(), inferValueType<Uptr>()})), {moduleContext.moduleInstanceId, emitLiteral(llvmContext, functionDefIndex)});
+    irBuilder.CreateBr(bodyBlock);
+
+    irBuilder.SetInsertPoint(bodyBlock);
+}
+
+llvm::Constant *EmitFunctionContext::getCallCounterPointer(Uptr counterOffset) {
+    return llvm::ConstantExpr::getPointerCast(llvm::ConstantExpr::getGetElementPtr(llvmContext.i8Type, functionDefMutableData, emitLiteral(llvmContext, Uptr(functionCallCountersOffset + counterOffset))), llvmContext.i64Type->getPointerTo());
+}
+
+void EmitFunctionContext::emitCallCountersPrologue() {
+    // Count the call with a relaxed atomic add, so calls on different threads aren't lost.
+    irBuilder.CreateAtomicRMW(llvm::AtomicRMWInst::Add, getCallCounterPointer(offsetof(Runtime::FunctionCallCounters, numCalls)), emitLiteral(llvmContext, U64(1)), llvm::AtomicOrdering::Monotonic);
+    if (moduleContext.enableCallTiming) {
+        callStartTicks = callLLVMIntrinsic({}, llvm::Intrinsic::readcyclecounter, {});
+    }
+}
+
+void EmitFunctionContext::emitCallCountersEpilogue() {
+    // Only normal returns are timed: a trap or exception that unwinds the function skips this.
+    if (callStartTicks) {
+        llvm::Value *endTicks = callLLVMIntrinsic({}, llvm::Intrinsic::readcyclecounter, {});
+        irBuilder.CreateAtomicRMW(llvm::AtomicRMWInst::Add, getCallCounterPointer(offsetof(Runtime::FunctionCallCounters, inclusiveTicks)), irBuilder.CreateSub(endTicks, callStartTicks), llvm::AtomicOrdering::Monotonic);
+    }
+}
+
+// Creates branch weights from profiled counts, scaled down to fit the 32-bit weights LLVM uses.
+// Returns null if neither destination was taken, so the branch has no profile information.
+llvm::MDNode *LLVMJIT::createProfileBranchWeights(LLVMContext &llvmContext, U64 trueCount, U64 falseCount) {
+    if (!trueCount && !falseCount) {
+        return nullptr;
+    }
+    const U64 scale = std::max(trueCount, falseCount) / UINT32_MAX + 1;
+    return llvm::MDBuilder(llvmContext).createBranchWeights(U32(trueCount / scale), U32(falseCount / scale));
+}
+
+void EmitFunctionContext::emitProfiledCondBr(llvm::Value *booleanCondition, llvm::BasicBlock *trueBlock, llvm::BasicBlock *falseBlock) {
+    const Uptr branchIndex = numBranches++;
+    if (branchCountersPlaceholder) {
+        // Select the taken or not taken counter, so counting the branch doesn't add a branch.
+        llvm::Constant *takenCounter = llvm::ConstantExpr::getInBoundsGetElementPtr(llvmContext.i64Type, branchCountersPlaceholder, emitLiteral(llvmContext, Uptr(branchIndex * 2)));
+        llvm::Constant *notTakenCounter = llvm::ConstantExpr::getInBoundsGetElementPtr(llvmContext.i64Type, branchCountersPlaceholder, emitLiteral(llvmContext, Uptr(branchIndex * 2 + 1)));
+        irBuilder.CreateAtomicRMW(llvm::AtomicRMWInst::Add, irBuilder.CreateSelect(booleanCondition, takenCounter, notTakenCounter), emitLiteral(llvmContext, U64(1)), llvm::AtomicOrdering::Monotonic);
+    }
+
+    llvm::MDNode *branchWeights = nullptr;
+    if (functionProfile && branchIndex < functionProfile->branches.size()) {
+        const BranchProfile &branchProfile = functionProfile->branches[branchIndex];
+        branchWeights = createProfileBranchWeights(llvmContext, branchProfile.numTaken, branchProfile.numNotTaken);
+    }
+    irBuilder.CreateCondBr(booleanCondition, trueBlock, falseBlock, branchWeights);
+}
+
+void EmitFunctionContext::createProfileCounters() {
+    // The counters are a mutable global, so each instance that loads the object code has its own
+    // copy. The loader binds the symbol to the function's FunctionMutableData::profileCounters.
+    const Uptr numCounters = numProfileCountersHeaderElements + numBranches * 2 + numCallIndirects * numCallIndirectProfileCounters;
+    std::vector<llvm::Constant *> initialCounters(numCounters, emitLiteral(llvmContext, U64(0)));
+    initialCounters[0] = emitLiteral(llvmContext, U64(numBranches));
+    initialCounters[1] = emitLiteral(llvmContext, U64(numCallIndirects));
+    llvm::ArrayType *countersType = llvm::ArrayType::get(llvmContext.i64Type, numCounters);
+    llvm::GlobalVariable *counters = new llvm::GlobalVariable(*moduleContext.llvmModule, countersType, false, llvm::GlobalVariable::ExternalLinkage, llvm::ConstantArray::get(countersType, initialCounters), moduleContext.externalNamePrefix + getExternalName("profileCounters", functionDefIndex));
+
+    llvm::Constant *firstCounter = llvm::ConstantExpr::getPointerCast(counters, llvmContext.i64Type->getPointerTo());
+    branchCountersPlaceholder->replaceAllUsesWith(llvm::ConstantExpr::getInBoundsGetElementPtr(llvmContext.i64Type, firstCounter, emitLiteral(llvmContext, Uptr(numProfileCountersHeaderElements))));
+    callIndirectCountersPlaceholder->replaceAllUsesWith(llvm::ConstantExpr::getInBoundsGetElementPtr(llvmContext.i64Type, firstCounter, emitLiteral(llvmContext, Uptr(numProfileCountersHeaderElements + numBranches * 2))));
+    branchCountersPlaceholder->eraseFromParent();
+    callIndirectCountersPlaceholder->eraseFromParent();
+    branchCountersPlaceholder = nullptr;
+    callIndirectCountersPlaceholder = nullptr;
+}
+
+void EmitFunctionContext::emitLazyCompilationStub() {
+    // Load the function's compiled code, and compile it if this is the first call. The
+    // compileLazyFunction intrinsic returns the compiled code, which it also stores in the
+    // FunctionTierUpState, so subsequent calls don't call it.
+    llvm::Constant *compiledCodePointer = llvm::ConstantExpr::getPointerCast(llvm::ConstantExpr::getGetElementPtr(llvmContext.i8Type, functionDefMutableData, emitLiteral(llvmContext, Uptr(offsetof(Runtime::FunctionTierUpState, optimizedCode)))), llvmContext.i8PtrType->getPointerTo());
+    llvm::LoadInst *loadedCode = irBuilder.CreateLoad(compiledCodePointer);
+    loadedCode->setAtomic(llvm::AtomicOrdering::Acquire);
+    loadedCode->setAlignment(sizeof(void *));
+
+    llvm::BasicBlock *loadedBlock = irBuilder.GetInsertBlock();
+    auto compileBlock = llvm::BasicBlock::Create(llvmContext, "compile", function);
+    auto forwardBlock = llvm::BasicBlock::Create(llvmContext, "forwardToCompiledCode", function);
+    irBuilder.CreateCondBr(irBuilder.CreateICmpEQ(loadedCode, llvm::Constant::getNullValue(llvmContext.i8PtrType)), compileBlock, forwardBlock, moduleContext.likelyFalseBranchWeights);
+
+    irBuilder.SetInsertPoint(compileBlock);
+    ValueVector compiledCodeResults = emitRuntimeIntrinsic("compileLazyFunction", FunctionType(TypeTuple({inferValueType<Uptr>()}), TypeTuple({inferValueType<Uptr>(), inferValueType<Uptr>()})), {moduleContext.moduleInstanceId, emitLiteral(llvmContext, functionDefIndex)});
+    llvm::Value *compiledCode = irBuilder.CreateIntToPtr(compiledCodeResults[0], llvmContext.i8PtrType);
+    irBuilder.CreateBr(forwardBlock);
+
+    // Forward the call to the compiled code.
+    irBuilder.SetInsertPoint(forwardBlock);
+    llvm::PHINode *code = irBuilder.CreatePHI(llvmContext.i8PtrType, 2);
+    code->addIncoming(loadedCode, loadedBlock);
+    code->addIncoming(compiledCode, compileBlock);
+    emitForwardToCode(code);
+}
+
+void EmitFunctionContext::emitForwardToCode(llvm::Value *code) {
+    llvm::SmallVector<llvm::Value *, 8> forwardedArgs;
+    for (llvm::Argument &arg : function->args()) {
+        forwardedArgs.push_back(&arg);
+    }
+    llvm::CallInst *forwardedCall = irBuilder.CreateCall(irBuilder.CreatePointerCast(code, function->getType()), forwardedArgs);
+    forwardedCall->setCallingConv(function->getCallingConv());
+    forwardedCall->setTailCallKind(llvm::CallInst::TCK_MustTail);
+    irBuilder.CreateRet(forwardedCall);
+}
+
+void EmitFunctionContext::emitInterpreterStub() {
+    // Load the function's compiled code, and interpret the function if it hasn't been compiled.
+    llvm::Constant *compiledCodePointer = llvm::ConstantExpr::getPointerCast(llvm::ConstantExpr::getGetElementPtr(llvmContext.i8Type, functionDefMutableData, emitLiteral(llvmContext, Uptr(offsetof(Runtime::FunctionTierUpState, optimizedCode)))), llvmContext.i8PtrType->getPointerTo());
+    llvm::LoadInst *loadedCode = irBuilder.CreateLoad(compiledCodePointer);
+    loadedCode->setAtomic(llvm::AtomicOrdering::Acquire);
+    loadedCode->setAlignment(sizeof(void *));
+
+    llvm::BasicBlock *loadedBlock = irBuilder.GetInsertBlock();
+    auto interpretBlock = llvm::BasicBlock::Create(llvmContext, "interpret", function);
+    auto returnBlock = llvm::BasicBlock::Create(llvmContext, "returnInterpretedResults", function);
+    auto forwardBlock = llvm::BasicBlock::Create(llvmContext, "forwardToCompiledCode", function);
+    irBuilder.CreateCondBr(irBuilder.CreateICmpEQ(loadedCode, llvm::Constant::getNullValue(llvmContext.i8PtrType)), interpretBlock, forwardBlock);
+
+    // Pass the arguments to the interpreter in the context's thunk argument buffer, laid out the
+    // same way as the arguments of an invoke thunk.
+    irBuilder.SetInsertPoint(interpretBlock);
+    llvm::Value *contextPointer = irBuilder.CreateLoad(contextPointerVariable);
+    Uptr argDataOffset = 0;
+    auto llvmArgIt = function->arg_begin() + 1;
+    for (ValueType parameterType : functionType.params()) {
+        const U32 numArgBytes = getTypeByteWidth(parameterType);
+        argDataOffset = (argDataOffset + numArgBytes - 1) & -numArgBytes;
+        storeToUntypedPointer(&*llvmArgIt++, irBuilder.CreateInBoundsGEP(contextPointer, {emitLiteral(llvmContext, argDataOffset + offsetof(Runtime::ContextRuntimeData, thunkArgAndReturnData))}), numArgBytes);
+        argDataOffset += numArgBytes;
+    }
+
+    // The interpretFunction intrinsic returns null after interpreting the function, or the
+    // function's compiled code if the interpreter doesn't support it.
+    ValueVector compiledCodeResults = emitRuntimeIntrinsic("interpretFunction", FunctionType(TypeTuple({inferValueType<Uptr>()}), TypeTuple({inferValueType<Uptr>(), inferValueType<Uptr>()})), {moduleContext.moduleInstanceId, emitLiteral(llvmContext, functionDefIndex)});
+    llvm::Value *compiledCode = irBuilder.CreateIntToPtr(compiledCodeResults[0], llvmContext.i8PtrType);
+    llvm::BasicBlock *interpretEndBlock = irBuilder.GetInsertBlock();
+    irBuilder.CreateCondBr(irBuilder.CreateICmpEQ(compiledCode, llvm::Constant::getNullValue(llvmContext.i8PtrType)), returnBlock, forwardBlock, moduleContext.likelyTrueBranchWeights);
+
+    // Return the results that the interpreter wrote to the thunk argument buffer.
+    irBuilder.SetInsertPoint(returnBlock);
+    contextPointer = irBuilder.CreateLoad(contextPointerVariable);
+    ValueVector results;
+    Uptr resultOffset = 0;
+    for (ValueType resultType : functionType.results()) {
+        const U32 numResultBytes = getTypeByteWidth(resultType);
+        resultOffset = (resultOffset + numResultBytes - 1) & -numResultBytes;
+        results.push_back(loadFromUntypedPointer(irBuilder.CreateInBoundsGEP(contextPointer, {emitLiteral(llvmContext, resultOffset + offsetof(Runtime::ContextRuntimeData, thunkArgAndReturnData))}), asLLVMType(llvmContext, resultType), numResultBytes));
+        resultOffset += numResultBytes;
+    }
+    emitReturn(functionType.results(), results);
+
+    irBuilder.SetInsertPoint(forwardBlock);
+    llvm::PHINode *code = irBuilder.CreatePHI(llvmContext.i8PtrType, 2);
+    code->addIncoming(loadedCode, loadedBlock);
+    code->addIncoming(compiledCode, interpretEndBlock);
+    emitForwardToCode(code);
+}
+
+void EmitFunctionContext::emitInterruptCheck() {
+    // Poll the context's interrupt flag. The load is atomic so it isn't hoisted out of loops, but
+    // unordered with respect to other memory accesses, so it only costs a load and a predictable
+    // branch.
+    auto interruptRequestedPointer = irBuilder.CreateInBoundsGEP(irBuilder.CreateLoad(contextPointerVariable), {emitLiteral(llvmContext, Uptr(offsetof(Runtime::ContextRuntimeData, interruptRequested)))});
+    auto interruptRequested = irBuilder.CreateLoad(irBuilder.CreatePointerCast(interruptRequestedPointer, llvmContext.i32Type->getPointerTo()));
+    interruptRequested->setAlignment(sizeof(U32));
+    interruptRequested->setAtomic(llvm::AtomicOrdering::Monotonic);
+
+    auto interruptBlock = llvm::BasicBlock::Create(llvmContext, "interrupt", function);
+    auto continueBlock = llvm::BasicBlock::Create(llvmContext, "interruptCheckContinue", function);
+    irBuilder.CreateCondBr(irBuilder.CreateICmpNE(interruptRequested, emitLiteral(llvmContext, U32(0))), interruptBlock, continueBlock, moduleContext.likelyFalseBranchWeights);
+
+    irBuilder.SetInsertPoint(interruptBlock);
+    emitRuntimeIntrinsic("interrupt", FunctionType(), {});
+    irBuilder.CreateBr(continueBlock);
+
+    irBuilder.SetInsertPoint(continueBlock);
+}
+
+void EmitFunctionContext::beginFuelRegion() {
+    wavmAssert(!fuelRegionCharge);
+
+    // Subtract the region's cost from the fuel up front. The cost isn't known until the region's
+    // last operator is emitted, so subtract zero for now, and patch the constant in endFuelRegion.
+    auto fuelPointer = irBuilder.CreateInBoundsGEP(irBuilder.CreateLoad(contextPointerVariable), {emitLiteral(llvmContext, Uptr(offsetof(Runtime::ContextRuntimeData, fuel)))});
+    llvm::Value *fuel = loadRuntimeData(fuelPointer, llvmContext.i64Type, sizeof(I64));
+    fuelRegionCharge = llvm::BinaryOperator::CreateSub(fuel, emitLiteral(llvmContext, U64(0)));
+    irBuilder.Insert(fuelRegionCharge);
+    numFuelRegionOps = 0;
+    storeRuntimeData(fuelRegionCharge, fuelPointer, sizeof(I64));
+
+    auto outOfFuelBlock = llvm::BasicBlock::Create(llvmContext, "outOfFuel", function);
+    auto continueBlock = llvm::BasicBlock::Create(llvmContext, "fuelCheckContinue", function);
+    irBuilder.CreateCondBr(irBuilder.CreateICmpSLT(fuelRegionCharge, emitLiteral(llvmContext, I64(0))), outOfFuelBlock, continueBlock, moduleContext.likelyFalseBranchWeights);
+
+    // The outOfFuel intrinsic only returns if the host added more fuel.
+    irBuilder.SetInsertPoint(outOfFuelBlock);
+    emitRuntimeIntrinsic("outOfFuel", FunctionType(), {});
+    irBuilder.CreateBr(continueBlock);
+
+    irBuilder.SetInsertPoint(continueBlock);
+}
+
+void EmitFunctionContext::endFuelRegion() {
+    if (fuelRegionCharge) {
+        fuelRegionCharge->setOperand(1, emitLiteral(llvmContext, U64(numFuelRegionOps)));
+        fuelRegionCharge = nullptr;
+    }
+}
+
+// Returns whether an operator may end the basic block it's in, or start a new one. These delimit the
+// regions that fuel metering charges for as a unit.
+static bool isFuelRegionBoundary(Opcode opcode) {
+    switch (opcode) {
+        case Opcode::loop:
+        case Opcode::if_:
+        case Opcode::else_:
+        case Opcode::end:
+        case Opcode::catch_:
+        case Opcode::catch_all:
+        case Opcode::br:
+        case Opcode::br_if:
+        case Opcode::br_table:
+        case Opcode::return_:
+        case Opcode::unreachable:
+        case Opcode::throw_:
+        case Opcode::rethrow:
+            return true;
+        default:
+            return false;
+    };
+}
+
 void EmitFunctionContext::emit() {
     // Create debug info for the function.
     llvm::SmallVector<llvm::Metadata *, 10> diFunctionParameterTypes;
@@ -277,6 +582,22 @@ void EmitFunctionContext::emit() {
     diFunction = moduleContext.diBuilder.createFunction(moduleContext.diModuleScope, function->getName(), function->getName(), moduleContext.diModuleScope, 0, diFunctionType, false, true, 0);
     function->setSubprogram(diFunction);
 
+    // A lazily compiled or interpreted function definition is just a stub that compiles or
+    // interprets the function, or forwards to the function's code. Functions with parameters or
+    // results that can't be passed to the interpreter are compiled lazily.
+    if (moduleContext.enableLazyCompilation || moduleContext.enableInterpreter) {
+        entryBlock = llvm::BasicBlock::Create(llvmContext, "entry", function);
+        irBuilder.SetInsertPoint(entryBlock);
+        irBuilder.SetCurrentDebugLocation(llvm::DILocation::get(llvmContext, 0, 0, diFunction));
+        initContextVariables(&*function->arg_begin());
+        if (moduleContext.enableInterpreter && Runtime::canPassValuesToInterpreter(functionType.params()) && Runtime::canPassValuesToInterpreter(functionType.results())) {
+            emitInterpreterStub();
+        } else {
+            emitLazyCompilationStub();
+        }
+        return;
+    }
+
     // Create the return basic block, and push the root control context for the function.
     auto returnBlock = llvm::BasicBlock::Create(llvmContext, "return", function);
     auto returnPHIs = createPHIs(returnBlock, functionType.results());
@@ -284,8 +605,8 @@ void EmitFunctionContext::emit() {
     pushBranchTarget(functionType.results(), returnBlock, returnPHIs);
 
     // Create an initial basic block for the function.
-    auto entryBasicBlock = llvm::BasicBlock::Create(llvmContext, "entry", function);
-    irBuilder.SetInsertPoint(entryBasicBlock);
+    entryBlock = llvm::BasicBlock::Create(llvmContext, "entry", function);
+    irBuilder.SetInsertPoint(entryBlock);
 
     // Create and initialize allocas for the memory and table base parameters.
     auto llvmArgIt = function->arg_begin();
@@ -310,14 +631,71 @@ void EmitFunctionContext::emit() {
         }
     }
 
+    // If memory accesses are explicitly bounds checked, find the locals the function never
+    // assigns. Their values are known everywhere in the function, so the accesses through them are
+    // clamped once in the entry block, instead of on each access or loop iteration.
+    if (memoryNumReservedBytesVariable && localPointers.size()) {
+        std::vector<bool> isLocalAssigned(localPointers.size(), false);
+        AssignedLocalVisitor assignedLocalVisitor(isLocalAssigned);
+        OperatorDecoderStream assignedLocalDecoder(functionDef.code.data(), functionDef.code.size());
+        while (assignedLocalDecoder) {
+            assignedLocalDecoder.decodeOp(assignedLocalVisitor);
+        }
+
+        knownLocalValues.assign(localPointers.size(), {nullptr, nullptr});
+        auto parameterIt = function->arg_begin();
+        ++parameterIt;
+        for (Uptr localIndex = 0; localIndex < localPointers.size(); ++localIndex) {
+            llvm::Value *parameter = nullptr;
+            if (localIndex < functionType.params().size()) {
+                parameter = &*parameterIt++;
+            }
+            if (!isLocalAssigned[localIndex]) {
+                knownLocalValues[localIndex].value = parameter ? parameter : llvmContext.typedZeroConstants[(Uptr) functionDef.nonParameterLocalTypes[localIndex - functionType.params().size()]];
+            }
+        }
+        boundsCheckHoistPoint = &entryBlock->back();
+    }
+
+    if (moduleContext.enableProfileCounters) {
+        branchCountersPlaceholder = new llvm::GlobalVariable(*moduleContext.llvmModule, llvmContext.i64Type, false, llvm::GlobalVariable::ExternalLinkage, nullptr, "");
+        callIndirectCountersPlaceholder = new llvm::GlobalVariable(*moduleContext.llvmModule, llvmContext.i64Type, false, llvm::GlobalVariable::ExternalLinkage, nullptr, "");
+    }
+    if (moduleContext.profile && functionDefIndex < moduleContext.profile->functionDefs.size()) {
+        functionProfile = &moduleContext.profile->functionDefs[functionDefIndex];
+    }
+
+    if (moduleContext.tierUpCallThreshold) {
+        emitTierUpPrologue();
+    }
+
+    // The counters are updated after the tier-up prologue, so a call that is forwarded to the
+    // optimized code is only counted by it.
+    if (moduleContext.enableCallCounters) {
+        emitCallCountersPrologue();
+    }
+
+    if (moduleContext.enableInterruptChecks) {
+        emitInterruptCheck();
+    }
+
+    if (moduleContext.enableFuelMetering) {
+        beginFuelRegion();
+    }
+
     if (EMIT_ENTER_EXIT_HOOKS) {
         emitRuntimeIntrinsic("debugEnterFunction", FunctionType({}, {ValueType::anyfunc}), {llvm::ConstantExpr::getSub(llvm::ConstantExpr::getPtrToInt(function, llvmContext.iptrType), emitLiteral(llvmContext, Uptr(offsetof(Runtime::Function, code))))});
     }
 
-    // Decode the WebAssembly opcodes and emit LLVM IR for them.
-    OperatorDecoderStream decoder(functionDef.code);
+    // Decode the WebAssembly opcodes and emit LLVM IR for them. If the code wasn't validated when it
+    // was decoded, validate each operator before emitting it, so the code is only decoded once.
+    OperatorDecoderStream decoder(functionDef.code.data(), functionDef.code.size());
     UnreachableOpVisitor unreachableOpVisitor(*this);
     OperatorPrinter operatorPrinter(irModule, functionDef);
+    std::unique_ptr<CodeValidationStream> codeValidationStream;
+    if (moduleContext.deferredCodeValidationState) {
+        codeValidationStream.reset(new CodeValidationStream(irModule, functionDef, *moduleContext.deferredCodeValidationState));
+    }
     Uptr opIndex = 0;
     while (decoder && controlStack.size()) {
         irBuilder.SetCurrentDebugLocation(llvm::DILocation::get(llvmContext, (unsigned int) opIndex++, 0, diFunction));
@@ -325,21 +703,56 @@ void EmitFunctionContext::emit() {
             logOperator(decoder.decodeOpWithoutConsume(operatorPrinter));
         }
 
+        const bool isEndOfFuelRegion = moduleContext.enableFuelMetering && isFuelRegionBoundary(decoder.peekOpcode());
         if (controlStack.back().isReachable) {
-            decoder.decodeOp(*this);
+            ++numFuelRegionOps;
+            if (codeValidationStream) {
+                CodeValidationProxyVisitor<EmitFunctionContext> validatingVisitor(*codeValidationStream, *this);
+                decoder.decodeOp(validatingVisitor);
+            } else {
+                decoder.decodeOp(*this);
+            }
         } else {
-            decoder.decodeOp(unreachableOpVisitor);
+            if (codeValidationStream) {
+                CodeValidationProxyVisitor<UnreachableOpVisitor> validatingVisitor(*codeValidationStream, unreachableOpVisitor);
+                decoder.decodeOp(validatingVisitor);
+            } else {
+                decoder.decodeOp(unreachableOpVisitor);
+            }
+        }
+
+        // Charge the operators up to and including a control flow operator to the region that
+        // precedes it, and start a new region if the code after it is reachable.
+        if (isEndOfFuelRegion) {
+            endFuelRegion();
+            if (controlStack.size() && controlStack.back().isReachable) {
+                beginFuelRegion();
+            }
         }
     };
+    if (codeValidationStream) {
+        if (decoder) {
+            throw ValidationException("operators after the end of the function");
+        }
+        codeValidationStream->finish();
+    }
     wavmAssert(irBuilder.GetInsertBlock() == returnBlock);
 
     if (EMIT_ENTER_EXIT_HOOKS) {
         emitRuntimeIntrinsic("debugExitFunction", FunctionType({}, {ValueType::anyfunc}), {llvm::ConstantExpr::getSub(llvm::ConstantExpr::getPtrToInt(function, llvmContext.iptrType), emitLiteral(llvmContext, Uptr(offsetof(Runtime::Function, code))))});
     }
 
+    if (moduleContext.enableCallCounters) {
+        emitCallCountersEpilogue();
+    }
+
     // Emit the function return.
     emitReturn(functionType.results(), stack);
 
+    if (branchCountersPlaceholder) {
+        createProfileCounters();
+    }
+
     // If a local escape block was created, add a localescape intrinsic to it with the accumulated
     // local escape allocas, and insert it before the function's entry block.
     if (localEscapeBlock) {
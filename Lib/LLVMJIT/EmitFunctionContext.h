@@ -7,6 +7,7 @@
 #include "WAVM/IR/Types.h"
 
 PUSH_DISABLE_WARNINGS_FOR_LLVM_HEADERS
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/IR/Intrinsics.h"
 
 POP_DISABLE_WARNINGS_FOR_LLVM_HEADERS
@@ -18,14 +19,60 @@ namespace WAVM {
 
             struct EmitModuleContext &moduleContext;
             const IR::Module &irModule;
+            const Uptr functionDefIndex;
             const IR::FunctionDef &functionDef;
+            llvm::Constant *functionDefMutableData;
             IR::FunctionType functionType;
             llvm::Function *function;
 
             std::vector<llvm::Value *> localPointers;
 
+            // If the function's memory accesses are explicitly bounds checked, the value of each
+            // local where it's known: in the basic block it was last loaded or assigned in, or in the
+            // whole function if the function never assigns it. get_local reuses a known value, so
+            // the accesses through it may share a bounded address.
+            struct KnownLocalValue {
+                llvm::Value *value;
+                llvm::BasicBlock *block;
+            };
+            std::vector<KnownLocalValue> knownLocalValues;
+
+            // The addresses that have been clamped to the memory's reservation, and the basic block
+            // the clamped address was computed in. A function argument's address is clamped in the
+            // entry block, after boundsCheckHoistPoint, so it's checked once for the whole function.
+            struct BoundedMemoryBase {
+                llvm::BasicBlock *block;
+                llvm::Value *boundedBase;
+            };
+            llvm::DenseMap<llvm::Value *, BoundedMemoryBase> boundedMemoryBases;
+            llvm::Instruction *boundsCheckHoistPoint;
+
             llvm::DISubprogram *diFunction;
 
+            llvm::BasicBlock *entryBlock;
+
+            // The subtract from the fuel of the current fuel metering region, whose cost operand is
+            // set to the number of operators in the region when it ends.
+            llvm::BinaryOperator *fuelRegionCharge;
+            Uptr numFuelRegionOps;
+
+            // The cycle counter at the function's entry, if the function times its calls.
+            llvm::Value *callStartTicks;
+
+            // If the function has profile counters, placeholders for its branch and call_indirect
+            // counters. The number of counters isn't known until the function has been emitted, so
+            // createProfileCounters then replaces them with pointers into the counters array.
+            llvm::GlobalVariable *branchCountersPlaceholder;
+            llvm::GlobalVariable *callIndirectCountersPlaceholder;
+
+            // The function's profile from a previous run, if the module is compiled with one.
+            const FunctionProfile *functionProfile;
+
+            // The number of if and br_if, and call_indirect operators emitted so far, which index
+            // the function's profile counters and profile.
+            Uptr numBranches;
+            Uptr numCallIndirects;
+
             llvm::BasicBlock *localEscapeBlock;
             std::vector<llvm::Value *> pendingLocalEscapes;
 
@@ -56,15 +103,48 @@ namespace WAVM {
             std::vector<BranchTarget> branchTargetStack;
             std::vector<llvm::Value *> stack;
 
-            EmitFunctionContext(LLVMContext &inLLVMContext, EmitModuleContext &inModuleContext, const IR::Module &inIRModule, const IR::FunctionDef &inFunctionDef, llvm::Function *inLLVMFunction)
-                    : EmitContext(inLLVMContext, inModuleContext.defaultMemoryOffset), moduleContext(inModuleContext),
-                      irModule(inIRModule), functionDef(inFunctionDef),
-                      functionType(inIRModule.types[inFunctionDef.type.index]), function(inLLVMFunction),
-                      localEscapeBlock(nullptr) {
+            EmitFunctionContext(LLVMContext &inLLVMContext, EmitModuleContext &inModuleContext, const IR::Module &inIRModule, Uptr inFunctionDefIndex, llvm::Constant *inFunctionDefMutableData, llvm::Function *inLLVMFunction)
+                    : EmitContext(inLLVMContext, inModuleContext.defaultMemoryOffset, inModuleContext.explicitMemoryBoundsChecks), moduleContext(inModuleContext),
+                      irModule(inIRModule), functionDefIndex(inFunctionDefIndex),
+                      functionDef(inIRModule.functions.defs[inFunctionDefIndex]),
+                      functionDefMutableData(inFunctionDefMutableData),
+                      functionType(inIRModule.types[functionDef.type.index]), function(inLLVMFunction),
+                      boundsCheckHoistPoint(nullptr), entryBlock(nullptr), fuelRegionCharge(nullptr), numFuelRegionOps(0), callStartTicks(nullptr),
+                      branchCountersPlaceholder(nullptr), callIndirectCountersPlaceholder(nullptr), functionProfile(nullptr), numBranches(0), numCallIndirects(0), localEscapeBlock(nullptr) {
+                runtimeDataTBAATag = inModuleContext.runtimeDataTBAATag;
             }
 
             void emit();
 
+            void emitTierUpPrologue();
+
+            void emitLazyCompilationStub();
+
+            void emitInterpreterStub();
+
+            // Forwards the call to the function's code with a tail call, which reuses the stub's
+            // arguments and stack frame.
+            void emitForwardToCode(llvm::Value *code);
+
+            llvm::Constant *getCallCounterPointer(Uptr counterOffset);
+
+            void emitCallCountersPrologue();
+
+            void emitCallCountersEpilogue();
+
+            void emitInterruptCheck();
+
+            // Emits the conditional branch of an if or br_if. If the function has profile counters,
+            // the branch counts whether it is taken, and if the module is compiled with a profile,
+            // the branch is weighted by the profiled counts.
+            void emitProfiledCondBr(llvm::Value *booleanCondition, llvm::BasicBlock *trueBlock, llvm::BasicBlock *falseBlock);
+
+            void createProfileCounters();
+
+            void beginFuelRegion();
+
+            void endFuelRegion();
+
             // Operand stack manipulation
             llvm::Value *pop() {
                 wavmAssert(stack.size() - (controlStack.size() ? controlStack.back().outerStackSize : 0) >= 1);
@@ -116,6 +196,11 @@ namespace WAVM {
             // Converts a bounded memory address to a LLVM pointer.
             llvm::Value *coerceAddressToPointer(llvm::Value *boundedAddress, llvm::Type *memoryType);
 
+            // Returns a 32-bit address zero extended to 64 bits and clamped to the memory's
+            // reservation, reusing a clamped address computed earlier for the same value if it
+            // dominates the insert point.
+            llvm::Value *getBoundedMemoryBase(llvm::Value *address);
+
             // Traps a divide-by-zero
             void trapDivideByZero(llvm::Value *divisor);
 
@@ -181,6 +266,14 @@ namespace WAVM {
 
             struct TryContext {
                 llvm::BasicBlock *unwindToBlock;
+
+                // The block that dispatches an exception to the try's catch clauses. Exceptions
+                // thrown in the same function branch to it directly, and add their type ID, data,
+                // and whether they are local to these PHIs.
+                llvm::BasicBlock *catchDispatchBlock;
+                llvm::PHINode *exceptionTypeIdPHI;
+                llvm::PHINode *exceptionPointerPHI;
+                llvm::PHINode *isLocalExceptionPHI;
             };
 
             struct CatchContext {
@@ -194,6 +287,10 @@ namespace WAVM {
 
                 // Used for all platforms.
                 llvm::Value *exceptionPointer;
+
+                // True if the exception was thrown in this function, in which case exceptionPointer
+                // points to an ExceptionData on the stack instead of one owned by a C++ exception.
+                llvm::Value *isLocalException;
             };
 
             std::vector<TryContext> tryStack;
@@ -205,6 +302,8 @@ namespace WAVM {
 
             llvm::BasicBlock *getInnermostUnwindToBlock();
 
+            void emitThrowToInnermostHandler(llvm::Value *exceptionTypeId, llvm::Value *exceptionPointer, llvm::Value *isLocalException);
+
 #define VISIT_OPCODE(encoding, name, nameString, Imm, ...) void name(IR::Imm imm);
 
             ENUM_OPERATORS(VISIT_OPCODE)
@@ -1,32 +1,98 @@
+#include <algorithm>
+
 #include "EmitContext.h"
 #include "EmitFunctionContext.h"
 
 PUSH_DISABLE_WARNINGS_FOR_LLVM_HEADERS
+#include "llvm/Analysis/ValueTracking.h"
+#include "llvm/Support/KnownBits.h"
 
 POP_DISABLE_WARNINGS_FOR_LLVM_HEADERS
 
+using namespace WAVM;
 using namespace WAVM::IR;
 using namespace WAVM::LLVMJIT;
 
+// The number of bytes accessed by the widest memory operator.
+static constexpr U64 maxMemoryAccessBytes = 16;
+
+// Emits the clamp of a 32-bit address to the end of the memory's reservation: an access there
+// faults on the guard page that follows it, so this doesn't need a branch or a trap block.
+static llvm::Value *emitBoundedMemoryBase(EmitFunctionContext &functionContext, llvm::IRBuilder<> &irBuilder, llvm::Value *address) {
+    llvm::Value *address64 = irBuilder.CreateZExt(address, functionContext.llvmContext.i64Type);
+    llvm::Value *numReservedBytes = irBuilder.CreateLoad(functionContext.memoryNumReservedBytesVariable);
+    return irBuilder.CreateSelect(irBuilder.CreateICmpUGT(address64, numReservedBytes), numReservedBytes, address64);
+}
+
+llvm::Value *EmitFunctionContext::getBoundedMemoryBase(llvm::Value *address) {
+    // The arguments of a function are only pushed by get_local for parameters the function never
+    // assigns, so their clamped address is computed once in the entry block, which dominates every
+    // access, including the accesses in loops.
+    const bool isArgument = llvm::isa<llvm::Argument>(address);
+    llvm::BasicBlock *block = isArgument ? entryBlock : irBuilder.GetInsertBlock();
+
+    auto boundedBaseIt = boundedMemoryBases.find(address);
+    if (boundedBaseIt != boundedMemoryBases.end() && boundedBaseIt->second.block == block) {
+        return boundedBaseIt->second.boundedBase;
+    }
+
+    llvm::Value *boundedBase;
+    if (isArgument) {
+        llvm::IRBuilder<> hoistIRBuilder(entryBlock, std::next(boundsCheckHoistPoint->getIterator()));
+        hoistIRBuilder.SetCurrentDebugLocation(llvm::DILocation::get(llvmContext, 0, 0, diFunction));
+        boundedBase = emitBoundedMemoryBase(*this, hoistIRBuilder, address);
+        boundsCheckHoistPoint = llvm::cast<llvm::Instruction>(boundedBase);
+    } else {
+        boundedBase = emitBoundedMemoryBase(*this, irBuilder, address);
+    }
+    boundedMemoryBases[address] = {block, boundedBase};
+    return boundedBase;
+}
+
 // Bounds checks a sandboxed memory address + offset, and returns an offset relative to the memory
 // base address that is guaranteed to be within the virtual address space allocated for the linear
 // memory object.
-static llvm::Value *getOffsetAndBoundedAddress(EmitContext &emitContext, llvm::Value *address, U32 offset) {
+static llvm::Value *getOffsetAndBoundedAddress(EmitFunctionContext &functionContext, llvm::Value *address, U32 offset) {
+    llvm::IRBuilder<> &irBuilder = functionContext.irBuilder;
+    LLVMContext &llvmContext = functionContext.llvmContext;
+
+    // If the memory may only reserve address space for its maximum size, the address must be
+    // clamped to the end of the reservation, unless it's known to be within it.
+    if (functionContext.memoryNumReservedBytesVariable) {
+        // The memory's reservation is at least its minimum size, so an address whose known bits
+        // bound the accessed bytes within the minimum size doesn't need to be clamped. This covers
+        // constant addresses, and addresses masked or shifted into a fixed range.
+        const U64 memoryMinBytes = functionContext.irModule.memories.getType(0).size.min * IR::numBytesPerPage;
+        const llvm::KnownBits knownAddressBits = llvm::computeKnownBits(address, functionContext.function->getParent()->getDataLayout());
+        const U64 maxAddress = (~knownAddressBits.Zero).getZExtValue();
+        if (maxAddress + offset + maxMemoryAccessBytes > memoryMinBytes) {
+            // If the offset is within the guard page, clamp only the address and add the offset to
+            // it, so all the accesses through an address share one clamp.
+            if (offset + maxMemoryAccessBytes <= Runtime::boundedMemoryGuardBytes) {
+                llvm::Value *boundedBase = functionContext.getBoundedMemoryBase(address);
+                return offset ? irBuilder.CreateAdd(boundedBase, emitLiteral(llvmContext, U64(offset))) : boundedBase;
+            }
+
+            llvm::Value *numReservedBytes = irBuilder.CreateLoad(functionContext.memoryNumReservedBytesVariable);
+            llvm::Value *offsetAddress = irBuilder.CreateAdd(irBuilder.CreateZExt(address, llvmContext.i64Type), emitLiteral(llvmContext, U64(offset)));
+            return irBuilder.CreateSelect(irBuilder.CreateICmpUGT(offsetAddress, numReservedBytes), numReservedBytes, offsetAddress);
+        }
+    }
+
     // zext the 32-bit address to 64-bits.
     // This is crucial for security, as LLVM will otherwise implicitly sign extend it to 64-bits in
     // the GEP below, interpreting it as a signed offset and allowing access to memory outside the
     // sandboxed memory range. There are no 'far addresses' in a 32 bit runtime.
-    address = emitContext.irBuilder.CreateZExt(address, emitContext.llvmContext.i64Type);
+    address = irBuilder.CreateZExt(address, llvmContext.i64Type);
 
     // Add the offset to the byte index.
     if (offset) {
-        address = emitContext.irBuilder.CreateAdd(address, emitContext.irBuilder.CreateZExt(emitLiteral(emitContext.llvmContext, offset), emitContext.llvmContext.i64Type));
+        address = irBuilder.CreateAdd(address, irBuilder.CreateZExt(emitLiteral(llvmContext, offset), llvmContext.i64Type));
     }
 
     // If HAS_64BIT_ADDRESS_SPACE, the memory has enough virtual address space allocated to ensure
     // that any 32-bit byte index + 32-bit offset will fall within the virtual address sandbox, so
     // no explicit bounds check is necessary.
-
     return address;
 }
 
@@ -74,12 +140,64 @@ void EmitFunctionContext::memory_drop(DataSegmentImm imm) {
     emitRuntimeIntrinsic("memory.drop", FunctionType({}, TypeTuple({inferValueType<Uptr>(), inferValueType<Uptr>()})), {moduleContext.moduleInstanceId, emitLiteral(llvmContext, imm.dataSegmentIndex)});
 }
 
+// Emits a check that the byte ranges [address, address + numBytes) of each address are within the
+// default memory's committed bytes. Branches to the returned block if they aren't, and leaves the
+// insert point in a block only reached if they are.
+static llvm::BasicBlock *emitInlineBulkMemoryBoundsCheck(EmitFunctionContext &functionContext, std::initializer_list<llvm::Value *> addresses, llvm::Value *numBytes) {
+    LLVMContext &llvmContext = functionContext.llvmContext;
+    llvm::IRBuilder<> &irBuilder = functionContext.irBuilder;
+
+    // The memory's committed size follows the memory bases and reserved sizes in
+    // CompartmentRuntimeData. It only increases while the code can access the memory, so reading
+    // a stale value just takes the out-of-line path.
+    llvm::Constant *numBytesOffset = llvm::ConstantExpr::getAdd(functionContext.moduleContext.defaultMemoryOffset, emitLiteral(llvmContext, Uptr(2 * Runtime::maxMemories * sizeof(void *))));
+    llvm::LoadInst *memoryNumBytes = functionContext.loadRuntimeData(irBuilder.CreateInBoundsGEP(functionContext.getCompartmentAddress(), {numBytesOffset}), llvmContext.i64Type, sizeof(Uptr));
+    memoryNumBytes->setAtomic(llvm::AtomicOrdering::Monotonic);
+
+    // 32-bit addresses and sizes can't overflow when added as 64-bit integers.
+    llvm::Value *isInBounds = nullptr;
+    for (llvm::Value *address : addresses) {
+        llvm::Value *endAddress = irBuilder.CreateAdd(irBuilder.CreateZExt(address, llvmContext.i64Type), numBytes);
+        llvm::Value *isAddressInBounds = irBuilder.CreateICmpULE(endAddress, memoryNumBytes);
+        isInBounds = isInBounds ? irBuilder.CreateAnd(isInBounds, isAddressInBounds) : isAddressInBounds;
+    }
+
+    llvm::BasicBlock *inBoundsBlock = llvm::BasicBlock::Create(llvmContext, "bulkMemoryInBounds", functionContext.function);
+    llvm::BasicBlock *outOfBoundsBlock = llvm::BasicBlock::Create(llvmContext, "bulkMemoryOutOfBounds", functionContext.function);
+    irBuilder.CreateCondBr(isInBounds, inBoundsBlock, outOfBoundsBlock, functionContext.moduleContext.likelyTrueBranchWeights);
+    irBuilder.SetInsertPoint(inBoundsBlock);
+    return outOfBoundsBlock;
+}
+
 void EmitFunctionContext::memory_copy(MemoryImm imm) {
     auto numBytes = pop();
     auto sourceAddress = pop();
     auto destAddress = pop();
 
+    // If the operation is on the default memory, do it inline if it's in bounds, and only call the
+    // intrinsic to trap if it isn't. LLVM lowers a small constant size to plain loads and stores.
+    llvm::BasicBlock *endBlock = nullptr;
+    if (imm.memoryIndex == 0) {
+        llvm::Value *numBytes64 = irBuilder.CreateZExt(numBytes, llvmContext.i64Type);
+        llvm::BasicBlock *outOfBoundsBlock = emitInlineBulkMemoryBoundsCheck(*this, {destAddress, sourceAddress}, numBytes64);
+        llvm::Value *destPointer = coerceAddressToPointer(irBuilder.CreateZExt(destAddress, llvmContext.i64Type), llvmContext.i8Type);
+        llvm::Value *sourcePointer = coerceAddressToPointer(irBuilder.CreateZExt(sourceAddress, llvmContext.i64Type), llvmContext.i8Type);
+#if LLVM_VERSION_MAJOR >= 7
+        irBuilder.CreateMemMove(destPointer, 1, sourcePointer, 1, numBytes64);
+#else
+        irBuilder.CreateMemMove(destPointer, sourcePointer, numBytes64, 1);
+#endif
+        endBlock = llvm::BasicBlock::Create(llvmContext, "memoryCopyEnd", function);
+        irBuilder.CreateBr(endBlock);
+        irBuilder.SetInsertPoint(outOfBoundsBlock);
+    }
+
     emitRuntimeIntrinsic("memory.copy", FunctionType({}, TypeTuple({ValueType::i32, ValueType::i32, ValueType::i32, inferValueType<Uptr>()})), {destAddress, sourceAddress, numBytes, getMemoryIdFromOffset(llvmContext, moduleContext.memoryOffsets[imm.memoryIndex])});
+
+    if (endBlock) {
+        irBuilder.CreateBr(endBlock);
+        irBuilder.SetInsertPoint(endBlock);
+    }
 }
 
 void EmitFunctionContext::memory_fill(MemoryImm imm) {
@@ -87,13 +205,46 @@ void EmitFunctionContext::memory_fill(MemoryImm imm) {
     auto value = pop();
     auto destAddress = pop();
 
+    // As for memory.copy, do the operation inline if it's in bounds.
+    llvm::BasicBlock *endBlock = nullptr;
+    if (imm.memoryIndex == 0) {
+        llvm::Value *numBytes64 = irBuilder.CreateZExt(numBytes, llvmContext.i64Type);
+        llvm::BasicBlock *outOfBoundsBlock = emitInlineBulkMemoryBoundsCheck(*this, {destAddress}, numBytes64);
+        llvm::Value *destPointer = coerceAddressToPointer(irBuilder.CreateZExt(destAddress, llvmContext.i64Type), llvmContext.i8Type);
+        irBuilder.CreateMemSet(destPointer, irBuilder.CreateTrunc(value, llvmContext.i8Type), numBytes64, 1);
+        endBlock = llvm::BasicBlock::Create(llvmContext, "memoryFillEnd", function);
+        irBuilder.CreateBr(endBlock);
+        irBuilder.SetInsertPoint(outOfBoundsBlock);
+    }
+
     emitRuntimeIntrinsic("memory.fill", FunctionType({}, TypeTuple({ValueType::i32, ValueType::i32, ValueType::i32, inferValueType<Uptr>()})), {destAddress, value, numBytes, getMemoryIdFromOffset(llvmContext, moduleContext.memoryOffsets[imm.memoryIndex])});
+
+    if (endBlock) {
+        irBuilder.CreateBr(endBlock);
+        irBuilder.SetInsertPoint(endBlock);
+    }
 }
 
 //
 // Load/store operators
 //
 
+template<typename Access> static void setLinearMemoryAccessAttributes(EmitModuleContext &moduleContext, Access *access, U32 alignmentLog2, U32 naturalAlignmentLog2) {
+    if (!moduleContext.linearMemoryTBAATag) {
+        // Don't trust the alignment hint provided by the WebAssembly code, since the access can't
+        // trap if it's wrong.
+        access->setAlignment(1);
+        access->setVolatile(true);
+    } else {
+        // A misaligned scalar access doesn't fault on the targets WAVM supports, so the hint can be
+        // used for accesses up to 8 bytes. A 16-byte alignment could select an instruction that
+        // faults on a misaligned address, so it is never claimed.
+        const U32 hintedAlignmentLog2 = std::min(std::min(alignmentLog2, naturalAlignmentLog2), U32(3));
+        access->setAlignment(naturalAlignmentLog2 > 3 ? 1 : U32(1) << hintedAlignmentLog2);
+        access->setMetadata(llvm::LLVMContext::MD_tbaa, moduleContext.linearMemoryTBAATag);
+    }
+}
+
 #define EMIT_LOAD_OP(valueTypeId, name, llvmMemoryType, naturalAlignmentLog2, conversionOp)        \
     void EmitFunctionContext::valueTypeId##_##name(LoadOrStoreImm<naturalAlignmentLog2> imm)       \
     {                                                                                              \
@@ -101,10 +252,8 @@ void EmitFunctionContext::memory_fill(MemoryImm imm) {
         auto boundedAddress = getOffsetAndBoundedAddress(*this, address, imm.offset);              \
         auto pointer = coerceAddressToPointer(boundedAddress, llvmMemoryType);                     \
         auto load = irBuilder.CreateLoad(pointer);                                                 \
-        /* Don't trust the alignment hint provided by the WebAssembly code, since the load can't   \
-		 * trap if it's wrong. */                                                                  \
-        load->setAlignment(1);                                                                     \
-        load->setVolatile(true);                                                                   \
+        setLinearMemoryAccessAttributes(                                                           \
+            moduleContext, load, imm.alignmentLog2, naturalAlignmentLog2);                         \
         push(conversionOp(load, asLLVMType(llvmContext, ValueType::valueTypeId)));                 \
     }
 #define EMIT_STORE_OP(valueTypeId, name, llvmMemoryType, naturalAlignmentLog2, conversionOp)       \
@@ -116,10 +265,8 @@ void EmitFunctionContext::memory_fill(MemoryImm imm) {
         auto pointer = coerceAddressToPointer(boundedAddress, llvmMemoryType);                     \
         auto memoryValue = conversionOp(value, llvmMemoryType);                                    \
         auto store = irBuilder.CreateStore(memoryValue, pointer);                                  \
-        store->setVolatile(true);                                                                  \
-        /* Don't trust the alignment hint provided by the WebAssembly code, since the store can't  \
-		 * trap if it's wrong. */                                                                  \
-        store->setAlignment(1);                                                                    \
+        setLinearMemoryAccessAttributes(                                                           \
+            moduleContext, store, imm.alignmentLog2, naturalAlignmentLog2);                        \
     }
 
 EMIT_LOAD_OP(i32, load8_s, llvmContext.i8Type, 0, sext)
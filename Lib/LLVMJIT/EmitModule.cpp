@@ -1,9 +1,13 @@
 #include <stdint.h>
+#include <algorithm>
 #include <vector>
 
 #include "EmitFunctionContext.h"
+#include "WAVM/Inline/HashMap.h"
+#include "WAVM/Platform/Clock.h"
 
 PUSH_DISABLE_WARNINGS_FOR_LLVM_HEADERS
+#include "llvm/IR/MDBuilder.h"
 
 POP_DISABLE_WARNINGS_FOR_LLVM_HEADERS
 
@@ -16,9 +20,13 @@ using namespace WAVM::IR;
 using namespace WAVM::LLVMJIT;
 using namespace WAVM::Runtime;
 
+// The maximum size of a function definition's encoded code that is inlined into its callers: about
+// 8 operators in the compact operator encoding.
+static constexpr Uptr maxInlinedFunctionCodeBytes = 20;
+
 EmitModuleContext::EmitModuleContext(const IR::Module &inIRModule, LLVMContext &inLLVMContext, llvm::Module *inLLVMModule)
         : irModule(inIRModule), llvmContext(inLLVMContext), llvmModule(inLLVMModule), defaultMemoryOffset(nullptr),
-          defaultTableOffset(nullptr), diBuilder(*inLLVMModule) {
+          defaultTableOffset(nullptr), tierUpCallThreshold(0), enableLazyCompilation(false), enableInterpreter(false), explicitMemoryBoundsChecks(false), enableInterruptChecks(false), enableFuelMetering(false), enableCallCounters(false), enableCallTiming(false), enableProfileCounters(false), profile(nullptr), deferredCodeValidationState(nullptr), linearMemoryTBAATag(nullptr), runtimeDataTBAATag(nullptr), diBuilder(*inLLVMModule) {
     diModuleScope = diBuilder.createFile("unknown", "unknown");
     diCompileUnit = diBuilder.createCompileUnit(0xffff, diModuleScope, "WAVM", true, "", 0);
 
@@ -43,29 +51,68 @@ EmitModuleContext::EmitModuleContext(const IR::Module &inIRModule, LLVMContext &
     tryPrologueDummyFunction = nullptr;
     cxaBeginCatchFunction = nullptr;
 
-    cxaBeginCatchFunction = llvm::Function::Create(llvm::FunctionType::get(llvmContext.i8PtrType, {llvmContext.i8PtrType}, false), llvm::GlobalValue::LinkageTypes::ExternalLinkage, "__cxa_begin_catch", llvmModule);
+    // A linked module's code may have been emitted into the LLVM module before this module's, so
+    // the declarations of the symbols that aren't specific to a module may already exist.
+    cxaBeginCatchFunction = llvmModule->getFunction("__cxa_begin_catch");
+    if (!cxaBeginCatchFunction) {
+        cxaBeginCatchFunction = llvm::Function::Create(llvm::FunctionType::get(llvmContext.i8PtrType, {llvmContext.i8PtrType}, false), llvm::GlobalValue::LinkageTypes::ExternalLinkage, "__cxa_begin_catch", llvmModule);
+    }
 }
 
 static llvm::Constant *createImportedConstant(llvm::Module &llvmModule, llvm::Twine externalName) {
     return new llvm::GlobalVariable(llvmModule, llvm::Type::getInt8Ty(llvmModule.getContext()), false, llvm::GlobalVariable::ExternalLinkage, nullptr, externalName);
 }
 
-void LLVMJIT::emitModule(const IR::Module &irModule, LLVMContext &llvmContext, llvm::Module &outLLVMModule) {
+// Emits a module's function definitions in [beginFunctionDefIndex, endFunctionDefIndex). If
+// linkedFunctionDefs is non-null, the module is a linked module: only the definitions it selects are
+// emitted, as available_externally copies, and all the module's symbols are prefixed with
+// externalNamePrefix.
+static void emitModuleImpl(const IR::Module &irModule, const CompileOptions &options, LLVMContext &llvmContext, llvm::Module &outLLVMModule, Uptr beginFunctionDefIndex, Uptr endFunctionDefIndex, DeferredCodeValidationState *deferredCodeValidationState, FunctionCompileStats *outFunctionStats, const std::string &externalNamePrefix, const std::vector<bool> *linkedFunctionDefs) {
+    wavmAssert(beginFunctionDefIndex <= endFunctionDefIndex && endFunctionDefIndex <= irModule.functions.defs.size());
+
     EmitModuleContext moduleContext(irModule, llvmContext, &outLLVMModule);
+    moduleContext.externalNamePrefix = externalNamePrefix;
+    if (options.enableTierUp) {
+        wavmAssert(options.tierUpCallThreshold > 0);
+        moduleContext.tierUpCallThreshold = options.tierUpCallThreshold;
+    }
+    moduleContext.enableLazyCompilation = options.enableLazyCompilation;
+    moduleContext.enableInterpreter = options.enableInterpreter;
+    moduleContext.explicitMemoryBoundsChecks = options.explicitMemoryBoundsChecks;
+    moduleContext.enableInterruptChecks = options.enableInterruptChecks;
+    moduleContext.enableFuelMetering = options.enableFuelMetering;
+    moduleContext.enableCallCounters = options.enableCallCounters || options.enableProfileCounters;
+    moduleContext.enableCallTiming = options.enableCallCounters && options.enableCallTiming;
+    moduleContext.enableProfileCounters = options.enableProfileCounters;
+    moduleContext.profile = options.profile.get();
+    moduleContext.deferredCodeValidationState = deferredCodeValidationState;
+    if (options.nonVolatileMemoryAccesses) {
+        // All linear memory accesses share a TBAA type, since wasm code may access the same bytes
+        // with different types, but it is disjoint from the type of runtime data accesses.
+        llvm::MDBuilder mdBuilder(llvmContext);
+        llvm::MDNode *tbaaRoot = mdBuilder.createTBAARoot("WAVM TBAA");
+        llvm::MDNode *linearMemoryType = mdBuilder.createTBAAScalarTypeNode("linear memory", tbaaRoot);
+        llvm::MDNode *runtimeDataType = mdBuilder.createTBAAScalarTypeNode("runtime data", tbaaRoot);
+        moduleContext.linearMemoryTBAATag = mdBuilder.createTBAAStructTagNode(linearMemoryType, linearMemoryType, 0);
+        moduleContext.runtimeDataTBAATag = mdBuilder.createTBAAStructTagNode(runtimeDataType, runtimeDataType, 0);
+    }
 
     // Create an external reference to the appropriate exception personality function.
-    auto personalityFunction = llvm::Function::Create(llvm::FunctionType::get(llvmContext.i32Type, {}, false), llvm::GlobalValue::LinkageTypes::ExternalLinkage, "__gxx_personality_v0", &outLLVMModule);
+    llvm::Function *personalityFunction = outLLVMModule.getFunction("__gxx_personality_v0");
+    if (!personalityFunction) {
+        personalityFunction = llvm::Function::Create(llvm::FunctionType::get(llvmContext.i32Type, {}, false), llvm::GlobalValue::LinkageTypes::ExternalLinkage, "__gxx_personality_v0", &outLLVMModule);
+    }
 
     // Create LLVM external globals corresponding to the encoded function types for the module's
     // indexed function types.
     for (Uptr typeIndex = 0; typeIndex < irModule.types.size(); ++typeIndex) {
-        moduleContext.typeIds.push_back(llvm::ConstantExpr::getPtrToInt(createImportedConstant(outLLVMModule, getExternalName("typeId", typeIndex)), llvmContext.iptrType));
+        moduleContext.typeIds.push_back(llvm::ConstantExpr::getPtrToInt(createImportedConstant(outLLVMModule, externalNamePrefix + getExternalName("typeId", typeIndex)), llvmContext.iptrType));
     }
 
     // Create LLVM external globals corresponding to offsets to table base pointers in
     // CompartmentRuntimeData for the module's declared table objects.
     for (Uptr tableIndex = 0; tableIndex < irModule.tables.size(); ++tableIndex) {
-        moduleContext.tableOffsets.push_back(llvm::ConstantExpr::getPtrToInt(createImportedConstant(outLLVMModule, getExternalName("tableOffset", tableIndex)), llvmContext.iptrType));
+        moduleContext.tableOffsets.push_back(llvm::ConstantExpr::getPtrToInt(createImportedConstant(outLLVMModule, externalNamePrefix + getExternalName("tableOffset", tableIndex)), llvmContext.iptrType));
     }
     if (moduleContext.tableOffsets.size()) {
         moduleContext.defaultTableOffset = moduleContext.tableOffsets[0];
@@ -74,7 +121,7 @@ void LLVMJIT::emitModule(const IR::Module &irModule, LLVMContext &llvmContext, l
     // Create LLVM external globals corresponding to offsets to memory base pointers in
     // CompartmentRuntimeData for the module's declared memory objects.
     for (Uptr memoryIndex = 0; memoryIndex < irModule.memories.size(); ++memoryIndex) {
-        moduleContext.memoryOffsets.push_back(llvm::ConstantExpr::getPtrToInt(createImportedConstant(outLLVMModule, getExternalName("memoryOffset", memoryIndex)), llvmContext.iptrType));
+        moduleContext.memoryOffsets.push_back(llvm::ConstantExpr::getPtrToInt(createImportedConstant(outLLVMModule, externalNamePrefix + getExternalName("memoryOffset", memoryIndex)), llvmContext.iptrType));
     }
     if (moduleContext.memoryOffsets.size()) {
         moduleContext.defaultMemoryOffset = moduleContext.memoryOffsets[0];
@@ -82,57 +129,247 @@ void LLVMJIT::emitModule(const IR::Module &irModule, LLVMContext &llvmContext, l
 
     // Create LLVM external globals for the module's globals.
     for (Uptr globalIndex = 0; globalIndex < irModule.globals.size(); ++globalIndex) {
-        moduleContext.globals.push_back(createImportedConstant(outLLVMModule, getExternalName("global", globalIndex)));
+        moduleContext.globals.push_back(createImportedConstant(outLLVMModule, externalNamePrefix + getExternalName("global", globalIndex)));
     }
 
     // Create LLVM external globals corresponding to pointers to ExceptionTypes for the
     // module's declared exception types.
     for (Uptr exceptionTypeIndex = 0; exceptionTypeIndex < irModule.exceptionTypes.size(); ++exceptionTypeIndex) {
-        llvm::Constant *biasedExceptionTypeIdAsPointer = createImportedConstant(outLLVMModule, getExternalName("biasedExceptionTypeId", exceptionTypeIndex));
+        llvm::Constant *biasedExceptionTypeIdAsPointer = createImportedConstant(outLLVMModule, externalNamePrefix + getExternalName("biasedExceptionTypeId", exceptionTypeIndex));
         llvm::Constant *biasedExceptionTypeId = llvm::ConstantExpr::getPtrToInt(biasedExceptionTypeIdAsPointer, llvmContext.iptrType);
         llvm::Constant *exceptionTypeId = llvm::ConstantExpr::getSub(biasedExceptionTypeId, emitLiteral(llvmContext, Uptr(1)));
         moduleContext.exceptionTypeIds.push_back(exceptionTypeId);
     }
 
     // Create a LLVM external global that will point to the ModuleInstance.
-    llvm::Constant *biasedModuleInstanceIdAsPointer = createImportedConstant(outLLVMModule, "biasedModuleInstanceId");
+    llvm::Constant *biasedModuleInstanceIdAsPointer = createImportedConstant(outLLVMModule, externalNamePrefix + "biasedModuleInstanceId");
     llvm::Constant *biasedModuleInstanceId = llvm::ConstantExpr::getPtrToInt(biasedModuleInstanceIdAsPointer, llvmContext.iptrType);
     moduleContext.moduleInstanceId = llvm::ConstantExpr::getSub(biasedModuleInstanceId, emitLiteral(llvmContext, Uptr(1)));
 
     // Create a LLVM external global that will be a bias applied to all references in a table.
-    moduleContext.tableReferenceBias = llvm::ConstantExpr::getPtrToInt(createImportedConstant(outLLVMModule, "tableReferenceBias"), llvmContext.iptrType);
+    moduleContext.tableReferenceBias = llvm::ConstantExpr::getPtrToInt(createImportedConstant(outLLVMModule, externalNamePrefix + "tableReferenceBias"), llvmContext.iptrType);
+
+    // If the code is specialized to an instance, replace the symbols for the instance's bindings
+    // with their values, computed as loadModule would bind the symbols.
+    if (const InstanceConstants *instanceConstants = options.instanceConstants.get()) {
+        errorUnless(instanceConstants->tableIds.size() == irModule.tables.size());
+        errorUnless(instanceConstants->memoryIds.size() == irModule.memories.size());
+        errorUnless(instanceConstants->globalValues.size() == irModule.globals.size());
 
-    moduleContext.userExceptionTypeInfo = llvm::ConstantExpr::getPointerCast(createImportedConstant(outLLVMModule, "userExceptionTypeInfo"), llvmContext.i8PtrType);
+        for (Uptr tableIndex = 0; tableIndex < irModule.tables.size(); ++tableIndex) {
+            moduleContext.tableOffsets[tableIndex] = emitLiteral(llvmContext, Uptr(offsetof(Runtime::CompartmentRuntimeData, tableBases) + sizeof(void *) * instanceConstants->tableIds[tableIndex]));
+        }
+        if (moduleContext.tableOffsets.size()) {
+            moduleContext.defaultTableOffset = moduleContext.tableOffsets[0];
+        }
+        for (Uptr memoryIndex = 0; memoryIndex < irModule.memories.size(); ++memoryIndex) {
+            moduleContext.memoryOffsets[memoryIndex] = emitLiteral(llvmContext, Uptr(offsetof(Runtime::CompartmentRuntimeData, memoryBases) + sizeof(void *) * instanceConstants->memoryIds[memoryIndex]));
+        }
+        if (moduleContext.memoryOffsets.size()) {
+            moduleContext.defaultMemoryOffset = moduleContext.memoryOffsets[0];
+        }
 
-    // Create the LLVM functions.
+        for (const IR::Value &value : instanceConstants->globalValues) {
+            llvm::Constant *constant = nullptr;
+            switch (value.type) {
+                case ValueType::i32:
+                    constant = emitLiteral(llvmContext, value.i32);
+                    break;
+                case ValueType::i64:
+                    constant = emitLiteral(llvmContext, value.i64);
+                    break;
+                case ValueType::f32:
+                    constant = emitLiteral(llvmContext, value.f32);
+                    break;
+                case ValueType::f64:
+                    constant = emitLiteral(llvmContext, value.f64);
+                    break;
+                case ValueType::v128:
+                    constant = emitLiteral(llvmContext, value.v128);
+                    break;
+                default:
+                    break;
+            }
+            moduleContext.globalConstants.push_back(constant);
+        }
+
+        wavmAssert(instanceConstants->moduleInstanceId != UINTPTR_MAX);
+        moduleContext.moduleInstanceId = emitLiteral(llvmContext, instanceConstants->moduleInstanceId);
+        moduleContext.tableReferenceBias = emitLiteral(llvmContext, instanceConstants->tableReferenceBias);
+    }
+
+    llvm::GlobalVariable *userExceptionTypeInfo = outLLVMModule.getNamedGlobal("userExceptionTypeInfo");
+    moduleContext.userExceptionTypeInfo = llvm::ConstantExpr::getPointerCast(userExceptionTypeInfo ? userExceptionTypeInfo : createImportedConstant(outLLVMModule, "userExceptionTypeInfo"), llvmContext.i8PtrType);
+
+    // Create the LLVM functions. A function import that is resolved to a definition of a linked
+    // module refers to the copy of the definition that emitLinkedModule emitted.
     moduleContext.functions.resize(irModule.functions.size());
     for (Uptr functionIndex = 0; functionIndex < irModule.functions.size(); ++functionIndex) {
         FunctionType functionType = irModule.types[irModule.functions.getType(functionIndex).index];
 
+        if (!linkedFunctionDefs && functionIndex < options.linkedFunctionImports.size() &&
+            options.linkedFunctionImports[functionIndex].linkedModuleIndex != UINTPTR_MAX) {
+            const LinkedFunctionImport &linkedImport = options.linkedFunctionImports[functionIndex];
+            llvm::Function *function = outLLVMModule.getFunction(getLinkedModuleNamePrefix(linkedImport.linkedModuleIndex) + getExternalName("functionDef", linkedImport.functionDefIndex));
+            errorUnless(function && function->getFunctionType() == asLLVMType(llvmContext, functionType, CallingConvention::wasm));
+            moduleContext.functions[functionIndex] = function;
+            continue;
+        }
+
         llvm::Function *function = llvm::Function::Create(asLLVMType(llvmContext, functionType, CallingConvention::wasm), llvm::Function::ExternalLinkage,
-                                                          functionIndex >=
+                                                          externalNamePrefix + (functionIndex >=
                                                           irModule.functions.imports.size() ? getExternalName("functionDef",
                                                                                                               functionIndex -
-                                                                                                              irModule.functions.imports.size()) : getExternalName("functionImport", functionIndex), &outLLVMModule);
+                                                                                                              irModule.functions.imports.size()) : getExternalName("functionImport", functionIndex)), &outLLVMModule);
         function->setCallingConv(asLLVMCallingConv(CallingConvention::wasm));
         moduleContext.functions[functionIndex] = function;
     }
 
-    // Compile each function in the module.
-    for (Uptr functionDefIndex = 0; functionDefIndex < irModule.functions.defs.size(); ++functionDefIndex) {
+    // Find the function definitions that call_indirect may speculatively call: for each function
+    // type, the function referenced by the elem segments if it's the only one of that type. The
+    // speculation is checked by each call, so it's safe if the table is imported, or holds other
+    // functions set by the host or the module's code.
+    {
+        HashMap<FunctionType, Uptr> elemFunctionByType;
+        for (const ElemSegment &elemSegment : irModule.elemSegments) {
+            for (Uptr functionIndex : elemSegment.indices) {
+                const FunctionType functionType = irModule.types[irModule.functions.getType(functionIndex).index];
+                Uptr &elemFunctionIndex = elemFunctionByType.getOrAdd(functionType, functionIndex);
+                if (elemFunctionIndex != functionIndex) {
+                    elemFunctionIndex = UINTPTR_MAX;
+                }
+            }
+        }
+
+        moduleContext.speculativeCallIndirectTargets.resize(irModule.types.size(), UINTPTR_MAX);
+        for (Uptr typeIndex = 0; typeIndex < irModule.types.size(); ++typeIndex) {
+            const Uptr *elemFunctionIndex = elemFunctionByType.get(irModule.types[typeIndex]);
+            if (elemFunctionIndex && *elemFunctionIndex != UINTPTR_MAX &&
+                *elemFunctionIndex >= irModule.functions.imports.size()) {
+                moduleContext.speculativeCallIndirectTargets[typeIndex] = *elemFunctionIndex;
+            }
+        }
+    }
+
+    // Mark the small function definitions that are only reachable through direct calls for inlining.
+    // Exported functions, functions referenced by elem segments, and the start function may also be
+    // called through their Runtime::Function, so inlining them would duplicate code that is still
+    // needed. Every definition keeps its external symbol and prefix data, since the runtime binds a
+    // Runtime::Function to each of them, so an inlined function is only a copy of its body. Lazily
+    // compiled and interpreter stubs aren't inlined, since they only forward the call.
+    if (!options.enableLazyCompilation && !options.enableInterpreter) {
+        std::vector<bool> isEscapingFunction(irModule.functions.size(), false);
+        for (const Export &exportIt : irModule.exports) {
+            if (exportIt.kind == ExternKind::function) {
+                isEscapingFunction[exportIt.index] = true;
+            }
+        }
+        for (const ElemSegment &elemSegment : irModule.elemSegments) {
+            for (Uptr functionIndex : elemSegment.indices) {
+                isEscapingFunction[functionIndex] = true;
+            }
+        }
+        if (irModule.startFunctionIndex != UINTPTR_MAX) {
+            isEscapingFunction[irModule.startFunctionIndex] = true;
+        }
+
+        for (Uptr functionDefIndex = beginFunctionDefIndex; functionDefIndex < endFunctionDefIndex; ++functionDefIndex) {
+            const Uptr functionIndex = irModule.functions.imports.size() + functionDefIndex;
+            if (!isEscapingFunction[functionIndex] &&
+                irModule.functions.defs[functionDefIndex].code.size() <= maxInlinedFunctionCodeBytes) {
+                moduleContext.functions[functionIndex]->addFnAttr(llvm::Attribute::AlwaysInline);
+            }
+        }
+    }
+
+    // Compile each function in the module's partition. Functions outside the partition are left as
+    // external declarations.
+    for (Uptr functionDefIndex = beginFunctionDefIndex; functionDefIndex < endFunctionDefIndex; ++functionDefIndex) {
+        if (linkedFunctionDefs && !(*linkedFunctionDefs)[functionDefIndex]) {
+            continue;
+        }
         const FunctionDef &functionDef = irModule.functions.defs[functionDefIndex];
         llvm::Function *function = moduleContext.functions[irModule.functions.imports.size() + functionDefIndex];
 
         function->setPersonalityFn(personalityFunction);
+        if (options.enableFramePointers) {
+#if LLVM_VERSION_MAJOR >= 8
+            function->addFnAttr("frame-pointer", "all");
+#else
+            function->addFnAttr("no-frame-pointer-elim", "true");
+#endif
+        }
 
-        llvm::Constant *functionDefMutableData = createImportedConstant(outLLVMModule, getExternalName("functionDefMutableDatas", functionDefIndex));
+        llvm::Constant *functionDefMutableData = createImportedConstant(outLLVMModule, externalNamePrefix + getExternalName("functionDefMutableDatas", functionDefIndex));
         llvm::Constant *functionDefMutableDataAsIptr = llvm::ConstantExpr::getPtrToInt(functionDefMutableData, llvmContext.iptrType);
 
         setRuntimeFunctionPrefix(llvmContext, function, functionDefMutableDataAsIptr, moduleContext.moduleInstanceId, moduleContext.typeIds[functionDef.type.index]);
 
-        EmitFunctionContext(llvmContext, moduleContext, irModule, functionDef, function).emit();
+        // The profiled call count scales the block frequencies that LLVM derives from the branch
+        // weights, so the optimizer can compare the hotness of code in different functions.
+        if (options.profile && functionDefIndex < options.profile->functionDefs.size()) {
+            const U64 numCalls = options.profile->functionDefs[functionDefIndex].numCalls;
+#if LLVM_VERSION_MAJOR >= 8
+            function->setEntryCount(llvm::Function::ProfileCount(numCalls, llvm::Function::PCT_Real));
+#else
+            function->setEntryCount(numCalls);
+#endif
+        }
+
+        const U64 emitStartTime = outFunctionStats ? Platform::getMonotonicClock() : 0;
+        EmitFunctionContext(llvmContext, moduleContext, irModule, functionDefIndex, functionDefMutableData, function).emit();
+        if (outFunctionStats) {
+            outFunctionStats[functionDefIndex - beginFunctionDefIndex].emitMicroseconds = Platform::getMonotonicClock() - emitStartTime;
+        }
+
+        // A linked module's definition is only a copy for the inliner: calls that aren't inlined
+        // call the definition in the linked module's instance, which the symbol is bound to.
+        if (linkedFunctionDefs) {
+            function->setLinkage(llvm::GlobalValue::AvailableExternallyLinkage);
+        }
+    }
+
+    // Lay out the function definitions by their profiled call counts. The code generator emits
+    // functions in the order of the module's function list, so move the definitions to the end of
+    // the list from the most to the least called. The functions that weren't called are marked cold,
+    // which puts them in the .text.unlikely section on ELF targets, and lets the optimizer treat the
+    // paths that call them as unlikely. Without explicit call counts, the profile's are used.
+    std::vector<U64> profileCallCounts;
+    if (!options.functionDefCallCounts.size() && options.profile) {
+        for (const FunctionProfile &functionProfile : options.profile->functionDefs) {
+            profileCallCounts.push_back(functionProfile.numCalls);
+        }
+    }
+    const std::vector<U64> &callCounts = options.functionDefCallCounts.size() ? options.functionDefCallCounts : profileCallCounts;
+    if (callCounts.size()) {
+        std::vector<Uptr> layoutFunctionDefIndices;
+        for (Uptr functionDefIndex = beginFunctionDefIndex; functionDefIndex < endFunctionDefIndex; ++functionDefIndex) {
+            layoutFunctionDefIndices.push_back(functionDefIndex);
+        }
+        std::stable_sort(layoutFunctionDefIndices.begin(), layoutFunctionDefIndices.end(), [&callCounts](Uptr a, Uptr b) {
+            return (a < callCounts.size() ? callCounts[a] : 0) > (b < callCounts.size() ? callCounts[b] : 0);
+        });
+
+        for (Uptr functionDefIndex : layoutFunctionDefIndices) {
+            llvm::Function *function = moduleContext.functions[irModule.functions.imports.size() + functionDefIndex];
+            if (functionDefIndex < callCounts.size() && !callCounts[functionDefIndex]) {
+                function->addFnAttr(llvm::Attribute::Cold);
+                function->setSectionPrefix(".unlikely");
+            }
+            function->removeFromParent();
+            outLLVMModule.getFunctionList().push_back(function);
+        }
     }
 
     // Finalize the debug info.
     moduleContext.diBuilder.finalize();
 }
+
+void LLVMJIT::emitModule(const IR::Module &irModule, const CompileOptions &options, LLVMContext &llvmContext, llvm::Module &outLLVMModule, Uptr beginFunctionDefIndex, Uptr endFunctionDefIndex, DeferredCodeValidationState *deferredCodeValidationState, FunctionCompileStats *outFunctionStats) {
+    emitModuleImpl(irModule, options, llvmContext, outLLVMModule, beginFunctionDefIndex, endFunctionDefIndex, deferredCodeValidationState, outFunctionStats, std::string(), nullptr);
+}
+
+void LLVMJIT::emitLinkedModule(const IR::Module &irModule, const CompileOptions &options, LLVMContext &llvmContext, llvm::Module &outLLVMModule, Uptr linkedModuleIndex, const std::vector<bool> &emittedFunctionDefs) {
+    wavmAssert(emittedFunctionDefs.size() == irModule.functions.defs.size());
+    emitModuleImpl(irModule, options, llvmContext, outLLVMModule, 0, irModule.functions.defs.size(), nullptr, nullptr, getLinkedModuleNamePrefix(linkedModuleIndex), &emittedFunctionDefs);
+}
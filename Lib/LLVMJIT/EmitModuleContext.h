@@ -22,6 +22,20 @@ namespace WAVM {
             std::vector<llvm::Constant *> globals;
             std::vector<llvm::Constant *> exceptionTypeIds;
 
+            // The prefix of the module's external symbols: empty, unless the module is a linked module
+            // whose code is compiled into another module.
+            std::string externalNamePrefix;
+
+            // The values of the immutable globals that the code is specialized to, indexed by global
+            // index, or null for the globals that aren't constant. Empty if the code isn't
+            // specialized to an instance.
+            std::vector<llvm::Constant *> globalConstants;
+
+            // For each type index, the only function definition of that type that is referenced by
+            // the module's elem segments, or UINTPTR_MAX if there isn't exactly one. call_indirect
+            // speculates that it calls this function, and calls it directly if it does.
+            std::vector<Uptr> speculativeCallIndirectTargets;
+
             llvm::Constant *defaultMemoryOffset;
             llvm::Constant *defaultTableOffset;
 
@@ -30,6 +44,49 @@ namespace WAVM {
 
             llvm::Constant *userExceptionTypeInfo;
 
+            // If non-zero, functions are emitted with a prologue that counts calls, and requests
+            // that the function be recompiled after this many calls.
+            Uptr tierUpCallThreshold;
+
+            // If true, function definitions are emitted as stubs that compile the function on their
+            // first call.
+            bool enableLazyCompilation;
+
+            // If true, function definitions are emitted as stubs that call the interpreter until
+            // the function has compiled code.
+            bool enableInterpreter;
+
+            // If true, memory accesses clamp their address to the memory's reserved bytes.
+            bool explicitMemoryBoundsChecks;
+
+            // If true, function entries and loop back-edges check for interrupt requests.
+            bool enableInterruptChecks;
+
+            // If true, basic blocks subtract their cost from the context's fuel.
+            bool enableFuelMetering;
+
+            // If true, functions count their calls, and if enableCallTiming is also true, the time
+            // spent in them, in their FunctionMutableData's call counters.
+            bool enableCallCounters;
+            bool enableCallTiming;
+
+            // If true, functions count how their branches and call_indirects are executed in their
+            // profile counters.
+            bool enableProfileCounters;
+
+            // If non-null, the profile of a previous run, which is emitted as branch weights and
+            // function entry counts, and chooses the speculative call_indirect targets.
+            const ModuleProfile *profile;
+
+            // If non-null, function definitions are validated as they are emitted, and the state of
+            // the validation that is deferred until the data segments are known is merged into it.
+            IR::DeferredCodeValidationState *deferredCodeValidationState;
+
+            // If non-null, linear memory accesses are non-volatile, and linear memory and runtime
+            // data accesses are tagged with these TBAA access tags, which don't alias each other.
+            llvm::MDNode *linearMemoryTBAATag;
+            llvm::MDNode *runtimeDataTBAATag;
+
             llvm::DIBuilder diBuilder;
             llvm::DICompileUnit *diCompileUnit;
             llvm::DIFile *diModuleScope;
@@ -251,24 +251,63 @@ EMIT_FP_COMPARE(gt, llvm::CmpInst::FCMP_OGT)
 
 EMIT_FP_COMPARE(ge, llvm::CmpInst::FCMP_OGE)
 
-// These operations don't match LLVM's semantics exactly, so just call out to C++ implementations.
-EMIT_FP_BINARY_OP(min, emitRuntimeIntrinsic(type ==
-                                            ValueType::f32 ? "f32.min" : "f64.min", FunctionType(TypeTuple(type), TypeTuple{type, type}), {left, right})[0])
+static llvm::Type *getIntTypeWithSameShape(llvm::Type *type) {
+    // Returns the integer (or integer vector) type that a float (or float vector) may be bitcast to.
+    llvm::Type *scalarIntType = llvm::IntegerType::get(type->getContext(), type->getScalarSizeInBits());
+    return type->isVectorTy() ? llvm::VectorType::get(scalarIntType, type->getVectorNumElements()) : scalarIntType;
+}
+
+static llvm::Value *emitQuietNaN(EmitFunctionContext &functionContext, llvm::Value *value) {
+    // Set the most significant bit of the significand, which turns a signaling NaN into a quiet NaN
+    // with the same payload.
+    llvm::Type *intType = getIntTypeWithSameShape(value->getType());
+    llvm::Value *quietBit = llvm::ConstantInt::get(intType, U64(1) << (value->getType()->getFPMantissaWidth() - 2));
+    llvm::Value *bits = functionContext.irBuilder.CreateBitCast(value, intType);
+    return functionContext.irBuilder.CreateBitCast(functionContext.irBuilder.CreateOr(bits, quietBit), value->getType());
+}
+
+static llvm::Value *emitFloatMinOrMax(EmitFunctionContext &functionContext, llvm::Value *left, llvm::Value *right, bool isMax) {
+    // LLVM's minnum/maxnum return the non-NaN operand, and don't order -0 and +0, so WebAssembly's
+    // min and max are emitted as a branchless sequence of compares and selects instead. This works
+    // on both scalars and vectors, and lowers to compares, blends, and bitwise ops on any target.
+    llvm::IRBuilder<> &irBuilder = functionContext.irBuilder;
+    const llvm::CmpInst::Predicate predicate = isMax ? llvm::CmpInst::FCMP_OGT : llvm::CmpInst::FCMP_OLT;
+
+    // If the operands are equal, they're either identical or -0 and +0: combine their bits to pick
+    // the sign bit of whichever zero is the min or max.
+    llvm::Type *intType = getIntTypeWithSameShape(left->getType());
+    llvm::Value *leftBits = irBuilder.CreateBitCast(left, intType);
+    llvm::Value *rightBits = irBuilder.CreateBitCast(right, intType);
+    llvm::Value *equalResult = irBuilder.CreateBitCast(isMax ? irBuilder.CreateAnd(leftBits, rightBits) : irBuilder.CreateOr(leftBits, rightBits), left->getType());
+
+    llvm::Value *result = irBuilder.CreateSelect(createFCmpWithWorkaround(irBuilder, predicate, right, left), right, equalResult);
+    result = irBuilder.CreateSelect(createFCmpWithWorkaround(irBuilder, predicate, left, right), left, result);
+
+    // If either operand is a NaN, return it as a quiet NaN, preferring the left operand.
+    llvm::Value *nanResult = irBuilder.CreateSelect(createFCmpWithWorkaround(irBuilder, llvm::CmpInst::FCMP_UNO, left, left), emitQuietNaN(functionContext, left), emitQuietNaN(functionContext, right));
+    return irBuilder.CreateSelect(createFCmpWithWorkaround(irBuilder, llvm::CmpInst::FCMP_UNO, left, right), nanResult, result);
+}
+
+static llvm::Value *emitFloatRounding(EmitFunctionContext &functionContext, llvm::Intrinsic::ID id, llvm::Value *operand) {
+    // LLVM's rounding intrinsics leave it unspecified whether a signaling NaN operand is quieted,
+    // so explicitly return a NaN operand as a quiet NaN.
+    llvm::Value *result = functionContext.callLLVMIntrinsic({operand->getType()}, id, {operand});
+    llvm::Value *isNaN = createFCmpWithWorkaround(functionContext.irBuilder, llvm::CmpInst::FCMP_UNO, operand, operand);
+    return functionContext.irBuilder.CreateSelect(isNaN, emitQuietNaN(functionContext, operand), result);
+}
+
+EMIT_FP_BINARY_OP(min, emitFloatMinOrMax(*this, left, right, false))
 
-EMIT_FP_BINARY_OP(max, emitRuntimeIntrinsic(type ==
-                                            ValueType::f32 ? "f32.max" : "f64.max", FunctionType(TypeTuple(type), TypeTuple{type, type}), {left, right})[0])
+EMIT_FP_BINARY_OP(max, emitFloatMinOrMax(*this, left, right, true))
 
-EMIT_FP_UNARY_OP(ceil, emitRuntimeIntrinsic(
-        type == ValueType::f32 ? "f32.ceil" : "f64.ceil", FunctionType(TypeTuple(type), TypeTuple{type}), {operand})[0])
+EMIT_FP_UNARY_OP(ceil, emitFloatRounding(*this, llvm::Intrinsic::ceil, operand))
 
-EMIT_FP_UNARY_OP(floor, emitRuntimeIntrinsic(type ==
-                                             ValueType::f32 ? "f32.floor" : "f64.floor", FunctionType(TypeTuple(type), TypeTuple{type}), {operand})[0])
+EMIT_FP_UNARY_OP(floor, emitFloatRounding(*this, llvm::Intrinsic::floor, operand))
 
-EMIT_FP_UNARY_OP(trunc, emitRuntimeIntrinsic(type ==
-                                             ValueType::f32 ? "f32.trunc" : "f64.trunc", FunctionType(TypeTuple(type), TypeTuple{type}), {operand})[0])
+EMIT_FP_UNARY_OP(trunc, emitFloatRounding(*this, llvm::Intrinsic::trunc, operand))
 
-EMIT_FP_UNARY_OP(nearest, emitRuntimeIntrinsic(type ==
-                                               ValueType::f32 ? "f32.nearest" : "f64.nearest", FunctionType(TypeTuple(type), TypeTuple{type}), {operand})[0])
+// nearbyint rounds to nearest, ties to even, in the default floating-point environment.
+EMIT_FP_UNARY_OP(nearest, emitFloatRounding(*this, llvm::Intrinsic::nearbyint, operand))
 
 EMIT_SIMD_INT_BINARY_OP(add, irBuilder.CreateAdd(left, right))
 
@@ -335,6 +374,25 @@ EMIT_INT_COMPARE(ge_u, llvm::CmpInst::ICMP_UGE)
 
 EMIT_SIMD_INT_UNARY_OP(neg, irBuilder.CreateNeg(operand))
 
+#if LLVM_VERSION_MAJOR >= 8
+// LLVM 8 added target-independent saturating arithmetic intrinsics, which lower to paddsb/paddusb
+// and friends on x86 and to sqadd/uqadd on AArch64.
+EMIT_SIMD_BINARY_OP(i8x16_add_saturate_s, llvmContext.i8x16Type, callLLVMIntrinsic({vectorType}, llvm::Intrinsic::sadd_sat, {left, right}))
+
+EMIT_SIMD_BINARY_OP(i8x16_add_saturate_u, llvmContext.i8x16Type, callLLVMIntrinsic({vectorType}, llvm::Intrinsic::uadd_sat, {left, right}))
+
+EMIT_SIMD_BINARY_OP(i8x16_sub_saturate_s, llvmContext.i8x16Type, callLLVMIntrinsic({vectorType}, llvm::Intrinsic::ssub_sat, {left, right}))
+
+EMIT_SIMD_BINARY_OP(i8x16_sub_saturate_u, llvmContext.i8x16Type, callLLVMIntrinsic({vectorType}, llvm::Intrinsic::usub_sat, {left, right}))
+
+EMIT_SIMD_BINARY_OP(i16x8_add_saturate_s, llvmContext.i16x8Type, callLLVMIntrinsic({vectorType}, llvm::Intrinsic::sadd_sat, {left, right}))
+
+EMIT_SIMD_BINARY_OP(i16x8_add_saturate_u, llvmContext.i16x8Type, callLLVMIntrinsic({vectorType}, llvm::Intrinsic::uadd_sat, {left, right}))
+
+EMIT_SIMD_BINARY_OP(i16x8_sub_saturate_s, llvmContext.i16x8Type, callLLVMIntrinsic({vectorType}, llvm::Intrinsic::ssub_sat, {left, right}))
+
+EMIT_SIMD_BINARY_OP(i16x8_sub_saturate_u, llvmContext.i16x8Type, callLLVMIntrinsic({vectorType}, llvm::Intrinsic::usub_sat, {left, right}))
+#else
 static llvm::Value *emitAddUnsignedSaturated(llvm::IRBuilder<> &irBuilder, llvm::Value *left, llvm::Value *right, llvm::Type *type) {
     left = irBuilder.CreateBitCast(left, type);
     right = irBuilder.CreateBitCast(right, type);
@@ -363,6 +421,7 @@ EMIT_SIMD_BINARY_OP(i16x8_add_saturate_u, llvmContext.i16x8Type, emitAddUnsigned
 EMIT_SIMD_BINARY_OP(i16x8_sub_saturate_s, llvmContext.i16x8Type, callLLVMIntrinsic({}, llvm::Intrinsic::x86_sse2_psubs_w, {left, right}))
 
 EMIT_SIMD_BINARY_OP(i16x8_sub_saturate_u, llvmContext.i16x8Type, emitSubUnsignedSaturated(irBuilder, left, right, llvmContext.i16x8Type))
+#endif
 
 llvm::Value *EmitFunctionContext::emitBitSelect(llvm::Value *mask, llvm::Value *trueValue, llvm::Value *falseValue) {
     return irBuilder.CreateOr(irBuilder.CreateAnd(trueValue, mask), irBuilder.CreateAnd(falseValue, irBuilder.CreateNot(mask)));
@@ -399,13 +458,13 @@ EMIT_SIMD_FP_BINARY_OP(mul, irBuilder.CreateFMul(left, right))
 
 EMIT_SIMD_FP_BINARY_OP(div, irBuilder.CreateFDiv(left, right))
 
-EMIT_SIMD_BINARY_OP(f32x4_min, llvmContext.f32x4Type, callLLVMIntrinsic({}, llvm::Intrinsic::x86_sse_min_ps, {left, right}))
+EMIT_SIMD_BINARY_OP(f32x4_min, llvmContext.f32x4Type, emitFloatMinOrMax(*this, left, right, false))
 
-EMIT_SIMD_BINARY_OP(f64x2_min, llvmContext.f64x2Type, callLLVMIntrinsic({}, llvm::Intrinsic::x86_sse2_min_pd, {left, right}))
+EMIT_SIMD_BINARY_OP(f64x2_min, llvmContext.f64x2Type, emitFloatMinOrMax(*this, left, right, false))
 
-EMIT_SIMD_BINARY_OP(f32x4_max, llvmContext.f32x4Type, callLLVMIntrinsic({}, llvm::Intrinsic::x86_sse_max_ps, {left, right}))
+EMIT_SIMD_BINARY_OP(f32x4_max, llvmContext.f32x4Type, emitFloatMinOrMax(*this, left, right, true))
 
-EMIT_SIMD_BINARY_OP(f64x2_max, llvmContext.f64x2Type, callLLVMIntrinsic({}, llvm::Intrinsic::x86_sse2_max_pd, {left, right}))
+EMIT_SIMD_BINARY_OP(f64x2_max, llvmContext.f64x2Type, emitFloatMinOrMax(*this, left, right, true))
 
 EMIT_SIMD_FP_UNARY_OP(neg, irBuilder.CreateFNeg(operand))
 
@@ -413,47 +472,36 @@ EMIT_SIMD_FP_UNARY_OP(abs, callLLVMIntrinsic({operand->getType()}, llvm::Intrins
 
 EMIT_SIMD_FP_UNARY_OP(sqrt, callLLVMIntrinsic({operand->getType()}, llvm::Intrinsic::sqrt, {operand}))
 
-static llvm::Value *emitAnyTrue(llvm::IRBuilder<> &irBuilder, llvm::Value *vector, llvm::Type *vectorType) {
-    vector = irBuilder.CreateBitCast(vector, vectorType);
-
-    const U32 numScalarBits = vectorType->getScalarSizeInBits();
-    const Uptr numLanes = vectorType->getVectorNumElements();
-    llvm::Constant *zero = llvm::ConstantInt::get(vectorType->getScalarType(), llvm::APInt(numScalarBits, 0));
-
-    llvm::Value *result = nullptr;
-    for (Uptr laneIndex = 0; laneIndex < numLanes; ++laneIndex) {
-        llvm::Value *scalar = irBuilder.CreateExtractElement(vector, laneIndex);
-        llvm::Value *scalarBool = irBuilder.CreateICmpNE(scalar, zero);
-
-        result = result ? irBuilder.CreateOr(result, scalarBool) : scalarBool;
-    }
-    return irBuilder.CreateZExt(result, llvm::Type::getInt32Ty(irBuilder.getContext()));
+static llvm::Value *emitAnyTrue(llvm::IRBuilder<> &irBuilder, llvm::Value *vector) {
+    // Any lane is non-zero iff the vector as a whole is non-zero, regardless of the lane width.
+    // Compare it as a single 128-bit integer, which lowers to ptest on SSE4.1 and to a
+    // pairwise-max reduction on NEON.
+    llvm::Type *i128Type = llvm::IntegerType::get(irBuilder.getContext(), 128);
+    llvm::Value *isNonZero = irBuilder.CreateICmpNE(irBuilder.CreateBitCast(vector, i128Type), llvm::ConstantInt::get(i128Type, 0));
+    return irBuilder.CreateZExt(isNonZero, llvm::Type::getInt32Ty(irBuilder.getContext()));
 }
 
 static llvm::Value *emitAllTrue(llvm::IRBuilder<> &irBuilder, llvm::Value *vector, llvm::Type *vectorType) {
+    // Compare all lanes against zero at once, and bitcast the resulting lane mask to an integer with
+    // one bit per lane. That lowers to pcmpeq+pmovmskb (or movmskps/movmskpd) on x86, instead of
+    // extracting and testing each lane separately.
     vector = irBuilder.CreateBitCast(vector, vectorType);
 
-    const U32 numScalarBits = vectorType->getScalarSizeInBits();
-    const Uptr numLanes = vectorType->getVectorNumElements();
-    llvm::Constant *zero = llvm::ConstantInt::get(vectorType->getScalarType(), llvm::APInt(numScalarBits, 0));
-
-    llvm::Value *result = nullptr;
-    for (Uptr laneIndex = 0; laneIndex < numLanes; ++laneIndex) {
-        llvm::Value *scalar = irBuilder.CreateExtractElement(vector, laneIndex);
-        llvm::Value *scalarBool = irBuilder.CreateICmpNE(scalar, zero);
-
-        result = result ? irBuilder.CreateAnd(result, scalarBool) : scalarBool;
-    }
-    return irBuilder.CreateZExt(result, llvm::Type::getInt32Ty(irBuilder.getContext()));
+    const U32 numLanes = vectorType->getVectorNumElements();
+    llvm::Value *laneMask = irBuilder.CreateICmpNE(vector, llvm::Constant::getNullValue(vectorType));
+    llvm::Type *laneMaskIntType = llvm::IntegerType::get(irBuilder.getContext(), numLanes);
+    llvm::Value *laneMaskBits = irBuilder.CreateBitCast(laneMask, laneMaskIntType);
+    llvm::Value *isAllTrue = irBuilder.CreateICmpEQ(laneMaskBits, llvm::Constant::getAllOnesValue(laneMaskIntType));
+    return irBuilder.CreateZExt(isAllTrue, llvm::Type::getInt32Ty(irBuilder.getContext()));
 }
 
-EMIT_SIMD_UNARY_OP(i8x16_any_true, llvmContext.i8x16Type, emitAnyTrue(irBuilder, operand, llvmContext.i8x16Type))
+EMIT_SIMD_UNARY_OP(i8x16_any_true, llvmContext.i8x16Type, emitAnyTrue(irBuilder, operand))
 
-EMIT_SIMD_UNARY_OP(i16x8_any_true, llvmContext.i16x8Type, emitAnyTrue(irBuilder, operand, llvmContext.i16x8Type))
+EMIT_SIMD_UNARY_OP(i16x8_any_true, llvmContext.i16x8Type, emitAnyTrue(irBuilder, operand))
 
-EMIT_SIMD_UNARY_OP(i32x4_any_true, llvmContext.i32x4Type, emitAnyTrue(irBuilder, operand, llvmContext.i32x4Type))
+EMIT_SIMD_UNARY_OP(i32x4_any_true, llvmContext.i32x4Type, emitAnyTrue(irBuilder, operand))
 
-EMIT_SIMD_UNARY_OP(i64x2_any_true, llvmContext.i64x2Type, emitAnyTrue(irBuilder, operand, llvmContext.i64x2Type))
+EMIT_SIMD_UNARY_OP(i64x2_any_true, llvmContext.i64x2Type, emitAnyTrue(irBuilder, operand))
 
 EMIT_SIMD_UNARY_OP(i8x16_all_true, llvmContext.i8x16Type, emitAllTrue(irBuilder, operand, llvmContext.i8x16Type))
 
@@ -5,6 +5,7 @@ PUSH_DISABLE_WARNINGS_FOR_LLVM_HEADERS
 
 POP_DISABLE_WARNINGS_FOR_LLVM_HEADERS
 
+using namespace WAVM;
 using namespace WAVM::IR;
 using namespace WAVM::LLVMJIT;
 
@@ -29,7 +30,43 @@ void EmitFunctionContext::ref_func(FunctionImm imm) {
 
 void EmitFunctionContext::table_get(TableImm imm) {
     llvm::Value *index = pop();
-    llvm::Value *result = emitRuntimeIntrinsic("table.get", FunctionType({ValueType::anyref}, TypeTuple({ValueType::i32, inferValueType<Uptr>()})), {index, getTableIdFromOffset(llvmContext, moduleContext.tableOffsets[imm.tableIndex])})[0];
+    llvm::Constant *tableOffset = moduleContext.tableOffsets[imm.tableIndex];
+
+    // The table's size follows the table bases in CompartmentRuntimeData. It only increases while
+    // the code can access the table, so reading a stale value just takes the out-of-line path.
+    llvm::Constant *numElementsOffset = llvm::ConstantExpr::getAdd(tableOffset, emitLiteral(llvmContext, Uptr(Runtime::maxTables * sizeof(void *))));
+    llvm::LoadInst *tableNumElements = loadRuntimeData(irBuilder.CreateInBoundsGEP(getCompartmentAddress(), {numElementsOffset}), llvmContext.iptrType, sizeof(Uptr));
+    tableNumElements->setAtomic(llvm::AtomicOrdering::Monotonic);
+
+    llvm::Value *indexZExt = zext(index, llvmContext.iptrType);
+    llvm::BasicBlock *inBoundsBlock = llvm::BasicBlock::Create(llvmContext, "tableGetInBounds", function);
+    llvm::BasicBlock *outOfBoundsBlock = llvm::BasicBlock::Create(llvmContext, "tableGetOutOfBounds", function);
+    llvm::BasicBlock *endBlock = llvm::BasicBlock::Create(llvmContext, "tableGetEnd", function);
+    irBuilder.CreateCondBr(irBuilder.CreateICmpULT(indexZExt, tableNumElements), inBoundsBlock, outOfBoundsBlock, moduleContext.likelyTrueBranchWeights);
+
+    // Load the element from the table, and translate its biased value to a reference. A biased value
+    // of zero is the uninitialized sentinel, which is null.
+    irBuilder.SetInsertPoint(inBoundsBlock);
+    llvm::Value *tableBasePointer = loadRuntimeData(irBuilder.CreateInBoundsGEP(getCompartmentAddress(), {tableOffset}), llvmContext.iptrType->getPointerTo(), sizeof(Uptr));
+    llvm::LoadInst *biasedValueLoad = irBuilder.CreateLoad(irBuilder.CreateInBoundsGEP(tableBasePointer, {indexZExt}));
+    biasedValueLoad->setAtomic(llvm::AtomicOrdering::Acquire);
+    biasedValueLoad->setAlignment(sizeof(Uptr));
+    llvm::Value *element = irBuilder.CreateIntToPtr(irBuilder.CreateAdd(biasedValueLoad, moduleContext.tableReferenceBias), llvmContext.anyrefType);
+    llvm::Value *inBoundsResult = irBuilder.CreateSelect(irBuilder.CreateICmpEQ(biasedValueLoad, llvm::ConstantInt::get(llvmContext.iptrType, 0)), llvm::Constant::getNullValue(llvmContext.anyrefType), element);
+    llvm::BasicBlock *inBoundsEndBlock = irBuilder.GetInsertBlock();
+    irBuilder.CreateBr(endBlock);
+
+    // Call the intrinsic to trap, or to read the element if the table grew since its size was read.
+    irBuilder.SetInsertPoint(outOfBoundsBlock);
+    llvm::Value *outOfBoundsResult = emitRuntimeIntrinsic("table.get", FunctionType({ValueType::anyref}, TypeTuple({ValueType::i32, inferValueType<Uptr>()})), {index, getTableIdFromOffset(llvmContext, tableOffset)})[0];
+    outOfBoundsResult = irBuilder.CreatePointerCast(outOfBoundsResult, llvmContext.anyrefType);
+    llvm::BasicBlock *outOfBoundsEndBlock = irBuilder.GetInsertBlock();
+    irBuilder.CreateBr(endBlock);
+
+    irBuilder.SetInsertPoint(endBlock);
+    llvm::PHINode *result = irBuilder.CreatePHI(llvmContext.anyrefType, 2);
+    result->addIncoming(inBoundsResult, inBoundsEndBlock);
+    result->addIncoming(outOfBoundsResult, outOfBoundsEndBlock);
     push(result);
 }
 
@@ -15,6 +15,15 @@ using namespace WAVM::LLVMJIT;
 
 void EmitFunctionContext::get_local(GetOrSetVariableImm<false> imm) {
     wavmAssert(imm.variableIndex < localPointers.size());
+    if (knownLocalValues.size()) {
+        KnownLocalValue &knownValue = knownLocalValues[imm.variableIndex];
+        if (!knownValue.value || (knownValue.block && knownValue.block != irBuilder.GetInsertBlock())) {
+            knownValue.value = irBuilder.CreateLoad(localPointers[imm.variableIndex]);
+            knownValue.block = irBuilder.GetInsertBlock();
+        }
+        push(knownValue.value);
+        return;
+    }
     push(irBuilder.CreateLoad(localPointers[imm.variableIndex]));
 }
 
@@ -22,12 +31,18 @@ void EmitFunctionContext::set_local(GetOrSetVariableImm<false> imm) {
     wavmAssert(imm.variableIndex < localPointers.size());
     auto value = irBuilder.CreateBitCast(pop(), localPointers[imm.variableIndex]->getType()->getPointerElementType());
     irBuilder.CreateStore(value, localPointers[imm.variableIndex]);
+    if (knownLocalValues.size()) {
+        knownLocalValues[imm.variableIndex] = {value, irBuilder.GetInsertBlock()};
+    }
 }
 
 void EmitFunctionContext::tee_local(GetOrSetVariableImm<false> imm) {
     wavmAssert(imm.variableIndex < localPointers.size());
     auto value = irBuilder.CreateBitCast(getValueFromTop(), localPointers[imm.variableIndex]->getType()->getPointerElementType());
     irBuilder.CreateStore(value, localPointers[imm.variableIndex]);
+    if (knownLocalValues.size()) {
+        knownLocalValues[imm.variableIndex] = {value, irBuilder.GetInsertBlock()};
+    }
 }
 
 //
@@ -45,7 +60,10 @@ void EmitFunctionContext::get_global(GetOrSetVariableImm<true> imm) {
         // ContextRuntimeData::globalData that its value is stored at.
         llvm::Value *globalDataOffset = irBuilder.CreatePtrToInt(moduleContext.globals[imm.variableIndex], llvmContext.iptrType);
         llvm::Value *globalPointer = irBuilder.CreateInBoundsGEP(irBuilder.CreateLoad(contextPointerVariable), {globalDataOffset});
-        value = loadFromUntypedPointer(globalPointer, llvmValueType, getTypeByteWidth(globalType.valueType));
+        value = loadRuntimeData(globalPointer, llvmValueType, getTypeByteWidth(globalType.valueType));
+    } else if (moduleContext.globalConstants.size() && moduleContext.globalConstants[imm.variableIndex]) {
+        // If the code is specialized to an instance, emit the instance's value of the global.
+        value = moduleContext.globalConstants[imm.variableIndex];
     } else {
         // If the value is an immutable global definition with a literal value, emit the literal.
         if (irModule.globals.isDef(imm.variableIndex)) {
@@ -77,7 +95,7 @@ void EmitFunctionContext::get_global(GetOrSetVariableImm<true> imm) {
 
         if (!value) {
             // Otherwise, the symbol's value will point to the global's immutable value.
-            value = loadFromUntypedPointer(moduleContext.globals[imm.variableIndex], llvmValueType, getTypeByteWidth(globalType.valueType));
+            value = loadRuntimeData(moduleContext.globals[imm.variableIndex], llvmValueType, getTypeByteWidth(globalType.valueType));
         }
     }
 
@@ -96,5 +114,5 @@ void EmitFunctionContext::set_global(GetOrSetVariableImm<true> imm) {
     // ContextRuntimeData::globalData that its value is stored at.
     llvm::Value *globalDataOffset = irBuilder.CreatePtrToInt(moduleContext.globals[imm.variableIndex], llvmContext.iptrType);
     llvm::Value *globalPointer = irBuilder.CreateInBoundsGEP(irBuilder.CreateLoad(contextPointerVariable), {globalDataOffset});
-    storeToUntypedPointer(value, globalPointer);
+    storeRuntimeData(value, globalPointer);
 }
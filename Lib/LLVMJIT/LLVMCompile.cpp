@@ -1,15 +1,27 @@
 #include <string.h>
+#include <algorithm>
+#include <atomic>
 #include <memory>
 #include <system_error>
+#include <thread>
 #include <vector>
 
 #include "LLVMJITPrivate.h"
+#include "WAVM/Inline/Lock.h"
+#include "WAVM/Inline/ParallelFor.h"
+#include "WAVM/Platform/Clock.h"
+#include "WAVM/Platform/Mutex.h"
 #include "iostream"
 
 PUSH_DISABLE_WARNINGS_FOR_LLVM_HEADERS
+#include "llvm/Analysis/TargetTransformInfo.h"
 #include "llvm/ExecutionEngine/ExecutionEngine.h"
 #include "llvm/IR/LegacyPassManager.h"
 #include "llvm/IR/Verifier.h"
+#include "llvm/Object/SymbolSize.h"
+#include "llvm/Transforms/IPO.h"
+#include "llvm/Transforms/IPO/AlwaysInliner.h"
+#include "llvm/Transforms/IPO/PassManagerBuilder.h"
 #include "llvm/Transforms/Scalar.h"
 
 #if LLVM_VERSION_MAJOR >= 7
@@ -38,7 +50,7 @@ using namespace WAVM;
 using namespace WAVM::IR;
 using namespace WAVM::LLVMJIT;
 
-static Uptr printedModuleId = 0;
+static std::atomic<Uptr> printedModuleId{0};
 
 static void printModule(const llvm::Module &llvmModule, const char *filename) {
     std::error_code errorCode;
@@ -82,34 +94,254 @@ private:
     std::vector<U8> output;
 };
 
-static void optimizeLLVMModule(llvm::Module &llvmModule, bool shouldLogMetrics) {
+// If the name is the symbol of a function definition in the range [beginFunctionDefIndex,
+// endFunctionDefIndex), returns its index relative to beginFunctionDefIndex. The symbols in the
+// object file may have the leading underscore that Mach-O and Win32 add to C symbols.
+static bool getFunctionDefStatsIndex(llvm::StringRef name, bool allowUnderscorePrefix, Uptr beginFunctionDefIndex, Uptr endFunctionDefIndex, Uptr &outStatsIndex) {
+    if (allowUnderscorePrefix && name.startswith("_")) {
+        name = name.drop_front(1);
+    }
+    U64 functionDefIndex;
+    if (!name.startswith("functionDef") || name.drop_front(strlen("functionDef")).getAsInteger(10, functionDefIndex) || functionDefIndex < beginFunctionDefIndex || functionDefIndex >= endFunctionDefIndex) {
+        return false;
+    }
+    outStatsIndex = Uptr(functionDefIndex - beginFunctionDefIndex);
+    return true;
+}
+
+static Uptr getNumInstructions(const llvm::Function &function) {
+    Uptr numInstructions = 0;
+    for (const llvm::BasicBlock &block : function) {
+        numInstructions += block.size();
+    }
+    return numInstructions;
+}
+
+static void optimizeLLVMModule(llvm::Module &llvmModule, llvm::TargetMachine *targetMachine, OptimizationLevel optimizationLevel, bool shouldLogMetrics, CompileStats *outStats, Uptr beginFunctionDefIndex) {
     llvm::legacy::FunctionPassManager fpm(&llvmModule);
-    fpm.add(llvm::createPromoteMemoryToRegisterPass());
-    fpm.add(llvm::createInstructionNamerPass());
-    fpm.add(llvm::createCFGSimplificationPass());
-    fpm.add(llvm::createJumpThreadingPass());
-    fpm.add(llvm::createConstantPropagationPass());
+    llvm::legacy::PassManager mpm;
+    bool useModulePasses = false;
+    switch (optimizationLevel) {
+        case OptimizationLevel::O0:
+            // The emitted code keeps locals in allocas, so even an unoptimized module needs them
+            // promoted to SSA values to avoid generating a load and store for every access.
+            fpm.add(llvm::createPromoteMemoryToRegisterPass());
+            break;
+
+        case OptimizationLevel::O1:
+            fpm.add(llvm::createPromoteMemoryToRegisterPass());
+            fpm.add(llvm::createInstructionNamerPass());
+            fpm.add(llvm::createCFGSimplificationPass());
+            fpm.add(llvm::createJumpThreadingPass());
+            fpm.add(llvm::createConstantPropagationPass());
+
+            // Inline the small functions emitModule marked as alwaysinline. The O2 and O3 inliner
+            // inlines them too, along with any other calls its cost model considers profitable.
+            mpm.add(llvm::createAlwaysInlinerLegacyPass());
+            useModulePasses = true;
+            break;
+
+        case OptimizationLevel::O2:
+        case OptimizationLevel::O3: {
+            const unsigned optLevel = optimizationLevel == OptimizationLevel::O3 ? 3 : 2;
+
+            llvm::PassManagerBuilder passManagerBuilder;
+            passManagerBuilder.OptLevel = optLevel;
+            passManagerBuilder.SizeLevel = 0;
+            passManagerBuilder.Inliner = llvm::createFunctionInliningPass(optLevel, 0, false);
+            passManagerBuilder.LoopVectorize = true;
+            passManagerBuilder.SLPVectorize = optLevel >= 3;
+            targetMachine->adjustPassManager(passManagerBuilder);
+
+            // Let the passes query the target's costs, which the vectorizers and LICM depend on.
+            fpm.add(llvm::createTargetTransformInfoWrapperPass(targetMachine->getTargetIRAnalysis()));
+            mpm.add(llvm::createTargetTransformInfoWrapperPass(targetMachine->getTargetIRAnalysis()));
+
+            passManagerBuilder.populateFunctionPassManager(fpm);
+            passManagerBuilder.populateModulePassManager(mpm);
+            useModulePasses = true;
+            break;
+        }
+
+        default:
+            Errors::unreachable();
+    };
+
+    const U64 optimizeStartTime = outStats ? Platform::getMonotonicClock() : 0;
     fpm.doInitialization();
     for (auto functionIt = llvmModule.begin(); functionIt != llvmModule.end(); ++functionIt) {
+        const U64 functionStartTime = outStats ? Platform::getMonotonicClock() : 0;
         fpm.run(*functionIt);
+
+        Uptr statsIndex;
+        if (outStats && getFunctionDefStatsIndex(functionIt->getName(), false, beginFunctionDefIndex, beginFunctionDefIndex + outStats->functionDefs.size(), statsIndex)) {
+            outStats->functionDefs[statsIndex].optimizeMicroseconds = Platform::getMonotonicClock() - functionStartTime;
+        }
+    }
+    fpm.doFinalization();
+
+    if (useModulePasses) {
+        mpm.run(llvmModule);
+    }
+    if (outStats) {
+        outStats->optimizeMicroseconds += Platform::getMonotonicClock() - optimizeStartTime;
+    }
+}
+
+// Adds the size of each function definition's machine code in an object file to the stats.
+static void addMachineCodeStats(const std::vector<U8> &objectBytes, Uptr beginFunctionDefIndex, CompileStats &outStats) {
+    llvm::Expected<std::unique_ptr<llvm::object::ObjectFile>> object = llvm::object::ObjectFile::createObjectFile(llvm::MemoryBufferRef(llvm::StringRef((const char *) objectBytes.data(), objectBytes.size()), "memory"));
+    if (!object) {
+        llvm::consumeError(object.takeError());
+        return;
+    }
+
+    for (std::pair<llvm::object::SymbolRef, U64> symbolSizePair : llvm::object::computeSymbolSizes(**object)) {
+        llvm::Expected<llvm::object::SymbolRef::Type> type = symbolSizePair.first.getType();
+        if (!type || *type != llvm::object::SymbolRef::ST_Function) {
+            if (!type) {
+                llvm::consumeError(type.takeError());
+            }
+            continue;
+        }
+        llvm::Expected<llvm::StringRef> name = symbolSizePair.first.getName();
+        if (!name) {
+            llvm::consumeError(name.takeError());
+            continue;
+        }
+
+        Uptr statsIndex;
+        if (getFunctionDefStatsIndex(*name, true, beginFunctionDefIndex, beginFunctionDefIndex + outStats.functionDefs.size(), statsIndex)) {
+            outStats.functionDefs[statsIndex].numMachineCodeBytes = Uptr(symbolSizePair.second);
+        }
     }
 }
 
-std::vector<U8> LLVMJIT::compileLLVMModule(LLVMContext &llvmContext, llvm::Module &&llvmModule, bool shouldLogMetrics) {
+static llvm::CodeGenOpt::Level getCodeGenOptLevel(OptimizationLevel optimizationLevel) {
+    switch (optimizationLevel) {
+        case OptimizationLevel::O0:
+            return llvm::CodeGenOpt::None;
+        case OptimizationLevel::O1:
+        case OptimizationLevel::O2:
+            return llvm::CodeGenOpt::Default;
+        case OptimizationLevel::O3:
+            return llvm::CodeGenOpt::Aggressive;
+        default:
+            Errors::unreachable();
+    };
+}
+
+static std::string getTargetTriple() {
     auto targetTriple = llvm::sys::getProcessTriple();
 #ifdef __APPLE__
     // Didn't figure out exactly why, but this works around a problem with the MacOS dynamic loader.
     // Without it, our symbols can't be found in the JITed object file.
     targetTriple += "-elf";
 #endif
-    std::unique_ptr<llvm::TargetMachine> targetMachine(llvm::EngineBuilder().selectTarget(llvm::Triple(targetTriple), "", llvm::sys::getHostCPUName(), llvm::SmallVector<std::string, 0>{LLVM_TARGET_ATTRIBUTES}));
+    return targetTriple;
+}
+
+std::string LLVMJIT::getHostTargetSpec() {
+    std::string targetSpec = getTargetTriple();
+    targetSpec += ' ';
+    targetSpec += llvm::sys::getHostCPUName().str();
+    for (const std::string &attribute : llvm::SmallVector<std::string, 0>{LLVM_TARGET_ATTRIBUTES}) {
+        targetSpec += ' ';
+        targetSpec += attribute;
+    }
+    targetSpec += " LLVM " LLVM_VERSION_STRING;
+    return targetSpec;
+}
+
+// The most LLVM instructions that are compiled in a pooled LLVMContext before it is replaced.
+static constexpr Uptr maxInstructionsPerLLVMContext = 1024 * 1024;
+
+struct CompileSession::State {
+    std::unique_ptr<LLVMContext> llvmContext;
+    Uptr numLLVMContextInstructions = 0;
+
+    // The TargetMachine for each optimization level, created the first time it is used.
+    std::unique_ptr<llvm::TargetMachine> targetMachines[Uptr(OptimizationLevel::O3) + 1];
+};
+
+static Platform::Mutex compileSessionPoolMutex;
+static std::vector<CompileSession::State *> compileSessionPool;
+
+CompileSession::CompileSession() {
+    {
+        Lock<Platform::Mutex> compileSessionPoolLock(compileSessionPoolMutex);
+        if (compileSessionPool.size()) {
+            state = compileSessionPool.back();
+            compileSessionPool.pop_back();
+        } else {
+            state = nullptr;
+        }
+    }
+
+    if (!state) {
+        state = new State;
+    }
+    if (!state->llvmContext) {
+        state->llvmContext.reset(new LLVMContext);
+        state->numLLVMContextInstructions = 0;
+    }
+}
+
+CompileSession::~CompileSession() {
+    if (state->numLLVMContextInstructions >= maxInstructionsPerLLVMContext) {
+        state->llvmContext.reset();
+    }
+
+    Lock<Platform::Mutex> compileSessionPoolLock(compileSessionPoolMutex);
+    compileSessionPool.push_back(state);
+}
+
+LLVMContext &CompileSession::getLLVMContext() {
+    return *state->llvmContext;
+}
+
+llvm::TargetMachine *CompileSession::getTargetMachine(OptimizationLevel optimizationLevel) {
+    wavmAssert(Uptr(optimizationLevel) <= Uptr(OptimizationLevel::O3));
+    std::unique_ptr<llvm::TargetMachine> &targetMachine = state->targetMachines[Uptr(optimizationLevel)];
+    if (!targetMachine) {
+        targetMachine.reset(llvm::EngineBuilder().setOptLevel(getCodeGenOptLevel(optimizationLevel)).selectTarget(llvm::Triple(getTargetTriple()), "", llvm::sys::getHostCPUName(), llvm::SmallVector<std::string, 0>{LLVM_TARGET_ATTRIBUTES}));
+    }
+    return targetMachine.get();
+}
+
+void CompileSession::addCompiledInstructions(Uptr numInstructions) {
+    state->numLLVMContextInstructions += numInstructions;
+}
 
+std::vector<U8> LLVMJIT::compileLLVMModule(CompileSession &session, llvm::Module &&llvmModule, OptimizationLevel optimizationLevel, bool shouldLogMetrics, CompileStats *outStats, Uptr beginFunctionDefIndex) {
     // Get a target machine object for this host, and set the module to use its data layout.
+    llvm::TargetMachine *targetMachine = session.getTargetMachine(optimizationLevel);
     llvmModule.setDataLayout(targetMachine->createDataLayout());
 
+    const Uptr endFunctionDefIndex = outStats ? beginFunctionDefIndex + outStats->functionDefs.size() : 0;
+    Uptr statsIndex;
+    if (outStats) {
+        for (const llvm::Function &function : llvmModule) {
+            if (getFunctionDefStatsIndex(function.getName(), false, beginFunctionDefIndex, endFunctionDefIndex, statsIndex)) {
+                outStats->functionDefs[statsIndex].numEmittedInstructions = getNumInstructions(function);
+            }
+        }
+    }
+
     // Optimize the module;
-    optimizeLLVMModule(llvmModule, shouldLogMetrics);
+    optimizeLLVMModule(llvmModule, targetMachine, optimizationLevel, shouldLogMetrics, outStats, beginFunctionDefIndex);
 
+    Uptr numInstructions = 0;
+    for (const llvm::Function &function : llvmModule) {
+        const Uptr numFunctionInstructions = getNumInstructions(function);
+        numInstructions += numFunctionInstructions;
+        if (outStats && getFunctionDefStatsIndex(function.getName(), false, beginFunctionDefIndex, endFunctionDefIndex, statsIndex)) {
+            outStats->functionDefs[statsIndex].numOptimizedInstructions = numFunctionInstructions;
+        }
+    }
+    session.addCompiledInstructions(numInstructions);
+
+    const U64 machineCodeStartTime = outStats ? Platform::getMonotonicClock() : 0;
     std::vector<U8> objectBytes;
     {
         llvm::legacy::PassManager passManager;
@@ -119,17 +351,194 @@ std::vector<U8> LLVMJIT::compileLLVMModule(LLVMContext &llvmContext, llvm::Modul
         passManager.run(llvmModule);
         objectBytes = objectStream.getOutput();
     }
+    if (outStats) {
+        outStats->machineCodeMicroseconds += Platform::getMonotonicClock() - machineCodeStartTime;
+        addMachineCodeStats(objectBytes, beginFunctionDefIndex, *outStats);
+    }
 
     return objectBytes;
 }
 
-std::vector<U8> LLVMJIT::compileModule(const IR::Module &irModule) {
-    LLVMContext llvmContext;
+// Compiling a partition of a module has a fixed cost for creating the LLVM context and emitting the
+// module's imported symbols, so a module is only split into partitions that have at least this many
+// bytes of WebAssembly code each.
+static constexpr Uptr minPartitionCodeBytes = 16 * 1024;
+
+// The number of partitions to create per compile thread. Using more partitions than threads reduces
+// the time threads spend waiting for the thread compiling the largest partition.
+static constexpr Uptr numPartitionsPerThread = 4;
+
+// Emits copies of the linked modules' function definitions that the module's function imports are
+// resolved to. The copies are compiled with only the options that change the semantics of their
+// code: they aren't loaded as functions, so they don't need the options that instrument or defer
+// compiling a function.
+static void emitLinkedModules(const IR::Module &irModule, const CompileOptions &options, LLVMContext &llvmContext, llvm::Module &llvmModule) {
+    CompileOptions linkedOptions;
+    linkedOptions.explicitMemoryBoundsChecks = options.explicitMemoryBoundsChecks;
+    linkedOptions.nonVolatileMemoryAccesses = options.nonVolatileMemoryAccesses;
+    linkedOptions.enableInterruptChecks = options.enableInterruptChecks;
+    linkedOptions.enableFuelMetering = options.enableFuelMetering;
+    linkedOptions.enableFramePointers = options.enableFramePointers;
+
+    for (Uptr linkedModuleIndex = 0; linkedModuleIndex < options.linkedModules.size(); ++linkedModuleIndex) {
+        const IR::Module &linkedModule = *options.linkedModules[linkedModuleIndex];
+        std::vector<bool> emittedFunctionDefs(linkedModule.functions.defs.size(), false);
+        bool hasEmittedFunctionDefs = false;
+        for (const LinkedFunctionImport &linkedImport : options.linkedFunctionImports) {
+            if (linkedImport.linkedModuleIndex == linkedModuleIndex) {
+                errorUnless(linkedImport.functionDefIndex < linkedModule.functions.defs.size());
+                emittedFunctionDefs[linkedImport.functionDefIndex] = true;
+                hasEmittedFunctionDefs = true;
+            }
+        }
+        if (hasEmittedFunctionDefs) {
+            emitLinkedModule(linkedModule, linkedOptions, llvmContext, llvmModule, linkedModuleIndex, emittedFunctionDefs);
+        }
+    }
+}
+
+// Compiles the function definitions in [beginFunctionDefIndex, endFunctionDefIndex). If outStats is
+// non-null, its functionDefs must have an element for each function definition in the range.
+static std::vector<U8> compileModulePartition(const IR::Module &irModule, const CompileOptions &options, Uptr beginFunctionDefIndex, Uptr endFunctionDefIndex, DeferredCodeValidationState *deferredCodeValidationState = nullptr, CompileStats *outStats = nullptr) {
+    wavmAssert(!outStats || outStats->functionDefs.size() == endFunctionDefIndex - beginFunctionDefIndex);
+    CompileSession session;
+    LLVMContext &llvmContext = session.getLLVMContext();
 
     // Emit LLVM IR for the module.
+    const U64 emitStartTime = outStats ? Platform::getMonotonicClock() : 0;
     llvm::Module llvmModule("", llvmContext);
-    emitModule(irModule, llvmContext, llvmModule);
+    errorUnless(options.linkedFunctionImports.size() <= irModule.functions.imports.size());
+    emitLinkedModules(irModule, options, llvmContext, llvmModule);
+    emitModule(irModule, options, llvmContext, llvmModule, beginFunctionDefIndex, endFunctionDefIndex, deferredCodeValidationState, outStats ? outStats->functionDefs.data() : nullptr);
+    if (outStats) {
+        outStats->emitMicroseconds += Platform::getMonotonicClock() - emitStartTime;
+    }
 
     // Compile the LLVM IR to object code.
-    return compileLLVMModule(llvmContext, std::move(llvmModule), true);
+    return compileLLVMModule(session, std::move(llvmModule), options.optimizationLevel, true, outStats, beginFunctionDefIndex);
+}
+
+static std::vector<U8> packObjectFiles(const std::vector<std::vector<U8>> &objectFiles) {
+    const Uptr headerNumBytes = sizeof(multiObjectFileMagic) + sizeof(U64) * (1 + objectFiles.size());
+    Uptr numBytes = alignMultiObjectFileOffset(headerNumBytes);
+    for (const std::vector<U8> &objectFile : objectFiles) {
+        numBytes = alignMultiObjectFileOffset(numBytes + objectFile.size());
+    }
+
+    std::vector<U8> objectCode(numBytes, 0);
+    memcpy(objectCode.data(), multiObjectFileMagic, sizeof(multiObjectFileMagic));
+    const U64 numObjectFiles = objectFiles.size();
+    memcpy(objectCode.data() + sizeof(multiObjectFileMagic), &numObjectFiles, sizeof(U64));
+
+    Uptr offset = alignMultiObjectFileOffset(headerNumBytes);
+    for (Uptr objectFileIndex = 0; objectFileIndex < objectFiles.size(); ++objectFileIndex) {
+        const std::vector<U8> &objectFile = objectFiles[objectFileIndex];
+        const U64 objectFileNumBytes = objectFile.size();
+        memcpy(objectCode.data() + sizeof(multiObjectFileMagic) + sizeof(U64) * (1 + objectFileIndex), &objectFileNumBytes, sizeof(U64));
+        memcpy(objectCode.data() + offset, objectFile.data(), objectFile.size());
+        offset = alignMultiObjectFileOffset(offset + objectFile.size());
+    }
+    wavmAssert(offset == objectCode.size());
+
+    return objectCode;
+}
+
+// Compiles a module, and if deferredCodeValidationState is non-null, validates its function
+// definitions as they are emitted.
+static std::vector<U8> compileModuleImpl(const IR::Module &irModule, const CompileOptions &options, DeferredCodeValidationState *deferredCodeValidationState, CompileStats *outStats = nullptr) {
+    const std::vector<FunctionDef> &functionDefs = irModule.functions.defs;
+    if (outStats) {
+        *outStats = CompileStats();
+        outStats->functionDefs.resize(functionDefs.size());
+    }
+
+    Uptr numCodeBytes = 0;
+    for (const FunctionDef &functionDef : functionDefs) {
+        numCodeBytes += functionDef.code.size();
+    }
+
+    // Decide how many partitions to split the module's function definitions into.
+    const Uptr numHardwareThreads = std::max(Uptr(std::thread::hardware_concurrency()), Uptr(1));
+    Uptr numPartitions = std::min(numHardwareThreads * numPartitionsPerThread, numCodeBytes / minPartitionCodeBytes);
+    numPartitions = std::min(numPartitions, Uptr(functionDefs.size()));
+    if (numHardwareThreads == 1 || numPartitions <= 1) {
+        return compileModulePartition(irModule, options, 0, functionDefs.size(), deferredCodeValidationState, outStats);
+    }
+
+    // Split the function definitions into contiguous ranges with roughly equal amounts of code.
+    std::vector<Uptr> partitionBeginFunctionDefIndices;
+    Uptr numPartitionedCodeBytes = 0;
+    for (Uptr functionDefIndex = 0; functionDefIndex < functionDefs.size(); ++functionDefIndex) {
+        if (numPartitionedCodeBytes * numPartitions >= numCodeBytes * partitionBeginFunctionDefIndices.size()) {
+            partitionBeginFunctionDefIndices.push_back(functionDefIndex);
+        }
+        numPartitionedCodeBytes += functionDefs[functionDefIndex].code.size();
+    }
+    numPartitions = partitionBeginFunctionDefIndices.size();
+    partitionBeginFunctionDefIndices.push_back(functionDefs.size());
+
+    // Compile the partitions on a pool of threads, each in its own LLVM context. The calling thread
+    // is one of the threads in the pool. Each thread validates into its own deferred validation
+    // state, which are merged when all threads are done.
+    const Uptr numThreads = std::min(numHardwareThreads, numPartitions);
+    std::vector<DeferredCodeValidationState> threadDeferredCodeValidationStates(numThreads);
+    std::vector<std::vector<U8>> partitionObjectFiles(numPartitions);
+    std::vector<CompileStats> partitionStats(outStats ? numPartitions : 0);
+    for (Uptr partitionIndex = 0; partitionIndex < partitionStats.size(); ++partitionIndex) {
+        partitionStats[partitionIndex].functionDefs.resize(partitionBeginFunctionDefIndices[partitionIndex + 1] - partitionBeginFunctionDefIndices[partitionIndex]);
+    }
+    parallelFor(numPartitions, numThreads, [&](Uptr threadIndex, Uptr partitionIndex) {
+        partitionObjectFiles[partitionIndex] = compileModulePartition(irModule, options, partitionBeginFunctionDefIndices[partitionIndex], partitionBeginFunctionDefIndices[partitionIndex + 1], deferredCodeValidationState ? &threadDeferredCodeValidationStates[threadIndex] : nullptr, outStats ? &partitionStats[partitionIndex] : nullptr);
+    });
+    for (Uptr partitionIndex = 0; partitionIndex < partitionStats.size(); ++partitionIndex) {
+        const CompileStats &stats = partitionStats[partitionIndex];
+        outStats->emitMicroseconds += stats.emitMicroseconds;
+        outStats->optimizeMicroseconds += stats.optimizeMicroseconds;
+        outStats->machineCodeMicroseconds += stats.machineCodeMicroseconds;
+        std::copy(stats.functionDefs.begin(), stats.functionDefs.end(), outStats->functionDefs.begin() + partitionBeginFunctionDefIndices[partitionIndex]);
+    }
+    if (deferredCodeValidationState) {
+        for (const DeferredCodeValidationState &threadDeferredCodeValidationState :
+                threadDeferredCodeValidationStates) {
+            mergeDeferredCodeValidationState(*deferredCodeValidationState, threadDeferredCodeValidationState);
+        }
+    }
+
+    return packObjectFiles(partitionObjectFiles);
+}
+
+std::vector<U8> LLVMJIT::compileModule(const IR::Module &irModule, const CompileOptions &options, CompileStats *outStats) {
+    return compileModuleImpl(irModule, options, nullptr, outStats);
+}
+
+std::vector<U8> LLVMJIT::validateAndCompileModule(const IR::Module &irModule, const CompileOptions &options) {
+    validatePreCodeSections(irModule);
+
+    DeferredCodeValidationState deferredCodeValidationState;
+    std::vector<U8> objectCode;
+    if (options.enableLazyCompilation || options.enableInterpreter) {
+        // Lazily compiled and interpreted function definitions aren't emitted until they are
+        // called, so they must be validated separately.
+        validateFunctionDefs(irModule, deferredCodeValidationState);
+        objectCode = compileModuleImpl(irModule, options, nullptr);
+    } else {
+        objectCode = compileModuleImpl(irModule, options, &deferredCodeValidationState);
+    }
+
+    validatePostCodeSections(irModule, deferredCodeValidationState);
+    return objectCode;
+}
+
+std::vector<U8> LLVMJIT::compileFunctionDef(const IR::Module &irModule, Uptr functionDefIndex, const CompileOptions &options) {
+    wavmAssert(functionDefIndex < irModule.functions.defs.size());
+    return compileModulePartition(irModule, options, functionDefIndex, functionDefIndex + 1);
+}
+
+std::vector<U8> LLVMJIT::compileFunctionDefs(const IR::Module &irModule, Uptr beginFunctionDefIndex, Uptr endFunctionDefIndex, const CompileOptions &options) {
+    return compileModulePartition(irModule, options, beginFunctionDefIndex, endFunctionDefIndex);
+}
+
+std::vector<U8> LLVMJIT::combineObjectCode(const std::vector<std::vector<U8>> &objectCodes) {
+    wavmAssert(objectCodes.size());
+    return objectCodes.size() == 1 ? objectCodes[0] : packObjectFiles(objectCodes);
 }
@@ -2,8 +2,11 @@
 
 #include "WAVM/IR/Module.h"
 #include "WAVM/IR/Operators.h"
+#include "WAVM/IR/Validate.h"
+#include "WAVM/Inline/AddressRangeIndex.h"
 #include "WAVM/Inline/BasicTypes.h"
 #include "WAVM/LLVMJIT/LLVMJIT.h"
+#include "WAVM/Platform/Memory.h"
 #include "WAVM/Runtime/RuntimeData.h"
 
 #include <cctype>
@@ -58,6 +61,7 @@ POP_DISABLE_WARNINGS_FOR_LLVM_HEADERS
 
 namespace llvm {
     class LoadedObjectInfo;
+    class TargetMachine;
 
     namespace object {
         class SectionRef;
@@ -261,8 +265,41 @@ namespace WAVM {
             return std::string(baseName) + std::to_string(index);
         }
 
-        // Emits LLVM IR for a module.
-        void emitModule(const IR::Module &irModule, LLVMContext &llvmContext, llvm::Module &outLLVMModule);
+        // The prefix of the symbols of a module in CompileOptions::linkedModules that is compiled
+        // into another module, which keeps them distinct from the other module's symbols.
+        inline std::string getLinkedModuleNamePrefix(Uptr linkedModuleIndex) {
+            return "linked" + std::to_string(linkedModuleIndex) + ".";
+        }
+
+        // Creates the branch weights for a conditional branch from the profiled number of times its
+        // true and false destinations were taken, or returns null if neither was taken.
+        llvm::MDNode *createProfileBranchWeights(LLVMContext &llvmContext, U64 trueCount, U64 falseCount);
+
+        // Emits LLVM IR for a module. Only the function definitions in the range
+        // [beginFunctionDefIndex, endFunctionDefIndex) are emitted: the others are declared, and must
+        // be defined by another object file that is loaded together with this one. If
+        // deferredCodeValidationState is non-null, the emitted function definitions are validated as
+        // they are decoded, and a ValidationException is thrown for the first invalid one. If
+        // outFunctionStats is non-null, the time to emit each function definition in the range is
+        // written to outFunctionStats[functionDefIndex - beginFunctionDefIndex].
+        void emitModule(const IR::Module &irModule, const CompileOptions &options, LLVMContext &llvmContext, llvm::Module &outLLVMModule, Uptr beginFunctionDefIndex, Uptr endFunctionDefIndex, IR::DeferredCodeValidationState *deferredCodeValidationState = nullptr, FunctionCompileStats *outFunctionStats = nullptr);
+
+        // Emits available_externally copies of the function definitions of the module at
+        // linkedModuleIndex in CompileOptions::linkedModules for which emittedFunctionDefs is true,
+        // with the module's symbols prefixed by getLinkedModuleNamePrefix. This must precede the
+        // emitModule call for the module that imports them, so its resolved imports refer to them.
+        void emitLinkedModule(const IR::Module &irModule, const CompileOptions &options, LLVMContext &llvmContext, llvm::Module &outLLVMModule, Uptr linkedModuleIndex, const std::vector<bool> &emittedFunctionDefs);
+
+        // When compileModule splits a module into several partitions, it returns the object files
+        // for the partitions packed together: this magic number, the number of object files, and the
+        // size of each object file, followed by the object files themselves. Each object file starts
+        // at an offset aligned to multiObjectFileAlignment, so it may be parsed in place.
+        static constexpr U8 multiObjectFileMagic[8] = {'W', 'A', 'V', 'M', 'O', 'B', 'J', 'S'};
+        static constexpr Uptr multiObjectFileAlignment = 16;
+
+        inline Uptr alignMultiObjectFileOffset(Uptr offset) {
+            return (offset + multiObjectFileAlignment - 1) & ~(multiObjectFileAlignment - 1);
+        }
 
         // Used to override LLVM's default behavior of looking up unresolved symbols in DLL exports.
         llvm::JITEvaluatedSymbol resolveJITImport(llvm::StringRef name);
@@ -271,23 +308,68 @@ namespace WAVM {
 
         // Encapsulates a loaded module.
         struct Module {
-            std::map<Uptr, Runtime::Function *> addressToFunctionMap;
+            std::vector<Runtime::Function *> functions;
+            std::vector<AddressRangeIndex<Runtime::Function *>::Range> functionCodeRanges;
             HashMap<std::string, Runtime::Function *> nameToFunctionMap;
 
-            Module(const std::vector<U8> &inObjectBytes, const HashMap<std::string, Uptr> &importedSymbolMap, bool shouldLogMetrics);
+            // The slab holding the FunctionMutableData objects of the module's functions, if they
+            // were allocated in one. It must outlive the functions, so it's freed after them.
+            std::unique_ptr<Runtime::FunctionMutableDataSlab> functionDefMutableDataSlab;
+
+            // If useThunkArena is true, the module is loaded into the arena shared by the thunks
+            // instead of its own pages. Such a module must never be destroyed.
+            Module(const std::vector<U8> &inObjectBytes, const HashMap<std::string, Uptr> &importedSymbolMap, bool shouldLogMetrics, Uptr numaNode = Platform::anyNUMANode, bool useThunkArena = false);
 
             ~Module();
 
+            // Returns the number of bytes of committed pages holding the module's code and data, or
+            // of the bytes allocated for it in the thunk arena.
+            Uptr getNumImageBytes() const;
+
         private:
             ModuleMemoryManager *memoryManager;
 
             // Have to keep copies of these around because GDB registration listener uses their pointers
             // as keys for deregistration.
             std::vector<U8> objectBytes;
-            std::unique_ptr<llvm::object::ObjectFile> object;
+            std::vector<std::unique_ptr<llvm::object::ObjectFile>> objects;
+        };
+
+        // The state that is reused between compilations: creating a TargetMachine and a LLVMContext
+        // has a fixed cost that dominates compiling small modules like thunks. Constructing a
+        // CompileSession takes the state from a process-wide pool, and destroying it returns the
+        // state to the pool, so each state is only used by one thread at a time. Any LLVM module
+        // created in the session's context must be destroyed before the session.
+        struct CompileSession {
+            CompileSession();
+
+            ~CompileSession();
+
+            CompileSession(const CompileSession &) = delete;
+
+            CompileSession &operator=(const CompileSession &) = delete;
+
+            LLVMContext &getLLVMContext();
+
+            // Returns a TargetMachine for the host with the given optimization level.
+            llvm::TargetMachine *getTargetMachine(OptimizationLevel optimizationLevel);
+
+            // Records the size of a module that was compiled in the session's context. The
+            // LLVMContext keeps the constants and types of every module created in it, so it is
+            // replaced after it has been used for many instructions.
+            void addCompiledInstructions(Uptr numInstructions);
+
+            struct State;
+
+        private:
+            State *state;
         };
 
-        extern std::vector<U8> compileLLVMModule(LLVMContext &llvmContext, llvm::Module &&llvmModule, bool shouldLogMetrics);
+        // Optimizes a LLVM module and compiles it to object code. If outStats is non-null, the time
+        // spent in each phase is added to it, and the costs of the module's function definitions
+        // are written to outStats->functionDefs, indexed by the function definition's index minus
+        // beginFunctionDefIndex.
+        extern std::vector<U8> compileLLVMModule(CompileSession &session, llvm::Module &&llvmModule, OptimizationLevel optimizationLevel, bool shouldLogMetrics, CompileStats *outStats = nullptr, Uptr beginFunctionDefIndex = 0);
 
         extern void processSEHTables(U8 *imageBase, const llvm::LoadedObjectInfo &loadedObject, const llvm::object::SectionRef &pdataSection, const U8 *pdataCopy, Uptr pdataNumBytes, const llvm::object::SectionRef &xdataSection, const U8 *xdataCopy, Uptr sehTrampolineAddress);
     }
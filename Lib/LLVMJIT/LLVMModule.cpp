@@ -1,21 +1,24 @@
+#include <inttypes.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <string.h>
-#include <map>
+#include <algorithm>
+#include <atomic>
 #include <memory>
 #include <system_error>
 #include <vector>
 
 #include "LLVMJITPrivate.h"
+#include "WAVM/Inline/AddressRangeIndex.h"
 #include "WAVM/Inline/Lock.h"
 #include "WAVM/Platform/Memory.h"
 #include "WAVM/Platform/Mutex.h"
+#include "WAVM/Platform/Thread.h"
 #include <iostream>
 
 PUSH_DISABLE_WARNINGS_FOR_LLVM_HEADERS
 #include "llvm-c/Disassembler.h"
-#include "llvm/DebugInfo/DIContext.h"
-#include "llvm/DebugInfo/DWARF/DWARFContext.h"
 #include "llvm/ExecutionEngine/JITEventListener.h"
 #include "llvm/ExecutionEngine/RTDyldMemoryManager.h"
 #include "llvm/Object/SymbolSize.h"
@@ -37,27 +40,105 @@ using namespace WAVM::LLVMJIT;
 
 static llvm::JITEventListener *gdbRegistrationListener = nullptr;
 
-// A map from address to loaded JIT symbols.
-static Platform::Mutex addressToModuleMapMutex;
-static std::map<Uptr, LLVMJIT::Module *> addressToModuleMap;
+// Whether to align JIT images to the huge page size and advise the OS to back them with huge pages.
+static std::atomic<bool> useHugePagesForCode{false};
 
-// Allocates memory for the LLVM object loader.
+// An index of the loaded functions' code address ranges. Lookups don't lock, so it may be used by
+// signal handlers and profilers.
+static AddressRangeIndex<Runtime::Function *> functionCodeRangeIndex;
+
+// Held while a module removes its functions from functionCodeRangeIndex, so a lookup that holds it
+// may use the function it finds until it releases it.
+static Platform::Mutex functionUnloadMutex;
+
+// The perf map file that loaded functions are written to, if setPerfMapEnabled enabled it. Linux
+// perf reads /tmp/perf-<pid>.map to symbolize samples in JIT code.
+static Platform::Mutex perfMapMutex;
+static FILE *perfMapFile = nullptr;
+
+// Writes the address range and name of each function in a loaded module to the perf map.
+static void writePerfMapEntries(const std::vector<AddressRangeIndex<Runtime::Function *>::Range> &functionCodeRanges) {
+    Lock<Platform::Mutex> perfMapLock(perfMapMutex);
+    if (!perfMapFile) {
+        return;
+    }
+    for (const AddressRangeIndex<Runtime::Function *>::Range &range : functionCodeRanges) {
+        fprintf(perfMapFile, "%" PRIxPTR " %" PRIxPTR " %s\n", range.begin, range.end - range.begin, range.value->mutableData->debugName.c_str());
+    }
+    fflush(perfMapFile);
+}
+
+// Thunks are small and never freed, so instead of giving each thunk module its own pages for each
+// section, they are packed into chunks of a shared arena. A chunk has a run of pages for each
+// section kind, which thunks are allocated from in order, and chunks are never freed.
+struct ThunkArenaChunk {
+    U8 *sectionBaseAddresses[3];
+    Uptr sectionNumAllocatedBytes[3];
+};
+
+// The number of pages of each section kind in a thunk arena chunk: code, read-only data, and
+// read-write data. An object with a larger section is loaded into its own image instead.
+static constexpr Uptr thunkArenaChunkNumSectionPages[3] = {16, 16, 4};
+
+// The bytes reserved for each section of an object loaded into the thunk arena in addition to the
+// bytes the loader asks for, since the loader's sizes don't include the padding that aligning each
+// allocation within the section may add.
+static constexpr Uptr thunkArenaSectionSlackBytes = 256;
+
+// The arena's mutex is held from when a thunk module reserves its space in the arena until its
+// pages have their final access, so only one thunk is written into the arena at a time.
+static Platform::Mutex thunkArenaMutex;
+static ThunkArenaChunk *thunkArenaChunk = nullptr;
+
+// Allocates memory for the LLVM object loader. The loader reserves space for each object it loads,
+// so a module that is split into several object files is loaded into one image per object file.
 struct LLVMJIT::ModuleMemoryManager : llvm::RTDyldMemoryManager {
-    ModuleMemoryManager()
-            : imageBaseAddress(nullptr), isFinalized(false), codeSection({nullptr, 0, 0}),
-              readOnlySection({nullptr, 0, 0}), readWriteSection({nullptr, 0, 0}), hasRegisteredEHFrames(false) {
+    struct Section {
+        U8 *baseAddress;
+        Uptr numReservedBytes;
+        Uptr numCommittedBytes;
+    };
+
+    struct Image {
+        U8 *baseAddress;
+        U8 *unalignedBaseAddress;
+        Uptr alignmentLog2;
+        Uptr numPages;
+
+        // Whether the image's sections are allocated in a thunk arena chunk, which owns their pages,
+        // instead of in the image's own pages.
+        bool isInThunkArena;
+
+        Section codeSection;
+        Section readOnlySection;
+        Section readWriteSection;
+    };
+
+    ModuleMemoryManager(Uptr inNUMANode, bool inUseThunkArena)
+            : numaNode(inNUMANode), useThunkArena(inUseThunkArena), isHoldingThunkArenaLock(false), isFinalized(false), hasRegisteredEHFrames(false) {
     }
 
     virtual ~ModuleMemoryManager() override {
+        wavmAssert(!isHoldingThunkArenaLock);
+
         // Deregister the exception handling frame info.
         deregisterEHFrames();
 
-        if (!KEEP_UNLOADED_MODULE_ADDRESSES_RESERVED) {
-            Platform::freeVirtualPages(imageBaseAddress, numAllocatedImagePages);
-        } else {
-            // Decommit the image pages, but leave them reserved to catch any references to them
-            // that might erroneously remain.
-            Platform::decommitVirtualPages(imageBaseAddress, numAllocatedImagePages);
+        for (const Image &image : images) {
+            if (!image.numPages) {
+                continue;
+            }
+            if (!KEEP_UNLOADED_MODULE_ADDRESSES_RESERVED) {
+                if (image.alignmentLog2) {
+                    Platform::freeAlignedVirtualPages(image.unalignedBaseAddress, image.numPages, image.alignmentLog2);
+                } else {
+                    Platform::freeVirtualPages(image.baseAddress, image.numPages);
+                }
+            } else {
+                // Decommit the image pages, but leave them reserved to catch any references to them
+                // that might erroneously remain.
+                Platform::decommitVirtualPages(image.baseAddress, image.numPages);
+            }
         }
     }
 
@@ -78,31 +159,63 @@ struct LLVMJIT::ModuleMemoryManager : llvm::RTDyldMemoryManager {
     }
 
     virtual void reserveAllocationSpace(uintptr_t numCodeBytes, U32 codeAlignment, uintptr_t numReadOnlyBytes, U32 readOnlyAlignment, uintptr_t numReadWriteBytes, U32 readWriteAlignment) override {
+        if (useThunkArena && reserveThunkArenaSpace({Uptr(numCodeBytes), Uptr(numReadOnlyBytes), Uptr(numReadWriteBytes)}, {codeAlignment, readOnlyAlignment, readWriteAlignment})) {
+            return;
+        }
+
         // Calculate the number of pages to be used by each section.
-        codeSection.numPages = shrAndRoundUp(numCodeBytes, Platform::getPageSizeLog2());
-        readOnlySection.numPages = shrAndRoundUp(numReadOnlyBytes, Platform::getPageSizeLog2());
-        readWriteSection.numPages = shrAndRoundUp(numReadWriteBytes, Platform::getPageSizeLog2());
-        numAllocatedImagePages = codeSection.numPages + readOnlySection.numPages + readWriteSection.numPages;
-        if (numAllocatedImagePages) {
-            // Reserve enough contiguous pages for all sections.
-            imageBaseAddress = Platform::allocateVirtualPages(numAllocatedImagePages);
-            if (!imageBaseAddress || !Platform::commitVirtualPages(imageBaseAddress, numAllocatedImagePages)) {
+        const Uptr pageSizeLog2 = Platform::getPageSizeLog2();
+        const Uptr numCodePages = shrAndRoundUp(numCodeBytes, pageSizeLog2);
+        const Uptr numReadOnlyPages = shrAndRoundUp(numReadOnlyBytes, pageSizeLog2);
+        const Uptr numReadWritePages = shrAndRoundUp(numReadWriteBytes, pageSizeLog2);
+        Image image;
+        image.baseAddress = nullptr;
+        image.unalignedBaseAddress = nullptr;
+        image.alignmentLog2 = 0;
+        image.isInThunkArena = false;
+        image.codeSection = {nullptr, numCodePages << pageSizeLog2, 0};
+        image.readOnlySection = {nullptr, numReadOnlyPages << pageSizeLog2, 0};
+        image.readWriteSection = {nullptr, numReadWritePages << pageSizeLog2, 0};
+        image.numPages = numCodePages + numReadOnlyPages + numReadWritePages;
+        if (image.numPages) {
+            // Reserve enough contiguous pages for all sections. If huge pages are enabled, and the
+            // code section is at least a huge page, align the image so its code can be backed by
+            // huge pages.
+            const Uptr hugePageSizeLog2 = Platform::getHugePageSizeLog2();
+            const bool useHugePages = useHugePagesForCode.load(std::memory_order_relaxed) && hugePageSizeLog2 > Platform::getPageSizeLog2() &&
+                                      numCodePages >= (Uptr(1) << (hugePageSizeLog2 - Platform::getPageSizeLog2()));
+            if (useHugePages) {
+                image.alignmentLog2 = hugePageSizeLog2;
+                image.baseAddress = Platform::allocateAlignedVirtualPages(image.numPages, hugePageSizeLog2, image.unalignedBaseAddress);
+            } else {
+                image.baseAddress = Platform::allocateVirtualPages(image.numPages);
+                image.unalignedBaseAddress = image.baseAddress;
+            }
+            if (useHugePages && image.baseAddress) {
+                Platform::adviseHugePages(image.baseAddress, numCodePages);
+            }
+            if (numaNode != Platform::anyNUMANode && image.baseAddress) {
+                Platform::setVirtualPagesNUMANode(image.baseAddress, image.numPages, numaNode);
+            }
+            if (!image.baseAddress || !Platform::commitVirtualPages(image.baseAddress, image.numPages)) {
                 Errors::fatal("memory allocation for JIT code failed");
             }
-            codeSection.baseAddress = imageBaseAddress;
-            readOnlySection.baseAddress =
-                    codeSection.baseAddress + (codeSection.numPages << Platform::getPageSizeLog2());
-            readWriteSection.baseAddress =
-                    readOnlySection.baseAddress + (readOnlySection.numPages << Platform::getPageSizeLog2());
+            image.codeSection.baseAddress = image.baseAddress;
+            image.readOnlySection.baseAddress = image.codeSection.baseAddress + image.codeSection.numReservedBytes;
+            image.readWriteSection.baseAddress = image.readOnlySection.baseAddress + image.readOnlySection.numReservedBytes;
         }
+
+        // Subsequent allocations are made in the image for the object being loaded.
+        images.push_back(image);
     }
 
     virtual U8 *allocateCodeSection(uintptr_t numBytes, U32 alignment, U32 sectionID, llvm::StringRef sectionName) override {
-        return allocateBytes((Uptr) numBytes, alignment, codeSection);
+        return allocateBytes((Uptr) numBytes, alignment, getCurrentImage().codeSection);
     }
 
     virtual U8 *allocateDataSection(uintptr_t numBytes, U32 alignment, U32 sectionID, llvm::StringRef SectionName, bool isReadOnly) override {
-        return allocateBytes((Uptr) numBytes, alignment, isReadOnly ? readOnlySection : readWriteSection);
+        Image &image = getCurrentImage();
+        return allocateBytes((Uptr) numBytes, alignment, isReadOnly ? image.readOnlySection : image.readWriteSection);
     }
 
     virtual bool finalizeMemory(std::string *ErrMsg = nullptr) override {
@@ -116,50 +229,53 @@ struct LLVMJIT::ModuleMemoryManager : llvm::RTDyldMemoryManager {
         wavmAssert(!isFinalized);
         isFinalized = true;
         const Platform::MemoryAccess codeAccess = Platform::MemoryAccess::execute;
-        if (codeSection.numPages) {
-            errorUnless(Platform::setVirtualPageAccess(codeSection.baseAddress, codeSection.numPages, codeAccess));
+        for (const Image &image : images) {
+            setSectionAccess(image.codeSection, codeAccess);
+            setSectionAccess(image.readOnlySection, Platform::MemoryAccess::readOnly);
+            setSectionAccess(image.readWriteSection, Platform::MemoryAccess::readWrite);
         }
-        if (readOnlySection.numPages) {
-            errorUnless(Platform::setVirtualPageAccess(readOnlySection.baseAddress, readOnlySection.numPages, Platform::MemoryAccess::readOnly));
-        }
-        if (readWriteSection.numPages) {
-            errorUnless(Platform::setVirtualPageAccess(readWriteSection.baseAddress, readWriteSection.numPages, Platform::MemoryAccess::readWrite));
+
+        // Now that the thunk's pages have their final access, other thunks may be written into the
+        // arena.
+        if (isHoldingThunkArenaLock) {
+            isHoldingThunkArenaLock = false;
+            thunkArenaMutex.unlock();
         }
     }
 
     virtual void invalidateInstructionCache() {
-        // Invalidate the instruction cache for the whole image.
-        llvm::sys::Memory::InvalidateInstructionCache(imageBaseAddress,
-                                                      numAllocatedImagePages << Platform::getPageSizeLog2());
-    }
-
-    U8 *getImageBaseAddress() const {
-        return imageBaseAddress;
+        // Invalidate the instruction cache for the whole image, or for the code of an image in the
+        // thunk arena.
+        for (const Image &image : images) {
+            if (image.isInThunkArena) {
+                llvm::sys::Memory::InvalidateInstructionCache(image.codeSection.baseAddress, image.codeSection.numReservedBytes);
+            } else {
+                llvm::sys::Memory::InvalidateInstructionCache(image.baseAddress,
+                                                              image.numPages << Platform::getPageSizeLog2());
+            }
+        }
     }
 
-    Uptr getNumImageBytes() const {
-        return numAllocatedImagePages << Platform::getPageSizeLog2();
+    const std::vector<Image> &getImages() const {
+        return images;
     }
 
 private:
-    struct Section {
-        U8 *baseAddress;
-        Uptr numPages;
-        Uptr numCommittedBytes;
-    };
-
-    U8 *imageBaseAddress;
-    Uptr numAllocatedImagePages;
+    std::vector<Image> images;
+    const Uptr numaNode;
+    const bool useThunkArena;
+    bool isHoldingThunkArenaLock;
     bool isFinalized;
 
-    Section codeSection;
-    Section readOnlySection;
-    Section readWriteSection;
-
     bool hasRegisteredEHFrames;
     const U8 *ehFramesAddr;
     Uptr ehFramesNumBytes;
 
+    Image &getCurrentImage() {
+        wavmAssert(images.size());
+        return images.back();
+    }
+
     U8 *allocateBytes(Uptr numBytes, Uptr alignment, Section &section) {
         wavmAssert(section.baseAddress);
         wavmAssert(!(alignment & (alignment - 1)));
@@ -171,13 +287,92 @@ private:
         section.numCommittedBytes = align(section.numCommittedBytes, alignment) + align(numBytes, alignment);
 
         // Check that enough space was reserved in the section.
-        if (section.numCommittedBytes > (section.numPages << Platform::getPageSizeLog2())) {
+        if (section.numCommittedBytes > section.numReservedBytes) {
             Errors::fatal("didn't reserve enough space in section");
         }
 
         return allocationBaseAddress;
     }
 
+    // Sets the access of the pages that contain a section. A section in the thunk arena may share
+    // its first and last pages with the sections of other thunks, which need the same access.
+    static void setSectionAccess(const Section &section, Platform::MemoryAccess access) {
+        if (!section.numReservedBytes) {
+            return;
+        }
+        const Uptr pageSizeLog2 = Platform::getPageSizeLog2();
+        const Uptr beginPageIndex = reinterpret_cast<Uptr>(section.baseAddress) >> pageSizeLog2;
+        const Uptr endPageIndex = shrAndRoundUp(reinterpret_cast<Uptr>(section.baseAddress) + section.numReservedBytes, pageSizeLog2);
+        errorUnless(Platform::setVirtualPageAccess(reinterpret_cast<U8 *>(beginPageIndex << pageSizeLog2), endPageIndex - beginPageIndex, access));
+    }
+
+    // Reserves space for an object in the thunk arena, and returns false if its sections are too
+    // large for an arena chunk. Locks the arena until the object's pages are finalized.
+    bool reserveThunkArenaSpace(const Uptr (&numSectionBytes)[3], const U32 (&inSectionAlignments)[3]) {
+        const Uptr pageSizeLog2 = Platform::getPageSizeLog2();
+        Uptr sectionAlignments[3];
+        Uptr numReservedSectionBytes[3];
+        for (Uptr sectionIndex = 0; sectionIndex < 3; ++sectionIndex) {
+            sectionAlignments[sectionIndex] = std::max(Uptr(inSectionAlignments[sectionIndex]), Uptr(1));
+            numReservedSectionBytes[sectionIndex] = numSectionBytes[sectionIndex] ? align(numSectionBytes[sectionIndex] + thunkArenaSectionSlackBytes, sectionAlignments[sectionIndex]) : 0;
+            if (numReservedSectionBytes[sectionIndex] + sectionAlignments[sectionIndex] > (thunkArenaChunkNumSectionPages[sectionIndex] << pageSizeLog2)) {
+                return false;
+            }
+        }
+
+        if (!isHoldingThunkArenaLock) {
+            thunkArenaMutex.lock();
+            isHoldingThunkArenaLock = true;
+        }
+
+        // Start a new chunk if the object doesn't fit in the rest of the current chunk.
+        bool fitsInChunk = thunkArenaChunk != nullptr;
+        for (Uptr sectionIndex = 0; sectionIndex < 3 && fitsInChunk; ++sectionIndex) {
+            const Uptr sectionOffset = align(thunkArenaChunk->sectionNumAllocatedBytes[sectionIndex], sectionAlignments[sectionIndex]);
+            fitsInChunk = sectionOffset + numReservedSectionBytes[sectionIndex] <= (thunkArenaChunkNumSectionPages[sectionIndex] << pageSizeLog2);
+        }
+        if (!fitsInChunk) {
+            const Uptr numChunkPages = thunkArenaChunkNumSectionPages[0] + thunkArenaChunkNumSectionPages[1] + thunkArenaChunkNumSectionPages[2];
+            U8 *chunkBaseAddress = Platform::allocateVirtualPages(numChunkPages);
+            if (!chunkBaseAddress || !Platform::commitVirtualPages(chunkBaseAddress, numChunkPages)) {
+                Errors::fatal("memory allocation for JIT code failed");
+            }
+
+            thunkArenaChunk = new ThunkArenaChunk;
+            U8 *sectionBaseAddress = chunkBaseAddress;
+            for (Uptr sectionIndex = 0; sectionIndex < 3; ++sectionIndex) {
+                thunkArenaChunk->sectionBaseAddresses[sectionIndex] = sectionBaseAddress;
+                thunkArenaChunk->sectionNumAllocatedBytes[sectionIndex] = 0;
+                sectionBaseAddress += thunkArenaChunkNumSectionPages[sectionIndex] << pageSizeLog2;
+            }
+        }
+
+        // Allocate the sections at the end of the chunk's allocated bytes.
+        Section sections[3];
+        for (Uptr sectionIndex = 0; sectionIndex < 3; ++sectionIndex) {
+            const Uptr sectionOffset = align(thunkArenaChunk->sectionNumAllocatedBytes[sectionIndex], sectionAlignments[sectionIndex]);
+            sections[sectionIndex] = {thunkArenaChunk->sectionBaseAddresses[sectionIndex] + sectionOffset, numReservedSectionBytes[sectionIndex], 0};
+            thunkArenaChunk->sectionNumAllocatedBytes[sectionIndex] = sectionOffset + numReservedSectionBytes[sectionIndex];
+        }
+
+        // Make the pages the object is loaded into writable. Other thunks' code on the same pages
+        // may be running, so the code pages stay executable while they are written.
+        setSectionAccess(sections[0], Platform::MemoryAccess::readWriteExecute);
+        setSectionAccess(sections[1], Platform::MemoryAccess::readWrite);
+
+        Image image;
+        image.baseAddress = nullptr;
+        image.unalignedBaseAddress = nullptr;
+        image.alignmentLog2 = 0;
+        image.numPages = 0;
+        image.isInThunkArena = true;
+        image.codeSection = sections[0];
+        image.readOnlySection = sections[1];
+        image.readWriteSection = sections[2];
+        images.push_back(image);
+        return true;
+    }
+
     static Uptr align(Uptr size, Uptr alignment) {
         return (size + alignment - 1) & ~(alignment - 1);
     }
@@ -191,6 +386,34 @@ private:
     void operator=(const ModuleMemoryManager &) = delete;
 };
 
+// Splits object code into the object files it contains: either a single object file, or several
+// object files packed together by compileModule.
+static std::vector<llvm::StringRef> splitObjectFiles(const std::vector<U8> &objectCode) {
+    const U8 *bytes = objectCode.data();
+    const Uptr numBytes = objectCode.size();
+    if (numBytes < sizeof(multiObjectFileMagic) || memcmp(bytes, multiObjectFileMagic, sizeof(multiObjectFileMagic))) {
+        return {llvm::StringRef((const char *) bytes, numBytes)};
+    }
+
+    U64 numObjectFiles;
+    errorUnless(numBytes >= sizeof(multiObjectFileMagic) + sizeof(U64));
+    memcpy(&numObjectFiles, bytes + sizeof(multiObjectFileMagic), sizeof(U64));
+
+    Uptr headerNumBytes = sizeof(multiObjectFileMagic) + sizeof(U64) * (1 + numObjectFiles);
+    errorUnless(numObjectFiles <= numBytes && headerNumBytes <= numBytes);
+    Uptr offset = alignMultiObjectFileOffset(headerNumBytes);
+
+    std::vector<llvm::StringRef> objectFiles;
+    for (Uptr objectFileIndex = 0; objectFileIndex < numObjectFiles; ++objectFileIndex) {
+        U64 objectFileNumBytes;
+        memcpy(&objectFileNumBytes, bytes + sizeof(multiObjectFileMagic) + sizeof(U64) * (1 + objectFileIndex), sizeof(U64));
+        errorUnless(offset <= numBytes && objectFileNumBytes <= numBytes - offset);
+        objectFiles.push_back(llvm::StringRef((const char *) bytes + offset, Uptr(objectFileNumBytes)));
+        offset = alignMultiObjectFileOffset(offset + Uptr(objectFileNumBytes));
+    }
+    return objectFiles;
+}
+
 static void disassembleFunction(U8 *bytes, Uptr numBytes) {
     LLVMDisasmContextRef disasmRef = LLVMCreateDisasm(llvm::sys::getProcessTriple().c_str(), nullptr, 0, nullptr, nullptr);
 
@@ -212,10 +435,15 @@ static void disassembleFunction(U8 *bytes, Uptr numBytes) {
     LLVMDisasmDispose(disasmRef);
 }
 
-Module::Module(const std::vector<U8> &inObjectBytes, const HashMap<std::string, Uptr> &importedSymbolMap, bool shouldLogMetrics)
-        : memoryManager(new ModuleMemoryManager()), objectBytes(inObjectBytes) {
+Module::Module(const std::vector<U8> &inObjectBytes, const HashMap<std::string, Uptr> &importedSymbolMap, bool shouldLogMetrics, Uptr numaNode, bool useThunkArena)
+        : memoryManager(new ModuleMemoryManager(numaNode, useThunkArena)), objectBytes(inObjectBytes) {
 
-    object = cantFail(llvm::object::ObjectFile::createObjectFile(llvm::MemoryBufferRef(llvm::StringRef((const char *) objectBytes.data(), objectBytes.size()), "memory")));
+    // The object code may contain multiple object files if compileModule split the module into
+    // partitions. They are all loaded by the same RuntimeDyld, so references from one object file
+    // to functions defined in another are resolved by the loader.
+    for (llvm::StringRef objectFileBytes : splitObjectFiles(objectBytes)) {
+        objects.push_back(cantFail(llvm::object::ObjectFile::createObjectFile(llvm::MemoryBufferRef(objectFileBytes, "memory"))));
+    }
 
     // Create the LLVM object loader.
     struct SymbolResolver : llvm::JITSymbolResolver {
@@ -296,28 +524,33 @@ Module::Module(const std::vector<U8> &inObjectBytes, const HashMap<std::string,
     Uptr pdataNumBytes = 0;
     llvm::object::SectionRef xdataSection;
     U8 *xdataCopy = nullptr;
-    for (auto section : object->sections()) {
-        llvm::StringRef sectionName;
-        if (!section.getName(sectionName)) {
-            llvm::StringRef sectionContents;
-            if (!section.getContents(sectionContents)) {
-                const U8 *loadedSection = (const U8 *) sectionContents.data();
-                if (sectionName == ".pdata") {
-                    pdataCopy = new U8[section.getSize()];
-                    pdataNumBytes = section.getSize();
-                    pdataSection = section;
-                    memcpy(pdataCopy, loadedSection, section.getSize());
-                } else if (sectionName == ".xdata") {
-                    xdataCopy = new U8[section.getSize()];
-                    xdataSection = section;
-                    memcpy(xdataCopy, loadedSection, section.getSize());
+    std::vector<std::unique_ptr<llvm::RuntimeDyld::LoadedObjectInfo>> loadedObjects;
+    for (const std::unique_ptr<llvm::object::ObjectFile> &object : objects) {
+        for (auto section : object->sections()) {
+            llvm::StringRef sectionName;
+            if (!section.getName(sectionName)) {
+                llvm::StringRef sectionContents;
+                if (!section.getContents(sectionContents)) {
+                    const U8 *loadedSection = (const U8 *) sectionContents.data();
+                    if (sectionName == ".pdata") {
+                        wavmAssert(!pdataCopy);
+                        pdataCopy = new U8[section.getSize()];
+                        pdataNumBytes = section.getSize();
+                        pdataSection = section;
+                        memcpy(pdataCopy, loadedSection, section.getSize());
+                    } else if (sectionName == ".xdata") {
+                        wavmAssert(!xdataCopy);
+                        xdataCopy = new U8[section.getSize()];
+                        xdataSection = section;
+                        memcpy(xdataCopy, loadedSection, section.getSize());
+                    }
                 }
             }
         }
-    }
 
-    // Use the LLVM object loader to load the object.
-    std::unique_ptr<llvm::RuntimeDyld::LoadedObjectInfo> loadedObject = loader.loadObject(*object);
+        // Use the LLVM object loader to load the object.
+        loadedObjects.push_back(loader.loadObject(*object));
+    }
     loader.finalizeWithMemoryManagerLocking();
     if (loader.hasError()) {
         Errors::fatalf("RuntimeDyld failed: %s", loader.getErrorString().data());
@@ -337,119 +570,168 @@ Module::Module(const std::vector<U8> &inObjectBytes, const HashMap<std::string,
     // final non-writable memory permissions.
     memoryManager->reallyFinalizeMemory();
 
-    // Notify GDB of the new object.
     if (!gdbRegistrationListener) {
         gdbRegistrationListener = llvm::JITEventListener::createGDBRegistrationListener();
     }
-    gdbRegistrationListener->NotifyObjectEmitted(*object, *loadedObject);
 
-    // Create a DWARF context to interpret the debug information in this compilation unit.
-    auto dwarfContext = llvm::DWARFContext::create(*object, &*loadedObject);
+    for (Uptr objectIndex = 0; objectIndex < objects.size(); ++objectIndex) {
+        const llvm::object::ObjectFile &object = *objects[objectIndex];
+        const llvm::RuntimeDyld::LoadedObjectInfo &loadedObject = *loadedObjects[objectIndex];
 
-    // Iterate over the functions in the loaded object.
-    for (std::pair<llvm::object::SymbolRef, U64> symbolSizePair :
-            llvm::object::computeSymbolSizes(*object)) {
-        llvm::object::SymbolRef symbol = symbolSizePair.first;
+        // Notify GDB of the new object.
+        gdbRegistrationListener->NotifyObjectEmitted(object, loadedObject);
 
-        // Get the type, name, and address of the symbol. Need to be careful not to get the
-        // Expected<T> for each value unless it will be checked for success before continuing.
-        llvm::Expected<llvm::object::SymbolRef::Type> type = symbol.getType();
-        if (!type || *type != llvm::object::SymbolRef::ST_Function) {
-            continue;
-        }
-        llvm::Expected<llvm::StringRef> name = symbol.getName();
-        if (!name) {
-            continue;
-        }
-        llvm::Expected<U64> address = symbol.getAddress();
-        if (!address) {
-            continue;
-        }
+        // Iterate over the functions in the loaded object.
+        std::vector<llvm::object::SymbolRef> dataSymbols;
+        for (std::pair<llvm::object::SymbolRef, U64> symbolSizePair :
+                llvm::object::computeSymbolSizes(object)) {
+            llvm::object::SymbolRef symbol = symbolSizePair.first;
 
-        // Compute the address the function was loaded at.
-        wavmAssert(*address <= UINTPTR_MAX);
-        Uptr loadedAddress = Uptr(*address);
-        if (llvm::Expected<llvm::object::section_iterator> symbolSection = symbol.getSection()) {
-            loadedAddress += (Uptr) loadedObject->getSectionLoadAddress(*symbolSection.get());
-        }
+            // Get the type, name, and address of the symbol. Need to be careful not to get the
+            // Expected<T> for each value unless it will be checked for success before continuing.
+            llvm::Expected<llvm::object::SymbolRef::Type> type = symbol.getType();
+            if (type && *type == llvm::object::SymbolRef::ST_Data) {
+                dataSymbols.push_back(symbol);
+            }
+            if (!type || *type != llvm::object::SymbolRef::ST_Function) {
+                continue;
+            }
+            llvm::Expected<llvm::StringRef> name = symbol.getName();
+            if (!name) {
+                continue;
+            }
+            llvm::Expected<U64> address = symbol.getAddress();
+            if (!address) {
+                continue;
+            }
 
-        // Get the DWARF line info for this symbol, which maps machine code addresses to
-        // WebAssembly op indices.
-        llvm::DILineInfoTable lineInfoTable = dwarfContext->getLineInfoForAddressRange(loadedAddress, symbolSizePair.second);
-        std::map<U32, U32> offsetToOpIndexMap;
-        for (auto lineInfo : lineInfoTable) {
-            offsetToOpIndexMap.emplace(U32(lineInfo.first - loadedAddress), lineInfo.second.Line);
-        }
+            // Compute the address the function was loaded at.
+            wavmAssert(*address <= UINTPTR_MAX);
+            Uptr loadedAddress = Uptr(*address);
+            if (llvm::Expected<llvm::object::section_iterator> symbolSection = symbol.getSection()) {
+                loadedAddress += (Uptr) loadedObject.getSectionLoadAddress(*symbolSection.get());
+            }
 
-        if (PRINT_DISASSEMBLY && shouldLogMetrics) {
-            std::cout << "Disassembly for function %s\n", name.get().data();
-            disassembleFunction(reinterpret_cast<U8 *>(loadedAddress), Uptr(symbolSizePair.second));
+            if (PRINT_DISASSEMBLY && shouldLogMetrics) {
+                std::cout << "Disassembly for function %s\n", name.get().data();
+                disassembleFunction(reinterpret_cast<U8 *>(loadedAddress), Uptr(symbolSizePair.second));
+            }
+
+            // Add the function to the module's name to function map and list of functions.
+            wavmAssert(symbolSizePair.second <= UINTPTR_MAX);
+            Runtime::Function *function = (Runtime::Function *) (loadedAddress - offsetof(Runtime::Function, code));
+            nameToFunctionMap.addOrFail(*name, function);
+            functions.push_back(function);
+            if (symbolSizePair.second) {
+                functionCodeRanges.push_back({loadedAddress, loadedAddress + Uptr(symbolSizePair.second), function});
+            }
+
+            // Initialize the function mutable data.
+            wavmAssert(function->mutableData);
+            function->mutableData->jitModule = this;
+            function->mutableData->function = function;
+            function->mutableData->numCodeBytes = Uptr(symbolSizePair.second);
         }
 
-        // Add the function to the module's name and address to function maps.
-        wavmAssert(symbolSizePair.second <= UINTPTR_MAX);
-        Runtime::Function *function = (Runtime::Function *) (loadedAddress - offsetof(Runtime::Function, code));
-        nameToFunctionMap.addOrFail(*name, function);
-        addressToFunctionMap.emplace(Uptr(loadedAddress + symbolSizePair.second), function);
+        // Bind the profile counters of each function definition compiled with profile counters to
+        // its FunctionMutableData. The counters symbol has the same prefix and index as the
+        // function's symbol.
+        for (const llvm::object::SymbolRef &symbol : dataSymbols) {
+            llvm::Expected<llvm::StringRef> name = symbol.getName();
+            llvm::Expected<U64> address = symbol.getAddress();
+            if (!name || !address) {
+                continue;
+            }
+            const Uptr countersNameOffset = name->find("profileCounters");
+            if (countersNameOffset == llvm::StringRef::npos) {
+                continue;
+            }
+            const std::string functionName = name->substr(0, countersNameOffset).str() + "functionDef" + name->substr(countersNameOffset + strlen("profileCounters")).str();
+            Runtime::Function *const *function = nameToFunctionMap.get(functionName);
+            if (!function) {
+                continue;
+            }
 
-        // Initialize the function mutable data.
-        wavmAssert(function->mutableData);
-        function->mutableData->jitModule = this;
-        function->mutableData->function = function;
+            Uptr loadedAddress = Uptr(*address);
+            if (llvm::Expected<llvm::object::section_iterator> symbolSection = symbol.getSection()) {
+                loadedAddress += (Uptr) loadedObject.getSectionLoadAddress(*symbolSection.get());
+            }
+            (*function)->mutableData->profileCounters = reinterpret_cast<std::atomic<U64> *>(loadedAddress);
+        }
     }
 
-    const Uptr moduleEndAddress = reinterpret_cast<Uptr>(memoryManager->getImageBaseAddress() +
-                                                         memoryManager->getNumImageBytes());
-    {
-        Lock<Platform::Mutex> addressToModuleMapLock(addressToModuleMapMutex);
-        addressToModuleMap.emplace(moduleEndAddress, this);
-    }
+    // Publish the functions' code address ranges in a single update of the global index.
+    functionCodeRangeIndex.addRanges(std::vector<AddressRangeIndex<Runtime::Function *>::Range>(functionCodeRanges));
+    writePerfMapEntries(functionCodeRanges);
 }
 
 Module::~Module() {
-    // Notify GDB that the object is being unloaded.
-    gdbRegistrationListener->NotifyFreeingObject(*object);
+    // Notify GDB that the objects are being unloaded.
+    for (const std::unique_ptr<llvm::object::ObjectFile> &object : objects) {
+        gdbRegistrationListener->NotifyFreeingObject(*object);
+    }
 
-    // Remove the module from the global address to module map.
-    Lock<Platform::Mutex> addressToModuleMapLock(addressToModuleMapMutex);
-    addressToModuleMap.erase(addressToModuleMap.find(reinterpret_cast<Uptr>(
-                                                             memoryManager->getImageBaseAddress() +
-                                                             memoryManager->getNumImageBytes())));
+    // Remove the module's functions from the global code address index.
+    std::vector<Uptr> functionCodeBegins;
+    for (const AddressRangeIndex<Runtime::Function *>::Range &range : functionCodeRanges) {
+        functionCodeBegins.push_back(range.begin);
+    }
+    {
+        Lock<Platform::Mutex> functionUnloadLock(functionUnloadMutex);
+        functionCodeRangeIndex.removeRangesOrFail(std::move(functionCodeBegins));
+    }
 
-    // Free the FunctionMutableData objects.
-    for (const auto &pair : addressToFunctionMap) {
-        delete pair.second->mutableData;
+    // Free the FunctionMutableData objects that aren't in the slab, which is freed with the module.
+    for (Runtime::Function *function : functions) {
+        if (!functionDefMutableDataSlab || !functionDefMutableDataSlab->contains(function->mutableData)) {
+            delete function->mutableData;
+        }
     }
 
     // Delete the memory manager.
     delete memoryManager;
 }
 
-std::shared_ptr<LLVMJIT::Module> LLVMJIT::loadModule(const std::vector<U8> &objectFileBytes, HashMap<std::string, FunctionBinding> &&wavmIntrinsicsExportMap, std::vector<IR::FunctionType> &&types, std::vector<FunctionBinding> &&functionImports, std::vector<TableBinding> &&tables, std::vector<MemoryBinding> &&memories, std::vector<GlobalBinding> &&globals, std::vector<ExceptionTypeBinding> &&exceptionTypes, ModuleInstanceBinding moduleInstance, Uptr tableReferenceBias, const std::vector<Runtime::FunctionMutableData *> &functionDefMutableDatas) {
-    // Bind undefined symbols in the compiled object to values.
-    HashMap<std::string, Uptr> importedSymbolMap;
-
-    // Bind the wavmIntrinsic function symbols; the compiled module assumes they have the intrinsic
-    // calling convention, so no thunking is necessary.
-    for (auto exportMapPair : wavmIntrinsicsExportMap) {
-        wavmAssert(exportMapPair.value.callingConvention == IR::CallingConvention::intrinsic);
-        importedSymbolMap.addOrFail(exportMapPair.key, reinterpret_cast<Uptr>(exportMapPair.value.code));
+Uptr Module::getNumImageBytes() const {
+    Uptr numBytes = 0;
+    for (const ModuleMemoryManager::Image &image : memoryManager->getImages()) {
+        if (image.isInThunkArena) {
+            numBytes += image.codeSection.numReservedBytes + image.readOnlySection.numReservedBytes + image.readWriteSection.numReservedBytes;
+        } else {
+            numBytes += image.numPages << Platform::getPageSizeLog2();
+        }
     }
+    return numBytes;
+}
+
+Uptr LLVMJIT::getModuleNumImageBytes(const Module *module) {
+    return module->getNumImageBytes();
+}
 
+// Binds the symbols of a module's bindings, each prefixed with namePrefix.
+static void bindModuleSymbols(HashMap<std::string, Uptr> &importedSymbolMap, const std::string &namePrefix, const std::vector<IR::FunctionType> &types, const std::vector<FunctionBinding> &functionImports, const std::vector<FunctionBinding> &functionDefs, const std::vector<TableBinding> &tables, const std::vector<MemoryBinding> &memories, const std::vector<GlobalBinding> &globals, const std::vector<ExceptionTypeBinding> &exceptionTypes, ModuleInstanceBinding moduleInstance, Uptr tableReferenceBias, const std::vector<Runtime::FunctionMutableData *> &functionDefMutableDatas) {
     // Bind the type ID symbols.
     for (Uptr typeIndex = 0; typeIndex < types.size(); ++typeIndex) {
-        importedSymbolMap.addOrFail(getExternalName("typeId", typeIndex), types[typeIndex].getEncoding().impl);
+        importedSymbolMap.addOrFail(namePrefix + getExternalName("typeId", typeIndex), types[typeIndex].getEncoding().impl);
     }
 
     // Bind imported function symbols.
     for (Uptr importIndex = 0; importIndex < functionImports.size(); ++importIndex) {
-        importedSymbolMap.addOrFail(getExternalName("functionImport", importIndex), reinterpret_cast<Uptr>(functionImports[importIndex].code));
+        importedSymbolMap.addOrFail(namePrefix + getExternalName("functionImport", importIndex), reinterpret_cast<Uptr>(functionImports[importIndex].code));
+    }
+
+    // Bind the function definition symbols that aren't defined by the object code.
+    for (Uptr functionDefIndex = 0; functionDefIndex < functionDefs.size(); ++functionDefIndex) {
+        if (functionDefs[functionDefIndex].code) {
+            wavmAssert(functionDefs[functionDefIndex].callingConvention == IR::CallingConvention::wasm);
+            importedSymbolMap.addOrFail(namePrefix + getExternalName("functionDef", functionDefIndex), reinterpret_cast<Uptr>(functionDefs[functionDefIndex].code));
+        }
     }
 
     // Bind the table symbols. The compiled module uses the symbol's value as an offset into
     // CompartmentRuntimeData to the table's entry in CompartmentRuntimeData::tableBases.
     for (Uptr tableIndex = 0; tableIndex < tables.size(); ++tableIndex) {
-        importedSymbolMap.addOrFail(getExternalName("tableOffset", tableIndex),
+        importedSymbolMap.addOrFail(namePrefix + getExternalName("tableOffset", tableIndex),
                                     offsetof(Runtime::CompartmentRuntimeData, tableBases) +
                                     sizeof(void *) * tables[tableIndex].id);
     }
@@ -457,7 +739,7 @@ std::shared_ptr<LLVMJIT::Module> LLVMJIT::loadModule(const std::vector<U8> &obje
     // Bind the memory symbols. The compiled module uses the symbol's value as an offset into
     // CompartmentRuntimeData to the memory's entry in CompartmentRuntimeData::memoryBases.
     for (Uptr memoryIndex = 0; memoryIndex < memories.size(); ++memoryIndex) {
-        importedSymbolMap.addOrFail(getExternalName("memoryOffset", memoryIndex),
+        importedSymbolMap.addOrFail(namePrefix + getExternalName("memoryOffset", memoryIndex),
                                     offsetof(Runtime::CompartmentRuntimeData, memoryBases) +
                                     sizeof(void *) * memories[memoryIndex].id);
     }
@@ -475,49 +757,92 @@ std::shared_ptr<LLVMJIT::Module> LLVMJIT::loadModule(const std::vector<U8> &obje
             // Otherwise, bind the symbol to a pointer to the global's immutable value.
             value = reinterpret_cast<Uptr>(globalSpec.immutableValuePointer);
         }
-        importedSymbolMap.addOrFail(getExternalName("global", globalIndex), value);
+        importedSymbolMap.addOrFail(namePrefix + getExternalName("global", globalIndex), value);
     }
 
     // Bind exception type symbols to point to the exception type instance.
     for (Uptr exceptionTypeIndex = 0; exceptionTypeIndex < exceptionTypes.size(); ++exceptionTypeIndex) {
-        importedSymbolMap.addOrFail(getExternalName("biasedExceptionTypeId", exceptionTypeIndex),
+        importedSymbolMap.addOrFail(namePrefix + getExternalName("biasedExceptionTypeId", exceptionTypeIndex),
                                     exceptionTypes[exceptionTypeIndex].id + 1);
     }
 
-    // Allocate FunctionMutableData objects for each function def, and bind them to the symbols
-    // imported by the compiled module.
+    // Bind the FunctionMutableData objects for each function def to the symbols imported by the
+    // compiled module.
     for (Uptr functionDefIndex = 0; functionDefIndex < functionDefMutableDatas.size(); ++functionDefIndex) {
         Runtime::FunctionMutableData *functionMutableData = functionDefMutableDatas[functionDefIndex];
-        importedSymbolMap.addOrFail(getExternalName("functionDefMutableDatas", functionDefIndex), reinterpret_cast<Uptr>(functionMutableData));
+        if (!functionMutableData) {
+            continue;
+        }
+        importedSymbolMap.addOrFail(namePrefix + getExternalName("functionDefMutableDatas", functionDefIndex), reinterpret_cast<Uptr>(functionMutableData));
     }
 
     // Bind the moduleInstance symbol to point to the ModuleInstance.
     wavmAssert(moduleInstance.id != UINTPTR_MAX);
-    importedSymbolMap.addOrFail("biasedModuleInstanceId", moduleInstance.id + 1);
+    importedSymbolMap.addOrFail(namePrefix + "biasedModuleInstanceId", moduleInstance.id + 1);
 
     // Bind the tableReferenceBias symbol to the tableReferenceBias.
-    importedSymbolMap.addOrFail("tableReferenceBias", tableReferenceBias);
+    importedSymbolMap.addOrFail(namePrefix + "tableReferenceBias", tableReferenceBias);
+}
+
+std::shared_ptr<LLVMJIT::Module> LLVMJIT::loadModule(const std::vector<U8> &objectFileBytes, HashMap<std::string, FunctionBinding> &&wavmIntrinsicsExportMap, std::vector<IR::FunctionType> &&types, std::vector<FunctionBinding> &&functionImports, std::vector<FunctionBinding> &&functionDefs, std::vector<TableBinding> &&tables, std::vector<MemoryBinding> &&memories, std::vector<GlobalBinding> &&globals, std::vector<ExceptionTypeBinding> &&exceptionTypes, ModuleInstanceBinding moduleInstance, Uptr tableReferenceBias, const std::vector<Runtime::FunctionMutableData *> &functionDefMutableDatas, Uptr numaNode, std::vector<LinkedModuleBinding> &&linkedModules, std::unique_ptr<Runtime::FunctionMutableDataSlab> &&functionDefMutableDataSlab) {
+    // Bind undefined symbols in the compiled object to values.
+    HashMap<std::string, Uptr> importedSymbolMap;
+
+    // Bind the wavmIntrinsic function symbols; the compiled module assumes they have the intrinsic
+    // calling convention, so no thunking is necessary.
+    for (auto exportMapPair : wavmIntrinsicsExportMap) {
+        wavmAssert(exportMapPair.value.callingConvention == IR::CallingConvention::intrinsic);
+        importedSymbolMap.addOrFail(exportMapPair.key, reinterpret_cast<Uptr>(exportMapPair.value.code));
+    }
+
+    bindModuleSymbols(importedSymbolMap, std::string(), types, functionImports, functionDefs, tables, memories, globals, exceptionTypes, moduleInstance, tableReferenceBias, functionDefMutableDatas);
+
+    // Bind the symbols of the linked modules' code that was compiled into the module, with the
+    // prefix that distinguishes them from the module's own symbols.
+    for (Uptr linkedModuleIndex = 0; linkedModuleIndex < linkedModules.size(); ++linkedModuleIndex) {
+        const LinkedModuleBinding &linkedModule = linkedModules[linkedModuleIndex];
+        bindModuleSymbols(importedSymbolMap, getLinkedModuleNamePrefix(linkedModuleIndex), linkedModule.types, linkedModule.functionImports, linkedModule.functionDefs, linkedModule.tables, linkedModule.memories, linkedModule.globals, linkedModule.exceptionTypes, linkedModule.moduleInstance, linkedModule.tableReferenceBias, linkedModule.functionDefMutableDatas);
+    }
 
     // Load the module.
-    return std::make_shared<Module>(objectFileBytes, importedSymbolMap, true);
+    std::shared_ptr<Module> module = std::make_shared<Module>(objectFileBytes, importedSymbolMap, true, numaNode);
+    module->functionDefMutableDataSlab = std::move(functionDefMutableDataSlab);
+    return module;
 }
 
-Runtime::Function *LLVMJIT::getFunctionByAddress(Uptr address) {
-    Module *jitModule;
-    {
-        Lock<Platform::Mutex> addressToModuleMapLock(addressToModuleMapMutex);
-        auto moduleIt = addressToModuleMap.upper_bound(address);
-        if (moduleIt == addressToModuleMap.end()) {
-            return nullptr;
+void LLVMJIT::setPerfMapEnabled(bool enabled) {
+    Lock<Platform::Mutex> perfMapLock(perfMapMutex);
+    if (enabled && !perfMapFile) {
+        char path[64];
+        snprintf(path, sizeof(path), "/tmp/perf-%" PRIuPTR ".map", Platform::getProcessId());
+        perfMapFile = fopen(path, "a");
+        if (!perfMapFile) {
+            Errors::fatalf("Couldn't open %s", path);
         }
-        jitModule = moduleIt->second;
+    } else if (!enabled && perfMapFile) {
+        fclose(perfMapFile);
+        perfMapFile = nullptr;
     }
+}
+
+void LLVMJIT::setUseHugePagesForCode(bool useHugePages) {
+    useHugePagesForCode.store(useHugePages, std::memory_order_relaxed);
+}
+
+Runtime::Function *LLVMJIT::getFunctionByAddress(Uptr address) {
+    // This doesn't lock or allocate, so it's safe to call from a signal handler.
+    AddressRangeIndex<Runtime::Function *>::Range functionCodeRange;
+    return functionCodeRangeIndex.find(address, functionCodeRange) ? functionCodeRange.value : nullptr;
+}
 
-    auto functionIt = jitModule->addressToFunctionMap.upper_bound(address);
-    if (functionIt == jitModule->addressToFunctionMap.end()) {
-        return nullptr;
+bool LLVMJIT::getFunctionDebugNameByAddress(Uptr address, std::string &outDebugName) {
+    // Hold the unload mutex while the function's name is copied, so the module that contains the
+    // function can't be unloaded in between.
+    Lock<Platform::Mutex> functionUnloadLock(functionUnloadMutex);
+    AddressRangeIndex<Runtime::Function *>::Range functionCodeRange;
+    if (!functionCodeRangeIndex.find(address, functionCodeRange)) {
+        return false;
     }
-    Runtime::Function *function = functionIt->second;
-    const Uptr codeAddress = reinterpret_cast<Uptr>(function->code);
-    return address >= codeAddress && address < codeAddress + function->mutableData->numCodeBytes ? function : nullptr;
+    outDebugName = functionCodeRange.value->mutableData->debugName;
+    return true;
 }
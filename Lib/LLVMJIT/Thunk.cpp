@@ -1,6 +1,7 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "EmitContext.h"
@@ -24,11 +25,26 @@ using namespace WAVM::Runtime;
 static Platform::Mutex invokeThunkMutex;
 static HashMap<FunctionType, Runtime::Function *> invokeThunkTypeToFunctionMap;
 
-// A map from function types to JIT symbols for cached native thunks (WASM -> C++)
-static Platform::Mutex intrinsicThunkMutex;
+// A per-thread cache of invoke thunks that were already looked up in invokeThunkTypeToFunctionMap.
+// Thunks are never freed, so a cached thunk stays valid, and the common case doesn't need to take
+// invokeThunkMutex.
+static thread_local HashMap<FunctionType, InvokeThunkPointer> threadInvokeThunkCache;
+
+// A map from function types to cached batch invoke thunks (C++ -> WASM), and a per-thread cache of it.
+static Platform::Mutex batchInvokeThunkMutex;
+static HashMap<FunctionType, BatchInvokeThunkPointer> batchInvokeThunkTypeToPointerMap;
+static thread_local HashMap<FunctionType, BatchInvokeThunkPointer> threadBatchInvokeThunkCache;
+
+// A map from function types to JIT symbols for cached native thunks (WASM -> C++). Thunks are
+// looked up far more often than they are created, so lookups only take a shared lock.
+static Platform::RWMutex intrinsicThunkMutex;
 static HashMap<void *, Runtime::Function *> intrinsicFunctionToThunkFunctionMap;
 
-InvokeThunkPointer LLVMJIT::getInvokeThunk(FunctionType functionType) {
+// A map from native trap functions and function types to cached trap stubs.
+static Platform::RWMutex trapStubMutex;
+static HashMap<void *, HashMap<FunctionType, Runtime::Function *>> trapFunctionToStubMap;
+
+static InvokeThunkPointer getOrCreateInvokeThunk(FunctionType functionType) {
     Lock<Platform::Mutex> invokeThunkLock(invokeThunkMutex);
 
     // Reuse cached invoke thunks for the same function type.
@@ -42,7 +58,8 @@ InvokeThunkPointer LLVMJIT::getInvokeThunk(FunctionType functionType) {
             "thnk!C to WASM thunk!" + asString(functionType));
 
     // Create a LLVM module and a LLVM function for the thunk.
-    LLVMContext llvmContext;
+    CompileSession session;
+    LLVMContext &llvmContext = session.getLLVMContext();
     llvm::Module llvmModule("", llvmContext);
     auto llvmFunctionType = llvm::FunctionType::get(llvmContext.i8PtrType, {llvmContext.i8PtrType, llvmContext.i8PtrType}, false);
     auto function = llvm::Function::Create(llvmFunctionType, llvm::Function::ExternalLinkage, "thunk", &llvmModule);
@@ -95,10 +112,10 @@ InvokeThunkPointer LLVMJIT::getInvokeThunk(FunctionType functionType) {
     emitContext.irBuilder.CreateRet(emitContext.irBuilder.CreateLoad(emitContext.contextPointerVariable));
 
     // Compile the LLVM IR to object code.
-    std::vector<U8> objectBytes = compileLLVMModule(llvmContext, std::move(llvmModule), false);
+    std::vector<U8> objectBytes = compileLLVMModule(session, std::move(llvmModule), OptimizationLevel::O1, false);
 
     // Load the object code.
-    auto jitModule = new LLVMJIT::Module(objectBytes, {}, false);
+    auto jitModule = new LLVMJIT::Module(objectBytes, {}, false, Platform::anyNUMANode, true);
 
 #if(defined(_WIN32) && !defined(_WIN64))
     const char* thunkFunctionName = "_thunk";
@@ -109,32 +126,126 @@ InvokeThunkPointer LLVMJIT::getInvokeThunk(FunctionType functionType) {
     return reinterpret_cast<InvokeThunkPointer>(const_cast<U8 *>(invokeThunkFunction->code));
 }
 
-Runtime::Function *LLVMJIT::getIntrinsicThunk(void *nativeFunction, FunctionType functionType, CallingConvention callingConvention, const char *debugName) {
-    Lock<Platform::Mutex> intrinsicThunkLock(intrinsicThunkMutex);
+InvokeThunkPointer LLVMJIT::getInvokeThunk(FunctionType functionType) {
+    if (const InvokeThunkPointer *cachedInvokeThunk = threadInvokeThunkCache.get(functionType)) {
+        return *cachedInvokeThunk;
+    }
 
-    wavmAssert(callingConvention == CallingConvention::intrinsic ||
-               callingConvention == CallingConvention::intrinsicWithContextSwitch);
+    const InvokeThunkPointer invokeThunk = getOrCreateInvokeThunk(functionType);
+    threadInvokeThunkCache.add(functionType, invokeThunk);
+    return invokeThunk;
+}
 
-    LLVMContext llvmContext;
+static BatchInvokeThunkPointer getOrCreateBatchInvokeThunk(FunctionType functionType) {
+    Lock<Platform::Mutex> batchInvokeThunkLock(batchInvokeThunkMutex);
 
-    // Reuse cached intrinsic thunks for the same function type.
-    Runtime::Function *&intrinsicThunkFunction = intrinsicFunctionToThunkFunctionMap.getOrAdd(nativeFunction, nullptr);
-    if (intrinsicThunkFunction) {
-        return intrinsicThunkFunction;
+    BatchInvokeThunkPointer &batchInvokeThunk = batchInvokeThunkTypeToPointerMap.getOrAdd(functionType, nullptr);
+    if (batchInvokeThunk) {
+        return batchInvokeThunk;
     }
 
-    // Create a FunctionMutableData object for the thunk.
     FunctionMutableData *functionMutableData = new FunctionMutableData(
-            std::string("thnk!WASM to C thunk!(") + debugName + ')');
+            "thnk!C to WASM batch thunk!" + asString(functionType));
 
-    // Create a LLVM module containing a single function with the same signature as the native
-    // function, but with the WASM calling convention.
+    // Create a LLVM module and a LLVM function for the thunk.
+    CompileSession session;
+    LLVMContext &llvmContext = session.getLLVMContext();
     llvm::Module llvmModule("", llvmContext);
-    auto llvmFunctionType = asLLVMType(llvmContext, functionType, CallingConvention::wasm);
+    auto llvmFunctionType = llvm::FunctionType::get(llvmContext.i8PtrType, {llvmContext.i8PtrType, llvmContext.i8PtrType, llvmContext.i8PtrType, llvmContext.iptrType, llvmContext.i8PtrType}, false);
     auto function = llvm::Function::Create(llvmFunctionType, llvm::Function::ExternalLinkage, "thunk", &llvmModule);
-    function->setCallingConv(asLLVMCallingConv(callingConvention));
     setRuntimeFunctionPrefix(llvmContext, function, emitLiteralPointer(functionMutableData, llvmContext.iptrType), emitLiteral(llvmContext, Uptr(UINTPTR_MAX)), emitLiteral(llvmContext, functionType.getEncoding().impl));
 
+    llvm::Value *calleeFunction = &*(function->args().begin() + 0);
+    llvm::Value *contextPointer = &*(function->args().begin() + 1);
+    llvm::Value *argumentsPointer = &*(function->args().begin() + 2);
+    llvm::Value *numCalls = &*(function->args().begin() + 3);
+    llvm::Value *resultsPointer = &*(function->args().begin() + 4);
+
+    EmitContext emitContext(llvmContext, nullptr);
+    auto entryBlock = llvm::BasicBlock::Create(llvmContext, "entry", function);
+    auto loopBlock = llvm::BasicBlock::Create(llvmContext, "loop", function);
+    auto exitBlock = llvm::BasicBlock::Create(llvmContext, "exit", function);
+    emitContext.irBuilder.SetInsertPoint(entryBlock);
+
+    emitContext.initContextVariables(contextPointer);
+
+    llvm::Value *functionCode = emitContext.irBuilder.CreateInBoundsGEP(calleeFunction, {emitLiteral(llvmContext, Uptr(offsetof(Runtime::Function, code)))});
+    llvm::Value *typedFunctionCode = emitContext.irBuilder.CreatePointerCast(functionCode, asLLVMType(llvmContext, functionType, IR::CallingConvention::wasm)->getPointerTo());
+    emitContext.irBuilder.CreateCondBr(emitContext.irBuilder.CreateICmpEQ(numCalls, emitLiteral(llvmContext, Uptr(0))), exitBlock, loopBlock);
+
+    // Each call reads its arguments from, and writes its results to, consecutive UntaggedValues
+    // in the caller's buffers.
+    emitContext.irBuilder.SetInsertPoint(loopBlock);
+    llvm::PHINode *callIndex = emitContext.irBuilder.CreatePHI(llvmContext.iptrType, 2);
+    callIndex->addIncoming(emitLiteral(llvmContext, Uptr(0)), entryBlock);
+
+    const Uptr numArgumentBytesPerCall = functionType.params().size() * sizeof(UntaggedValue);
+    const Uptr numResultBytesPerCall = functionType.results().size() * sizeof(UntaggedValue);
+    llvm::Value *callArguments = emitContext.irBuilder.CreateInBoundsGEP(argumentsPointer, {emitContext.irBuilder.CreateMul(callIndex, emitLiteral(llvmContext, numArgumentBytesPerCall))});
+    llvm::Value *callResults = emitContext.irBuilder.CreateInBoundsGEP(resultsPointer, {emitContext.irBuilder.CreateMul(callIndex, emitLiteral(llvmContext, numResultBytesPerCall))});
+
+    std::vector<llvm::Value *> arguments;
+    for (Uptr argumentIndex = 0; argumentIndex < functionType.params().size(); ++argumentIndex) {
+        const ValueType parameterType = functionType.params()[argumentIndex];
+        arguments.push_back(emitContext.loadFromUntypedPointer(emitContext.irBuilder.CreateInBoundsGEP(callArguments, {emitLiteral(llvmContext, argumentIndex * sizeof(UntaggedValue))}), asLLVMType(llvmContext, parameterType), getTypeByteWidth(parameterType)));
+    }
+
+    // Call the function, and write its results to the results buffer.
+    ValueVector results = emitContext.emitCallOrInvoke(typedFunctionCode, arguments, functionType, IR::CallingConvention::wasm);
+    wavmAssert(results.size() == functionType.results().size());
+    for (Uptr resultIndex = 0; resultIndex < results.size(); ++resultIndex) {
+        const ValueType resultType = functionType.results()[resultIndex];
+        emitContext.storeToUntypedPointer(results[resultIndex], emitContext.irBuilder.CreateInBoundsGEP(callResults, {emitLiteral(llvmContext, resultIndex * sizeof(UntaggedValue))}), getTypeByteWidth(resultType));
+    }
+
+    llvm::Value *nextCallIndex = emitContext.irBuilder.CreateAdd(callIndex, emitLiteral(llvmContext, Uptr(1)));
+    callIndex->addIncoming(nextCallIndex, emitContext.irBuilder.GetInsertBlock());
+    emitContext.irBuilder.CreateCondBr(emitContext.irBuilder.CreateICmpULT(nextCallIndex, numCalls), loopBlock, exitBlock);
+
+    emitContext.irBuilder.SetInsertPoint(exitBlock);
+    emitContext.irBuilder.CreateRet(emitContext.irBuilder.CreateLoad(emitContext.contextPointerVariable));
+
+    // Compile the LLVM IR to object code.
+    std::vector<U8> objectBytes = compileLLVMModule(session, std::move(llvmModule), OptimizationLevel::O1, false);
+
+    // Load the object code.
+    auto jitModule = new LLVMJIT::Module(objectBytes, {}, false, Platform::anyNUMANode, true);
+
+#if(defined(_WIN32) && !defined(_WIN64))
+    const char* thunkFunctionName = "_thunk";
+#else
+    const char *thunkFunctionName = "thunk";
+#endif
+    Runtime::Function *batchInvokeThunkFunction = jitModule->nameToFunctionMap[thunkFunctionName];
+    batchInvokeThunk = reinterpret_cast<BatchInvokeThunkPointer>(const_cast<U8 *>(batchInvokeThunkFunction->code));
+    return batchInvokeThunk;
+}
+
+BatchInvokeThunkPointer LLVMJIT::getBatchInvokeThunk(FunctionType functionType) {
+    if (const BatchInvokeThunkPointer *cachedBatchInvokeThunk = threadBatchInvokeThunkCache.get(functionType)) {
+        return *cachedBatchInvokeThunk;
+    }
+
+    const BatchInvokeThunkPointer batchInvokeThunk = getOrCreateBatchInvokeThunk(functionType);
+    threadBatchInvokeThunkCache.add(functionType, batchInvokeThunk);
+    return batchInvokeThunk;
+}
+
+// Emits a function with the same signature as a native function, but with the WASM calling
+// convention, that calls the native function.
+static void emitIntrinsicThunk(LLVMContext &llvmContext, llvm::Module &llvmModule, const std::string &thunkName, const IntrinsicThunkDesc &desc) {
+    wavmAssert(desc.callingConvention == CallingConvention::intrinsic ||
+               desc.callingConvention == CallingConvention::intrinsicWithContextSwitch);
+
+    // Create a FunctionMutableData object for the thunk.
+    FunctionMutableData *functionMutableData = new FunctionMutableData(
+            std::string("thnk!WASM to C thunk!(") + desc.debugName + ')');
+
+    auto llvmFunctionType = asLLVMType(llvmContext, desc.functionType, CallingConvention::wasm);
+    auto function = llvm::Function::Create(llvmFunctionType, llvm::Function::ExternalLinkage, thunkName, &llvmModule);
+    function->setCallingConv(asLLVMCallingConv(desc.callingConvention));
+    setRuntimeFunctionPrefix(llvmContext, function, emitLiteralPointer(functionMutableData, llvmContext.iptrType), emitLiteral(llvmContext, Uptr(UINTPTR_MAX)), emitLiteral(llvmContext, desc.functionType.getEncoding().impl));
+
     EmitContext emitContext(llvmContext, nullptr);
     emitContext.irBuilder.SetInsertPoint(llvm::BasicBlock::Create(llvmContext, "entry", function));
 
@@ -145,24 +256,143 @@ Runtime::Function *LLVMJIT::getIntrinsicThunk(void *nativeFunction, FunctionType
         args.push_back(&*argIt);
     }
 
-    llvm::Type *llvmNativeFunctionType = asLLVMType(llvmContext, functionType, callingConvention)->getPointerTo();
-    llvm::Value *llvmNativeFunction = emitLiteralPointer(nativeFunction, llvmNativeFunctionType);
-    ValueVector results = emitContext.emitCallOrInvoke(llvmNativeFunction, args, functionType, callingConvention);
+    llvm::Type *llvmNativeFunctionType = asLLVMType(llvmContext, desc.functionType, desc.callingConvention)->getPointerTo();
+    llvm::Value *llvmNativeFunction = emitLiteralPointer(desc.nativeFunction, llvmNativeFunctionType);
+    ValueVector results = emitContext.emitCallOrInvoke(llvmNativeFunction, args, desc.functionType, desc.callingConvention);
 
     // Emit the function return.
-    emitContext.emitReturn(functionType.results(), results);
+    emitContext.emitReturn(desc.functionType.results(), results);
+}
+
+void LLVMJIT::getIntrinsicThunks(const IntrinsicThunkDesc *descs, Uptr numDescs, Runtime::Function **outThunks) {
+    // Reuse cached intrinsic thunks for the same native function.
+    Uptr numMissingThunks = 0;
+    {
+        SharedLock<Platform::RWMutex> intrinsicThunkLock(intrinsicThunkMutex);
+        for (Uptr descIndex = 0; descIndex < numDescs; ++descIndex) {
+            Runtime::Function *const *intrinsicThunkFunction = intrinsicFunctionToThunkFunctionMap.get(descs[descIndex].nativeFunction);
+            outThunks[descIndex] = intrinsicThunkFunction ? *intrinsicThunkFunction : nullptr;
+            if (!intrinsicThunkFunction) {
+                ++numMissingThunks;
+            }
+        }
+    }
+    if (!numMissingThunks) {
+        return;
+    }
+
+    // Another thread may have created some of the thunks before the exclusive lock was acquired.
+    Lock<Platform::RWMutex> intrinsicThunkLock(intrinsicThunkMutex);
+
+    // Emit all the missing thunks into a single LLVM module, so they are compiled and loaded
+    // together. The thunks are named by the index of the first desc for their native function.
+    CompileSession session;
+    LLVMContext &llvmContext = session.getLLVMContext();
+    llvm::Module llvmModule("", llvmContext);
+    HashMap<void *, std::string> nativeFunctionToThunkNameMap;
+    for (Uptr descIndex = 0; descIndex < numDescs; ++descIndex) {
+        const IntrinsicThunkDesc &desc = descs[descIndex];
+        if (outThunks[descIndex]) {
+            continue;
+        }
+        if (Runtime::Function *const *intrinsicThunkFunction = intrinsicFunctionToThunkFunctionMap.get(desc.nativeFunction)) {
+            outThunks[descIndex] = *intrinsicThunkFunction;
+            continue;
+        }
+        if (!nativeFunctionToThunkNameMap.contains(desc.nativeFunction)) {
+            const std::string thunkName = "thunk" + std::to_string(descIndex);
+            emitIntrinsicThunk(llvmContext, llvmModule, thunkName, desc);
+            nativeFunctionToThunkNameMap.addOrFail(desc.nativeFunction, thunkName);
+        }
+    }
+    if (!nativeFunctionToThunkNameMap.size()) {
+        return;
+    }
 
     // Compile the LLVM IR to object code.
-    std::vector<U8> objectBytes = compileLLVMModule(llvmContext, std::move(llvmModule), false);
+    std::vector<U8> objectBytes = compileLLVMModule(session, std::move(llvmModule), OptimizationLevel::O1, false);
 
     // Load the object code.
-    auto jitModule = new LLVMJIT::Module(objectBytes, {}, false);
+    auto jitModule = new LLVMJIT::Module(objectBytes, {}, false, Platform::anyNUMANode, true);
+
+    for (Uptr descIndex = 0; descIndex < numDescs; ++descIndex) {
+        if (outThunks[descIndex]) {
+            continue;
+        }
+        void *nativeFunction = descs[descIndex].nativeFunction;
+        Runtime::Function *&intrinsicThunkFunction = intrinsicFunctionToThunkFunctionMap.getOrAdd(nativeFunction, nullptr);
+        if (!intrinsicThunkFunction) {
+#if(defined(_WIN32) && !defined(_WIN64))
+            const std::string thunkFunctionName = "_" + nativeFunctionToThunkNameMap[nativeFunction];
+#else
+            const std::string &thunkFunctionName = nativeFunctionToThunkNameMap[nativeFunction];
+#endif
+            intrinsicThunkFunction = jitModule->nameToFunctionMap[thunkFunctionName];
+        }
+        outThunks[descIndex] = intrinsicThunkFunction;
+    }
+}
+
+Runtime::Function *LLVMJIT::getIntrinsicThunk(void *nativeFunction, FunctionType functionType, CallingConvention callingConvention, const char *debugName) {
+    const IntrinsicThunkDesc desc = {nativeFunction, functionType, callingConvention, debugName};
+    Runtime::Function *intrinsicThunkFunction = nullptr;
+    getIntrinsicThunks(&desc, 1, &intrinsicThunkFunction);
+    return intrinsicThunkFunction;
+}
+
+Runtime::Function *LLVMJIT::getTrapStub(void *nativeTrapFunction, FunctionType functionType) {
+    // Reuse cached trap stubs for the same trap function and function type.
+    {
+        SharedLock<Platform::RWMutex> trapStubLock(trapStubMutex);
+        if (const HashMap<FunctionType, Runtime::Function *> *typeToStubMap = trapFunctionToStubMap.get(nativeTrapFunction)) {
+            if (Runtime::Function *const *trapStubFunction = typeToStubMap->get(functionType)) {
+                return *trapStubFunction;
+            }
+        }
+    }
+
+    // Another thread may have created the stub before the exclusive lock was acquired.
+    Lock<Platform::RWMutex> trapStubLock(trapStubMutex);
+    Runtime::Function *&trapStubFunction = trapFunctionToStubMap.getOrAdd(nativeTrapFunction).getOrAdd(functionType, nullptr);
+    if (trapStubFunction) {
+        return trapStubFunction;
+    }
+
+    CompileSession session;
+    LLVMContext &llvmContext = session.getLLVMContext();
+
+    // Create a FunctionMutableData object for the stub.
+    FunctionMutableData *functionMutableData = new FunctionMutableData(
+            "thnk!trap stub!" + asString(functionType));
+
+    // Create a LLVM module containing a single function with the WASM calling convention, which
+    // ignores its arguments and calls the trap function.
+    llvm::Module llvmModule("", llvmContext);
+    auto llvmFunctionType = asLLVMType(llvmContext, functionType, CallingConvention::wasm);
+    auto function = llvm::Function::Create(llvmFunctionType, llvm::Function::ExternalLinkage, "thunk", &llvmModule);
+    function->setCallingConv(asLLVMCallingConv(CallingConvention::wasm));
+    setRuntimeFunctionPrefix(llvmContext, function, emitLiteralPointer(functionMutableData, llvmContext.iptrType), emitLiteral(llvmContext, Uptr(UINTPTR_MAX)), emitLiteral(llvmContext, functionType.getEncoding().impl));
+
+    EmitContext emitContext(llvmContext, nullptr);
+    emitContext.irBuilder.SetInsertPoint(llvm::BasicBlock::Create(llvmContext, "entry", function));
+
+    emitContext.initContextVariables(&*function->args().begin());
+
+    llvm::Type *llvmTrapFunctionType = asLLVMType(llvmContext, FunctionType(), CallingConvention::intrinsic)->getPointerTo();
+    emitContext.emitCallOrInvoke(emitLiteralPointer(nativeTrapFunction, llvmTrapFunctionType), {}, FunctionType(), CallingConvention::intrinsic);
+    emitContext.irBuilder.CreateUnreachable();
+
+    // Compile the LLVM IR to object code.
+    std::vector<U8> objectBytes = compileLLVMModule(session, std::move(llvmModule), OptimizationLevel::O1, false);
+
+    // Load the object code.
+    auto jitModule = new LLVMJIT::Module(objectBytes, {}, false, Platform::anyNUMANode, true);
 
 #if(defined(_WIN32) && !defined(_WIN64))
     const char* thunkFunctionName = "_thunk";
 #else
     const char *thunkFunctionName = "thunk";
 #endif
-    intrinsicThunkFunction = jitModule->nameToFunctionMap[thunkFunctionName];
-    return intrinsicThunkFunction;
+    trapStubFunction = jitModule->nameToFunctionMap[thunkFunctionName];
+    return trapStubFunction;
 }
@@ -243,6 +243,185 @@ static std::vector<DFAState> convertToDFA(Builder *builder) {
     return dfaStates;
 }
 
+// A partition of the integers [0, numElements) into blocks, which may be refined by marking some of
+// the elements of blocks, and splitting the marked elements of each block into a new block.
+struct RefinablePartition {
+    std::vector<U32> elements;
+    std::vector<U32> elementLocations;
+    std::vector<U32> elementBlocks;
+    std::vector<U32> blockBegins;
+    std::vector<U32> blockEnds;
+    std::vector<U32> blockNumMarkedElements;
+    std::vector<U32> touchedBlocks;
+
+    RefinablePartition(Uptr numElements) {
+        for (Uptr element = 0; element < numElements; ++element) {
+            elements.push_back(U32(element));
+            elementLocations.push_back(U32(element));
+            elementBlocks.push_back(0);
+        }
+        blockBegins.push_back(0);
+        blockEnds.push_back(U32(numElements));
+        blockNumMarkedElements.push_back(0);
+    }
+
+    Uptr getNumBlocks() const {
+        return blockBegins.size();
+    }
+
+    Uptr getBlockSize(U32 block) const {
+        return blockEnds[block] - blockBegins[block];
+    }
+
+    // Moves an element to the marked elements at the beginning of its block.
+    void mark(U32 element) {
+        const U32 block = elementBlocks[element];
+        const U32 location = elementLocations[element];
+        const U32 markedEnd = blockBegins[block] + blockNumMarkedElements[block];
+        if (location >= markedEnd) {
+            if (!blockNumMarkedElements[block]) {
+                touchedBlocks.push_back(block);
+            }
+            std::swap(elements[location], elements[markedEnd]);
+            elementLocations[elements[location]] = location;
+            elementLocations[elements[markedEnd]] = markedEnd;
+            ++blockNumMarkedElements[block];
+        }
+    }
+
+    // Splits the marked elements of each block that has both marked and unmarked elements into a
+    // new block, and calls splitCallback(block, newBlock) for each split.
+    template<typename SplitCallback> void split(SplitCallback &&splitCallback) {
+        for (U32 block : touchedBlocks) {
+            const U32 markedEnd = blockBegins[block] + blockNumMarkedElements[block];
+            blockNumMarkedElements[block] = 0;
+            if (markedEnd == blockEnds[block]) {
+                continue;
+            }
+
+            const U32 newBlock = U32(blockBegins.size());
+            blockBegins.push_back(blockBegins[block]);
+            blockEnds.push_back(markedEnd);
+            blockNumMarkedElements.push_back(0);
+            blockBegins[block] = markedEnd;
+            for (U32 location = blockBegins[newBlock]; location < markedEnd; ++location) {
+                elementBlocks[elements[location]] = newBlock;
+            }
+            splitCallback(block, newBlock);
+        }
+        touchedBlocks.clear();
+    }
+};
+
+// Merges equivalent DFA states with Hopcroft's algorithm. Transitions to terminal states are
+// treated as transitions to a distinct pseudo-state for each terminal state, so only DFA states
+// with the same transitions to terminal states may be merged. The start state stays state 0.
+static std::vector<DFAState> minimizeDFA(const std::vector<DFAState> &dfaStates) {
+    const Uptr numDFAStates = dfaStates.size();
+
+    // Give each terminal state a pseudo-state index following the DFA states.
+    HashMap<StateIndex, U32> terminalStateToPseudoStateMap;
+    for (const DFAState &dfaState : dfaStates) {
+        for (Uptr charIndex = 0; charIndex < 256; ++charIndex) {
+            const StateIndex nextState = dfaState.nextStateByChar[charIndex];
+            if (nextState < 0 && !terminalStateToPseudoStateMap.contains(nextState)) {
+                terminalStateToPseudoStateMap.set(nextState, U32(numDFAStates + terminalStateToPseudoStateMap.size()));
+            }
+        }
+    }
+    const Uptr numStates = numDFAStates + terminalStateToPseudoStateMap.size();
+    auto getNextState = [&](Uptr stateIndex, Uptr charIndex) -> U32 {
+        const StateIndex nextState = dfaStates[stateIndex].nextStateByChar[charIndex];
+        return nextState >= 0 ? U32(nextState) : terminalStateToPseudoStateMap[nextState];
+    };
+
+    // Build the inverse transition map: for each character and state, the DFA states that
+    // transition to it on that character.
+    std::vector<U32> predecessorBegins(256 * numStates + 1, 0);
+    for (Uptr stateIndex = 0; stateIndex < numDFAStates; ++stateIndex) {
+        for (Uptr charIndex = 0; charIndex < 256; ++charIndex) {
+            ++predecessorBegins[charIndex * numStates + getNextState(stateIndex, charIndex) + 1];
+        }
+    }
+    for (Uptr index = 1; index < predecessorBegins.size(); ++index) {
+        predecessorBegins[index] += predecessorBegins[index - 1];
+    }
+    std::vector<U32> predecessors(256 * numDFAStates);
+    {
+        std::vector<U32> predecessorEnds(predecessorBegins.begin(), predecessorBegins.end() - 1);
+        for (Uptr stateIndex = 0; stateIndex < numDFAStates; ++stateIndex) {
+            for (Uptr charIndex = 0; charIndex < 256; ++charIndex) {
+                predecessors[predecessorEnds[charIndex * numStates + getNextState(stateIndex, charIndex)]++] = U32(stateIndex);
+            }
+        }
+    }
+
+    // Start with the DFA states in one block, and each terminal pseudo-state in its own block.
+    RefinablePartition partition(numStates);
+    for (U32 pseudoState = U32(numDFAStates); pseudoState < numStates; ++pseudoState) {
+        partition.mark(pseudoState);
+        partition.split([](U32, U32) {});
+    }
+
+    // Refine the partition until no block's predecessors on any character split another block.
+    // When a block that is waiting to be used as a splitter is split, both halves must be used,
+    // but otherwise only the smaller half needs to be.
+    std::vector<U32> pendingSplitters;
+    std::vector<bool> isPendingSplitter;
+    for (U32 block = 0; block < partition.getNumBlocks(); ++block) {
+        pendingSplitters.push_back(block);
+        isPendingSplitter.push_back(true);
+    }
+    std::vector<U32> splitterStates;
+    while (pendingSplitters.size()) {
+        const U32 splitter = pendingSplitters.back();
+        pendingSplitters.pop_back();
+        isPendingSplitter[splitter] = false;
+
+        splitterStates.assign(partition.elements.begin() + partition.blockBegins[splitter], partition.elements.begin() + partition.blockEnds[splitter]);
+        for (Uptr charIndex = 0; charIndex < 256; ++charIndex) {
+            for (U32 state : splitterStates) {
+                const Uptr predecessorIndex = charIndex * numStates + state;
+                for (U32 index = predecessorBegins[predecessorIndex]; index < predecessorBegins[predecessorIndex + 1]; ++index) {
+                    partition.mark(predecessors[index]);
+                }
+            }
+            partition.split([&](U32 block, U32 newBlock) {
+                isPendingSplitter.push_back(false);
+                if (isPendingSplitter[block] || partition.getBlockSize(newBlock) <= partition.getBlockSize(block)) {
+                    pendingSplitters.push_back(newBlock);
+                    isPendingSplitter[newBlock] = true;
+                } else {
+                    pendingSplitters.push_back(block);
+                    isPendingSplitter[block] = true;
+                }
+            });
+        }
+    }
+
+    // Number the blocks of DFA states in the order of their first state, so the start state's block
+    // is state 0, and build the minimized DFA from a representative state of each block.
+    std::vector<StateIndex> blockToMinimizedStateMap(partition.getNumBlocks(), -1);
+    std::vector<Uptr> minimizedStateRepresentatives;
+    for (Uptr stateIndex = 0; stateIndex < numDFAStates; ++stateIndex) {
+        const U32 block = partition.elementBlocks[stateIndex];
+        if (blockToMinimizedStateMap[block] < 0) {
+            blockToMinimizedStateMap[block] = StateIndex(minimizedStateRepresentatives.size());
+            minimizedStateRepresentatives.push_back(stateIndex);
+        }
+    }
+
+    std::vector<DFAState> minimizedDFAStates(minimizedStateRepresentatives.size());
+    for (Uptr minimizedStateIndex = 0; minimizedStateIndex < minimizedDFAStates.size(); ++minimizedStateIndex) {
+        const DFAState &dfaState = dfaStates[minimizedStateRepresentatives[minimizedStateIndex]];
+        for (Uptr charIndex = 0; charIndex < 256; ++charIndex) {
+            const StateIndex nextState = dfaState.nextStateByChar[charIndex];
+            minimizedDFAStates[minimizedStateIndex].nextStateByChar[charIndex] = nextState < 0 ? nextState : blockToMinimizedStateMap[partition.elementBlocks[nextState]];
+        }
+    }
+    return minimizedDFAStates;
+}
+
 struct StateTransitionsByChar {
     U8 c;
     StateIndex *nextStateByInitialState;
@@ -282,9 +461,9 @@ struct StateTransitionsByChar {
 };
 
 NFA::Machine::Machine(Builder *builder) {
-    // Convert the NFA constructed by the builder to a DFA.
-    std::vector<DFAState> dfaStates = convertToDFA(builder);
-    wavmAssert(dfaStates.size() <= internalMaxStates);
+    // Convert the NFA constructed by the builder to a DFA, and merge its equivalent states.
+    std::vector<DFAState> dfaStates = minimizeDFA(convertToDFA(builder));
+    errorUnless(dfaStates.size() <= internalMaxStates);
     delete builder;
 
     // Transpose the [state][character] transition map to [character][state].
@@ -317,13 +496,15 @@ NFA::Machine::Machine(Builder *builder) {
     }
 
     // Build a [charClass][state] transition map.
-    stateAndOffsetToNextStateMap = new InternalStateIndex[numClasses * numStates];
+    InternalStateIndex *nextStateMap = new InternalStateIndex[numClasses * numStates];
     for (Uptr classIndex = 0; classIndex < numClasses; ++classIndex) {
         for (Uptr stateIndex = 0; stateIndex < numStates; ++stateIndex) {
-            stateAndOffsetToNextStateMap[stateIndex + classIndex *
-                                                      numStates] = InternalStateIndex(dfaStates[stateIndex].nextStateByChar[representativeCharsByClass[classIndex]]);
+            nextStateMap[stateIndex + classIndex *
+                         numStates] = InternalStateIndex(dfaStates[stateIndex].nextStateByChar[representativeCharsByClass[classIndex]]);
         }
     }
+    stateAndOffsetToNextStateMap = nextStateMap;
+    ownsStateAndOffsetToNextStateMap = true;
 
     // Build a map from character index to offset into [charClass][initialState] transition map.
     wavmAssert((numClasses - 1) * (numStates - 1) <= UINT32_MAX);
@@ -333,21 +514,103 @@ NFA::Machine::Machine(Builder *builder) {
 
 }
 
+NFA::Machine::Machine(const U32 inCharToOffsetMap[256], const StateIndex *inStateAndOffsetToNextStateMap, Uptr inNumClasses, Uptr inNumStates)
+        : stateAndOffsetToNextStateMap(inStateAndOffsetToNextStateMap), ownsStateAndOffsetToNextStateMap(false), numClasses(inNumClasses), numStates(inNumStates) {
+    memcpy(charToOffsetMap, inCharToOffsetMap, sizeof(charToOffsetMap));
+}
+
 NFA::Machine::~Machine() {
-    if (stateAndOffsetToNextStateMap) {
+    if (stateAndOffsetToNextStateMap && ownsStateAndOffsetToNextStateMap) {
         delete[] stateAndOffsetToNextStateMap;
-        stateAndOffsetToNextStateMap = nullptr;
     }
+    stateAndOffsetToNextStateMap = nullptr;
 }
 
 void NFA::Machine::moveFrom(Machine &&inMachine) {
     memcpy(charToOffsetMap, inMachine.charToOffsetMap, sizeof(charToOffsetMap));
     stateAndOffsetToNextStateMap = inMachine.stateAndOffsetToNextStateMap;
+    ownsStateAndOffsetToNextStateMap = inMachine.ownsStateAndOffsetToNextStateMap;
     inMachine.stateAndOffsetToNextStateMap = nullptr;
     numClasses = inMachine.numClasses;
     numStates = inMachine.numStates;
 }
 
+NFA::CompactMachine::CompactMachine(const Machine &machine) {
+    const Uptr numStates = machine.numStates;
+    const Uptr numClasses = machine.numClasses;
+    for (Uptr charIndex = 0; charIndex < 256; ++charIndex) {
+        charToClassMap[charIndex] = U8(machine.charToOffsetMap[charIndex] / numStates);
+    }
+
+    // Use each state's most common transition as its default, and collect the classes of the
+    // transitions that differ from the default.
+    std::vector<std::vector<U8>> exceptionClassesByState(numStates);
+    rows.resize(numStates);
+    for (Uptr stateIndex = 0; stateIndex < numStates; ++stateIndex) {
+        HashMap<StateIndex, Uptr> nextStateCounts;
+        StateIndex defaultNextState = 0;
+        Uptr defaultNextStateCount = 0;
+        for (Uptr classIndex = 0; classIndex < numClasses; ++classIndex) {
+            const StateIndex nextState = machine.stateAndOffsetToNextStateMap[stateIndex + classIndex * numStates];
+            const Uptr count = ++nextStateCounts.getOrAdd(nextState, 0);
+            if (count > defaultNextStateCount) {
+                defaultNextState = nextState;
+                defaultNextStateCount = count;
+            }
+        }
+        rows[stateIndex].defaultNextState = defaultNextState;
+        for (Uptr classIndex = 0; classIndex < numClasses; ++classIndex) {
+            if (machine.stateAndOffsetToNextStateMap[stateIndex + classIndex * numStates] != defaultNextState) {
+                exceptionClassesByState[stateIndex].push_back(U8(classIndex));
+            }
+        }
+    }
+
+    // Place the states with the most exceptions first, each at the first offset where the slots
+    // for its exceptions are free.
+    std::vector<Uptr> statesByNumExceptions;
+    for (Uptr stateIndex = 0; stateIndex < numStates; ++stateIndex) {
+        statesByNumExceptions.push_back(stateIndex);
+    }
+    std::stable_sort(statesByNumExceptions.begin(), statesByNumExceptions.end(), [&](Uptr left, Uptr right) {
+        return exceptionClassesByState[left].size() > exceptionClassesByState[right].size();
+    });
+
+    // A slot's state is -1 while it is unused, which never matches the non-terminal states that
+    // are looked up in the table.
+    const Slot unusedSlot = {-1, -1};
+    slots.assign(numClasses, unusedSlot);
+    for (Uptr stateIndex : statesByNumExceptions) {
+        const std::vector<U8> &exceptionClasses = exceptionClassesByState[stateIndex];
+        Uptr slotBase = 0;
+        if (exceptionClasses.size()) {
+            while (true) {
+                bool fits = true;
+                for (U8 classIndex : exceptionClasses) {
+                    if (slotBase + classIndex < slots.size() && slots[slotBase + classIndex].state != -1) {
+                        fits = false;
+                        break;
+                    }
+                }
+                if (fits) {
+                    break;
+                }
+                ++slotBase;
+            }
+        }
+        errorUnless(slotBase <= UINT32_MAX);
+
+        if (slots.size() < slotBase + numClasses) {
+            slots.resize(slotBase + numClasses, unusedSlot);
+        }
+        rows[stateIndex].slotBase = U32(slotBase);
+        for (U8 classIndex : exceptionClasses) {
+            slots[slotBase + classIndex].state = StateIndex(stateIndex);
+            slots[slotBase + classIndex].nextState = machine.stateAndOffsetToNextStateMap[stateIndex + classIndex * numStates];
+        }
+    }
+}
+
 static char nibbleToHexChar(U8 value) {
     return value < 10 ? ('0' + value) : 'a' + value - 10;
 }
@@ -549,3 +812,22 @@ std::string NFA::Machine::dumpDFAGraphViz() const {
     result += "}\n";
     return result;
 }
+
+std::string NFA::Machine::dumpCppTables(const char *name) const {
+    std::string result;
+    result += "static constexpr Uptr " + std::string(name) + "NumClasses = " + std::to_string(numClasses) + ";\n";
+    result += "static constexpr Uptr " + std::string(name) + "NumStates = " + std::to_string(numStates) + ";\n";
+
+    result += "static const U32 " + std::string(name) + "CharToOffsetMap[256] = {";
+    for (Uptr charIndex = 0; charIndex < 256; ++charIndex) {
+        result += (charIndex % 16 ? " " : "\n    ") + std::to_string(charToOffsetMap[charIndex]) + ",";
+    }
+    result += "\n};\n";
+
+    result += "static const WAVM::NFA::StateIndex " + std::string(name) + "StateAndOffsetToNextStateMap[" + std::to_string(numClasses * numStates) + "] = {";
+    for (Uptr index = 0; index < numClasses * numStates; ++index) {
+        result += (index % 16 ? " " : "\n    ") + std::to_string(stateAndOffsetToNextStateMap[index]) + ",";
+    }
+    result += "\n};\n";
+    return result;
+}
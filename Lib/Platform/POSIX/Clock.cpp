@@ -0,0 +1,14 @@
+#include <time.h>
+
+#include "WAVM/Inline/Assert.h"
+#include "WAVM/Inline/Errors.h"
+#include "WAVM/Platform/Clock.h"
+
+using namespace WAVM;
+using namespace WAVM::Platform;
+
+U64 Platform::getMonotonicClock() {
+    timespec monotonicClock;
+    errorUnless(!clock_gettime(CLOCK_MONOTONIC, &monotonicClock));
+    return U64(monotonicClock.tv_sec) * 1000000 + U64(monotonicClock.tv_nsec) / 1000;
+}
@@ -1,14 +1,67 @@
 #include <errno.h>
 #include <pthread.h>
+#include <time.h>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 #include "WAVM/Inline/Assert.h"
 #include "WAVM/Inline/Errors.h"
+#include "WAVM/Platform/Clock.h"
 #include "WAVM/Platform/Event.h"
 
 using namespace WAVM;
 using namespace WAVM::Platform;
 
-Platform::Event::Event() {
+#ifdef __linux__
+
+Platform::Event::Event() : futexWord(0) {
+    static_assert(sizeof(futexWord) == sizeof(U32), "futexWord must be a plain 32-bit word");
+}
+
+Platform::Event::~Event() {}
+
+bool Platform::Event::wait(U64 untilTime) {
+    while (true) {
+        if (futexWord.exchange(0, std::memory_order_acquire)) {
+            return true;
+        }
+
+        timespec timeout;
+        timespec *timeoutPointer = nullptr;
+        if (untilTime != UINT64_MAX) {
+            const U64 currentTime = getMonotonicClock();
+            if (currentTime >= untilTime) {
+                return false;
+            }
+
+            // FUTEX_WAIT takes a timeout relative to now, measured by the monotonic clock.
+            const U64 remainingMicroseconds = untilTime - currentTime;
+            timeout.tv_sec = time_t(remainingMicroseconds / 1000000);
+            timeout.tv_nsec = long(remainingMicroseconds % 1000000) * 1000;
+            timeoutPointer = &timeout;
+        }
+
+        // Sleep until the futex word changes from 0. Spurious wakeups, EAGAIN if the event was
+        // signaled before the syscall, and timeouts are all handled by checking the word again.
+        if (syscall(SYS_futex, reinterpret_cast<U32 *>(&futexWord), FUTEX_WAIT_PRIVATE, 0, timeoutPointer, nullptr, 0) == -1) {
+            errorUnless(errno == EAGAIN || errno == EINTR || errno == ETIMEDOUT);
+        }
+    }
+}
+
+void Platform::Event::signal() {
+    if (!futexWord.exchange(1, std::memory_order_release)) {
+        syscall(SYS_futex, reinterpret_cast<U32 *>(&futexWord), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+    }
+}
+
+#else
+
+Platform::Event::Event() : isSignaled(false) {
     static_assert(sizeof(pthreadMutex) == sizeof(pthread_mutex_t), "");
     static_assert(alignof(PthreadMutex) >= alignof(pthread_mutex_t), "");
 
@@ -23,7 +76,7 @@ Platform::Event::Event() {
     errorUnless(!pthread_condattr_setclock(&conditionVariableAttr, CLOCK_MONOTONIC));
 #endif
 
-    errorUnless(!pthread_cond_init((pthread_cond_t *) &pthreadCond, nullptr));
+    errorUnless(!pthread_cond_init((pthread_cond_t *) &pthreadCond, &conditionVariableAttr));
     errorUnless(!pthread_mutex_init((pthread_mutex_t *) &pthreadMutex, nullptr));
 
     errorUnless(!pthread_condattr_destroy(&conditionVariableAttr));
@@ -32,4 +85,50 @@ Platform::Event::Event() {
 Platform::Event::~Event() {
     pthread_cond_destroy((pthread_cond_t *) &pthreadCond);
     errorUnless(!pthread_mutex_destroy((pthread_mutex_t *) &pthreadMutex));
-}
\ No newline at end of file
+}
+
+bool Platform::Event::wait(U64 untilTime) {
+    errorUnless(!pthread_mutex_lock((pthread_mutex_t *) &pthreadMutex));
+
+    while (!isSignaled) {
+        if (untilTime == UINT64_MAX) {
+            errorUnless(!pthread_cond_wait((pthread_cond_t *) &pthreadCond, (pthread_mutex_t *) &pthreadMutex));
+            continue;
+        }
+
+        const U64 currentTime = getMonotonicClock();
+        if (currentTime >= untilTime) {
+            break;
+        }
+
+#ifdef __APPLE__
+        // Apple doesn't support monotonic clock condition variables, but does support waiting for a
+        // relative timeout.
+        const U64 remainingMicroseconds = untilTime - currentTime;
+        timespec timeout;
+        timeout.tv_sec = time_t(remainingMicroseconds / 1000000);
+        timeout.tv_nsec = long(remainingMicroseconds % 1000000) * 1000;
+        const int result = pthread_cond_timedwait_relative_np((pthread_cond_t *) &pthreadCond, (pthread_mutex_t *) &pthreadMutex, &timeout);
+#else
+        timespec timeout;
+        timeout.tv_sec = time_t(untilTime / 1000000);
+        timeout.tv_nsec = long(untilTime % 1000000) * 1000;
+        const int result = pthread_cond_timedwait((pthread_cond_t *) &pthreadCond, (pthread_mutex_t *) &pthreadMutex, &timeout);
+#endif
+        errorUnless(!result || result == ETIMEDOUT);
+    }
+
+    const bool wasSignaled = isSignaled;
+    isSignaled = false;
+    errorUnless(!pthread_mutex_unlock((pthread_mutex_t *) &pthreadMutex));
+    return wasSignaled;
+}
+
+void Platform::Event::signal() {
+    errorUnless(!pthread_mutex_lock((pthread_mutex_t *) &pthreadMutex));
+    isSignaled = true;
+    errorUnless(!pthread_cond_signal((pthread_cond_t *) &pthreadCond));
+    errorUnless(!pthread_mutex_unlock((pthread_mutex_t *) &pthreadMutex));
+}
+
+#endif
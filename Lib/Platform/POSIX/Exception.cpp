@@ -0,0 +1,402 @@
+#include <errno.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <setjmp.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+#include <ucontext.h>
+#include <unistd.h>
+#include <atomic>
+
+#include "POSIXPrivate.h"
+#include "WAVM/Inline/Assert.h"
+#include "WAVM/Inline/Errors.h"
+#include "WAVM/Platform/Exception.h"
+#include "WAVM/Platform/Memory.h"
+
+#ifdef __APPLE__
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+
+using namespace WAVM;
+using namespace WAVM::Platform;
+
+// The number of bytes of the alternate stack that signal handlers run on. Filters run on it too, so
+// it is larger than MINSIGSTKSZ.
+static constexpr Uptr signalStackNumBytes = 64 * 1024;
+
+// A fault this far below the thread's stack is treated as a stack overflow, since a function's
+// frame may skip over the guard page.
+static constexpr Uptr stackOverflowGuardNumBytes = 1024 * 1024;
+
+// The maximum number of frames in the call stack passed to a filter. The handler doesn't allocate,
+// so the call stack is preallocated with this capacity.
+static constexpr Uptr maxSignalCallStackFrames = 1;
+
+struct SignalContext {
+    SignalContext *outerContext;
+    sigjmp_buf catchJump;
+    const std::function<bool(Signal, const CallStack &)> *filter;
+};
+
+// The per-thread state used by the signal handler. It is initialized by the first catchSignals on a
+// thread, before the handler may run on the thread, so the handler never allocates it.
+struct SignalThreadState {
+    SignalContext *innermostSignalContext = nullptr;
+
+    U8 *signalStack = nullptr;
+    U8 *stackMinGuardAddress = nullptr;
+    U8 *stackMaxAddress = nullptr;
+
+    SignalStackState *resumerStackState = nullptr;
+    sigjmp_buf *fiberBaseJump = nullptr;
+    SignalContext *forwardedSignalContext = nullptr;
+
+    CallStack callStack;
+
+    SignalThreadState() {
+        // Allocate the alternate signal stack, with an inaccessible guard page below it, so a signal
+        // handler that overflows it faults instead of corrupting memory.
+        const Uptr pageNumBytes = Uptr(1) << getPageSizeLog2();
+        void *mapping = mmap(nullptr, pageNumBytes + signalStackNumBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        errorUnless(mapping != MAP_FAILED);
+        signalStack = reinterpret_cast<U8 *>(mapping);
+        errorUnless(!mprotect(signalStack, pageNumBytes, PROT_NONE));
+
+        stack_t altStack;
+        altStack.ss_sp = signalStack + pageNumBytes;
+        altStack.ss_size = signalStackNumBytes;
+        altStack.ss_flags = 0;
+        errorUnless(!sigaltstack(&altStack, nullptr));
+
+        // Find the thread's stack, to distinguish stack overflows from other access violations.
+        U8 *stackMinAddress;
+#ifdef __APPLE__
+        stackMaxAddress = reinterpret_cast<U8 *>(pthread_get_stackaddr_np(pthread_self()));
+        stackMinAddress = stackMaxAddress - pthread_get_stacksize_np(pthread_self());
+#else
+        pthread_attr_t threadAttributes;
+        errorUnless(!pthread_getattr_np(pthread_self(), &threadAttributes));
+        void *stackAddress;
+        size_t stackNumBytes;
+        errorUnless(!pthread_attr_getstack(&threadAttributes, &stackAddress, &stackNumBytes));
+        errorUnless(!pthread_attr_destroy(&threadAttributes));
+        stackMinAddress = reinterpret_cast<U8 *>(stackAddress);
+        stackMaxAddress = stackMinAddress + stackNumBytes;
+#endif
+        stackMinGuardAddress = stackMinAddress - stackOverflowGuardNumBytes;
+
+        callStack.stackFrames.reserve(maxSignalCallStackFrames);
+    }
+
+    ~SignalThreadState() {
+        stack_t altStack;
+        memset(&altStack, 0, sizeof(altStack));
+        altStack.ss_flags = SS_DISABLE;
+        sigaltstack(&altStack, nullptr);
+
+        const Uptr pageNumBytes = Uptr(1) << getPageSizeLog2();
+        munmap(signalStack, pageNumBytes + signalStackNumBytes);
+    }
+};
+
+// The signal handler only reads this plain pointer to the thread's state, which doesn't need the
+// lazy initialization of a thread_local with a constructor.
+static thread_local SignalThreadState *signalThreadState = nullptr;
+
+static SignalThreadState &getSignalThreadState() {
+    // The state is destroyed when the thread exits.
+    struct SignalThreadStateOwner {
+        SignalThreadState state;
+
+        SignalThreadStateOwner() {
+            signalThreadState = &state;
+        }
+
+        ~SignalThreadStateOwner() {
+            signalThreadState = nullptr;
+        }
+    };
+    static thread_local SignalThreadStateOwner owner;
+    return owner.state;
+}
+
+// Returns the instruction pointer at which a signal was raised.
+static Uptr getSignalInstructionPointer(void *signalContext) {
+    const ucontext_t *context = reinterpret_cast<const ucontext_t *>(signalContext);
+#if defined(__APPLE__) && defined(__x86_64__)
+    return Uptr(context->uc_mcontext->__ss.__rip);
+#elif defined(__APPLE__) && defined(__aarch64__)
+    return Uptr(context->uc_mcontext->__ss.__pc);
+#elif defined(__linux__) && defined(__x86_64__)
+    return Uptr(context->uc_mcontext.gregs[REG_RIP]);
+#elif defined(__linux__) && defined(__aarch64__)
+    return Uptr(context->uc_mcontext.pc);
+#else
+    return 0;
+#endif
+}
+
+// Returns the stack and frame pointers of the code that was interrupted by a signal.
+static bool getSignalStackAndFramePointers(void *signalContext, Uptr &outStackPointer, Uptr &outFramePointer) {
+    const ucontext_t *context = reinterpret_cast<const ucontext_t *>(signalContext);
+#if defined(__APPLE__) && defined(__x86_64__)
+    outStackPointer = Uptr(context->uc_mcontext->__ss.__rsp);
+    outFramePointer = Uptr(context->uc_mcontext->__ss.__rbp);
+    return true;
+#elif defined(__APPLE__) && defined(__aarch64__)
+    outStackPointer = Uptr(context->uc_mcontext->__ss.__sp);
+    outFramePointer = Uptr(context->uc_mcontext->__ss.__fp);
+    return true;
+#elif defined(__linux__) && defined(__x86_64__)
+    outStackPointer = Uptr(context->uc_mcontext.gregs[REG_RSP]);
+    outFramePointer = Uptr(context->uc_mcontext.gregs[REG_RBP]);
+    return true;
+#elif defined(__linux__) && defined(__aarch64__)
+    outStackPointer = Uptr(context->uc_mcontext.sp);
+    outFramePointer = Uptr(context->uc_mcontext.regs[29]);
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Calls the filters of the signal contexts on this thread, from innermost to outermost, until one
+// returns true, and jumps back to the catchSignals that installed it. The contexts on this stack are
+// followed by those on the stacks that resumed its fiber. Jumping straight to one of those would
+// leave the fiber running, so the signal is forwarded to it through the fiber's base. Returns if no
+// filter accepts the signal. Like the signal handler, this must not lock or allocate.
+static void deliverSignal(SignalThreadState *threadState, const Signal &signal, Uptr instructionAddress) {
+    CallStack &callStack = threadState->callStack;
+    callStack.stackFrames.clear();
+    callStack.stackFrames.push_back({instructionAddress});
+
+    SignalContext *context = threadState->innermostSignalContext;
+    SignalStackState *stackState = nullptr;
+    while (true) {
+        for (; context; context = context->outerContext) {
+            if ((*context->filter)(signal, callStack)) {
+                if (!stackState) {
+                    threadState->innermostSignalContext = context->outerContext;
+                    siglongjmp(context->catchJump, 1);
+                } else {
+                    threadState->forwardedSignalContext = context;
+                    siglongjmp(*threadState->fiberBaseJump, 1);
+                }
+            }
+        }
+
+        stackState = stackState ? stackState->resumerStackState : threadState->resumerStackState;
+        if (!stackState) {
+            break;
+        }
+        context = reinterpret_cast<SignalContext *>(stackState->innermostSignalContext);
+    }
+}
+
+static void signalHandler(int signalNumber, siginfo_t *signalInfo, void *signalContext) {
+    // This runs on the thread's alternate signal stack, and must not lock or allocate: the signal
+    // may have interrupted the allocator or a lock holder.
+    SignalThreadState *threadState = signalThreadState;
+
+    Signal signal;
+    switch (signalNumber) {
+        case SIGFPE:
+            if (signalInfo->si_code == FPE_INTDIV || signalInfo->si_code == FPE_INTOVF) {
+                signal.type = Signal::Type::intDivideByZeroOrOverflow;
+            }
+            break;
+        case SIGSEGV:
+        case SIGBUS: {
+            U8 *address = reinterpret_cast<U8 *>(signalInfo->si_addr);
+            signal.type = threadState && address >= threadState->stackMinGuardAddress && address < threadState->stackMaxAddress ? Signal::Type::stackOverflow : Signal::Type::accessViolation;
+            signal.accessViolation.address = Uptr(address);
+            break;
+        }
+        default:
+            break;
+    };
+
+    if (threadState && signal.type != Signal::Type::invalid) {
+        deliverSignal(threadState, signal, getSignalInstructionPointer(signalContext));
+    }
+
+    // If no filter handled the signal, restore the default action and return: the faulting
+    // instruction raises the signal again, and the process terminates as it would have without the
+    // handler.
+    struct sigaction defaultAction;
+    memset(&defaultAction, 0, sizeof(defaultAction));
+    defaultAction.sa_handler = SIG_DFL;
+    sigemptyset(&defaultAction.sa_mask);
+    sigaction(signalNumber, &defaultAction, nullptr);
+}
+
+static void installSignalHandlers() {
+    struct sigaction signalAction;
+    memset(&signalAction, 0, sizeof(signalAction));
+    signalAction.sa_sigaction = signalHandler;
+    sigemptyset(&signalAction.sa_mask);
+    signalAction.sa_flags = SA_SIGINFO | SA_ONSTACK;
+    errorUnless(!sigaction(SIGSEGV, &signalAction, nullptr));
+    errorUnless(!sigaction(SIGBUS, &signalAction, nullptr));
+    errorUnless(!sigaction(SIGFPE, &signalAction, nullptr));
+}
+
+bool Platform::catchSignals(const std::function<void()> &thunk, const std::function<bool(Signal signal, const CallStack &)> &filter) {
+    // Install the process's signal handlers the first time any thread catches signals, and this
+    // thread's alternate signal stack the first time it catches signals.
+    static const bool areSignalHandlersInstalled = (installSignalHandlers(), true);
+    SUPPRESS_UNUSED(areSignalHandlersInstalled);
+    SignalThreadState &threadState = getSignalThreadState();
+
+    SignalContext signalContext;
+    signalContext.outerContext = threadState.innermostSignalContext;
+    signalContext.filter = &filter;
+
+    // Save the execution state, including the signal mask, which is restored when the signal handler
+    // jumps back here. The handler pops this context before jumping.
+    if (sigsetjmp(signalContext.catchJump, 1)) {
+        return true;
+    }
+
+    threadState.innermostSignalContext = &signalContext;
+    try {
+        thunk();
+    } catch (...) {
+        threadState.innermostSignalContext = signalContext.outerContext;
+        throw;
+    }
+    threadState.innermostSignalContext = signalContext.outerContext;
+    return false;
+}
+
+void Platform::raiseSignal(const Signal &signal, Uptr instructionAddress) {
+    // The thread's state only exists once it has called catchSignals, and without it there are no
+    // filters to accept the signal.
+    if (signalThreadState) {
+        deliverSignal(signalThreadState, signal, instructionAddress);
+    }
+    Errors::fatalf("The signal raised at 0x%" PRIxPTR " wasn't caught", instructionAddress);
+}
+
+void Platform::exchangeSignalStackState(SignalStackState &state) {
+    SignalThreadState &threadState = getSignalThreadState();
+
+    SignalStackState threadStackState;
+    threadStackState.innermostSignalContext = threadState.innermostSignalContext;
+    threadStackState.stackMinGuardAddress = threadState.stackMinGuardAddress;
+    threadStackState.stackMaxAddress = threadState.stackMaxAddress;
+    threadStackState.resumerStackState = threadState.resumerStackState;
+    threadStackState.fiberBaseJump = threadState.fiberBaseJump;
+
+    threadState.innermostSignalContext = reinterpret_cast<SignalContext *>(state.innermostSignalContext);
+    threadState.stackMinGuardAddress = state.stackMinGuardAddress;
+    threadState.stackMaxAddress = state.stackMaxAddress;
+    threadState.resumerStackState = state.resumerStackState;
+    threadState.fiberBaseJump = state.fiberBaseJump;
+    state = threadStackState;
+}
+
+void *Platform::takeForwardedSignalContext() {
+    SignalThreadState &threadState = getSignalThreadState();
+    SignalContext *signalContext = threadState.forwardedSignalContext;
+    threadState.forwardedSignalContext = nullptr;
+    return signalContext;
+}
+
+void Platform::deliverForwardedSignal(void *signalContextVoid) {
+    SignalThreadState &threadState = getSignalThreadState();
+    SignalContext *signalContext = reinterpret_cast<SignalContext *>(signalContextVoid);
+
+    for (SignalContext *context = threadState.innermostSignalContext; context; context = context->outerContext) {
+        if (context == signalContext) {
+            threadState.innermostSignalContext = signalContext->outerContext;
+            siglongjmp(signalContext->catchJump, 1);
+        }
+    }
+
+    errorUnless(threadState.fiberBaseJump);
+    threadState.forwardedSignalContext = signalContext;
+    siglongjmp(*threadState.fiberBaseJump, 1);
+}
+
+static std::atomic<ProfileSampleCallback> profileSampleCallback{nullptr};
+
+static void profilingSignalHandler(int signalNumber, siginfo_t *signalInfo, void *signalContext) {
+    // Like signalHandler, this must not lock or allocate. It also preserves errno, since it may
+    // interrupt any code.
+    const int savedErrno = errno;
+    ProfileSampleCallback callback = profileSampleCallback.load(std::memory_order_acquire);
+    if (callback) {
+        Uptr ips[maxProfileSampleFrames];
+        Uptr numFrames = 0;
+        ips[numFrames++] = getSignalInstructionPointer(signalContext);
+
+        // Follow the chain of frame pointers. Each frame starts with the caller's frame pointer,
+        // followed by the return address. The chain is only followed while it stays within the
+        // interrupted thread's stack, so a frame pointer register that is used for other data in
+        // code without frame pointers can't cause a fault.
+        SignalThreadState *threadState = signalThreadState;
+        Uptr stackPointer;
+        Uptr framePointer;
+        if (threadState && getSignalStackAndFramePointers(signalContext, stackPointer, framePointer) &&
+            stackPointer >= Uptr(threadState->stackMinGuardAddress) + stackOverflowGuardNumBytes && stackPointer < Uptr(threadState->stackMaxAddress)) {
+            const Uptr stackMaxAddress = Uptr(threadState->stackMaxAddress);
+            while (numFrames < maxProfileSampleFrames && framePointer >= stackPointer &&
+                   framePointer <= stackMaxAddress - 2 * sizeof(Uptr) && !(framePointer & (sizeof(Uptr) - 1))) {
+                const Uptr *frame = reinterpret_cast<const Uptr *>(framePointer);
+                if (!frame[1]) {
+                    break;
+                }
+                ips[numFrames++] = frame[1];
+
+                // Frames are at increasing addresses toward the base of the stack.
+                stackPointer = framePointer + 2 * sizeof(Uptr);
+                framePointer = frame[0];
+            }
+        }
+
+        callback(ips, numFrames);
+    }
+    errno = savedErrno;
+}
+
+bool Platform::startProfilingTimer(U64 intervalMicroseconds, ProfileSampleCallback callback) {
+    wavmAssert(callback);
+    wavmAssert(intervalMicroseconds > 0);
+
+    ProfileSampleCallback expectedCallback = nullptr;
+    if (!profileSampleCallback.compare_exchange_strong(expectedCallback, callback, std::memory_order_acq_rel)) {
+        return false;
+    }
+
+    // SA_RESTART keeps the timer's signals from failing system calls with EINTR.
+    struct sigaction signalAction;
+    memset(&signalAction, 0, sizeof(signalAction));
+    signalAction.sa_sigaction = profilingSignalHandler;
+    sigemptyset(&signalAction.sa_mask);
+    signalAction.sa_flags = SA_SIGINFO | SA_ONSTACK | SA_RESTART;
+    errorUnless(!sigaction(SIGPROF, &signalAction, nullptr));
+
+    struct itimerval timer;
+    timer.it_interval.tv_sec = time_t(intervalMicroseconds / 1000000);
+    timer.it_interval.tv_usec = suseconds_t(intervalMicroseconds % 1000000);
+    timer.it_value = timer.it_interval;
+    if (setitimer(ITIMER_PROF, &timer, nullptr)) {
+        profileSampleCallback.store(nullptr, std::memory_order_release);
+        return false;
+    }
+    return true;
+}
+
+void Platform::stopProfilingTimer() {
+    struct itimerval timer;
+    memset(&timer, 0, sizeof(timer));
+    setitimer(ITIMER_PROF, &timer, nullptr);
+
+    // Leave the handler installed, since a signal raised by the timer before it was stopped may not
+    // have been delivered yet.
+    profileSampleCallback.store(nullptr, std::memory_order_release);
+}
@@ -0,0 +1,161 @@
+#include <setjmp.h>
+#include <string.h>
+#include <exception>
+
+#include "POSIXPrivate.h"
+#include "WAVM/Inline/Assert.h"
+#include "WAVM/Inline/BasicTypes.h"
+#include "WAVM/Inline/Errors.h"
+#include "WAVM/Platform/Fiber.h"
+#include "WAVM/Platform/Memory.h"
+
+using namespace WAVM;
+using namespace WAVM::Platform;
+
+// The number of inaccessible bytes below a fiber's stack. A function's frame may skip over a single
+// guard page, so this is large enough that a stack overflow faults in the guard region.
+static constexpr Uptr fiberStackGuardNumBytes = 64 * 1024;
+
+struct Platform::Fiber {
+    U8 *stackMapping;
+    Uptr numStackMappingPages;
+
+    FiberEntry entry;
+    void *argument;
+
+    // The fiber's stack pointer while it isn't running, and the stack pointer of the code that
+    // resumed it while it is running.
+    U8 *fiberStackPointer;
+    U8 *resumerStackPointer;
+
+    // The fiber's signal stack state while it isn't running, and the resumer's while it is.
+    SignalStackState signalStackState;
+
+    // The fiber that resumed this fiber, or null if it was resumed by code that isn't on a fiber.
+    Fiber *resumerFiber = nullptr;
+
+    // Where the signal handler jumps to forward a signal to a catchSignals on a resumer's stack,
+    // and the context of that catchSignals once the jump has been taken.
+    sigjmp_buf baseJump;
+    void *forwardedSignalContext = nullptr;
+
+    bool isRunning = false;
+    bool hasReturned = false;
+    std::exception_ptr exception;
+};
+
+static thread_local Fiber *currentFiber = nullptr;
+
+// Lays out a fiber's stack as switchStack saves it, so the first switch to it returns to
+// fiberStackTrampoline with the fiber in r12, and the default SSE and x87 control words. The two
+// words at the top of the stack are left zero, as the trampoline's phony return address and frame
+// pointer, and keep the stack 16-byte aligned at the trampoline's call.
+static void initFiberStack(Fiber *fiber) {
+    U8 *stackMaxAddress = fiber->stackMapping + (fiber->numStackMappingPages << getPageSizeLog2());
+    fiber->signalStackState.innermostSignalContext = nullptr;
+    fiber->signalStackState.stackMinGuardAddress = fiber->stackMapping;
+    fiber->signalStackState.stackMaxAddress = stackMaxAddress;
+    fiber->signalStackState.resumerStackState = nullptr;
+    fiber->signalStackState.fiberBaseJump = &fiber->baseJump;
+
+    U64 *initialStack = reinterpret_cast<U64 *>(stackMaxAddress) - 10;
+    memset(initialStack, 0, sizeof(U64) * 10);
+    initialStack[0] = U64(0x1f80) | (U64(0x037f) << 32);
+    initialStack[4] = reinterpret_cast<U64>(fiber);
+    initialStack[7] = reinterpret_cast<U64>(&fiberStackTrampoline);
+    fiber->fiberStackPointer = reinterpret_cast<U8 *>(initialStack);
+    fiber->hasReturned = false;
+}
+
+Fiber *Platform::createFiber(Uptr numStackBytes, FiberEntry entry, void *argument) {
+    const Uptr pageSizeLog2 = getPageSizeLog2();
+    const Uptr numGuardPages = fiberStackGuardNumBytes >> pageSizeLog2;
+    const Uptr numStackPages = (numStackBytes + (Uptr(1) << pageSizeLog2) - 1) >> pageSizeLog2;
+
+    Fiber *fiber = new Fiber;
+    fiber->numStackMappingPages = numGuardPages + numStackPages;
+    fiber->stackMapping = allocateVirtualPages(fiber->numStackMappingPages);
+    errorUnless(fiber->stackMapping);
+    errorUnless(commitVirtualPages(fiber->stackMapping + (numGuardPages << pageSizeLog2), numStackPages));
+    fiber->entry = entry;
+    fiber->argument = argument;
+    initFiberStack(fiber);
+    return fiber;
+}
+
+void Platform::resetFiber(Fiber *fiber, FiberEntry entry, void *argument) {
+    errorUnless(!fiber->isRunning);
+    fiber->entry = entry;
+    fiber->argument = argument;
+    fiber->exception = nullptr;
+    initFiberStack(fiber);
+}
+
+void Platform::destroyFiber(Fiber *fiber) {
+    errorUnless(!fiber->isRunning);
+    freeVirtualPages(fiber->stackMapping, fiber->numStackMappingPages);
+    delete fiber;
+}
+
+extern "C" void runFiberEntry(Fiber *fiber) {
+    // Neither exceptions nor the signal handler's jumps can cross the bottom of the fiber's stack,
+    // so they end the fiber here, and are completed by the resumeFiber that is waiting for it.
+    if (sigsetjmp(fiber->baseJump, 1)) {
+        fiber->forwardedSignalContext = takeForwardedSignalContext();
+    } else {
+        try {
+            (*fiber->entry)(fiber->argument);
+        } catch (...) {
+            fiber->exception = std::current_exception();
+        }
+    }
+
+    fiber->hasReturned = true;
+    switchStack(&fiber->fiberStackPointer, fiber->resumerStackPointer);
+    Errors::unreachable();
+}
+
+bool Platform::resumeFiber(Fiber *fiber) {
+    errorUnless(!fiber->isRunning && !fiber->hasReturned);
+    fiber->isRunning = true;
+    fiber->resumerFiber = currentFiber;
+    currentFiber = fiber;
+
+    // While the fiber runs, its signal stack state is swapped into the thread, and the resumer's
+    // is held by the fiber, where the signal handler finds the resumer's catchSignals.
+    fiber->signalStackState.resumerStackState = &fiber->signalStackState;
+    exchangeSignalStackState(fiber->signalStackState);
+    switchStack(&fiber->resumerStackPointer, fiber->fiberStackPointer);
+    exchangeSignalStackState(fiber->signalStackState);
+
+    currentFiber = fiber->resumerFiber;
+    fiber->resumerFiber = nullptr;
+    fiber->isRunning = false;
+
+    if (fiber->forwardedSignalContext) {
+        void *signalContext = fiber->forwardedSignalContext;
+        fiber->forwardedSignalContext = nullptr;
+        deliverForwardedSignal(signalContext);
+    }
+
+    if (fiber->exception) {
+        std::exception_ptr exception = fiber->exception;
+        fiber->exception = nullptr;
+        std::rethrow_exception(exception);
+    }
+    return fiber->hasReturned;
+}
+
+void Platform::yieldFiber() {
+    Fiber *fiber = currentFiber;
+    errorUnless(fiber);
+    switchStack(&fiber->fiberStackPointer, fiber->resumerStackPointer);
+}
+
+bool Platform::isFiberRunning(const Fiber *fiber) {
+    return fiber->isRunning;
+}
+
+Fiber *Platform::getCurrentFiber() {
+    return currentFiber;
+}
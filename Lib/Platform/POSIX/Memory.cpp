@@ -1,7 +1,22 @@
 #include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <sys/mman.h>
 #include <unistd.h>
+#include <algorithm>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+#ifdef __x86_64__
+#include <emmintrin.h>
+#endif
 
 #include "POSIXPrivate.h"
 #include "WAVM/Inline/Assert.h"
@@ -127,6 +142,59 @@ void Platform::decommitVirtualPages(U8 *baseVirtualAddress, Uptr numPages) {
     }
 }
 
+void Platform::discardVirtualPages(U8 *baseVirtualAddress, Uptr numPages) {
+    errorUnless(isPageAligned(baseVirtualAddress));
+    auto numBytes = numPages << getPageSizeLog2();
+    if (!numBytes) {
+        return;
+    }
+#ifndef __linux__
+    // Only Linux guarantees that MADV_DONTNEED zeroes the pages.
+    decommitVirtualPages(baseVirtualAddress, numPages);
+#else
+    if (madvise(baseVirtualAddress, numBytes, MADV_DONTNEED)) {
+        Errors::fatalf("madvise(0x%" PRIxPTR ", %" PRIuPTR ", MADV_DONTNEED) failed! errno=%s", reinterpret_cast<Uptr>(baseVirtualAddress), numBytes, strerror(errno));
+    }
+    if (mprotect(baseVirtualAddress, numBytes, PROT_NONE)) {
+        Errors::fatalf("mprotect(0x%" PRIxPTR ", %" PRIuPTR ", PROT_NONE) failed! errno=%s", reinterpret_cast<Uptr>(baseVirtualAddress), numBytes, strerror(errno));
+    }
+#endif
+}
+
+static Uptr internalGetHugePageSizeLog2() {
+#ifdef __linux__
+    // The transparent huge page size is the size of a page mapped by a PMD entry: 2MB on x86-64,
+    // but it varies with the base page size on other architectures.
+    FILE *file = fopen("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size", "r");
+    if (file) {
+        unsigned long long hugePageSize = 0;
+        const bool readSize = fscanf(file, "%llu", &hugePageSize) == 1;
+        fclose(file);
+        if (readSize && hugePageSize && hugePageSize <= UINT32_MAX && !(hugePageSize & (hugePageSize - 1))) {
+            return floorLogTwo(U32(hugePageSize));
+        }
+    }
+#endif
+    return getPageSizeLog2();
+}
+
+Uptr Platform::getHugePageSizeLog2() {
+    static Uptr hugePageSizeLog2 = internalGetHugePageSizeLog2();
+    return hugePageSizeLog2;
+}
+
+bool Platform::adviseHugePages(U8 *baseVirtualAddress, Uptr numPages) {
+    errorUnless(isPageAligned(baseVirtualAddress));
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if (getHugePageSizeLog2() == getPageSizeLog2()) {
+        return false;
+    }
+    return !madvise(baseVirtualAddress, numPages << getPageSizeLog2(), MADV_HUGEPAGE);
+#else
+    return false;
+#endif
+}
+
 void Platform::freeVirtualPages(U8 *baseVirtualAddress, Uptr numPages) {
     errorUnless(isPageAligned(baseVirtualAddress));
     if (munmap(baseVirtualAddress, numPages << getPageSizeLog2())) {
@@ -135,6 +203,96 @@ void Platform::freeVirtualPages(U8 *baseVirtualAddress, Uptr numPages) {
     }
 }
 
+bool Platform::readSysfsIndexList(const char *path, std::vector<Uptr> &outIndices) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        return false;
+    }
+    char buffer[4096];
+    const Uptr numBytes = fread(buffer, 1, sizeof(buffer) - 1, file);
+    fclose(file);
+    buffer[numBytes] = 0;
+
+    const char *next = buffer;
+    while (*next >= '0' && *next <= '9') {
+        char *end;
+        const Uptr firstIndex = Uptr(strtoull(next, &end, 10));
+        Uptr lastIndex = firstIndex;
+        if (*end == '-') {
+            lastIndex = Uptr(strtoull(end + 1, &end, 10));
+        }
+        if (lastIndex < firstIndex || lastIndex - firstIndex >= 65536) {
+            return false;
+        }
+        for (Uptr index = firstIndex; index <= lastIndex; ++index) {
+            outIndices.push_back(index);
+        }
+        next = *end == ',' ? end + 1 : end;
+    }
+    return *next == 0 || *next == '\n';
+}
+
+static Uptr internalGetNumNUMANodes() {
+    // The nodes are numbered densely in practice, so the highest node that is online bounds the
+    // node indices.
+    std::vector<Uptr> nodes;
+    if (!readSysfsIndexList("/sys/devices/system/node/online", nodes) || !nodes.size()) {
+        return 1;
+    }
+    return *std::max_element(nodes.begin(), nodes.end()) + 1;
+}
+
+Uptr Platform::getNumNUMANodes() {
+#ifdef __linux__
+    static Uptr numNUMANodes = internalGetNumNUMANodes();
+    return numNUMANodes;
+#else
+    return 1;
+#endif
+}
+
+Uptr Platform::getCurrentNUMANode() {
+#if defined(__linux__) && defined(SYS_getcpu)
+    unsigned cpu = 0;
+    unsigned node = 0;
+    if (getNumNUMANodes() > 1 && !syscall(SYS_getcpu, &cpu, &node, nullptr)) {
+        return Uptr(node);
+    }
+#endif
+    return 0;
+}
+
+bool Platform::setVirtualPagesNUMANode(U8 *baseVirtualAddress, Uptr numPages, Uptr numaNode) {
+    errorUnless(isPageAligned(baseVirtualAddress));
+#if defined(__linux__) && defined(SYS_mbind)
+    // The mbind policies, from linux/mempolicy.h: MPOL_DEFAULT uses the thread's policy, which
+    // allocates on the node of the CPU that first touches a page, and MPOL_PREFERRED allocates on
+    // the given node while it has free memory.
+    enum { mpolDefault = 0, mpolPreferred = 1 };
+
+    const Uptr numNodes = getNumNUMANodes();
+    if (numaNode == anyNUMANode) {
+        // There is no policy to reset on a machine with a single node.
+        return numNodes == 1 || !syscall(SYS_mbind, baseVirtualAddress, numPages << getPageSizeLog2(), mpolDefault, nullptr, 0, 0);
+    }
+    if (numaNode >= numNodes) {
+        return false;
+    }
+    if (numNodes == 1) {
+        return true;
+    }
+
+    constexpr Uptr numMaskWordBits = sizeof(unsigned long) * 8;
+    std::vector<unsigned long> nodeMask(numNodes / numMaskWordBits + 1, 0);
+    nodeMask[numaNode / numMaskWordBits] |= 1ul << (numaNode % numMaskWordBits);
+
+    // The kernel reads one bit less than maxnode, so pass one more bit than there are nodes.
+    return !syscall(SYS_mbind, baseVirtualAddress, numPages << getPageSizeLog2(), mpolPreferred, nodeMask.data(), numNodes + 1, 0);
+#else
+    return false;
+#endif
+}
+
 void Platform::freeAlignedVirtualPages(U8 *unalignedBaseAddress, Uptr numPages, Uptr alignmentLog2) {
     errorUnless(isPageAligned(unalignedBaseAddress));
     if (munmap(unalignedBaseAddress, numPages << getPageSizeLog2())) {
@@ -142,3 +300,484 @@ void Platform::freeAlignedVirtualPages(U8 *unalignedBaseAddress, Uptr numPages,
                        numPages << getPageSizeLog2(), strerror(errno));
     }
 }
+
+struct Platform::PageFile {
+    int fd;
+    U64 offset;
+    Uptr numPages;
+};
+
+static int createAnonymousFile() {
+#if defined(__linux__) && defined(SYS_memfd_create)
+    // Use memfd_create if the kernel supports it: the file lives in memory, and never has a name in
+    // the file system.
+    const int memfd = int(syscall(SYS_memfd_create, "wavm-page-file", 1u /* MFD_CLOEXEC */));
+    if (memfd != -1) {
+        return memfd;
+    }
+#endif
+
+    // Otherwise, create a temporary file and unlink it, so it is deleted when it is closed.
+    char path[] = "/tmp/wavm-page-file-XXXXXX";
+    const int fd = mkstemp(path);
+    if (fd != -1) {
+        unlink(path);
+    }
+    return fd;
+}
+
+static bool isZeroPage(const U8 *page) {
+    const Uptr pageBytes = Uptr(1) << getPageSizeLog2();
+    for (Uptr wordOffset = 0; wordOffset < pageBytes; wordOffset += sizeof(U64)) {
+        if (*reinterpret_cast<const U64 *>(page + wordOffset)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Writes the pages that aren't entirely zero to a file at a byte offset, leaving the zero pages as
+// they were: holes, if the file was extended past them with ftruncate.
+static bool writeNonZeroPages(int fd, U64 offset, const U8 *baseAddress, Uptr numBytes) {
+    const Uptr pageBytes = Uptr(1) << getPageSizeLog2();
+    for (Uptr pageOffset = 0; pageOffset < numBytes; pageOffset += pageBytes) {
+        const U8 *page = baseAddress + pageOffset;
+        if (isZeroPage(page)) {
+            continue;
+        }
+
+        Uptr numWrittenBytes = 0;
+        while (numWrittenBytes < pageBytes) {
+            const ssize_t result = pwrite(fd, page + numWrittenBytes, pageBytes - numWrittenBytes, off_t(offset + pageOffset + numWrittenBytes));
+            if (result == -1 && errno != EINTR) {
+                fprintf(stderr, "pwrite to page file failed! errno=%s\n", strerror(errno));
+                return false;
+            }
+            if (result > 0) {
+                numWrittenBytes += Uptr(result);
+            }
+        }
+    }
+    return true;
+}
+
+PageFile *Platform::createPageFile(const U8 *baseAddress, Uptr numPages) {
+    const Uptr numBytes = numPages << getPageSizeLog2();
+    const int fd = createAnonymousFile();
+    if (fd == -1) {
+        fprintf(stderr, "Failed to create a page file: errno=%s\n", strerror(errno));
+        return nullptr;
+    }
+
+    if (ftruncate(fd, off_t(numBytes))) {
+        fprintf(stderr, "ftruncate(%d, %" PRIuPTR ") failed! errno=%s\n", fd, numBytes, strerror(errno));
+        close(fd);
+        return nullptr;
+    }
+
+    // Copy the pages into the file. Skip pages that are entirely zero: the file is already zeroed,
+    // and leaving them as holes avoids allocating backing storage for them.
+    if (!writeNonZeroPages(fd, 0, baseAddress, numBytes)) {
+        close(fd);
+        return nullptr;
+    }
+
+    return new PageFile{fd, 0, numPages};
+}
+
+bool Platform::writePageFile(const PageFile *pageFile, const char *path, U64 offset) {
+    errorUnless(!(offset & ((U64(1) << getPageSizeLog2()) - 1)));
+
+    const int fd = open(path, O_WRONLY | O_CLOEXEC);
+    if (fd == -1) {
+        return false;
+    }
+
+    // Extend the file to the end of the pages first, so the zero pages that aren't written are
+    // holes in the file instead of being allocated.
+    const Uptr numBytes = pageFile->numPages << getPageSizeLog2();
+    struct stat fileStatus;
+    bool succeeded = !fstat(fd, &fileStatus);
+    if (succeeded && U64(fileStatus.st_size) < offset + numBytes) {
+        succeeded = !ftruncate(fd, off_t(offset + numBytes));
+    }
+
+    // Read the page file through a mapping of it, so its holes read as zero without allocating
+    // backing storage for them.
+    if (succeeded && numBytes) {
+        void *pages = mmap(nullptr, numBytes, PROT_READ, MAP_SHARED, pageFile->fd, off_t(pageFile->offset));
+        succeeded = pages != MAP_FAILED;
+        if (succeeded) {
+            succeeded = writeNonZeroPages(fd, offset, (const U8 *) pages, numBytes);
+            munmap(pages, numBytes);
+        }
+    }
+
+    if (close(fd)) {
+        succeeded = false;
+    }
+    return succeeded;
+}
+
+PageFile *Platform::openPageFile(const char *path, U64 offset, Uptr numPages) {
+    errorUnless(!(offset & ((U64(1) << getPageSizeLog2()) - 1)));
+
+    const int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        return nullptr;
+    }
+
+    // Accessing a mapped page beyond the end of the file would raise SIGBUS, so check that the file
+    // contains all the pages.
+    struct stat fileStatus;
+    if (fstat(fd, &fileStatus) || !S_ISREG(fileStatus.st_mode) || U64(fileStatus.st_size) < offset + (U64(numPages) << getPageSizeLog2())) {
+        close(fd);
+        return nullptr;
+    }
+
+    return new PageFile{fd, offset, numPages};
+}
+
+void Platform::destroyPageFile(PageFile *pageFile) {
+    errorUnless(!close(pageFile->fd));
+    delete pageFile;
+}
+
+bool Platform::mapPageFileCopyOnWrite(PageFile *pageFile, U8 *baseVirtualAddress, Uptr numPages) {
+    errorUnless(isPageAligned(baseVirtualAddress));
+    errorUnless(numPages <= pageFile->numPages);
+    if (!numPages) {
+        return true;
+    }
+
+    const Uptr numBytes = numPages << getPageSizeLog2();
+    if (mmap(baseVirtualAddress, numBytes, PROT_READ | PROT_WRITE, MAP_FIXED | MAP_PRIVATE, pageFile->fd, off_t(pageFile->offset)) == MAP_FAILED) {
+        fprintf(stderr, "mmap(0x%" PRIxPTR ", %" PRIuPTR ", PROT_READ | PROT_WRITE, MAP_FIXED | MAP_PRIVATE, %d, %" PRIu64 ") failed! errno=%s\n", reinterpret_cast<Uptr>(baseVirtualAddress), numBytes, pageFile->fd, pageFile->offset, strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+#ifdef __linux__
+// The bits of a /proc/self/pagemap entry that tell whether a page is mapped to physical memory or
+// swap, and whether it is a page of a file or shared memory. A page of a private file mapping that
+// is present or swapped but isn't a file page is a private copy made by a write.
+static constexpr U64 pagemapPresentBit = U64(1) << 63;
+static constexpr U64 pagemapSwappedBit = U64(1) << 62;
+static constexpr U64 pagemapFilePageBit = U64(1) << 61;
+
+// Clean pages between written pages are reverted along with them if there are at most this many
+// of them, to make fewer madvise calls.
+static constexpr Uptr maxRevertedCleanPageGap = 16;
+
+// Returns a descriptor of /proc/self/pagemap, which is opened once for the process, or -1 if it
+// can't be opened.
+static int getPagemapFD() {
+    static const int pagemapFD = open("/proc/self/pagemap", O_RDONLY | O_CLOEXEC);
+    return pagemapFD;
+}
+
+// Releases the physical pages of a range of pages, so the next access reads a zero page or the
+// page of the file it maps.
+static void releasePages(U8 *baseVirtualAddress, Uptr numPages) {
+    const Uptr numBytes = numPages << getPageSizeLog2();
+    if (madvise(baseVirtualAddress, numBytes, MADV_DONTNEED)) {
+        Errors::fatalf("madvise(0x%" PRIxPTR ", %" PRIuPTR ", MADV_DONTNEED) failed! errno=%s", reinterpret_cast<Uptr>(baseVirtualAddress), numBytes, strerror(errno));
+    }
+}
+#endif
+
+Uptr Platform::revertPageFileCopyOnWrite(PageFile *pageFile, U8 *baseVirtualAddress, Uptr numPages) {
+    errorUnless(isPageAligned(baseVirtualAddress));
+    errorUnless(numPages <= pageFile->numPages);
+    if (!numPages) {
+        return 0;
+    }
+
+#ifdef __linux__
+    // Discarding the private copies of a private file mapping's pages with MADV_DONTNEED makes the
+    // next access read the page from the file again. Find the written pages in /proc/self/pagemap,
+    // and only discard those, so the pages that were only read stay mapped.
+    const int pagemapFD = getPagemapFD();
+    if (pagemapFD == -1) {
+        releasePages(baseVirtualAddress, numPages);
+        return numPages;
+    }
+
+    const Uptr pageSizeLog2 = getPageSizeLog2();
+    const Uptr firstPageIndex = reinterpret_cast<Uptr>(baseVirtualAddress) >> pageSizeLog2;
+    Uptr numRevertedPages = 0;
+    Uptr runBeginPageIndex = UINTPTR_MAX;
+    Uptr runEndPageIndex = 0;
+
+    U64 entries[512];
+    for (Uptr chunkPageIndex = 0; chunkPageIndex < numPages; chunkPageIndex += 512) {
+        const Uptr numChunkPages = std::min(numPages - chunkPageIndex, Uptr(512));
+        const Uptr numChunkBytes = numChunkPages * sizeof(U64);
+        if (pread(pagemapFD, entries, numChunkBytes, off_t((firstPageIndex + chunkPageIndex) * sizeof(U64))) != ssize_t(numChunkBytes)) {
+            // If the pagemap can't be read, revert the current run and all the remaining pages.
+            const Uptr revertBeginPageIndex = runBeginPageIndex != UINTPTR_MAX ? runBeginPageIndex : chunkPageIndex;
+            releasePages(baseVirtualAddress + (revertBeginPageIndex << pageSizeLog2), numPages - revertBeginPageIndex);
+            return numRevertedPages + numPages - revertBeginPageIndex;
+        }
+
+        for (Uptr entryIndex = 0; entryIndex < numChunkPages; ++entryIndex) {
+            const U64 entry = entries[entryIndex];
+            const bool isWritten = (entry & (pagemapPresentBit | pagemapSwappedBit)) && !(entry & pagemapFilePageBit);
+            if (!isWritten) {
+                continue;
+            }
+
+            // Extend the current run of written pages, or revert it and start a new one.
+            const Uptr pageIndex = chunkPageIndex + entryIndex;
+            if (runBeginPageIndex != UINTPTR_MAX && pageIndex - runEndPageIndex > maxRevertedCleanPageGap) {
+                releasePages(baseVirtualAddress + (runBeginPageIndex << pageSizeLog2), runEndPageIndex - runBeginPageIndex);
+                numRevertedPages += runEndPageIndex - runBeginPageIndex;
+                runBeginPageIndex = UINTPTR_MAX;
+            }
+            if (runBeginPageIndex == UINTPTR_MAX) {
+                runBeginPageIndex = pageIndex;
+            }
+            runEndPageIndex = pageIndex + 1;
+        }
+    }
+
+    if (runBeginPageIndex != UINTPTR_MAX) {
+        releasePages(baseVirtualAddress + (runBeginPageIndex << pageSizeLog2), runEndPageIndex - runBeginPageIndex);
+        numRevertedPages += runEndPageIndex - runBeginPageIndex;
+    }
+    return numRevertedPages;
+#else
+    // Otherwise, map the page file again, which discards all the private copies of its pages.
+    if (!mapPageFileCopyOnWrite(pageFile, baseVirtualAddress, numPages)) {
+        Errors::fatalf("Failed to map a page file again to revert its copy-on-write pages");
+    }
+    return numPages;
+#endif
+}
+
+Uptr Platform::releaseZeroPages(U8 *baseVirtualAddress, Uptr numPages) {
+    errorUnless(isPageAligned(baseVirtualAddress));
+#ifdef __linux__
+    // Only check the pages that are present in physical memory: reading the others would fault them
+    // in, or read them back from swap.
+    const int pagemapFD = getPagemapFD();
+    if (pagemapFD == -1) {
+        return 0;
+    }
+
+    const Uptr pageSizeLog2 = getPageSizeLog2();
+    const Uptr firstPageIndex = reinterpret_cast<Uptr>(baseVirtualAddress) >> pageSizeLog2;
+    Uptr numReleasedPages = 0;
+    Uptr runBeginPageIndex = UINTPTR_MAX;
+    Uptr runEndPageIndex = 0;
+
+    U64 entries[512];
+    for (Uptr chunkPageIndex = 0; chunkPageIndex < numPages; chunkPageIndex += 512) {
+        const Uptr numChunkPages = std::min(numPages - chunkPageIndex, Uptr(512));
+        const Uptr numChunkBytes = numChunkPages * sizeof(U64);
+        if (pread(pagemapFD, entries, numChunkBytes, off_t((firstPageIndex + chunkPageIndex) * sizeof(U64))) != ssize_t(numChunkBytes)) {
+            break;
+        }
+
+        for (Uptr entryIndex = 0; entryIndex < numChunkPages; ++entryIndex) {
+            const Uptr pageIndex = chunkPageIndex + entryIndex;
+            const bool isReleasable = (entries[entryIndex] & pagemapPresentBit) && isZeroPage(baseVirtualAddress + (pageIndex << pageSizeLog2));
+
+            // Release runs of contiguous zero pages with one madvise call.
+            if (runBeginPageIndex != UINTPTR_MAX && !isReleasable) {
+                releasePages(baseVirtualAddress + (runBeginPageIndex << pageSizeLog2), runEndPageIndex - runBeginPageIndex);
+                numReleasedPages += runEndPageIndex - runBeginPageIndex;
+                runBeginPageIndex = UINTPTR_MAX;
+            }
+            if (isReleasable) {
+                if (runBeginPageIndex == UINTPTR_MAX) {
+                    runBeginPageIndex = pageIndex;
+                }
+                runEndPageIndex = pageIndex + 1;
+            }
+        }
+    }
+
+    if (runBeginPageIndex != UINTPTR_MAX) {
+        releasePages(baseVirtualAddress + (runBeginPageIndex << pageSizeLog2), runEndPageIndex - runBeginPageIndex);
+        numReleasedPages += runEndPageIndex - runBeginPageIndex;
+    }
+    return numReleasedPages;
+#else
+    // Other OSes don't guarantee that releasing a page's physical memory zeroes it.
+    return 0;
+#endif
+}
+
+bool Platform::reclaimVirtualPages(U8 *baseVirtualAddress, Uptr numPages) {
+    errorUnless(isPageAligned(baseVirtualAddress));
+    if (!numPages) {
+        return true;
+    }
+#ifdef __linux__
+    // MADV_PAGEOUT was added in Linux 5.4, and fails with EINVAL on older kernels.
+#ifndef MADV_PAGEOUT
+#define MADV_PAGEOUT 21
+#endif
+    return !madvise(baseVirtualAddress, numPages << getPageSizeLog2(), MADV_PAGEOUT);
+#else
+    return false;
+#endif
+}
+
+struct Platform::MappedFile {
+    U8 *baseAddress;
+    Uptr numBytes;
+    Uptr numPages;
+};
+
+MappedFile *Platform::mapFile(const char *path) {
+    const int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        return nullptr;
+    }
+
+    struct stat fileStatus;
+    if (fstat(fd, &fileStatus) || !S_ISREG(fileStatus.st_mode)) {
+        close(fd);
+        return nullptr;
+    }
+    const Uptr numBytes = Uptr(fileStatus.st_size);
+
+    // Reserve zeroed pages for the contents and at least one more byte, and map the file over the
+    // start of them. The rest of the file's last page reads as zero, and if the file ends at a page
+    // boundary, the following reserved page provides the terminating zero byte.
+    const Uptr pageSizeLog2 = getPageSizeLog2();
+    const Uptr numPages = (numBytes + 1 + (Uptr(1) << pageSizeLog2) - 1) >> pageSizeLog2;
+    void *baseAddress = mmap(nullptr, numPages << pageSizeLog2, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (baseAddress == MAP_FAILED) {
+        close(fd);
+        return nullptr;
+    }
+    if (numBytes && mmap(baseAddress, numBytes, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+        munmap(baseAddress, numPages << pageSizeLog2);
+        close(fd);
+        return nullptr;
+    }
+
+    // The mapping keeps a reference to the file, so it doesn't need the descriptor.
+    close(fd);
+    return new MappedFile{(U8 *) baseAddress, numBytes, numPages};
+}
+
+const U8 *Platform::getMappedFileBytes(const MappedFile *mappedFile) {
+    return mappedFile->baseAddress;
+}
+
+Uptr Platform::getMappedFileNumBytes(const MappedFile *mappedFile) {
+    return mappedFile->numBytes;
+}
+
+void Platform::unmapFile(MappedFile *mappedFile) {
+    errorUnless(!munmap(mappedFile->baseAddress, mappedFile->numPages << getPageSizeLog2()));
+    delete mappedFile;
+}
+
+// Copies and fills smaller than this use memmove and memset, which are faster than rep movsb and rep
+// stosb for small sizes.
+static constexpr Uptr minRepMovsbBytes = 2048;
+
+// Returns the size of copies and fills that use non-temporal stores: the size of the last level
+// cache, since a copy that large would evict all of its other contents.
+static Uptr getMinNonTemporalBytes() {
+    static const Uptr minNonTemporalBytes = [] {
+        long numCacheBytes = -1;
+#ifdef _SC_LEVEL3_CACHE_SIZE
+        numCacheBytes = sysconf(_SC_LEVEL3_CACHE_SIZE);
+        if (numCacheBytes <= 0) {
+            numCacheBytes = sysconf(_SC_LEVEL2_CACHE_SIZE);
+        }
+#endif
+        return numCacheBytes > 0 ? Uptr(numCacheBytes) : Uptr(8 * 1024 * 1024);
+    }();
+    return minNonTemporalBytes;
+}
+
+#ifdef __x86_64__
+// Copies the bytes up to the first cache line aligned dest address normally, the whole cache lines
+// after it with non-temporal stores, and the remaining bytes normally. source and dest must not
+// overlap.
+static void copyNonTemporal(U8 *dest, const U8 *source, Uptr numBytes) {
+    const Uptr numHeadBytes = (64 - (reinterpret_cast<Uptr>(dest) & 63)) & 63;
+    memcpy(dest, source, numHeadBytes);
+    dest += numHeadBytes;
+    source += numHeadBytes;
+    numBytes -= numHeadBytes;
+
+    for (; numBytes >= 64; dest += 64, source += 64, numBytes -= 64) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + 16));
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + 32));
+        const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + 48));
+        _mm_stream_si128(reinterpret_cast<__m128i *>(dest), a);
+        _mm_stream_si128(reinterpret_cast<__m128i *>(dest + 16), b);
+        _mm_stream_si128(reinterpret_cast<__m128i *>(dest + 32), c);
+        _mm_stream_si128(reinterpret_cast<__m128i *>(dest + 48), d);
+    }
+
+    // Non-temporal stores are weakly ordered, so fence them before any stores that follow.
+    _mm_sfence();
+    memcpy(dest, source, numBytes);
+}
+
+// Fills memory like copyNonTemporal copies it.
+static void fillNonTemporal(U8 *dest, U8 value, Uptr numBytes) {
+    const Uptr numHeadBytes = (64 - (reinterpret_cast<Uptr>(dest) & 63)) & 63;
+    memset(dest, value, numHeadBytes);
+    dest += numHeadBytes;
+    numBytes -= numHeadBytes;
+
+    const __m128i line = _mm_set1_epi8(char(value));
+    for (; numBytes >= 64; dest += 64, numBytes -= 64) {
+        _mm_stream_si128(reinterpret_cast<__m128i *>(dest), line);
+        _mm_stream_si128(reinterpret_cast<__m128i *>(dest + 16), line);
+        _mm_stream_si128(reinterpret_cast<__m128i *>(dest + 32), line);
+        _mm_stream_si128(reinterpret_cast<__m128i *>(dest + 48), line);
+    }
+
+    _mm_sfence();
+    memset(dest, value, numBytes);
+}
+#endif
+
+void Platform::copyMemoryBytes(U8 *dest, const U8 *source, Uptr numBytes) {
+    // A forward copy would overwrite the source bytes after dest before reading them, so copy those
+    // with memmove, which copies them backward; rep movsb is slow when copying backward.
+    const bool overlapsAfterDest = dest > source && dest < source + numBytes;
+    if (numBytes < minRepMovsbBytes || overlapsAfterDest) {
+        memmove(dest, source, numBytes);
+        return;
+    }
+
+#ifdef __x86_64__
+    const bool overlaps = source < dest + numBytes && dest < source + numBytes;
+    if (numBytes >= getMinNonTemporalBytes() && !overlaps) {
+        copyNonTemporal(dest, source, numBytes);
+        return;
+    }
+#endif
+
+    bytewiseMemCopy(dest, source, numBytes);
+}
+
+void Platform::fillMemoryBytes(U8 *dest, U8 value, Uptr numBytes) {
+    if (numBytes < minRepMovsbBytes) {
+        memset(dest, value, numBytes);
+        return;
+    }
+
+#ifdef __x86_64__
+    if (numBytes >= getMinNonTemporalBytes()) {
+        fillNonTemporal(dest, value, numBytes);
+        return;
+    }
+#endif
+
+    bytewiseMemSet(dest, value, numBytes);
+}
@@ -1,4 +1,11 @@
 #include <pthread.h>
+#include <sched.h>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 #include "WAVM/Inline/Assert.h"
 #include "WAVM/Inline/Errors.h"
@@ -56,3 +63,69 @@ bool Platform::Mutex::isLockedByCurrentThread()
     return result;
 }
 #endif
+
+// The number of times SpinMutex::lock checks whether the mutex was unlocked before parking the
+// thread.
+static constexpr Uptr numSpinMutexSpins = 100;
+
+static inline void spinPause() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+void Platform::SpinMutex::lockContended() {
+    // Spin while the mutex is locked, but no threads are parked, in case it is unlocked soon.
+    for (Uptr spinIndex = 0; spinIndex < numSpinMutexSpins; ++spinIndex) {
+        U32 expectedState = state.load(std::memory_order_relaxed);
+        if (expectedState == 0 &&
+            state.compare_exchange_weak(expectedState, 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+            return;
+        } else if (expectedState == 2) {
+            break;
+        }
+        spinPause();
+    }
+
+    // Mark the mutex as having parked threads, and park until it is unlocked. The thread that
+    // acquires the mutex this way leaves it marked, since other threads may still be parked.
+    while (state.exchange(2, std::memory_order_acquire) != 0) {
+#ifdef __linux__
+        syscall(SYS_futex, reinterpret_cast<U32 *>(&state), FUTEX_WAIT_PRIVATE, 2, nullptr, nullptr, 0);
+#else
+        sched_yield();
+#endif
+    }
+}
+
+void Platform::SpinMutex::unlockContended() {
+#ifdef __linux__
+    syscall(SYS_futex, reinterpret_cast<U32 *>(&state), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#endif
+}
+
+Platform::RWMutex::RWMutex() {
+    static_assert(sizeof(pthreadRWLock) == sizeof(pthread_rwlock_t), "");
+    static_assert(alignof(PthreadRWLock) >= alignof(pthread_rwlock_t), "");
+    errorUnless(!pthread_rwlock_init((pthread_rwlock_t *) &pthreadRWLock, nullptr));
+}
+
+Platform::RWMutex::~RWMutex() {
+    errorUnless(!pthread_rwlock_destroy((pthread_rwlock_t *) &pthreadRWLock));
+}
+
+void Platform::RWMutex::lock() {
+    errorUnless(!pthread_rwlock_wrlock((pthread_rwlock_t *) &pthreadRWLock));
+}
+
+void Platform::RWMutex::unlock() {
+    errorUnless(!pthread_rwlock_unlock((pthread_rwlock_t *) &pthreadRWLock));
+}
+
+void Platform::RWMutex::lockShared() {
+    errorUnless(!pthread_rwlock_rdlock((pthread_rwlock_t *) &pthreadRWLock));
+}
+
+void Platform::RWMutex::unlockShared() {
+    errorUnless(!pthread_rwlock_unlock((pthread_rwlock_t *) &pthreadRWLock));
+}
@@ -2,6 +2,7 @@
 
 #include <setjmp.h>
 #include <functional>
+#include <vector>
 
 #include "WAVM/Inline/BasicTypes.h"
 #include "WAVM/Inline/Errors.h"
@@ -33,6 +34,14 @@ extern "C" I64 saveExecutionState(ExecutionContext *outContext, I64 returnCode)
 extern "C" I64 switchToForkedStackContext(ExecutionContext *forkedContext, U8 *trampolineFramePointer) noexcept(false);
 extern "C" U8 *getStackPointer();
 
+// Saves the callee-saved registers on the current stack, stores the stack pointer to
+// outSavedStackPointer, and restores the registers saved at stackPointer by an earlier call or
+// by createFiber, returning to that stack's caller.
+extern "C" void switchStack(U8 **outSavedStackPointer, U8 *stackPointer);
+
+// The first return address on a new fiber's stack, which calls runFiberEntry with the fiber.
+extern "C" void fiberStackTrampoline();
+
 extern "C" void __register_frame(const void *fde);
 extern "C" void __deregister_frame(const void *fde);
 
@@ -40,5 +49,40 @@ namespace WAVM {
     namespace Platform {
 
         struct CallStack;
+        struct Fiber;
+
+        // The state the signal handler uses to catch the signals raised by the code running on a
+        // stack: the innermost catchSignals on that stack, and the stack's bounds, which identify
+        // stack overflows.
+        struct SignalStackState {
+            void *innermostSignalContext;
+            U8 *stackMinGuardAddress;
+            U8 *stackMaxAddress;
+
+            // The state of the stack that resumed this fiber's stack, whose catchSignals enclose
+            // the fiber's, and the jump to the bottom of the fiber's stack, which returns to the
+            // resumer to complete a catch by one of them. Both are null for a thread's own stack.
+            SignalStackState *resumerStackState;
+            sigjmp_buf *fiberBaseJump;
+        };
+
+        // Reads a list of indices in the format Linux uses for CPU and NUMA node sets in sysfs, e.g.
+        // "0-3,8,10-11". Returns false if the file couldn't be read or parsed.
+        bool readSysfsIndexList(const char *path, std::vector<Uptr> &outIndices);
+
+        // Swaps the calling thread's signal stack state with state. Switching to a fiber's stack
+        // swaps in the fiber's state, and switching back swaps the thread's state back in.
+        void exchangeSignalStackState(SignalStackState &state);
+
+        // Returns the signal context on a resumer's stack that caught a signal raised on the
+        // current fiber's stack, after the signal handler jumped to the fiber's base jump.
+        void *takeForwardedSignalContext();
+
+        // Completes the catch of a signal forwarded from a fiber that has switched back to its
+        // resumer: jumps to the catchSignals if it is on the current stack, and otherwise forwards
+        // the signal on to the current fiber's own resumer.
+        [[noreturn]] void deliverForwardedSignal(void *signalContext);
     }
 }
+
+extern "C" void runFiberEntry(WAVM::Platform::Fiber *fiber);
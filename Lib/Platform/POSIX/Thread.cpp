@@ -0,0 +1,147 @@
+#include <inttypes.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include "POSIXPrivate.h"
+#include "WAVM/Inline/Assert.h"
+#include "WAVM/Inline/Errors.h"
+#include "WAVM/Platform/Memory.h"
+#include "WAVM/Platform/Thread.h"
+
+using namespace WAVM;
+using namespace WAVM::Platform;
+
+struct Platform::Thread {
+    pthread_t id;
+    ThreadEntry entry;
+    void *argument;
+    I64 result = 0;
+
+    // The thread is referenced by its creator until it is joined or detached, and by itself until
+    // it exits.
+    std::atomic<Uptr> numReferences{2};
+};
+
+static thread_local Thread *currentThread = nullptr;
+
+static void releaseThread(Thread *thread) {
+    if (thread->numReferences.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        delete thread;
+    }
+}
+
+static void *threadEntry(void *threadVoid) {
+    Thread *thread = reinterpret_cast<Thread *>(threadVoid);
+    currentThread = thread;
+    thread->result = (*thread->entry)(thread->argument);
+    currentThread = nullptr;
+    releaseThread(thread);
+    return nullptr;
+}
+
+Thread *Platform::createThread(Uptr numStackBytes, ThreadEntry entry, void *argument) {
+    Thread *thread = new Thread;
+    thread->entry = entry;
+    thread->argument = argument;
+
+    pthread_attr_t threadAttributes;
+    errorUnless(!pthread_attr_init(&threadAttributes));
+    if (numStackBytes) {
+        // Round the stack size up to a multiple of the page size, which some platforms require.
+        const Uptr pageNumBytes = Uptr(sysconf(_SC_PAGESIZE));
+        numStackBytes = std::max(Uptr(PTHREAD_STACK_MIN), (numStackBytes + pageNumBytes - 1) & ~(pageNumBytes - 1));
+        errorUnless(!pthread_attr_setstacksize(&threadAttributes, numStackBytes));
+    }
+    errorUnless(!pthread_create(&thread->id, &threadAttributes, threadEntry, thread));
+    errorUnless(!pthread_attr_destroy(&threadAttributes));
+
+    return thread;
+}
+
+I64 Platform::joinThread(Thread *thread) {
+    errorUnless(!pthread_join(thread->id, nullptr));
+    const I64 result = thread->result;
+    releaseThread(thread);
+    return result;
+}
+
+void Platform::detachThread(Thread *thread) {
+    errorUnless(!pthread_detach(thread->id));
+    releaseThread(thread);
+}
+
+Thread *Platform::getCurrentThread() {
+    return currentThread;
+}
+
+bool Platform::setThreadAffinity(Thread *thread, Uptr cpuIndex) {
+#ifdef __linux__
+    if (cpuIndex >= CPU_SETSIZE) {
+        return false;
+    }
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(cpuIndex, &cpuSet);
+    return !pthread_setaffinity_np(thread->id, sizeof(cpuSet), &cpuSet);
+#else
+    // macOS only supports affinity hints between threads, not pinning a thread to a CPU.
+    return false;
+#endif
+}
+
+Uptr Platform::getNumberOfHardwareThreads() {
+    const long numOnlineProcessors = sysconf(_SC_NPROCESSORS_ONLN);
+    return numOnlineProcessors > 0 ? Uptr(numOnlineProcessors) : 1;
+}
+
+#ifdef __linux__
+static bool getNUMANodeCPUs(Uptr numaNode, std::vector<Uptr> &outCPUs) {
+    if (numaNode >= getNumNUMANodes()) {
+        return false;
+    }
+    char path[64];
+    snprintf(path, sizeof(path), "/sys/devices/system/node/node%" PRIuPTR "/cpulist", numaNode);
+    return readSysfsIndexList(path, outCPUs) && outCPUs.size();
+}
+#endif
+
+Uptr Platform::getNumberOfNUMANodeHardwareThreads(Uptr numaNode) {
+#ifdef __linux__
+    std::vector<Uptr> cpus;
+    return getNUMANodeCPUs(numaNode, cpus) ? cpus.size() : 0;
+#else
+    return 0;
+#endif
+}
+
+bool Platform::setCurrentThreadNUMANode(Uptr numaNode) {
+#ifdef __linux__
+    std::vector<Uptr> cpus;
+    if (!getNUMANodeCPUs(numaNode, cpus)) {
+        return false;
+    }
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    for (Uptr cpuIndex : cpus) {
+        if (cpuIndex < CPU_SETSIZE) {
+            CPU_SET(cpuIndex, &cpuSet);
+        }
+    }
+    return !pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+#else
+    return false;
+#endif
+}
+
+void Platform::yieldToAnotherThread() {
+    errorUnless(!sched_yield());
+}
+
+Uptr Platform::getProcessId() {
+    return Uptr(getpid());
+}
@@ -0,0 +1,148 @@
+#include <math.h>
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include "RuntimePrivate.h"
+#include "WAVM/Inline/HashMap.h"
+#include "WAVM/Inline/Lock.h"
+#include "WAVM/Platform/Clock.h"
+#include "WAVM/Platform/Event.h"
+#include "WAVM/Platform/Mutex.h"
+#include "WAVM/Runtime/Intrinsics.h"
+#include "WAVM/Runtime/Runtime.h"
+
+using namespace WAVM;
+using namespace WAVM::IR;
+using namespace WAVM::Runtime;
+
+// The threads waiting on atomic addresses are kept in a fixed number of shards, each with its own
+// lock, so waits and wakes on unrelated addresses rarely contend for the same lock. Each memory has
+// its own address-space reservation, so the host address of a waited-on location identifies both
+// the memory and the address within it.
+enum {
+    numWaitListShardsLog2 = 6,
+    numWaitListShards = 1 << numWaitListShardsLog2
+};
+
+struct WaitListShard {
+    Platform::Mutex mutex;
+
+    // The threads waiting on each host address, in the order they started waiting.
+    HashMap<Uptr, std::vector<Platform::Event *>> addressToWaitingThreadsMap;
+};
+
+static WaitListShard waitListShards[numWaitListShards];
+
+// The event each thread waits on while it's in a wait list.
+static thread_local Platform::Event threadWaitEvent;
+
+static WaitListShard &getWaitListShard(Uptr hostAddress) {
+    // Use the top bits of a multiplicative hash of the address, so nearby addresses spread across shards.
+    const U64 hash = U64(hostAddress >> 2) * 0x9e3779b97f4a7c15ull;
+    return waitListShards[hash >> (64 - numWaitListShardsLog2)];
+}
+
+// Returns 0 if the thread was woken, 1 if the value at the address didn't match expectedValue, or 2
+// if the wait timed out. The timeout is in nanoseconds: a negative or non-finite timeout waits
+// forever.
+template<typename Value> static U32 waitOnAtomicValue(Memory *memory, U32 address, Value expectedValue, F64 timeout) {
+    std::atomic<Value> *value = reinterpret_cast<std::atomic<Value> *>(getReservedMemoryOffsetRange(memory, address, sizeof(Value)));
+    const Uptr hostAddress = reinterpret_cast<Uptr>(value);
+
+    // Read the value before taking the lock: if the address isn't accessible, the resulting signal
+    // would unwind the stack without calling the Lock destructor.
+    value->load(std::memory_order_relaxed);
+
+    U64 untilTime = UINT64_MAX;
+    if (timeout >= 0.0 && isfinite(timeout)) {
+        const F64 timeoutMicroseconds = timeout / 1000.0;
+        const U64 currentTime = Platform::getMonotonicClock();
+        if (timeoutMicroseconds < F64(UINT64_MAX - currentTime)) {
+            untilTime = currentTime + U64(timeoutMicroseconds);
+        }
+    }
+
+    WaitListShard &shard = getWaitListShard(hostAddress);
+    Platform::Event &waitEvent = threadWaitEvent;
+    {
+        // Compare the value while holding the lock: a wake must take the lock after any write that
+        // it follows, so it can't be missed between comparing the value and adding the thread to
+        // the wait list.
+        Lock<Platform::Mutex> shardLock(shard.mutex);
+        if (value->load(std::memory_order_seq_cst) != expectedValue) {
+            return 1;
+        }
+        shard.addressToWaitingThreadsMap.getOrAdd(hostAddress).push_back(&waitEvent);
+    }
+
+    if (waitEvent.wait(untilTime)) {
+        return 0;
+    }
+
+    Lock<Platform::Mutex> shardLock(shard.mutex);
+
+    // If the thread is still in the wait list, it timed out.
+    if (shard.addressToWaitingThreadsMap.contains(hostAddress)) {
+        std::vector<Platform::Event *> &waitingThreads = shard.addressToWaitingThreadsMap.getOrAdd(hostAddress);
+        for (auto it = waitingThreads.begin(); it != waitingThreads.end(); ++it) {
+            if (*it == &waitEvent) {
+                waitingThreads.erase(it);
+                if (waitingThreads.empty()) {
+                    shard.addressToWaitingThreadsMap.removeOrFail(hostAddress);
+                }
+                return 2;
+            }
+        }
+    }
+
+    // Otherwise, it was woken after the wait timed out, but before it reacquired the lock. The
+    // wake signaled the event while holding the lock, so consume the signal, which won't block.
+    errorUnless(waitEvent.wait(0));
+    return 0;
+}
+
+U32 Runtime::waitOnAtomicAddress(Memory *memory, U32 address, I32 expectedValue, F64 timeout) {
+    return waitOnAtomicValue<I32>(memory, address, expectedValue, timeout);
+}
+
+U32 Runtime::wakeAtomicAddress(Memory *memory, U32 address, U32 numToWake) {
+    const Uptr hostAddress = reinterpret_cast<Uptr>(getReservedMemoryOffsetRange(memory, address, sizeof(U32)));
+
+    WaitListShard &shard = getWaitListShard(hostAddress);
+    Lock<Platform::Mutex> shardLock(shard.mutex);
+
+    if (!shard.addressToWaitingThreadsMap.contains(hostAddress)) {
+        return 0;
+    }
+    std::vector<Platform::Event *> &waitingThreads = shard.addressToWaitingThreadsMap.getOrAdd(hostAddress);
+
+    // Wake the threads that have been waiting longest first.
+    const Uptr numWoken = std::min(Uptr(numToWake), Uptr(waitingThreads.size()));
+    for (Uptr waiterIndex = 0; waiterIndex < numWoken; ++waiterIndex) {
+        waitingThreads[waiterIndex]->signal();
+    }
+    waitingThreads.erase(waitingThreads.begin(), waitingThreads.begin() + numWoken);
+    if (waitingThreads.empty()) {
+        shard.addressToWaitingThreadsMap.removeOrFail(hostAddress);
+    }
+
+    return U32(numWoken);
+}
+
+DEFINE_INTRINSIC_FUNCTION(wavmIntrinsics, "atomic_wait_i32", I32, atomic_wait_i32, U32 address, I32 expectedValue, F64 timeout, Uptr memoryId) {
+    Memory *memory = getMemoryFromRuntimeData(contextRuntimeData, memoryId);
+    wavmAssert(memory->type.isShared);
+    return I32(waitOnAtomicValue<I32>(memory, address, expectedValue, timeout));
+}
+
+DEFINE_INTRINSIC_FUNCTION(wavmIntrinsics, "atomic_wait_i64", I32, atomic_wait_i64, U32 address, I64 expectedValue, F64 timeout, Uptr memoryId) {
+    Memory *memory = getMemoryFromRuntimeData(contextRuntimeData, memoryId);
+    wavmAssert(memory->type.isShared);
+    return I32(waitOnAtomicValue<I64>(memory, address, expectedValue, timeout));
+}
+
+DEFINE_INTRINSIC_FUNCTION(wavmIntrinsics, "atomic_wake", I32, atomic_wake, U32 address, U32 numToWake, I64 memoryId) {
+    Memory *memory = getMemoryFromRuntimeData(contextRuntimeData, Uptr(memoryId));
+    return I32(wakeAtomicAddress(memory, address, numToWake));
+}
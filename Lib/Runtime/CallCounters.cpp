@@ -0,0 +1,200 @@
+#include <string.h>
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "RuntimePrivate.h"
+#include "WAVM/IR/Module.h"
+#include "WAVM/Inline/HashMap.h"
+#include "WAVM/Inline/Serialization.h"
+#include "WAVM/LLVMJIT/LLVMJIT.h"
+#include "WAVM/Runtime/Intrinsics.h"
+#include "WAVM/Runtime/Runtime.h"
+#include "WAVM/Runtime/RuntimeData.h"
+
+using namespace WAVM;
+using namespace WAVM::Runtime;
+
+static const char moduleProfileMagic[8] = {'W', 'A', 'V', 'M', 'P', 'G', 'O', 0};
+static constexpr U32 moduleProfileVersion = 1;
+
+// Calls the visitor for the FunctionMutableData of each piece of code that counts the calls to a
+// function: its own, and that of the code its tierUp.optimizedCode forwards calls to. A function
+// that was compiled lazily forwards to its compiled code, which may itself forward to optimized
+// code. If a lazily compiled function is recompiled by tier-up, the stub forwards directly to the
+// optimized code, so the calls counted by the lazily compiled code before then aren't visited.
+template<typename Visitor> static void visitCallCounterMutableDatas(Function *function, Visitor &&visitor) {
+    FunctionMutableData *mutableData = function->mutableData;
+    while (mutableData) {
+        visitor(*mutableData);
+        const U8 *code = mutableData->tierUp.optimizedCode.load(std::memory_order_acquire);
+        mutableData = code ? reinterpret_cast<const Function *>(code - offsetof(Function, code))->mutableData : nullptr;
+    }
+}
+
+static Uptr getNumFunctionImports(const ModuleInstance *moduleInstance) {
+    return moduleInstance->module ? moduleInstance->module->ir.functions.imports.size() : 0;
+}
+
+std::vector<FunctionCallCounts> Runtime::getFunctionCallCounts(ModuleInstance *moduleInstance) {
+    std::vector<FunctionCallCounts> result;
+    for (Uptr functionIndex = getNumFunctionImports(moduleInstance); functionIndex < moduleInstance->functions.size(); ++functionIndex) {
+        Function *function = moduleInstance->functions[functionIndex];
+        FunctionCallCounts counts;
+        counts.debugName = function->mutableData->debugName;
+        counts.numCalls = 0;
+        counts.inclusiveTicks = 0;
+        visitCallCounterMutableDatas(function, [&counts](FunctionMutableData &mutableData) {
+            counts.numCalls += mutableData.callCounters.numCalls.load(std::memory_order_relaxed);
+            counts.inclusiveTicks += mutableData.callCounters.inclusiveTicks.load(std::memory_order_relaxed);
+        });
+        result.push_back(std::move(counts));
+    }
+    return result;
+}
+
+void Runtime::resetFunctionCallCounts(ModuleInstance *moduleInstance) {
+    for (Uptr functionIndex = getNumFunctionImports(moduleInstance); functionIndex < moduleInstance->functions.size(); ++functionIndex) {
+        visitCallCounterMutableDatas(moduleInstance->functions[functionIndex], [](FunctionMutableData &mutableData) {
+            mutableData.callCounters.numCalls.store(0, std::memory_order_relaxed);
+            mutableData.callCounters.inclusiveTicks.store(0, std::memory_order_relaxed);
+
+            // Keep the header that gives the number of branches and call_indirects. The
+            // call_indirect targets are also cleared, so a slot can record a different function.
+            if (std::atomic<U64> *counters = mutableData.profileCounters) {
+                const Uptr numCounters = LLVMJIT::numProfileCountersHeaderElements + Uptr(counters[0].load(std::memory_order_relaxed)) * 2 + Uptr(counters[1].load(std::memory_order_relaxed)) * LLVMJIT::numCallIndirectProfileCounters;
+                for (Uptr counterIndex = LLVMJIT::numProfileCountersHeaderElements; counterIndex < numCounters; ++counterIndex) {
+                    counters[counterIndex].store(0, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+}
+
+// Records a call from a call_indirect compiled with CompileOptions::enableProfileCounters. The
+// targetCounters are the call_indirect's counters: pairs of a Runtime::Function address and its
+// number of calls, followed by the number of calls to other functions. A slot is claimed for a new
+// target with a compare-and-swap, so concurrent calls never count a call to the wrong function.
+DEFINE_INTRINSIC_FUNCTION(wavmIntrinsics, "profileCallIndirect", void, profileCallIndirect, Uptr targetCountersAddress, const Function *function) {
+    std::atomic<U64> *targetCounters = reinterpret_cast<std::atomic<U64> *>(targetCountersAddress);
+    const U64 functionAddress = U64(reinterpret_cast<Uptr>(function));
+    for (Uptr slotIndex = 0; slotIndex < LLVMJIT::numProfiledCallIndirectTargets; ++slotIndex) {
+        std::atomic<U64> &slotFunction = targetCounters[slotIndex * 2];
+        U64 slotFunctionAddress = slotFunction.load(std::memory_order_relaxed);
+        if (!slotFunctionAddress && slotFunction.compare_exchange_strong(slotFunctionAddress, functionAddress, std::memory_order_relaxed)) {
+            slotFunctionAddress = functionAddress;
+        }
+        if (slotFunctionAddress == functionAddress) {
+            targetCounters[slotIndex * 2 + 1].fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+    targetCounters[LLVMJIT::numProfiledCallIndirectTargets * 2].fetch_add(1, std::memory_order_relaxed);
+}
+
+// Adds the profile counters of a piece of a function's code to its profile. The call_indirect
+// targets are mapped from their Runtime::Function to the module instance's function definition
+// index, and calls to functions of other instances are counted as other calls.
+static void addProfileCounters(const std::atomic<U64> *counters, const HashMap<const Function *, Uptr> &functionToDefIndexMap, LLVMJIT::FunctionProfile &profile) {
+    const Uptr numBranches = Uptr(counters[0].load(std::memory_order_relaxed));
+    const Uptr numCallIndirects = Uptr(counters[1].load(std::memory_order_relaxed));
+    if (profile.branches.size() < numBranches) {
+        profile.branches.resize(numBranches);
+    }
+    if (profile.callIndirects.size() < numCallIndirects) {
+        profile.callIndirects.resize(numCallIndirects);
+    }
+
+    const std::atomic<U64> *branchCounters = counters + LLVMJIT::numProfileCountersHeaderElements;
+    for (Uptr branchIndex = 0; branchIndex < numBranches; ++branchIndex) {
+        profile.branches[branchIndex].numTaken += branchCounters[branchIndex * 2].load(std::memory_order_relaxed);
+        profile.branches[branchIndex].numNotTaken += branchCounters[branchIndex * 2 + 1].load(std::memory_order_relaxed);
+    }
+
+    const std::atomic<U64> *callIndirectCounters = branchCounters + numBranches * 2;
+    for (Uptr callIndirectIndex = 0; callIndirectIndex < numCallIndirects; ++callIndirectIndex) {
+        const std::atomic<U64> *targetCounters = callIndirectCounters + callIndirectIndex * LLVMJIT::numCallIndirectProfileCounters;
+        LLVMJIT::CallIndirectProfile &callIndirectProfile = profile.callIndirects[callIndirectIndex];
+        callIndirectProfile.numOtherCalls += targetCounters[LLVMJIT::numProfiledCallIndirectTargets * 2].load(std::memory_order_relaxed);
+        for (Uptr slotIndex = 0; slotIndex < LLVMJIT::numProfiledCallIndirectTargets; ++slotIndex) {
+            const Function *function = reinterpret_cast<const Function *>(Uptr(targetCounters[slotIndex * 2].load(std::memory_order_relaxed)));
+            const U64 numCalls = targetCounters[slotIndex * 2 + 1].load(std::memory_order_relaxed);
+            const Uptr *functionDefIndex = function ? functionToDefIndexMap.get(function) : nullptr;
+            if (!functionDefIndex) {
+                callIndirectProfile.numOtherCalls += numCalls;
+                continue;
+            }
+
+            bool isExistingTarget = false;
+            for (LLVMJIT::CallIndirectTargetProfile &target : callIndirectProfile.targets) {
+                if (target.functionDefIndex == *functionDefIndex) {
+                    target.numCalls += numCalls;
+                    isExistingTarget = true;
+                }
+            }
+            if (!isExistingTarget) {
+                callIndirectProfile.targets.push_back({*functionDefIndex, numCalls});
+            }
+        }
+    }
+}
+
+LLVMJIT::ModuleProfile Runtime::getModuleProfile(ModuleInstance *moduleInstance) {
+    const Uptr numFunctionImports = getNumFunctionImports(moduleInstance);
+    HashMap<const Function *, Uptr> functionToDefIndexMap;
+    for (Uptr functionIndex = numFunctionImports; functionIndex < moduleInstance->functions.size(); ++functionIndex) {
+        functionToDefIndexMap.addOrFail(moduleInstance->functions[functionIndex], functionIndex - numFunctionImports);
+    }
+
+    LLVMJIT::ModuleProfile profile;
+    for (Uptr functionIndex = numFunctionImports; functionIndex < moduleInstance->functions.size(); ++functionIndex) {
+        LLVMJIT::FunctionProfile functionProfile;
+        visitCallCounterMutableDatas(moduleInstance->functions[functionIndex], [&](FunctionMutableData &mutableData) {
+            functionProfile.numCalls += mutableData.callCounters.numCalls.load(std::memory_order_relaxed);
+            if (mutableData.profileCounters) {
+                addProfileCounters(mutableData.profileCounters, functionToDefIndexMap, functionProfile);
+            }
+        });
+        profile.functionDefs.push_back(std::move(functionProfile));
+    }
+    return profile;
+}
+
+template<typename Stream> static void serialize(Stream &stream, LLVMJIT::FunctionProfile &profile) {
+    Serialization::serialize(stream, profile.numCalls);
+    Serialization::serializeArray(stream, profile.branches, [](Stream &stream, LLVMJIT::BranchProfile &branch) {
+        Serialization::serialize(stream, branch.numTaken);
+        Serialization::serialize(stream, branch.numNotTaken);
+    });
+    Serialization::serializeArray(stream, profile.callIndirects, [](Stream &stream, LLVMJIT::CallIndirectProfile &callIndirect) {
+        Serialization::serializeArray(stream, callIndirect.targets, [](Stream &stream, LLVMJIT::CallIndirectTargetProfile &target) {
+            Serialization::serializeVarUInt32(stream, target.functionDefIndex);
+            Serialization::serialize(stream, target.numCalls);
+        });
+        Serialization::serialize(stream, callIndirect.numOtherCalls);
+    });
+}
+
+template<typename Stream> static void serialize(Stream &stream, LLVMJIT::ModuleProfile &profile) {
+    char magic[sizeof(moduleProfileMagic)];
+    memcpy(magic, moduleProfileMagic, sizeof(magic));
+    Serialization::serializeBytes(stream, (U8 *) magic, sizeof(magic));
+    U32 version = moduleProfileVersion;
+    Serialization::serialize(stream, version);
+    if (memcmp(magic, moduleProfileMagic, sizeof(magic)) || version != moduleProfileVersion) {
+        throw Serialization::FatalSerializationException("not a profile written by this version of WAVM");
+    }
+
+    Serialization::serializeArray(stream, profile.functionDefs, [](Stream &stream, LLVMJIT::FunctionProfile &functionProfile) {
+        serialize(stream, functionProfile);
+    });
+}
+
+void Runtime::saveModuleProfile(const LLVMJIT::ModuleProfile &profile, Serialization::OutputStream &stream) {
+    LLVMJIT::ModuleProfile profileCopy = profile;
+    serialize(stream, profileCopy);
+}
+
+void Runtime::loadModuleProfile(Serialization::InputStream &stream, LLVMJIT::ModuleProfile &outProfile) {
+    serialize(stream, outProfile);
+}
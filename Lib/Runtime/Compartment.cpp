@@ -1,4 +1,5 @@
 #include <stddef.h>
+#include <string.h>
 #include <atomic>
 #include <memory>
 
@@ -9,19 +10,28 @@
 using namespace WAVM;
 using namespace WAVM::Runtime;
 
-Runtime::Compartment::Compartment()
+Runtime::Compartment::Compartment(Uptr inNUMANode)
         : GCObject(ObjectKind::compartment, this), unalignedRuntimeData(nullptr), tables(0, maxTables - 1),
           memories(0, maxMemories - 1)
 // Use UINTPTR_MAX as an invalid ID for globals, exception types, and module instances.
         , globals(0, UINTPTR_MAX - 1), exceptionTypes(0, UINTPTR_MAX - 1), moduleInstances(0, UINTPTR_MAX - 1),
-          contexts(0, maxContexts - 1) {
-    runtimeData = (CompartmentRuntimeData *) Platform::allocateAlignedVirtualPages(compartmentReservedBytes
-                                                                                           >> Platform::getPageSizeLog2(), compartmentRuntimeDataAlignmentLog2, unalignedRuntimeData);
+          contexts(0, maxContexts - 1), numaNode(inNUMANode) {
+    runtimeData = (CompartmentRuntimeData *) allocateAlignedReservation(ReservationKind::compartment, compartmentReservedBytes
+            >> Platform::getPageSizeLog2(), unalignedRuntimeData);
+
+    // Set the placement of the runtime data before committing any of it. A pooled reservation may
+    // have been placed on another node by the compartment that used it before.
+    Platform::setVirtualPagesNUMANode((U8 *) runtimeData, compartmentReservedBytes >> Platform::getPageSizeLog2(), numaNode);
 
     errorUnless(Platform::commitVirtualPages((U8 *) runtimeData, offsetof(CompartmentRuntimeData, contexts)
             >> Platform::getPageSizeLog2()));
 
     runtimeData->compartment = this;
+
+    for (Uptr kindIndex = 0; kindIndex < Uptr(CompartmentMemoryKind::num); ++kindIndex) {
+        numCommittedBytesByKind[kindIndex].store(0, std::memory_order_relaxed);
+    }
+    chargeCompartmentMemory(this, CompartmentMemoryKind::runtimeData, offsetof(CompartmentRuntimeData, contexts));
 }
 
 Runtime::Compartment::~Compartment() {
@@ -34,14 +44,97 @@ Runtime::Compartment::~Compartment() {
     wavmAssert(!moduleInstances.size());
     wavmAssert(!contexts.size());
 
-    Platform::freeAlignedVirtualPages(unalignedRuntimeData, compartmentReservedBytes
-            >> Platform::getPageSizeLog2(), compartmentRuntimeDataAlignmentLog2);
+    if (gcState) {
+        destroyIncrementalGCState(gcState);
+        gcState = nullptr;
+    }
+
+    // Return the runtime data reservation to the pool, decommitting the header and the context
+    // slots that were committed.
+    const Uptr numCommittedBytes = offsetof(CompartmentRuntimeData, contexts) + numCommittedContexts * sizeof(ContextRuntimeData);
+    freeAlignedReservation(ReservationKind::compartment, (U8 *) runtimeData, unalignedRuntimeData, compartmentReservedBytes
+            >> Platform::getPageSizeLog2(), numCommittedBytes >> Platform::getPageSizeLog2());
     runtimeData = nullptr;
     unalignedRuntimeData = nullptr;
 }
 
-Compartment *Runtime::createCompartment() {
-    return new Compartment;
+Compartment *Runtime::createCompartment(Uptr numaNode) {
+    errorUnless(numaNode == Platform::anyNUMANode || numaNode < Platform::getNumNUMANodes());
+    return new Compartment(numaNode);
+}
+
+Uptr Runtime::getCompartmentNUMANode(const Compartment *compartment) {
+    return compartment->numaNode;
+}
+
+bool Runtime::tryChargeCompartmentMemory(Compartment *compartment, CompartmentMemoryKind kind, Uptr numBytes) {
+    const Uptr maxCommittedBytes = compartment->maxCommittedBytes.load(std::memory_order_relaxed);
+    Uptr previousNumCommittedBytes = compartment->numCommittedBytes.load(std::memory_order_relaxed);
+    do {
+        if (numBytes > maxCommittedBytes || previousNumCommittedBytes > maxCommittedBytes - numBytes) {
+            return false;
+        }
+    } while (!compartment->numCommittedBytes.compare_exchange_weak(previousNumCommittedBytes, previousNumCommittedBytes + numBytes, std::memory_order_relaxed));
+
+    compartment->numCommittedBytesByKind[Uptr(kind)].fetch_add(numBytes, std::memory_order_relaxed);
+    return true;
+}
+
+void Runtime::chargeCompartmentMemory(Compartment *compartment, CompartmentMemoryKind kind, Uptr numBytes) {
+    compartment->numCommittedBytes.fetch_add(numBytes, std::memory_order_relaxed);
+    compartment->numCommittedBytesByKind[Uptr(kind)].fetch_add(numBytes, std::memory_order_relaxed);
+}
+
+void Runtime::releaseCompartmentMemory(Compartment *compartment, CompartmentMemoryKind kind, Uptr numBytes) {
+    wavmAssert(compartment->numCommittedBytesByKind[Uptr(kind)].load(std::memory_order_relaxed) >= numBytes);
+    compartment->numCommittedBytes.fetch_sub(numBytes, std::memory_order_relaxed);
+    compartment->numCommittedBytesByKind[Uptr(kind)].fetch_sub(numBytes, std::memory_order_relaxed);
+}
+
+CompartmentMemoryUsage Runtime::getCompartmentMemoryUsage(const Compartment *compartment) {
+    CompartmentMemoryUsage usage;
+    usage.memoryBytes = compartment->numCommittedBytesByKind[Uptr(CompartmentMemoryKind::memory)].load(std::memory_order_relaxed);
+    usage.tableBytes = compartment->numCommittedBytesByKind[Uptr(CompartmentMemoryKind::table)].load(std::memory_order_relaxed);
+    usage.runtimeDataBytes = compartment->numCommittedBytesByKind[Uptr(CompartmentMemoryKind::runtimeData)].load(std::memory_order_relaxed);
+    usage.codeBytes = compartment->numCommittedBytesByKind[Uptr(CompartmentMemoryKind::code)].load(std::memory_order_relaxed);
+    usage.totalBytes = usage.memoryBytes + usage.tableBytes + usage.runtimeDataBytes + usage.codeBytes;
+    return usage;
+}
+
+void Runtime::setCompartmentMemoryLimit(Compartment *compartment, Uptr maxBytes) {
+    compartment->maxCommittedBytes.store(maxBytes, std::memory_order_relaxed);
+}
+
+Uptr Runtime::parkCompartment(Compartment *compartment, bool reclaimColdPages) {
+    Lock<Platform::Mutex> compartmentLock(compartment->mutex);
+
+    const Uptr pageSizeLog2 = Platform::getPageSizeLog2();
+    const Uptr platformPagesPerWebAssemblyPageLog2 = IR::numBytesPerPageLog2 - pageSizeLog2;
+    Uptr numReleasedPages = 0;
+    Uptr numReclaimedPages = 0;
+    for (Memory *memory : compartment->memories) {
+        const Uptr numPlatformPages = memory->numPages.load(std::memory_order_acquire) << platformPagesPerWebAssemblyPageLog2;
+
+        // Releasing a page mapped from a page file would revert it to the page file's contents.
+        if (!memory->isMappedFromPageFile) {
+            numReleasedPages += Platform::releaseZeroPages(memory->baseAddress, numPlatformPages);
+        }
+        if (reclaimColdPages && Platform::reclaimVirtualPages(memory->baseAddress, numPlatformPages)) {
+            numReclaimedPages += numPlatformPages;
+        }
+    }
+
+    // Uninitialized table elements are zero, so a table's unused pages can be released too.
+    for (Table *table : compartment->tables) {
+        Lock<Platform::Mutex> resizingLock(table->resizingMutex);
+        const Uptr numElementBytes = table->numElements.load(std::memory_order_acquire) * sizeof(Table::Element);
+        const Uptr numPlatformPages = (numElementBytes + (Uptr(1) << pageSizeLog2) - 1) >> pageSizeLog2;
+        numReleasedPages += Platform::releaseZeroPages((U8 *) table->elements, numPlatformPages);
+    }
+
+    addToMetric(Metrics::Counter::numReleasedZeroPages, numReleasedPages);
+    addToMetric(Metrics::Counter::numReclaimedPages, numReclaimedPages);
+    return numReleasedPages << pageSizeLog2;
 }
 
 bool Runtime::isInCompartment(Object *object, const Compartment *compartment) {
@@ -66,3 +159,73 @@ bool Runtime::isInCompartment(Object *object, const Compartment *compartment) {
         return gcObject->compartment == compartment;
     }
 }
+
+Object *Runtime::remapToClonedCompartment(Object *object, const Compartment *newCompartment) {
+    switch (object->kind) {
+        case ObjectKind::function:
+            return object;
+        case ObjectKind::table:
+            return asObject(newCompartment->tables[asTable(object)->id]);
+        case ObjectKind::memory:
+            return asObject(newCompartment->memories[asMemory(object)->id]);
+        case ObjectKind::global:
+            return asObject(newCompartment->globals[asGlobal(object)->id]);
+        case ObjectKind::exceptionType:
+            return asObject(newCompartment->exceptionTypes[asExceptionType(object)->id]);
+        case ObjectKind::moduleInstance:
+            return asObject(newCompartment->moduleInstances[asModuleInstance(object)->id]);
+        default:
+            Errors::unreachable();
+    };
+}
+
+Compartment *Runtime::cloneCompartment(const Compartment *compartment) {
+    Compartment *newCompartment = new Compartment(compartment->numaNode);
+    newCompartment->maxCommittedBytes.store(compartment->maxCommittedBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    Lock<Platform::Mutex> compartmentLock(compartment->mutex);
+
+    // Clone the objects in dependency order: globals and module instances may refer to the
+    // objects cloned before them.
+    for (Table *table : compartment->tables) {
+        errorUnless(cloneTable(table, newCompartment));
+    }
+    for (Memory *memory : compartment->memories) {
+        errorUnless(cloneMemory(memory, newCompartment));
+    }
+    for (ExceptionType *exceptionType : compartment->exceptionTypes) {
+        errorUnless(cloneExceptionType(exceptionType, newCompartment));
+    }
+
+    // Copy the mutable global allocation mask and the initial values for new contexts, so the cloned
+    // globals can keep their mutable data indices.
+    newCompartment->globalDataAllocationMask = compartment->globalDataAllocationMask;
+    memcpy(newCompartment->initialContextMutableGlobals, compartment->initialContextMutableGlobals, sizeof(newCompartment->initialContextMutableGlobals));
+    for (Global *global : compartment->globals) {
+        Global *newGlobal = cloneGlobal(global, newCompartment);
+        errorUnless(newGlobal);
+        if (global->type.isMutable && isReferenceType(global->type.valueType)) {
+            IR::UntaggedValue &initialValue = newCompartment->initialContextMutableGlobals[global->mutableGlobalIndex];
+            if (initialValue.object) {
+                initialValue.object = remapToClonedCompartment(initialValue.object, newCompartment);
+            }
+        }
+    }
+
+    for (ModuleInstance *moduleInstance : compartment->moduleInstances) {
+        errorUnless(cloneModuleInstance(moduleInstance, newCompartment));
+    }
+
+    // Now that all the objects have been cloned, remap the cloned table elements that refer to
+    // objects other than functions.
+    for (Table *newTable : newCompartment->tables) {
+        const Uptr numElements = getTableNumElements(newTable);
+        for (Uptr elementIndex = 0; elementIndex < numElements; ++elementIndex) {
+            Object *element = getTableElement(newTable, elementIndex);
+            if (element && element->kind != ObjectKind::function) {
+                setTableElement(newTable, elementIndex, remapToClonedCompartment(element, newCompartment));
+            }
+        }
+    }
+
+    return newCompartment;
+}
@@ -0,0 +1,103 @@
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "RuntimePrivate.h"
+#include "WAVM/IR/Module.h"
+#include "WAVM/Inline/Assert.h"
+#include "WAVM/Inline/BasicTypes.h"
+#include "WAVM/LLVMJIT/LLVMJIT.h"
+#include "WAVM/Platform/Thread.h"
+#include "WAVM/Runtime/Runtime.h"
+
+using namespace WAVM;
+using namespace WAVM::Runtime;
+
+// The maximum number of compilation threads, so compiles don't take all the hardware threads from
+// the threads that run code.
+static constexpr Uptr maxCompileThreads = 8;
+
+// The queues of jobs waiting for the compilation threads, one for each priority.
+struct CompileQueue {
+    std::mutex mutex;
+    std::condition_variable jobAdded;
+    std::deque<std::function<void()>> foregroundJobs;
+    std::deque<std::function<void()>> backgroundJobs;
+    Uptr numThreads = 0;
+    Uptr numIdleThreads = 0;
+};
+
+static CompileQueue &getCompileQueue() {
+    // The queue is never freed, so the detached compilation threads can't observe it being
+    // destroyed during process exit.
+    static CompileQueue *queue = new CompileQueue;
+    return *queue;
+}
+
+static void compileThreadEntry() {
+    CompileQueue &queue = getCompileQueue();
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> queueLock(queue.mutex);
+            ++queue.numIdleThreads;
+            queue.jobAdded.wait(queueLock, [&queue] { return !queue.foregroundJobs.empty() || !queue.backgroundJobs.empty(); });
+            --queue.numIdleThreads;
+
+            // Background jobs only run when there are no foreground jobs waiting.
+            std::deque<std::function<void()>> &jobs = queue.foregroundJobs.empty() ? queue.backgroundJobs : queue.foregroundJobs;
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+
+        job();
+    }
+}
+
+void Runtime::queueCompileJob(CompilePriority priority, std::function<void()> &&job) {
+    CompileQueue &queue = getCompileQueue();
+    {
+        std::lock_guard<std::mutex> queueLock(queue.mutex);
+        if (priority == CompilePriority::foreground) {
+            queue.foregroundJobs.push_back(std::move(job));
+        } else {
+            queue.backgroundJobs.push_back(std::move(job));
+        }
+
+        // Start another compilation thread if all the threads are busy, up to the limit.
+        const Uptr maxThreads = std::min(std::max(Platform::getNumberOfHardwareThreads(), Uptr(1)), maxCompileThreads);
+        if (!queue.numIdleThreads && queue.numThreads < maxThreads) {
+            ++queue.numThreads;
+            std::thread(compileThreadEntry).detach();
+        }
+    }
+    queue.jobAdded.notify_one();
+}
+
+std::future<ModuleRef> Runtime::compileModuleAsync(const IR::Module &irModule, const LLVMJIT::CompileOptions &options, CompilePriority priority, std::shared_ptr<CompileCancellation> cancellation) {
+    // The job owns copies of the IR and options, so the caller doesn't need to keep them alive
+    // until the compile finishes.
+    std::shared_ptr<IR::Module> irModuleCopy = std::make_shared<IR::Module>(irModule);
+    std::shared_ptr<std::promise<ModuleRef>> promise = std::make_shared<std::promise<ModuleRef>>();
+    std::future<ModuleRef> future = promise->get_future();
+    queueCompileJob(priority, [irModuleCopy, options, cancellation, promise] {
+        if (cancellation && cancellation->isCancelled.load(std::memory_order_acquire)) {
+            promise->set_value(nullptr);
+            return;
+        }
+
+        try {
+            promise->set_value(Runtime::compileModule(*irModuleCopy, options));
+        } catch (...) {
+            promise->set_exception(std::current_exception());
+        }
+    });
+    return future;
+}
@@ -0,0 +1,477 @@
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "RuntimePrivate.h"
+#include "WAVM/IR/Types.h"
+#include "WAVM/IR/Value.h"
+#include "WAVM/Inline/Assert.h"
+#include "WAVM/Inline/BasicTypes.h"
+#include "WAVM/Inline/Errors.h"
+#include "WAVM/Inline/Lock.h"
+#include "WAVM/Platform/Event.h"
+#include "WAVM/Platform/Memory.h"
+#include "WAVM/Platform/Mutex.h"
+#include "WAVM/Platform/Thread.h"
+#include "WAVM/Runtime/Runtime.h"
+
+using namespace WAVM;
+using namespace WAVM::IR;
+using namespace WAVM::Runtime;
+
+struct ExecutorWorker;
+
+namespace WAVM {
+    namespace Runtime {
+        struct ExecutorTask {
+            // The task roots its function until it completes, so it stays alive while it's queued.
+            GCPointer<Function> function;
+            std::vector<UntaggedValue> arguments;
+            InvocationCompletion completion;
+
+            // The task's invocation, once a worker started it. The invocation is bound to that
+            // worker's thread, so a task is only stolen before it starts.
+            Invocation *invocation = nullptr;
+            ExecutorWorker *worker = nullptr;
+
+            // Whether the invocation is suspended by yieldInvocation, rather than waiting for
+            // scheduleResume.
+            bool isYielding = false;
+        };
+    }
+}
+
+// A Chase-Lev work-stealing deque of the tasks that haven't started. The worker that owns it pushes
+// and pops tasks at the bottom, and other workers steal tasks from the top. The buffer grows when
+// it is full; the old buffers are kept until the deque is destroyed, since a thief may still be
+// reading one.
+struct TaskDeque {
+    struct Buffer {
+        Uptr indexMask;
+        std::unique_ptr<std::atomic<ExecutorTask *>[]> tasks;
+
+        Buffer(Uptr numTasks) : indexMask(numTasks - 1), tasks(new std::atomic<ExecutorTask *>[numTasks]) {
+        }
+
+        std::atomic<ExecutorTask *> &operator[](Iptr index) {
+            return tasks[Uptr(index) & indexMask];
+        }
+    };
+
+    std::atomic<Iptr> top{0};
+    std::atomic<Iptr> bottom{0};
+    std::atomic<Buffer *> buffer;
+    std::vector<std::unique_ptr<Buffer>> buffers;
+
+    TaskDeque() {
+        buffers.emplace_back(new Buffer(256));
+        buffer.store(buffers.back().get(), std::memory_order_relaxed);
+    }
+
+    // Called by the owner.
+    void push(ExecutorTask *task) {
+        const Iptr bottomIndex = bottom.load(std::memory_order_relaxed);
+        const Iptr topIndex = top.load(std::memory_order_acquire);
+        Buffer *currentBuffer = buffer.load(std::memory_order_relaxed);
+        if (Uptr(bottomIndex - topIndex) > currentBuffer->indexMask) {
+            Buffer *newBuffer = new Buffer((currentBuffer->indexMask + 1) * 2);
+            for (Iptr index = topIndex; index < bottomIndex; ++index) {
+                (*newBuffer)[index].store((*currentBuffer)[index].load(std::memory_order_relaxed), std::memory_order_relaxed);
+            }
+            buffers.emplace_back(newBuffer);
+            buffer.store(newBuffer, std::memory_order_release);
+            currentBuffer = newBuffer;
+        }
+        (*currentBuffer)[bottomIndex].store(task, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(bottomIndex + 1, std::memory_order_relaxed);
+    }
+
+    // Called by the owner.
+    ExecutorTask *pop() {
+        const Iptr bottomIndex = bottom.load(std::memory_order_relaxed) - 1;
+        Buffer *currentBuffer = buffer.load(std::memory_order_relaxed);
+        bottom.store(bottomIndex, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        Iptr topIndex = top.load(std::memory_order_relaxed);
+        if (topIndex > bottomIndex) {
+            bottom.store(bottomIndex + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        ExecutorTask *task = (*currentBuffer)[bottomIndex].load(std::memory_order_relaxed);
+        if (topIndex == bottomIndex) {
+            // This is the last task, so race the thieves for it.
+            if (!top.compare_exchange_strong(topIndex, topIndex + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                task = nullptr;
+            }
+            bottom.store(bottomIndex + 1, std::memory_order_relaxed);
+        }
+        return task;
+    }
+
+    // Called by any thread.
+    ExecutorTask *steal() {
+        Iptr topIndex = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const Iptr bottomIndex = bottom.load(std::memory_order_acquire);
+        if (topIndex >= bottomIndex) {
+            return nullptr;
+        }
+
+        ExecutorTask *task = (*buffer.load(std::memory_order_acquire))[topIndex].load(std::memory_order_relaxed);
+        if (!top.compare_exchange_strong(topIndex, topIndex + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return task;
+    }
+};
+
+struct ExecutorWorker {
+    Executor &executor;
+    const Uptr workerIndex;
+
+    TaskDeque deque;
+
+    // Tasks queued by other threads: new tasks submitted from outside the executor, and suspended
+    // invocations passed to scheduleResume. They are moved to the deque or readyTasks by the worker.
+    Platform::SpinMutex inboxMutex;
+    std::vector<ExecutorTask *> inboxNewTasks;
+    std::vector<ExecutorTask *> inboxResumedTasks;
+    std::atomic<bool> hasInboxTasks{false};
+
+    // The started invocations that are ready to be resumed on this worker.
+    std::vector<ExecutorTask *> readyTasks;
+    Uptr readyTaskIndex = 0;
+
+    // The contexts that aren't used by an invocation. A worker creates more if its invocations are
+    // suspended while holding all of them.
+    std::vector<Context *> freeContexts;
+    std::vector<Context *> contexts;
+
+    // The context of the invocation the worker is running, for interruptExecutorWorkers. The
+    // mutex is held while an interrupt is requested in the context, and while the worker clears
+    // the context and any interrupt requested in it, so a request made for one invocation can't be
+    // delivered to the next invocation that runs in the context.
+    Platform::SpinMutex runningContextMutex;
+    Context *runningContext = nullptr;
+
+    std::atomic<bool> isSleeping{false};
+    Platform::Event wakeEvent;
+    U64 randomState;
+    std::thread thread;
+
+    ExecutorWorker(Executor &inExecutor, Uptr inWorkerIndex)
+            : executor(inExecutor), workerIndex(inWorkerIndex), randomState(inWorkerIndex * 0x9e3779b97f4a7c15ull + 1) {
+    }
+
+    void threadEntry();
+    ExecutorTask *findTask();
+    void runTask(ExecutorTask *task);
+    void takeInboxTasks();
+    void wake();
+};
+
+namespace WAVM {
+    namespace Runtime {
+        struct Executor {
+            Compartment *const compartment;
+            const Uptr numStackBytes;
+            std::vector<std::unique_ptr<ExecutorWorker>> workers;
+
+            std::atomic<Uptr> nextWorkerIndex{0};
+            std::atomic<Uptr> numSleepingWorkers{0};
+
+            // The number of submitted tasks that haven't completed. destroyExecutor waits for it to
+            // reach zero.
+            std::atomic<Uptr> numIncompleteTasks{0};
+            Platform::Event tasksCompletedEvent;
+
+            std::atomic<bool> isShuttingDown{false};
+
+            Executor(Compartment *inCompartment, Uptr inNumStackBytes) : compartment(inCompartment), numStackBytes(inNumStackBytes) {
+            }
+
+            // Wakes a sleeping worker, if there is one, so it can steal a task that was just queued.
+            void wakeSleepingWorker();
+        };
+    }
+}
+
+// The worker running on the calling thread, or null if it isn't one of an executor's workers.
+static thread_local ExecutorWorker *currentWorker = nullptr;
+
+void ExecutorWorker::wake() {
+    if (isSleeping.exchange(false, std::memory_order_acq_rel)) {
+        executor.numSleepingWorkers.fetch_sub(1, std::memory_order_relaxed);
+        wakeEvent.signal();
+    }
+}
+
+void Executor::wakeSleepingWorker() {
+    if (!numSleepingWorkers.load(std::memory_order_acquire)) {
+        return;
+    }
+    const Uptr firstWorkerIndex = nextWorkerIndex.fetch_add(1, std::memory_order_relaxed);
+    for (Uptr offset = 0; offset < workers.size(); ++offset) {
+        ExecutorWorker &worker = *workers[(firstWorkerIndex + offset) % workers.size()];
+        if (worker.isSleeping.load(std::memory_order_acquire)) {
+            worker.wake();
+            return;
+        }
+    }
+}
+
+void ExecutorWorker::takeInboxTasks() {
+    if (!hasInboxTasks.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    std::vector<ExecutorTask *> newTasks;
+    std::vector<ExecutorTask *> resumedTasks;
+    {
+        Lock<Platform::SpinMutex> inboxLock(inboxMutex);
+        newTasks.swap(inboxNewTasks);
+        resumedTasks.swap(inboxResumedTasks);
+        hasInboxTasks.store(false, std::memory_order_relaxed);
+    }
+
+    for (ExecutorTask *task : newTasks) {
+        deque.push(task);
+    }
+    readyTasks.insert(readyTasks.end(), resumedTasks.begin(), resumedTasks.end());
+
+    // Let sleeping workers steal the new tasks.
+    if (newTasks.size() > 1) {
+        executor.wakeSleepingWorker();
+    }
+}
+
+ExecutorTask *ExecutorWorker::findTask() {
+    takeInboxTasks();
+
+    // Resume the started invocations first, since they hold contexts and stacks.
+    if (readyTaskIndex < readyTasks.size()) {
+        ExecutorTask *task = readyTasks[readyTaskIndex++];
+        if (readyTaskIndex == readyTasks.size()) {
+            readyTasks.clear();
+            readyTaskIndex = 0;
+        }
+        return task;
+    }
+
+    if (ExecutorTask *task = deque.pop()) {
+        return task;
+    }
+
+    // Steal from the other workers, starting at a random one so thieves spread across victims.
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 7;
+    randomState ^= randomState << 17;
+    const Uptr numWorkers = executor.workers.size();
+    const Uptr firstVictimIndex = Uptr(randomState % numWorkers);
+    for (Uptr offset = 0; offset < numWorkers; ++offset) {
+        ExecutorWorker &victim = *executor.workers[(firstVictimIndex + offset) % numWorkers];
+        if (&victim != this) {
+            if (ExecutorTask *task = victim.deque.steal()) {
+                return task;
+            }
+        }
+    }
+    return nullptr;
+}
+
+void ExecutorWorker::runTask(ExecutorTask *task) {
+    Invocation *invocation = task->invocation;
+    if (!invocation) {
+        Context *context;
+        if (freeContexts.size()) {
+            context = freeContexts.back();
+            freeContexts.pop_back();
+        } else {
+            context = createContext(executor.compartment);
+            errorUnless(context);
+            addGCRoot(asObject(context));
+            contexts.push_back(context);
+        }
+
+        invocation = createInvocation(context, task->function, task->arguments.data(), executor.numStackBytes);
+        invocation->executorTask = task;
+        task->invocation = invocation;
+        task->worker = this;
+    }
+
+    {
+        Lock<Platform::SpinMutex> runningContextLock(runningContextMutex);
+        runningContext = invocation->context;
+    }
+    try {
+        resumeInvocation(invocation);
+    } catch (...) {
+        // The invocation is left in the threw state, which the completion observes.
+        wavmAssert(invocation->state == InvocationState::threw);
+    }
+    {
+        Lock<Platform::SpinMutex> runningContextLock(runningContextMutex);
+        runningContext = nullptr;
+        invocation->context->runtimeData->interruptRequested.store(0, std::memory_order_relaxed);
+    }
+
+    if (invocation->state == InvocationState::suspended) {
+        // A yielded invocation is ready again right away; otherwise, it waits for scheduleResume.
+        if (task->isYielding) {
+            task->isYielding = false;
+            readyTasks.push_back(task);
+        }
+        return;
+    }
+
+    task->completion(invocation);
+
+    Context *context = invocation->context;
+    destroyInvocation(invocation);
+    freeContexts.push_back(context);
+    delete task;
+
+    if (executor.numIncompleteTasks.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        executor.tasksCompletedEvent.signal();
+    }
+}
+
+void ExecutorWorker::threadEntry() {
+    currentWorker = this;
+
+    // Run the worker on the NUMA node that the compartment's memories are placed on, so the guests
+    // don't access them remotely. This also places the stacks the worker touches on that node.
+    if (executor.compartment->numaNode != Platform::anyNUMANode) {
+        Platform::setCurrentThreadNUMANode(executor.compartment->numaNode);
+    }
+
+    while (true) {
+        if (ExecutorTask *task = findTask()) {
+            runTask(task);
+            continue;
+        }
+
+        // Sleep until a task is queued. The worker is marked sleeping before it looks for tasks
+        // again, so a task queued after the last look wakes it.
+        isSleeping.store(true, std::memory_order_seq_cst);
+        executor.numSleepingWorkers.fetch_add(1, std::memory_order_seq_cst);
+        if (executor.isShuttingDown.load(std::memory_order_acquire)) {
+            break;
+        }
+        if (ExecutorTask *task = findTask()) {
+            wake();
+            runTask(task);
+            continue;
+        }
+        wakeEvent.wait(UINT64_MAX);
+        wake();
+    }
+    currentWorker = nullptr;
+}
+
+Executor *Runtime::createExecutor(Compartment *compartment, Uptr numWorkers, Uptr numStackBytes) {
+    if (!numWorkers && compartment->numaNode != Platform::anyNUMANode) {
+        numWorkers = Platform::getNumberOfNUMANodeHardwareThreads(compartment->numaNode);
+    }
+    if (!numWorkers) {
+        numWorkers = Platform::getNumberOfHardwareThreads();
+    }
+    errorUnless(numWorkers > 0);
+
+    Executor *executor = new Executor(compartment, numStackBytes);
+    for (Uptr workerIndex = 0; workerIndex < numWorkers; ++workerIndex) {
+        ExecutorWorker *worker = new ExecutorWorker(*executor, workerIndex);
+        executor->workers.emplace_back(worker);
+
+        // Create each worker's first context up front, so small invocations don't create contexts
+        // while they run.
+        Context *context = createContext(compartment);
+        errorUnless(context);
+        addGCRoot(asObject(context));
+        worker->contexts.push_back(context);
+        worker->freeContexts.push_back(context);
+    }
+    for (const std::unique_ptr<ExecutorWorker> &worker : executor->workers) {
+        ExecutorWorker *workerPointer = worker.get();
+        worker->thread = std::thread([workerPointer] { workerPointer->threadEntry(); });
+    }
+    return executor;
+}
+
+void Runtime::submitInvocation(Executor *executor, Function *function, const UntaggedValue *arguments, InvocationCompletion &&completion) {
+    errorUnless(isInCompartment(asObject(function), executor->compartment));
+    wavmAssert(!executor->isShuttingDown.load(std::memory_order_relaxed));
+
+    ExecutorTask *task = new ExecutorTask;
+    task->function = function;
+    task->arguments.assign(arguments, arguments + FunctionType{function->encodedType}.params().size());
+    task->completion = std::move(completion);
+    executor->numIncompleteTasks.fetch_add(1, std::memory_order_relaxed);
+
+    // A worker queues the task on its own deque without locking. Other threads queue it in the
+    // inbox of a worker chosen round-robin.
+    if (currentWorker && &currentWorker->executor == executor) {
+        currentWorker->deque.push(task);
+        executor->wakeSleepingWorker();
+        return;
+    }
+
+    ExecutorWorker &worker = *executor->workers[executor->nextWorkerIndex.fetch_add(1, std::memory_order_relaxed) % executor->workers.size()];
+    {
+        Lock<Platform::SpinMutex> inboxLock(worker.inboxMutex);
+        worker.inboxNewTasks.push_back(task);
+        worker.hasInboxTasks.store(true, std::memory_order_release);
+    }
+    worker.wake();
+}
+
+void Runtime::scheduleResume(Invocation *invocation) {
+    ExecutorTask *task = invocation->executorTask;
+    errorUnless(task && task->worker);
+
+    ExecutorWorker &worker = *task->worker;
+    {
+        Lock<Platform::SpinMutex> inboxLock(worker.inboxMutex);
+        worker.inboxResumedTasks.push_back(task);
+        worker.hasInboxTasks.store(true, std::memory_order_release);
+    }
+    worker.wake();
+}
+
+void Runtime::yieldInvocation() {
+    Invocation *invocation = getCurrentInvocation();
+    errorUnless(invocation && invocation->executorTask);
+    invocation->executorTask->isYielding = true;
+    suspendInvocation();
+}
+
+void Runtime::interruptExecutorWorkers(Executor *executor) {
+    for (const std::unique_ptr<ExecutorWorker> &worker : executor->workers) {
+        Lock<Platform::SpinMutex> runningContextLock(worker->runningContextMutex);
+        if (worker->runningContext) {
+            requestInterrupt(worker->runningContext);
+        }
+    }
+}
+
+void Runtime::destroyExecutor(Executor *executor) {
+    while (executor->numIncompleteTasks.load(std::memory_order_acquire)) {
+        executor->tasksCompletedEvent.wait(UINT64_MAX);
+    }
+
+    executor->isShuttingDown.store(true, std::memory_order_release);
+    for (const std::unique_ptr<ExecutorWorker> &worker : executor->workers) {
+        worker->wake();
+        worker->wakeEvent.signal();
+    }
+    for (const std::unique_ptr<ExecutorWorker> &worker : executor->workers) {
+        worker->thread.join();
+        for (Context *context : worker->contexts) {
+            removeGCRoot(asObject(context));
+        }
+    }
+    delete executor;
+}
@@ -0,0 +1,32 @@
+#include <atomic>
+
+#include "RuntimePrivate.h"
+#include "WAVM/Runtime/Intrinsics.h"
+#include "WAVM/Runtime/Runtime.h"
+#include "WAVM/Runtime/RuntimeData.h"
+
+using namespace WAVM;
+using namespace WAVM::Runtime;
+
+static std::atomic<OutOfFuelHandler> outOfFuelHandler{nullptr};
+
+void Runtime::setFuel(Context *context, I64 fuel) {
+    context->runtimeData->fuel = fuel;
+}
+
+I64 Runtime::getFuel(const Context *context) {
+    return context->runtimeData->fuel;
+}
+
+void Runtime::setOutOfFuelHandler(OutOfFuelHandler handler) {
+    outOfFuelHandler.store(handler, std::memory_order_release);
+}
+
+DEFINE_INTRINSIC_FUNCTION(wavmIntrinsics, "outOfFuel", void, outOfFuel) {
+    OutOfFuelHandler handler = outOfFuelHandler.load(std::memory_order_acquire);
+    if (!handler) {
+        raiseTrap(Trap::Type::outOfFuel, GET_TRAP_ADDRESS());
+    }
+
+    handler(getContextFromRuntimeData(contextRuntimeData));
+}
@@ -0,0 +1,147 @@
+#include <functional>
+#include <vector>
+
+#include "RuntimePrivate.h"
+#include "WAVM/Inline/Lock.h"
+#include "WAVM/Platform/Fiber.h"
+#include "WAVM/Platform/Mutex.h"
+
+using namespace WAVM;
+using namespace WAVM::Runtime;
+
+// The number of freed guest stacks each thread keeps for itself, and the number kept by the
+// process-wide pool that the threads share. A guest stack that doesn't fit in either is unmapped.
+static constexpr Uptr maxThreadGuestStacks = 4;
+static constexpr Uptr maxPooledGuestStacks = 256;
+
+struct GuestStack {
+    Platform::Fiber *fiber = nullptr;
+    Uptr numStackBytes = 0;
+};
+
+// The freed guest stacks, which keep their memory committed so they are reused without any mmap
+// or page faults. Stacks of different sizes share the pool.
+struct GuestStackPool {
+    Platform::Mutex mutex;
+    std::vector<GuestStack> stacks;
+};
+
+static GuestStackPool &getGuestStackPool() {
+    // The pool is never freed, so threads that exit during process exit can still return their
+    // stacks to it.
+    static GuestStackPool *pool = new GuestStackPool;
+    return *pool;
+}
+
+static void releaseToGuestStackPool(const GuestStack &stack) {
+    GuestStackPool &pool = getGuestStackPool();
+    {
+        Lock<Platform::Mutex> poolLock(pool.mutex);
+        if (pool.stacks.size() < maxPooledGuestStacks) {
+            pool.stacks.push_back(stack);
+            return;
+        }
+    }
+    Platform::destroyFiber(stack.fiber);
+}
+
+struct ThreadGuestStacks {
+    std::vector<GuestStack> stacks;
+
+    // The stack of the call in callOnContextStack that is running on this thread. A signal caught
+    // outside the call jumps out of it without returning its stack, so the next call reclaims it.
+    GuestStack callStack;
+
+    ~ThreadGuestStacks() {
+        for (const GuestStack &stack : stacks) {
+            releaseToGuestStackPool(stack);
+        }
+        if (callStack.fiber) {
+            releaseToGuestStackPool(callStack);
+        }
+    }
+};
+
+static thread_local ThreadGuestStacks threadGuestStacks;
+
+static bool takeGuestStack(std::vector<GuestStack> &stacks, Uptr numStackBytes, GuestStack &outStack) {
+    for (Uptr index = stacks.size(); index; --index) {
+        if (stacks[index - 1].numStackBytes == numStackBytes) {
+            outStack = stacks[index - 1];
+            stacks[index - 1] = stacks.back();
+            stacks.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
+
+Platform::Fiber *Runtime::acquireGuestStack(Uptr numStackBytes, Platform::FiberEntry entry, void *argument) {
+    GuestStack stack;
+    if (takeGuestStack(threadGuestStacks.stacks, numStackBytes, stack)) {
+        Platform::resetFiber(stack.fiber, entry, argument);
+        return stack.fiber;
+    }
+
+    GuestStackPool &pool = getGuestStackPool();
+    {
+        Lock<Platform::Mutex> poolLock(pool.mutex);
+        if (!takeGuestStack(pool.stacks, numStackBytes, stack)) {
+            stack.fiber = nullptr;
+        }
+    }
+    if (stack.fiber) {
+        Platform::resetFiber(stack.fiber, entry, argument);
+        return stack.fiber;
+    }
+
+    return Platform::createFiber(numStackBytes, entry, argument);
+}
+
+void Runtime::releaseGuestStack(Platform::Fiber *fiber, Uptr numStackBytes) {
+    GuestStack stack;
+    stack.fiber = fiber;
+    stack.numStackBytes = numStackBytes;
+    if (threadGuestStacks.stacks.size() < maxThreadGuestStacks) {
+        threadGuestStacks.stacks.push_back(stack);
+    } else {
+        releaseToGuestStackPool(stack);
+    }
+}
+
+static void callOnContextStackEntry(void *thunkVoid) {
+    (*reinterpret_cast<const std::function<void()> *>(thunkVoid))();
+}
+
+void Runtime::callOnContextStack(Context *context, const std::function<void()> &thunk) {
+    // Code that is already on a guest stack, e.g. a host function called by an invocation or by
+    // another call in a context, keeps running on it.
+    if (!context->numStackBytes || Platform::getCurrentFiber()) {
+        thunk();
+        return;
+    }
+
+    // Since the caller isn't on a guest stack, no call is running on this thread, and a call stack
+    // that is left over was abandoned by a signal.
+    ThreadGuestStacks &thread = threadGuestStacks;
+    if (thread.callStack.fiber) {
+        releaseGuestStack(thread.callStack.fiber, thread.callStack.numStackBytes);
+        thread.callStack.fiber = nullptr;
+    }
+
+    thread.callStack.fiber = acquireGuestStack(context->numStackBytes, callOnContextStackEntry, const_cast<std::function<void()> *>(&thunk));
+    thread.callStack.numStackBytes = context->numStackBytes;
+
+    bool returned;
+    try {
+        returned = Platform::resumeFiber(thread.callStack.fiber);
+    } catch (...) {
+        releaseGuestStack(thread.callStack.fiber, thread.callStack.numStackBytes);
+        thread.callStack.fiber = nullptr;
+        throw;
+    }
+    errorUnless(returned);
+
+    releaseGuestStack(thread.callStack.fiber, thread.callStack.numStackBytes);
+    thread.callStack.fiber = nullptr;
+}
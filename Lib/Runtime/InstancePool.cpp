@@ -0,0 +1,208 @@
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "RuntimePrivate.h"
+#include "WAVM/Platform/Event.h"
+#include "WAVM/Platform/Intrinsic.h"
+#include "WAVM/Runtime/Runtime.h"
+
+using namespace WAVM;
+using namespace WAVM::Runtime;
+
+namespace WAVM {
+    namespace Runtime {
+        // The ready instances are kept in a bounded multi-producer, multi-consumer queue: each slot
+        // has a sequence number that tells a producer or consumer whether the slot is ready for it,
+        // so pushing and popping only take a compare-and-swap of the queue's push or pop index.
+        struct InstancePool {
+            struct Slot {
+                std::atomic<Uptr> sequence;
+                ModuleInstance *moduleInstance;
+            };
+
+            Compartment *const compartment;
+            const InstanceFactory factory;
+            const Uptr numInstances;
+
+            std::unique_ptr<Slot[]> slots;
+            Uptr slotIndexMask;
+            std::atomic<Uptr> pushIndex{0};
+            std::atomic<Uptr> popIndex{0};
+
+            // The number of instances in the queue, plus the number being created or requested.
+            std::atomic<Uptr> numQueuedOrPendingInstances{0};
+
+            // The number of instances the refill threads should create.
+            std::atomic<Uptr> numRequestedInstances{0};
+
+            std::atomic<bool> isShuttingDown{false};
+            std::atomic<Uptr> nextRefillThreadIndex{0};
+            std::vector<std::unique_ptr<Platform::Event>> refillThreadEvents;
+            std::vector<std::thread> refillThreads;
+
+            InstancePool(Compartment *inCompartment, InstanceFactory &&inFactory, Uptr inNumInstances)
+                    : compartment(inCompartment), factory(std::move(inFactory)), numInstances(inNumInstances) {
+                const Uptr numSlots = Uptr(1) << Platform::ceilLogTwo(numInstances);
+                slots.reset(new Slot[numSlots]);
+                slotIndexMask = numSlots - 1;
+                for (Uptr slotIndex = 0; slotIndex < numSlots; ++slotIndex) {
+                    slots[slotIndex].sequence.store(slotIndex, std::memory_order_relaxed);
+                    slots[slotIndex].moduleInstance = nullptr;
+                }
+            }
+
+            bool tryPush(ModuleInstance *moduleInstance);
+
+            ModuleInstance *tryPop();
+
+            void requestRefills();
+
+            void refillThreadEntry(Uptr threadIndex);
+        };
+    }
+}
+
+bool InstancePool::tryPush(ModuleInstance *moduleInstance) {
+    Uptr index = pushIndex.load(std::memory_order_relaxed);
+    while (true) {
+        Slot &slot = slots[index & slotIndexMask];
+        const Iptr difference = Iptr(slot.sequence.load(std::memory_order_acquire) - index);
+        if (difference == 0) {
+            if (pushIndex.compare_exchange_weak(index, index + 1, std::memory_order_relaxed)) {
+                slot.moduleInstance = moduleInstance;
+                slot.sequence.store(index + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (difference < 0) {
+            // The slot is still occupied by an instance pushed numSlots pushes ago: the queue is full.
+            return false;
+        } else {
+            index = pushIndex.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+ModuleInstance *InstancePool::tryPop() {
+    Uptr index = popIndex.load(std::memory_order_relaxed);
+    while (true) {
+        Slot &slot = slots[index & slotIndexMask];
+        const Iptr difference = Iptr(slot.sequence.load(std::memory_order_acquire) - (index + 1));
+        if (difference == 0) {
+            if (popIndex.compare_exchange_weak(index, index + 1, std::memory_order_relaxed)) {
+                ModuleInstance *moduleInstance = slot.moduleInstance;
+                slot.sequence.store(index + slotIndexMask + 1, std::memory_order_release);
+                return moduleInstance;
+            }
+        } else if (difference < 0) {
+            // The slot hasn't been pushed to yet: the queue is empty.
+            return nullptr;
+        } else {
+            index = popIndex.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void InstancePool::requestRefills() {
+    // Request enough instances to bring the pool back up to numInstances.
+    Uptr numNewRequests = 0;
+    Uptr numQueuedOrPending = numQueuedOrPendingInstances.load(std::memory_order_relaxed);
+    while (numQueuedOrPending < numInstances) {
+        if (numQueuedOrPendingInstances.compare_exchange_weak(numQueuedOrPending, numQueuedOrPending + 1, std::memory_order_relaxed)) {
+            ++numNewRequests;
+            ++numQueuedOrPending;
+        }
+    }
+    if (!numNewRequests) {
+        return;
+    }
+
+    numRequestedInstances.fetch_add(numNewRequests, std::memory_order_release);
+
+    // Wake one of the refill threads. A refill thread keeps creating instances until there are no
+    // requests left, so a busy thread also picks up requests that were meant for another.
+    const Uptr threadIndex = nextRefillThreadIndex.fetch_add(1, std::memory_order_relaxed) % refillThreads.size();
+    refillThreadEvents[threadIndex]->signal();
+}
+
+void InstancePool::refillThreadEntry(Uptr threadIndex) {
+    while (!isShuttingDown.load(std::memory_order_acquire)) {
+        // Take a request, or wait for one if there are none.
+        Uptr numRequested = numRequestedInstances.load(std::memory_order_acquire);
+        if (!numRequested) {
+            refillThreadEvents[threadIndex]->wait(UINT64_MAX);
+            continue;
+        }
+        if (!numRequestedInstances.compare_exchange_weak(numRequested, numRequested - 1, std::memory_order_acquire)) {
+            continue;
+        }
+
+        ModuleInstance *moduleInstance = nullptr;
+        try {
+            moduleInstance = factory(compartment);
+        } catch (...) {
+            // Drop the request: the next acquireInstance that finds the pool empty calls the factory
+            // on its own thread, which rethrows the error to the caller, and requests it again.
+        }
+
+        if (!moduleInstance) {
+            numQueuedOrPendingInstances.fetch_sub(1, std::memory_order_relaxed);
+        } else {
+            // The pool holds a root reference to each queued instance, so the garbage collector
+            // doesn't delete it before it is handed out.
+            addGCRoot(asObject(moduleInstance));
+            errorUnless(tryPush(moduleInstance));
+        }
+    }
+}
+
+InstancePool *Runtime::createInstancePool(Compartment *compartment, Uptr numInstances, InstanceFactory &&factory, Uptr numRefillThreads) {
+    errorUnless(numInstances > 0);
+    errorUnless(numRefillThreads > 0);
+
+    InstancePool *pool = new InstancePool(compartment, std::move(factory), numInstances);
+    for (Uptr threadIndex = 0; threadIndex < numRefillThreads; ++threadIndex) {
+        pool->refillThreadEvents.emplace_back(new Platform::Event);
+    }
+    for (Uptr threadIndex = 0; threadIndex < numRefillThreads; ++threadIndex) {
+        pool->refillThreads.emplace_back([pool, threadIndex] { pool->refillThreadEntry(threadIndex); });
+    }
+
+    pool->requestRefills();
+    return pool;
+}
+
+ModuleInstance *Runtime::acquireInstance(InstancePool *pool) {
+    ModuleInstance *moduleInstance = pool->tryPop();
+    if (moduleInstance) {
+        pool->numQueuedOrPendingInstances.fetch_sub(1, std::memory_order_relaxed);
+        pool->requestRefills();
+        return moduleInstance;
+    }
+
+    // If the pool is empty, create the instance on the calling thread instead of waiting for the
+    // refill threads, and make sure the pool is refilled if a refill failed.
+    pool->requestRefills();
+    moduleInstance = pool->factory(pool->compartment);
+    addGCRoot(asObject(moduleInstance));
+    return moduleInstance;
+}
+
+void Runtime::destroyInstancePool(InstancePool *pool) {
+    pool->isShuttingDown.store(true, std::memory_order_release);
+    for (const std::unique_ptr<Platform::Event> &event : pool->refillThreadEvents) {
+        event->signal();
+    }
+    for (std::thread &thread : pool->refillThreads) {
+        thread.join();
+    }
+
+    // Release the pool's references to the instances that weren't handed out, so the garbage
+    // collector can delete them.
+    while (ModuleInstance *moduleInstance = pool->tryPop()) {
+        removeGCRoot(asObject(moduleInstance));
+    }
+
+    delete pool;
+}
@@ -0,0 +1,1312 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "RuntimePrivate.h"
+#include "WAVM/IR/Module.h"
+#include "WAVM/IR/Operators.h"
+#include "WAVM/IR/Types.h"
+#include "WAVM/Inline/Assert.h"
+#include "WAVM/Inline/BasicTypes.h"
+#include "WAVM/Inline/Errors.h"
+#include "WAVM/LLVMJIT/LLVMJIT.h"
+#include "WAVM/Platform/Defines.h"
+#include "WAVM/Platform/Intrinsic.h"
+#include "WAVM/Runtime/Intrinsics.h"
+#include "WAVM/Runtime/Runtime.h"
+#include "WAVM/Runtime/RuntimeData.h"
+
+using namespace WAVM;
+using namespace WAVM::IR;
+using namespace WAVM::Runtime;
+
+// The interpreter runs the function definitions of a module compiled with
+// CompileOptions::enableInterpreter until they are hot enough to compile. Each function is decoded
+// on its first call from the IR operators to a register-based form: each instruction names the
+// frame slots of its operands and result, so the operand stack only exists at decode time.
+// Instructions are dispatched by threaded code where the compiler supports computed gotos.
+
+// A value in an interpreted function's frame. A frame has a slot for each local, followed by a slot
+// for each element of the operand stack. The values of 32-bit types only use the low bytes of their
+// slot.
+union Slot {
+    I32 i32;
+    U32 u32;
+    I64 i64;
+    U64 u64;
+    F32 f32;
+    F64 f64;
+    Object *object;
+};
+
+// The instructions that aren't a single unary or binary operator.
+#define ENUM_INTERPRETER_CONTROL_OPS(visit)                                                        \
+    visit(copy) visit(constant) visit(br) visit(br_loop) visit(br_if) visit(br_if_loop)            \
+            visit(br_unless) visit(br_table) visit(return_) visit(call) visit(call_indirect)       \
+                    visit(unreachable) visit(select) visit(get_global) visit(set_global)           \
+                            visit(memory_size) visit(memory_grow)
+
+// visit(name, operandField, resultField, expression), where the expression computes the result from
+// operand.
+#define ENUM_INTERPRETER_UNARY_OPS(visit)                                                          \
+    visit(i32_eqz, u32, u32, operand == 0)                                                         \
+    visit(i32_clz, u32, u32, Platform::countLeadingZeroes(operand))                                \
+    visit(i32_ctz, u32, u32, operand ? U32(Platform::countTrailingZeroes(U64(operand))) : 32)      \
+    visit(i32_popcnt, u32, u32, U32(__builtin_popcount(operand)))                                  \
+    visit(i64_eqz, u64, u32, operand == 0)                                                         \
+    visit(i64_clz, u64, u64, Platform::countLeadingZeroes(operand))                                \
+    visit(i64_ctz, u64, u64, Platform::countTrailingZeroes(operand))                               \
+    visit(i64_popcnt, u64, u64, U64(__builtin_popcountll(operand)))                                \
+    visit(f32_abs, f32, f32, fabsf(operand))                                                       \
+    visit(f32_neg, f32, f32, -operand)                                                             \
+    visit(f32_ceil, f32, f32, ceilf(operand))                                                      \
+    visit(f32_floor, f32, f32, floorf(operand))                                                    \
+    visit(f32_trunc, f32, f32, truncf(operand))                                                    \
+    visit(f32_nearest, f32, f32, nearbyintf(operand))                                              \
+    visit(f32_sqrt, f32, f32, sqrtf(operand))                                                      \
+    visit(f64_abs, f64, f64, fabs(operand))                                                        \
+    visit(f64_neg, f64, f64, -operand)                                                             \
+    visit(f64_ceil, f64, f64, ceil(operand))                                                       \
+    visit(f64_floor, f64, f64, floor(operand))                                                     \
+    visit(f64_trunc, f64, f64, trunc(operand))                                                     \
+    visit(f64_nearest, f64, f64, nearbyint(operand))                                               \
+    visit(f64_sqrt, f64, f64, sqrt(operand))                                                       \
+    visit(i32_wrap_i64, u64, u32, U32(operand))                                                    \
+    visit(i32_trunc_s_f32, f32, i32, truncateToI32(operand))                                       \
+    visit(i32_trunc_u_f32, f32, u32, truncateToU32(operand))                                       \
+    visit(i32_trunc_s_f64, f64, i32, truncateToI32(operand))                                       \
+    visit(i32_trunc_u_f64, f64, u32, truncateToU32(operand))                                       \
+    visit(i64_extend_s_i32, i32, i64, I64(operand))                                                \
+    visit(i64_extend_u_i32, u32, u64, U64(operand))                                                \
+    visit(i64_trunc_s_f32, f32, i64, truncateToI64(operand))                                       \
+    visit(i64_trunc_u_f32, f32, u64, truncateToU64(operand))                                       \
+    visit(i64_trunc_s_f64, f64, i64, truncateToI64(operand))                                       \
+    visit(i64_trunc_u_f64, f64, u64, truncateToU64(operand))                                       \
+    visit(f32_convert_s_i32, i32, f32, F32(operand))                                               \
+    visit(f32_convert_u_i32, u32, f32, F32(operand))                                               \
+    visit(f32_convert_s_i64, i64, f32, F32(operand))                                               \
+    visit(f32_convert_u_i64, u64, f32, F32(operand))                                               \
+    visit(f32_demote_f64, f64, f32, F32(operand))                                                  \
+    visit(f64_convert_s_i32, i32, f64, F64(operand))                                               \
+    visit(f64_convert_u_i32, u32, f64, F64(operand))                                               \
+    visit(f64_convert_s_i64, i64, f64, F64(operand))                                               \
+    visit(f64_convert_u_i64, u64, f64, F64(operand))                                               \
+    visit(f64_promote_f32, f32, f64, F64(operand))                                                 \
+    visit(i32_extend8_s, u32, i32, I32(I8(operand)))                                               \
+    visit(i32_extend16_s, u32, i32, I32(I16(operand)))                                             \
+    visit(i64_extend8_s, u64, i64, I64(I8(operand)))                                               \
+    visit(i64_extend16_s, u64, i64, I64(I16(operand)))                                             \
+    visit(i64_extend32_s, u64, i64, I64(I32(operand)))                                             \
+    visit(i32_trunc_s_sat_f32, f32, i32, saturateToI32(operand))                                   \
+    visit(i32_trunc_u_sat_f32, f32, u32, saturateToU32(operand))                                   \
+    visit(i32_trunc_s_sat_f64, f64, i32, saturateToI32(operand))                                   \
+    visit(i32_trunc_u_sat_f64, f64, u32, saturateToU32(operand))                                   \
+    visit(i64_trunc_s_sat_f32, f32, i64, saturateToI64(operand))                                   \
+    visit(i64_trunc_u_sat_f32, f32, u64, saturateToU64(operand))                                   \
+    visit(i64_trunc_s_sat_f64, f64, i64, saturateToI64(operand))                                   \
+    visit(i64_trunc_u_sat_f64, f64, u64, saturateToU64(operand))
+
+// visit(name, operandField, resultField, expression), where the expression computes the result from
+// left and right.
+#define ENUM_INTERPRETER_BINARY_OPS(visit)                                                         \
+    visit(i32_eq, u32, u32, left == right)                                                         \
+    visit(i32_ne, u32, u32, left != right)                                                         \
+    visit(i32_lt_s, i32, u32, left < right)                                                        \
+    visit(i32_lt_u, u32, u32, left < right)                                                        \
+    visit(i32_gt_s, i32, u32, left > right)                                                        \
+    visit(i32_gt_u, u32, u32, left > right)                                                        \
+    visit(i32_le_s, i32, u32, left <= right)                                                       \
+    visit(i32_le_u, u32, u32, left <= right)                                                       \
+    visit(i32_ge_s, i32, u32, left >= right)                                                       \
+    visit(i32_ge_u, u32, u32, left >= right)                                                       \
+    visit(i64_eq, u64, u32, left == right)                                                         \
+    visit(i64_ne, u64, u32, left != right)                                                         \
+    visit(i64_lt_s, i64, u32, left < right)                                                        \
+    visit(i64_lt_u, u64, u32, left < right)                                                        \
+    visit(i64_gt_s, i64, u32, left > right)                                                        \
+    visit(i64_gt_u, u64, u32, left > right)                                                        \
+    visit(i64_le_s, i64, u32, left <= right)                                                       \
+    visit(i64_le_u, u64, u32, left <= right)                                                       \
+    visit(i64_ge_s, i64, u32, left >= right)                                                       \
+    visit(i64_ge_u, u64, u32, left >= right)                                                       \
+    visit(f32_eq, f32, u32, left == right)                                                         \
+    visit(f32_ne, f32, u32, left != right)                                                         \
+    visit(f32_lt, f32, u32, left < right)                                                          \
+    visit(f32_gt, f32, u32, left > right)                                                          \
+    visit(f32_le, f32, u32, left <= right)                                                         \
+    visit(f32_ge, f32, u32, left >= right)                                                         \
+    visit(f64_eq, f64, u32, left == right)                                                         \
+    visit(f64_ne, f64, u32, left != right)                                                         \
+    visit(f64_lt, f64, u32, left < right)                                                          \
+    visit(f64_gt, f64, u32, left > right)                                                          \
+    visit(f64_le, f64, u32, left <= right)                                                         \
+    visit(f64_ge, f64, u32, left >= right)                                                         \
+    visit(i32_add, u32, u32, left + right)                                                         \
+    visit(i32_sub, u32, u32, left - right)                                                         \
+    visit(i32_mul, u32, u32, left * right)                                                         \
+    visit(i32_div_s, i32, i32, divideSigned(left, right))                                          \
+    visit(i32_div_u, u32, u32, divideUnsigned(left, right))                                        \
+    visit(i32_rem_s, i32, i32, remainderSigned(left, right))                                       \
+    visit(i32_rem_u, u32, u32, remainderUnsigned(left, right))                                     \
+    visit(i32_and_, u32, u32, left & right)                                                        \
+    visit(i32_or_, u32, u32, left | right)                                                         \
+    visit(i32_xor_, u32, u32, left ^ right)                                                        \
+    visit(i32_shl, u32, u32, left << (right & 31))                                                 \
+    visit(i32_shr_s, i32, i32, left >> (right & 31))                                               \
+    visit(i32_shr_u, u32, u32, left >> (right & 31))                                               \
+    visit(i32_rotl, u32, u32, rotateLeft(left, right))                                             \
+    visit(i32_rotr, u32, u32, rotateLeft(left, 0 - right))                                         \
+    visit(i64_add, u64, u64, left + right)                                                         \
+    visit(i64_sub, u64, u64, left - right)                                                         \
+    visit(i64_mul, u64, u64, left * right)                                                         \
+    visit(i64_div_s, i64, i64, divideSigned(left, right))                                          \
+    visit(i64_div_u, u64, u64, divideUnsigned(left, right))                                        \
+    visit(i64_rem_s, i64, i64, remainderSigned(left, right))                                       \
+    visit(i64_rem_u, u64, u64, remainderUnsigned(left, right))                                     \
+    visit(i64_and_, u64, u64, left & right)                                                        \
+    visit(i64_or_, u64, u64, left | right)                                                         \
+    visit(i64_xor_, u64, u64, left ^ right)                                                        \
+    visit(i64_shl, u64, u64, left << (right & 63))                                                 \
+    visit(i64_shr_s, i64, i64, left >> (right & 63))                                               \
+    visit(i64_shr_u, u64, u64, left >> (right & 63))                                               \
+    visit(i64_rotl, u64, u64, rotateLeft(left, right))                                             \
+    visit(i64_rotr, u64, u64, rotateLeft(left, 0 - right))                                         \
+    visit(f32_add, f32, f32, left + right)                                                         \
+    visit(f32_sub, f32, f32, left - right)                                                         \
+    visit(f32_mul, f32, f32, left * right)                                                         \
+    visit(f32_div, f32, f32, left / right)                                                         \
+    visit(f32_min, f32, f32, floatMin(left, right))                                                \
+    visit(f32_max, f32, f32, floatMax(left, right))                                                \
+    visit(f32_copysign, f32, f32, copysignf(left, right))                                          \
+    visit(f64_add, f64, f64, left + right)                                                         \
+    visit(f64_sub, f64, f64, left - right)                                                         \
+    visit(f64_mul, f64, f64, left * right)                                                         \
+    visit(f64_div, f64, f64, left / right)                                                         \
+    visit(f64_min, f64, f64, floatMin(left, right))                                                \
+    visit(f64_max, f64, f64, floatMax(left, right))                                                \
+    visit(f64_copysign, f64, f64, copysign(left, right))
+
+// visit(name, MemoryValue, resultField): loads a MemoryValue, and converts it to the result type.
+#define ENUM_INTERPRETER_LOAD_OPS(visit)                                                           \
+    visit(i32_load, U32, u32)                                                                      \
+    visit(i64_load, U64, u64)                                                                      \
+    visit(f32_load, F32, f32)                                                                      \
+    visit(f64_load, F64, f64)                                                                      \
+    visit(i32_load8_s, I8, i32)                                                                    \
+    visit(i32_load8_u, U8, u32)                                                                    \
+    visit(i32_load16_s, I16, i32)                                                                  \
+    visit(i32_load16_u, U16, u32)                                                                  \
+    visit(i64_load8_s, I8, i64)                                                                    \
+    visit(i64_load8_u, U8, u64)                                                                    \
+    visit(i64_load16_s, I16, i64)                                                                  \
+    visit(i64_load16_u, U16, u64)                                                                  \
+    visit(i64_load32_s, I32, i64)                                                                  \
+    visit(i64_load32_u, U32, u64)
+
+// visit(name, MemoryValue, operandField): converts the operand to a MemoryValue, and stores it.
+#define ENUM_INTERPRETER_STORE_OPS(visit)                                                          \
+    visit(i32_store, U32, u32)                                                                     \
+    visit(i64_store, U64, u64)                                                                     \
+    visit(f32_store, F32, f32)                                                                     \
+    visit(f64_store, F64, f64)                                                                     \
+    visit(i32_store8, U8, u32)                                                                     \
+    visit(i32_store16, U16, u32)                                                                   \
+    visit(i64_store8, U8, u64)                                                                     \
+    visit(i64_store16, U16, u64)                                                                   \
+    visit(i64_store32, U32, u64)
+
+enum class InterpreterOp : U16 {
+#define VISIT_OP(name, ...) name,
+    ENUM_INTERPRETER_CONTROL_OPS(VISIT_OP)
+    ENUM_INTERPRETER_UNARY_OPS(VISIT_OP)
+    ENUM_INTERPRETER_BINARY_OPS(VISIT_OP)
+    ENUM_INTERPRETER_LOAD_OPS(VISIT_OP)
+    ENUM_INTERPRETER_STORE_OPS(VISIT_OP)
+#undef VISIT_OP
+};
+
+// A decoded instruction. The meaning of the operands depends on the op:
+// - copy: frame[a] = frame[b].
+// - constant: frame[a] = imm.
+// - br, br_loop: copies d slots from frame + b to frame + c, and jumps to instruction a.
+// - br_if, br_if_loop, br_unless: branches like br if frame[imm] is non-zero, or zero for
+//   br_unless.
+// - br_table: copies d slots from frame + c to the target's slots, and jumps to the target, which is
+//   branchTableEntries[a + min(frame[b], imm)].
+// - return_: copies d slots from frame + b to the start of the frame, and returns.
+// - call: calls function a with the arguments that start at frame + b, and writes its results there.
+// - call_indirect: calls table d's element frame[c], which must have the module's type a, like call.
+// - select: frame[a] = frame[imm] ? frame[b] : frame[c].
+// - get_global: frame[a] = global b. set_global: global b = frame[c].
+// - memory_size: frame[a] = the size of memory b. memory_grow: grows memory c by frame[b] pages, and
+//   writes the previous size to frame[a].
+// - unary and binary operators: frame[a] = op(frame[b], frame[c]).
+// - loads: frame[a] = memory[frame[b] + imm]. stores: memory[frame[b] + imm] = frame[c].
+struct Instruction {
+    InterpreterOp op;
+    U32 a;
+    U32 b;
+    U32 c;
+    U32 d;
+    U64 imm;
+};
+
+struct BranchTableEntry {
+    U32 targetInstructionIndex;
+    U32 firstTargetSlot;
+};
+
+// A function definition decoded for the interpreter.
+struct InterpretedFunction {
+    // Whether the function can be interpreted: if false, it is compiled on its first call instead.
+    bool isSupported = true;
+
+    FunctionType type;
+    Uptr numLocals = 0;
+    Uptr numFrameSlots = 0;
+    std::vector<Instruction> instructions;
+    std::vector<BranchTableEntry> branchTableEntries;
+};
+
+namespace WAVM {
+    namespace Runtime {
+        // The functions of a module decoded for the interpreter. Each function is decoded by its
+        // first call, and the first thread to decode it installs its code for all instances of the
+        // module.
+        struct InterpreterModule {
+            const IR::Module &irModule;
+            std::unique_ptr<std::atomic<const InterpretedFunction *>[]> functionDefs;
+
+            InterpreterModule(const IR::Module &inIRModule)
+                    : irModule(inIRModule), functionDefs(new std::atomic<const InterpretedFunction *>[inIRModule.functions.defs.size()]) {
+                for (Uptr functionDefIndex = 0; functionDefIndex < irModule.functions.defs.size(); ++functionDefIndex) {
+                    functionDefs[functionDefIndex].store(nullptr, std::memory_order_relaxed);
+                }
+            }
+
+            ~InterpreterModule() {
+                for (Uptr functionDefIndex = 0; functionDefIndex < irModule.functions.defs.size(); ++functionDefIndex) {
+                    delete functionDefs[functionDefIndex].load(std::memory_order_relaxed);
+                }
+            }
+        };
+    }
+}
+
+std::shared_ptr<InterpreterModule> Runtime::createInterpreterModule(const IR::Module &irModule) {
+    return std::make_shared<InterpreterModule>(irModule);
+}
+
+static bool canPassFunctionTypeToInterpreter(FunctionType type) {
+    return canPassValuesToInterpreter(type.params()) && canPassValuesToInterpreter(type.results());
+}
+
+// Maps every operator to a method that marks the function as unsupported. The decoder overrides
+// the methods of the operators it supports.
+struct UnsupportedOperatorDecoder {
+    typedef void Result;
+
+    bool isSupported = true;
+
+#define VISIT_OPCODE(_, name, nameString, Imm, ...)                                                \
+    void name(Imm imm) {                                                                           \
+        isSupported = false;                                                                       \
+    }
+    ENUM_OPERATORS(VISIT_OPCODE)
+#undef VISIT_OPCODE
+
+    void unknown(Opcode opcode) {
+        Errors::unreachable();
+    }
+};
+
+// Decodes a function definition from the IR operators to the interpreter's instructions.
+struct InterpretedFunctionDecoder : UnsupportedOperatorDecoder {
+    struct ControlContext {
+        enum class Type : U8 {
+            function, block, loop, ifThen, ifElse
+        };
+
+        Type type;
+
+        // The operand stack height below the block's parameters.
+        Uptr baseHeight;
+        TypeTuple params;
+        TypeTuple results;
+
+        // The index of the first instruction of a loop.
+        Uptr loopInstructionIndex;
+
+        // The index of the br_unless instruction of an if without an else, which branches to the end.
+        Uptr ifBranchInstructionIndex;
+
+        // The instructions and branch table entries that branch to the end of the block, which are
+        // patched with the end's instruction index once it is decoded.
+        std::vector<Uptr> endBranchInstructionIndices;
+        std::vector<Uptr> endBranchTableEntryIndices;
+    };
+
+    const IR::Module &irModule;
+    const FunctionDef &functionDef;
+    InterpretedFunction &function;
+
+    std::vector<ControlContext> controlStack;
+
+    // The slot holding each operand on the stack. An operand is usually in its own slot, at
+    // numLocals plus its height, but get_local pushes the local's slot instead of copying it, until
+    // the local is set or the stack is flushed at a block boundary.
+    std::vector<U32> operandSlots;
+    Uptr maxHeight = 0;
+
+    // Whether the next operator is reachable, and the number of blocks that have been entered in
+    // unreachable code.
+    bool isReachable = true;
+    Uptr numUnreachableBlocks = 0;
+
+    // The index of the last instruction if it wrote the top operand to its own slot, so a set_local
+    // of the operand can write the instruction's result to the local instead.
+    Uptr lastResultInstructionIndex = UINTPTR_MAX;
+
+    InterpretedFunctionDecoder(const IR::Module &inIRModule, const FunctionDef &inFunctionDef, InterpretedFunction &inFunction)
+            : irModule(inIRModule), functionDef(inFunctionDef), function(inFunction) {
+    }
+
+    U32 getStackSlot(Uptr height) const {
+        return U32(function.numLocals + height);
+    }
+
+    U32 pop() {
+        wavmAssert(operandSlots.size());
+        const U32 slot = operandSlots.back();
+        operandSlots.pop_back();
+        return slot;
+    }
+
+    void push(U32 slot) {
+        operandSlots.push_back(slot);
+        if (operandSlots.size() > maxHeight) {
+            maxHeight = operandSlots.size();
+        }
+    }
+
+    U32 pushResult() {
+        const U32 slot = getStackSlot(operandSlots.size());
+        push(slot);
+        return slot;
+    }
+
+    Uptr emit(InterpreterOp op, U32 a = 0, U32 b = 0, U32 c = 0, U32 d = 0, U64 imm = 0) {
+        lastResultInstructionIndex = UINTPTR_MAX;
+        function.instructions.push_back({op, a, b, c, d, imm});
+        return function.instructions.size() - 1;
+    }
+
+    void emitResult(InterpreterOp op, U32 a, U32 b = 0, U32 c = 0, U32 d = 0, U64 imm = 0) {
+        lastResultInstructionIndex = emit(op, a, b, c, d, imm);
+    }
+
+    // Copies the operands that are in a local's slot to their own slots.
+    void flushLocal(U32 localIndex) {
+        for (Uptr height = 0; height < operandSlots.size(); ++height) {
+            if (operandSlots[height] == localIndex) {
+                emit(InterpreterOp::copy, getStackSlot(height), localIndex);
+                operandSlots[height] = getStackSlot(height);
+            }
+        }
+    }
+
+    // Copies all operands to their own slots. This is done before each block boundary and branch, so
+    // all paths that reach a label have their operands in the same slots.
+    void flush() {
+        for (Uptr height = 0; height < operandSlots.size(); ++height) {
+            if (operandSlots[height] != getStackSlot(height)) {
+                emit(InterpreterOp::copy, getStackSlot(height), operandSlots[height]);
+                operandSlots[height] = getStackSlot(height);
+            }
+        }
+        lastResultInstructionIndex = UINTPTR_MAX;
+    }
+
+    void resetOperands(Uptr height) {
+        operandSlots.resize(height);
+        for (Uptr operandIndex = 0; operandIndex < height; ++operandIndex) {
+            operandSlots[operandIndex] = getStackSlot(operandIndex);
+        }
+        lastResultInstructionIndex = UINTPTR_MAX;
+    }
+
+    void enterUnreachable() {
+        isReachable = false;
+        numUnreachableBlocks = 0;
+    }
+
+    void pushControlContext(ControlContext::Type type, FunctionType blockType) {
+        ControlContext context;
+        context.type = type;
+        context.baseHeight = operandSlots.size() - blockType.params().size();
+        context.params = blockType.params();
+        context.results = blockType.results();
+        context.loopInstructionIndex = function.instructions.size();
+        context.ifBranchInstructionIndex = UINTPTR_MAX;
+        controlStack.push_back(std::move(context));
+    }
+
+    // Emits a branch to the label at a depth. The operands must have been flushed.
+    void emitBranch(InterpreterOp op, InterpreterOp loopOp, Uptr depth, U32 conditionSlot = 0) {
+        ControlContext &target = controlStack[controlStack.size() - 1 - depth];
+        const Uptr arity = target.type == ControlContext::Type::loop ? target.params.size() : target.results.size();
+        const U32 sourceSlot = getStackSlot(operandSlots.size() - arity);
+        const U32 targetSlot = getStackSlot(target.baseHeight);
+        if (target.type == ControlContext::Type::loop) {
+            emit(loopOp, U32(target.loopInstructionIndex), sourceSlot, targetSlot, U32(arity), conditionSlot);
+        } else {
+            target.endBranchInstructionIndices.push_back(emit(op, 0, sourceSlot, targetSlot, U32(arity), conditionSlot));
+        }
+    }
+
+    void checkFunctionType(FunctionType type) {
+        if (!canPassFunctionTypeToInterpreter(type)) {
+            isSupported = false;
+        }
+    }
+
+    void decode() {
+        const FunctionType functionType = irModule.types[functionDef.type.index];
+        function.type = functionType;
+        function.numLocals = functionType.params().size() + functionDef.nonParameterLocalTypes.size();
+        checkFunctionType(functionType);
+        for (ValueType localType : functionDef.nonParameterLocalTypes) {
+            if (localType == ValueType::v128) {
+                isSupported = false;
+            }
+        }
+
+        pushControlContext(ControlContext::Type::function, FunctionType(functionType.results()));
+
+        OperatorDecoderStream decoder(functionDef.code.data(), functionDef.code.size());
+        UnreachableOperatorVisitor unreachableVisitor(*this);
+        while (decoder && isSupported && controlStack.size()) {
+            if (isReachable) {
+                decoder.decodeOp(*this);
+            } else {
+                decoder.decodeOp(unreachableVisitor);
+            }
+        }
+
+        function.isSupported = isSupported;
+        function.numFrameSlots = function.numLocals + maxHeight;
+    }
+
+    // Skips the operators in unreachable code, but tracks the blocks they enter, to find the else or
+    // end that makes code reachable again.
+    struct UnreachableOperatorVisitor {
+        typedef void Result;
+
+        InterpretedFunctionDecoder &decoder;
+
+        UnreachableOperatorVisitor(InterpretedFunctionDecoder &inDecoder) : decoder(inDecoder) {
+        }
+
+#define VISIT_OPCODE(_, name, nameString, Imm, ...)                                                \
+    void name(Imm imm) {                                                                           \
+    }
+        ENUM_NONCONTROL_OPERATORS(VISIT_OPCODE)
+#undef VISIT_OPCODE
+
+        void block(ControlStructureImm) {
+            ++decoder.numUnreachableBlocks;
+        }
+        void loop(ControlStructureImm) {
+            ++decoder.numUnreachableBlocks;
+        }
+        void if_(ControlStructureImm) {
+            ++decoder.numUnreachableBlocks;
+        }
+        void try_(ControlStructureImm) {
+            ++decoder.numUnreachableBlocks;
+        }
+        void else_(NoImm imm) {
+            if (!decoder.numUnreachableBlocks) {
+                decoder.else_(imm);
+            }
+        }
+        void catch_(ExceptionTypeImm imm) {
+            if (!decoder.numUnreachableBlocks) {
+                decoder.catch_(imm);
+            }
+        }
+        void catch_all(NoImm imm) {
+            if (!decoder.numUnreachableBlocks) {
+                decoder.catch_all(imm);
+            }
+        }
+        void end(NoImm imm) {
+            if (decoder.numUnreachableBlocks) {
+                --decoder.numUnreachableBlocks;
+            } else {
+                decoder.end(imm);
+            }
+        }
+
+        void unknown(Opcode opcode) {
+            Errors::unreachable();
+        }
+    };
+
+    // Control operators.
+
+    void block(ControlStructureImm imm) {
+        flush();
+        pushControlContext(ControlContext::Type::block, resolveBlockType(irModule, imm.type));
+    }
+
+    void loop(ControlStructureImm imm) {
+        flush();
+        pushControlContext(ControlContext::Type::loop, resolveBlockType(irModule, imm.type));
+    }
+
+    void if_(ControlStructureImm imm) {
+        // The then branch may overwrite the slots of the if's parameters before the else reads them.
+        const FunctionType blockType = resolveBlockType(irModule, imm.type);
+        if (blockType.params().size()) {
+            isSupported = false;
+            return;
+        }
+
+        const U32 conditionSlot = pop();
+        flush();
+        pushControlContext(ControlContext::Type::ifThen, blockType);
+        controlStack.back().ifBranchInstructionIndex = emit(InterpreterOp::br_unless, 0, 0, 0, 0, conditionSlot);
+    }
+
+    void else_(NoImm) {
+        ControlContext &context = controlStack.back();
+        wavmAssert(context.type == ControlContext::Type::ifThen);
+        if (isReachable) {
+            flush();
+            context.endBranchInstructionIndices.push_back(emit(InterpreterOp::br));
+        }
+
+        // The br_unless of the if branches to the else.
+        function.instructions[context.ifBranchInstructionIndex].a = U32(function.instructions.size());
+        context.ifBranchInstructionIndex = UINTPTR_MAX;
+        context.type = ControlContext::Type::ifElse;
+        resetOperands(context.baseHeight + context.params.size());
+        isReachable = true;
+    }
+
+    void end(NoImm) {
+        ControlContext &context = controlStack.back();
+        if (isReachable) {
+            flush();
+        }
+
+        const U32 endInstructionIndex = U32(function.instructions.size());
+        for (Uptr instructionIndex : context.endBranchInstructionIndices) {
+            function.instructions[instructionIndex].a = endInstructionIndex;
+        }
+        for (Uptr entryIndex : context.endBranchTableEntryIndices) {
+            function.branchTableEntries[entryIndex].targetInstructionIndex = endInstructionIndex;
+        }
+        if (context.ifBranchInstructionIndex != UINTPTR_MAX) {
+            function.instructions[context.ifBranchInstructionIndex].a = endInstructionIndex;
+        }
+
+        const Uptr resultHeight = context.baseHeight + context.results.size();
+        if (context.type == ControlContext::Type::function) {
+            emit(InterpreterOp::return_, 0, getStackSlot(0), 0, U32(context.results.size()));
+        }
+        controlStack.pop_back();
+        resetOperands(resultHeight);
+        isReachable = true;
+    }
+
+    void unreachable(NoImm) {
+        emit(InterpreterOp::unreachable);
+        enterUnreachable();
+    }
+
+    void br(BranchImm imm) {
+        flush();
+        emitBranch(InterpreterOp::br, InterpreterOp::br_loop, imm.targetDepth);
+        enterUnreachable();
+    }
+
+    void br_if(BranchImm imm) {
+        const U32 conditionSlot = pop();
+        flush();
+        emitBranch(InterpreterOp::br_if, InterpreterOp::br_if_loop, imm.targetDepth, conditionSlot);
+    }
+
+    void br_table(BranchTableImm imm) {
+        const U32 indexSlot = pop();
+        flush();
+
+        const ControlContext &defaultTarget = controlStack[controlStack.size() - 1 - imm.defaultTargetDepth];
+        const Uptr arity = defaultTarget.type == ControlContext::Type::loop ? defaultTarget.params.size() : defaultTarget.results.size();
+
+        // The default target is the entry after the table's targets. Branches to loops through a
+        // table aren't counted as back-edges.
+        const std::vector<Uptr> &targetDepths = functionDef.branchTables[imm.branchTableIndex];
+        const Uptr firstEntryIndex = function.branchTableEntries.size();
+        for (Uptr entryIndex = 0; entryIndex <= targetDepths.size(); ++entryIndex) {
+            const Uptr depth = entryIndex < targetDepths.size() ? targetDepths[entryIndex] : imm.defaultTargetDepth;
+            ControlContext &target = controlStack[controlStack.size() - 1 - depth];
+            if (target.type == ControlContext::Type::loop) {
+                function.branchTableEntries.push_back({U32(target.loopInstructionIndex), getStackSlot(target.baseHeight)});
+            } else {
+                target.endBranchTableEntryIndices.push_back(function.branchTableEntries.size());
+                function.branchTableEntries.push_back({0, getStackSlot(target.baseHeight)});
+            }
+        }
+
+        emit(InterpreterOp::br_table, U32(firstEntryIndex), indexSlot, getStackSlot(operandSlots.size() - arity), U32(arity), targetDepths.size());
+        enterUnreachable();
+    }
+
+    void return_(NoImm) {
+        flush();
+        const Uptr numResults = function.type.results().size();
+        emit(InterpreterOp::return_, 0, getStackSlot(operandSlots.size() - numResults), 0, U32(numResults));
+        enterUnreachable();
+    }
+
+    void emitCall(InterpreterOp op, FunctionType calleeType, U32 a, U32 c = 0, U32 d = 0) {
+        checkFunctionType(calleeType);
+        flush();
+        const Uptr firstArgHeight = operandSlots.size() - calleeType.params().size();
+        emit(op, a, getStackSlot(firstArgHeight), c, d);
+        resetOperands(firstArgHeight);
+        for (Uptr resultIndex = 0; resultIndex < calleeType.results().size(); ++resultIndex) {
+            pushResult();
+        }
+    }
+
+    void call(FunctionImm imm) {
+        emitCall(InterpreterOp::call, irModule.types[irModule.functions.getType(imm.functionIndex).index], U32(imm.functionIndex));
+    }
+
+    void call_indirect(CallIndirectImm imm) {
+        const U32 elementIndexSlot = pop();
+        emitCall(InterpreterOp::call_indirect, irModule.types[imm.type.index], U32(imm.type.index), elementIndexSlot, U32(imm.tableIndex));
+    }
+
+    // Parametric operators.
+
+    void nop(NoImm) {
+    }
+
+    void drop(NoImm) {
+        pop();
+        lastResultInstructionIndex = UINTPTR_MAX;
+    }
+
+    void select(NoImm) {
+        const U32 conditionSlot = pop();
+        const U32 falseSlot = pop();
+        const U32 trueSlot = pop();
+        emitResult(InterpreterOp::select, pushResult(), trueSlot, falseSlot, 0, conditionSlot);
+    }
+
+    void get_local(GetOrSetVariableImm<false> imm) {
+        push(U32(imm.variableIndex));
+        lastResultInstructionIndex = UINTPTR_MAX;
+    }
+
+    void set_local(GetOrSetVariableImm<false> imm) {
+        const U32 localIndex = U32(imm.variableIndex);
+
+        // If the value was just computed into its own slot, write it to the local instead, unless
+        // another operand still refers to the local's current value.
+        if (lastResultInstructionIndex != UINTPTR_MAX) {
+            bool isLocalOnStack = false;
+            for (Uptr height = 0; height + 1 < operandSlots.size(); ++height) {
+                isLocalOnStack = isLocalOnStack || operandSlots[height] == localIndex;
+            }
+            if (!isLocalOnStack) {
+                function.instructions[lastResultInstructionIndex].a = localIndex;
+                pop();
+                lastResultInstructionIndex = UINTPTR_MAX;
+                return;
+            }
+        }
+
+        const U32 valueSlot = pop();
+        flushLocal(localIndex);
+        if (valueSlot != localIndex) {
+            emit(InterpreterOp::copy, localIndex, valueSlot);
+        }
+    }
+
+    void tee_local(GetOrSetVariableImm<false> imm) {
+        set_local(imm);
+        get_local(imm);
+    }
+
+    void get_global(GetOrSetVariableImm<true> imm) {
+        if (irModule.globals.getType(imm.variableIndex).valueType == ValueType::v128) {
+            isSupported = false;
+            return;
+        }
+        emitResult(InterpreterOp::get_global, pushResult(), U32(imm.variableIndex));
+    }
+
+    void set_global(GetOrSetVariableImm<true> imm) {
+        if (irModule.globals.getType(imm.variableIndex).valueType == ValueType::v128) {
+            isSupported = false;
+            return;
+        }
+        emit(InterpreterOp::set_global, 0, U32(imm.variableIndex), pop());
+    }
+
+    // Non-parametric operators.
+
+    void memory_size(MemoryImm imm) {
+        emitResult(InterpreterOp::memory_size, pushResult(), U32(imm.memoryIndex));
+    }
+
+    void memory_grow(MemoryImm imm) {
+        const U32 deltaSlot = pop();
+        emitResult(InterpreterOp::memory_grow, pushResult(), deltaSlot, U32(imm.memoryIndex));
+    }
+
+    template<typename Value> void emitConstant(Value value) {
+        U64 bits = 0;
+        memcpy(&bits, &value, sizeof(Value));
+        emitResult(InterpreterOp::constant, pushResult(), 0, 0, 0, bits);
+    }
+
+    void i32_const(LiteralImm<I32> imm) {
+        emitConstant(imm.value);
+    }
+    void i64_const(LiteralImm<I64> imm) {
+        emitConstant(imm.value);
+    }
+    void f32_const(LiteralImm<F32> imm) {
+        emitConstant(imm.value);
+    }
+    void f64_const(LiteralImm<F64> imm) {
+        emitConstant(imm.value);
+    }
+
+    // Reinterpreting a value doesn't change the bits in its slot.
+    void i32_reinterpret_f32(NoImm) {
+    }
+    void i64_reinterpret_f64(NoImm) {
+    }
+    void f32_reinterpret_i32(NoImm) {
+    }
+    void f64_reinterpret_i64(NoImm) {
+    }
+
+#define VISIT_UNARY_OP(name, ...)                                                                  \
+    void name(NoImm) {                                                                             \
+        const U32 operandSlot = pop();                                                             \
+        emitResult(InterpreterOp::name, pushResult(), operandSlot);                                \
+    }
+    ENUM_INTERPRETER_UNARY_OPS(VISIT_UNARY_OP)
+#undef VISIT_UNARY_OP
+
+#define VISIT_BINARY_OP(name, ...)                                                                 \
+    void name(NoImm) {                                                                             \
+        const U32 rightSlot = pop();                                                               \
+        const U32 leftSlot = pop();                                                                \
+        emitResult(InterpreterOp::name, pushResult(), leftSlot, rightSlot);                        \
+    }
+    ENUM_INTERPRETER_BINARY_OPS(VISIT_BINARY_OP)
+#undef VISIT_BINARY_OP
+
+#define VISIT_LOAD_OP(name, MemoryValue, ...)                                                      \
+    template<Uptr naturalAlignmentLog2> void name(LoadOrStoreImm<naturalAlignmentLog2> imm) {      \
+        const U32 addressSlot = pop();                                                             \
+        emitResult(InterpreterOp::name, pushResult(), addressSlot, 0, 0, imm.offset);              \
+    }
+    ENUM_INTERPRETER_LOAD_OPS(VISIT_LOAD_OP)
+#undef VISIT_LOAD_OP
+
+#define VISIT_STORE_OP(name, MemoryValue, ...)                                                     \
+    template<Uptr naturalAlignmentLog2> void name(LoadOrStoreImm<naturalAlignmentLog2> imm) {      \
+        const U32 valueSlot = pop();                                                               \
+        const U32 addressSlot = pop();                                                             \
+        emit(InterpreterOp::name, 0, addressSlot, valueSlot, 0, imm.offset);                       \
+    }
+    ENUM_INTERPRETER_STORE_OPS(VISIT_STORE_OP)
+#undef VISIT_STORE_OP
+};
+
+static const InterpretedFunction &getDecodedFunction(const Runtime::Module &module, Uptr functionDefIndex) {
+    InterpreterModule &interpreterModule = *module.interpreterModule;
+    wavmAssert(functionDefIndex < module.ir.functions.defs.size());
+    std::atomic<const InterpretedFunction *> &functionDef = interpreterModule.functionDefs[functionDefIndex];
+    const InterpretedFunction *function = functionDef.load(std::memory_order_acquire);
+    if (!function) {
+        // Threads that call the function for the first time concurrently may each decode it, but
+        // only the first to finish installs its code.
+        InterpretedFunction *decodedFunction = new InterpretedFunction;
+        InterpretedFunctionDecoder decoder(module.ir, module.ir.functions.defs[functionDefIndex], *decodedFunction);
+        decoder.decode();
+
+        function = nullptr;
+        if (functionDef.compare_exchange_strong(function, decodedFunction, std::memory_order_acq_rel)) {
+            function = decodedFunction;
+        } else {
+            delete decodedFunction;
+        }
+    }
+    return *function;
+}
+
+static thread_local Function *interpretedFunction = nullptr;
+
+Function *Runtime::getInterpretedFunction() {
+    return interpretedFunction;
+}
+
+void Runtime::setInterpretedFunction(Function *function) {
+    interpretedFunction = function;
+}
+
+// Sets the function the thread is interpreting until the scope is exited.
+struct InterpretedFunctionScope {
+    InterpretedFunctionScope(Function *function) : outerFunction(interpretedFunction) {
+        interpretedFunction = function;
+    }
+
+    ~InterpretedFunctionScope() {
+        interpretedFunction = outerFunction;
+    }
+
+private:
+    Function *outerFunction;
+};
+
+// Raises an integer divide-by-zero trap, which catchTraps attributes to the interpreted function
+// like the same trap raised by compiled code.
+[[noreturn]] static FORCENOINLINE void raiseIntegerDivideByZeroTrap() {
+    raiseTrap(Trap::Type::integerDivideByZeroOrOverflow);
+}
+
+template<typename Int> static Int divideSigned(Int left, Int right) {
+    if (right == 0 || (right == -1 && left == std::numeric_limits<Int>::min())) {
+        raiseIntegerDivideByZeroTrap();
+    }
+    return left / right;
+}
+
+template<typename Int> static Int remainderSigned(Int left, Int right) {
+    if (right == 0) {
+        raiseIntegerDivideByZeroTrap();
+    }
+    return right == -1 ? 0 : left % right;
+}
+
+template<typename Int> static Int divideUnsigned(Int left, Int right) {
+    if (right == 0) {
+        raiseIntegerDivideByZeroTrap();
+    }
+    return left / right;
+}
+
+template<typename Int> static Int remainderUnsigned(Int left, Int right) {
+    if (right == 0) {
+        raiseIntegerDivideByZeroTrap();
+    }
+    return left % right;
+}
+
+template<typename Int> static Int rotateLeft(Int value, Int count) {
+    const Int numBits = Int(sizeof(Int) * 8);
+    count &= numBits - 1;
+    return count ? Int((value << count) | (value >> (numBits - count))) : value;
+}
+
+// Returns the lesser or greater of two floats, with the WebAssembly semantics for NaNs and zeroes.
+template<typename Float> static Float floatMin(Float left, Float right) {
+    if (left != left || right != right) {
+        return left + right;
+    } else if (left == right) {
+        return signbit(left) ? left : right;
+    }
+    return left < right ? left : right;
+}
+
+template<typename Float> static Float floatMax(Float left, Float right) {
+    if (left != left || right != right) {
+        return left + right;
+    } else if (left == right) {
+        return signbit(left) ? right : left;
+    }
+    return left > right ? left : right;
+}
+
+// Truncates a float to an integer. The bounds are the nearest doubles outside the integer's range,
+// which both f32 and f64 operands can be compared to exactly.
+template<typename Int> static Int truncateFloat(F64 value, F64 minExclusive, F64 maxExclusive) {
+    if (!(value > minExclusive && value < maxExclusive)) {
+        raiseTrap(Trap::Type::invalidFloatOperation);
+    }
+    return Int(value);
+}
+
+template<typename Int> static Int truncateFloatSaturated(F64 value, F64 minExclusive, F64 maxExclusive) {
+    if (value != value) {
+        return 0;
+    } else if (value <= minExclusive) {
+        return std::numeric_limits<Int>::min();
+    } else if (value >= maxExclusive) {
+        return std::numeric_limits<Int>::max();
+    }
+    return Int(value);
+}
+
+static I32 truncateToI32(F64 value) {
+    return truncateFloat<I32>(value, -2147483649.0, 2147483648.0);
+}
+static U32 truncateToU32(F64 value) {
+    return truncateFloat<U32>(value, -1.0, 4294967296.0);
+}
+static I64 truncateToI64(F64 value) {
+    return truncateFloat<I64>(value, -9223372036854777856.0, 9223372036854775808.0);
+}
+static U64 truncateToU64(F64 value) {
+    return truncateFloat<U64>(value, -1.0, 18446744073709551616.0);
+}
+static I32 saturateToI32(F64 value) {
+    return truncateFloatSaturated<I32>(value, -2147483649.0, 2147483648.0);
+}
+static U32 saturateToU32(F64 value) {
+    return truncateFloatSaturated<U32>(value, -1.0, 4294967296.0);
+}
+static I64 saturateToI64(F64 value) {
+    return truncateFloatSaturated<I64>(value, -9223372036854777856.0, 9223372036854775808.0);
+}
+static U64 saturateToU64(F64 value) {
+    return truncateFloatSaturated<U64>(value, -1.0, 18446744073709551616.0);
+}
+
+// Clamps an address to the memory's reserved bytes, like code compiled with explicit memory bounds
+// checks, so an out-of-bounds access faults on the guard pages after the reservation.
+static FORCEINLINE U8 *getMemoryAddress(U8 *memoryBase, Uptr memoryNumReservedBytes, U32 address, U64 offset) {
+    return memoryBase + Platform::saturateToBounds(U64(address) + offset, memoryNumReservedBytes);
+}
+
+static FORCEINLINE void copySlots(Slot *destination, const Slot *source, Uptr numSlots) {
+    // A branch copies its operands down the stack, so the slots are copied from the lowest.
+    if (destination != source) {
+        for (Uptr slotIndex = 0; slotIndex < numSlots; ++slotIndex) {
+            destination[slotIndex] = source[slotIndex];
+        }
+    }
+}
+
+// The number of loop iterations an interpreted call counts before adding them to the function's
+// tier-up count, so a long running loop queues the function to be compiled before it returns.
+static constexpr Uptr backEdgeFlushInterval = 1024;
+
+// Adds interpreted calls or loop iterations to a function's tier-up count, and queues the function
+// to be compiled if the count crossed the module's tier-up threshold.
+static void addTierUpCount(ModuleInstance *moduleInstance, Function *function, Uptr functionDefIndex, Uptr count) {
+    const Uptr threshold = moduleInstance->module->compileOptions.tierUpCallThreshold;
+    const Uptr previousCount = function->mutableData->tierUp.numCalls.fetch_add(count, std::memory_order_relaxed);
+    if (previousCount < threshold && previousCount + count >= threshold) {
+        queueTierUp(moduleInstance->tierUpState, functionDefIndex);
+    }
+}
+
+// Calls a function through its invoke thunk. The arguments and results are in the slots that start
+// at argsAndResults.
+static ContextRuntimeData *callThroughInvokeThunk(ContextRuntimeData *contextRuntimeData, Function *function, Slot *argsAndResults) {
+    const FunctionType functionType{function->encodedType};
+    auto invokeThunk = reinterpret_cast<LLVMJIT::InvokeThunkPointer>(function->mutableData->invokeThunk.load(std::memory_order_relaxed));
+    if (!invokeThunk) {
+        invokeThunk = LLVMJIT::getInvokeThunk(functionType);
+        function->mutableData->invokeThunk.store(reinterpret_cast<void *>(invokeThunk), std::memory_order_relaxed);
+    }
+
+    Uptr argDataOffset = 0;
+    for (Uptr argIndex = 0; argIndex < functionType.params().size(); ++argIndex) {
+        const Uptr numArgBytes = getTypeByteWidth(functionType.params()[argIndex]);
+        argDataOffset = (argDataOffset + numArgBytes - 1) & -numArgBytes;
+        memcpy(contextRuntimeData->thunkArgAndReturnData + argDataOffset, &argsAndResults[argIndex], numArgBytes);
+        argDataOffset += numArgBytes;
+    }
+
+    // The called code isn't interpreted, so a signal it raises isn't attributed to the caller.
+    {
+        InterpretedFunctionScope nativeScope(nullptr);
+        contextRuntimeData = (*invokeThunk)(function, contextRuntimeData);
+    }
+
+    Uptr resultOffset = 0;
+    for (Uptr resultIndex = 0; resultIndex < functionType.results().size(); ++resultIndex) {
+        const Uptr numResultBytes = getTypeByteWidth(functionType.results()[resultIndex]);
+        resultOffset = (resultOffset + numResultBytes - 1) & -numResultBytes;
+        memcpy(&argsAndResults[resultIndex], contextRuntimeData->thunkArgAndReturnData + resultOffset, numResultBytes);
+        resultOffset += numResultBytes;
+    }
+    return contextRuntimeData;
+}
+
+// Interprets a call to a function definition. The arguments and results are in the slots that
+// start at argsAndResults.
+static ContextRuntimeData *interpretCall(ContextRuntimeData *contextRuntimeData, ModuleInstance *moduleInstance, Uptr functionDefIndex, const InterpretedFunction &interpretedFunction, Slot *argsAndResults) {
+    const Runtime::Module &module = *moduleInstance->module;
+    const Uptr numFunctionImports = module.ir.functions.imports.size();
+    Function *function = moduleInstance->functions[numFunctionImports + functionDefIndex];
+    InterpretedFunctionScope functionScope(function);
+    addTierUpCount(moduleInstance, function, functionDefIndex, 1);
+
+    const Uptr numParams = interpretedFunction.type.params().size();
+    Slot *frame = (Slot *) alloca(sizeof(Slot) * interpretedFunction.numFrameSlots);
+    memcpy(frame, argsAndResults, sizeof(Slot) * numParams);
+    memset(frame + numParams, 0, sizeof(Slot) * (interpretedFunction.numLocals - numParams));
+
+    U8 *memoryBase = nullptr;
+    Uptr memoryNumReservedBytes = 0;
+    if (moduleInstance->memories.size()) {
+        memoryBase = moduleInstance->memories[0]->baseAddress;
+        memoryNumReservedBytes = moduleInstance->memories[0]->numReservedBytes;
+    }
+
+    const Instruction *const code = interpretedFunction.instructions.data();
+    const BranchTableEntry *const branchTableEntries = interpretedFunction.branchTableEntries.data();
+    const Instruction *ip = code;
+    Uptr numBackEdges = 0;
+
+#if defined(__GNUC__)
+    static const void *const dispatchTable[] = {
+#define VISIT_OP(name, ...) &&op_##name,
+            ENUM_INTERPRETER_CONTROL_OPS(VISIT_OP)
+            ENUM_INTERPRETER_UNARY_OPS(VISIT_OP)
+            ENUM_INTERPRETER_BINARY_OPS(VISIT_OP)
+            ENUM_INTERPRETER_LOAD_OPS(VISIT_OP)
+            ENUM_INTERPRETER_STORE_OPS(VISIT_OP)
+#undef VISIT_OP
+    };
+#define INTERPRETER_OP(name) op_##name:
+#define DISPATCH() goto *dispatchTable[Uptr(ip->op)]
+    DISPATCH();
+#else
+#define INTERPRETER_OP(name) case InterpreterOp::name:
+#define DISPATCH() goto dispatch
+dispatch:
+    switch (ip->op) {
+#endif
+
+    INTERPRETER_OP(copy) {
+        frame[ip->a] = frame[ip->b];
+        ++ip;
+        DISPATCH();
+    }
+    INTERPRETER_OP(constant) {
+        frame[ip->a].u64 = ip->imm;
+        ++ip;
+        DISPATCH();
+    }
+    INTERPRETER_OP(br) {
+        copySlots(frame + ip->c, frame + ip->b, ip->d);
+        ip = code + ip->a;
+        DISPATCH();
+    }
+    INTERPRETER_OP(br_loop) {
+        if (++numBackEdges == backEdgeFlushInterval) {
+            addTierUpCount(moduleInstance, function, functionDefIndex, numBackEdges);
+            numBackEdges = 0;
+        }
+        copySlots(frame + ip->c, frame + ip->b, ip->d);
+        ip = code + ip->a;
+        DISPATCH();
+    }
+    INTERPRETER_OP(br_if) {
+        if (frame[ip->imm].u32) {
+            copySlots(frame + ip->c, frame + ip->b, ip->d);
+            ip = code + ip->a;
+        } else {
+            ++ip;
+        }
+        DISPATCH();
+    }
+    INTERPRETER_OP(br_if_loop) {
+        if (frame[ip->imm].u32) {
+            if (++numBackEdges == backEdgeFlushInterval) {
+                addTierUpCount(moduleInstance, function, functionDefIndex, numBackEdges);
+                numBackEdges = 0;
+            }
+            copySlots(frame + ip->c, frame + ip->b, ip->d);
+            ip = code + ip->a;
+        } else {
+            ++ip;
+        }
+        DISPATCH();
+    }
+    INTERPRETER_OP(br_unless) {
+        ip = frame[ip->imm].u32 ? ip + 1 : code + ip->a;
+        DISPATCH();
+    }
+    INTERPRETER_OP(br_table) {
+        const U64 index = frame[ip->b].u32;
+        const BranchTableEntry &entry = branchTableEntries[ip->a + (index < ip->imm ? index : ip->imm)];
+        copySlots(frame + entry.firstTargetSlot, frame + ip->c, ip->d);
+        ip = code + entry.targetInstructionIndex;
+        DISPATCH();
+    }
+    INTERPRETER_OP(return_) {
+        copySlots(frame, frame + ip->b, ip->d);
+        memcpy(argsAndResults, frame, sizeof(Slot) * ip->d);
+        if (numBackEdges) {
+            addTierUpCount(moduleInstance, function, functionDefIndex, numBackEdges);
+        }
+        return contextRuntimeData;
+    }
+    INTERPRETER_OP(call) {
+        // Interpret calls to the instance's own function definitions that haven't been compiled
+        // without leaving the interpreter.
+        Function *callee = moduleInstance->functions[ip->a];
+        if (ip->a >= numFunctionImports && !callee->mutableData->tierUp.optimizedCode.load(std::memory_order_acquire)) {
+            const Uptr calleeDefIndex = ip->a - numFunctionImports;
+            const InterpretedFunction &calleeFunction = getDecodedFunction(module, calleeDefIndex);
+            if (calleeFunction.isSupported) {
+                contextRuntimeData = interpretCall(contextRuntimeData, moduleInstance, calleeDefIndex, calleeFunction, frame + ip->b);
+                ++ip;
+                DISPATCH();
+            }
+        }
+        contextRuntimeData = callThroughInvokeThunk(contextRuntimeData, callee, frame + ip->b);
+        ++ip;
+        DISPATCH();
+    }
+    INTERPRETER_OP(call_indirect) {
+        Table *table = moduleInstance->tables[ip->d];
+        if (frame[ip->c].u32 >= getTableNumElements(table)) {
+            raiseTrap(Trap::Type::invalidIndirectCall);
+        }
+        Object *element = getTableElement(table, frame[ip->c].u32);
+        if (!element || element->kind != ObjectKind::function || asFunction(element)->encodedType.impl != module.ir.types[ip->a].getEncoding().impl) {
+            raiseTrap(Trap::Type::invalidIndirectCall);
+        }
+        contextRuntimeData = callThroughInvokeThunk(contextRuntimeData, asFunction(element), frame + ip->b);
+        ++ip;
+        DISPATCH();
+    }
+    INTERPRETER_OP(unreachable) {
+        raiseTrap(Trap::Type::unreachable);
+    }
+    INTERPRETER_OP(select) {
+        frame[ip->a] = frame[ip->imm].u32 ? frame[ip->b] : frame[ip->c];
+        ++ip;
+        DISPATCH();
+    }
+    INTERPRETER_OP(get_global) {
+        const Global *global = moduleInstance->globals[ip->b];
+        const UntaggedValue &value = global->type.isMutable ? contextRuntimeData->mutableGlobals[global->mutableGlobalIndex] : global->initialValue;
+        frame[ip->a].u64 = value.u64;
+        ++ip;
+        DISPATCH();
+    }
+    INTERPRETER_OP(set_global) {
+        const Global *global = moduleInstance->globals[ip->b];
+        contextRuntimeData->mutableGlobals[global->mutableGlobalIndex].u64 = frame[ip->c].u64;
+        ++ip;
+        DISPATCH();
+    }
+    INTERPRETER_OP(memory_size) {
+        frame[ip->a].u32 = U32(getMemoryNumPages(moduleInstance->memories[ip->b]));
+        ++ip;
+        DISPATCH();
+    }
+    INTERPRETER_OP(memory_grow) {
+        frame[ip->a].i32 = I32(growMemory(moduleInstance->memories[ip->c], frame[ip->b].u32));
+        ++ip;
+        DISPATCH();
+    }
+
+#define VISIT_UNARY_OP(name, operandField, resultField, ...)                                       \
+    INTERPRETER_OP(name) {                                                                         \
+        const auto operand = frame[ip->b].operandField;                                            \
+        frame[ip->a].resultField = __VA_ARGS__;                                                    \
+        ++ip;                                                                                      \
+        DISPATCH();                                                                                \
+    }
+    ENUM_INTERPRETER_UNARY_OPS(VISIT_UNARY_OP)
+#undef VISIT_UNARY_OP
+
+#define VISIT_BINARY_OP(name, operandField, resultField, ...)                                      \
+    INTERPRETER_OP(name) {                                                                         \
+        const auto left = frame[ip->b].operandField;                                               \
+        const auto right = frame[ip->c].operandField;                                              \
+        frame[ip->a].resultField = __VA_ARGS__;                                                    \
+        ++ip;                                                                                      \
+        DISPATCH();                                                                                \
+    }
+    ENUM_INTERPRETER_BINARY_OPS(VISIT_BINARY_OP)
+#undef VISIT_BINARY_OP
+
+#define VISIT_LOAD_OP(name, MemoryValue, resultField)                                              \
+    INTERPRETER_OP(name) {                                                                         \
+        MemoryValue value;                                                                         \
+        memcpy(&value, getMemoryAddress(memoryBase, memoryNumReservedBytes, frame[ip->b].u32, ip->imm), sizeof(MemoryValue)); \
+        frame[ip->a].resultField = value;                                                          \
+        ++ip;                                                                                      \
+        DISPATCH();                                                                                \
+    }
+    ENUM_INTERPRETER_LOAD_OPS(VISIT_LOAD_OP)
+#undef VISIT_LOAD_OP
+
+#define VISIT_STORE_OP(name, MemoryValue, operandField)                                            \
+    INTERPRETER_OP(name) {                                                                         \
+        const MemoryValue value = MemoryValue(frame[ip->c].operandField);                          \
+        memcpy(getMemoryAddress(memoryBase, memoryNumReservedBytes, frame[ip->b].u32, ip->imm), &value, sizeof(MemoryValue)); \
+        ++ip;                                                                                      \
+        DISPATCH();                                                                                \
+    }
+    ENUM_INTERPRETER_STORE_OPS(VISIT_STORE_OP)
+#undef VISIT_STORE_OP
+
+#if !defined(__GNUC__)
+    default:
+        Errors::unreachable();
+    }
+#endif
+#undef INTERPRETER_OP
+#undef DISPATCH
+}
+
+DEFINE_INTRINSIC_FUNCTION(wavmIntrinsics, "interpretFunction", Uptr, interpretFunction, Uptr moduleInstanceId, Uptr functionDefIndex) {
+    ModuleInstance *moduleInstance = getModuleInstanceFromRuntimeData(contextRuntimeData, moduleInstanceId);
+    wavmAssert(moduleInstance->tierUpState);
+
+    // If the function can't be interpreted, compile it and return its code, which the stub
+    // forwards the call to.
+    const InterpretedFunction &interpretedFunction = getDecodedFunction(*moduleInstance->module, functionDefIndex);
+    if (!interpretedFunction.isSupported) {
+        return reinterpret_cast<Uptr>(compileLazyFunction(*moduleInstance->tierUpState, functionDefIndex));
+    }
+
+    // The stub passes the arguments and reads the results in the context's thunk argument buffer,
+    // laid out the same way as the arguments and results of an invoke thunk.
+    const FunctionType functionType = interpretedFunction.type;
+    const Uptr numArgsAndResults = functionType.params().size() > functionType.results().size() ? functionType.params().size() : functionType.results().size();
+    Slot *argsAndResults = (Slot *) alloca(sizeof(Slot) * (numArgsAndResults ? numArgsAndResults : 1));
+    Uptr argDataOffset = 0;
+    for (Uptr argIndex = 0; argIndex < functionType.params().size(); ++argIndex) {
+        const Uptr numArgBytes = getTypeByteWidth(functionType.params()[argIndex]);
+        argDataOffset = (argDataOffset + numArgBytes - 1) & -numArgBytes;
+        memcpy(&argsAndResults[argIndex], contextRuntimeData->thunkArgAndReturnData + argDataOffset, numArgBytes);
+        argDataOffset += numArgBytes;
+    }
+
+    interpretCall(contextRuntimeData, moduleInstance, functionDefIndex, interpretedFunction, argsAndResults);
+
+    Uptr resultOffset = 0;
+    for (Uptr resultIndex = 0; resultIndex < functionType.results().size(); ++resultIndex) {
+        const Uptr numResultBytes = getTypeByteWidth(functionType.results()[resultIndex]);
+        resultOffset = (resultOffset + numResultBytes - 1) & -numResultBytes;
+        memcpy(contextRuntimeData->thunkArgAndReturnData + resultOffset, &argsAndResults[resultIndex], numResultBytes);
+        resultOffset += numResultBytes;
+    }
+    return 0;
+}
@@ -0,0 +1,34 @@
+#include <atomic>
+
+#include "RuntimePrivate.h"
+#include "WAVM/Runtime/Intrinsics.h"
+#include "WAVM/Runtime/Runtime.h"
+#include "WAVM/Runtime/RuntimeData.h"
+
+using namespace WAVM;
+using namespace WAVM::Runtime;
+
+static std::atomic<InterruptHandler> interruptHandler{nullptr};
+
+void Runtime::setInterruptHandler(InterruptHandler handler) {
+    interruptHandler.store(handler, std::memory_order_release);
+}
+
+void Runtime::requestInterrupt(Context *context) {
+    context->runtimeData->interruptRequested.store(1, std::memory_order_release);
+}
+
+DEFINE_INTRINSIC_FUNCTION(wavmIntrinsics, "interrupt", void, interrupt) {
+    // Clear the request before calling the handler, so a request made while the handler runs
+    // interrupts the code again.
+    if (!contextRuntimeData->interruptRequested.exchange(0, std::memory_order_acquire)) {
+        return;
+    }
+
+    InterruptHandler handler = interruptHandler.load(std::memory_order_acquire);
+    if (!handler) {
+        return;
+    }
+
+    handler(getContextFromRuntimeData(contextRuntimeData));
+}
@@ -12,6 +12,11 @@ namespace WAVM {
             HashMap<std::string, Intrinsics::Table *> tableMap;
             HashMap<std::string, Intrinsics::Memory *> memoryMap;
             HashMap<std::string, Intrinsics::Global *> globalMap;
+
+            // The module's function exports, which are created by the first instantiation of the
+            // module and shared by all later instantiations in any compartment.
+            Platform::Mutex sharedExportsMutex;
+            std::shared_ptr<const Runtime::SharedIntrinsicExports> sharedExports;
         };
     }
 }
@@ -87,18 +92,48 @@ Memory *Intrinsics::Memory::instantiate(Compartment *compartment) {
     return createMemory(compartment, type, name);
 }
 
+static std::shared_ptr<const SharedIntrinsicExports> getSharedExports(Intrinsics::ModuleImpl *moduleImpl) {
+    Lock<Platform::Mutex> sharedExportsLock(moduleImpl->sharedExportsMutex);
+    if (!moduleImpl->sharedExports) {
+        // Generate the thunks for all the module's functions at once, so the thunks that haven't
+        // been generated yet are compiled together.
+        std::vector<LLVMJIT::IntrinsicThunkDesc> thunkDescs;
+        for (const auto &pair : moduleImpl->functionMap) {
+            const Intrinsics::Function *intrinsicFunction = pair.value;
+            thunkDescs.push_back({intrinsicFunction->getNativeFunction(), intrinsicFunction->getType(), intrinsicFunction->getCallingConvention(), intrinsicFunction->getName()});
+        }
+
+        std::shared_ptr<SharedIntrinsicExports> sharedExports = std::make_shared<SharedIntrinsicExports>();
+        sharedExports->functions.resize(thunkDescs.size());
+        LLVMJIT::getIntrinsicThunks(thunkDescs.data(), thunkDescs.size(), sharedExports->functions.data());
+
+        Uptr functionIndex = 0;
+        for (const auto &pair : moduleImpl->functionMap) {
+            sharedExports->exportMap.addOrFail(pair.key, asObject(sharedExports->functions[functionIndex++]));
+        }
+        moduleImpl->sharedExports = std::move(sharedExports);
+    }
+    return moduleImpl->sharedExports;
+}
+
 ModuleInstance *Intrinsics::instantiateModule(Compartment *compartment, const Intrinsics::Module &moduleRef, std::string &&debugName, const HashMap<std::string, Object *> &extraExports) {
     HashMap<std::string, Object *> exportMap = extraExports;
+    std::shared_ptr<const SharedIntrinsicExports> sharedExports;
     std::vector<Runtime::Function *> functions;
     std::vector<Runtime::Table *> tables;
     std::vector<Runtime::Memory *> memories;
     std::vector<Runtime::Global *> globals;
     std::vector<Runtime::ExceptionType *> exceptionTypes;
     if (moduleRef.impl) {
-        for (const auto &pair : moduleRef.impl->functionMap) {
-            auto function = pair.value->instantiate(compartment);
-            functions.push_back(function);
-            exportMap.addOrFail(pair.key, asObject(function));
+        // The function thunks don't depend on the compartment, so only the module's tables,
+        // memories, and globals are created for each instance.
+        sharedExports = getSharedExports(moduleRef.impl);
+        functions = sharedExports->functions;
+
+        for (const auto &pair : extraExports) {
+            if (sharedExports->exportMap.contains(pair.key)) {
+                Errors::fatalf("Intrinsic module extra export duplicates a function: %s", pair.key.c_str());
+            }
         }
 
         for (const auto &pair : moduleRef.impl->tableMap) {
@@ -145,7 +180,8 @@ ModuleInstance *Intrinsics::instantiateModule(Compartment *compartment, const In
 
     Lock<Platform::Mutex> compartmentLock(compartment->mutex);
     const Uptr id = compartment->moduleInstances.add(UINTPTR_MAX, nullptr);
-    auto moduleInstance = new ModuleInstance(compartment, id, std::move(exportMap), std::move(functions), std::move(tables), std::move(memories), std::move(globals), std::move(exceptionTypes), nullptr, {}, {}, nullptr, std::move(debugName));
+    auto moduleInstance = new ModuleInstance(compartment, id, std::move(exportMap), std::move(functions), std::move(tables), std::move(memories), std::move(globals), std::move(exceptionTypes), nullptr, nullptr, {}, {}, nullptr, std::move(debugName));
+    moduleInstance->sharedExports = std::move(sharedExports);
     compartment->moduleInstances[id] = moduleInstance;
     return moduleInstance;
 }
@@ -0,0 +1,144 @@
+#include <string.h>
+#include <thread>
+#include <vector>
+
+#include "RuntimePrivate.h"
+#include "WAVM/IR/Types.h"
+#include "WAVM/IR/Value.h"
+#include "WAVM/Inline/Assert.h"
+#include "WAVM/Inline/BasicTypes.h"
+#include "WAVM/Inline/Errors.h"
+#include "WAVM/Platform/Fiber.h"
+#include "WAVM/Runtime/Runtime.h"
+
+using namespace WAVM;
+using namespace WAVM::IR;
+using namespace WAVM::Runtime;
+
+static thread_local Invocation *currentInvocation = nullptr;
+
+static void invocationEntry(void *invocationVoid) {
+    Invocation *invocation = reinterpret_cast<Invocation *>(invocationVoid);
+
+    const bool trapped = catchTraps(
+            [invocation] {
+                const FunctionType functionType{invocation->function->encodedType};
+                const U8 *resultData = reinterpret_cast<const U8 *>(invokeFunctionUnchecked(invocation->context, invocation->function, invocation->arguments.data()));
+
+                // Copy the results out of the context's thunk argument buffer, where they are
+                // naturally aligned, before another invocation in the context overwrites them.
+                Uptr resultOffset = 0;
+                for (ValueType resultType : functionType.results()) {
+                    const Uptr numResultBytes = getTypeByteWidth(resultType);
+                    resultOffset = (resultOffset + numResultBytes - 1) & -numResultBytes;
+
+                    UntaggedValue result;
+                    memcpy(result.bytes, resultData + resultOffset, numResultBytes);
+                    invocation->results.push_back(result);
+                    resultOffset += numResultBytes;
+                }
+            },
+            [invocation](const Trap &trap) { invocation->trap = trap; });
+
+    invocation->state = trapped ? InvocationState::trapped : InvocationState::returned;
+}
+
+// Runs an invocation's fiber until it returns or is suspended.
+static InvocationState runInvocation(Invocation *invocation) {
+    errorUnless(invocation->state == InvocationState::suspended && !invocation->isRunning);
+    errorUnless(invocation->threadId == std::this_thread::get_id());
+
+    // The invocation and the code that resumes it each keep the function they were interpreting,
+    // since other invocations may run on the thread while it is suspended.
+    Invocation *resumerInvocation = currentInvocation;
+    Function *resumerInterpretedFunction = getInterpretedFunction();
+    currentInvocation = invocation;
+    invocation->isRunning = true;
+    setInterpretedFunction(invocation->interpretedFunction);
+
+    try {
+        Platform::resumeFiber(invocation->fiber);
+    } catch (...) {
+        invocation->state = InvocationState::threw;
+        invocation->isRunning = false;
+        currentInvocation = resumerInvocation;
+        setInterpretedFunction(resumerInterpretedFunction);
+        throw;
+    }
+
+    invocation->interpretedFunction = getInterpretedFunction();
+    invocation->isRunning = false;
+    currentInvocation = resumerInvocation;
+    setInterpretedFunction(resumerInterpretedFunction);
+    return invocation->state;
+}
+
+Invocation *Runtime::createInvocation(Context *context, Function *function, const UntaggedValue *arguments, Uptr numStackBytes) {
+    errorUnless(isInCompartment(asObject(function), context->compartment));
+
+    const FunctionType functionType{function->encodedType};
+
+    Invocation *invocation = new Invocation;
+    invocation->context = context;
+    invocation->function = function;
+    invocation->arguments.assign(arguments, arguments + functionType.params().size());
+    invocation->fiber = acquireGuestStack(numStackBytes, invocationEntry, invocation);
+    invocation->numStackBytes = numStackBytes;
+    invocation->threadId = std::this_thread::get_id();
+    addGCRoot(asObject(context));
+    addGCRoot(asObject(function));
+    return invocation;
+}
+
+Invocation *Runtime::startInvocation(Context *context, Function *function, const UntaggedValue *arguments, Uptr numStackBytes) {
+    Invocation *invocation = createInvocation(context, function, arguments, numStackBytes);
+
+    // If the function throws, the caller never gets the invocation, so destroy it before rethrowing.
+    try {
+        runInvocation(invocation);
+    } catch (...) {
+        destroyInvocation(invocation);
+        throw;
+    }
+    return invocation;
+}
+
+InvocationState Runtime::resumeInvocation(Invocation *invocation) {
+    return runInvocation(invocation);
+}
+
+InvocationState Runtime::getInvocationState(const Invocation *invocation) {
+    return invocation->state;
+}
+
+const std::vector<UntaggedValue> &Runtime::getInvocationResults(const Invocation *invocation) {
+    wavmAssert(invocation->state == InvocationState::returned);
+    return invocation->results;
+}
+
+const Trap &Runtime::getInvocationTrap(const Invocation *invocation) {
+    wavmAssert(invocation->state == InvocationState::trapped);
+    return invocation->trap;
+}
+
+void Runtime::destroyInvocation(Invocation *invocation) {
+    errorUnless(!invocation->isRunning);
+    releaseGuestStack(invocation->fiber, invocation->numStackBytes);
+    removeGCRoot(asObject(invocation->context));
+    removeGCRoot(asObject(invocation->function));
+    delete invocation;
+}
+
+Context *Runtime::getInvocationContext(const Invocation *invocation) {
+    return invocation->context;
+}
+
+Invocation *Runtime::getCurrentInvocation() {
+    return currentInvocation;
+}
+
+void Runtime::suspendInvocation() {
+    Invocation *invocation = currentInvocation;
+    errorUnless(invocation && Platform::getCurrentFiber() == invocation->fiber);
+    Platform::yieldFiber();
+}
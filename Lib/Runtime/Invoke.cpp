@@ -11,8 +11,13 @@ using namespace WAVM::Runtime;
 UntaggedValue *Runtime::invokeFunctionUnchecked(Context *context, Function *function, const UntaggedValue *arguments) {
     FunctionType functionType = function->encodedType;
 
-    // Get the invoke thunk for this function type.
-    auto invokeFunctionPointer = LLVMJIT::getInvokeThunk(functionType);
+    // Get the invoke thunk for this function type, using the thunk cached on the function if there
+    // is one. Racing threads will store the same thunk, so relaxed ordering is sufficient.
+    auto invokeFunctionPointer = reinterpret_cast<LLVMJIT::InvokeThunkPointer>(function->mutableData->invokeThunk.load(std::memory_order_relaxed));
+    if (!invokeFunctionPointer) {
+        invokeFunctionPointer = LLVMJIT::getInvokeThunk(functionType);
+        function->mutableData->invokeThunk.store(reinterpret_cast<void *>(invokeFunctionPointer), std::memory_order_relaxed);
+    }
 
     // Copy the arguments into the thunk arguments buffer in ContextRuntimeData.
     ContextRuntimeData *contextRuntimeData = &context->compartment->runtimeData->contexts[context->id];
@@ -30,14 +35,30 @@ UntaggedValue *Runtime::invokeFunctionUnchecked(Context *context, Function *func
         argDataOffset += numArgBytes;
     }
 
-    // Call the invoke thunk.
-    contextRuntimeData = (*invokeFunctionPointer)(function, contextRuntimeData);
+    // Call the invoke thunk. The call's state is captured through a single pointer, so the
+    // std::function that callOnContextStack takes stores the lambda inline instead of allocating.
+    struct ThunkCall {
+        LLVMJIT::InvokeThunkPointer invokeThunk;
+        Function *function;
+        ContextRuntimeData *contextRuntimeData;
+    } thunkCall = {invokeFunctionPointer, function, contextRuntimeData};
+    callOnContextStack(context, [&thunkCall] { thunkCall.contextRuntimeData = (*thunkCall.invokeThunk)(thunkCall.function, thunkCall.contextRuntimeData); });
+    contextRuntimeData = thunkCall.contextRuntimeData;
 
     // Return a pointer to the return value that was written to the ContextRuntimeData.
     return (UntaggedValue *) contextRuntimeData->thunkArgAndReturnData;
 }
 
-ValueTuple Runtime::invokeFunctionChecked(Context *context, Function *function, const std::vector<Value> &arguments) {
+void Runtime::invokeFunctionBatch(Context *context, Function *function, const UntaggedValue *arguments, Uptr numCalls, UntaggedValue *results) {
+    errorUnless(isInCompartment(asObject(function), context->compartment));
+
+    auto batchInvokeThunk = LLVMJIT::getBatchInvokeThunk(FunctionType{function->encodedType});
+
+    ContextRuntimeData *contextRuntimeData = &context->compartment->runtimeData->contexts[context->id];
+    callOnContextStack(context, [&] { (*batchInvokeThunk)(function, contextRuntimeData, arguments, numCalls, results); });
+}
+
+ValueTuple Runtime::invokeFunctionChecked(Context *context, Function *function, const Value *arguments, Uptr numArguments) {
     errorUnless(isInCompartment(asObject(function), context->compartment));
 
     FunctionType functionType{function->encodedType};
@@ -47,8 +68,8 @@ ValueTuple Runtime::invokeFunctionChecked(Context *context, Function *function,
 
     // Convert the arguments from a vector of Values to a stack-allocated block of
     // UntaggedValues.
-    UntaggedValue *untaggedArguments = (UntaggedValue *) alloca(arguments.size() * sizeof(UntaggedValue));
-    for (Uptr argumentIndex = 0; argumentIndex < arguments.size(); ++argumentIndex) {
+    UntaggedValue *untaggedArguments = (UntaggedValue *) alloca(numArguments * sizeof(UntaggedValue));
+    for (Uptr argumentIndex = 0; argumentIndex < numArguments; ++argumentIndex) {
         const Value &argument = arguments[argumentIndex];
 
         errorUnless(!isReferenceType(argument.type) || !argument.object ||
@@ -72,25 +93,25 @@ ValueTuple Runtime::invokeFunctionChecked(Context *context, Function *function,
         U8 *result = resultStructBase + resultOffset;
         switch (resultType) {
             case ValueType::i32:
-                results.values.push_back(Value(*(I32 *) result));
+                results.push_back(Value(*(I32 *) result));
                 break;
             case ValueType::i64:
-                results.values.push_back(Value(*(I64 *) result));
+                results.push_back(Value(*(I64 *) result));
                 break;
             case ValueType::f32:
-                results.values.push_back(Value(*(F32 *) result));
+                results.push_back(Value(*(F32 *) result));
                 break;
             case ValueType::f64:
-                results.values.push_back(Value(*(F64 *) result));
+                results.push_back(Value(*(F64 *) result));
                 break;
             case ValueType::v128:
-                results.values.push_back(Value(*(V128 *) result));
+                results.push_back(Value(*(V128 *) result));
                 break;
             case ValueType::anyref:
-                results.values.push_back(Value(*(Object **) result));
+                results.push_back(Value(*(Object **) result));
                 break;
             case ValueType::anyfunc:
-                results.values.push_back(Value(*(Function **) result));
+                results.push_back(Value(*(Function **) result));
                 break;
             default:
                 Errors::unreachable();
@@ -100,3 +121,54 @@ ValueTuple Runtime::invokeFunctionChecked(Context *context, Function *function,
     }
     return results;
 }
+
+PreparedCall Runtime::prepareCall(Context *context, Function *function) {
+    errorUnless(isInCompartment(asObject(function), context->compartment));
+
+    PreparedCall call;
+    call.function = function;
+    call.context = context;
+    call.contextRuntimeData = &context->compartment->runtimeData->contexts[context->id];
+    call.invokeThunk = LLVMJIT::getInvokeThunk(FunctionType{function->encodedType});
+    call.argAndReturnData = call.contextRuntimeData->thunkArgAndReturnData;
+    call.type = FunctionType{function->encodedType};
+
+    // Lay out the arguments the same way as invokeFunctionUnchecked: each naturally aligned.
+    Uptr argDataOffset = 0;
+    for (ValueType paramType : call.type.params()) {
+        const Uptr numArgBytes = getTypeByteWidth(paramType);
+        argDataOffset = (argDataOffset + numArgBytes - 1) & -numArgBytes;
+        errorUnless(argDataOffset + numArgBytes <= maxThunkArgAndReturnBytes);
+
+        call.paramOffsets.push_back(U32(argDataOffset));
+        call.paramNumBytes.push_back(U8(numArgBytes));
+        argDataOffset += numArgBytes;
+    }
+
+    // Lay out the results the same way as invokeFunctionChecked reads them.
+    Uptr resultOffset = 0;
+    for (ValueType resultType : call.type.results()) {
+        const Uptr numResultBytes = getTypeByteWidth(resultType);
+        resultOffset = (resultOffset + numResultBytes - 1) & -numResultBytes;
+        wavmAssert(resultOffset + numResultBytes <= maxThunkArgAndReturnBytes);
+
+        call.resultOffsets.push_back(U32(resultOffset));
+        call.resultNumBytes.push_back(U8(numResultBytes));
+        resultOffset += numResultBytes;
+    }
+
+    return call;
+}
+
+const U8 *Runtime::invokePreparedCall(const PreparedCall &call, const UntaggedValue *arguments) {
+    for (Uptr argumentIndex = 0; argumentIndex < call.paramOffsets.size(); ++argumentIndex) {
+        memcpy(call.argAndReturnData + call.paramOffsets[argumentIndex], arguments[argumentIndex].bytes, call.paramNumBytes[argumentIndex]);
+    }
+    return invokePreparedCallWithWrittenArguments(call);
+}
+
+const U8 *Runtime::invokePreparedCallWithWrittenArguments(const PreparedCall &call) {
+    ContextRuntimeData *contextRuntimeData = call.contextRuntimeData;
+    callOnContextStack(call.context, [&] { contextRuntimeData = (*call.invokeThunk)(call.function, contextRuntimeData); });
+    return contextRuntimeData->thunkArgAndReturnData;
+}
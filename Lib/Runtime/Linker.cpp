@@ -1,3 +1,4 @@
+#include "RuntimePrivate.h"
 #include "WAVM/Runtime/Linker.h"
 
 using namespace WAVM;
@@ -37,6 +38,8 @@ template<typename Instance, typename Type> void linkImport(const IR::Module &mod
 }
 
 LinkResult Runtime::linkModule(const IR::Module &module, Resolver &resolver) {
+    MetricTimer linkTimer(Metrics::Histogram::linkMicroseconds);
+    addToMetric(Metrics::Counter::numLinks);
     LinkResult linkResult;
     for (const auto &import : module.functions.imports) {
         linkImport(module, import, resolver, linkResult, linkResult.resolvedImports.functions);
@@ -57,3 +60,170 @@ LinkResult Runtime::linkModule(const IR::Module &module, Resolver &resolver) {
     linkResult.success = linkResult.missingImports.size() == 0;
     return linkResult;
 }
+
+struct Runtime::LinkPlan {
+    // Where a link plan finds the object for an import.
+    enum class ImportSource {
+        // An object that is in every compartment, e.g. an intrinsic function's thunk.
+        object,
+        // The object at an index in the provider's functions, tables, memories, globals, or
+        // exception types.
+        providerIndex,
+        // An export of an intrinsic module instance, which has no IR to give its exports indices.
+        providerExportName,
+    };
+
+    struct Import {
+        ImportSource source;
+        ExternType type;
+        Object *object;
+        Uptr providerIndex;
+        Uptr index;
+        std::string exportName;
+    };
+
+    // What a provider that was given to createLinkPlan was an instance of.
+    struct Provider {
+        std::shared_ptr<const Runtime::Module> module;
+        std::shared_ptr<const SharedIntrinsicExports> sharedExports;
+    };
+
+    std::vector<Provider> providers;
+    std::vector<Import> imports;
+};
+
+template<typename Type> static void planImport(const IR::Module &module, const Import<Type> &import, const std::vector<std::pair<std::string, ModuleInstance *>> &providers, LinkPlan &linkPlan, std::vector<LinkResult::MissingImport> &outMissingImports) {
+    const ExternType type = resolveImportType(module, import.type);
+    for (Uptr providerIndex = 0; providerIndex < providers.size(); ++providerIndex) {
+        if (providers[providerIndex].first != import.moduleName) {
+            continue;
+        }
+
+        ModuleInstance *provider = providers[providerIndex].second;
+        Object *object = getInstanceExport(provider, import.exportName);
+        if (!object || !isA(object, type)) {
+            break;
+        }
+
+        LinkPlan::Import plannedImport{LinkPlan::ImportSource::object, type, nullptr, providerIndex, 0, {}};
+        if (object->kind == ObjectKind::function && asFunction(object)->moduleInstanceId == UINTPTR_MAX) {
+            plannedImport.object = object;
+        } else if (provider->module) {
+            plannedImport.source = LinkPlan::ImportSource::providerIndex;
+            for (const Export &exportIt : provider->module->ir.exports) {
+                if (exportIt.name == import.exportName) {
+                    plannedImport.index = exportIt.index;
+                    break;
+                }
+            }
+        } else {
+            plannedImport.source = LinkPlan::ImportSource::providerExportName;
+            plannedImport.exportName = import.exportName;
+        }
+        linkPlan.imports.push_back(std::move(plannedImport));
+        return;
+    }
+
+    outMissingImports.push_back({import.moduleName, import.exportName, type});
+}
+
+LinkPlanRef Runtime::createLinkPlan(const IR::Module &module, const std::vector<std::pair<std::string, ModuleInstance *>> &providers, std::vector<LinkResult::MissingImport> &outMissingImports) {
+    std::shared_ptr<LinkPlan> linkPlan = std::make_shared<LinkPlan>();
+    for (const auto &provider : providers) {
+        linkPlan->providers.push_back({provider.second->module, provider.second->sharedExports});
+    }
+
+    const Uptr numPreviousMissingImports = outMissingImports.size();
+    for (const auto &import : module.functions.imports) {
+        planImport(module, import, providers, *linkPlan, outMissingImports);
+    }
+    for (const auto &import : module.tables.imports) {
+        planImport(module, import, providers, *linkPlan, outMissingImports);
+    }
+    for (const auto &import : module.memories.imports) {
+        planImport(module, import, providers, *linkPlan, outMissingImports);
+    }
+    for (const auto &import : module.globals.imports) {
+        planImport(module, import, providers, *linkPlan, outMissingImports);
+    }
+    for (const auto &import : module.exceptionTypes.imports) {
+        planImport(module, import, providers, *linkPlan, outMissingImports);
+    }
+
+    if (outMissingImports.size() != numPreviousMissingImports) {
+        return nullptr;
+    }
+    return linkPlan;
+}
+
+template<typename Instance> static Instance *getProviderObject(const std::vector<Instance *> &objects, Uptr index) {
+    errorUnless(index < objects.size());
+    return objects[index];
+}
+
+ImportBindings Runtime::linkModule(const LinkPlan &linkPlan, const std::vector<ModuleInstance *> &providers) {
+    MetricTimer linkTimer(Metrics::Histogram::linkMicroseconds);
+    addToMetric(Metrics::Counter::numLinks);
+
+    // The plan's indices are only valid for instances of the same modules it was created from.
+    errorUnless(providers.size() == linkPlan.providers.size());
+    for (Uptr providerIndex = 0; providerIndex < providers.size(); ++providerIndex) {
+        errorUnless(providers[providerIndex]->module == linkPlan.providers[providerIndex].module);
+        errorUnless(providers[providerIndex]->sharedExports == linkPlan.providers[providerIndex].sharedExports);
+    }
+
+    ImportBindings imports;
+    for (const LinkPlan::Import &import : linkPlan.imports) {
+        Object *object = import.object;
+        if (import.source != LinkPlan::ImportSource::object) {
+            ModuleInstance *provider = providers[import.providerIndex];
+            if (import.source == LinkPlan::ImportSource::providerIndex) {
+                switch (import.type.kind) {
+                    case ExternKind::function:
+                        object = asObject(getProviderObject(provider->functions, import.index));
+                        break;
+                    case ExternKind::table:
+                        object = asObject(getProviderObject(provider->tables, import.index));
+                        break;
+                    case ExternKind::memory:
+                        object = asObject(getProviderObject(provider->memories, import.index));
+                        break;
+                    case ExternKind::global:
+                        object = asObject(getProviderObject(provider->globals, import.index));
+                        break;
+                    case ExternKind::exceptionType:
+                        object = asObject(getProviderObject(provider->exceptionTypes, import.index));
+                        break;
+                    default:
+                        Errors::unreachable();
+                }
+            } else {
+                // An intrinsic module's per-compartment objects may differ between instances, e.g.
+                // in the extra exports they were given, so their types are checked again.
+                object = getInstanceExport(provider, import.exportName);
+                errorUnless(object && isA(object, import.type));
+            }
+        }
+
+        switch (import.type.kind) {
+            case ExternKind::function:
+                imports.functions.push_back(asFunction(object));
+                break;
+            case ExternKind::table:
+                imports.tables.push_back(asTable(object));
+                break;
+            case ExternKind::memory:
+                imports.memories.push_back(asMemory(object));
+                break;
+            case ExternKind::global:
+                imports.globals.push_back(asGlobal(object));
+                break;
+            case ExternKind::exceptionType:
+                imports.exceptionTypes.push_back(asExceptionType(object));
+                break;
+            default:
+                Errors::unreachable();
+        }
+    }
+    return imports;
+}
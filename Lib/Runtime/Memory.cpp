@@ -1,19 +1,25 @@
 #include <stdint.h>
 #include <string.h>
 #include <atomic>
+#include <algorithm>
 #include <memory>
+#include <thread>
 #include <vector>
 
 #include "RuntimePrivate.h"
+#include "WAVM/Inline/AddressRangeIndex.h"
 #include "WAVM/Inline/Lock.h"
 #include "WAVM/Platform/Memory.h"
 
 using namespace WAVM;
 using namespace WAVM::Runtime;
 
-// Global lists of memories; used to query whether an address is reserved by one of them.
-static Platform::Mutex memoriesMutex;
-static std::vector<Memory *> memories;
+// A global index of the memories' reserved address ranges; used to query whether an address is
+// reserved by one of them.
+static AddressRangeIndex<Memory *> memoryRangeIndex;
+
+// The maximum number of pages reserved by a memory with a bounded reservation.
+static std::atomic<Uptr> maxBoundedMemoryPages{IR::maxMemoryPages};
 
 enum {
     numGuardPages = 1
@@ -24,22 +30,53 @@ static Uptr getPlatformPagesPerWebAssemblyPageLog2() {
     return IR::numBytesPerPageLog2 - Platform::getPageSizeLog2();
 }
 
-static Memory *createMemoryImpl(Compartment *compartment, IR::MemoryType type, Uptr numPages, std::string &&debugName) {
+void Runtime::setMaxBoundedMemoryPages(Uptr maxPages) {
+    maxBoundedMemoryPages.store(std::min(maxPages, Uptr(IR::maxMemoryPages)), std::memory_order_relaxed);
+}
+
+static Memory *createMemoryImpl(Compartment *compartment, IR::MemoryType type, Uptr numPages, bool useHugePages, bool boundedReservation, Uptr numaNode, std::string &&debugName) {
     Memory *memory = new Memory(compartment, type, std::move(debugName));
+    memory->useHugePages = useHugePages;
+    memory->hasBoundedReservation = boundedReservation;
+    memory->numaNode = numaNode;
 
     // On a 64-bit runtime, allocate 8GB of address space for the memory.
     // This allows eliding bounds checks on memory accesses, since a 32-bit index + 32-bit offset
-    // will always be within the reserved address-space.
+    // will always be within the reserved address-space. A memory with a bounded reservation only
+    // allocates address space for its maximum size, and relies on the generated code clamping
+    // addresses to the end of the reservation, where the guard page is.
     const Uptr pageBytesLog2 = Platform::getPageSizeLog2();
-    const Uptr memoryMaxBytes = Uptr(8ull * 1024 * 1024 * 1024);
+    errorUnless((Uptr(numGuardPages) << pageBytesLog2) >= boundedMemoryGuardBytes);
+    Uptr memoryMaxBytes = Uptr(8ull * 1024 * 1024 * 1024);
+    if (boundedReservation) {
+        const Uptr maxReservedPages = std::min(getMemoryMaxPages(memory), maxBoundedMemoryPages.load(std::memory_order_relaxed));
+        memoryMaxBytes = maxReservedPages * IR::numBytesPerPage;
+    }
     const Uptr memoryMaxPages = memoryMaxBytes >> pageBytesLog2;
 
-    memory->baseAddress = Platform::allocateVirtualPages(memoryMaxPages + numGuardPages);
+    // If the memory should use huge pages, align its reservation to the huge page size, so the
+    // pages it commits cover whole huge pages from its base address.
+    if (useHugePages) {
+        memory->baseAddress = allocateAlignedReservation(ReservationKind::hugePageMemory, memoryMaxPages + numGuardPages, memory->unalignedBaseAddress);
+    } else {
+        memory->baseAddress = allocateReservation(ReservationKind::memory, memoryMaxPages + numGuardPages);
+        memory->unalignedBaseAddress = memory->baseAddress;
+    }
     memory->numReservedBytes = memoryMaxBytes;
     if (!memory->baseAddress) {
         delete memory;
         return nullptr;
     }
+    if (useHugePages && memoryMaxPages) {
+        Platform::adviseHugePages(memory->baseAddress, memoryMaxPages);
+    }
+
+    // Place the memory's pages on its NUMA node before they are committed, so they aren't placed on
+    // the node of the thread that happens to touch them first. This also resets the placement of a
+    // pooled reservation.
+    if (memoryMaxPages) {
+        Platform::setVirtualPagesNUMANode(memory->baseAddress, memoryMaxPages, numaNode != Platform::anyNUMANode ? numaNode : compartment->numaNode);
+    }
 
     // Grow the memory to the type's minimum size.
     if (growMemory(memory, numPages) == -1) {
@@ -47,59 +84,107 @@ static Memory *createMemoryImpl(Compartment *compartment, IR::MemoryType type, U
         return nullptr;
     }
 
-    // Add the memory to the global array.
-    {
-        Lock<Platform::Mutex> memoriesLock(memoriesMutex);
-        memories.push_back(memory);
+    // Add the memory's reserved address range to the global index, including its guard pages, so
+    // an access to them is recognized as an out-of-bounds access of the memory. This also indexes a
+    // bounded reservation for a memory with no pages, which only contains the guard pages.
+    const Uptr numGuardBytes = Uptr(numGuardPages) << pageBytesLog2;
+    memoryRangeIndex.add(Uptr(memory->baseAddress), Uptr(memory->baseAddress) + memory->numReservedBytes + numGuardBytes, memory);
+    memory->isInRangeIndex = true;
+
+    return memory;
+}
+
+static Memory *addMemoryToCompartment(Compartment *compartment, Memory *memory) {
+    // Add the memory to the compartment's memories DenseIndexMap.
+    Lock<Platform::Mutex> compartmentLock(compartment->mutex);
+
+    memory->id = compartment->memories.add(UINTPTR_MAX, memory);
+    if (memory->id == UINTPTR_MAX) {
+        delete memory;
+        return nullptr;
     }
+    compartment->runtimeData->memoryBases[memory->id] = memory->baseAddress;
+    compartment->runtimeData->memoryNumReservedBytes[memory->id] = memory->numReservedBytes;
+    compartment->runtimeData->memoryNumBytes[memory->id].store(memory->numPages.load(std::memory_order_acquire) * IR::numBytesPerPage, std::memory_order_release);
 
     return memory;
 }
 
-Memory *Runtime::createMemory(Compartment *compartment, IR::MemoryType type, std::string &&debugName) {
+Memory *Runtime::createMemory(Compartment *compartment, IR::MemoryType type, std::string &&debugName, bool useHugePages, bool boundedReservation, Uptr numaNode) {
     wavmAssert(type.size.min <= UINTPTR_MAX);
-    Memory *memory = createMemoryImpl(compartment, type, Uptr(type.size.min), std::move(debugName));
+    errorUnless(numaNode == Platform::anyNUMANode || numaNode < Platform::getNumNUMANodes());
+    Memory *memory = createMemoryImpl(compartment, type, Uptr(type.size.min), useHugePages, boundedReservation, numaNode, std::move(debugName));
     if (!memory) {
         return nullptr;
     }
 
-    // Add the memory to the compartment's memories IndexMap.
-    {
-        Lock<Platform::Mutex> compartmentLock(compartment->mutex);
+    return addMemoryToCompartment(compartment, memory);
+}
 
-        memory->id = compartment->memories.add(UINTPTR_MAX, memory);
-        if (memory->id == UINTPTR_MAX) {
-            delete memory;
-            return nullptr;
-        }
-        compartment->runtimeData->memoryBases[memory->id] = memory->baseAddress;
+Memory *Runtime::createMemoryFromPageFile(Compartment *compartment, IR::MemoryType type, Platform::PageFile *pageFile, Uptr numPages, bool boundedReservation, std::string &&debugName) {
+    errorUnless(numPages >= type.size.min && numPages <= type.size.max);
+    Memory *memory = createMemoryImpl(compartment, type, 0, false, boundedReservation, Platform::anyNUMANode, std::move(debugName));
+    if (!memory) {
+        return nullptr;
+    }
+    if (numPages > memory->numReservedBytes / IR::numBytesPerPage) {
+        delete memory;
+        return nullptr;
     }
 
-    return memory;
+    // Map the page file over the memory's reserved pages, in place of committing them. The mapped
+    // pages are charged to the compartment as if they were committed.
+    memory->isMappedFromPageFile = true;
+    if (!tryChargeCompartmentMemory(compartment, CompartmentMemoryKind::memory, numPages * IR::numBytesPerPage)) {
+        delete memory;
+        return nullptr;
+    }
+    if (!Platform::mapPageFileCopyOnWrite(pageFile, memory->baseAddress, numPages << getPlatformPagesPerWebAssemblyPageLog2())) {
+        releaseCompartmentMemory(compartment, CompartmentMemoryKind::memory, numPages * IR::numBytesPerPage);
+        delete memory;
+        return nullptr;
+    }
+    memory->numClaimedPages.store(numPages, std::memory_order_relaxed);
+    memory->numPages.store(numPages, std::memory_order_release);
+
+    return addMemoryToCompartment(compartment, memory);
 }
 
 Memory *Runtime::cloneMemory(Memory *memory, Compartment *newCompartment) {
-    Lock<Platform::Mutex> resizingLock(memory->resizingMutex);
+    // Pages committed by grows that finish after this load aren't copied, but they are zero, as the
+    // new memory's pages are.
     const Uptr numPages = memory->numPages.load(std::memory_order_acquire);
     std::string debugName = memory->debugName;
-    Memory *newMemory = createMemoryImpl(newCompartment, memory->type, numPages, std::move(debugName));
+    Memory *newMemory = createMemoryImpl(newCompartment, memory->type, numPages, memory->useHugePages, memory->hasBoundedReservation, memory->numaNode, std::move(debugName));
     if (!newMemory) {
         return nullptr;
     }
 
-    // Copy the memory contents to the new memory.
-    memcpy(newMemory->baseAddress, memory->baseAddress, numPages * IR::numBytesPerPage);
-
-    resizingLock.unlock();
+    // Copy the memory contents to the new memory. The new memory's pages are already zero, so skip
+    // pages that are entirely zero: besides avoiding the copy, this leaves them uncommitted
+    // physically until the clone writes them.
+    const Uptr platformPageBytes = Uptr(1) << Platform::getPageSizeLog2();
+    const Uptr numBytes = numPages * IR::numBytesPerPage;
+    for (Uptr pageOffset = 0; pageOffset < numBytes; pageOffset += platformPageBytes) {
+        const U64 *pageWords = reinterpret_cast<const U64 *>(memory->baseAddress + pageOffset);
+        for (Uptr wordIndex = 0; wordIndex < platformPageBytes / sizeof(U64); ++wordIndex) {
+            if (pageWords[wordIndex]) {
+                memcpy(newMemory->baseAddress + pageOffset, memory->baseAddress + pageOffset, platformPageBytes);
+                break;
+            }
+        }
+    }
 
     // Insert the memory in the new compartment's memories array with the same index as it had in
-    // the original compartment's memories IndexMap.
+    // the original compartment's memories DenseIndexMap.
     {
         Lock<Platform::Mutex> compartmentLock(newCompartment->mutex);
 
         newMemory->id = memory->id;
         newCompartment->memories.insertOrFail(newMemory->id, newMemory);
         newCompartment->runtimeData->memoryBases[newMemory->id] = newMemory->baseAddress;
+        newCompartment->runtimeData->memoryNumReservedBytes[newMemory->id] = newMemory->numReservedBytes;
+        newCompartment->runtimeData->memoryNumBytes[newMemory->id].store(numPages * IR::numBytesPerPage, std::memory_order_release);
     }
 
     return newMemory;
@@ -112,42 +197,42 @@ Runtime::Memory::~Memory() {
 
         wavmAssert(compartment->runtimeData->memoryBases[id] == baseAddress);
         compartment->runtimeData->memoryBases[id] = nullptr;
+        compartment->runtimeData->memoryNumReservedBytes[id] = 0;
+        compartment->runtimeData->memoryNumBytes[id].store(0, std::memory_order_release);
     }
 
-    // Remove the memory from the global array.
-    {
-        Lock<Platform::Mutex> memoriesLock(memoriesMutex);
-        for (Uptr memoryIndex = 0; memoryIndex < memories.size(); ++memoryIndex) {
-            if (memories[memoryIndex] == this) {
-                memories.erase(memories.begin() + memoryIndex);
-                break;
-            }
-        }
+    // Remove the memory's reserved address range from the global index.
+    if (isInRangeIndex) {
+        memoryRangeIndex.removeOrFail(Uptr(baseAddress));
     }
 
-    // Free the virtual address space.
+    // Free the virtual address space. If the memory was mapped from a page file, replace the mapping
+    // with anonymous pages first, so the reservation is in the same state as a new one.
     const Uptr pageBytesLog2 = Platform::getPageSizeLog2();
-    if (numReservedBytes > 0) {
-        Platform::freeVirtualPages(baseAddress, (numReservedBytes >> pageBytesLog2) + numGuardPages);
+    if (baseAddress) {
+        releaseCompartmentMemory(compartment, CompartmentMemoryKind::memory, numPages.load(std::memory_order_acquire) * IR::numBytesPerPage);
+
+        Uptr numCommittedPages = numPages.load(std::memory_order_acquire) << getPlatformPagesPerWebAssemblyPageLog2();
+        if (isMappedFromPageFile) {
+            Platform::decommitVirtualPages(baseAddress, numCommittedPages);
+            numCommittedPages = 0;
+        }
+        freeAlignedReservation(useHugePages ? ReservationKind::hugePageMemory : ReservationKind::memory, baseAddress, unalignedBaseAddress, (numReservedBytes >> pageBytesLog2) + numGuardPages, numCommittedPages);
     }
     baseAddress = nullptr;
-    numPages = numReservedBytes = 0;
+    numClaimedPages = numPages = numReservedBytes = 0;
 }
 
 bool Runtime::isAddressOwnedByMemory(U8 *address, Memory *&outMemory, Uptr &outMemoryAddress) {
-    // Iterate over all memories and check if the address is within the reserved address space for
-    // each.
-    Lock<Platform::Mutex> memoriesLock(memoriesMutex);
-    for (auto memory : memories) {
-        U8 *startAddress = memory->baseAddress;
-        U8 *endAddress = memory->baseAddress + memory->numReservedBytes;
-        if (address >= startAddress && address < endAddress) {
-            outMemory = memory;
-            outMemoryAddress = address - startAddress;
-            return true;
-        }
+    // Look up the memory whose reserved address space contains the address. This doesn't take a
+    // lock, so it's safe to call from a signal handler.
+    AddressRangeIndex<Memory *>::Range range;
+    if (!memoryRangeIndex.find(Uptr(address), range)) {
+        return false;
     }
-    return false;
+    outMemory = range.value;
+    outMemoryAddress = Uptr(address) - range.begin;
+    return true;
 }
 
 Uptr Runtime::getMemoryNumPages(Memory *memory) {
@@ -164,24 +249,53 @@ Iptr Runtime::growMemory(Memory *memory, Uptr numPagesToGrow) {
         return memory->numPages.load(std::memory_order_seq_cst);
     }
 
-    Lock<Platform::Mutex> resizingLock(memory->resizingMutex);
-    const Uptr previousNumPages = memory->numPages.load(std::memory_order_acquire);
+    // The memory can't grow beyond its type's maximum size, or beyond its reservation.
+    const Uptr maxPages = std::min(std::min(getMemoryMaxPages(memory), Uptr(IR::maxMemoryPages)), memory->numReservedBytes / IR::numBytesPerPage);
 
-    // If the number of pages to grow would cause the memory's size to exceed its maximum,
-    // return -1.
-    if (numPagesToGrow > memory->type.size.max || previousNumPages > memory->type.size.max - numPagesToGrow ||
-        numPagesToGrow > IR::maxMemoryPages || previousNumPages > IR::maxMemoryPages - numPagesToGrow) {
+    // Charge the pages to the compartment's memory usage, and return -1 if that would exceed the
+    // compartment's memory limit.
+    if (numPagesToGrow > maxPages ||
+        !tryChargeCompartmentMemory(memory->compartment, CompartmentMemoryKind::memory, numPagesToGrow * IR::numBytesPerPage)) {
         return -1;
     }
 
-    // Try to commit the new pages, and return -1 if the commit fails.
+    // Claim the pages to grow by, and return -1 if that would cause the memory's size to exceed its
+    // maximum.
+    Uptr previousNumPages = memory->numClaimedPages.load(std::memory_order_acquire);
+    do {
+        if (previousNumPages > maxPages - numPagesToGrow) {
+            releaseCompartmentMemory(memory->compartment, CompartmentMemoryKind::memory, numPagesToGrow * IR::numBytesPerPage);
+            return -1;
+        }
+    } while (!memory->numClaimedPages.compare_exchange_weak(previousNumPages, previousNumPages + numPagesToGrow, std::memory_order_acq_rel, std::memory_order_acquire));
+    const Uptr newNumPages = previousNumPages + numPagesToGrow;
+
+    // Commit the claimed pages. Concurrent grows of the same memory commit their pages in parallel.
     if (!Platform::commitVirtualPages(
             memory->baseAddress + previousNumPages * IR::numBytesPerPage,
             numPagesToGrow << getPlatformPagesPerWebAssemblyPageLog2())) {
-        return -1;
+        // If no other grow has claimed pages after this one's, release the claim and return -1.
+        // Otherwise, the later grow's pages would be published after a hole of uncommitted pages.
+        Uptr expectedNumClaimedPages = newNumPages;
+        if (memory->numClaimedPages.compare_exchange_strong(expectedNumClaimedPages, previousNumPages, std::memory_order_acq_rel)) {
+            releaseCompartmentMemory(memory->compartment, CompartmentMemoryKind::memory, numPagesToGrow * IR::numBytesPerPage);
+            return -1;
+        }
+        Errors::fatalf("Failed to commit %" PRIuPTR " pages of memory while it was being grown concurrently", numPagesToGrow);
     }
 
-    memory->numPages.store(previousNumPages + numPagesToGrow, std::memory_order_release);
+    // Publish the new pages once the grows that claimed the pages before them have published theirs,
+    // so numPages never includes uncommitted pages. The size in the compartment's runtime data is
+    // updated before numPages, so the next grow's update can't be overwritten by this one's.
+    while (memory->numPages.load(std::memory_order_acquire) != previousNumPages) {
+        std::this_thread::yield();
+    }
+    if (memory->id != UINTPTR_MAX) {
+        memory->compartment->runtimeData->memoryNumBytes[memory->id].store(newNumPages * IR::numBytesPerPage, std::memory_order_release);
+    }
+    memory->numPages.store(newNumPages, std::memory_order_release);
+    addToMetric(Metrics::Counter::numMemoryGrows);
+    addToMetric(Metrics::Counter::numGrownMemoryPages, numPagesToGrow);
     return previousNumPages;
 }
 
@@ -200,6 +314,14 @@ static U8 *getValidatedMemoryOffsetRangeImpl(Memory *memory, U8 *memoryBase, Upt
 U8 *Runtime::getReservedMemoryOffsetRange(Memory *memory, Uptr address, Uptr numBytes) {
     wavmAssert(memory);
 
+    // If the memory has a bounded reservation, an out-of-bounds range can't be saturated to its
+    // reserved pages, since they may all be committed. Instead, access the guard page after the
+    // reservation, which faults like an out-of-bounds access by generated code.
+    if (memory->hasBoundedReservation && (numBytes > memory->numReservedBytes || address > memory->numReservedBytes - numBytes)) {
+        *(volatile U8 *) (memory->baseAddress + memory->numReservedBytes);
+        Errors::unreachable();
+    }
+
     // Validate that the range [offset..offset+numBytes) is contained by the memory's reserved
     // pages.
     return ::getValidatedMemoryOffsetRangeImpl(memory, memory->baseAddress, memory->numReservedBytes, address, numBytes);
@@ -231,48 +353,55 @@ DEFINE_INTRINSIC_FUNCTION(wavmIntrinsics, "memory.size", U32, memory_size, I64 m
 
 DEFINE_INTRINSIC_FUNCTION(wavmIntrinsics, "memory.init", void, memory_init, U32 destAddress, U32 sourceOffset, U32 numBytes, Uptr moduleInstanceId, Uptr memoryId, Uptr dataSegmentIndex) {
     ModuleInstance *moduleInstance = getModuleInstanceFromRuntimeData(contextRuntimeData, moduleInstanceId);
-    Lock<Platform::Mutex> passiveDataSegmentsLock(moduleInstance->passiveDataSegmentsMutex);
 
-    if (!moduleInstance->passiveDataSegments.contains(dataSegmentIndex)) {
-        passiveDataSegmentsLock.unlock();
-    } else {
-        // Copy the passive data segment shared_ptr, and unlock the mutex. It's important to
-        // explicitly unlock the mutex before calling memcpy, as memcpy might trigger a signal that
-        // will unwind the stack without calling the Lock destructor.
-        std::shared_ptr<const std::vector<U8>> passiveDataSegmentBytes = moduleInstance->passiveDataSegments[dataSegmentIndex];
-        passiveDataSegmentsLock.unlock();
+    // Only hold the lock while reading the dropped bit: memcpy might trigger a signal that will
+    // unwind the stack without calling the Lock destructor.
+    bool isDropped;
+    {
+        Lock<Platform::Mutex> droppedSegmentsLock(moduleInstance->droppedSegmentsMutex);
+        wavmAssert(dataSegmentIndex < moduleInstance->droppedDataSegments.size());
+        isDropped = moduleInstance->droppedDataSegments[dataSegmentIndex];
+    }
+
+    if (!isDropped) {
+        // The segment's bytes are owned by the immutable module, which outlives the instance.
+        const IR::ModuleBytes &passiveDataSegmentBytes = moduleInstance->module->ir.dataSegments[dataSegmentIndex].data;
 
         Memory *memory = getMemoryFromRuntimeData(contextRuntimeData, memoryId);
         U8 *destPointer = getReservedMemoryOffsetRange(memory, destAddress, numBytes);
 
-        if (U64(sourceOffset) + U64(numBytes) > passiveDataSegmentBytes->size()) {
+        if (U64(sourceOffset) + U64(numBytes) > passiveDataSegmentBytes.size()) {
             // If the source range is outside the bounds of the data segment, copy the part that is
             // in range, then trap.
-            if (sourceOffset < passiveDataSegmentBytes->size()) {
+            if (sourceOffset < passiveDataSegmentBytes.size()) {
                 Platform::bytewiseMemCopy(destPointer,
-                                          passiveDataSegmentBytes->data() + sourceOffset,
-                                          passiveDataSegmentBytes->size() - sourceOffset);
+                                          passiveDataSegmentBytes.data() + sourceOffset,
+                                          passiveDataSegmentBytes.size() - sourceOffset);
             }
         } else if (numBytes) {
-            Platform::bytewiseMemCopy(destPointer, passiveDataSegmentBytes->data() + sourceOffset, numBytes);
+            Platform::bytewiseMemCopy(destPointer, passiveDataSegmentBytes.data() + sourceOffset, numBytes);
         }
     }
 }
 
 DEFINE_INTRINSIC_FUNCTION(wavmIntrinsics, "memory.drop", void, memory_drop, Uptr moduleInstanceId, Uptr dataSegmentIndex) {
     ModuleInstance *moduleInstance = getModuleInstanceFromRuntimeData(contextRuntimeData, moduleInstanceId);
-    Lock<Platform::Mutex> passiveDataSegmentsLock(moduleInstance->passiveDataSegmentsMutex);
-
-    if (!moduleInstance->passiveDataSegments.contains(dataSegmentIndex)) {
-        passiveDataSegmentsLock.unlock();
-    } else {
-        moduleInstance->passiveDataSegments.removeOrFail(dataSegmentIndex);
-    }
+    Lock<Platform::Mutex> droppedSegmentsLock(moduleInstance->droppedSegmentsMutex);
+    wavmAssert(dataSegmentIndex < moduleInstance->droppedDataSegments.size());
+    moduleInstance->droppedDataSegments[dataSegmentIndex] = true;
 }
 
 DEFINE_INTRINSIC_FUNCTION(wavmIntrinsics, "memory.copy", void, memory_copy, U32 destAddress, U32 sourceAddress, U32 numBytes, Uptr memoryId) {
     Memory *memory = getMemoryFromRuntimeData(contextRuntimeData, memoryId);
 
+    // If both ranges are in the memory's committed pages, copy them with the fastest method for the
+    // size. Otherwise, copy bytewise until the out-of-bounds access faults.
+    const U64 numMemoryBytes = U64(memory->numPages.load(std::memory_order_acquire)) * IR::numBytesPerPage;
+    if (U64(destAddress) + numBytes <= numMemoryBytes && U64(sourceAddress) + numBytes <= numMemoryBytes) {
+        Platform::copyMemoryBytes(memory->baseAddress + destAddress, memory->baseAddress + sourceAddress, numBytes);
+        return;
+    }
+
     U8 *destPointer = getReservedMemoryOffsetRange(memory, destAddress, numBytes);
     U8 *sourcePointer = getReservedMemoryOffsetRange(memory, sourceAddress, numBytes);
     if (numBytes) {
@@ -283,6 +412,13 @@ DEFINE_INTRINSIC_FUNCTION(wavmIntrinsics, "memory.copy", void, memory_copy, U32
 DEFINE_INTRINSIC_FUNCTION(wavmIntrinsics, "memory.fill", void, memory_fill, U32 destAddress, U32 value, U32 numBytes, Uptr memoryId) {
     Memory *memory = getMemoryFromRuntimeData(contextRuntimeData, memoryId);
 
+    // Like memory.copy, only fill bytewise if the range isn't in the memory's committed pages.
+    const U64 numMemoryBytes = U64(memory->numPages.load(std::memory_order_acquire)) * IR::numBytesPerPage;
+    if (U64(destAddress) + numBytes <= numMemoryBytes) {
+        Platform::fillMemoryBytes(memory->baseAddress + destAddress, U8(value), numBytes);
+        return;
+    }
+
     U8 *destPointer = getReservedMemoryOffsetRange(memory, destAddress, numBytes);
     if (numBytes) {
         Platform::bytewiseMemSet(destPointer, U8(value), numBytes);
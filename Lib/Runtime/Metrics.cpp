@@ -0,0 +1,194 @@
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#include "RuntimePrivate.h"
+#include "WAVM/Inline/Config.h"
+#include "WAVM/Inline/Lock.h"
+#include "WAVM/Platform/Clock.h"
+#include "WAVM/Platform/Event.h"
+#include "WAVM/Platform/Intrinsic.h"
+#include "WAVM/Platform/Mutex.h"
+#include "WAVM/Runtime/Metrics.h"
+
+using namespace WAVM;
+using namespace WAVM::Runtime;
+using namespace WAVM::Runtime::Metrics;
+
+struct AtomicHistogram {
+    std::atomic<U64> numSamples{0};
+    std::atomic<U64> sum{0};
+    std::atomic<U64> min{UINT64_MAX};
+    std::atomic<U64> max{0};
+    std::atomic<U64> buckets[numHistogramBuckets];
+
+    AtomicHistogram() {
+        for (Uptr bucketIndex = 0; bucketIndex < numHistogramBuckets; ++bucketIndex) {
+            buckets[bucketIndex].store(0, std::memory_order_relaxed);
+        }
+    }
+};
+
+static std::atomic<U64> counters[Uptr(Counter::num)];
+static AtomicHistogram histograms[Uptr(Histogram::num)];
+
+static const char *const counterNames[] = {"numCompiledModules", "numCompiledFunctions", "numObjectCodeBytes", "numObjectCacheHits", "numInstantiations", "numLinks", "numGarbageCollections", "numMemoryGrows", "numGrownMemoryPages", "numTraps", "numReleasedZeroPages", "numReclaimedPages"};
+static_assert(sizeof(counterNames) / sizeof(counterNames[0]) == Uptr(Counter::num), "counterNames doesn't match Counter");
+
+static const char *const histogramNames[] = {"moduleCompileMicroseconds", "linkMicroseconds", "instantiateMicroseconds", "garbageCollectionPauseMicroseconds"};
+static_assert(sizeof(histogramNames) / sizeof(histogramNames[0]) == Uptr(Histogram::num), "histogramNames doesn't match Histogram");
+
+void Runtime::addToMetric(Counter counter, U64 value) {
+    counters[Uptr(counter)].fetch_add(value, std::memory_order_relaxed);
+}
+
+void Runtime::recordMetricSample(Histogram histogram, U64 value) {
+    AtomicHistogram &atomicHistogram = histograms[Uptr(histogram)];
+    atomicHistogram.numSamples.fetch_add(1, std::memory_order_relaxed);
+    atomicHistogram.sum.fetch_add(value, std::memory_order_relaxed);
+
+    U64 previousMin = atomicHistogram.min.load(std::memory_order_relaxed);
+    while (value < previousMin && !atomicHistogram.min.compare_exchange_weak(previousMin, value, std::memory_order_relaxed)) {
+    };
+    U64 previousMax = atomicHistogram.max.load(std::memory_order_relaxed);
+    while (value > previousMax && !atomicHistogram.max.compare_exchange_weak(previousMax, value, std::memory_order_relaxed)) {
+    };
+
+    Uptr bucketIndex = value ? Uptr(64 - Platform::countLeadingZeroes(value)) : 0;
+    if (bucketIndex >= numHistogramBuckets) {
+        bucketIndex = numHistogramBuckets - 1;
+    }
+    atomicHistogram.buckets[bucketIndex].fetch_add(1, std::memory_order_relaxed);
+}
+
+MetricTimer::MetricTimer(Histogram inHistogram) : histogram(inHistogram), startTime(Platform::getMonotonicClock()) {
+}
+
+MetricTimer::~MetricTimer() {
+    recordMetricSample(histogram, Platform::getMonotonicClock() - startTime);
+}
+
+Snapshot Metrics::getSnapshot() {
+    Snapshot snapshot;
+    for (Uptr counterIndex = 0; counterIndex < Uptr(Counter::num); ++counterIndex) {
+        snapshot.counters[counterIndex] = counters[counterIndex].load(std::memory_order_relaxed);
+    }
+    for (Uptr histogramIndex = 0; histogramIndex < Uptr(Histogram::num); ++histogramIndex) {
+        const AtomicHistogram &atomicHistogram = histograms[histogramIndex];
+        HistogramSnapshot &histogramSnapshot = snapshot.histograms[histogramIndex];
+        histogramSnapshot.numSamples = atomicHistogram.numSamples.load(std::memory_order_relaxed);
+        histogramSnapshot.sum = atomicHistogram.sum.load(std::memory_order_relaxed);
+        histogramSnapshot.min = histogramSnapshot.numSamples ? atomicHistogram.min.load(std::memory_order_relaxed) : 0;
+        histogramSnapshot.max = atomicHistogram.max.load(std::memory_order_relaxed);
+        for (Uptr bucketIndex = 0; bucketIndex < numHistogramBuckets; ++bucketIndex) {
+            histogramSnapshot.buckets[bucketIndex] = atomicHistogram.buckets[bucketIndex].load(std::memory_order_relaxed);
+        }
+    }
+    return snapshot;
+}
+
+void Metrics::reset() {
+    for (Uptr counterIndex = 0; counterIndex < Uptr(Counter::num); ++counterIndex) {
+        counters[counterIndex].store(0, std::memory_order_relaxed);
+    }
+    for (Uptr histogramIndex = 0; histogramIndex < Uptr(Histogram::num); ++histogramIndex) {
+        AtomicHistogram &atomicHistogram = histograms[histogramIndex];
+        atomicHistogram.numSamples.store(0, std::memory_order_relaxed);
+        atomicHistogram.sum.store(0, std::memory_order_relaxed);
+        atomicHistogram.min.store(UINT64_MAX, std::memory_order_relaxed);
+        atomicHistogram.max.store(0, std::memory_order_relaxed);
+        for (Uptr bucketIndex = 0; bucketIndex < numHistogramBuckets; ++bucketIndex) {
+            atomicHistogram.buckets[bucketIndex].store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+const char *Metrics::getCounterName(Counter counter) {
+    wavmAssert(counter < Counter::num);
+    return counterNames[Uptr(counter)];
+}
+
+const char *Metrics::getHistogramName(Histogram histogram) {
+    wavmAssert(histogram < Histogram::num);
+    return histogramNames[Uptr(histogram)];
+}
+
+// The background thread that pushes snapshots to the callback. It is never freed, so the callback
+// can be replaced during process exit.
+struct PushThread {
+    Platform::Mutex mutex;
+    PushCallback callback;
+    U64 intervalMicroseconds = 0;
+    Platform::Event wakeEvent;
+    bool isRunning = false;
+};
+
+static PushThread &getPushThread() {
+    static PushThread *pushThread = new PushThread;
+    return *pushThread;
+}
+
+static void pushThreadEntry() {
+    PushThread &pushThread = getPushThread();
+    U64 nextPushTime = 0;
+    while (true) {
+        PushCallback callback;
+        U64 intervalMicroseconds;
+        {
+            Lock<Platform::Mutex> pushThreadLock(pushThread.mutex);
+            if (!pushThread.callback) {
+                pushThread.isRunning = false;
+                return;
+            }
+            callback = pushThread.callback;
+            intervalMicroseconds = pushThread.intervalMicroseconds;
+        }
+
+        const U64 currentTime = Platform::getMonotonicClock();
+        if (!nextPushTime) {
+            nextPushTime = currentTime + intervalMicroseconds;
+        } else if (currentTime >= nextPushTime) {
+            callback(getSnapshot());
+            nextPushTime = currentTime + intervalMicroseconds;
+        }
+
+        // Wait until the next push, or until the callback is replaced.
+        pushThread.wakeEvent.wait(nextPushTime);
+    }
+}
+
+void Metrics::setPushCallback(PushCallback &&callback, U64 intervalMicroseconds) {
+    PushThread &pushThread = getPushThread();
+    Lock<Platform::Mutex> pushThreadLock(pushThread.mutex);
+    pushThread.callback = std::move(callback);
+    pushThread.intervalMicroseconds = intervalMicroseconds;
+    if (pushThread.callback && !pushThread.isRunning) {
+        pushThread.isRunning = true;
+        std::thread(pushThreadEntry).detach();
+    } else {
+        pushThread.wakeEvent.signal();
+    }
+}
+
+#if WAVM_METRICS_OUTPUT
+// Print the metrics when the process exits.
+static void printMetrics() {
+    const Snapshot snapshot = getSnapshot();
+    for (Uptr counterIndex = 0; counterIndex < Uptr(Counter::num); ++counterIndex) {
+        printf("%s: %" PRIu64 "\n", counterNames[counterIndex], snapshot.counters[counterIndex]);
+    }
+    for (Uptr histogramIndex = 0; histogramIndex < Uptr(Histogram::num); ++histogramIndex) {
+        const HistogramSnapshot &histogram = snapshot.histograms[histogramIndex];
+        printf("%s: samples=%" PRIu64 " sum=%" PRIu64 " min=%" PRIu64 " max=%" PRIu64 "\n", histogramNames[histogramIndex], histogram.numSamples, histogram.sum, histogram.min, histogram.max);
+    }
+}
+
+static struct RegisterMetricsOutput {
+    RegisterMetricsOutput() {
+        atexit(printMetrics);
+    }
+} registerMetricsOutput;
+#endif
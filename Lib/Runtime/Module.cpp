@@ -1,4 +1,5 @@
 #include <string.h>
+#include <algorithm>
 #include <atomic>
 #include <memory>
 
@@ -10,7 +11,7 @@ using namespace WAVM;
 using namespace WAVM::IR;
 using namespace WAVM::Runtime;
 
-static Value evaluateInitializer(const std::vector<Global *> &moduleGlobals, InitializerExpression expression) {
+Value Runtime::evaluateInitializer(const std::vector<Global *> &moduleGlobals, InitializerExpression expression) {
     switch (expression.type) {
         case InitializerExpression::Type::i32_const:
             return expression.i32;
@@ -37,18 +38,445 @@ static Value evaluateInitializer(const std::vector<Global *> &moduleGlobals, Ini
     };
 }
 
+static std::atomic<bool> areDebugNamesEnabled{true};
+
+void Runtime::setDebugNamesEnabled(bool enabled) {
+    areDebugNamesEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+// Returns the module's disassembly names, decoding them the first time they are needed. Unnamed
+// function definitions are given a name derived from their index.
+static const DisassemblyNames &getModuleDisassemblyNames(const Runtime::Module &module) {
+    Lock<Platform::Mutex> disassemblyNamesLock(module.disassemblyNamesMutex);
+    if (!module.disassemblyNames) {
+        DisassemblyNames *disassemblyNames = new DisassemblyNames;
+        getDisassemblyNames(module.ir, *disassemblyNames);
+        for (Uptr functionDefIndex = 0; functionDefIndex < module.ir.functions.defs.size(); ++functionDefIndex) {
+            DisassemblyNames::Function &functionNames = disassemblyNames->functions[module.ir.functions.imports.size() + functionDefIndex];
+            if (!functionNames.name.size()) {
+                functionNames.name = "<function #" + std::to_string(functionDefIndex) + ">";
+            }
+
+            // Instantiation doesn't use the local and label names, so don't keep them around.
+            functionNames.locals.clear();
+            functionNames.locals.shrink_to_fit();
+            functionNames.labels.clear();
+            functionNames.labels.shrink_to_fit();
+        }
+        module.disassemblyNames.reset(disassemblyNames);
+    }
+    return *module.disassemblyNames;
+}
+
+// Returns the debug names of the module's function definitions in instances with the given debug
+// name, creating them the first time they are needed.
+static std::shared_ptr<const std::vector<std::string>> getFunctionDefDebugNames(const Runtime::Module &module, const std::string &moduleDebugName) {
+    const DisassemblyNames &disassemblyNames = getModuleDisassemblyNames(module);
+
+    Lock<Platform::Mutex> functionDefDebugNamesLock(module.functionDefDebugNamesMutex);
+    std::weak_ptr<const std::vector<std::string>> &weakDebugNames = module.functionDefDebugNames.getOrAdd(moduleDebugName, std::weak_ptr<const std::vector<std::string>>());
+    std::shared_ptr<const std::vector<std::string>> debugNames = weakDebugNames.lock();
+    if (!debugNames) {
+        std::vector<std::string> *newDebugNames = new std::vector<std::string>(module.ir.functions.defs.size());
+        for (Uptr functionDefIndex = 0; functionDefIndex < module.ir.functions.defs.size(); ++functionDefIndex) {
+            const std::string &functionName = disassemblyNames.functions[module.ir.functions.imports.size() + functionDefIndex].name;
+            std::string &debugName = (*newDebugNames)[functionDefIndex];
+            debugName.reserve(5 + moduleDebugName.size() + 1 + functionName.size());
+            debugName += "wasm!";
+            debugName += moduleDebugName;
+            debugName += '!';
+            debugName += functionName;
+        }
+        debugNames.reset(newDebugNames);
+        weakDebugNames = debugNames;
+
+        // Remove the entries of debug names whose instances have all been freed.
+        if (module.functionDefDebugNames.size() >= module.numFunctionDefDebugNamesToPrune) {
+            std::vector<std::string> expiredModuleDebugNames;
+            for (const auto &pair : module.functionDefDebugNames) {
+                if (pair.value.expired()) {
+                    expiredModuleDebugNames.push_back(pair.key);
+                }
+            }
+            for (const std::string &expiredModuleDebugName : expiredModuleDebugNames) {
+                module.functionDefDebugNames.removeOrFail(expiredModuleDebugName);
+            }
+            module.numFunctionDefDebugNamesToPrune = std::max(Uptr(16), module.functionDefDebugNames.size() * 2);
+        }
+    }
+    return debugNames;
+}
+
 ModuleRef Runtime::compileModule(const IR::Module &irModule) {
-    std::vector<U8> objectCode = LLVMJIT::compileModule(irModule);
-    return std::make_shared<Module>(IR::Module(irModule), std::move(objectCode));
+    return Runtime::compileModule(irModule, LLVMJIT::CompileOptions());
+}
+
+ModuleRef Runtime::compileModule(const IR::Module &irModule, const LLVMJIT::CompileOptions &options) {
+    errorUnless(!options.instanceConstants && !options.linkedModules.size());
+    return compileModuleWithModuleCache(irModule, options);
+}
+
+ModuleRef Runtime::validateAndCompileModule(const IR::Module &irModule, const LLVMJIT::CompileOptions &options) {
+    errorUnless(!options.instanceConstants && !options.linkedModules.size());
+    std::vector<U8> objectCode;
+    {
+        MetricTimer compileTimer(Metrics::Histogram::moduleCompileMicroseconds);
+        objectCode = LLVMJIT::validateAndCompileModule(irModule, options);
+    }
+    addToMetric(Metrics::Counter::numCompiledModules);
+    addToMetric(Metrics::Counter::numCompiledFunctions, irModule.functions.defs.size());
+    addToMetric(Metrics::Counter::numObjectCodeBytes, objectCode.size());
+    return std::make_shared<Module>(IR::Module(irModule), std::move(objectCode), options);
+}
+
+std::vector<ModuleRef> Runtime::compileLinkedModules(const std::vector<const IR::Module *> &irModules, const std::vector<std::string> &moduleNames, const LLVMJIT::CompileOptions &options) {
+    errorUnless(irModules.size() == moduleNames.size());
+    errorUnless(!options.instanceConstants && !options.linkedModules.size() && !options.linkedFunctionImports.size());
+
+    std::vector<ModuleRef> modules;
+    for (Uptr moduleIndex = 0; moduleIndex < irModules.size(); ++moduleIndex) {
+        const IR::Module &irModule = *irModules[moduleIndex];
+        LLVMJIT::CompileOptions moduleOptions = options;
+
+        // Resolve each function import to a function definition exported by the last earlier
+        // module with the import's module name. Imports of functions that the earlier module
+        // imports itself are left unresolved.
+        HashMap<Uptr, Uptr> moduleIndexToLinkedModuleIndex;
+        for (Uptr importIndex = 0; importIndex < irModule.functions.imports.size(); ++importIndex) {
+            const FunctionImport &functionImport = irModule.functions.imports[importIndex];
+            Uptr exportingModuleIndex = UINTPTR_MAX;
+            for (Uptr earlierModuleIndex = 0; earlierModuleIndex < moduleIndex; ++earlierModuleIndex) {
+                if (moduleNames[earlierModuleIndex] == functionImport.moduleName) {
+                    exportingModuleIndex = earlierModuleIndex;
+                }
+            }
+            if (exportingModuleIndex == UINTPTR_MAX) {
+                continue;
+            }
+
+            const IR::Module &exportingIR = modules[exportingModuleIndex]->ir;
+            for (const Export &exportIt : exportingIR.exports) {
+                if (exportIt.kind != ExternKind::function || exportIt.name != functionImport.exportName ||
+                    exportIt.index < exportingIR.functions.imports.size() ||
+                    exportingIR.types[exportingIR.functions.getType(exportIt.index).index] !=
+                    irModule.types[functionImport.type.index]) {
+                    continue;
+                }
+
+                const Uptr linkedModuleIndex = moduleIndexToLinkedModuleIndex.getOrAdd(exportingModuleIndex, moduleOptions.linkedModules.size());
+                if (linkedModuleIndex == moduleOptions.linkedModules.size()) {
+                    // The linked module's IR is referenced through its Runtime::Module, which keeps
+                    // it alive as long as this module.
+                    moduleOptions.linkedModules.push_back(std::shared_ptr<const IR::Module>(modules[exportingModuleIndex], &modules[exportingModuleIndex]->ir));
+                }
+                moduleOptions.linkedFunctionImports.resize(irModule.functions.imports.size());
+                moduleOptions.linkedFunctionImports[importIndex] = {linkedModuleIndex, exportIt.index - exportingIR.functions.imports.size()};
+                break;
+            }
+        }
+
+        std::vector<U8> objectCode;
+        {
+            MetricTimer compileTimer(Metrics::Histogram::moduleCompileMicroseconds);
+            objectCode = LLVMJIT::compileModule(irModule, moduleOptions);
+        }
+        addToMetric(Metrics::Counter::numCompiledModules);
+        addToMetric(Metrics::Counter::numCompiledFunctions, irModule.functions.defs.size());
+        addToMetric(Metrics::Counter::numObjectCodeBytes, objectCode.size());
+        modules.push_back(std::make_shared<Module>(IR::Module(irModule), std::move(objectCode), moduleOptions));
+    }
+    return modules;
+}
+
+const IR::Module &Runtime::getModuleIR(ModuleConstRefParam module) {
+    return module->ir;
+}
+
+Uptr Runtime::getModuleObjectCodeSize(ModuleConstRefParam module) {
+    return module->objectCode.size();
+}
+
+// The header of a precompiled module artifact. The artifact format version must be bumped whenever
+// the IR serialization or the object code's runtime ABI changes.
+static const char precompiledModuleMagic[8] = {'W', 'A', 'V', 'M', 'A', 'O', 'T', 0};
+static constexpr U32 precompiledModuleVersion = 13;
+
+static void serialize(Serialization::InputStream &stream, LLVMJIT::OptimizationLevel &level) {
+    U8 levelByte = 0;
+    Serialization::serialize(stream, levelByte);
+    if (levelByte > U8(LLVMJIT::OptimizationLevel::O3)) {
+        throw Serialization::FatalSerializationException("invalid optimization level");
+    }
+    level = LLVMJIT::OptimizationLevel(levelByte);
+}
+
+static void serialize(Serialization::OutputStream &stream, LLVMJIT::OptimizationLevel &level) {
+    U8 levelByte = U8(level);
+    Serialization::serialize(stream, levelByte);
+}
+
+static void serializeProfile(Serialization::InputStream &stream, std::shared_ptr<const LLVMJIT::ModuleProfile> &profile) {
+    U8 hasProfile = 0;
+    Serialization::serialize(stream, hasProfile);
+    if (hasProfile) {
+        std::shared_ptr<LLVMJIT::ModuleProfile> loadedProfile = std::make_shared<LLVMJIT::ModuleProfile>();
+        loadModuleProfile(stream, *loadedProfile);
+        profile = loadedProfile;
+    } else {
+        profile.reset();
+    }
+}
+
+static void serializeProfile(Serialization::OutputStream &stream, std::shared_ptr<const LLVMJIT::ModuleProfile> &profile) {
+    U8 hasProfile = profile ? 1 : 0;
+    Serialization::serialize(stream, hasProfile);
+    if (profile) {
+        saveModuleProfile(*profile, stream);
+    }
+}
+
+template<typename Stream> static void serialize(Stream &stream, LLVMJIT::CompileOptions &options) {
+    serialize(stream, options.optimizationLevel);
+    U8 enableTierUp = options.enableTierUp ? 1 : 0;
+    Serialization::serialize(stream, enableTierUp);
+    options.enableTierUp = enableTierUp != 0;
+    serialize(stream, options.tierUpOptimizationLevel);
+    Serialization::serialize(stream, options.tierUpCallThreshold);
+    U8 explicitMemoryBoundsChecks = options.explicitMemoryBoundsChecks ? 1 : 0;
+    Serialization::serialize(stream, explicitMemoryBoundsChecks);
+    options.explicitMemoryBoundsChecks = explicitMemoryBoundsChecks != 0;
+    U8 nonVolatileMemoryAccesses = options.nonVolatileMemoryAccesses ? 1 : 0;
+    Serialization::serialize(stream, nonVolatileMemoryAccesses);
+    options.nonVolatileMemoryAccesses = nonVolatileMemoryAccesses != 0;
+    U8 enableInterruptChecks = options.enableInterruptChecks ? 1 : 0;
+    Serialization::serialize(stream, enableInterruptChecks);
+    options.enableInterruptChecks = enableInterruptChecks != 0;
+    U8 enableFuelMetering = options.enableFuelMetering ? 1 : 0;
+    Serialization::serialize(stream, enableFuelMetering);
+    options.enableFuelMetering = enableFuelMetering != 0;
+    U8 enableLazyCompilation = options.enableLazyCompilation ? 1 : 0;
+    Serialization::serialize(stream, enableLazyCompilation);
+    options.enableLazyCompilation = enableLazyCompilation != 0;
+    U8 enableInterpreter = options.enableInterpreter ? 1 : 0;
+    Serialization::serialize(stream, enableInterpreter);
+    options.enableInterpreter = enableInterpreter != 0;
+    U8 enableFramePointers = options.enableFramePointers ? 1 : 0;
+    Serialization::serialize(stream, enableFramePointers);
+    options.enableFramePointers = enableFramePointers != 0;
+    U8 enableCallCounters = options.enableCallCounters ? 1 : 0;
+    Serialization::serialize(stream, enableCallCounters);
+    options.enableCallCounters = enableCallCounters != 0;
+    U8 enableCallTiming = options.enableCallTiming ? 1 : 0;
+    Serialization::serialize(stream, enableCallTiming);
+    options.enableCallTiming = enableCallTiming != 0;
+    Serialization::serialize(stream, options.functionDefCallCounts);
+    U8 enableProfileCounters = options.enableProfileCounters ? 1 : 0;
+    Serialization::serialize(stream, enableProfileCounters);
+    options.enableProfileCounters = enableProfileCounters != 0;
+    serializeProfile(stream, options.profile);
+}
+
+bool Runtime::isPrecompiledModule(const U8 *bytes, Uptr numBytes) {
+    return numBytes >= sizeof(precompiledModuleMagic) &&
+           !memcmp(bytes, precompiledModuleMagic, sizeof(precompiledModuleMagic));
+}
+
+void Runtime::saveCompiledModule(ModuleConstRefParam module, Serialization::OutputStream &stream) {
+    // The object code of a module compiled with linked modules refers to their code, which the
+    // artifact can't reference.
+    errorUnless(!module->compileOptions.linkedModules.size());
+
+    Serialization::serializeBytes(stream, (const U8 *) precompiledModuleMagic, sizeof(precompiledModuleMagic));
+
+    U32 version = precompiledModuleVersion;
+    Serialization::serialize(stream, version);
+
+    std::string targetSpec = LLVMJIT::getHostTargetSpec();
+    Serialization::serialize(stream, targetSpec);
+
+    LLVMJIT::CompileOptions compileOptions = module->compileOptions;
+    serialize(stream, compileOptions);
+
+    IR::serializeModule(stream, module->ir);
+
+    U64 numObjectCodeBytes = module->objectCode.size();
+    Serialization::serialize(stream, numObjectCodeBytes);
+    Serialization::serializeBytes(stream, module->objectCode.data(), module->objectCode.size());
+}
+
+// Loads a precompiled module. If backingBuffer is set, the stream reads from it, and the byte arrays
+// of the IR are views of it.
+static ModuleRef loadPrecompiledModuleImpl(Serialization::InputStream &stream, std::shared_ptr<const void> &&backingBuffer) {
+    const U8 *magic = stream.advance(sizeof(precompiledModuleMagic));
+    if (!isPrecompiledModule(magic, sizeof(precompiledModuleMagic))) {
+        throw Serialization::FatalSerializationException("not a precompiled WAVM module");
+    }
+
+    U32 version = 0;
+    Serialization::serialize(stream, version);
+    if (version != precompiledModuleVersion) {
+        throw Serialization::FatalSerializationException("unsupported precompiled module version");
+    }
+
+    std::string targetSpec;
+    Serialization::serialize(stream, targetSpec);
+
+    LLVMJIT::CompileOptions compileOptions;
+    serialize(stream, compileOptions);
+
+    IR::Module irModule;
+    irModule.backingBuffer = std::move(backingBuffer);
+    IR::deserializeModule(stream, irModule);
+
+    U64 numObjectCodeBytes = 0;
+    Serialization::serialize(stream, numObjectCodeBytes);
+    const U8 *objectCodeBytes = stream.advance(Uptr(numObjectCodeBytes));
+
+    // Object code compiled for another target can't be loaded, but the IR is still usable.
+    std::vector<U8> objectCode;
+    if (targetSpec == LLVMJIT::getHostTargetSpec()) {
+        objectCode.assign(objectCodeBytes, objectCodeBytes + numObjectCodeBytes);
+    } else {
+        objectCode = compileModuleWithObjectCache(irModule, compileOptions);
+    }
+
+    return std::make_shared<Runtime::Module>(std::move(irModule), std::move(objectCode), compileOptions);
+}
+
+ModuleRef Runtime::loadPrecompiledModule(Serialization::InputStream &stream) {
+    return loadPrecompiledModuleImpl(stream, nullptr);
+}
+
+ModuleRef Runtime::loadPrecompiledModule(const U8 *bytes, Uptr numBytes, std::shared_ptr<const void> backingBuffer) {
+    Serialization::MemoryInputStream stream(bytes, numBytes);
+    return loadPrecompiledModuleImpl(stream, std::move(backingBuffer));
 }
 
 ModuleInstance::~ModuleInstance() {
+    // When the last instance sharing the tier-up state is destroyed, tell the tier-up thread not to
+    // install recompiled code for it, and release the recompiled code that was already installed.
+    if (tierUpState) {
+        Lock<Platform::Mutex> tierUpLock(tierUpState->mutex);
+        wavmAssert(tierUpState->numInstances > 0);
+        if (--tierUpState->numInstances == 0) {
+            tierUpState->isInstanceDestroyed = true;
+            tierUpState->tieredJITModules.clear();
+        }
+    }
+
     if (id != UINTPTR_MAX) {
         compartment->moduleInstances.removeOrFail(id);
     }
+
+    releaseCompartmentMemory(compartment, CompartmentMemoryKind::code, numChargedCodeBytes);
+}
+
+static LLVMJIT::GlobalBinding getGlobalBinding(const Global *global) {
+    LLVMJIT::GlobalBinding globalSpec;
+    globalSpec.type = global->type;
+    if (global->type.isMutable) {
+        globalSpec.mutableGlobalIndex = global->mutableGlobalIndex;
+    } else {
+        globalSpec.immutableValuePointer = &global->initialValue;
+    }
+    return globalSpec;
+}
+
+// Finds the instance of each of the module's linked modules that its resolved function imports are
+// imported from. Returns false if an import isn't the function definition it was compiled against,
+// or the imports of a linked module aren't all from the same instance of it, in which case the
+// module can't be instantiated with the imports.
+static bool getLinkedModuleInstances(Compartment *compartment, const Runtime::Module &module, const std::vector<Function *> &functionImports, std::vector<ModuleInstance *> &outLinkedModuleInstances) {
+    const LLVMJIT::CompileOptions &options = module.compileOptions;
+    outLinkedModuleInstances.assign(options.linkedModules.size(), nullptr);
+    for (Uptr importIndex = 0; importIndex < options.linkedFunctionImports.size(); ++importIndex) {
+        const LLVMJIT::LinkedFunctionImport &linkedImport = options.linkedFunctionImports[importIndex];
+        if (linkedImport.linkedModuleIndex == UINTPTR_MAX) {
+            continue;
+        }
+
+        const IR::Module &linkedIR = *options.linkedModules[linkedImport.linkedModuleIndex];
+        Function *function = functionImports[importIndex];
+        ModuleInstance *moduleInstance = nullptr;
+        {
+            Lock<Platform::Mutex> compartmentLock(compartment->mutex);
+            if (function->moduleInstanceId == UINTPTR_MAX || !compartment->moduleInstances.contains(function->moduleInstanceId)) {
+                return false;
+            }
+            moduleInstance = compartment->moduleInstances[function->moduleInstanceId];
+        }
+        if (!moduleInstance || !moduleInstance->module || &moduleInstance->module->ir != &linkedIR ||
+            moduleInstance->functions[linkedIR.functions.imports.size() + linkedImport.functionDefIndex] != function) {
+            return false;
+        }
+
+        ModuleInstance *&linkedModuleInstance = outLinkedModuleInstances[linkedImport.linkedModuleIndex];
+        if (linkedModuleInstance && linkedModuleInstance != moduleInstance) {
+            return false;
+        }
+        linkedModuleInstance = moduleInstance;
+    }
+
+    // The code refers to each linked module's instance, so each must be imported from.
+    for (ModuleInstance *moduleInstance : outLinkedModuleInstances) {
+        if (!moduleInstance) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static std::vector<LLVMJIT::LinkedModuleBinding> getLinkedModuleBindings(const std::vector<ModuleInstance *> &linkedModuleInstances) {
+    std::vector<LLVMJIT::LinkedModuleBinding> linkedModuleBindings;
+    for (ModuleInstance *moduleInstance : linkedModuleInstances) {
+        const IR::Module &linkedIR = moduleInstance->module->ir;
+
+        LLVMJIT::LinkedModuleBinding binding;
+        binding.types = linkedIR.types;
+        for (Uptr functionIndex = 0; functionIndex < moduleInstance->functions.size(); ++functionIndex) {
+            Function *function = moduleInstance->functions[functionIndex];
+            const LLVMJIT::FunctionBinding functionBinding{CallingConvention::wasm, const_cast<U8 *>(function->code)};
+            if (functionIndex < linkedIR.functions.imports.size()) {
+                binding.functionImports.push_back(functionBinding);
+            } else {
+                binding.functionDefs.push_back(functionBinding);
+                binding.functionDefMutableDatas.push_back(function->mutableData);
+            }
+        }
+        for (Table *table : moduleInstance->tables) {
+            binding.tables.push_back({table->id});
+        }
+        for (Memory *memory : moduleInstance->memories) {
+            binding.memories.push_back({memory->id});
+        }
+        for (Global *global : moduleInstance->globals) {
+            binding.globals.push_back(getGlobalBinding(global));
+        }
+        for (Runtime::ExceptionType *exceptionType : moduleInstance->exceptionTypes) {
+            binding.exceptionTypes.push_back({exceptionType->id});
+        }
+        binding.moduleInstance = {moduleInstance->id};
+        binding.tableReferenceBias = reinterpret_cast<Uptr>(getUninitializedElement());
+        linkedModuleBindings.push_back(std::move(binding));
+    }
+    return linkedModuleBindings;
+}
+
+// Frees the module instance ID reserved by instantiateModuleImpl when the instantiation fails.
+static void removeModuleInstanceId(Compartment *compartment, Uptr id) {
+    Lock<Platform::Mutex> compartmentLock(compartment->mutex);
+    compartment->moduleInstances.removeOrFail(id);
 }
 
 ModuleInstance *Runtime::instantiateModule(Compartment *compartment, ModuleConstRefParam module, ImportBindings &&imports, std::string &&moduleDebugName) {
+    return instantiateModuleImpl(compartment, module, std::move(imports), nullptr, std::move(moduleDebugName));
+}
+
+ModuleInstance *Runtime::instantiateModuleImpl(Compartment *compartment, ModuleConstRefParam module, ImportBindings &&imports, const InstanceSnapshot *snapshot, std::string &&moduleDebugName) {
+    wavmAssert(!snapshot || snapshot->module == module);
+    MetricTimer instantiateTimer(Metrics::Histogram::instantiateMicroseconds);
+    addToMetric(Metrics::Counter::numInstantiations);
+
     Uptr id = UINTPTR_MAX;
     {
         Lock<Platform::Mutex> compartmentLock(compartment->mutex);
@@ -67,6 +495,14 @@ ModuleInstance *Runtime::instantiateModule(Compartment *compartment, ModuleConst
         errorUnless(isInCompartment(importObject, compartment));
     }
 
+    // If the module was compiled with linked modules, check that its imports are from instances of
+    // them, before anything else is created for the instance.
+    std::vector<ModuleInstance *> linkedModuleInstances;
+    if (!getLinkedModuleInstances(compartment, *module, functions, linkedModuleInstances)) {
+        removeModuleInstanceId(compartment, id);
+        return nullptr;
+    }
+
     std::vector<Table *> tables = std::move(imports.tables);
     errorUnless(tables.size() == module->ir.tables.imports.size());
     for (Uptr importIndex = 0; importIndex < module->ir.tables.imports.size(); ++importIndex) {
@@ -81,6 +517,10 @@ ModuleInstance *Runtime::instantiateModule(Compartment *compartment, ModuleConst
         Object *importObject = asObject(memories[importIndex]);
         errorUnless(isA(importObject, module->ir.memories.getType(importIndex)));
         errorUnless(isInCompartment(importObject, compartment));
+
+        // Code compiled without explicit bounds checks relies on the memory reserving enough
+        // address space for any address it can access.
+        errorUnless(!memories[importIndex]->hasBoundedReservation || module->compileOptions.explicitMemoryBoundsChecks);
     }
 
     std::vector<Global *> globals = std::move(imports.globals);
@@ -99,26 +539,64 @@ ModuleInstance *Runtime::instantiateModule(Compartment *compartment, ModuleConst
         errorUnless(isInCompartment(importObject, compartment));
     }
 
-    // Deserialize the disassembly names.
-    DisassemblyNames disassemblyNames;
-    getDisassemblyNames(module->ir, disassemblyNames);
-
-    // Instantiate the module's memory and table definitions.
+    // Get the disassembly names, unless debug names are disabled.
+    const bool useDebugNames = areDebugNamesEnabled.load(std::memory_order_relaxed);
+    static const DisassemblyNames emptyDisassemblyNames;
+    const DisassemblyNames &disassemblyNames = useDebugNames ? getModuleDisassemblyNames(*module) : emptyDisassemblyNames;
+
+    // Instantiate the module's memory and table definitions. If the module's code was compiled with
+    // explicit memory bounds checks, its memories only reserve address space for their maximum size.
+    // If a table or memory can't be created within the compartment's memory limit, the
+    // instantiation fails; the tables and memories that were already created are freed by the next
+    // garbage collection.
+    const bool boundedMemoryReservations = module->compileOptions.explicitMemoryBoundsChecks;
     for (Uptr tableDefIndex = 0; tableDefIndex < module->ir.tables.defs.size(); ++tableDefIndex) {
-        std::string debugName = disassemblyNames.tables[module->ir.tables.imports.size() + tableDefIndex];
+        std::string debugName = useDebugNames ? disassemblyNames.tables[module->ir.tables.imports.size() + tableDefIndex] : std::string();
         auto table = createTable(compartment, module->ir.tables.defs[tableDefIndex].type, std::move(debugName));
+        if (!table) {
+            removeModuleInstanceId(compartment, id);
+            return nullptr;
+        }
+
+        // A table that grew before it was snapshotted is grown to the same size, so all of its
+        // elements are restored.
+        if (snapshot && !snapshot->tableDefFunctionIndices.empty()) {
+            const Uptr numSnapshotElements = snapshot->tableDefFunctionIndices[tableDefIndex].size();
+            const Uptr numElements = getTableNumElements(table);
+            if (numSnapshotElements > numElements && growTable(table, numSnapshotElements - numElements) == -1) {
+                removeModuleInstanceId(compartment, id);
+                return nullptr;
+            }
+        }
         tables.push_back(table);
     }
     for (Uptr memoryDefIndex = 0; memoryDefIndex < module->ir.memories.defs.size(); ++memoryDefIndex) {
-        std::string debugName = disassemblyNames.memories[module->ir.memories.imports.size() + memoryDefIndex];
-        auto memory = createMemory(compartment, module->ir.memories.defs[memoryDefIndex].type, std::move(debugName));
+        std::string debugName = useDebugNames ? disassemblyNames.memories[module->ir.memories.imports.size() + memoryDefIndex] : std::string();
+        const MemoryType &memoryType = module->ir.memories.defs[memoryDefIndex].type;
+        Memory *memory;
+        if (snapshot) {
+            const InstanceSnapshot::MemoryDefSnapshot &memorySnapshot = snapshot->memoryDefs[memoryDefIndex];
+            memory = createMemoryFromPageFile(compartment, memoryType, memorySnapshot.pageFile, memorySnapshot.numPages, boundedMemoryReservations, std::move(debugName));
+        } else {
+            memory = createMemory(compartment, memoryType, std::move(debugName), false, boundedMemoryReservations);
+        }
+        if (!memory) {
+            removeModuleInstanceId(compartment, id);
+            return nullptr;
+        }
 
         memories.push_back(memory);
     }
 
     // Instantiate the module's global definitions.
-    for (const GlobalDef &globalDef : module->ir.globals.defs) {
-        const Value initialValue = evaluateInitializer(globals, globalDef.initializer);
+    for (Uptr globalDefIndex = 0; globalDefIndex < module->ir.globals.defs.size(); ++globalDefIndex) {
+        const GlobalDef &globalDef = module->ir.globals.defs[globalDefIndex];
+        Value initialValue;
+        if (snapshot && !isReferenceType(globalDef.type.valueType)) {
+            initialValue = snapshot->globalDefValues[globalDefIndex];
+        } else {
+            initialValue = evaluateInitializer(globals, globalDef.initializer);
+        }
         errorUnless(isSubtype(initialValue.type, globalDef.type.valueType));
         globals.push_back(createGlobal(compartment, globalDef.type, initialValue));
     }
@@ -127,8 +605,7 @@ ModuleInstance *Runtime::instantiateModule(Compartment *compartment, ModuleConst
     for (Uptr exceptionTypeDefIndex = 0;
          exceptionTypeDefIndex < module->ir.exceptionTypes.defs.size(); ++exceptionTypeDefIndex) {
         const ExceptionTypeDef &exceptionTypeDef = module->ir.exceptionTypes.defs[exceptionTypeDefIndex];
-        std::string debugName = disassemblyNames.exceptionTypes[module->ir.exceptionTypes.imports.size() +
-                                                                exceptionTypeDefIndex];
+        std::string debugName = useDebugNames ? disassemblyNames.exceptionTypes[module->ir.exceptionTypes.imports.size() + exceptionTypeDefIndex] : std::string();
     }
 
     // Set up the values to bind to the symbols in the LLVMJIT object code.
@@ -156,14 +633,7 @@ ModuleInstance *Runtime::instantiateModule(Compartment *compartment, ModuleConst
 
     std::vector<LLVMJIT::GlobalBinding> jitGlobals;
     for (Global *global : globals) {
-        LLVMJIT::GlobalBinding globalSpec;
-        globalSpec.type = global->type;
-        if (global->type.isMutable) {
-            globalSpec.mutableGlobalIndex = global->mutableGlobalIndex;
-        } else {
-            globalSpec.immutableValuePointer = &global->initialValue;
-        }
-        jitGlobals.push_back(globalSpec);
+        jitGlobals.push_back(getGlobalBinding(global));
     }
 
     std::vector<LLVMJIT::ExceptionTypeBinding> jitExceptionTypes;
@@ -171,28 +641,55 @@ ModuleInstance *Runtime::instantiateModule(Compartment *compartment, ModuleConst
         jitExceptionTypes.push_back({exceptionType->id});
     }
 
-    // Create a FunctionMutableData for each function definition.
-    std::vector<FunctionMutableData *> functionDefMutableDatas;
-    for (Uptr functionDefIndex = 0; functionDefIndex < module->ir.functions.defs.size(); ++functionDefIndex) {
-        std::string debugName = disassemblyNames.functions[module->ir.functions.imports.size() + functionDefIndex].name;
-        if (!debugName.size()) {
-            debugName = "<function #" + std::to_string(functionDefIndex) + ">";
-        }
-        debugName = "wasm!" + moduleDebugName + '!' + debugName;
+    // Create a FunctionMutableData for each function definition, in a slab that is owned by the
+    // loaded code, with the names shared by the module's instances.
+    const Uptr numFunctionDefs = module->ir.functions.defs.size();
+    std::unique_ptr<FunctionMutableDataSlab> functionDefMutableDataSlab(new FunctionMutableDataSlab(numFunctionDefs, useDebugNames ? getFunctionDefDebugNames(*module, moduleDebugName) : nullptr));
+    std::vector<FunctionMutableData *> functionDefMutableDatas(numFunctionDefs);
+    for (Uptr functionDefIndex = 0; functionDefIndex < numFunctionDefs; ++functionDefIndex) {
+        functionDefMutableDatas[functionDefIndex] = functionDefMutableDataSlab->get(functionDefIndex);
+    }
 
-        functionDefMutableDatas.push_back(new FunctionMutableData(std::move(debugName)));
+    // If the module was compiled with tier-up, lazy compilation or the interpreter enabled, keep a
+    // copy of the bindings for loading the object code of recompiled or lazily compiled functions.
+    std::shared_ptr<TierUpState> tierUpState;
+    if (module->compileOptions.enableTierUp || module->compileOptions.enableLazyCompilation || module->compileOptions.enableInterpreter) {
+        tierUpState = std::make_shared<TierUpState>();
+        tierUpState->module = module;
+        tierUpState->wavmIntrinsicsExportMap = wavmIntrinsicsExportMap;
+        tierUpState->functionImports = jitFunctionImports;
+        tierUpState->tables = jitTables;
+        tierUpState->memories = jitMemories;
+        tierUpState->globals = jitGlobals;
+        tierUpState->exceptionTypes = jitExceptionTypes;
+        tierUpState->moduleInstanceId = id;
+        tierUpState->tableReferenceBias = reinterpret_cast<Uptr>(getUninitializedElement());
+        tierUpState->numaNode = compartment->numaNode;
     }
 
     // Load the compiled module's object code with this module instance's imports.
     std::vector<FunctionType> jitTypes = module->ir.types;
     std::vector<Runtime::Function *> jitFunctionDefs;
     jitFunctionDefs.resize(module->ir.functions.defs.size(), nullptr);
-    std::shared_ptr<LLVMJIT::Module> jitModule = LLVMJIT::loadModule(module->objectCode, std::move(wavmIntrinsicsExportMap), std::move(jitTypes), std::move(jitFunctionImports), std::move(jitTables), std::move(jitMemories), std::move(jitGlobals), std::move(jitExceptionTypes), {id}, reinterpret_cast<Uptr>(getOutOfBoundsElement()), functionDefMutableDatas);
+    std::vector<LLVMJIT::LinkedModuleBinding> jitLinkedModules = getLinkedModuleBindings(linkedModuleInstances);
+    std::shared_ptr<LLVMJIT::Module> jitModule = LLVMJIT::loadModule(module->objectCode, std::move(wavmIntrinsicsExportMap), std::move(jitTypes), std::move(jitFunctionImports), {}, std::move(jitTables), std::move(jitMemories), std::move(jitGlobals), std::move(jitExceptionTypes), {id}, reinterpret_cast<Uptr>(getUninitializedElement()), functionDefMutableDatas, compartment->numaNode, std::move(jitLinkedModules), std::move(functionDefMutableDataSlab));
+
+    // Charge the loaded code to the compartment. If that would exceed the compartment's memory
+    // limit, unload the code, which also frees the functions' FunctionMutableData objects.
+    const Uptr numCodeBytes = LLVMJIT::getModuleNumImageBytes(jitModule.get());
+    if (!tryChargeCompartmentMemory(compartment, CompartmentMemoryKind::code, numCodeBytes)) {
+        jitModule.reset();
+        removeModuleInstanceId(compartment, id);
+        return nullptr;
+    }
 
     // LLVMJIT::loadModule filled in the functionDefMutableDatas' function pointers with the
     // compiled functions. Add those functions to the module.
     for (FunctionMutableData *functionMutableData : functionDefMutableDatas) {
         functions.push_back(functionMutableData->function);
+        if (tierUpState) {
+            tierUpState->functionDefs.push_back(functionMutableData->function);
+        }
     }
 
     // Set up the instance's exports.
@@ -221,43 +718,40 @@ ModuleInstance *Runtime::instantiateModule(Compartment *compartment, ModuleConst
         exportMap.addOrFail(exportIt.name, exportedObject);
     }
 
-    // Copy the module's passive data and table segments into the ModuleInstance for later use.
-    PassiveDataSegmentMap passiveDataSegments;
-    PassiveElemSegmentMap passiveElemSegments;
-    for (Uptr segmentIndex = 0; segmentIndex < module->ir.dataSegments.size(); ++segmentIndex) {
-        const DataSegment &dataSegment = module->ir.dataSegments[segmentIndex];
-        if (!dataSegment.isActive) {
-            passiveDataSegments.add(segmentIndex, std::make_shared<std::vector<U8>>(dataSegment.data));
-        }
+    // The instance refers to the contents of the module's passive segments instead of copying them,
+    // so it only needs to track which segments have been dropped. Active segments may not be used
+    // by memory.init or table.init, so they start out dropped.
+    std::vector<bool> droppedDataSegments;
+    for (const DataSegment &dataSegment : module->ir.dataSegments) {
+        droppedDataSegments.push_back(dataSegment.isActive);
     }
-    for (Uptr segmentIndex = 0; segmentIndex < module->ir.elemSegments.size(); ++segmentIndex) {
-        const ElemSegment &elemSegment = module->ir.elemSegments[segmentIndex];
-        if (!elemSegment.isActive) {
-            auto passiveElemSegmentObjects = std::make_shared<std::vector<Object *>>();
-            for (Uptr functionIndex : elemSegment.indices) {
-                passiveElemSegmentObjects->push_back(asObject(functions[functionIndex]));
-            }
-            passiveElemSegments.add(segmentIndex, passiveElemSegmentObjects);
-        }
+    std::vector<bool> droppedElemSegments;
+    for (const ElemSegment &elemSegment : module->ir.elemSegments) {
+        droppedElemSegments.push_back(elemSegment.isActive);
     }
 
     // Look up the module's start function.
+    // An instance created from a snapshot doesn't run the start function again.
     Function *startFunction = nullptr;
-    if (module->ir.startFunctionIndex != UINTPTR_MAX) {
+    if (module->ir.startFunctionIndex != UINTPTR_MAX && !snapshot) {
         startFunction = functions[module->ir.startFunctionIndex];
         wavmAssert(FunctionType(startFunction->encodedType) == FunctionType());
     }
 
     // Create the ModuleInstance and add it to the compartment's modules list.
-    ModuleInstance *moduleInstance = new ModuleInstance(compartment, id, std::move(exportMap), std::move(functions), std::move(tables), std::move(memories), std::move(globals), std::move(exceptionTypes), startFunction, std::move(passiveDataSegments), std::move(passiveElemSegments), std::move(jitModule), std::move(moduleDebugName));
+    ModuleInstance *moduleInstance = new ModuleInstance(compartment, id, std::move(exportMap), std::move(functions), std::move(tables), std::move(memories), std::move(globals), std::move(exceptionTypes), startFunction, module, std::move(droppedDataSegments), std::move(droppedElemSegments), std::move(jitModule), std::move(moduleDebugName));
+    moduleInstance->tierUpState = std::move(tierUpState);
+    moduleInstance->numChargedCodeBytes = numCodeBytes;
     {
         Lock<Platform::Mutex> compartmentLock(compartment->mutex);
         compartment->moduleInstances[id] = moduleInstance;
     }
 
-    // Copy the module's data segments into their designated memory instances.
+    // Copy the module's data segments into their designated memory instances. The memories defined
+    // by an instance created from a snapshot already contain them.
     for (const DataSegment &dataSegment : module->ir.dataSegments) {
-        if (dataSegment.isActive) {
+        const bool isSnapshotMemory = snapshot && dataSegment.memoryIndex >= module->ir.memories.imports.size();
+        if (dataSegment.isActive && !isSnapshotMemory) {
             Memory *memory = moduleInstance->memories[dataSegment.memoryIndex];
 
             const Value baseOffsetValue = evaluateInitializer(moduleInstance->globals, dataSegment.baseOffset);
@@ -271,9 +765,12 @@ ModuleInstance *Runtime::instantiateModule(Compartment *compartment, ModuleConst
         }
     }
 
-    // Copy the module's elem segments into their designated table instances.
+    // Copy the module's elem segments into their designated table instances. The tables defined by
+    // an instance created from a snapshot that captured them are initialized from the snapshot.
+    const bool hasSnapshotTables = snapshot && !snapshot->tableDefFunctionIndices.empty();
     for (const ElemSegment &elemSegment : module->ir.elemSegments) {
-        if (elemSegment.isActive) {
+        const bool isSnapshotTable = hasSnapshotTables && elemSegment.tableIndex >= module->ir.tables.imports.size();
+        if (elemSegment.isActive && !isSnapshotTable) {
             Table *table = moduleInstance->tables[elemSegment.tableIndex];
 
             const Value baseOffsetValue = evaluateInitializer(moduleInstance->globals, elemSegment.baseOffset);
@@ -290,6 +787,9 @@ ModuleInstance *Runtime::instantiateModule(Compartment *compartment, ModuleConst
             }
         }
     }
+    if (hasSnapshotTables) {
+        initTableDefsFromSnapshot(moduleInstance, *snapshot);
+    }
 
     return moduleInstance;
 }
@@ -301,5 +801,70 @@ Function *Runtime::getStartFunction(ModuleInstance *moduleInstance) {
 Object *Runtime::getInstanceExport(ModuleInstance *moduleInstance, const std::string &name) {
     wavmAssert(moduleInstance);
     Object *const *exportedObjectPtr = moduleInstance->exportMap.get(name);
+    if (!exportedObjectPtr && moduleInstance->sharedExports) {
+        exportedObjectPtr = moduleInstance->sharedExports->exportMap.get(name);
+    }
     return exportedObjectPtr ? *exportedObjectPtr : nullptr;
 }
+
+ModuleInstance *Runtime::cloneModuleInstance(ModuleInstance *moduleInstance, Compartment *newCompartment) {
+    // Remap the module instance's references to objects in the new compartment.
+    HashMap<std::string, Object *> newExportMap;
+    for (const auto &pair : moduleInstance->exportMap) {
+        newExportMap.add(pair.key, remapToClonedCompartment(pair.value, newCompartment));
+    }
+    std::vector<Function *> newFunctions = moduleInstance->functions;
+    std::vector<Table *> newTables;
+    for (Table *table : moduleInstance->tables) {
+        newTables.push_back(asTable(remapToClonedCompartment(asObject(table), newCompartment)));
+    }
+    std::vector<Memory *> newMemories;
+    for (Memory *memory : moduleInstance->memories) {
+        newMemories.push_back(asMemory(remapToClonedCompartment(asObject(memory), newCompartment)));
+    }
+    std::vector<Global *> newGlobals;
+    for (Global *global : moduleInstance->globals) {
+        newGlobals.push_back(asGlobal(remapToClonedCompartment(asObject(global), newCompartment)));
+    }
+    std::vector<ExceptionType *> newExceptionTypes;
+    for (ExceptionType *exceptionType : moduleInstance->exceptionTypes) {
+        newExceptionTypes.push_back(asExceptionType(remapToClonedCompartment(asObject(exceptionType), newCompartment)));
+    }
+
+    // The passive segments' contents are owned by the module, so the clone only copies which of
+    // them have been dropped. The elem segments only contain functions, which are shared by the
+    // clones.
+    std::vector<bool> newDroppedDataSegments;
+    std::vector<bool> newDroppedElemSegments;
+    {
+        Lock<Platform::Mutex> droppedSegmentsLock(moduleInstance->droppedSegmentsMutex);
+        newDroppedDataSegments = moduleInstance->droppedDataSegments;
+        newDroppedElemSegments = moduleInstance->droppedElemSegments;
+    }
+
+    // Create the new ModuleInstance in the cloned compartment with the same ID and JIT module as the
+    // original, so the generated code that refers to it by ID is shared.
+    std::shared_ptr<LLVMJIT::Module> jitModule = moduleInstance->jitModule;
+    std::string debugName = moduleInstance->debugName;
+    ModuleInstance *newModuleInstance = new ModuleInstance(newCompartment, moduleInstance->id, std::move(newExportMap), std::move(newFunctions), std::move(newTables), std::move(newMemories), std::move(newGlobals), std::move(newExceptionTypes), moduleInstance->startFunction, moduleInstance->module, std::move(newDroppedDataSegments), std::move(newDroppedElemSegments), std::move(jitModule), std::move(debugName));
+
+    newModuleInstance->sharedExports = moduleInstance->sharedExports;
+
+    // The clone shares the original's code, but the code is charged to both compartments, since
+    // either may outlive the other.
+    chargeCompartmentMemory(newCompartment, CompartmentMemoryKind::code, moduleInstance->numChargedCodeBytes);
+    newModuleInstance->numChargedCodeBytes = moduleInstance->numChargedCodeBytes;
+
+    if (moduleInstance->tierUpState) {
+        Lock<Platform::Mutex> tierUpLock(moduleInstance->tierUpState->mutex);
+        ++moduleInstance->tierUpState->numInstances;
+        newModuleInstance->tierUpState = moduleInstance->tierUpState;
+    }
+
+    {
+        Lock<Platform::Mutex> compartmentLock(newCompartment->mutex);
+        newCompartment->moduleInstances.insertOrFail(newModuleInstance->id, newModuleInstance);
+    }
+
+    return newModuleInstance;
+}
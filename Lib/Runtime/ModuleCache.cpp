@@ -0,0 +1,177 @@
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "RuntimePrivate.h"
+#include "WAVM/IR/Module.h"
+#include "WAVM/Inline/Hash.h"
+#include "WAVM/Inline/HashMap.h"
+#include "WAVM/Inline/Serialization.h"
+#include "WAVM/LLVMJIT/LLVMJIT.h"
+
+using namespace WAVM;
+using namespace WAVM::IR;
+using namespace WAVM::Runtime;
+using namespace WAVM::Serialization;
+
+// An entry in the in-process module cache. The entry only holds a weak reference to its module, so
+// the cache doesn't keep modules alive: the module's deleter removes the entry.
+struct ModuleCacheEntry {
+    // The serialized IR module followed by the compile options. The whole key is compared on a
+    // lookup, so a hash collision can't return the wrong module.
+    std::vector<U8> key;
+
+    std::weak_ptr<Runtime::Module> module;
+
+    // Whether the thread that added the entry is still compiling the module. Other threads that
+    // look up the same key wait for it, instead of compiling the module again.
+    bool isCompiling = true;
+};
+
+struct ModuleCache {
+    std::mutex mutex;
+    std::condition_variable compileFinished;
+    HashMap<U64, std::vector<std::shared_ptr<ModuleCacheEntry>>> hashToEntriesMap;
+};
+
+static ModuleCache &getModuleCache() {
+    // The cache is never freed, so modules destroyed during process exit can still remove their
+    // entries.
+    static ModuleCache *cache = new ModuleCache;
+    return *cache;
+}
+
+static std::vector<U8> getModuleCacheKey(const IR::Module &irModule, const LLVMJIT::CompileOptions &options) {
+    ArrayOutputStream keyStream;
+    serializeModule(keyStream, irModule);
+
+    U8 optimizationLevel = U8(options.optimizationLevel);
+    U8 enableTierUp = options.enableTierUp ? 1 : 0;
+    U8 tierUpOptimizationLevel = U8(options.tierUpOptimizationLevel);
+    U64 tierUpCallThreshold = options.tierUpCallThreshold;
+    U8 explicitMemoryBoundsChecks = options.explicitMemoryBoundsChecks ? 1 : 0;
+    U8 nonVolatileMemoryAccesses = options.nonVolatileMemoryAccesses ? 1 : 0;
+    U8 enableInterruptChecks = options.enableInterruptChecks ? 1 : 0;
+    U8 enableFuelMetering = options.enableFuelMetering ? 1 : 0;
+    U8 enableLazyCompilation = options.enableLazyCompilation ? 1 : 0;
+    U8 enableInterpreter = options.enableInterpreter ? 1 : 0;
+    U8 enableFramePointers = options.enableFramePointers ? 1 : 0;
+    U8 enableCallCounters = options.enableCallCounters ? 1 : 0;
+    U8 enableCallTiming = options.enableCallTiming ? 1 : 0;
+    Serialization::serialize(keyStream, optimizationLevel);
+    Serialization::serialize(keyStream, enableTierUp);
+    Serialization::serialize(keyStream, tierUpOptimizationLevel);
+    Serialization::serialize(keyStream, tierUpCallThreshold);
+    Serialization::serialize(keyStream, explicitMemoryBoundsChecks);
+    Serialization::serialize(keyStream, nonVolatileMemoryAccesses);
+    Serialization::serialize(keyStream, enableInterruptChecks);
+    Serialization::serialize(keyStream, enableFuelMetering);
+    Serialization::serialize(keyStream, enableLazyCompilation);
+    Serialization::serialize(keyStream, enableInterpreter);
+    Serialization::serialize(keyStream, enableFramePointers);
+    Serialization::serialize(keyStream, enableCallCounters);
+    Serialization::serialize(keyStream, enableCallTiming);
+    std::vector<U64> functionDefCallCounts = options.functionDefCallCounts;
+    Serialization::serialize(keyStream, functionDefCallCounts);
+    U8 enableProfileCounters = options.enableProfileCounters ? 1 : 0;
+    U8 hasProfile = options.profile ? 1 : 0;
+    Serialization::serialize(keyStream, enableProfileCounters);
+    Serialization::serialize(keyStream, hasProfile);
+    if (options.profile) {
+        saveModuleProfile(*options.profile, keyStream);
+    }
+
+    return keyStream.getBytes();
+}
+
+// Removes an entry from the cache. The caller must hold the cache's mutex.
+static void removeModuleCacheEntry(ModuleCache &cache, U64 hash, const ModuleCacheEntry *entry) {
+    if (!cache.hashToEntriesMap.contains(hash)) {
+        return;
+    }
+
+    std::vector<std::shared_ptr<ModuleCacheEntry>> &entries = cache.hashToEntriesMap.getOrAdd(hash);
+    for (auto entryIt = entries.begin(); entryIt != entries.end(); ++entryIt) {
+        if (entryIt->get() == entry) {
+            entries.erase(entryIt);
+            break;
+        }
+    }
+    if (!entries.size()) {
+        cache.hashToEntriesMap.removeOrFail(hash);
+    }
+}
+
+ModuleRef Runtime::compileModuleWithModuleCache(const IR::Module &irModule, const LLVMJIT::CompileOptions &options) {
+    ModuleCache &cache = getModuleCache();
+
+    std::vector<U8> key = getModuleCacheKey(irModule, options);
+    const U64 hash = XXH<U64>(key.data(), key.size(), 0);
+
+    // Look for a live module with the same key, or wait for another thread that is compiling one.
+    std::shared_ptr<ModuleCacheEntry> entry;
+    {
+        std::unique_lock<std::mutex> cacheLock(cache.mutex);
+        while (true) {
+            std::vector<std::shared_ptr<ModuleCacheEntry>> &entries = cache.hashToEntriesMap.getOrAdd(hash);
+
+            std::shared_ptr<ModuleCacheEntry> matchingEntry;
+            for (const std::shared_ptr<ModuleCacheEntry> &otherEntry : entries) {
+                if (otherEntry->key == key) {
+                    matchingEntry = otherEntry;
+                    break;
+                }
+            }
+
+            if (!matchingEntry) {
+                break;
+            } else if (matchingEntry->isCompiling) {
+                // The entries may change while waiting, so look the key up again afterward.
+                cache.compileFinished.wait(cacheLock);
+            } else if (ModuleRef module = matchingEntry->module.lock()) {
+                return module;
+            } else {
+                // The module is being destroyed, but its deleter hasn't removed the entry yet.
+                removeModuleCacheEntry(cache, hash, matchingEntry.get());
+                break;
+            }
+        }
+
+        entry = std::make_shared<ModuleCacheEntry>();
+        entry->key = std::move(key);
+        cache.hashToEntriesMap.getOrAdd(hash).push_back(entry);
+    }
+
+    // Compile the module without holding the cache's mutex. The module's deleter removes the entry
+    // from the cache, and keeps the entry alive until then, so a later entry can't be allocated at
+    // the same address and removed in its place.
+    ModuleRef module;
+    try {
+        std::vector<U8> objectCode = compileModuleWithObjectCache(irModule, options);
+        module = ModuleRef(new Runtime::Module(IR::Module(irModule), std::move(objectCode), options), [hash, entry](Runtime::Module *deletedModule) {
+            {
+                ModuleCache &cache = getModuleCache();
+                std::lock_guard<std::mutex> cacheLock(cache.mutex);
+                removeModuleCacheEntry(cache, hash, entry.get());
+
+                // The entry's weak reference would keep this deleter, and so the entry, alive.
+                entry->module.reset();
+            }
+            delete deletedModule;
+        });
+    } catch (...) {
+        // If the compile failed, remove the entry, so a waiting thread compiles the module itself.
+        std::lock_guard<std::mutex> cacheLock(cache.mutex);
+        removeModuleCacheEntry(cache, hash, entry.get());
+        entry->isCompiling = false;
+        cache.compileFinished.notify_all();
+        throw;
+    }
+
+    std::lock_guard<std::mutex> cacheLock(cache.mutex);
+    entry->module = module;
+    entry->isCompiling = false;
+    cache.compileFinished.notify_all();
+    return module;
+}
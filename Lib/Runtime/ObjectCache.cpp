@@ -0,0 +1,243 @@
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "RuntimePrivate.h"
+#include "WAVM/IR/Module.h"
+#include "WAVM/Inline/Hash.h"
+#include "WAVM/Inline/Lock.h"
+#include "WAVM/Inline/Serialization.h"
+#include "WAVM/LLVMJIT/LLVMJIT.h"
+#include "WAVM/Platform/Mutex.h"
+#include "WAVM/Platform/Thread.h"
+
+using namespace WAVM;
+using namespace WAVM::IR;
+using namespace WAVM::Runtime;
+using namespace WAVM::Serialization;
+
+// The version of the cached object file format and of the code it contains. Bump this whenever a
+// change to WAVM makes previously cached object code incompatible: e.g. a change to the runtime
+// data layout or to the symbols the generated code imports.
+static constexpr U32 objectCacheVersion = 15;
+
+static const char objectCacheMagic[8] = {'W', 'A', 'V', 'M', 'O', 'B', 'J', 0};
+
+static Platform::Mutex &getObjectCacheMutex() {
+    static Platform::Mutex mutex;
+    return mutex;
+}
+
+static std::string objectCacheDirectory;
+
+void Runtime::setObjectCacheDirectory(std::string &&path) {
+    Lock<Platform::Mutex> lock(getObjectCacheMutex());
+    objectCacheDirectory = std::move(path);
+    while (objectCacheDirectory.size() > 1 && objectCacheDirectory.back() == '/') {
+        objectCacheDirectory.pop_back();
+    }
+}
+
+static std::string getObjectCacheDirectory() {
+    Lock<Platform::Mutex> lock(getObjectCacheMutex());
+    return objectCacheDirectory;
+}
+
+// The header written before the object code in a cache file. The target spec, options, and IR module
+// size are stored in addition to the hash, so a hash collision or a file copied between hosts is
+// detected instead of loading incompatible code.
+struct ObjectCacheHeader {
+    U32 version;
+    std::string targetSpec;
+    U8 optimizationLevel;
+    U8 enableTierUp;
+    U64 tierUpCallThreshold;
+    U8 explicitMemoryBoundsChecks;
+    U8 nonVolatileMemoryAccesses;
+    U8 enableInterruptChecks;
+    U8 enableFuelMetering;
+    U8 enableLazyCompilation;
+    U8 enableInterpreter;
+    U8 enableFramePointers;
+    U8 enableCallCounters;
+    U8 enableCallTiming;
+    U64 functionDefCallCountsHash;
+    U8 enableProfileCounters;
+    U64 profileHash;
+    U64 irModuleHash;
+    U64 irModuleNumBytes;
+};
+
+template<typename Stream> static void serialize(Stream &stream, ObjectCacheHeader &header) {
+    char magic[sizeof(objectCacheMagic)];
+    memcpy(magic, objectCacheMagic, sizeof(magic));
+    serializeBytes(stream, (U8 *) magic, sizeof(magic));
+    if (memcmp(magic, objectCacheMagic, sizeof(magic))) {
+        throw FatalSerializationException("not a WAVM object cache file");
+    }
+
+    Serialization::serialize(stream, header.version);
+    Serialization::serialize(stream, header.targetSpec);
+    Serialization::serialize(stream, header.optimizationLevel);
+    Serialization::serialize(stream, header.enableTierUp);
+    Serialization::serialize(stream, header.tierUpCallThreshold);
+    Serialization::serialize(stream, header.explicitMemoryBoundsChecks);
+    Serialization::serialize(stream, header.nonVolatileMemoryAccesses);
+    Serialization::serialize(stream, header.enableInterruptChecks);
+    Serialization::serialize(stream, header.enableFuelMetering);
+    Serialization::serialize(stream, header.enableLazyCompilation);
+    Serialization::serialize(stream, header.enableInterpreter);
+    Serialization::serialize(stream, header.enableFramePointers);
+    Serialization::serialize(stream, header.enableCallCounters);
+    Serialization::serialize(stream, header.enableCallTiming);
+    Serialization::serialize(stream, header.functionDefCallCountsHash);
+    Serialization::serialize(stream, header.enableProfileCounters);
+    Serialization::serialize(stream, header.profileHash);
+    Serialization::serialize(stream, header.irModuleHash);
+    Serialization::serialize(stream, header.irModuleNumBytes);
+}
+
+static bool readFileBytes(const std::string &path, std::vector<U8> &outBytes) {
+    FILE *file = fopen(path.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+
+    bool succeeded = false;
+    if (!fseek(file, 0, SEEK_END)) {
+        const long numBytes = ftell(file);
+        if (numBytes >= 0 && !fseek(file, 0, SEEK_SET)) {
+            outBytes.resize(Uptr(numBytes));
+            succeeded = fread(outBytes.data(), 1, outBytes.size(), file) == outBytes.size();
+        }
+    }
+
+    fclose(file);
+    return succeeded;
+}
+
+static bool writeFileBytes(const std::string &path, const std::vector<U8> &bytes) {
+    // Write to a temporary file and rename it over the destination, so concurrent processes never
+    // observe a partially written cache file.
+    const std::string tempPath = path + ".tmp" + std::to_string(Platform::getProcessId());
+    FILE *file = fopen(tempPath.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+
+    const bool wroteAllBytes = fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    if (fclose(file) || !wroteAllBytes || rename(tempPath.c_str(), path.c_str())) {
+        remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+// Compiles a module, and records the compile in the metrics.
+static std::vector<U8> compileModuleAndRecordMetrics(const IR::Module &irModule, const LLVMJIT::CompileOptions &options) {
+    std::vector<U8> objectCode;
+    {
+        MetricTimer compileTimer(Metrics::Histogram::moduleCompileMicroseconds);
+        objectCode = LLVMJIT::compileModule(irModule, options);
+    }
+    addToMetric(Metrics::Counter::numCompiledModules);
+    addToMetric(Metrics::Counter::numCompiledFunctions, irModule.functions.defs.size());
+    addToMetric(Metrics::Counter::numObjectCodeBytes, objectCode.size());
+    return objectCode;
+}
+
+std::vector<U8> Runtime::compileModuleWithObjectCache(const IR::Module &irModule, const LLVMJIT::CompileOptions &options) {
+    const std::string cacheDirectory = getObjectCacheDirectory();
+    if (!cacheDirectory.size()) {
+        return compileModuleAndRecordMetrics(irModule, options);
+    }
+
+    // The cache key is a hash of the serialized IR module, the host target, the compile options, and
+    // the cache version.
+    ArrayOutputStream irModuleStream;
+    serializeModule(irModuleStream, irModule);
+    const std::vector<U8> irModuleBytes = irModuleStream.getBytes();
+
+    ObjectCacheHeader expectedHeader;
+    expectedHeader.version = objectCacheVersion;
+    expectedHeader.targetSpec = LLVMJIT::getHostTargetSpec();
+    expectedHeader.optimizationLevel = U8(options.optimizationLevel);
+    expectedHeader.enableTierUp = options.enableTierUp ? 1 : 0;
+    expectedHeader.tierUpCallThreshold = options.enableTierUp ? options.tierUpCallThreshold : 0;
+    expectedHeader.explicitMemoryBoundsChecks = options.explicitMemoryBoundsChecks ? 1 : 0;
+    expectedHeader.nonVolatileMemoryAccesses = options.nonVolatileMemoryAccesses ? 1 : 0;
+    expectedHeader.enableInterruptChecks = options.enableInterruptChecks ? 1 : 0;
+    expectedHeader.enableFuelMetering = options.enableFuelMetering ? 1 : 0;
+    expectedHeader.enableLazyCompilation = options.enableLazyCompilation ? 1 : 0;
+    expectedHeader.enableInterpreter = options.enableInterpreter ? 1 : 0;
+    expectedHeader.enableFramePointers = options.enableFramePointers ? 1 : 0;
+    expectedHeader.enableCallCounters = options.enableCallCounters ? 1 : 0;
+    expectedHeader.enableCallTiming = options.enableCallTiming ? 1 : 0;
+    expectedHeader.functionDefCallCountsHash = options.functionDefCallCounts.size() ? XXH<U64>(options.functionDefCallCounts.data(), options.functionDefCallCounts.size() * sizeof(U64), options.functionDefCallCounts.size()) : 0;
+    expectedHeader.enableProfileCounters = options.enableProfileCounters ? 1 : 0;
+    expectedHeader.profileHash = 0;
+    if (options.profile) {
+        ArrayOutputStream profileStream;
+        saveModuleProfile(*options.profile, profileStream);
+        const std::vector<U8> profileBytes = profileStream.getBytes();
+        expectedHeader.profileHash = XXH<U64>(profileBytes.data(), profileBytes.size(), profileBytes.size());
+    }
+    expectedHeader.irModuleNumBytes = irModuleBytes.size();
+
+    // The tier-up optimization level isn't included: it doesn't affect the baseline object code.
+    const U64 optionsKey[15] = {expectedHeader.optimizationLevel, expectedHeader.enableTierUp, expectedHeader.tierUpCallThreshold, expectedHeader.explicitMemoryBoundsChecks, expectedHeader.nonVolatileMemoryAccesses, expectedHeader.enableInterruptChecks, expectedHeader.enableFuelMetering, expectedHeader.enableLazyCompilation, expectedHeader.enableInterpreter, expectedHeader.enableFramePointers, expectedHeader.enableCallCounters, expectedHeader.enableCallTiming, expectedHeader.functionDefCallCountsHash, expectedHeader.enableProfileCounters, expectedHeader.profileHash};
+    const U64 targetSpecHash = XXH<U64>(expectedHeader.targetSpec.data(), expectedHeader.targetSpec.size(), objectCacheVersion);
+    const U64 optionsHash = XXH<U64>(optionsKey, sizeof(optionsKey), targetSpecHash);
+    expectedHeader.irModuleHash = XXH<U64>(irModuleBytes.data(), irModuleBytes.size(), optionsHash);
+
+    char hashString[17];
+    snprintf(hashString, sizeof(hashString), "%016" PRIx64, expectedHeader.irModuleHash);
+    const std::string cachePath = cacheDirectory + '/' + hashString + ".wavmobj";
+
+    // Try to load the object code from the cache.
+    std::vector<U8> cacheFileBytes;
+    if (readFileBytes(cachePath, cacheFileBytes)) {
+        try {
+            MemoryInputStream stream(cacheFileBytes.data(), cacheFileBytes.size());
+            ObjectCacheHeader header;
+            serialize(stream, header);
+            if (header.version == expectedHeader.version && header.targetSpec == expectedHeader.targetSpec &&
+                header.optimizationLevel == expectedHeader.optimizationLevel &&
+                header.enableTierUp == expectedHeader.enableTierUp &&
+                header.tierUpCallThreshold == expectedHeader.tierUpCallThreshold &&
+                header.explicitMemoryBoundsChecks == expectedHeader.explicitMemoryBoundsChecks &&
+                header.nonVolatileMemoryAccesses == expectedHeader.nonVolatileMemoryAccesses &&
+                header.enableInterruptChecks == expectedHeader.enableInterruptChecks &&
+                header.enableFuelMetering == expectedHeader.enableFuelMetering &&
+                header.enableLazyCompilation == expectedHeader.enableLazyCompilation &&
+                header.enableInterpreter == expectedHeader.enableInterpreter &&
+                header.enableFramePointers == expectedHeader.enableFramePointers &&
+                header.enableCallCounters == expectedHeader.enableCallCounters &&
+                header.enableCallTiming == expectedHeader.enableCallTiming &&
+                header.functionDefCallCountsHash == expectedHeader.functionDefCallCountsHash &&
+                header.enableProfileCounters == expectedHeader.enableProfileCounters &&
+                header.profileHash == expectedHeader.profileHash &&
+                header.irModuleHash == expectedHeader.irModuleHash &&
+                header.irModuleNumBytes == expectedHeader.irModuleNumBytes) {
+                // The object code is the remainder of the file.
+                addToMetric(Metrics::Counter::numObjectCacheHits);
+                const Uptr numObjectCodeBytes = stream.capacity();
+                const U8 *objectCodeBytes = stream.advance(numObjectCodeBytes);
+                return std::vector<U8>(objectCodeBytes, objectCodeBytes + numObjectCodeBytes);
+            }
+        } catch (const FatalSerializationException &) {
+            // Treat a malformed cache file as a cache miss, and overwrite it below.
+        }
+    }
+
+    // On a cache miss, compile the module and try to store the result in the cache. Failing to
+    // write the cache file isn't fatal: the next compile will just miss again.
+    std::vector<U8> objectCode = compileModuleAndRecordMetrics(irModule, options);
+
+    ArrayOutputStream cacheFileStream;
+    serialize(cacheFileStream, expectedHeader);
+    serializeBytes(cacheFileStream, objectCode.data(), objectCode.size());
+    writeFileBytes(cachePath, cacheFileStream.getBytes());
+
+    return objectCode;
+}
@@ -1,47 +1,168 @@
-#include <inttypes.h>
+#include <algorithm>
 #include <atomic>
 #include <utility>
 #include <vector>
-#include <iostream>
 
 #include "RuntimePrivate.h"
+#include "WAVM/Inline/HashMap.h"
 #include "WAVM/Inline/Lock.h"
 
 using namespace WAVM;
 using namespace WAVM::Runtime;
 
 Runtime::GCObject::GCObject(ObjectKind inKind, Compartment *inCompartment)
-        : Object{inKind}, compartment(inCompartment), numRootReferences(0) {
+        : Object{inKind}, compartment(inCompartment), numRootReferences(0),
+          isYoung(inKind != ObjectKind::compartment && inCompartment) {
+    // The compartment isn't constructed yet when its own GCObject base is, and is never collected,
+    // so it's never in the young generation.
+    if (isYoung) {
+        Lock<Platform::SpinMutex> youngGenerationLock(compartment->gcYoungGeneration.mutex);
+        compartment->gcYoungGeneration.objects.addOrFail(this);
+    }
 }
 
-void Runtime::addGCRoot(Object *object) {
-    if (object->kind == ObjectKind::function) {
-        Function *function = (Function *) object;
-        wavmAssert(function->mutableData);
-        ++function->mutableData->numRootReferences;
-    } else {
-        GCObject *gcObject = (GCObject *) object;
-        ++gcObject->numRootReferences;
+Runtime::GCObject::~GCObject() {
+    if (isYoung) {
+        Lock<Platform::SpinMutex> youngGenerationLock(compartment->gcYoungGeneration.mutex);
+        compartment->gcYoungGeneration.objects.removeOrFail(this);
     }
 }
 
-void Runtime::removeGCRoot(Object *object) {
-    if (object->kind == ObjectKind::function) {
-        Function *function = (Function *) object;
-        wavmAssert(function->mutableData);
-        --function->mutableData->numRootReferences;
+// Returns whether a reference may be to a young object. Functions aren't GCObjects: they are kept
+// alive by their module instance, which can't be looked up without the compartment lock, so any
+// function other than the table sentinels is treated as possibly young.
+static bool mayBeYoung(Object *object) {
+    if (!object) {
+        return false;
+    } else if (object->kind == ObjectKind::function) {
+        return asFunction(object)->moduleInstanceId != UINTPTR_MAX;
     } else {
-        GCObject *gcObject = (GCObject *) object;
-        --gcObject->numRootReferences;
+        return ((GCObject *) object)->isYoung.load(std::memory_order_acquire);
+    }
+}
+
+void Runtime::rememberTableWrite(Table *table, Object *value) {
+    if (!table->isYoung.load(std::memory_order_acquire) && !table->isRemembered.load(std::memory_order_acquire) && mayBeYoung(value)) {
+        Lock<Platform::SpinMutex> youngGenerationLock(table->compartment->gcYoungGeneration.mutex);
+        if (!table->isRemembered.load(std::memory_order_acquire)) {
+            table->compartment->gcYoungGeneration.rememberedTables.addOrFail(table);
+            table->isRemembered.store(true, std::memory_order_release);
+        }
+    }
+}
+
+// The changes to objects' root reference counts that haven't been added to the counts yet.
+// addGCRoot and removeGCRoot only update the calling thread's shard, so threads that root the same
+// objects, e.g. executor workers invoking the same function, don't contend for the objects' cache
+// lines. The changes are added to the counts when a collection starts, before it reads them.
+struct alignas(64) RootReferenceShard {
+    Platform::SpinMutex mutex;
+    HashMap<Object *, Iptr> deltas;
+};
+
+static constexpr Uptr numRootReferenceShards = 64;
+
+static RootReferenceShard *getRootReferenceShards() {
+    static RootReferenceShard shards[numRootReferenceShards];
+    return shards;
+}
+
+static RootReferenceShard &getThreadRootReferenceShard() {
+    static std::atomic<Uptr> nextShardIndex{0};
+    static thread_local RootReferenceShard *threadShard = nullptr;
+    if (!threadShard) {
+        threadShard = &getRootReferenceShards()[nextShardIndex.fetch_add(1, std::memory_order_relaxed) % numRootReferenceShards];
     }
+    return *threadShard;
+}
+
+static void addRootReferenceDelta(Object *object, Iptr delta) {
+    wavmAssert(object->kind != ObjectKind::function || ((Function *) object)->mutableData);
+    RootReferenceShard &shard = getThreadRootReferenceShard();
+    Lock<Platform::SpinMutex> shardLock(shard.mutex);
+    Iptr &objectDelta = shard.deltas.getOrAdd(object, 0);
+    objectDelta += delta;
+    if (!objectDelta) {
+        shard.deltas.removeOrFail(object);
+    }
+}
+
+// Adds the changes in all the shards to the objects' root reference counts. A reference may be
+// added on one thread and removed on another, so all the shards are locked at once to see a
+// consistent set of changes. The changes to an object are summed before they are added to its
+// count, since an object whose changes sum to zero may have been deleted.
+static void flushRootReferenceShards() {
+    RootReferenceShard *shards = getRootReferenceShards();
+    for (Uptr shardIndex = 0; shardIndex < numRootReferenceShards; ++shardIndex) {
+        shards[shardIndex].mutex.lock();
+    }
+
+    HashMap<Object *, Iptr> objectDeltas;
+    for (Uptr shardIndex = 0; shardIndex < numRootReferenceShards; ++shardIndex) {
+        for (const auto &pair : shards[shardIndex].deltas) {
+            objectDeltas.getOrAdd(pair.key, 0) += pair.value;
+        }
+        shards[shardIndex].deltas.clear();
+    }
+    for (const auto &pair : objectDeltas) {
+        if (pair.value) {
+            std::atomic<Uptr> &numRootReferences = pair.key->kind == ObjectKind::function ? ((Function *) pair.key)->mutableData->numRootReferences : ((GCObject *) pair.key)->numRootReferences;
+            numRootReferences.fetch_add(Uptr(pair.value), std::memory_order_acq_rel);
+        }
+    }
+
+    for (Uptr shardIndex = 0; shardIndex < numRootReferenceShards; ++shardIndex) {
+        shards[shardIndex].mutex.unlock();
+    }
+}
+
+void Runtime::addGCRoot(Object *object) {
+    addRootReferenceDelta(object, 1);
 }
 
-struct GCState {
+void Runtime::removeGCRoot(Object *object) {
+    addRootReferenceDelta(object, -1);
+}
+
+// The state of an incremental collection of a compartment's garbage. The collection is a
+// snapshot-at-the-beginning mark and sweep: every object that was reachable when the collection
+// started is marked, and the objects that were unreachable then are deleted when it finishes.
+// Objects created while the collection is in progress aren't tracked by it, so they survive it.
+//
+// A young collection only tracks the young generation: the objects created since the last
+// collection finished. Old objects are treated as live, and the only ones that may reference young
+// objects are the tables in the remembered set and mutable globals, which are scanned as roots.
+// The objects that survive a collection are promoted to the old generation.
+//
+// Between steps of the collection, the mutator may overwrite table elements and mutable globals.
+// A table element that hasn't been scanned yet may hold the only reference to an object that was
+// reachable at the start, so setTableElement shades the element it overwrites while a collection
+// is marking (see GCWriteBarrier). Mutable globals can be written by generated code without a
+// barrier, so their values are instead copied when the collection starts.
+struct Runtime::IncrementalGCState {
     Compartment *compartment;
-    HashSet<GCObject *> unreferencedObjects;
+    bool isYoungCollection;
+
+    // The young objects tracked by the collection, which are promoted if they survive it.
+    std::vector<GCObject *> youngObjects;
+
+    // A referenced object is looked up and removed from this set for every reference the
+    // collection visits, which the grouped layout does with fewer cache misses for large sets.
+    HashSet<GCObject *, DefaultHashPolicy<GCObject *>, GroupedHashTableAllocPolicy> unreferencedObjects;
     std::vector<GCObject *> pendingScanObjects;
 
-    GCState(Compartment *inCompartment) : compartment(inCompartment) {
+    // The table currently being scanned, and the index of the next element to scan in it. Tables
+    // are scanned a bounded number of elements at a time, so a large table doesn't make a step
+    // unbounded.
+    Table *scanningTable = nullptr;
+    Uptr scanningTableNextElementIndex = 0;
+
+    // The values of the compartment's mutable reference globals when the collection started, in
+    // the initial context globals and every context.
+    HashMap<GCObject *, std::vector<Object *>> mutableGlobalValueSnapshots;
+
+    IncrementalGCState(Compartment *inCompartment, bool inIsYoungCollection)
+            : compartment(inCompartment), isYoungCollection(inIsYoungCollection) {
     }
 
     void visitReference(Object *object) {
@@ -73,34 +194,32 @@ struct GCState {
         }
     }
 
-    void scanObject(GCObject *object) {
+    // Scans an object, and returns the number of work units it took.
+    Uptr scanObject(GCObject *object) {
         wavmAssert(!object->compartment || object->compartment == compartment);
         visitReference(object->compartment);
 
         // Gather the child references for this object based on its kind.
         switch (object->kind) {
             case ObjectKind::table: {
-                Table *table = asTable(object);
-
-                Lock<Platform::Mutex> resizingLock(table->resizingMutex);
-                const Uptr numElements = getTableNumElements(table);
-                for (Uptr elementIndex = 0; elementIndex < numElements; ++elementIndex) {
-                    visitReference(getTableElement(table, elementIndex));
-                }
-                break;
+                // Tables are scanned incrementally by scanTableElements.
+                wavmAssert(!scanningTable);
+                scanningTable = asTable(object);
+                scanningTableNextElementIndex = 0;
+                return 1;
             }
             case ObjectKind::global: {
                 Global *global = asGlobal(object);
+                Uptr numWorkUnits = 1;
                 if (isReferenceType(global->type.valueType)) {
-                    if (global->type.isMutable) {
-                        visitReference(compartment->initialContextMutableGlobals[global->mutableGlobalIndex].object);
-                        for (Context *context : compartment->contexts) {
-                            visitReference(context->runtimeData->mutableGlobals[global->mutableGlobalIndex].object);
-                        }
+                    if (global->type.isMutable && mutableGlobalValueSnapshots.contains(global)) {
+                        const std::vector<Object *> &values = *mutableGlobalValueSnapshots.get(global);
+                        visitReferenceArray(values);
+                        numWorkUnits += values.size();
                     }
                     visitReference(global->initialValue.object);
                 }
-                break;
+                return numWorkUnits;
             }
             case ObjectKind::moduleInstance: {
                 ModuleInstance *moduleInstance = asModuleInstance(object);
@@ -109,95 +228,308 @@ struct GCState {
                 visitReferenceArray(moduleInstance->memories);
                 visitReferenceArray(moduleInstance->globals);
                 visitReferenceArray(moduleInstance->exceptionTypes);
+                Uptr numWorkUnits = 1 + moduleInstance->functions.size() + moduleInstance->tables.size() +
+                                    moduleInstance->memories.size() + moduleInstance->globals.size() +
+                                    moduleInstance->exceptionTypes.size();
 
-                {
-                    Lock<Platform::Mutex> passiveElemSegmentLock(moduleInstance->passiveElemSegmentsMutex);
-                    for (const auto &passiveElemSegmentPair : moduleInstance->passiveElemSegments) {
-                        visitReferenceArray(*passiveElemSegmentPair.value);
-                    }
-                }
-
-                break;
+                return numWorkUnits;
             }
             case ObjectKind::compartment: {
                 wavmAssert(object == compartment);
-                break;
+                return 1;
             }
 
             case ObjectKind::memory:
             case ObjectKind::exceptionType:
             case ObjectKind::context:
-                break;
+                return 1;
 
             case ObjectKind::function:
             default:
                 Errors::unreachable();
         };
     }
+
+    // Scans up to maxElements elements of scanningTable, and returns the number scanned.
+    Uptr scanTableElements(Uptr maxElements) {
+        wavmAssert(scanningTable);
+        Table *table = scanningTable;
+
+        // The table may grow between steps, so check its size every time. Elements added by growing
+        // the table are initialized with references the mutator already had, so scanning them is
+        // conservative but not needed for correctness.
+        Lock<Platform::Mutex> resizingLock(table->resizingMutex);
+        const Uptr numElements = getTableNumElements(table);
+        const Uptr endElementIndex = scanningTableNextElementIndex + std::min(maxElements, numElements - scanningTableNextElementIndex);
+        for (Uptr elementIndex = scanningTableNextElementIndex; elementIndex < endElementIndex; ++elementIndex) {
+            visitReference(getTableElement(table, elementIndex));
+        }
+
+        const Uptr numScannedElements = endElementIndex - scanningTableNextElementIndex;
+        scanningTableNextElementIndex = endElementIndex;
+        if (scanningTableNextElementIndex == numElements) {
+            scanningTable = nullptr;
+        }
+        return numScannedElements;
+    }
+
+    // Visits the objects shaded by the write barrier since the last call, and returns the number
+    // visited.
+    Uptr visitShadedObjects() {
+        std::vector<Object *> shadedObjects;
+        {
+            Lock<Platform::SpinMutex> barrierLock(compartment->gcWriteBarrier.mutex);
+            shadedObjects.swap(compartment->gcWriteBarrier.shadedObjects);
+        }
+        for (Object *object : shadedObjects) {
+            visitReference(object);
+        }
+        return shadedObjects.size();
+    }
+
+    // Tries to finish marking: if no table element writes are in progress, and none have shaded an
+    // object that hasn't been visited yet, stops the write barrier and returns true.
+    bool tryFinishMarking() {
+        GCWriteBarrier &barrier = compartment->gcWriteBarrier;
+        while (barrier.numActiveWrites.load(std::memory_order_seq_cst)) {
+        };
+
+        Lock<Platform::SpinMutex> barrierLock(barrier.mutex);
+        if (barrier.shadedObjects.size()) {
+            return false;
+        }
+        barrier.isMarking.store(false, std::memory_order_seq_cst);
+        return true;
+    }
 };
 
-static bool collectGarbageImpl(Compartment *compartment) {
-    Lock<Platform::Mutex> compartmentLock(compartment->mutex);
-    GCState state(compartment);
+// Returns whether an object has been added to its compartment. An object that isn't is still being
+// created, and may be deleted by whatever is creating it if that fails, so it isn't collected.
+static bool isAddedToCompartment(Compartment *compartment, GCObject *object) {
+    switch (object->kind) {
+        case ObjectKind::table:
+            return asTable(object)->id != UINTPTR_MAX;
+        case ObjectKind::memory:
+            return asMemory(object)->id != UINTPTR_MAX;
+        case ObjectKind::global:
+            return asGlobal(object)->id != UINTPTR_MAX;
+        case ObjectKind::exceptionType:
+            return asExceptionType(object)->id != UINTPTR_MAX;
+        case ObjectKind::context:
+            return asContext(object)->id != UINTPTR_MAX;
+        case ObjectKind::moduleInstance: {
+            ModuleInstance *moduleInstance = asModuleInstance(object);
+            return compartment->moduleInstances.contains(moduleInstance->id) &&
+                   compartment->moduleInstances[moduleInstance->id] == moduleInstance;
+        }
 
-    // Initialize the GC state from the compartment's various sets of objects.
-    state.initGCObject(compartment);
-    for (ModuleInstance *moduleInstance : compartment->moduleInstances) {
-        // Transfer root markings from functions to their module instance.
-        bool hasRootFunction = false;
-        for (Function *function : moduleInstance->functions) {
-            if (function->mutableData->numRootReferences) {
-                hasRootFunction = true;
-                break;
+        case ObjectKind::compartment:
+        case ObjectKind::function:
+        default:
+            Errors::unreachable();
+    };
+}
+
+static void initModuleInstance(IncrementalGCState *state, ModuleInstance *moduleInstance) {
+    // Transfer root markings from functions to their module instance.
+    bool hasRootFunction = false;
+    for (Function *function : moduleInstance->functions) {
+        if (function->mutableData->numRootReferences) {
+            hasRootFunction = true;
+            break;
+        }
+    }
+
+    state->initGCObject(moduleInstance, hasRootFunction);
+}
+
+static void startGarbageCollection(Compartment *compartment, bool isYoungCollection) {
+    wavmAssert(!compartment->gcState);
+    IncrementalGCState *state = new IncrementalGCState(compartment, isYoungCollection);
+    compartment->gcState = state;
+
+    // Bring the root reference counts up to date before the snapshot of the roots reads them.
+    flushRootReferenceShards();
+
+    // Start shading overwritten table elements before taking the snapshot of the roots: nothing has
+    // been scanned yet, so table elements overwritten before the snapshot don't need to be shaded.
+    {
+        Lock<Platform::SpinMutex> barrierLock(compartment->gcWriteBarrier.mutex);
+        compartment->gcWriteBarrier.shadedObjects.clear();
+        compartment->gcWriteBarrier.isMarking.store(true, std::memory_order_seq_cst);
+    }
+
+    // Take the young generation and the remembered set. Tables written during the collection are
+    // remembered again, and the young objects that survive it are promoted when it finishes.
+    std::vector<Table *> rememberedTables;
+    {
+        Lock<Platform::SpinMutex> youngGenerationLock(compartment->gcYoungGeneration.mutex);
+        for (GCObject *object : compartment->gcYoungGeneration.objects) {
+            if (isAddedToCompartment(compartment, object)) {
+                state->youngObjects.push_back(object);
+            }
+        }
+        for (Table *table : compartment->gcYoungGeneration.rememberedTables) {
+            table->isRemembered.store(false, std::memory_order_release);
+            rememberedTables.push_back(table);
+        }
+        compartment->gcYoungGeneration.rememberedTables.clear();
+    }
+
+    // The compartment itself is always a root, since the caller holds a pointer to it.
+    state->initGCObject(compartment, true);
+
+    if (isYoungCollection) {
+        // Only track the young objects. The old objects are implicitly live, and only the
+        // remembered tables and mutable globals among them may reference young objects.
+        for (GCObject *object : state->youngObjects) {
+            if (object->kind == ObjectKind::moduleInstance) {
+                initModuleInstance(state, asModuleInstance(object));
+            } else {
+                state->initGCObject(object);
             }
         }
+        for (Table *table : rememberedTables) {
+            state->pendingScanObjects.push_back(table);
+        }
+        for (Global *global : compartment->globals) {
+            if (isReferenceType(global->type.valueType) && global->type.isMutable) {
+                state->visitReference(compartment->initialContextMutableGlobals[global->mutableGlobalIndex].object);
+                for (Context *context : compartment->contexts) {
+                    state->visitReference(context->runtimeData->mutableGlobals[global->mutableGlobalIndex].object);
+                }
+            }
+        }
+        return;
+    }
 
-        state.initGCObject(moduleInstance, hasRootFunction);
+    // Initialize the GC state from the compartment's various sets of objects.
+    for (ModuleInstance *moduleInstance : compartment->moduleInstances) {
+        initModuleInstance(state, moduleInstance);
     }
     for (Memory *memory : compartment->memories) {
-        state.initGCObject(memory);
+        state->initGCObject(memory);
     }
     for (Table *table : compartment->tables) {
-        state.initGCObject(table);
+        state->initGCObject(table);
     }
     for (ExceptionType *exceptionType : compartment->exceptionTypes) {
-        state.initGCObject(exceptionType);
+        state->initGCObject(exceptionType);
     }
     for (Global *global : compartment->globals) {
-        state.initGCObject(global);
+        state->initGCObject(global);
+
+        // Copy the values of mutable reference globals.
+        if (isReferenceType(global->type.valueType) && global->type.isMutable) {
+            std::vector<Object *> values;
+            values.push_back(compartment->initialContextMutableGlobals[global->mutableGlobalIndex].object);
+            for (Context *context : compartment->contexts) {
+                values.push_back(context->runtimeData->mutableGlobals[global->mutableGlobalIndex].object);
+            }
+            state->mutableGlobalValueSnapshots.addOrFail(global, std::move(values));
+        }
     }
     for (Context *context : compartment->contexts) {
-        state.initGCObject(context);
+        state->initGCObject(context);
     }
+}
 
-    // Scan the objects added to the referenced set so far: gather their child references and
-    // recurse.
-    const Uptr numInitialObjects = state.pendingScanObjects.size() + state.unreferencedObjects.size();
-    const Uptr numRoots = state.pendingScanObjects.size();
-    while (state.pendingScanObjects.size()) {
-        GCObject *object = state.pendingScanObjects.back();
-        state.pendingScanObjects.pop_back();
-        state.scanObject(object);
-    };
+static void finishGarbageCollection(Compartment *compartment) {
+    IncrementalGCState *state = compartment->gcState;
+    wavmAssert(state && !state->pendingScanObjects.size() && !state->scanningTable);
+
+    // Promote the surviving young objects to the old generation. A promoted table may reference
+    // objects created during the collection, which are still young, so remember it.
+    {
+        Lock<Platform::SpinMutex> youngGenerationLock(compartment->gcYoungGeneration.mutex);
+        for (GCObject *object : state->youngObjects) {
+            if (!state->unreferencedObjects.contains(object)) {
+                compartment->gcYoungGeneration.objects.removeOrFail(object);
+                object->isYoung.store(false, std::memory_order_release);
+                if (object->kind == ObjectKind::table) {
+                    Table *table = asTable(object);
+                    if (!table->isRemembered.load(std::memory_order_acquire)) {
+                        compartment->gcYoungGeneration.rememberedTables.addOrFail(table);
+                        table->isRemembered.store(true, std::memory_order_release);
+                    }
+                }
+            }
+        }
+    }
+
+    // Delete each unreferenced object.
+    for (GCObject *object : state->unreferencedObjects) {
+        wavmAssert(object != compartment);
+        delete object;
+    }
 
-    // Delete each unreferenced object that isn't the compartment.
-    bool wasCompartmentUnreferenced = false;
-    for (GCObject *object : state.unreferencedObjects) {
-        if (object == compartment) {
-            wasCompartmentUnreferenced = true;
+    compartment->gcState = nullptr;
+    delete state;
+}
+
+bool Runtime::collectGarbage(Compartment *compartment, Uptr maxWorkUnits, bool youngOnly) {
+    // Each call is a pause of the compartment's mutator threads that create or delete objects.
+    MetricTimer pauseTimer(Metrics::Histogram::garbageCollectionPauseMicroseconds);
+    Lock<Platform::Mutex> compartmentLock(compartment->mutex);
+    if (!compartment->gcState) {
+        startGarbageCollection(compartment, youngOnly);
+    }
+    IncrementalGCState &state = *compartment->gcState;
+
+    Uptr numWorkUnits = 0;
+    while (true) {
+        numWorkUnits += state.visitShadedObjects();
+
+        if (!state.scanningTable && !state.pendingScanObjects.size()) {
+            if (state.tryFinishMarking()) {
+                break;
+            }
+            continue;
+        }
+
+        if (numWorkUnits >= maxWorkUnits) {
+            return false;
+        }
+
+        if (state.scanningTable) {
+            numWorkUnits += state.scanTableElements(std::max(Uptr(1), maxWorkUnits - numWorkUnits));
         } else {
-            delete object;
+            GCObject *object = state.pendingScanObjects.back();
+            state.pendingScanObjects.pop_back();
+            numWorkUnits += state.scanObject(object);
         }
+    };
+
+    finishGarbageCollection(compartment);
+    addToMetric(Metrics::Counter::numGarbageCollections);
+    return true;
+}
+
+bool Runtime::tryCollectCompartment(Compartment *compartment) {
+    // A collection in progress may be a young collection, or may have taken its snapshot of the
+    // roots before the caller released them, so finish it before doing a full collection.
+    bool isCollecting;
+    {
+        Lock<Platform::Mutex> compartmentLock(compartment->mutex);
+        isCollecting = compartment->gcState != nullptr;
     }
+    if (isCollecting) {
+        collectGarbage(compartment, UINTPTR_MAX, false);
+    }
+    collectGarbage(compartment, UINTPTR_MAX, false);
 
-    // Delete the compartment last, if it wasn't referenced.
-    compartmentLock.unlock();
-    if (wasCompartmentUnreferenced) {
-        delete compartment;
+    {
+        Lock<Platform::Mutex> compartmentLock(compartment->mutex);
+        if (compartment->memories.size() || compartment->tables.size() || compartment->exceptionTypes.size() ||
+            compartment->globals.size() || compartment->moduleInstances.size() || compartment->contexts.size()) {
+            return false;
+        }
     }
 
-    std::cout << "Collected garbage in %.2fms: %" PRIuPTR " roots, %" PRIuPTR " objects, %" PRIuPTR << " garbage\n"
-              << numRoots << numInitialObjects << Uptr(state.unreferencedObjects.size());
+    delete compartment;
+    return true;
+}
 
-    return wasCompartmentUnreferenced;
+void Runtime::destroyIncrementalGCState(IncrementalGCState *state) {
+    delete state;
 }
@@ -0,0 +1,236 @@
+#include <inttypes.h>
+#include <stdio.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "RuntimePrivate.h"
+#include "WAVM/Inline/HashMap.h"
+#include "WAVM/Inline/Lock.h"
+#include "WAVM/LLVMJIT/LLVMJIT.h"
+#include "WAVM/Platform/Clock.h"
+#include "WAVM/Platform/Event.h"
+#include "WAVM/Platform/Exception.h"
+#include "WAVM/Platform/Mutex.h"
+#include "WAVM/Runtime/Profiler.h"
+#include "WAVM/Runtime/RuntimeData.h"
+
+using namespace WAVM;
+using namespace WAVM::Runtime;
+
+// The number of samples the signal handler can queue before the aggregation thread takes them. At
+// 100 samples per second, the aggregation thread can fall behind by several seconds before samples
+// are dropped.
+static constexpr Uptr numSampleSlots = 1024;
+
+// How often the aggregation thread takes the queued samples.
+static constexpr U64 aggregationIntervalMicroseconds = 50 * 1000;
+
+// The queued samples are kept in a bounded queue like the one used by InstancePool: each slot has a
+// sequence number that tells the signal handler or the aggregation thread whether the slot is ready
+// for it, so the signal handler only takes a compare-and-swap to queue a sample, and never blocks.
+struct SampleSlot {
+    std::atomic<Uptr> sequence;
+    Uptr numFrames;
+    Uptr ips[Platform::maxProfileSampleFrames];
+};
+
+static SampleSlot sampleSlots[numSampleSlots];
+static std::atomic<Uptr> samplePushIndex{0};
+static std::atomic<Uptr> samplePopIndex{0};
+static std::atomic<U64> numSamples{0};
+static std::atomic<U64> numDroppedSamples{0};
+
+static_assert(!(numSampleSlots & (numSampleSlots - 1)), "numSampleSlots must be a power of two");
+
+static bool initSampleSlots() {
+    for (Uptr slotIndex = 0; slotIndex < numSampleSlots; ++slotIndex) {
+        sampleSlots[slotIndex].sequence.store(slotIndex, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+static void onProfileSample(const Uptr *ips, Uptr numFrames) {
+    // This is called from a signal handler, so it must not lock or allocate.
+    numSamples.fetch_add(1, std::memory_order_relaxed);
+
+    Uptr index = samplePushIndex.load(std::memory_order_relaxed);
+    while (true) {
+        SampleSlot &slot = sampleSlots[index & (numSampleSlots - 1)];
+        const Iptr difference = Iptr(slot.sequence.load(std::memory_order_acquire) - index);
+        if (difference == 0) {
+            if (samplePushIndex.compare_exchange_weak(index, index + 1, std::memory_order_relaxed)) {
+                slot.numFrames = numFrames;
+                for (Uptr frameIndex = 0; frameIndex < numFrames; ++frameIndex) {
+                    slot.ips[frameIndex] = ips[frameIndex];
+                }
+                slot.sequence.store(index + 1, std::memory_order_release);
+                return;
+            }
+        } else if (difference < 0) {
+            // The queue is full.
+            numDroppedSamples.fetch_add(1, std::memory_order_relaxed);
+            return;
+        } else {
+            index = samplePushIndex.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+struct Profile {
+    Platform::Mutex mutex;
+
+    // The number of samples of each distinct stack, keyed by the stack's collapsed function names.
+    HashMap<std::string, U64> stackToNumSamplesMap;
+
+    std::thread aggregationThread;
+    Platform::Event wakeEvent;
+    std::atomic<bool> isStopping{false};
+    bool isRunning = false;
+};
+
+// The profile is never freed, since the signal handler may queue samples during process exit.
+static Profile &getProfile() {
+    static Profile *profile = new Profile;
+    return *profile;
+}
+
+static void appendFunctionName(std::string &stack, const std::string &debugName) {
+    if (debugName.empty()) {
+        stack += "<unnamed>";
+    } else {
+        // Semicolons separate the frames of a collapsed stack.
+        for (char c : debugName) {
+            stack += c == ';' ? ':' : c;
+        }
+    }
+}
+
+// Takes the queued samples, and adds their stacks to the profile. The caller must hold the
+// profile's mutex, so there is only one consumer of the queue.
+static void aggregateQueuedSamples(Profile &profile) {
+    std::vector<std::string> functionNames;
+    std::string functionName;
+    std::string stack;
+    while (true) {
+        const Uptr index = samplePopIndex.load(std::memory_order_relaxed);
+        SampleSlot &slot = sampleSlots[index & (numSampleSlots - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != index + 1) {
+            break;
+        }
+
+        // Map each frame to the guest function that contains it. The return addresses of the outer
+        // frames may be just past the end of the calling function, so the address before them is
+        // looked up instead. Frames outside guest code are skipped. The names are copied by the
+        // lookup, since the module that contains a function may be unloaded at any time.
+        functionNames.clear();
+        bool isInnermostFrameNative = false;
+        for (Uptr frameIndex = 0; frameIndex < slot.numFrames; ++frameIndex) {
+            const Uptr ip = frameIndex ? slot.ips[frameIndex] - 1 : slot.ips[frameIndex];
+            if (LLVMJIT::getFunctionDebugNameByAddress(ip, functionName)) {
+                functionNames.push_back(functionName);
+            } else if (!frameIndex) {
+                isInnermostFrameNative = true;
+            }
+        }
+
+        slot.sequence.store(index + numSampleSlots, std::memory_order_release);
+        samplePopIndex.store(index + 1, std::memory_order_relaxed);
+
+        if (!functionNames.size()) {
+            continue;
+        }
+
+        stack.clear();
+        for (Uptr functionIndex = functionNames.size(); functionIndex > 0; --functionIndex) {
+            if (functionIndex != functionNames.size()) {
+                stack += ';';
+            }
+            appendFunctionName(stack, functionNames[functionIndex - 1]);
+        }
+        if (isInnermostFrameNative) {
+            stack += ";[native]";
+        }
+        ++profile.stackToNumSamplesMap.getOrAdd(stack, 0);
+    }
+}
+
+static void aggregationThreadEntry() {
+    Profile &profile = getProfile();
+    while (!profile.isStopping.load(std::memory_order_acquire)) {
+        profile.wakeEvent.wait(Platform::getMonotonicClock() + aggregationIntervalMicroseconds);
+
+        Lock<Platform::Mutex> profileLock(profile.mutex);
+        aggregateQueuedSamples(profile);
+    }
+}
+
+bool Profiler::start(Uptr samplesPerSecond) {
+    static const bool areSampleSlotsInitialized = initSampleSlots();
+    SUPPRESS_UNUSED(areSampleSlotsInitialized);
+    errorUnless(samplesPerSecond > 0 && samplesPerSecond <= 1000000);
+
+    Profile &profile = getProfile();
+    Lock<Platform::Mutex> profileLock(profile.mutex);
+    if (profile.isRunning || !Platform::startProfilingTimer(1000000 / samplesPerSecond, onProfileSample)) {
+        return false;
+    }
+
+    profile.isRunning = true;
+    profile.isStopping.store(false, std::memory_order_release);
+    profile.aggregationThread = std::thread(aggregationThreadEntry);
+    return true;
+}
+
+void Profiler::stop() {
+    Profile &profile = getProfile();
+    Lock<Platform::Mutex> profileLock(profile.mutex);
+    if (!profile.isRunning) {
+        return;
+    }
+    Platform::stopProfilingTimer();
+    profile.isRunning = false;
+
+    // The aggregation thread locks the mutex, so unlock it while waiting for the thread to exit.
+    profile.isStopping.store(true, std::memory_order_release);
+    profile.wakeEvent.signal();
+    std::thread aggregationThread = std::move(profile.aggregationThread);
+    profileLock.unlock();
+    aggregationThread.join();
+
+    Lock<Platform::Mutex> finalAggregationLock(profile.mutex);
+    aggregateQueuedSamples(profile);
+}
+
+void Profiler::reset() {
+    Profile &profile = getProfile();
+    Lock<Platform::Mutex> profileLock(profile.mutex);
+    aggregateQueuedSamples(profile);
+    profile.stackToNumSamplesMap.clear();
+    numSamples.store(0, std::memory_order_relaxed);
+    numDroppedSamples.store(0, std::memory_order_relaxed);
+}
+
+std::string Profiler::getCollapsedStacks() {
+    Profile &profile = getProfile();
+    Lock<Platform::Mutex> profileLock(profile.mutex);
+    aggregateQueuedSamples(profile);
+
+    std::string result;
+    for (const auto &pair : profile.stackToNumSamplesMap) {
+        char numSamplesString[24];
+        snprintf(numSamplesString, sizeof(numSamplesString), " %" PRIu64 "\n", pair.value);
+        result += pair.key;
+        result += numSamplesString;
+    }
+    return result;
+}
+
+U64 Profiler::getNumSamples() {
+    return numSamples.load(std::memory_order_relaxed);
+}
+
+U64 Profiler::getNumDroppedSamples() {
+    return numDroppedSamples.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,125 @@
+#include <vector>
+
+#include "RuntimePrivate.h"
+#include "WAVM/Inline/Lock.h"
+#include "WAVM/Platform/Memory.h"
+#include "WAVM/Platform/Mutex.h"
+
+using namespace WAVM;
+using namespace WAVM::Runtime;
+
+// A pool of freed address-space reservations of a single size, which are reused instead of being
+// unmapped and mapped again: at a high rate of instantiation, the mmap/munmap calls contend for the
+// kernel's address-space lock, and unmapping causes TLB shootdowns.
+struct ReservationPool {
+    struct Reservation {
+        U8 *baseAddress;
+        U8 *unalignedBaseAddress;
+    };
+
+    Platform::Mutex mutex;
+    const Uptr alignmentLog2;
+    Uptr maxReservations;
+    Uptr numPages = 0;
+    std::vector<Reservation> reservations;
+
+    ReservationPool(Uptr inAlignmentLog2, Uptr inMaxReservations)
+            : alignmentLog2(inAlignmentLog2), maxReservations(inMaxReservations) {
+    }
+
+    void freeReservation(const Reservation &reservation, Uptr numReservationPages) {
+        if (alignmentLog2) {
+            Platform::freeAlignedVirtualPages(reservation.unalignedBaseAddress, numReservationPages, alignmentLog2);
+        } else {
+            Platform::freeVirtualPages(reservation.baseAddress, numReservationPages);
+        }
+    }
+};
+
+static ReservationPool &getReservationPool(ReservationKind kind) {
+    static ReservationPool memoryPool(0, 64);
+    static ReservationPool tablePool(0, 16);
+    static ReservationPool compartmentPool(compartmentRuntimeDataAlignmentLog2, 16);
+    static ReservationPool hugePageMemoryPool(Platform::getHugePageSizeLog2(), 64);
+    switch (kind) {
+        case ReservationKind::memory:
+            return memoryPool;
+        case ReservationKind::table:
+            return tablePool;
+        case ReservationKind::compartment:
+            return compartmentPool;
+        case ReservationKind::hugePageMemory:
+            return hugePageMemoryPool;
+        default:
+            Errors::unreachable();
+    };
+}
+
+static void trimReservationPool(ReservationPool &pool) {
+    while (pool.reservations.size() > pool.maxReservations) {
+        pool.freeReservation(pool.reservations.back(), pool.numPages);
+        pool.reservations.pop_back();
+    }
+}
+
+U8 *Runtime::allocateReservation(ReservationKind kind, Uptr numPages) {
+    U8 *unalignedBaseAddress = nullptr;
+    return allocateAlignedReservation(kind, numPages, unalignedBaseAddress);
+}
+
+U8 *Runtime::allocateAlignedReservation(ReservationKind kind, Uptr numPages, U8 *&outUnalignedBaseAddress) {
+    ReservationPool &pool = getReservationPool(kind);
+    {
+        Lock<Platform::Mutex> poolLock(pool.mutex);
+        if (pool.reservations.size() && pool.numPages == numPages) {
+            const ReservationPool::Reservation reservation = pool.reservations.back();
+            pool.reservations.pop_back();
+            outUnalignedBaseAddress = reservation.unalignedBaseAddress;
+            return reservation.baseAddress;
+        }
+    }
+
+    if (pool.alignmentLog2) {
+        return Platform::allocateAlignedVirtualPages(numPages, pool.alignmentLog2, outUnalignedBaseAddress);
+    } else {
+        outUnalignedBaseAddress = Platform::allocateVirtualPages(numPages);
+        return outUnalignedBaseAddress;
+    }
+}
+
+void Runtime::freeReservation(ReservationKind kind, U8 *baseAddress, Uptr numPages, Uptr numCommittedPages) {
+    freeAlignedReservation(kind, baseAddress, baseAddress, numPages, numCommittedPages);
+}
+
+void Runtime::freeAlignedReservation(ReservationKind kind, U8 *baseAddress, U8 *unalignedBaseAddress, Uptr numPages, Uptr numCommittedPages) {
+    ReservationPool &pool = getReservationPool(kind);
+    const ReservationPool::Reservation reservation = {baseAddress, unalignedBaseAddress};
+    Lock<Platform::Mutex> poolLock(pool.mutex);
+
+    // All reservations of a kind are expected to be the same size, but don't pool reservations of a
+    // different size than the ones already in the pool.
+    if (!pool.reservations.size()) {
+        pool.numPages = numPages;
+    }
+    if (pool.reservations.size() >= pool.maxReservations || pool.numPages != numPages) {
+        poolLock.unlock();
+        pool.freeReservation(reservation, numPages);
+        return;
+    }
+
+    // Release the committed pages' physical memory, and make them inaccessible again, so the
+    // reservation is in the same state as a new one.
+    Platform::discardVirtualPages(baseAddress, numCommittedPages);
+    pool.reservations.push_back(reservation);
+}
+
+void Runtime::setReservationPoolSizes(Uptr maxPooledMemoryReservations, Uptr maxPooledTableReservations, Uptr maxPooledCompartmentReservations) {
+    const ReservationKind kinds[4] = {ReservationKind::memory, ReservationKind::hugePageMemory, ReservationKind::table, ReservationKind::compartment};
+    const Uptr maxReservations[4] = {maxPooledMemoryReservations, maxPooledMemoryReservations, maxPooledTableReservations, maxPooledCompartmentReservations};
+    for (Uptr kindIndex = 0; kindIndex < 4; ++kindIndex) {
+        ReservationPool &pool = getReservationPool(kinds[kindIndex]);
+        Lock<Platform::Mutex> poolLock(pool.mutex);
+        pool.maxReservations = maxReservations[kindIndex];
+        trimReservationPool(pool);
+    }
+}
@@ -7,9 +7,10 @@ using namespace WAVM;
 using namespace WAVM::IR;
 using namespace WAVM::Runtime;
 
-Context *Runtime::createContext(Compartment *compartment) {
+Context *Runtime::createContext(Compartment *compartment, Uptr numStackBytes) {
     wavmAssert(compartment);
     Context *context = new Context(compartment);
+    context->numStackBytes = numStackBytes;
     {
         Lock<Platform::Mutex> lock(compartment->mutex);
 
@@ -20,13 +21,30 @@ Context *Runtime::createContext(Compartment *compartment) {
             return nullptr;
         }
         context->runtimeData = &compartment->runtimeData->contexts[context->id];
+        context->runtimeData->interruptRequested.store(0, std::memory_order_relaxed);
+        context->runtimeData->fuel = INT64_MAX;
 
-        // Commit the page(s) for the context's runtime data.
-        errorUnless(Platform::commitVirtualPages((U8 *) context->runtimeData,
-                                                 sizeof(ContextRuntimeData) >> Platform::getPageSizeLog2()));
+        // Commit the page(s) for the context's runtime data, unless the slot was committed for a
+        // context that has been destroyed.
+        if (context->id >= compartment->numCommittedContexts) {
+            const Uptr numNewContexts = context->id + 1 - compartment->numCommittedContexts;
+            if (!tryChargeCompartmentMemory(compartment, CompartmentMemoryKind::runtimeData, numNewContexts * sizeof(ContextRuntimeData))) {
+                delete context;
+                return nullptr;
+            }
+            errorUnless(Platform::commitVirtualPages((U8 *) &compartment->runtimeData->contexts[compartment->numCommittedContexts],
+                                                     (numNewContexts * sizeof(ContextRuntimeData)) >> Platform::getPageSizeLog2()));
+            compartment->numCommittedContexts = context->id + 1;
+        }
 
-        // Initialize the context's global data.
-        memcpy(context->runtimeData->mutableGlobals, compartment->initialContextMutableGlobals, maxGlobalBytes);
+        // Initialize the context's allocated mutable globals. The values of unallocated globals are
+        // never read, and are initialized by createGlobal when they are allocated.
+        // Mutable globals are allocated at the smallest free index, so only the values up to the
+        // largest allocated index need to be copied.
+        const U32 largestMutableGlobalIndex = compartment->globalDataAllocationMask.getLargestMember();
+        if (largestMutableGlobalIndex != maxMutableGlobals) {
+            memcpy(context->runtimeData->mutableGlobals, compartment->initialContextMutableGlobals, (largestMutableGlobalIndex + 1) * sizeof(IR::UntaggedValue));
+        }
     }
 
     return context;
@@ -83,6 +101,61 @@ Runtime::Global::~Global() {
     }
 }
 
+Global *Runtime::cloneGlobal(Global *global, Compartment *newCompartment) {
+    // The global keeps its mutable data index: cloneCompartment copies the original compartment's
+    // allocation mask and initial values for it.
+    IR::UntaggedValue initialValue = global->initialValue;
+    if (isReferenceType(global->type.valueType) && initialValue.object) {
+        initialValue.object = remapToClonedCompartment(initialValue.object, newCompartment);
+    }
+    Global *newGlobal = new Global(newCompartment, global->type, global->mutableGlobalIndex, initialValue);
+
+    Lock<Platform::Mutex> compartmentLock(newCompartment->mutex);
+    newGlobal->id = global->id;
+    newCompartment->globals.insertOrFail(newGlobal->id, newGlobal);
+
+    return newGlobal;
+}
+
+Runtime::ExceptionType::~ExceptionType() {
+    if (id != UINTPTR_MAX) {
+        compartment->exceptionTypes.removeOrFail(id);
+    }
+}
+
+Runtime::ExceptionType *Runtime::cloneExceptionType(Runtime::ExceptionType *exceptionType, Compartment *newCompartment) {
+    std::string debugName = exceptionType->debugName;
+    Runtime::ExceptionType *newExceptionType = new Runtime::ExceptionType(newCompartment, exceptionType->sig, std::move(debugName));
+
+    Lock<Platform::Mutex> compartmentLock(newCompartment->mutex);
+    newExceptionType->id = exceptionType->id;
+    newCompartment->exceptionTypes.insertOrFail(newExceptionType->id, newExceptionType);
+
+    return newExceptionType;
+}
+
+Context *Runtime::cloneContext(const Context *context, Compartment *newCompartment) {
+    Context *newContext = createContext(newCompartment, context->numStackBytes);
+    if (!newContext) {
+        return nullptr;
+    }
+
+    // Copy the context's mutable global values, remapping references to the new compartment.
+    memcpy(newContext->runtimeData->mutableGlobals, context->runtimeData->mutableGlobals, maxGlobalBytes);
+
+    Lock<Platform::Mutex> compartmentLock(newCompartment->mutex);
+    for (Global *global : newCompartment->globals) {
+        if (global->type.isMutable && isReferenceType(global->type.valueType)) {
+            IR::UntaggedValue &value = newContext->runtimeData->mutableGlobals[global->mutableGlobalIndex];
+            if (value.object) {
+                value.object = remapToClonedCompartment(value.object, newCompartment);
+            }
+        }
+    }
+
+    return newContext;
+}
+
 #define DEFINE_OBJECT_TYPE(kindId, kindName, Type)                                                 \
     Runtime::Type* Runtime::as##kindName(Object* object)                                           \
     {                                                                                              \
@@ -163,6 +236,15 @@ FunctionType Runtime::getFunctionType(Function *function) {
     return function->encodedType;
 }
 
+Context *Runtime::getContextFromRuntimeData(ContextRuntimeData *contextRuntimeData) {
+    CompartmentRuntimeData *compartmentRuntimeData = getCompartmentRuntimeData(contextRuntimeData);
+    Compartment *compartment = compartmentRuntimeData->compartment;
+    const Uptr contextId = contextRuntimeData - compartmentRuntimeData->contexts;
+    Lock<Platform::Mutex> compartmentLock(compartment->mutex);
+    wavmAssert(compartment->contexts.contains(contextId));
+    return compartment->contexts[contextId];
+}
+
 ModuleInstance *Runtime::getModuleInstanceFromRuntimeData(ContextRuntimeData *contextRuntimeData, Uptr moduleInstanceId) {
     Compartment *compartment = getCompartmentRuntimeData(contextRuntimeData)->compartment;
     Lock<Platform::Mutex> compartmentLock(compartment->mutex);
@@ -2,20 +2,24 @@
 
 #include "WAVM/IR/Module.h"
 #include "WAVM/Inline/BasicTypes.h"
+#include "WAVM/Inline/DenseIndexMap.h"
 #include "WAVM/Inline/DenseStaticIntSet.h"
 #include "WAVM/Inline/HashMap.h"
 #include "WAVM/Inline/HashSet.h"
-#include "WAVM/Inline/IndexMap.h"
 #include "WAVM/LLVMJIT/LLVMJIT.h"
 #include "WAVM/Platform/Defines.h"
+#include "WAVM/Platform/Fiber.h"
+#include "WAVM/Platform/Memory.h"
 #include "WAVM/Platform/Mutex.h"
 #include "WAVM/Runtime/Intrinsics.h"
+#include "WAVM/Runtime/Metrics.h"
 #include "WAVM/Runtime/Runtime.h"
 #include "WAVM/Runtime/RuntimeData.h"
 
 #include <atomic>
 #include <functional>
 #include <memory>
+#include <thread>
 
 namespace WAVM {
     namespace Intrinsics {
@@ -29,13 +33,18 @@ namespace WAVM {
         // A private base class for all runtime objects that are garbage collected.
         struct GCObject : Object {
             Compartment *const compartment;
+
+            // The number of root references to the object, as of the last time a collection added
+            // the changes that addGCRoot and removeGCRoot deferred to their thread's shard.
             std::atomic<Uptr> numRootReferences;
 
+            // Whether the object is in its compartment's young generation: i.e. it was created since
+            // the last collection that finished.
+            std::atomic<bool> isYoung;
+
             GCObject(ObjectKind inKind, Compartment *inCompartment);
 
-            virtual ~GCObject() {
-                wavmAssert(numRootReferences.load(std::memory_order_acquire) == 0);
-            }
+            virtual ~GCObject();
         };
 
         // An instance of a WebAssembly Table.
@@ -51,10 +60,15 @@ namespace WAVM {
             Element *elements = nullptr;
             Uptr numReservedBytes = 0;
             Uptr numReservedElements = 0;
+            bool isInRangeIndex = false;
 
             mutable Platform::Mutex resizingMutex;
             std::atomic<Uptr> numElements{0};
 
+            // Whether the table is in its compartment's remembered set of old tables that may
+            // reference young objects.
+            std::atomic<bool> isRemembered{false};
+
             Table(Compartment *inCompartment, const IR::TableType &inType, std::string &&inDebugName)
                     : GCObject(ObjectKind::table, inCompartment), type(inType), debugName(std::move(inDebugName)) {
             }
@@ -62,10 +76,10 @@ namespace WAVM {
             ~Table() override;
         };
 
-        // This is used as a sentinel value for table elements that are out-of-bounds. The address of
-        // this Object is subtracted from every address stored in the table, so zero-initialized pages
-        // at the end of the array will, when re-adding this Function's address, point to this Object.
-        extern Object *getOutOfBoundsElement();
+        // This is used as a sentinel value for table elements that are uninitialized, i.e. null. The
+        // address of this Object is subtracted from every address stored in the table, so the
+        // zero-filled pages committed when a table grows already contain uninitialized elements.
+        extern Object *getUninitializedElement();
 
         // An instance of a WebAssembly Memory.
         struct Memory : GCObject {
@@ -75,8 +89,29 @@ namespace WAVM {
 
             U8 *baseAddress = nullptr;
             Uptr numReservedBytes = 0;
+            bool isInRangeIndex = false;
 
-            mutable Platform::Mutex resizingMutex;
+            // Whether some of the memory's pages may be mapped from a page file.
+            bool isMappedFromPageFile = false;
+
+            // Whether the memory's reservation is aligned to and advised to use huge pages, in which
+            // case it may start after unalignedBaseAddress.
+            bool useHugePages = false;
+            U8 *unalignedBaseAddress = nullptr;
+
+            // Whether the memory only reserves enough address space for its maximum size, instead of
+            // enough for any 32-bit address and offset. Such a memory may only be accessed by code
+            // compiled with explicit memory bounds checks.
+            bool hasBoundedReservation = false;
+
+            // The NUMA node the memory's pages are placed on, or Platform::anyNUMANode to place them
+            // on its compartment's node.
+            Uptr numaNode = Platform::anyNUMANode;
+
+            // numClaimedPages is the size the memory will have when all in-progress grows finish, and
+            // numPages is the size of the memory's committed pages. A grow claims its pages with a CAS
+            // on numClaimedPages, commits them, then publishes them by advancing numPages.
+            std::atomic<Uptr> numClaimedPages{0};
             std::atomic<Uptr> numPages{0};
 
             Memory(Compartment *inCompartment, const IR::MemoryType &inType, std::string &&inDebugName)
@@ -117,17 +152,107 @@ namespace WAVM {
             ~ExceptionType() override;
         };
 
+        struct InterpreterModule;
+
+        // Creates the interpreter's state for a module compiled with the interpreter enabled, which
+        // holds the decoded code of its function definitions.
+        std::shared_ptr<InterpreterModule> createInterpreterModule(const IR::Module &irModule);
+
         // A compiled WebAssembly module.
         struct Module {
             IR::Module ir;
             std::vector<U8> objectCode;
-
-            Module(IR::Module &&inIR, std::vector<U8> &&inObjectCode) : ir(inIR), objectCode(std::move(inObjectCode)) {
+            LLVMJIT::CompileOptions compileOptions;
+
+            // The names of the module's functions, tables, memories and exception types, decoded by
+            // the first instantiation that needs them and shared by all later instantiations.
+            mutable Platform::Mutex disassemblyNamesMutex;
+            mutable std::unique_ptr<const IR::DisassemblyNames> disassemblyNames;
+
+            // The debug names of the module's function definitions for each module debug name it was
+            // instantiated with, shared by the FunctionMutableData objects of those instances. Each
+            // instance's FunctionMutableDataSlab owns the names it uses, so the map only holds weak
+            // references. The entries of debug names with no live instances are pruned once the map
+            // has grown to twice the number of entries that survived the previous prune.
+            mutable Platform::Mutex functionDefDebugNamesMutex;
+            mutable HashMap<std::string, std::weak_ptr<const std::vector<std::string>>> functionDefDebugNames;
+            mutable Uptr numFunctionDefDebugNamesToPrune = 16;
+
+            // If the module was compiled with the interpreter enabled, the decoded code of its function
+            // definitions, shared by all its instances.
+            std::shared_ptr<InterpreterModule> interpreterModule;
+
+            Module(IR::Module &&inIR, std::vector<U8> &&inObjectCode, const LLVMJIT::CompileOptions &inCompileOptions)
+                    : ir(std::move(inIR)), objectCode(std::move(inObjectCode)), compileOptions(inCompileOptions) {
+                if (compileOptions.enableInterpreter) {
+                    interpreterModule = createInterpreterModule(ir);
+                }
             }
         };
 
-        typedef HashMap<Uptr, std::shared_ptr<std::vector<U8>>> PassiveDataSegmentMap;
-        typedef HashMap<Uptr, std::shared_ptr<std::vector<Object *>>> PassiveElemSegmentMap;
+        // The state shared by a module instance compiled with tier-up enabled and the background
+        // thread that recompiles its hot functions. The thread holds a reference to it while
+        // compiling, so it stays valid if the instance is destroyed in the meantime. An instance
+        // compiled with lazy compilation or the interpreter enabled also uses it to compile
+        // functions on their first call, or once their interpreted code is hot.
+        struct TierUpState {
+            Platform::Mutex mutex;
+            bool isInstanceDestroyed = false;
+
+            // Whether specializeModuleInstance installed code specialized to the instance, which
+            // later tier-ups don't replace.
+            bool isSpecialized = false;
+
+            std::shared_ptr<const Module> module;
+
+            // The number of instances sharing the state: an instance and its clones in other
+            // compartments share the same code, so they share its recompiled code too.
+            Uptr numInstances = 1;
+
+            // Copies of the bindings used to load the instance's object code, for loading the
+            // object code of recompiled functions.
+            HashMap<std::string, LLVMJIT::FunctionBinding> wavmIntrinsicsExportMap;
+            std::vector<LLVMJIT::FunctionBinding> functionImports;
+            std::vector<LLVMJIT::TableBinding> tables;
+            std::vector<LLVMJIT::MemoryBinding> memories;
+            std::vector<LLVMJIT::GlobalBinding> globals;
+            std::vector<LLVMJIT::ExceptionTypeBinding> exceptionTypes;
+            Uptr moduleInstanceId;
+            Uptr tableReferenceBias;
+            Uptr numaNode;
+
+            // The instance's baseline function definitions.
+            std::vector<Function *> functionDefs;
+
+            // The JIT modules containing recompiled or lazily compiled functions, which are kept alive until the
+            // instance is destroyed.
+            std::vector<std::shared_ptr<LLVMJIT::Module>> tieredJITModules;
+        };
+
+        struct InstanceSnapshot {
+            struct MemoryDefSnapshot {
+                Uptr numPages;
+                Platform::PageFile *pageFile;
+            };
+
+            std::shared_ptr<const Module> module;
+            std::vector<MemoryDefSnapshot> memoryDefs;
+            std::vector<IR::Value> globalDefValues;
+
+            // The elements of each table definition as indices of the instance's functions, or
+            // UINTPTR_MAX for null elements. Empty if an element referred to any other object, in
+            // which case the tables are initialized from the module's active elem segments instead.
+            std::vector<std::vector<Uptr>> tableDefFunctionIndices;
+
+            ~InstanceSnapshot();
+        };
+
+        // The exports of an intrinsic module that are the same in every compartment: the thunks for
+        // its functions. They are created once per process, and shared by all the module's instances.
+        struct SharedIntrinsicExports {
+            std::vector<Function *> functions;
+            HashMap<std::string, Object *> exportMap;
+        };
 
         // An instance of a WebAssembly module.
         struct ModuleInstance : GCObject {
@@ -136,6 +261,10 @@ namespace WAVM {
 
             const HashMap<std::string, Object *> exportMap;
 
+            // For an instance of an intrinsic module, the exports it shares with the module's
+            // instances in other compartments. They are not duplicated in exportMap.
+            std::shared_ptr<const SharedIntrinsicExports> sharedExports;
+
             const std::vector<Function *> functions;
             const std::vector<Table *> tables;
             const std::vector<Memory *> memories;
@@ -144,21 +273,31 @@ namespace WAVM {
 
             Function *const startFunction;
 
-            mutable Platform::Mutex passiveDataSegmentsMutex;
-            PassiveDataSegmentMap passiveDataSegments;
+            // The module the instance was created from, which owns the contents of its passive data
+            // and elem segments. Null for intrinsic module instances.
+            const std::shared_ptr<const Module> module;
 
-            mutable Platform::Mutex passiveElemSegmentsMutex;
-            PassiveElemSegmentMap passiveElemSegments;
+            // Which of the module's data and elem segments have been dropped, or were active, and so
+            // may not be used by memory.init or table.init.
+            mutable Platform::Mutex droppedSegmentsMutex;
+            std::vector<bool> droppedDataSegments;
+            std::vector<bool> droppedElemSegments;
 
             const std::shared_ptr<LLVMJIT::Module> jitModule;
 
-            ModuleInstance(Compartment *inCompartment, Uptr inID, HashMap<std::string, Object *> &&inExportMap, std::vector<Function *> &&inFunctions, std::vector<Table *> &&inTables, std::vector<Memory *> &&inMemories, std::vector<Global *> &&inGlobals, std::vector<ExceptionType *> &&inExceptionTypes, Function *inStartFunction, PassiveDataSegmentMap &&inPassiveDataSegments, PassiveElemSegmentMap &&inPassiveElemSegments, std::shared_ptr<LLVMJIT::Module> &&inJITModule, std::string &&inDebugName)
+            // Non-null if the module was compiled with tier-up enabled.
+            std::shared_ptr<TierUpState> tierUpState;
+
+            // The bytes of the JIT module's image charged to the compartment's memory usage.
+            Uptr numChargedCodeBytes = 0;
+
+            ModuleInstance(Compartment *inCompartment, Uptr inID, HashMap<std::string, Object *> &&inExportMap, std::vector<Function *> &&inFunctions, std::vector<Table *> &&inTables, std::vector<Memory *> &&inMemories, std::vector<Global *> &&inGlobals, std::vector<ExceptionType *> &&inExceptionTypes, Function *inStartFunction, std::shared_ptr<const Module> inModule, std::vector<bool> &&inDroppedDataSegments, std::vector<bool> &&inDroppedElemSegments, std::shared_ptr<LLVMJIT::Module> &&inJITModule, std::string &&inDebugName)
                     : GCObject(ObjectKind::moduleInstance, inCompartment), id(inID), debugName(std::move(inDebugName)),
                       exportMap(std::move(inExportMap)), functions(std::move(inFunctions)), tables(std::move(inTables)),
                       memories(std::move(inMemories)), globals(std::move(inGlobals)),
                       exceptionTypes(std::move(inExceptionTypes)), startFunction(inStartFunction),
-                      passiveDataSegments(std::move(inPassiveDataSegments)),
-                      passiveElemSegments(std::move(inPassiveElemSegments)), jitModule(std::move(inJITModule)) {
+                      module(std::move(inModule)), droppedDataSegments(std::move(inDroppedDataSegments)),
+                      droppedElemSegments(std::move(inDroppedElemSegments)), jitModule(std::move(inJITModule)) {
             }
 
             virtual ~ModuleInstance() override;
@@ -168,33 +307,243 @@ namespace WAVM {
             Uptr id = UINTPTR_MAX;
             struct ContextRuntimeData *runtimeData = nullptr;
 
+            // The size of the pooled guest stacks that calls into the context run on, or 0 to run
+            // them on the calling thread's stack.
+            Uptr numStackBytes = 0;
+
             Context(Compartment *inCompartment) : GCObject(ObjectKind::context, inCompartment) {
             }
 
             ~Context();
         };
 
+        struct IncrementalGCState;
+
+        // The write barrier used by incremental garbage collection: while a collection of the
+        // compartment is marking, setTableElement adds the element it overwrites to shadedObjects.
+        struct GCWriteBarrier {
+            std::atomic<bool> isMarking{false};
+
+            // The number of in-bounds table element writes in progress, which the collector waits
+            // for before it finishes marking.
+            std::atomic<Uptr> numActiveWrites{0};
+
+            Platform::SpinMutex mutex;
+            std::vector<Object *> shadedObjects;
+        };
+
+        // A compartment's young generation: the objects created since the last collection that
+        // finished, and the remembered set of old tables that may reference them. The only other
+        // old objects that may reference young objects are mutable globals.
+        struct GCYoungGeneration {
+            Platform::SpinMutex mutex;
+            HashSet<GCObject *> objects;
+            HashSet<Table *> rememberedTables;
+        };
+
+        // The kinds of memory committed for a compartment's objects, which are counted separately
+        // by getCompartmentMemoryUsage.
+        enum class CompartmentMemoryKind {
+            memory,
+            table,
+            runtimeData,
+            code,
+            num
+        };
+
         struct Compartment : GCObject {
             mutable Platform::Mutex mutex;
 
             struct CompartmentRuntimeData *runtimeData;
             U8 *unalignedRuntimeData;
 
-            IndexMap<Uptr, Table *> tables;
-            IndexMap<Uptr, Memory *> memories;
-            IndexMap<Uptr, Global *> globals;
-            IndexMap<Uptr, ExceptionType *> exceptionTypes;
-            IndexMap<Uptr, ModuleInstance *> moduleInstances;
-            IndexMap<Uptr, Context *> contexts;
+            DenseIndexMap<Uptr, Table *> tables;
+            DenseIndexMap<Uptr, Memory *> memories;
+            DenseIndexMap<Uptr, Global *> globals;
+            DenseIndexMap<Uptr, ExceptionType *> exceptionTypes;
+            DenseIndexMap<Uptr, ModuleInstance *> moduleInstances;
+            DenseIndexMap<Uptr, Context *> contexts;
 
             DenseStaticIntSet<U32, maxMutableGlobals> globalDataAllocationMask;
             IR::UntaggedValue initialContextMutableGlobals[maxMutableGlobals];
 
-            Compartment();
+            // The number of context runtime data slots whose pages have been committed. Slots are
+            // never decommitted while the compartment is alive, so a context that reuses the ID of a
+            // destroyed context doesn't need to commit its pages again.
+            Uptr numCommittedContexts = 0;
+
+            // The bytes committed for the compartment's objects by kind, and their total, which
+            // tryChargeCompartmentMemory keeps at or below maxCommittedBytes.
+            std::atomic<Uptr> numCommittedBytesByKind[Uptr(CompartmentMemoryKind::num)];
+            std::atomic<Uptr> numCommittedBytes{0};
+            std::atomic<Uptr> maxCommittedBytes{UINTPTR_MAX};
+
+            // The NUMA node the compartment's objects, code and executor workers are placed on, or
+            // Platform::anyNUMANode for the OS's default placement.
+            const Uptr numaNode;
+
+            // The state of the incremental garbage collection in progress, or null.
+            IncrementalGCState *gcState = nullptr;
+            GCWriteBarrier gcWriteBarrier;
+            GCYoungGeneration gcYoungGeneration;
+
+            Compartment(Uptr inNUMANode = Platform::anyNUMANode);
 
             ~Compartment();
         };
 
+        // Adds bytes committed for one of a compartment's objects to its memory usage. Returns false
+        // without adding them if that would exceed the compartment's memory limit.
+        bool tryChargeCompartmentMemory(Compartment *compartment, CompartmentMemoryKind kind, Uptr numBytes);
+
+        // Adds bytes committed for one of a compartment's objects to its memory usage, even if that
+        // exceeds the compartment's memory limit.
+        void chargeCompartmentMemory(Compartment *compartment, CompartmentMemoryKind kind, Uptr numBytes);
+
+        // Subtracts bytes decommitted or freed from a compartment's memory usage.
+        void releaseCompartmentMemory(Compartment *compartment, CompartmentMemoryKind kind, Uptr numBytes);
+
+        // Adds an old table to its compartment's remembered set if a value written to it may be a
+        // young object.
+        void rememberTableWrite(Table *table, Object *value);
+
+        // Frees the state of an incremental garbage collection that didn't finish.
+        void destroyIncrementalGCState(IncrementalGCState *state);
+
+        // The kinds of address-space reservations that are pooled by allocateReservation and
+        // freeReservation.
+        enum class ReservationKind {
+            memory,
+            table,
+            compartment,
+            hugePageMemory
+        };
+
+        // Allocates an inaccessible address-space reservation, reusing one from the kind's pool if
+        // possible.
+        U8 *allocateReservation(ReservationKind kind, Uptr numPages);
+
+        // Frees a reservation allocated by allocateReservation, whose first numCommittedPages pages
+        // may have been committed. If the kind's pool isn't full, the reservation is decommitted
+        // and kept in the pool instead of being unmapped.
+        void freeReservation(ReservationKind kind, U8 *baseAddress, Uptr numPages, Uptr numCommittedPages);
+
+        // Like allocateReservation and freeReservation, but for kinds of reservations that are
+        // aligned to more than a page: compartment reservations are aligned to
+        // 2^compartmentRuntimeDataAlignmentLog2 bytes, and huge page memory reservations are aligned
+        // to the huge page size.
+        U8 *allocateAlignedReservation(ReservationKind kind, Uptr numPages, U8 *&outUnalignedBaseAddress);
+
+        void freeAlignedReservation(ReservationKind kind, U8 *baseAddress, U8 *unalignedBaseAddress, Uptr numPages, Uptr numCommittedPages);
+
+        // Evaluates an initializer expression of a module with the given globals.
+        IR::Value evaluateInitializer(const std::vector<Global *> &moduleGlobals, IR::InitializerExpression expression);
+
+        // Instantiates a module, and initializes it from a snapshot if it's non-null.
+        ModuleInstance *instantiateModuleImpl(Compartment *compartment, ModuleConstRefParam module, ImportBindings &&imports, const InstanceSnapshot *snapshot, std::string &&debugName);
+
+        // Sets the elements of an instance's table definitions to the functions a snapshot captured
+        // them as referring to.
+        void initTableDefsFromSnapshot(ModuleInstance *moduleInstance, const InstanceSnapshot &snapshot);
+
+        // Grows a table by numElementsToGrow elements, and returns its previous size, or -1 if it
+        // would exceed the table's maximum size or the compartment's memory limit.
+        Iptr growTable(Table *table, Uptr numElementsToGrow);
+
+        // Creates a memory with numPages pages mapped copy-on-write from a page file.
+        Memory *createMemoryFromPageFile(Compartment *compartment, IR::MemoryType type, Platform::PageFile *pageFile, Uptr numPages, bool boundedReservation, std::string &&debugName);
+
+        // Adds a value to one of the process-wide metric counters.
+        void addToMetric(Metrics::Counter counter, U64 value = 1);
+
+        // Adds a sample to one of the process-wide metric histograms.
+        void recordMetricSample(Metrics::Histogram histogram, U64 value);
+
+        // Records the time from its construction to its destruction in a metric histogram.
+        struct MetricTimer {
+            MetricTimer(Metrics::Histogram inHistogram);
+
+            ~MetricTimer();
+
+        private:
+            Metrics::Histogram histogram;
+            U64 startTime;
+        };
+
+        // Compiles a module to object code, or loads the object code from the on-disk cache if a
+        // cache directory was set with setObjectCacheDirectory.
+        std::vector<U8> compileModuleWithObjectCache(const IR::Module &irModule, const LLVMJIT::CompileOptions &options);
+
+        // Returns a live module compiled from the same IR with the same options if there is one, and
+        // otherwise compiles the module with compileModuleWithObjectCache. Concurrent calls for the
+        // same module and options wait for a single compile.
+        ModuleRef compileModuleWithModuleCache(const IR::Module &irModule, const LLVMJIT::CompileOptions &options);
+
+        // Queues a job to run on one of the runtime's compilation threads, which are shared by
+        // asynchronous module compiles and tier-up.
+        void queueCompileJob(CompilePriority priority, std::function<void()> &&job);
+
+        // Queues a function of a module instance compiled with tier-up enabled to be recompiled at
+        // the module's tier-up optimization level.
+        void queueTierUp(const std::shared_ptr<TierUpState> &tierUpState, Uptr functionDefIndex);
+
+        // Compiles a function definition of an instance that was compiled with lazy compilation or
+        // the interpreter enabled, and returns its code. This is called by the function's stub the
+        // first time it is called, so the instance can't be destroyed until it returns.
+        const U8 *compileLazyFunction(TierUpState &tierUpState, Uptr functionDefIndex);
+
+        // Gets or sets the function the calling thread is interpreting, so a signal raised by the
+        // interpreter can be attributed to it. It is null while the interpreter calls native or
+        // compiled code.
+        Function *getInterpretedFunction();
+        void setInterpretedFunction(Function *function);
+
+        // Raises a trap detected by a check in the code, jumping straight to the innermost catchTraps
+        // on the thread without raising a signal or unwinding the frames in between. The trap is
+        // attributed to the function containing instructionAddress, or if there is none, to the
+        // interpreted function.
+        [[noreturn]] void raiseTrap(Trap::Type type, Uptr instructionAddress = 0);
+
+        struct ExecutorTask;
+
+        struct Invocation {
+            Context *context;
+            Function *function;
+            std::vector<IR::UntaggedValue> arguments;
+            std::vector<IR::UntaggedValue> results;
+
+            InvocationState state = InvocationState::suspended;
+            Trap trap;
+
+            Platform::Fiber *fiber = nullptr;
+            Uptr numStackBytes = 0;
+            std::thread::id threadId;
+
+            // The function being interpreted by the invocation when it was suspended.
+            Function *interpretedFunction = nullptr;
+
+            // The executor task that started the invocation, or null if it wasn't started by an
+            // executor.
+            ExecutorTask *executorTask = nullptr;
+
+            bool isRunning = false;
+        };
+
+        // Creates an invocation like startInvocation, but doesn't run it until it is passed to
+        // resumeInvocation, which must be called on the calling thread.
+        Invocation *createInvocation(Context *context, Function *function, const IR::UntaggedValue *arguments, Uptr numStackBytes);
+
+        // Returns a fiber that calls entry(argument) when it is resumed, on a guest stack of
+        // numStackBytes with guard pages below it, reusing a freed stack of that size if there is
+        // one. The fiber is freed by passing it and the same size to releaseGuestStack.
+        Platform::Fiber *acquireGuestStack(Uptr numStackBytes, Platform::FiberEntry entry, void *argument);
+        void releaseGuestStack(Platform::Fiber *fiber, Uptr numStackBytes);
+
+        // Calls thunk on a guest stack of the context's stack size, or directly if the context has no
+        // stack size or the caller is already on a guest stack. Exceptions and the signals caught by
+        // the caller's catchSignals propagate out of the call as if the thunk was called directly.
+        void callOnContextStack(Context *context, const std::function<void()> &thunk);
+
         DECLARE_INTRINSIC_MODULE(wavmIntrinsics);
 
         void dummyReferenceAtomics();
@@ -209,6 +558,10 @@ namespace WAVM {
 
         bool isAddressOwnedByMemory(U8 *address, Memory *&outMemory, Uptr &outMemoryAddress);
 
+        // Maps an object in a compartment to the object with the same ID in a clone of the compartment.
+        // Functions are shared by the clones, so they map to themselves.
+        Object *remapToClonedCompartment(Object *object, const Compartment *newCompartment);
+
         // Clones objects into a new compartment with the same ID.
         Table *cloneTable(Table *memory, Compartment *newCompartment);
 
@@ -221,6 +574,8 @@ namespace WAVM {
         // Clone a global with same ID and mutable data offset (if mutable) in a new compartment.
         Global *cloneGlobal(Global *global, Compartment *newCompartment);
 
+        Context *getContextFromRuntimeData(ContextRuntimeData *contextRuntimeData);
+
         ModuleInstance *getModuleInstanceFromRuntimeData(ContextRuntimeData *contextRuntimeData, Uptr moduleInstanceId);
 
         Table *getTableFromRuntimeData(ContextRuntimeData *contextRuntimeData, Uptr tableId);
@@ -228,3 +583,7 @@ namespace WAVM {
         Memory *getMemoryFromRuntimeData(ContextRuntimeData *contextRuntimeData, Uptr memoryId);
     }
 }
+
+// The intrinsics that raise traps are called by compiled code when a check fails, and attribute the
+// trap to the call instruction: the byte before the return address.
+#define GET_TRAP_ADDRESS() (Uptr(__builtin_return_address(0)) - 1)
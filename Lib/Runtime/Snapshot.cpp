@@ -0,0 +1,384 @@
+#include <stdio.h>
+#include <string.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "RuntimePrivate.h"
+#include "WAVM/IR/IR.h"
+#include "WAVM/Inline/Hash.h"
+#include "WAVM/Inline/HashMap.h"
+#include "WAVM/Inline/Lock.h"
+#include "WAVM/Inline/Serialization.h"
+#include "WAVM/Platform/Memory.h"
+#include "WAVM/Platform/Thread.h"
+#include "WAVM/Runtime/Runtime.h"
+
+using namespace WAVM;
+using namespace WAVM::IR;
+using namespace WAVM::Runtime;
+using namespace WAVM::Serialization;
+
+// The version of the checkpoint file format. Bump this whenever the format changes.
+static constexpr U32 checkpointVersion = 1;
+
+static const char checkpointMagic[8] = {'W', 'A', 'V', 'M', 'C', 'K', 'P', 'T'};
+
+// The header at the start of a checkpoint file. The memory images follow it at page-aligned
+// offsets, so they can be mapped from the file. The module is identified by a hash of its object
+// code, so a checkpoint is only loaded for the module it was written for, e.g. as loaded from the
+// same precompiled module file.
+struct CheckpointHeader {
+    struct MemoryDef {
+        U64 numPages;
+        U64 fileOffset;
+    };
+
+    U32 version;
+    U64 objectCodeHash;
+    U64 objectCodeNumBytes;
+    std::vector<MemoryDef> memoryDefs;
+    std::vector<V128> globalDefValues;
+    U8 hasTableDefs;
+    std::vector<std::vector<U64>> tableDefFunctionIndices;
+};
+
+template<typename Stream> static void serialize(Stream &stream, CheckpointHeader &header) {
+    char magic[sizeof(checkpointMagic)];
+    memcpy(magic, checkpointMagic, sizeof(magic));
+    serializeBytes(stream, (U8 *) magic, sizeof(magic));
+    if (memcmp(magic, checkpointMagic, sizeof(magic))) {
+        throw FatalSerializationException("not a WAVM checkpoint file");
+    }
+
+    Serialization::serialize(stream, header.version);
+    if (header.version != checkpointVersion) {
+        throw FatalSerializationException("unsupported checkpoint version");
+    }
+    Serialization::serialize(stream, header.objectCodeHash);
+    Serialization::serialize(stream, header.objectCodeNumBytes);
+    serializeArray(stream, header.memoryDefs, [](Stream &stream, CheckpointHeader::MemoryDef &memoryDef) {
+        Serialization::serialize(stream, memoryDef.numPages);
+        Serialization::serialize(stream, memoryDef.fileOffset);
+    });
+    serializeArray(stream, header.globalDefValues, [](Stream &stream, V128 &value) { serializeBytes(stream, value.u8, sizeof(value.u8)); });
+    Serialization::serialize(stream, header.hasTableDefs);
+    serializeArray(stream, header.tableDefFunctionIndices, [](Stream &stream, std::vector<U64> &functionIndices) { Serialization::serialize(stream, functionIndices); });
+}
+
+static U64 hashObjectCode(const Runtime::Module &module) {
+    return XXH<U64>(module.objectCode.data(), module.objectCode.size(), 0);
+}
+
+Runtime::InstanceSnapshot::~InstanceSnapshot() {
+    for (const MemoryDefSnapshot &memoryDef : memoryDefs) {
+        if (memoryDef.pageFile) {
+            Platform::destroyPageFile(memoryDef.pageFile);
+        }
+    }
+}
+
+InstanceSnapshotRef Runtime::snapshotModuleInstance(ModuleConstRefParam module, ModuleInstance *moduleInstance, Context *context) {
+    errorUnless(moduleInstance->compartment == context->compartment);
+    errorUnless(moduleInstance->memories.size() == module->ir.memories.size());
+    errorUnless(moduleInstance->globals.size() == module->ir.globals.size());
+
+    auto snapshot = std::make_shared<InstanceSnapshot>();
+    snapshot->module = module;
+
+    // Copy the committed pages of each memory definition to a page file.
+    const Uptr platformPagesPerWebAssemblyPageLog2 = IR::numBytesPerPageLog2 - Platform::getPageSizeLog2();
+    for (Uptr memoryDefIndex = 0; memoryDefIndex < module->ir.memories.defs.size(); ++memoryDefIndex) {
+        Memory *memory = moduleInstance->memories[module->ir.memories.imports.size() + memoryDefIndex];
+
+        const Uptr numPages = memory->numPages.load(std::memory_order_acquire);
+        Platform::PageFile *pageFile = Platform::createPageFile(memory->baseAddress, numPages << platformPagesPerWebAssemblyPageLog2);
+        if (!pageFile) {
+            return nullptr;
+        }
+        snapshot->memoryDefs.push_back({numPages, pageFile});
+    }
+
+    // Capture the elements of the table definitions as indices of the instance's functions, if they
+    // all refer to its functions or are null.
+    HashMap<Object *, Uptr> functionIndexMap;
+    for (Uptr functionIndex = 0; functionIndex < moduleInstance->functions.size(); ++functionIndex) {
+        functionIndexMap.set(asObject(moduleInstance->functions[functionIndex]), functionIndex);
+    }
+    for (Uptr tableDefIndex = 0; tableDefIndex < module->ir.tables.defs.size(); ++tableDefIndex) {
+        Table *table = moduleInstance->tables[module->ir.tables.imports.size() + tableDefIndex];
+
+        std::vector<Uptr> functionIndices;
+        const Uptr numElements = getTableNumElements(table);
+        for (Uptr elementIndex = 0; elementIndex < numElements; ++elementIndex) {
+            Object *element = getTableElement(table, elementIndex);
+            const Uptr *functionIndex = element ? functionIndexMap.get(element) : nullptr;
+            if (element && !functionIndex) {
+                break;
+            }
+            functionIndices.push_back(element ? *functionIndex : UINTPTR_MAX);
+        }
+        if (functionIndices.size() != numElements) {
+            snapshot->tableDefFunctionIndices.clear();
+            break;
+        }
+        snapshot->tableDefFunctionIndices.push_back(std::move(functionIndices));
+    }
+
+    // Read the values of the mutable global definitions from the context.
+    for (Uptr globalDefIndex = 0; globalDefIndex < module->ir.globals.defs.size(); ++globalDefIndex) {
+        Global *global = moduleInstance->globals[module->ir.globals.imports.size() + globalDefIndex];
+        if (global->type.isMutable) {
+            snapshot->globalDefValues.push_back(IR::Value(global->type.valueType, context->runtimeData->mutableGlobals[global->mutableGlobalIndex]));
+        } else {
+            snapshot->globalDefValues.push_back(IR::Value(global->type.valueType, global->initialValue));
+        }
+    }
+
+    return snapshot;
+}
+
+ModuleInstance *Runtime::instantiateModuleFromSnapshot(Compartment *compartment, ModuleConstRefParam module, ImportBindings &&imports, const InstanceSnapshotRef &snapshot, std::string &&debugName) {
+    errorUnless(snapshot && snapshot->module == module);
+    return instantiateModuleImpl(compartment, module, std::move(imports), snapshot.get(), std::move(debugName));
+}
+
+void Runtime::initTableDefsFromSnapshot(ModuleInstance *moduleInstance, const InstanceSnapshot &snapshot) {
+    const IR::Module &irModule = snapshot.module->ir;
+    wavmAssert(snapshot.tableDefFunctionIndices.size() == irModule.tables.defs.size());
+    for (Uptr tableDefIndex = 0; tableDefIndex < irModule.tables.defs.size(); ++tableDefIndex) {
+        Table *table = moduleInstance->tables[irModule.tables.imports.size() + tableDefIndex];
+        const std::vector<Uptr> &functionIndices = snapshot.tableDefFunctionIndices[tableDefIndex];
+
+        // The table was grown to the snapshotted table's size when it was created. Elements beyond
+        // the end of the snapshotted table, which a reset instance's table may have grown by, are
+        // cleared.
+        const Uptr numElements = getTableNumElements(table);
+        wavmAssert(numElements >= functionIndices.size());
+        for (Uptr elementIndex = 0; elementIndex < numElements; ++elementIndex) {
+            const Uptr functionIndex = elementIndex < functionIndices.size() ? functionIndices[elementIndex] : UINTPTR_MAX;
+            wavmAssert(functionIndex == UINTPTR_MAX || functionIndex < moduleInstance->functions.size());
+            setTableElement(table, elementIndex, functionIndex == UINTPTR_MAX ? nullptr : asObject(moduleInstance->functions[functionIndex]));
+        }
+    }
+}
+
+void Runtime::resetModuleInstance(ModuleInstance *moduleInstance, Context *context, const InstanceSnapshotRef &snapshot) {
+    errorUnless(snapshot && snapshot->module == moduleInstance->module);
+    errorUnless(moduleInstance->compartment == context->compartment);
+    const std::shared_ptr<const Module> &module = snapshot->module;
+
+    // Revert the written pages of each memory definition to the snapshot's page file, and decommit
+    // the pages it grew by since it was created.
+    const Uptr platformPagesPerWebAssemblyPageLog2 = IR::numBytesPerPageLog2 - Platform::getPageSizeLog2();
+    for (Uptr memoryDefIndex = 0; memoryDefIndex < module->ir.memories.defs.size(); ++memoryDefIndex) {
+        Memory *memory = moduleInstance->memories[module->ir.memories.imports.size() + memoryDefIndex];
+        const InstanceSnapshot::MemoryDefSnapshot &memorySnapshot = snapshot->memoryDefs[memoryDefIndex];
+        errorUnless(memory->isMappedFromPageFile);
+
+        const Uptr numPages = memory->numPages.load(std::memory_order_acquire);
+        errorUnless(numPages >= memorySnapshot.numPages);
+        if (numPages > memorySnapshot.numPages) {
+            memory->numPages.store(memorySnapshot.numPages, std::memory_order_release);
+            memory->numClaimedPages.store(memorySnapshot.numPages, std::memory_order_release);
+            if (memory->id != UINTPTR_MAX) {
+                context->compartment->runtimeData->memoryNumBytes[memory->id].store(memorySnapshot.numPages * IR::numBytesPerPage, std::memory_order_release);
+            }
+            Platform::decommitVirtualPages(memory->baseAddress + memorySnapshot.numPages * IR::numBytesPerPage, (numPages - memorySnapshot.numPages) << platformPagesPerWebAssemblyPageLog2);
+            releaseCompartmentMemory(memory->compartment, CompartmentMemoryKind::memory, (numPages - memorySnapshot.numPages) * IR::numBytesPerPage);
+        }
+
+        Platform::revertPageFileCopyOnWrite(memorySnapshot.pageFile, memory->baseAddress, memorySnapshot.numPages << platformPagesPerWebAssemblyPageLog2);
+    }
+
+    // Restore the values of the mutable global definitions in the context.
+    for (Uptr globalDefIndex = 0; globalDefIndex < module->ir.globals.defs.size(); ++globalDefIndex) {
+        Global *global = moduleInstance->globals[module->ir.globals.imports.size() + globalDefIndex];
+        if (global->type.isMutable && !isReferenceType(global->type.valueType)) {
+            context->runtimeData->mutableGlobals[global->mutableGlobalIndex] = snapshot->globalDefValues[globalDefIndex];
+        }
+    }
+
+    // Restore the table definitions from the snapshot if it captured them. Otherwise, clear them,
+    // and copy the active elem segments into them again.
+    if (!snapshot->tableDefFunctionIndices.empty()) {
+        initTableDefsFromSnapshot(moduleInstance, *snapshot);
+    } else {
+        for (Uptr tableDefIndex = 0; tableDefIndex < module->ir.tables.defs.size(); ++tableDefIndex) {
+            Table *table = moduleInstance->tables[module->ir.tables.imports.size() + tableDefIndex];
+            const Uptr numElements = getTableNumElements(table);
+            for (Uptr elementIndex = 0; elementIndex < numElements; ++elementIndex) {
+                setTableElement(table, elementIndex, nullptr);
+            }
+        }
+        for (const ElemSegment &elemSegment : module->ir.elemSegments) {
+            if (elemSegment.isActive && elemSegment.tableIndex >= module->ir.tables.imports.size()) {
+                Table *table = moduleInstance->tables[elemSegment.tableIndex];
+
+                const Value baseOffsetValue = evaluateInitializer(moduleInstance->globals, elemSegment.baseOffset);
+                errorUnless(baseOffsetValue.type == ValueType::i32);
+                const U32 baseOffset = baseOffsetValue.i32;
+
+                for (Uptr index = 0; index < elemSegment.indices.size(); ++index) {
+                    const Uptr functionIndex = elemSegment.indices[index];
+                    wavmAssert(functionIndex < moduleInstance->functions.size());
+                    setTableElement(table, baseOffset + index, asObject(moduleInstance->functions[functionIndex]));
+                }
+            }
+        }
+    }
+
+    // Undo any data.drop and elem.drop: the active segments are still dropped.
+    Lock<Platform::Mutex> droppedSegmentsLock(moduleInstance->droppedSegmentsMutex);
+    for (Uptr segmentIndex = 0; segmentIndex < module->ir.dataSegments.size(); ++segmentIndex) {
+        moduleInstance->droppedDataSegments[segmentIndex] = module->ir.dataSegments[segmentIndex].isActive;
+    }
+    for (Uptr segmentIndex = 0; segmentIndex < module->ir.elemSegments.size(); ++segmentIndex) {
+        moduleInstance->droppedElemSegments[segmentIndex] = module->ir.elemSegments[segmentIndex].isActive;
+    }
+}
+
+bool Runtime::saveInstanceSnapshot(const InstanceSnapshotRef &snapshot, const std::string &path) {
+    const IR::Module &irModule = snapshot->module->ir;
+
+    CheckpointHeader header;
+    header.version = checkpointVersion;
+    header.objectCodeHash = hashObjectCode(*snapshot->module);
+    header.objectCodeNumBytes = snapshot->module->objectCode.size();
+    for (const InstanceSnapshot::MemoryDefSnapshot &memoryDef : snapshot->memoryDefs) {
+        header.memoryDefs.push_back({memoryDef.numPages, 0});
+    }
+    for (Uptr globalDefIndex = 0; globalDefIndex < irModule.globals.defs.size(); ++globalDefIndex) {
+        // Reference-typed globals aren't restored from snapshots, so their values aren't written.
+        V128 value{};
+        if (!isReferenceType(irModule.globals.defs[globalDefIndex].type.valueType)) {
+            value = snapshot->globalDefValues[globalDefIndex].v128;
+        }
+        header.globalDefValues.push_back(value);
+    }
+    header.hasTableDefs = snapshot->tableDefFunctionIndices.empty() ? 0 : 1;
+    for (const std::vector<Uptr> &functionIndices : snapshot->tableDefFunctionIndices) {
+        header.tableDefFunctionIndices.push_back(std::vector<U64>(functionIndices.begin(), functionIndices.end()));
+    }
+
+    // The header's size doesn't depend on the memory images' offsets, so serialize it once to find
+    // where the images start, and again with their offsets.
+    const Uptr pageSizeLog2 = Platform::getPageSizeLog2();
+    const Uptr platformPagesPerWebAssemblyPageLog2 = IR::numBytesPerPageLog2 - pageSizeLog2;
+    ArrayOutputStream sizingStream;
+    serialize(sizingStream, header);
+    U64 nextFileOffset = (U64(sizingStream.getBytes().size()) + (U64(1) << pageSizeLog2) - 1) & ~((U64(1) << pageSizeLog2) - 1);
+    for (CheckpointHeader::MemoryDef &memoryDef : header.memoryDefs) {
+        memoryDef.fileOffset = nextFileOffset;
+        nextFileOffset += (memoryDef.numPages << platformPagesPerWebAssemblyPageLog2) << pageSizeLog2;
+    }
+    ArrayOutputStream headerStream;
+    serialize(headerStream, header);
+    const std::vector<U8> headerBytes = headerStream.getBytes();
+
+    // Write to a temporary file and rename it over the destination, so a process restarting
+    // concurrently never observes a partially written checkpoint.
+    const std::string tempPath = path + ".tmp" + std::to_string(Platform::getProcessId());
+    FILE *file = fopen(tempPath.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    const bool wroteHeader = fwrite(headerBytes.data(), 1, headerBytes.size(), file) == headerBytes.size();
+    if (fclose(file) || !wroteHeader) {
+        remove(tempPath.c_str());
+        return false;
+    }
+
+    for (Uptr memoryDefIndex = 0; memoryDefIndex < snapshot->memoryDefs.size(); ++memoryDefIndex) {
+        if (!Platform::writePageFile(snapshot->memoryDefs[memoryDefIndex].pageFile, tempPath.c_str(), header.memoryDefs[memoryDefIndex].fileOffset)) {
+            remove(tempPath.c_str());
+            return false;
+        }
+    }
+
+    if (rename(tempPath.c_str(), path.c_str())) {
+        remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+InstanceSnapshotRef Runtime::loadInstanceSnapshot(ModuleConstRefParam module, const std::string &path) {
+    const IR::Module &irModule = module->ir;
+
+    // Read the header from a mapping of the file, so the memory images after it aren't read.
+    Platform::MappedFile *mappedFile = Platform::mapFile(path.c_str());
+    if (!mappedFile) {
+        return nullptr;
+    }
+    CheckpointHeader header;
+    try {
+        MemoryInputStream stream(Platform::getMappedFileBytes(mappedFile), Platform::getMappedFileNumBytes(mappedFile));
+        serialize(stream, header);
+    } catch (const FatalSerializationException &) {
+        Platform::unmapFile(mappedFile);
+        return nullptr;
+    }
+    Platform::unmapFile(mappedFile);
+
+    // Check that the checkpoint was written for the module.
+    if (header.objectCodeHash != hashObjectCode(*module) || header.objectCodeNumBytes != module->objectCode.size() ||
+        header.memoryDefs.size() != irModule.memories.defs.size() || header.globalDefValues.size() != irModule.globals.defs.size() ||
+        (header.hasTableDefs && header.tableDefFunctionIndices.size() != irModule.tables.defs.size())) {
+        return nullptr;
+    }
+    for (Uptr tableDefIndex = 0; tableDefIndex < header.tableDefFunctionIndices.size(); ++tableDefIndex) {
+        const std::vector<U64> &functionIndices = header.tableDefFunctionIndices[tableDefIndex];
+        const IR::SizeConstraints &size = irModule.tables.defs[tableDefIndex].type.size;
+        if (functionIndices.size() < size.min || functionIndices.size() > size.max || functionIndices.size() > IR::maxTableElems) {
+            return nullptr;
+        }
+        for (U64 functionIndex : functionIndices) {
+            if (functionIndex != UINTPTR_MAX && functionIndex >= irModule.functions.size()) {
+                return nullptr;
+            }
+        }
+    }
+
+    // Each memory image must be at an offset aligned to this host's page size, which may differ
+    // from the page size of the host that wrote the checkpoint.
+    const U64 pageSize = U64(1) << Platform::getPageSizeLog2();
+    for (Uptr memoryDefIndex = 0; memoryDefIndex < header.memoryDefs.size(); ++memoryDefIndex) {
+        const CheckpointHeader::MemoryDef &memoryDef = header.memoryDefs[memoryDefIndex];
+        const IR::SizeConstraints &size = irModule.memories.defs[memoryDefIndex].type.size;
+        if (memoryDef.numPages < size.min || memoryDef.numPages > size.max || memoryDef.numPages > IR::maxMemoryPages) {
+            return nullptr;
+        }
+        const U64 numBytes = memoryDef.numPages * IR::numBytesPerPage;
+        if ((memoryDef.fileOffset & (pageSize - 1)) || memoryDef.fileOffset > UINT64_MAX - numBytes) {
+            return nullptr;
+        }
+    }
+
+    auto snapshot = std::make_shared<InstanceSnapshot>();
+    snapshot->module = module;
+
+    // Open a page file for each memory image, so the instances created from the snapshot map their
+    // pages from the checkpoint file instead of reading them.
+    const Uptr platformPagesPerWebAssemblyPageLog2 = IR::numBytesPerPageLog2 - Platform::getPageSizeLog2();
+    for (Uptr memoryDefIndex = 0; memoryDefIndex < irModule.memories.defs.size(); ++memoryDefIndex) {
+        const CheckpointHeader::MemoryDef &memoryDef = header.memoryDefs[memoryDefIndex];
+        Platform::PageFile *pageFile = Platform::openPageFile(path.c_str(), memoryDef.fileOffset, Uptr(memoryDef.numPages) << platformPagesPerWebAssemblyPageLog2);
+        if (!pageFile) {
+            return nullptr;
+        }
+        snapshot->memoryDefs.push_back({Uptr(memoryDef.numPages), pageFile});
+    }
+
+    for (Uptr globalDefIndex = 0; globalDefIndex < irModule.globals.defs.size(); ++globalDefIndex) {
+        snapshot->globalDefValues.push_back(IR::Value(irModule.globals.defs[globalDefIndex].type.valueType, header.globalDefValues[globalDefIndex]));
+    }
+
+    if (header.hasTableDefs) {
+        for (const std::vector<U64> &functionIndices : header.tableDefFunctionIndices) {
+            snapshot->tableDefFunctionIndices.push_back(std::vector<Uptr>(functionIndices.begin(), functionIndices.end()));
+        }
+    }
+
+    return snapshot;
+}
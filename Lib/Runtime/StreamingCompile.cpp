@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "RuntimePrivate.h"
+#include "WAVM/IR/Module.h"
+#include "WAVM/LLVMJIT/LLVMJIT.h"
+#include "WAVM/Runtime/Runtime.h"
+
+using namespace WAVM;
+using namespace WAVM::IR;
+using namespace WAVM::Runtime;
+
+// Compiling a range of function definitions has a fixed cost for creating the LLVM context and
+// emitting the module's imported symbols, so function definitions are only queued for compilation
+// once at least this many bytes of their code have been decoded.
+static constexpr Uptr minStreamingPartitionCodeBytes = 16 * 1024;
+
+struct StreamingPartition {
+    Uptr partitionIndex;
+    Uptr beginFunctionDefIndex;
+    Uptr endFunctionDefIndex;
+};
+
+struct Runtime::StreamingCompile {
+    const IR::Module &irModule;
+    const LLVMJIT::CompileOptions options;
+
+    // The function definitions that have been added, but not queued for compilation yet.
+    Uptr nextFunctionDefIndex = 0;
+    Uptr beginPendingFunctionDefIndex = 0;
+    Uptr numPendingCodeBytes = 0;
+
+    std::mutex mutex;
+    std::condition_variable partitionQueued;
+    std::deque<StreamingPartition> queuedPartitions;
+    std::vector<std::vector<U8>> partitionObjectCodes;
+    bool isFinishing = false;
+
+    std::vector<std::thread> threads;
+
+    StreamingCompile(const IR::Module &inIRModule, const LLVMJIT::CompileOptions &inOptions)
+            : irModule(inIRModule), options(inOptions) {
+    }
+};
+
+// Compiles queued partitions until the streaming compile is finishing and there are no more queued
+// partitions.
+static void compileStreamingPartitions(StreamingCompile *streamingCompile) {
+    while (true) {
+        StreamingPartition partition;
+        {
+            std::unique_lock<std::mutex> lock(streamingCompile->mutex);
+            streamingCompile->partitionQueued.wait(lock, [streamingCompile] {
+                return streamingCompile->isFinishing || !streamingCompile->queuedPartitions.empty();
+            });
+            if (streamingCompile->queuedPartitions.empty()) {
+                return;
+            }
+            partition = streamingCompile->queuedPartitions.front();
+            streamingCompile->queuedPartitions.pop_front();
+        }
+
+        std::vector<U8> objectCode = LLVMJIT::compileFunctionDefs(streamingCompile->irModule, partition.beginFunctionDefIndex, partition.endFunctionDefIndex, streamingCompile->options);
+
+        std::lock_guard<std::mutex> lock(streamingCompile->mutex);
+        streamingCompile->partitionObjectCodes[partition.partitionIndex] = std::move(objectCode);
+    }
+}
+
+// Queues the pending function definitions for compilation, starting another compile thread if
+// there are fewer than the number of hardware threads.
+static void queuePendingFunctionDefs(StreamingCompile *streamingCompile) {
+    {
+        std::lock_guard<std::mutex> lock(streamingCompile->mutex);
+        const Uptr partitionIndex = streamingCompile->partitionObjectCodes.size();
+        streamingCompile->partitionObjectCodes.emplace_back();
+        streamingCompile->queuedPartitions.push_back({partitionIndex, streamingCompile->beginPendingFunctionDefIndex, streamingCompile->nextFunctionDefIndex});
+    }
+    streamingCompile->partitionQueued.notify_one();
+
+    streamingCompile->beginPendingFunctionDefIndex = streamingCompile->nextFunctionDefIndex;
+    streamingCompile->numPendingCodeBytes = 0;
+
+    const Uptr numHardwareThreads = std::max(Uptr(std::thread::hardware_concurrency()), Uptr(1));
+    if (streamingCompile->threads.size() < numHardwareThreads) {
+        streamingCompile->threads.emplace_back(compileStreamingPartitions, streamingCompile);
+    }
+}
+
+StreamingCompile *Runtime::beginStreamingCompile(const IR::Module &irModule, const LLVMJIT::CompileOptions &options) {
+    return new StreamingCompile(irModule, options);
+}
+
+void Runtime::addStreamingCompileFunctionDef(StreamingCompile *streamingCompile, Uptr functionDefIndex) {
+    wavmAssert(functionDefIndex == streamingCompile->nextFunctionDefIndex);
+    wavmAssert(functionDefIndex < streamingCompile->irModule.functions.defs.size());
+    ++streamingCompile->nextFunctionDefIndex;
+    streamingCompile->numPendingCodeBytes += streamingCompile->irModule.functions.defs[functionDefIndex].code.size();
+    if (streamingCompile->numPendingCodeBytes >= minStreamingPartitionCodeBytes) {
+        queuePendingFunctionDefs(streamingCompile);
+    }
+}
+
+// Lets the compile threads exit once the queued partitions are compiled, helps compile them on the
+// calling thread, and waits for the compile threads to exit.
+static void joinStreamingCompileThreads(StreamingCompile *streamingCompile) {
+    {
+        std::lock_guard<std::mutex> lock(streamingCompile->mutex);
+        streamingCompile->isFinishing = true;
+    }
+    streamingCompile->partitionQueued.notify_all();
+
+    compileStreamingPartitions(streamingCompile);
+    for (std::thread &thread : streamingCompile->threads) {
+        thread.join();
+    }
+}
+
+ModuleRef Runtime::finishStreamingCompile(StreamingCompile *streamingCompile, IR::Module &&irModule) {
+    wavmAssert(&irModule == &streamingCompile->irModule);
+    wavmAssert(streamingCompile->nextFunctionDefIndex == irModule.functions.defs.size());
+
+    // Queue the last function definitions. A module without function definitions still needs
+    // object code for loadModule to bind its symbols.
+    if (streamingCompile->beginPendingFunctionDefIndex < streamingCompile->nextFunctionDefIndex ||
+        streamingCompile->partitionObjectCodes.empty()) {
+        queuePendingFunctionDefs(streamingCompile);
+    }
+    joinStreamingCompileThreads(streamingCompile);
+
+    std::vector<U8> objectCode = LLVMJIT::combineObjectCode(streamingCompile->partitionObjectCodes);
+    const LLVMJIT::CompileOptions options = streamingCompile->options;
+    delete streamingCompile;
+
+    return std::make_shared<Runtime::Module>(std::move(irModule), std::move(objectCode), options);
+}
+
+void Runtime::abortStreamingCompile(StreamingCompile *streamingCompile) {
+    {
+        std::lock_guard<std::mutex> lock(streamingCompile->mutex);
+        streamingCompile->queuedPartitions.clear();
+    }
+    joinStreamingCompileThreads(streamingCompile);
+    delete streamingCompile;
+}
@@ -4,15 +4,16 @@
 #include <iostream>
 
 #include "RuntimePrivate.h"
+#include "WAVM/Inline/AddressRangeIndex.h"
 #include "WAVM/Inline/Lock.h"
 #include "WAVM/Platform/Memory.h"
 
 using namespace WAVM;
 using namespace WAVM::Runtime;
 
-// Global lists of tables; used to query whether an address is reserved by one of them.
-static Platform::Mutex tablesMutex;
-static std::vector<Table *> tables;
+// A global index of the tables' reserved address ranges; used to query whether an address is
+// reserved by one of them.
+static AddressRangeIndex<Table *> tableRangeIndex;
 
 enum {
     numGuardPages = 1
@@ -29,22 +30,17 @@ static Function *makeDummyFunction(const char *debugName) {
     return function;
 }
 
-Object *Runtime::getOutOfBoundsElement() {
-    static Function *function = makeDummyFunction("out-of-bounds table element");
-    return asObject(function);
-}
-
-static Object *getUninitializedElement() {
+Object *Runtime::getUninitializedElement() {
     static Function *function = makeDummyFunction("uninitialized table element");
     return asObject(function);
 }
 
 static Uptr objectToBiasedTableElementValue(Object *object) {
-    return reinterpret_cast<Uptr>(object) - reinterpret_cast<Uptr>(getOutOfBoundsElement());
+    return reinterpret_cast<Uptr>(object) - reinterpret_cast<Uptr>(getUninitializedElement());
 }
 
 static Object *biasedTableElementValueToObject(Uptr biasedValue) {
-    return reinterpret_cast<Object *>(biasedValue + reinterpret_cast<Uptr>(getOutOfBoundsElement()));
+    return reinterpret_cast<Object *>(biasedValue + reinterpret_cast<Uptr>(getUninitializedElement()));
 }
 
 static Table *createTableImpl(Compartment *compartment, IR::TableType type, std::string &&debugName) {
@@ -57,23 +53,22 @@ static Table *createTableImpl(Compartment *compartment, IR::TableType type, std:
     const U64 tableMaxBytes = sizeof(Table::Element) * tableMaxElements;
     const U64 tableMaxPages = tableMaxBytes >> pageBytesLog2;
 
-    table->elements = (Table::Element *) Platform::allocateVirtualPages(tableMaxPages + numGuardPages);
+    table->elements = (Table::Element *) allocateReservation(ReservationKind::table, tableMaxPages + numGuardPages);
     table->numReservedBytes = tableMaxBytes;
     table->numReservedElements = tableMaxElements;
     if (!table->elements) {
         delete table;
         return nullptr;
     }
+    Platform::setVirtualPagesNUMANode((U8 *) table->elements, tableMaxPages, compartment->numaNode);
 
-    // Add the table to the global array.
-    {
-        Lock<Platform::Mutex> tablesLock(tablesMutex);
-        tables.push_back(table);
-    }
+    // Add the table's reserved address range to the global index.
+    tableRangeIndex.add(Uptr(table->elements), Uptr(table->elements) + table->numReservedBytes, table);
+    table->isInRangeIndex = true;
     return table;
 }
 
-static Iptr growTableImpl(Table *table, Uptr numElementsToGrow, bool initializeNewElements) {
+static Iptr growTableImpl(Table *table, Uptr numElementsToGrow) {
     if (!numElementsToGrow) {
         return table->numElements.load(std::memory_order_acquire);
     }
@@ -88,27 +83,36 @@ static Iptr growTableImpl(Table *table, Uptr numElementsToGrow, bool initializeN
         return -1;
     }
 
-    // Try to commit pages for the new elements, and return -1 if the commit fails.
+    // Try to commit pages for the new elements, and return -1 if the commit fails or the pages would
+    // exceed the compartment's memory limit.
     const Uptr newNumElements = previousNumElements + numElementsToGrow;
     const Uptr previousNumPlatformPages = getNumPlatformPages(previousNumElements * sizeof(Table::Element));
     const Uptr newNumPlatformPages = getNumPlatformPages(newNumElements * sizeof(Table::Element));
-    if (newNumPlatformPages != previousNumPlatformPages && !Platform::commitVirtualPages(
-            (U8 *) table->elements + (previousNumPlatformPages << Platform::getPageSizeLog2()),
-            newNumPlatformPages - previousNumPlatformPages)) {
-        return -1;
-    }
-
-    if (initializeNewElements) {
-        // Write the uninitialized sentinel value to the new elements.
-        for (Uptr elementIndex = previousNumElements; elementIndex < newNumElements; ++elementIndex) {
-            table->elements[elementIndex].biasedValue.store(objectToBiasedTableElementValue(getUninitializedElement()), std::memory_order_release);
+    if (newNumPlatformPages != previousNumPlatformPages) {
+        const Uptr numNewBytes = (newNumPlatformPages - previousNumPlatformPages) << Platform::getPageSizeLog2();
+        if (!tryChargeCompartmentMemory(table->compartment, CompartmentMemoryKind::table, numNewBytes)) {
+            return -1;
+        }
+        if (!Platform::commitVirtualPages((U8 *) table->elements + (previousNumPlatformPages << Platform::getPageSizeLog2()), newNumPlatformPages - previousNumPlatformPages)) {
+            releaseCompartmentMemory(table->compartment, CompartmentMemoryKind::table, numNewBytes);
+            return -1;
         }
     }
 
+    // The new elements don't need to be initialized: the biased value of the uninitialized
+    // sentinel is zero, which the pages are filled with when they are committed, and nothing writes
+    // the elements beyond the table's size in its last committed page.
     table->numElements.store(newNumElements, std::memory_order_release);
+    if (table->id != UINTPTR_MAX) {
+        table->compartment->runtimeData->tableNumElements[table->id].store(newNumElements, std::memory_order_release);
+    }
     return previousNumElements;
 }
 
+Iptr Runtime::growTable(Table *table, Uptr numElementsToGrow) {
+    return growTableImpl(table, numElementsToGrow);
+}
+
 Table *Runtime::createTable(Compartment *compartment, IR::TableType type, std::string &&debugName) {
     wavmAssert(type.size.min <= UINTPTR_MAX);
     Table *table = createTableImpl(compartment, type, std::move(debugName));
@@ -117,12 +121,12 @@ Table *Runtime::createTable(Compartment *compartment, IR::TableType type, std::s
     }
 
     // Grow the table to the type's minimum size.
-    if (growTableImpl(table, Uptr(type.size.min), true) == -1) {
+    if (growTableImpl(table, Uptr(type.size.min)) == -1) {
         delete table;
         return nullptr;
     }
 
-    // Add the table to the compartment's tables IndexMap.
+    // Add the table to the compartment's tables DenseIndexMap.
     {
         Lock<Platform::Mutex> compartmentLock(compartment->mutex);
 
@@ -132,12 +136,57 @@ Table *Runtime::createTable(Compartment *compartment, IR::TableType type, std::s
             return nullptr;
         }
         compartment->runtimeData->tableBases[table->id] = table->elements;
+        compartment->runtimeData->tableNumElements[table->id].store(table->numElements.load(std::memory_order_acquire), std::memory_order_release);
     }
 
     return table;
 }
 
+Table *Runtime::cloneTable(Table *table, Compartment *newCompartment) {
+    Lock<Platform::Mutex> resizingLock(table->resizingMutex);
+
+    // Create the new table.
+    const Uptr numElements = table->numElements.load(std::memory_order_acquire);
+    std::string debugName = table->debugName;
+    Table *newTable = createTableImpl(newCompartment, table->type, std::move(debugName));
+    if (!newTable) {
+        return nullptr;
+    }
+
+    // Grow the table to the same size as the original.
+    if (growTableImpl(newTable, numElements) == -1) {
+        delete newTable;
+        return nullptr;
+    }
+
+    // Copy the original table's elements to the new table. Elements that refer to objects other
+    // than functions are remapped by cloneCompartment once all the objects have been cloned.
+    for (Uptr elementIndex = 0; elementIndex < numElements; ++elementIndex) {
+        newTable->elements[elementIndex].biasedValue.store(table->elements[elementIndex].biasedValue.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+    resizingLock.unlock();
+
+    // Insert the table in the new compartment's tables array with the same index as it had in the
+    // original compartment's tables DenseIndexMap.
+    {
+        Lock<Platform::Mutex> compartmentLock(newCompartment->mutex);
+
+        newTable->id = table->id;
+        newCompartment->tables.insertOrFail(newTable->id, newTable);
+        newCompartment->runtimeData->tableBases[newTable->id] = newTable->elements;
+        newCompartment->runtimeData->tableNumElements[newTable->id].store(numElements, std::memory_order_release);
+    }
+
+    return newTable;
+}
+
 Table::~Table() {
+    if (isRemembered.load(std::memory_order_acquire)) {
+        Lock<Platform::SpinMutex> youngGenerationLock(compartment->gcYoungGeneration.mutex);
+        compartment->gcYoungGeneration.rememberedTables.remove(this);
+    }
+
     if (id != UINTPTR_MAX) {
 
         wavmAssert(compartment->tables[id] == this);
@@ -145,28 +194,37 @@ Table::~Table() {
 
         wavmAssert(compartment->runtimeData->tableBases[id] == elements);
         compartment->runtimeData->tableBases[id] = nullptr;
+        compartment->runtimeData->tableNumElements[id].store(0, std::memory_order_release);
     }
 
-    // Remove the table from the global array.
-    {
-        Lock<Platform::Mutex> tablesLock(tablesMutex);
-        for (Uptr tableIndex = 0; tableIndex < tables.size(); ++tableIndex) {
-            if (tables[tableIndex] == this) {
-                tables.erase(tables.begin() + tableIndex);
-                break;
-            }
-        }
+    // Remove the table's reserved address range from the global index.
+    if (isInRangeIndex) {
+        tableRangeIndex.removeOrFail(Uptr(elements));
     }
 
     // Free the virtual address space.
     const Uptr pageBytesLog2 = Platform::getPageSizeLog2();
     if (numReservedBytes > 0) {
-        Platform::freeVirtualPages((U8 *) elements, (numReservedBytes >> pageBytesLog2) + numGuardPages);
+        const Uptr numCommittedPages = getNumPlatformPages(numElements.load(std::memory_order_acquire) * sizeof(Table::Element));
+        releaseCompartmentMemory(compartment, CompartmentMemoryKind::table, numCommittedPages << pageBytesLog2);
+        freeReservation(ReservationKind::table, (U8 *) elements, (numReservedBytes >> pageBytesLog2) + numGuardPages, numCommittedPages);
     }
     elements = nullptr;
     numElements = numReservedBytes = numReservedElements = 0;
 }
 
+bool Runtime::isAddressOwnedByTable(U8 *address, Table *&outTable, Uptr &outTableIndex) {
+    // Look up the table whose reserved address space contains the address. This doesn't take a
+    // lock, so it's safe to call from a signal handler.
+    AddressRangeIndex<Table *>::Range range;
+    if (!tableRangeIndex.find(Uptr(address), range)) {
+        return false;
+    }
+    outTable = range.value;
+    outTableIndex = (Uptr(address) - range.begin) / sizeof(Table::Element);
+    return true;
+}
+
 static Object *setTableElementNonNull(Table *table, Uptr index, Object *object) {
     wavmAssert(object);
 
@@ -177,8 +235,7 @@ static Object *setTableElementNonNull(Table *table, Uptr index, Object *object)
     // Compute the biased value to store in the table.
     const Uptr biasedValue = objectToBiasedTableElementValue(object);
 
-    // Atomically replace the table element, throwing an out-of-bounds exception before the write if
-    // the element being replaced is an out-of-bounds sentinel value.
+    // Atomically replace the table element.
     Uptr oldBiasedValue = table->elements[saturatedIndex].biasedValue;
     while (true) {
         if (table->elements[saturatedIndex].biasedValue.compare_exchange_weak(oldBiasedValue, biasedValue, std::memory_order_acq_rel)) {
@@ -190,8 +247,6 @@ static Object *setTableElementNonNull(Table *table, Uptr index, Object *object)
 }
 
 static Object *getTableElementNonNull(Table *table, Uptr index) {
-    // Verify the index is within the table's bounds.
-
     // Use a saturated index to access the table data to ensure that it's harmless for the CPU to
     // speculate past the above bounds check.
     const Uptr saturatedIndex = Platform::saturateToBounds(index, U64(table->numReservedElements) - 1);
@@ -212,14 +267,32 @@ Object *Runtime::setTableElement(Table *table, Uptr index, Object *newValue) {
         newValue = getUninitializedElement();
     }
 
-    // Write the table element.
+    // Write the table element. If a garbage collection of the compartment is marking, shade the
+    // overwritten element, since the collector may not have scanned it yet.
+    GCWriteBarrier &barrier = table->compartment->gcWriteBarrier;
+    // The elements beyond the table's size in its last committed page must stay zero, which a grow
+    // relies on to not initialize them, so an out-of-bounds write must trap before it is made.
+    if (index >= getTableNumElements(table)) {
+        raiseTrap(Trap::Type::outOfBoundsTableAccess);
+    }
+    barrier.numActiveWrites.fetch_add(1, std::memory_order_seq_cst);
     Object *oldObject = setTableElementNonNull(table, index, newValue);
+    if (barrier.isMarking.load(std::memory_order_seq_cst)) {
+        Lock<Platform::SpinMutex> barrierLock(barrier.mutex);
+        barrier.shadedObjects.push_back(oldObject);
+    }
+    barrier.numActiveWrites.fetch_sub(1, std::memory_order_seq_cst);
+
+    rememberTableWrite(table, newValue);
 
     // If the old table element was the uninitialized sentinel value, return null.
     return oldObject == getUninitializedElement() ? nullptr : oldObject;
 }
 
 Object *Runtime::getTableElement(Table *table, Uptr index) {
+    if (index >= getTableNumElements(table)) {
+        raiseTrap(Trap::Type::outOfBoundsTableAccess);
+    }
     Object *object = getTableElementNonNull(table, index);
 
     // If the old table element was the uninitialized sentinel value, return null.
@@ -230,36 +303,63 @@ Uptr Runtime::getTableNumElements(Table *table) {
     return table->numElements.load(std::memory_order_acquire);
 }
 
+// Generated code only calls table.get for an index it found to be out of the table's bounds, so it
+// is usually a trap, unless the table grew since the generated code checked the index.
 DEFINE_INTRINSIC_FUNCTION(wavmIntrinsics, "table.get", Object*, table_get, U32 index, Uptr tableId) {
     Table *table = getTableFromRuntimeData(contextRuntimeData, tableId);
+    if (index >= getTableNumElements(table)) {
+        raiseTrap(Trap::Type::outOfBoundsTableAccess, GET_TRAP_ADDRESS());
+    }
     return getTableElement(table, index);
 }
 
 DEFINE_INTRINSIC_FUNCTION(wavmIntrinsics, "table.set", void, table_set, U32 index, Object *value, Uptr tableId) {
     Table *table = getTableFromRuntimeData(contextRuntimeData, tableId);
+    if (index >= getTableNumElements(table)) {
+        raiseTrap(Trap::Type::outOfBoundsTableAccess, GET_TRAP_ADDRESS());
+    }
     setTableElement(table, index, value);
 }
 
 DEFINE_INTRINSIC_FUNCTION(wavmIntrinsics, "table.init", void, table_init, U32 destOffset, U32 sourceOffset, U32 numElements, Uptr moduleInstanceId, Uptr tableId, Uptr elemSegmentIndex) {
     ModuleInstance *moduleInstance = getModuleInstanceFromRuntimeData(contextRuntimeData, moduleInstanceId);
-    Lock<Platform::Mutex> passiveElemSegmentsLock(moduleInstance->passiveElemSegmentsMutex);
 
-    if (!moduleInstance->passiveElemSegments.contains(elemSegmentIndex)) {
-        passiveElemSegmentsLock.unlock();
-    } else {
-        // Copy the passive elem segment shared_ptr, and unlock the mutex. It's important to
-        // explicitly unlock the mutex before calling setTableElement, as setTableElement trigger a
-        // signal that will unwind the stack without calling the Lock destructor.
-        std::shared_ptr<const std::vector<Object *>> passiveElemSegmentObjects = moduleInstance->passiveElemSegments[elemSegmentIndex];
-        passiveElemSegmentsLock.unlock();
+    // Only hold the lock while reading the dropped bit: setTableElement might trigger a signal that
+    // will unwind the stack without calling the Lock destructor.
+    bool isDropped;
+    {
+        Lock<Platform::Mutex> droppedSegmentsLock(moduleInstance->droppedSegmentsMutex);
+        wavmAssert(elemSegmentIndex < moduleInstance->droppedElemSegments.size());
+        isDropped = moduleInstance->droppedElemSegments[elemSegmentIndex];
+    }
+
+    // The segment's function indices are owned by the immutable module, which outlives the instance,
+    // and are mapped to the instance's functions as they are copied. A dropped segment has no
+    // elements.
+    const std::vector<Uptr> &passiveElemSegmentIndices = moduleInstance->module->ir.elemSegments[elemSegmentIndex].indices;
+    const U64 numSegmentElements = isDropped ? 0 : passiveElemSegmentIndices.size();
 
-        Table *table = getTableFromRuntimeData(contextRuntimeData, tableId);
+    // Check both ranges before writing any elements, so an out-of-bounds table.init doesn't change
+    // the table.
+    Table *table = getTableFromRuntimeData(contextRuntimeData, tableId);
+    if (U64(sourceOffset) + numElements > numSegmentElements || U64(destOffset) + numElements > getTableNumElements(table)) {
+        raiseTrap(Trap::Type::outOfBoundsTableAccess, GET_TRAP_ADDRESS());
+    }
 
+    if (!isDropped) {
         for (Uptr index = 0; index < numElements; ++index) {
             const U64 sourceIndex = U64(sourceOffset) + index;
             const U64 destIndex = U64(destOffset) + index;
 
-            setTableElement(table, Uptr(destIndex), asObject((*passiveElemSegmentObjects)[sourceIndex]));
+            const Uptr functionIndex = passiveElemSegmentIndices[Uptr(sourceIndex)];
+            setTableElement(table, Uptr(destIndex), asObject(moduleInstance->functions[functionIndex]));
         }
     }
 }
+
+DEFINE_INTRINSIC_FUNCTION(wavmIntrinsics, "table.drop", void, table_drop, Uptr moduleInstanceId, Uptr elemSegmentIndex) {
+    ModuleInstance *moduleInstance = getModuleInstanceFromRuntimeData(contextRuntimeData, moduleInstanceId);
+    Lock<Platform::Mutex> droppedSegmentsLock(moduleInstance->droppedSegmentsMutex);
+    wavmAssert(elemSegmentIndex < moduleInstance->droppedElemSegments.size());
+    moduleInstance->droppedElemSegments[elemSegmentIndex] = true;
+}
@@ -0,0 +1,234 @@
+#include <memory>
+#include <vector>
+
+#include "RuntimePrivate.h"
+#include "WAVM/IR/Module.h"
+#include "WAVM/Inline/Lock.h"
+#include "WAVM/LLVMJIT/LLVMJIT.h"
+#include "WAVM/Runtime/Intrinsics.h"
+#include "WAVM/Runtime/Runtime.h"
+
+using namespace WAVM;
+using namespace WAVM::IR;
+using namespace WAVM::Runtime;
+
+// Loads the object code of a single compiled function definition of an instance, and returns the
+// function's code. The caller must hold the state's lock, and check that the instance hasn't been
+// destroyed.
+static const U8 *loadFunctionDefCode(TierUpState &tierUpState, Uptr functionDefIndex, const std::vector<U8> &objectCode, std::string &&debugName) {
+    const Runtime::Module &module = *tierUpState.module;
+    const Uptr numFunctionDefs = module.ir.functions.defs.size();
+
+    // Bind the function's calls to other function definitions to their baseline code, which
+    // forwards the calls to their optimized or lazily compiled code.
+    std::vector<LLVMJIT::FunctionBinding> jitFunctionDefs;
+    for (Uptr otherFunctionDefIndex = 0; otherFunctionDefIndex < numFunctionDefs; ++otherFunctionDefIndex) {
+        void *code = nullptr;
+        if (otherFunctionDefIndex != functionDefIndex) {
+            code = const_cast<U8 *>(tierUpState.functionDefs[otherFunctionDefIndex]->code);
+        }
+        jitFunctionDefs.push_back({CallingConvention::wasm, code});
+    }
+
+    // The function gets its own FunctionMutableData, which is owned by the JIT module it is loaded
+    // into.
+    std::vector<FunctionMutableData *> functionDefMutableDatas(numFunctionDefs, nullptr);
+    FunctionMutableData *mutableData = new FunctionMutableData(std::move(debugName));
+    functionDefMutableDatas[functionDefIndex] = mutableData;
+
+    HashMap<std::string, LLVMJIT::FunctionBinding> wavmIntrinsicsExportMap = tierUpState.wavmIntrinsicsExportMap;
+    std::vector<FunctionType> jitTypes = module.ir.types;
+    std::vector<LLVMJIT::FunctionBinding> jitFunctionImports = tierUpState.functionImports;
+    std::vector<LLVMJIT::TableBinding> jitTables = tierUpState.tables;
+    std::vector<LLVMJIT::MemoryBinding> jitMemories = tierUpState.memories;
+    std::vector<LLVMJIT::GlobalBinding> jitGlobals = tierUpState.globals;
+    std::vector<LLVMJIT::ExceptionTypeBinding> jitExceptionTypes = tierUpState.exceptionTypes;
+    std::shared_ptr<LLVMJIT::Module> jitModule = LLVMJIT::loadModule(objectCode, std::move(wavmIntrinsicsExportMap), std::move(jitTypes), std::move(jitFunctionImports), std::move(jitFunctionDefs), std::move(jitTables), std::move(jitMemories), std::move(jitGlobals), std::move(jitExceptionTypes), {tierUpState.moduleInstanceId}, tierUpState.tableReferenceBias, functionDefMutableDatas, tierUpState.numaNode);
+    tierUpState.tieredJITModules.push_back(std::move(jitModule));
+
+    wavmAssert(mutableData->function);
+    return mutableData->function->code;
+}
+
+// Returns the options that a module's functions are recompiled with by tier-up: the module's
+// options without the tier-up prologues, at the tier-up optimization level.
+static LLVMJIT::CompileOptions getTierUpCompileOptions(const Runtime::Module &module) {
+    LLVMJIT::CompileOptions compileOptions;
+    compileOptions.optimizationLevel = module.compileOptions.tierUpOptimizationLevel;
+    compileOptions.explicitMemoryBoundsChecks = module.compileOptions.explicitMemoryBoundsChecks;
+    compileOptions.nonVolatileMemoryAccesses = module.compileOptions.nonVolatileMemoryAccesses;
+    compileOptions.enableInterruptChecks = module.compileOptions.enableInterruptChecks;
+    compileOptions.enableFuelMetering = module.compileOptions.enableFuelMetering;
+    compileOptions.enableFramePointers = module.compileOptions.enableFramePointers;
+    compileOptions.enableCallCounters = module.compileOptions.enableCallCounters;
+    compileOptions.enableCallTiming = module.compileOptions.enableCallTiming;
+    compileOptions.enableProfileCounters = module.compileOptions.enableProfileCounters;
+    compileOptions.profile = module.compileOptions.profile;
+    return compileOptions;
+}
+
+static void recompileFunction(TierUpState &tierUpState, Uptr functionDefIndex) {
+    const Runtime::Module &module = *tierUpState.module;
+    wavmAssert(functionDefIndex < module.ir.functions.defs.size());
+
+    // The instance's functions may only be accessed while holding the lock, and only if the instance
+    // hasn't been destroyed.
+    std::string debugName;
+    {
+        Lock<Platform::Mutex> tierUpLock(tierUpState.mutex);
+        if (tierUpState.isInstanceDestroyed) {
+            return;
+        }
+        debugName = tierUpState.functionDefs[functionDefIndex]->mutableData->debugName;
+    }
+
+    // Compile the function without tier-up prologues at the tier-up optimization level. This
+    // doesn't hold the lock, so the instance may be destroyed while compiling.
+    std::vector<U8> objectCode = LLVMJIT::compileFunctionDef(module.ir, functionDefIndex, getTierUpCompileOptions(module));
+
+    // Code specialized to the instance is better than the recompiled function, so it is kept.
+    Lock<Platform::Mutex> tierUpLock(tierUpState.mutex);
+    if (tierUpState.isInstanceDestroyed || tierUpState.isSpecialized) {
+        return;
+    }
+
+    // Install the optimized code: the baseline code will forward all subsequent calls to it. Since
+    // table elements and exports refer to the baseline function, they don't need to be updated.
+    const U8 *optimizedCode = loadFunctionDefCode(tierUpState, functionDefIndex, objectCode, std::move(debugName));
+    FunctionMutableData *baselineMutableData = tierUpState.functionDefs[functionDefIndex]->mutableData;
+    baselineMutableData->tierUp.optimizedCode.store(optimizedCode, std::memory_order_release);
+}
+
+const U8 *Runtime::compileLazyFunction(TierUpState &tierUpState, Uptr functionDefIndex) {
+    const Runtime::Module &module = *tierUpState.module;
+    wavmAssert(functionDefIndex < module.ir.functions.defs.size());
+
+    std::string debugName;
+    {
+        Lock<Platform::Mutex> tierUpLock(tierUpState.mutex);
+        wavmAssert(!tierUpState.isInstanceDestroyed);
+        debugName = tierUpState.functionDefs[functionDefIndex]->mutableData->debugName;
+    }
+
+    // Compile the function with the module's options, including its tier-up prologue if enabled.
+    // Threads that call the function for the first time concurrently may each compile it.
+    LLVMJIT::CompileOptions compileOptions = module.compileOptions;
+    compileOptions.enableLazyCompilation = false;
+    compileOptions.enableInterpreter = false;
+    // The function calls its imports through their symbols, which the tier-up state binds, so
+    // it doesn't need the linked modules' code.
+    compileOptions.linkedModules.clear();
+    compileOptions.linkedFunctionImports.clear();
+    std::vector<U8> objectCode = LLVMJIT::compileFunctionDef(module.ir, functionDefIndex, compileOptions);
+
+    // Install the compiled code, unless another thread installed it first. Since table elements and
+    // exports refer to the stub's function, they don't need to be updated.
+    Lock<Platform::Mutex> tierUpLock(tierUpState.mutex);
+    FunctionMutableData *stubMutableData = tierUpState.functionDefs[functionDefIndex]->mutableData;
+    const U8 *compiledCode = stubMutableData->tierUp.optimizedCode.load(std::memory_order_acquire);
+    if (!compiledCode) {
+        compiledCode = loadFunctionDefCode(tierUpState, functionDefIndex, objectCode, std::move(debugName));
+        stubMutableData->tierUp.optimizedCode.store(compiledCode, std::memory_order_release);
+    }
+    return compiledCode;
+}
+
+bool Runtime::specializeModuleInstance(ModuleInstance *moduleInstance) {
+    const std::shared_ptr<TierUpState> tierUpState = moduleInstance->tierUpState;
+    if (!tierUpState) {
+        return false;
+    }
+    const Runtime::Module &module = *tierUpState->module;
+    const Uptr numFunctionDefs = module.ir.functions.defs.size();
+
+    // Collect the bindings that the code can treat as constants. The values of immutable globals of
+    // reference types aren't folded, since clones of the instance in other compartments share its
+    // code, but not its objects.
+    std::shared_ptr<LLVMJIT::InstanceConstants> instanceConstants = std::make_shared<LLVMJIT::InstanceConstants>();
+    std::vector<std::string> debugNames;
+    {
+        Lock<Platform::Mutex> tierUpLock(tierUpState->mutex);
+        if (tierUpState->isInstanceDestroyed) {
+            return false;
+        }
+        instanceConstants->moduleInstanceId = tierUpState->moduleInstanceId;
+        instanceConstants->tableReferenceBias = tierUpState->tableReferenceBias;
+        for (const LLVMJIT::TableBinding &table : tierUpState->tables) {
+            instanceConstants->tableIds.push_back(table.id);
+        }
+        for (const LLVMJIT::MemoryBinding &memory : tierUpState->memories) {
+            instanceConstants->memoryIds.push_back(memory.id);
+        }
+        for (const LLVMJIT::GlobalBinding &global : tierUpState->globals) {
+            if (!global.type.isMutable && !isReferenceType(global.type.valueType)) {
+                instanceConstants->globalValues.push_back(Value(global.type.valueType, *global.immutableValuePointer));
+            } else {
+                instanceConstants->globalValues.push_back(Value());
+            }
+        }
+        for (Function *functionDef : tierUpState->functionDefs) {
+            debugNames.push_back(functionDef->mutableData->debugName);
+        }
+    }
+
+    // Compile the whole module, so the specialized functions call each other directly and may be
+    // inlined into each other. This doesn't hold the lock: the instance's functions keep running
+    // their baseline code until the specialized code is installed.
+    LLVMJIT::CompileOptions compileOptions = getTierUpCompileOptions(module);
+    compileOptions.functionDefCallCounts = module.compileOptions.functionDefCallCounts;
+    compileOptions.instanceConstants = instanceConstants;
+    std::vector<U8> objectCode = LLVMJIT::compileModule(module.ir, compileOptions);
+
+    // Like recompileFunction, drop the code if the instance was destroyed while it was compiled.
+    Lock<Platform::Mutex> tierUpLock(tierUpState->mutex);
+    if (tierUpState->isInstanceDestroyed) {
+        return false;
+    }
+
+    // Each specialized function gets its own FunctionMutableData, which is owned by the JIT module
+    // it is loaded into.
+    std::vector<FunctionMutableData *> functionDefMutableDatas;
+    for (Uptr functionDefIndex = 0; functionDefIndex < numFunctionDefs; ++functionDefIndex) {
+        functionDefMutableDatas.push_back(new FunctionMutableData(std::move(debugNames[functionDefIndex])));
+    }
+
+    HashMap<std::string, LLVMJIT::FunctionBinding> wavmIntrinsicsExportMap = tierUpState->wavmIntrinsicsExportMap;
+    std::vector<FunctionType> jitTypes = module.ir.types;
+    std::vector<LLVMJIT::FunctionBinding> jitFunctionImports = tierUpState->functionImports;
+    std::vector<LLVMJIT::TableBinding> jitTables = tierUpState->tables;
+    std::vector<LLVMJIT::MemoryBinding> jitMemories = tierUpState->memories;
+    std::vector<LLVMJIT::GlobalBinding> jitGlobals = tierUpState->globals;
+    std::vector<LLVMJIT::ExceptionTypeBinding> jitExceptionTypes = tierUpState->exceptionTypes;
+    std::shared_ptr<LLVMJIT::Module> jitModule = LLVMJIT::loadModule(objectCode, std::move(wavmIntrinsicsExportMap), std::move(jitTypes), std::move(jitFunctionImports), {}, std::move(jitTables), std::move(jitMemories), std::move(jitGlobals), std::move(jitExceptionTypes), {tierUpState->moduleInstanceId}, tierUpState->tableReferenceBias, functionDefMutableDatas, tierUpState->numaNode);
+    tierUpState->tieredJITModules.push_back(std::move(jitModule));
+
+    // Forward calls to the baseline functions, which table elements and exports refer to, to the
+    // specialized code. This replaces any code that tier-up or lazy compilation installed.
+    for (Uptr functionDefIndex = 0; functionDefIndex < numFunctionDefs; ++functionDefIndex) {
+        wavmAssert(functionDefMutableDatas[functionDefIndex]->function);
+        FunctionMutableData *baselineMutableData = tierUpState->functionDefs[functionDefIndex]->mutableData;
+        baselineMutableData->tierUp.optimizedCode.store(functionDefMutableDatas[functionDefIndex]->function->code, std::memory_order_release);
+    }
+    tierUpState->isSpecialized = true;
+    return true;
+}
+
+void Runtime::queueTierUp(const std::shared_ptr<TierUpState> &tierUpState, Uptr functionDefIndex) {
+    // Tier-up recompiles run in the background, so they don't delay first-time compiles.
+    queueCompileJob(CompilePriority::background, [tierUpState, functionDefIndex] { recompileFunction(*tierUpState, functionDefIndex); });
+}
+
+DEFINE_INTRINSIC_FUNCTION(wavmIntrinsics, "tierUpFunction", void, tierUpFunction, Uptr moduleInstanceId, Uptr functionDefIndex) {
+    ModuleInstance *moduleInstance = getModuleInstanceFromRuntimeData(contextRuntimeData, moduleInstanceId);
+
+    // An instance without tier-up state just keeps running the baseline code.
+    if (moduleInstance->tierUpState) {
+        queueTierUp(moduleInstance->tierUpState, functionDefIndex);
+    }
+}
+
+DEFINE_INTRINSIC_FUNCTION(wavmIntrinsics, "compileLazyFunction", Uptr, compileLazyFunctionIntrinsic, Uptr moduleInstanceId, Uptr functionDefIndex) {
+    ModuleInstance *moduleInstance = getModuleInstanceFromRuntimeData(contextRuntimeData, moduleInstanceId);
+    wavmAssert(moduleInstance->tierUpState);
+    return reinterpret_cast<Uptr>(compileLazyFunction(*moduleInstance->tierUpState, functionDefIndex));
+}
@@ -0,0 +1,67 @@
+#include "RuntimePrivate.h"
+#include "WAVM/LLVMJIT/LLVMJIT.h"
+#include "WAVM/Platform/Exception.h"
+#include "WAVM/Runtime/Runtime.h"
+
+using namespace WAVM;
+using namespace WAVM::Runtime;
+
+// Translates a signal to a trap, if it was raised by WebAssembly code. This is called by the signal
+// handler, so it only uses lookups that don't lock or allocate.
+static bool translateSignalToTrap(const Platform::Signal &signal, const Platform::CallStack &callStack, Trap &outTrap) {
+    outTrap.function = nullptr;
+    outTrap.memory = nullptr;
+    outTrap.memoryAddress = 0;
+    if (callStack.stackFrames.size()) {
+        outTrap.function = LLVMJIT::getFunctionByAddress(callStack.stackFrames[0].ip);
+    }
+    if (!outTrap.function) {
+        // A signal raised by the interpreter is attributed to the function it is interpreting.
+        outTrap.function = getInterpretedFunction();
+    }
+
+    switch (signal.type) {
+        case Platform::Signal::Type::accessViolation:
+            // An access to a memory's guard pages may be made by an intrinsic, e.g. memory.copy, so
+            // it is a trap even if the faulting instruction isn't in a WebAssembly function.
+            outTrap.type = Trap::Type::outOfBoundsMemoryAccess;
+            return isAddressOwnedByMemory(reinterpret_cast<U8 *>(signal.accessViolation.address), outTrap.memory, outTrap.memoryAddress);
+        case Platform::Signal::Type::stackOverflow:
+            outTrap.type = Trap::Type::stackOverflow;
+            return outTrap.function != nullptr;
+        case Platform::Signal::Type::intDivideByZeroOrOverflow:
+            outTrap.type = Trap::Type::integerDivideByZeroOrOverflow;
+            return outTrap.function != nullptr;
+        case Platform::Signal::Type::softwareTrap:
+            // Only raiseTrap raises these signals, so they are always traps.
+            outTrap.type = Trap::Type(signal.softwareTrap.code);
+            return true;
+        default:
+            return false;
+    };
+}
+
+bool Runtime::catchTraps(const std::function<void()> &thunk, const TrapHandler &handler) {
+    Trap trap;
+
+    // A trap unwinds the interpreter's frames without restoring the function it was interpreting.
+    Function *interpretedFunction = getInterpretedFunction();
+    const bool caughtTrap = Platform::catchSignals(thunk, [&trap](Platform::Signal signal, const Platform::CallStack &callStack) {
+        return translateSignalToTrap(signal, callStack, trap);
+    });
+    setInterpretedFunction(interpretedFunction);
+
+    // Call the handler after the stack has been unwound, so it may lock and allocate.
+    if (caughtTrap) {
+        addToMetric(Metrics::Counter::numTraps);
+        handler(trap);
+    }
+    return caughtTrap;
+}
+
+void Runtime::raiseTrap(Trap::Type type, Uptr instructionAddress) {
+    Platform::Signal signal;
+    signal.type = Platform::Signal::Type::softwareTrap;
+    signal.softwareTrap.code = Uptr(type);
+    Platform::raiseSignal(signal, instructionAddress);
+}
@@ -0,0 +1,1024 @@
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "WAVM/IR/IR.h"
+#include "WAVM/IR/Module.h"
+#include "WAVM/IR/Operators.h"
+#include "WAVM/IR/Types.h"
+#include "WAVM/IR/Validate.h"
+#include "WAVM/Inline/Assert.h"
+#include "WAVM/Inline/BasicTypes.h"
+#include "WAVM/Inline/Errors.h"
+#include "WAVM/Inline/ParallelFor.h"
+#include "WAVM/Inline/Serialization.h"
+#include "WAVM/WASMParse/WASMParse.h"
+
+using namespace WAVM;
+using namespace WAVM::IR;
+using namespace WAVM::Serialization;
+using namespace WAVM::WASM;
+
+static constexpr U32 magicNumber = 0x6d736100;
+static constexpr U32 currentVersion = 1;
+
+enum class SectionType : U8 {
+    user = 0,
+    type = 1,
+    import = 2,
+    functionDeclarations = 3,
+    table = 4,
+    memory = 5,
+    global = 6,
+    export_ = 7,
+    start = 8,
+    elem = 9,
+    functionDefinitions = 10,
+    data = 11,
+    dataCount = 12,
+    exceptionTypes = 13,
+};
+
+// The order that the known sections must occur in; user sections may occur anywhere.
+static Uptr getSectionOrder(SectionType type) {
+    switch (type) {
+        case SectionType::type:
+            return 1;
+        case SectionType::import:
+            return 2;
+        case SectionType::functionDeclarations:
+            return 3;
+        case SectionType::table:
+            return 4;
+        case SectionType::memory:
+            return 5;
+        case SectionType::global:
+            return 6;
+        case SectionType::exceptionTypes:
+            return 7;
+        case SectionType::export_:
+            return 8;
+        case SectionType::start:
+            return 9;
+        case SectionType::elem:
+            return 10;
+        case SectionType::dataCount:
+            return 11;
+        case SectionType::functionDefinitions:
+            return 12;
+        case SectionType::data:
+            return 13;
+        default:
+            throw FatalSerializationException("unknown section ID");
+    };
+}
+
+//
+// Primitive decoders
+//
+
+static U8 decodeU8(InputStream &stream) {
+    U8 value = 0;
+    serialize(stream, value);
+    return value;
+}
+
+static Uptr decodeVarUInt32(InputStream &stream) {
+    Uptr value = 0;
+    serializeVarUInt32(stream, value);
+    return value;
+}
+
+static I32 decodeVarInt32(InputStream &stream) {
+    I32 value = 0;
+    serializeVarInt<I32, 32>(stream, value, INT32_MIN, INT32_MAX);
+    return value;
+}
+
+static I64 decodeVarInt64(InputStream &stream) {
+    I64 value = 0;
+    serializeVarInt<I64, 64>(stream, value, INT64_MIN, INT64_MAX);
+    return value;
+}
+
+static std::string decodeName(InputStream &stream) {
+    std::string name;
+    serialize(stream, name);
+    return name;
+}
+
+template<typename Element, typename DecodeElement> static void decodeVector(InputStream &stream, std::vector<Element> &outElements, DecodeElement decodeElement) {
+    const Uptr numElements = decodeVarUInt32(stream);
+    for (Uptr index = 0; index < numElements; ++index) {
+        outElements.push_back(decodeElement(stream));
+    }
+}
+
+//
+// Type decoders
+//
+
+static ValueType decodeValueType(InputStream &stream) {
+    const U8 encodedType = decodeU8(stream);
+    switch (encodedType) {
+        case 0x7f:
+            return ValueType::i32;
+        case 0x7e:
+            return ValueType::i64;
+        case 0x7d:
+            return ValueType::f32;
+        case 0x7c:
+            return ValueType::f64;
+        case 0x7b:
+            return ValueType::v128;
+        case 0x70:
+            return ValueType::anyfunc;
+        case 0x6f:
+            return ValueType::anyref;
+        default:
+            throw FatalSerializationException("invalid value type encoding");
+    };
+}
+
+static ReferenceType decodeReferenceType(InputStream &stream) {
+    const U8 encodedType = decodeU8(stream);
+    switch (encodedType) {
+        case 0x70:
+            return ReferenceType::anyfunc;
+        case 0x6f:
+            return ReferenceType::anyref;
+        default:
+            throw FatalSerializationException("invalid reference type encoding");
+    };
+}
+
+static TypeTuple decodeTypeTuple(InputStream &stream) {
+    std::vector<ValueType> elems;
+    decodeVector(stream, elems, decodeValueType);
+    return TypeTuple(elems);
+}
+
+static FunctionType decodeFunctionType(InputStream &stream) {
+    if (decodeU8(stream) != 0x60) {
+        throw FatalSerializationException("expected function type form");
+    }
+    const TypeTuple params = decodeTypeTuple(stream);
+    const TypeTuple results = decodeTypeTuple(stream);
+    return FunctionType(results, params);
+}
+
+static IndexedFunctionType decodeIndexedFunctionType(InputStream &stream) {
+    return IndexedFunctionType{decodeVarUInt32(stream)};
+}
+
+static SizeConstraints decodeSizeConstraints(InputStream &stream, bool &outIsShared) {
+    const U8 flags = decodeU8(stream);
+    if (flags & ~0x03) {
+        throw FatalSerializationException("unknown size constraint flags");
+    }
+    outIsShared = (flags & 0x02) != 0;
+
+    SizeConstraints size;
+    size.min = decodeVarUInt32(stream);
+    size.max = (flags & 0x01) ? U64(decodeVarUInt32(stream)) : UINT64_MAX;
+    return size;
+}
+
+static TableType decodeTableType(InputStream &stream) {
+    const ReferenceType elementType = decodeReferenceType(stream);
+    bool isShared = false;
+    const SizeConstraints size = decodeSizeConstraints(stream, isShared);
+    return TableType(elementType, isShared, size);
+}
+
+static MemoryType decodeMemoryType(InputStream &stream) {
+    bool isShared = false;
+    const SizeConstraints size = decodeSizeConstraints(stream, isShared);
+    return MemoryType(isShared, size);
+}
+
+static GlobalType decodeGlobalType(InputStream &stream) {
+    const ValueType valueType = decodeValueType(stream);
+    const U8 isMutable = decodeU8(stream);
+    if (isMutable > 1) {
+        throw FatalSerializationException("invalid global mutability");
+    }
+    return GlobalType(valueType, isMutable != 0);
+}
+
+static ExceptionType decodeExceptionType(InputStream &stream) {
+    return ExceptionType{decodeTypeTuple(stream)};
+}
+
+static IndexedBlockType decodeBlockType(InputStream &stream) {
+    IndexedBlockType blockType;
+    const U8 firstByte = *stream.peek(1);
+    if (firstByte == 0x40) {
+        stream.advance(1);
+        blockType.format = IndexedBlockType::noParametersOrResult;
+        blockType.resultType = ValueType::none;
+    } else if ((firstByte & 0xc0) == 0x40) {
+        // Single-byte negative LEBs encode a single result value type. A byte with the sign bit
+        // and the continuation bit set begins a multi-byte LEB, e.g. 0xc0 0x00 for type index 64.
+        blockType.format = IndexedBlockType::oneResult;
+        blockType.resultType = decodeValueType(stream);
+    } else {
+        // Non-negative LEBs encode an index into the module's function types.
+        const I64 index = decodeVarInt64(stream);
+        if (index < 0 || index > I64(UINT32_MAX)) {
+            throw FatalSerializationException("invalid block type index");
+        }
+        blockType.format = IndexedBlockType::functionType;
+        blockType.index = Uptr(index);
+    }
+    return blockType;
+}
+
+//
+// Initializer expressions
+//
+
+static InitializerExpression decodeInitializerExpression(InputStream &stream) {
+    InitializerExpression expression;
+    const U8 opcode = decodeU8(stream);
+    switch (opcode) {
+        case 0x41:
+            expression = InitializerExpression(decodeVarInt32(stream));
+            break;
+        case 0x42:
+            expression = InitializerExpression(decodeVarInt64(stream));
+            break;
+        case 0x43: {
+            F32 f32;
+            serialize(stream, f32);
+            expression = InitializerExpression(f32);
+            break;
+        }
+        case 0x44: {
+            F64 f64;
+            serialize(stream, f64);
+            expression = InitializerExpression(f64);
+            break;
+        }
+        case 0xfd: {
+            if (decodeVarUInt32(stream) != 0) {
+                throw FatalSerializationException("invalid initializer expression opcode");
+            }
+            V128 v128;
+            serializeBytes(stream, v128.u8, sizeof(v128.u8));
+            expression = InitializerExpression(v128);
+            break;
+        }
+        case 0x23:
+            expression = InitializerExpression(InitializerExpression::Type::get_global, decodeVarUInt32(stream));
+            break;
+        case 0xd0:
+            expression = InitializerExpression(nullptr);
+            break;
+        default:
+            throw FatalSerializationException("invalid initializer expression opcode");
+    };
+
+    if (decodeU8(stream) != 0x0b) {
+        throw FatalSerializationException("expected end opcode after initializer expression");
+    }
+    return expression;
+}
+
+//
+// Operator immediates
+//
+
+static void decodeImm(InputStream &stream, NoImm &, FunctionDef &) {
+}
+
+static void decodeImm(InputStream &stream, MemoryImm &imm, FunctionDef &) {
+    imm.memoryIndex = decodeVarUInt32(stream);
+}
+
+static void decodeImm(InputStream &stream, TableImm &imm, FunctionDef &) {
+    imm.tableIndex = decodeVarUInt32(stream);
+}
+
+static void decodeImm(InputStream &stream, ControlStructureImm &imm, FunctionDef &) {
+    imm.type = decodeBlockType(stream);
+}
+
+static void decodeImm(InputStream &stream, BranchImm &imm, FunctionDef &) {
+    imm.targetDepth = decodeVarUInt32(stream);
+}
+
+static void decodeImm(InputStream &stream, BranchTableImm &imm, FunctionDef &functionDef) {
+    std::vector<Uptr> branchTable;
+    decodeVector(stream, branchTable, decodeVarUInt32);
+    imm.defaultTargetDepth = decodeVarUInt32(stream);
+    imm.branchTableIndex = functionDef.branchTables.size();
+    functionDef.branchTables.push_back(std::move(branchTable));
+}
+
+static void decodeImm(InputStream &stream, LiteralImm<I32> &imm, FunctionDef &) {
+    imm.value = decodeVarInt32(stream);
+}
+
+static void decodeImm(InputStream &stream, LiteralImm<I64> &imm, FunctionDef &) {
+    imm.value = decodeVarInt64(stream);
+}
+
+static void decodeImm(InputStream &stream, LiteralImm<F32> &imm, FunctionDef &) {
+    serialize(stream, imm.value);
+}
+
+static void decodeImm(InputStream &stream, LiteralImm<F64> &imm, FunctionDef &) {
+    serialize(stream, imm.value);
+}
+
+static void decodeImm(InputStream &stream, LiteralImm<V128> &imm, FunctionDef &) {
+    serializeBytes(stream, imm.value.u8, sizeof(imm.value.u8));
+}
+
+template<bool isGlobal> static void decodeImm(InputStream &stream, GetOrSetVariableImm<isGlobal> &imm, FunctionDef &) {
+    imm.variableIndex = decodeVarUInt32(stream);
+}
+
+static void decodeImm(InputStream &stream, FunctionImm &imm, FunctionDef &) {
+    imm.functionIndex = decodeVarUInt32(stream);
+}
+
+static void decodeImm(InputStream &stream, CallIndirectImm &imm, FunctionDef &) {
+    imm.type.index = decodeVarUInt32(stream);
+    imm.tableIndex = decodeVarUInt32(stream);
+}
+
+static void decodeAlignmentAndOffset(InputStream &stream, U8 &outAlignmentLog2, U32 &outOffset) {
+    const Uptr alignmentLog2 = decodeVarUInt32(stream);
+    if (alignmentLog2 > 255) {
+        throw FatalSerializationException("invalid load or store alignment");
+    }
+    outAlignmentLog2 = U8(alignmentLog2);
+    outOffset = U32(decodeVarUInt32(stream));
+}
+
+template<Uptr naturalAlignmentLog2> static void decodeImm(InputStream &stream, LoadOrStoreImm<naturalAlignmentLog2> &imm, FunctionDef &) {
+    decodeAlignmentAndOffset(stream, imm.alignmentLog2, imm.offset);
+}
+
+template<Uptr naturalAlignmentLog2> static void decodeImm(InputStream &stream, AtomicLoadOrStoreImm<naturalAlignmentLog2> &imm, FunctionDef &) {
+    decodeAlignmentAndOffset(stream, imm.alignmentLog2, imm.offset);
+}
+
+template<Uptr numLanes> static void decodeImm(InputStream &stream, LaneIndexImm<numLanes> &imm, FunctionDef &) {
+    imm.laneIndex = decodeU8(stream);
+}
+
+template<Uptr numLanes> static void decodeImm(InputStream &stream, ShuffleImm<numLanes> &imm, FunctionDef &) {
+    serializeBytes(stream, imm.laneIndices, numLanes);
+}
+
+static void decodeImm(InputStream &stream, ExceptionTypeImm &imm, FunctionDef &) {
+    imm.exceptionTypeIndex = decodeVarUInt32(stream);
+}
+
+static void decodeImm(InputStream &stream, RethrowImm &imm, FunctionDef &) {
+    imm.catchDepth = decodeVarUInt32(stream);
+}
+
+static void decodeImm(InputStream &stream, DataSegmentAndMemImm &imm, FunctionDef &) {
+    imm.dataSegmentIndex = decodeVarUInt32(stream);
+    imm.memoryIndex = decodeVarUInt32(stream);
+}
+
+static void decodeImm(InputStream &stream, DataSegmentImm &imm, FunctionDef &) {
+    imm.dataSegmentIndex = decodeVarUInt32(stream);
+}
+
+static void decodeImm(InputStream &stream, ElemSegmentAndTableImm &imm, FunctionDef &) {
+    imm.elemSegmentIndex = decodeVarUInt32(stream);
+    imm.tableIndex = decodeVarUInt32(stream);
+}
+
+static void decodeImm(InputStream &stream, ElemSegmentImm &imm, FunctionDef &) {
+    imm.elemSegmentIndex = decodeVarUInt32(stream);
+}
+
+//
+// Sections
+//
+
+struct ModuleState {
+    Module &module;
+    DeferredCodeValidationState deferredCodeValidationState;
+    bool hasValidatedPreCodeSections = false;
+    bool hasFunctionDefinitionsSection = false;
+
+    // Whether the data segment and user section bytes are loaded as views of the input, which is in
+    // the module's backing buffer, instead of copied.
+    bool loadViews = false;
+
+    ModuleState(Module &inModule) : module(inModule) {
+    }
+
+    void validatePreCodeSectionsOnce() {
+        if (!hasValidatedPreCodeSections) {
+            validatePreCodeSections(module);
+            hasValidatedPreCodeSections = true;
+        }
+    }
+};
+
+static void decodeTypeSection(InputStream &stream, ModuleState &moduleState) {
+    decodeVector(stream, moduleState.module.types, decodeFunctionType);
+}
+
+static void decodeImportSection(InputStream &stream, ModuleState &moduleState) {
+    Module &module = moduleState.module;
+    const Uptr numImports = decodeVarUInt32(stream);
+    for (Uptr importIndex = 0; importIndex < numImports; ++importIndex) {
+        std::string moduleName = decodeName(stream);
+        std::string exportName = decodeName(stream);
+        const U8 kind = decodeU8(stream);
+        switch (ExternKind(kind)) {
+            case ExternKind::function:
+                module.functions.imports.push_back({decodeIndexedFunctionType(stream), std::move(moduleName), std::move(exportName)});
+                break;
+            case ExternKind::table:
+                module.tables.imports.push_back({decodeTableType(stream), std::move(moduleName), std::move(exportName)});
+                break;
+            case ExternKind::memory:
+                module.memories.imports.push_back({decodeMemoryType(stream), std::move(moduleName), std::move(exportName)});
+                break;
+            case ExternKind::global:
+                module.globals.imports.push_back({decodeGlobalType(stream), std::move(moduleName), std::move(exportName)});
+                break;
+            case ExternKind::exceptionType:
+                module.exceptionTypes.imports.push_back({decodeExceptionType(stream), std::move(moduleName), std::move(exportName)});
+                break;
+            default:
+                throw FatalSerializationException("invalid import kind");
+        };
+    }
+}
+
+static void decodeFunctionDeclarationsSection(InputStream &stream, ModuleState &moduleState) {
+    const Uptr numFunctions = decodeVarUInt32(stream);
+    for (Uptr functionIndex = 0; functionIndex < numFunctions; ++functionIndex) {
+        moduleState.module.functions.defs.push_back({decodeIndexedFunctionType(stream), {}, {}, {}});
+    }
+}
+
+static void decodeTableSection(InputStream &stream, ModuleState &moduleState) {
+    decodeVector(stream, moduleState.module.tables.defs, [](InputStream &stream) {
+        return TableDef{decodeTableType(stream)};
+    });
+}
+
+static void decodeMemorySection(InputStream &stream, ModuleState &moduleState) {
+    decodeVector(stream, moduleState.module.memories.defs, [](InputStream &stream) {
+        return MemoryDef{decodeMemoryType(stream)};
+    });
+}
+
+static void decodeGlobalSection(InputStream &stream, ModuleState &moduleState) {
+    decodeVector(stream, moduleState.module.globals.defs, [](InputStream &stream) {
+        const GlobalType type = decodeGlobalType(stream);
+        return GlobalDef{type, decodeInitializerExpression(stream)};
+    });
+}
+
+static void decodeExceptionTypeSection(InputStream &stream, ModuleState &moduleState) {
+    decodeVector(stream, moduleState.module.exceptionTypes.defs, [](InputStream &stream) {
+        return ExceptionTypeDef{decodeExceptionType(stream)};
+    });
+}
+
+static void decodeExportSection(InputStream &stream, ModuleState &moduleState) {
+    decodeVector(stream, moduleState.module.exports, [](InputStream &stream) {
+        Export exportIt;
+        exportIt.name = decodeName(stream);
+        const U8 kind = decodeU8(stream);
+        if (kind > U8(ExternKind::max)) {
+            throw FatalSerializationException("invalid export kind");
+        }
+        exportIt.kind = ExternKind(kind);
+        exportIt.index = decodeVarUInt32(stream);
+        return exportIt;
+    });
+}
+
+static void decodeStartSection(InputStream &stream, ModuleState &moduleState) {
+    moduleState.module.startFunctionIndex = decodeVarUInt32(stream);
+}
+
+static void decodeElemSection(InputStream &stream, ModuleState &moduleState) {
+    decodeVector(stream, moduleState.module.elemSegments, [](InputStream &stream) {
+        // The segment flags: 0 is an active segment for table 0, 1 is a passive segment, and 2 is an
+        // active segment with an explicit table index. Segments with flags 1 or 2 have an elemkind
+        // byte before their function indices, which must be 0 for funcref.
+        ElemSegment elemSegment;
+        const Uptr flags = decodeVarUInt32(stream);
+        switch (flags) {
+            case 0:
+                elemSegment.isActive = true;
+                elemSegment.tableIndex = 0;
+                elemSegment.baseOffset = decodeInitializerExpression(stream);
+                break;
+            case 1:
+                elemSegment.isActive = false;
+                elemSegment.tableIndex = UINTPTR_MAX;
+                break;
+            case 2:
+                elemSegment.isActive = true;
+                elemSegment.tableIndex = decodeVarUInt32(stream);
+                elemSegment.baseOffset = decodeInitializerExpression(stream);
+                break;
+            default:
+                throw FatalSerializationException("invalid elem segment flags");
+        };
+        if (flags != 0 && decodeU8(stream) != 0) {
+            throw FatalSerializationException("invalid elem segment elemkind");
+        }
+        decodeVector(stream, elemSegment.indices, decodeVarUInt32);
+        return elemSegment;
+    });
+}
+
+static void decodeDataCountSection(InputStream &stream, ModuleState &moduleState) {
+    // The data count section is only used to validate memory.init and data.drop before the data
+    // section has been decoded; the data section itself determines the number of segments.
+    decodeVarUInt32(stream);
+}
+
+// Decodes a function body's operators, validating them and encoding them to the IR code format.
+static void decodeFunctionBody(InputStream &stream, const Module &module, DeferredCodeValidationState &deferredCodeValidationState, FunctionDef &functionDef) {
+    ArrayOutputStream codeByteStream;
+    OperatorEncoderStream operatorEncoder(codeByteStream);
+    CodeValidationProxyStream<OperatorEncoderStream> validatingCodeStream(module, functionDef, operatorEncoder, deferredCodeValidationState);
+
+    while (stream.capacity()) {
+        U16 opcode = decodeU8(stream);
+        if (opcode >= 0xfb && opcode <= 0xfe) {
+            // Prefixed opcodes are followed by a LEB sub-opcode.
+            const Uptr subOpcode = decodeVarUInt32(stream);
+            if (subOpcode > 0xff) {
+                throw FatalSerializationException("invalid prefixed opcode");
+            }
+            opcode = U16((opcode << 8) | subOpcode);
+        }
+
+        switch (Opcode(opcode)) {
+#define VISIT_OPCODE(_, name, nameString, Imm, ...)                                                \
+    case Opcode::name:                                                                             \
+    {                                                                                              \
+        Imm imm;                                                                                   \
+        decodeImm(stream, imm, functionDef);                                                       \
+        validatingCodeStream.name(imm);                                                            \
+        break;                                                                                     \
+    }
+            ENUM_OPERATORS(VISIT_OPCODE)
+#undef VISIT_OPCODE
+            default:
+                throw FatalSerializationException("unknown opcode");
+        };
+    };
+    validatingCodeStream.finishValidation();
+
+    functionDef.code = std::move(codeByteStream.getBytes());
+}
+
+// Decodes the number of function bodies at the start of the code section, and checks that it
+// matches the number of function declarations.
+static void decodeFunctionDefinitionsSectionHeader(InputStream &stream, ModuleState &moduleState) {
+    moduleState.validatePreCodeSectionsOnce();
+    moduleState.hasFunctionDefinitionsSection = true;
+
+    const Uptr numFunctionBodies = decodeVarUInt32(stream);
+    if (numFunctionBodies != moduleState.module.functions.defs.size()) {
+        throw FatalSerializationException("function and code section have inconsistent lengths");
+    }
+}
+
+// Decodes a function definition's run-length encoded local types and its body. Function definitions
+// only read the module's sections that precede the code section, so they may be decoded
+// concurrently, each with its own deferred validation state.
+static void decodeFunctionDefinition(InputStream &bodyStream, const Module &module, DeferredCodeValidationState &deferredCodeValidationState, FunctionDef &functionDef) {
+    const Uptr numLocalSets = decodeVarUInt32(bodyStream);
+    for (Uptr setIndex = 0; setIndex < numLocalSets; ++setIndex) {
+        const Uptr numLocals = decodeVarUInt32(bodyStream);
+        const ValueType localType = decodeValueType(bodyStream);
+        if (functionDef.nonParameterLocalTypes.size() + numLocals > module.featureSpec.maxLocals) {
+            throw FatalSerializationException("too many locals");
+        }
+        functionDef.nonParameterLocalTypes.insert(functionDef.nonParameterLocalTypes.end(), numLocals, localType);
+    }
+
+    decodeFunctionBody(bodyStream, module, deferredCodeValidationState, functionDef);
+}
+
+// A thread is only started to decode function bodies if it has at least this many bytes of them to
+// decode.
+static constexpr Uptr minDecodeCodeBytesPerThread = 256 * 1024;
+
+static void decodeFunctionDefinitionsSection(InputStream &stream, ModuleState &moduleState) {
+    Module &module = moduleState.module;
+    decodeFunctionDefinitionsSectionHeader(stream, moduleState);
+
+    // Find the bytes of each function body, so they can be decoded independently.
+    std::vector<const U8 *> bodyBytes;
+    std::vector<Uptr> numBodyBytes;
+    Uptr numCodeBytes = 0;
+    for (Uptr functionDefIndex = 0; functionDefIndex < module.functions.defs.size(); ++functionDefIndex) {
+        const Uptr numFunctionBodyBytes = decodeVarUInt32(stream);
+        bodyBytes.push_back(stream.advance(numFunctionBodyBytes));
+        numBodyBytes.push_back(numFunctionBodyBytes);
+        numCodeBytes += numFunctionBodyBytes;
+    }
+
+    // Decode and validate the function bodies on a pool of threads, and merge their deferred
+    // validation states.
+    const Uptr numThreads = getNumParallelThreads(numCodeBytes, minDecodeCodeBytesPerThread);
+    std::vector<DeferredCodeValidationState> threadDeferredCodeValidationStates(numThreads);
+    parallelFor(module.functions.defs.size(), numThreads, [&](Uptr threadIndex, Uptr functionDefIndex) {
+        MemoryInputStream bodyStream(bodyBytes[functionDefIndex], numBodyBytes[functionDefIndex]);
+        decodeFunctionDefinition(bodyStream, module, threadDeferredCodeValidationStates[threadIndex], module.functions.defs[functionDefIndex]);
+    });
+    for (const DeferredCodeValidationState &threadDeferredCodeValidationState :
+            threadDeferredCodeValidationStates) {
+        mergeDeferredCodeValidationState(moduleState.deferredCodeValidationState, threadDeferredCodeValidationState);
+    }
+}
+
+static void decodeDataSection(InputStream &stream, ModuleState &moduleState) {
+    decodeVector(stream, moduleState.module.dataSegments, [&moduleState](InputStream &stream) {
+        // The segment flags: 0 is an active segment for memory 0, 1 is a passive segment, and 2 is
+        // an active segment with an explicit memory index.
+        DataSegment dataSegment;
+        const Uptr flags = decodeVarUInt32(stream);
+        switch (flags) {
+            case 0:
+                dataSegment.isActive = true;
+                dataSegment.memoryIndex = 0;
+                dataSegment.baseOffset = decodeInitializerExpression(stream);
+                break;
+            case 1:
+                dataSegment.isActive = false;
+                dataSegment.memoryIndex = UINTPTR_MAX;
+                break;
+            case 2:
+                dataSegment.isActive = true;
+                dataSegment.memoryIndex = decodeVarUInt32(stream);
+                dataSegment.baseOffset = decodeInitializerExpression(stream);
+                break;
+            default:
+                throw FatalSerializationException("invalid data segment flags");
+        };
+
+        const Uptr numDataBytes = decodeVarUInt32(stream);
+        const U8 *dataBytes = stream.advance(numDataBytes);
+        if (moduleState.loadViews) {
+            dataSegment.data = ModuleBytes::view(dataBytes, numDataBytes);
+        } else {
+            dataSegment.data.assign(dataBytes, dataBytes + numDataBytes);
+        }
+        return dataSegment;
+    });
+}
+
+static void decodeUserSection(InputStream &stream, ModuleState &moduleState) {
+    UserSection userSection;
+    userSection.name = decodeName(stream);
+    const Uptr numDataBytes = stream.capacity();
+    const U8 *dataBytes = stream.advance(numDataBytes);
+    if (moduleState.loadViews) {
+        userSection.data = ModuleBytes::view(dataBytes, numDataBytes);
+    } else {
+        userSection.data.assign(dataBytes, dataBytes + numDataBytes);
+    }
+    moduleState.module.userSections.push_back(std::move(userSection));
+}
+
+static void decodeModuleHeader(InputStream &stream) {
+    U32 magic = 0;
+    U32 version = 0;
+    serialize(stream, magic);
+    if (magic != magicNumber) {
+        throw FatalSerializationException("magic number doesn't match");
+    }
+    serialize(stream, version);
+    if (version != currentVersion) {
+        throw FatalSerializationException("unsupported version");
+    }
+}
+
+// Checks that a known section occurs after the known sections that must precede it.
+static void checkSectionOrder(SectionType sectionType, Uptr &lastSectionOrder) {
+    if (sectionType != SectionType::user) {
+        const Uptr sectionOrder = getSectionOrder(sectionType);
+        if (sectionOrder <= lastSectionOrder) {
+            throw FatalSerializationException("incorrect order for known section");
+        }
+        lastSectionOrder = sectionOrder;
+    }
+}
+
+static void decodeSection(SectionType sectionType, InputStream &sectionStream, ModuleState &moduleState) {
+    switch (sectionType) {
+        case SectionType::user:
+            decodeUserSection(sectionStream, moduleState);
+            break;
+        case SectionType::type:
+            decodeTypeSection(sectionStream, moduleState);
+            break;
+        case SectionType::import:
+            decodeImportSection(sectionStream, moduleState);
+            break;
+        case SectionType::functionDeclarations:
+            decodeFunctionDeclarationsSection(sectionStream, moduleState);
+            break;
+        case SectionType::table:
+            decodeTableSection(sectionStream, moduleState);
+            break;
+        case SectionType::memory:
+            decodeMemorySection(sectionStream, moduleState);
+            break;
+        case SectionType::global:
+            decodeGlobalSection(sectionStream, moduleState);
+            break;
+        case SectionType::exceptionTypes:
+            decodeExceptionTypeSection(sectionStream, moduleState);
+            break;
+        case SectionType::export_:
+            decodeExportSection(sectionStream, moduleState);
+            break;
+        case SectionType::start:
+            decodeStartSection(sectionStream, moduleState);
+            break;
+        case SectionType::elem:
+            decodeElemSection(sectionStream, moduleState);
+            break;
+        case SectionType::dataCount:
+            decodeDataCountSection(sectionStream, moduleState);
+            break;
+        case SectionType::functionDefinitions:
+            decodeFunctionDefinitionsSection(sectionStream, moduleState);
+            break;
+        case SectionType::data:
+            decodeDataSection(sectionStream, moduleState);
+            break;
+        default:
+            Errors::unreachable();
+    };
+
+    if (sectionStream.capacity()) {
+        throw FatalSerializationException("section contained more data than expected");
+    }
+}
+
+// Does the validation that must wait until all of the module's sections have been decoded.
+static void finishModule(ModuleState &moduleState) {
+    if (!moduleState.hasFunctionDefinitionsSection && moduleState.module.functions.defs.size()) {
+        throw FatalSerializationException("function and code section have inconsistent lengths");
+    }
+
+    moduleState.validatePreCodeSectionsOnce();
+    validatePostCodeSections(moduleState.module, moduleState.deferredCodeValidationState);
+}
+
+static void decodeModule(InputStream &stream, Module &module) {
+    decodeModuleHeader(stream);
+
+    // If the module has a backing buffer, the caller guarantees that the input is in it.
+    ModuleState moduleState(module);
+    moduleState.loadViews = bool(module.backingBuffer);
+    Uptr lastSectionOrder = 0;
+    while (stream.capacity()) {
+        const SectionType sectionType = SectionType(decodeU8(stream));
+        const Uptr numSectionBytes = decodeVarUInt32(stream);
+        MemoryInputStream sectionStream(stream.advance(numSectionBytes), numSectionBytes);
+
+        checkSectionOrder(sectionType, lastSectionOrder);
+        decodeSection(sectionType, sectionStream, moduleState);
+    };
+
+    finishModule(moduleState);
+}
+
+bool WASM::isBinaryModule(const U8 *bytes, Uptr numBytes) {
+    U32 magic = 0;
+    if (numBytes < sizeof(magic)) {
+        return false;
+    }
+    memcpy(&magic, bytes, sizeof(magic));
+    return magic == magicNumber;
+}
+
+// Calls a function that decodes part of a module, and translates the exceptions it may throw for a
+// malformed or invalid module to an error message.
+template<typename Decode> static bool catchDecodeErrors(Decode &&decode, std::string *outErrorMessage) {
+    try {
+        decode();
+        return true;
+    } catch (const FatalSerializationException &exception) {
+        if (outErrorMessage) {
+            *outErrorMessage = "malformed module: " + exception.message;
+        }
+    } catch (const ValidationException &exception) {
+        if (outErrorMessage) {
+            *outErrorMessage = "invalid module: " + exception.message;
+        }
+    }
+    return false;
+}
+
+bool WASM::parseModule(const U8 *bytes, Uptr numBytes, IR::Module &outModule, std::string *outErrorMessage) {
+    return catchDecodeErrors([&] {
+        MemoryInputStream stream(bytes, numBytes);
+        decodeModule(stream, outModule);
+    }, outErrorMessage);
+}
+
+//
+// Streaming parser
+//
+
+struct WASM::StreamingModuleParser {
+    enum class State {
+        header,
+        sectionHeader,
+        section,
+        functionDefinitionsSectionHeader,
+        functionDefinition,
+        failed,
+    };
+
+    ModuleState moduleState;
+    DecodedFunctionDefCallback decodedFunctionDefCallback;
+
+    // The bytes that have been provided, and how many of them have been decoded.
+    std::vector<U8> bytes;
+    Uptr numDecodedBytes = 0;
+
+    State state = State::header;
+    std::string errorMessage;
+    Uptr lastSectionOrder = 0;
+    SectionType sectionType = SectionType::user;
+
+    // The number of bytes in the current section that haven't been decoded yet.
+    Uptr numSectionBytes = 0;
+
+    Uptr nextFunctionDefIndex = 0;
+
+    StreamingModuleParser(Module &module, DecodedFunctionDefCallback &&inDecodedFunctionDefCallback)
+            : moduleState(module), decodedFunctionDefCallback(std::move(inDecodedFunctionDefCallback)) {
+    }
+};
+
+// Returns whether the bytes start with a complete LEB128 encoded U32, or with at least as many bytes
+// as a U32 may be encoded with, so decoding it won't fail due to bytes that haven't arrived yet.
+static bool hasVarUInt32(const U8 *bytes, Uptr numBytes) {
+    for (Uptr byteIndex = 0; byteIndex < numBytes && byteIndex < 5; ++byteIndex) {
+        if (!(bytes[byteIndex] & 0x80)) {
+            return true;
+        }
+    }
+    return numBytes >= 5;
+}
+
+// Decodes as much of the module as the provided bytes allow.
+static void decodeAvailableBytes(StreamingModuleParser &parser) {
+    std::vector<FunctionDef> &functionDefs = parser.moduleState.module.functions.defs;
+    while (true) {
+        const U8 *nextByte = parser.bytes.data() + parser.numDecodedBytes;
+        const Uptr numAvailableBytes = parser.bytes.size() - parser.numDecodedBytes;
+        switch (parser.state) {
+            case StreamingModuleParser::State::header: {
+                const Uptr numHeaderBytes = sizeof(magicNumber) + sizeof(currentVersion);
+                if (numAvailableBytes < numHeaderBytes) {
+                    return;
+                }
+                MemoryInputStream headerStream(nextByte, numHeaderBytes);
+                decodeModuleHeader(headerStream);
+                parser.numDecodedBytes += numHeaderBytes;
+                parser.state = StreamingModuleParser::State::sectionHeader;
+                break;
+            }
+            case StreamingModuleParser::State::sectionHeader: {
+                if (!numAvailableBytes || !hasVarUInt32(nextByte + 1, numAvailableBytes - 1)) {
+                    return;
+                }
+                MemoryInputStream headerStream(nextByte, numAvailableBytes);
+                parser.sectionType = SectionType(decodeU8(headerStream));
+                parser.numSectionBytes = decodeVarUInt32(headerStream);
+                parser.numDecodedBytes += numAvailableBytes - headerStream.capacity();
+
+                checkSectionOrder(parser.sectionType, parser.lastSectionOrder);
+                parser.state = parser.sectionType == SectionType::functionDefinitions ? StreamingModuleParser::State::functionDefinitionsSectionHeader : StreamingModuleParser::State::section;
+                break;
+            }
+            case StreamingModuleParser::State::section: {
+                // Sections other than the code section are decoded once all their bytes arrive.
+                if (numAvailableBytes < parser.numSectionBytes) {
+                    return;
+                }
+                MemoryInputStream sectionStream(nextByte, parser.numSectionBytes);
+                decodeSection(parser.sectionType, sectionStream, parser.moduleState);
+                parser.numDecodedBytes += parser.numSectionBytes;
+                parser.state = StreamingModuleParser::State::sectionHeader;
+                break;
+            }
+            case StreamingModuleParser::State::functionDefinitionsSectionHeader: {
+                const Uptr numHeaderBytes = std::min(numAvailableBytes, parser.numSectionBytes);
+                if (numHeaderBytes < parser.numSectionBytes && !hasVarUInt32(nextByte, numHeaderBytes)) {
+                    return;
+                }
+                MemoryInputStream headerStream(nextByte, numHeaderBytes);
+                decodeFunctionDefinitionsSectionHeader(headerStream, parser.moduleState);
+                const Uptr numDecodedHeaderBytes = numHeaderBytes - headerStream.capacity();
+                parser.numDecodedBytes += numDecodedHeaderBytes;
+                parser.numSectionBytes -= numDecodedHeaderBytes;
+                parser.nextFunctionDefIndex = 0;
+                parser.state = StreamingModuleParser::State::functionDefinition;
+                break;
+            }
+            case StreamingModuleParser::State::functionDefinition: {
+                if (parser.nextFunctionDefIndex == functionDefs.size()) {
+                    if (parser.numSectionBytes) {
+                        throw FatalSerializationException("section contained more data than expected");
+                    }
+                    parser.state = StreamingModuleParser::State::sectionHeader;
+                    break;
+                }
+
+                // Each function body is decoded as soon as all its bytes arrive.
+                const Uptr numHeaderBytes = std::min(numAvailableBytes, parser.numSectionBytes);
+                if (numHeaderBytes < parser.numSectionBytes && !hasVarUInt32(nextByte, numHeaderBytes)) {
+                    return;
+                }
+                MemoryInputStream headerStream(nextByte, numHeaderBytes);
+                const Uptr numBodyBytes = decodeVarUInt32(headerStream);
+                const Uptr numSizeBytes = numHeaderBytes - headerStream.capacity();
+                if (numBodyBytes > parser.numSectionBytes - numSizeBytes) {
+                    throw FatalSerializationException("expected data but found end of stream");
+                }
+                if (numAvailableBytes - numSizeBytes < numBodyBytes) {
+                    return;
+                }
+
+                MemoryInputStream bodyStream(nextByte + numSizeBytes, numBodyBytes);
+                decodeFunctionDefinition(bodyStream, parser.moduleState.module, parser.moduleState.deferredCodeValidationState, functionDefs[parser.nextFunctionDefIndex]);
+                parser.numDecodedBytes += numSizeBytes + numBodyBytes;
+                parser.numSectionBytes -= numSizeBytes + numBodyBytes;
+
+                parser.decodedFunctionDefCallback(parser.nextFunctionDefIndex++);
+                break;
+            }
+            default:
+                Errors::unreachable();
+        };
+    }
+}
+
+StreamingModuleParser *WASM::createStreamingModuleParser(IR::Module &outModule, DecodedFunctionDefCallback &&decodedFunctionDefCallback) {
+    return new StreamingModuleParser(outModule, std::move(decodedFunctionDefCallback));
+}
+
+void WASM::destroyStreamingModuleParser(StreamingModuleParser *parser) {
+    delete parser;
+}
+
+bool WASM::addStreamingModuleBytes(StreamingModuleParser *parser, const U8 *bytes, Uptr numBytes, std::string *outErrorMessage) {
+    if (parser->state != StreamingModuleParser::State::failed) {
+        parser->bytes.insert(parser->bytes.end(), bytes, bytes + numBytes);
+        if (catchDecodeErrors([parser] { decodeAvailableBytes(*parser); }, &parser->errorMessage)) {
+            // Discard the decoded bytes: only the bytes of an incomplete section or function body
+            // need to be kept.
+            parser->bytes.erase(parser->bytes.begin(), parser->bytes.begin() + parser->numDecodedBytes);
+            parser->numDecodedBytes = 0;
+            return true;
+        }
+        parser->state = StreamingModuleParser::State::failed;
+    }
+
+    if (outErrorMessage) {
+        *outErrorMessage = parser->errorMessage;
+    }
+    return false;
+}
+
+bool WASM::finishStreamingModuleParser(StreamingModuleParser *parser, std::string *outErrorMessage) {
+    if (parser->state != StreamingModuleParser::State::failed) {
+        if (catchDecodeErrors([parser] {
+            if (parser->state != StreamingModuleParser::State::sectionHeader || parser->bytes.size()) {
+                throw FatalSerializationException("expected data but found end of stream");
+            }
+            finishModule(parser->moduleState);
+        }, &parser->errorMessage)) {
+            return true;
+        }
+        parser->state = StreamingModuleParser::State::failed;
+    }
+
+    if (outErrorMessage) {
+        *outErrorMessage = parser->errorMessage;
+    }
+    return false;
+}
@@ -0,0 +1,35 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+
+#include "Lexer.h"
+#include "WAVM/NFA/NFA.h"
+
+using namespace WAVM;
+using namespace WAVM::WAST;
+
+// Writes the tables of the lexer's DFA to the C++ header named by the command-line, for Lexer.cpp to
+// load instead of building the DFA at runtime.
+int main(int argc, char **argv) {
+    if (argc != 2) {
+        fprintf(stderr, "Usage: GenerateLexerTables <output header>\n");
+        return EXIT_FAILURE;
+    }
+
+    const NFA::Machine machine = createLexerMachine();
+    const std::string header = "// Generated by GenerateLexerTables from the lexer's token definitions; do not edit.\n\n"
+                               "#pragma once\n\n" +
+                               machine.dumpCppTables("lexer");
+
+    FILE *file = fopen(argv[1], "wb");
+    if (!file) {
+        fprintf(stderr, "Couldn't open %s for writing.\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+    const bool succeeded = fwrite(header.data(), 1, header.size(), file) == header.size();
+    if (fclose(file) || !succeeded) {
+        fprintf(stderr, "Couldn't write %s.\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -1,11 +1,24 @@
 #include <inttypes.h>
 #include <stdlib.h>
+#include <string.h>
+#include <algorithm>
 #include <string>
 #include <tuple>
 
 #include "Lexer.h"
+#include "WAVM/Inline/Config.h"
 #include "WAVM/NFA/NFA.h"
-#include "WAVM/RegExp/RegExp.h"
+#include "WAVM/Platform/Intrinsic.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#if WAVM_ENABLE_PRECOMPUTED_LEXER
+#include "LexerTables.h"
+#endif
 
 using namespace WAVM;
 using namespace WAVM::WAST;
@@ -35,83 +48,291 @@ struct StaticData {
     StaticData();
 };
 
-static NFA::StateIndex createTokenSeparatorPeekState(NFA::Builder *builder, NFA::StateIndex finalState) {
-    NFA::CharSet tokenSeparatorCharSet;
-    tokenSeparatorCharSet.add(U8(' '));
-    tokenSeparatorCharSet.add(U8('\t'));
-    tokenSeparatorCharSet.add(U8('\r'));
-    tokenSeparatorCharSet.add(U8('\n'));
-    tokenSeparatorCharSet.add(U8('='));
-    tokenSeparatorCharSet.add(U8('('));
-    tokenSeparatorCharSet.add(U8(')'));
-    tokenSeparatorCharSet.add(U8(';'));
-    tokenSeparatorCharSet.add(0);
-    auto separatorState = addState(builder);
-    NFA::addEdge(builder, separatorState, tokenSeparatorCharSet, finalState | NFA::edgeDoesntConsumeInputFlag);
-    return separatorState;
+StaticData::StaticData() {
+#if WAVM_ENABLE_PRECOMPUTED_LEXER
+    // Load the tables that GenerateLexerTables built from createLexerMachine at build time.
+    nfaMachine = NFA::Machine(lexerCharToOffsetMap, lexerStateAndOffsetToNextStateMap, lexerNumClasses, lexerNumStates);
+#else
+    nfaMachine = createLexerMachine();
+#endif
 }
 
-static void addLiteralToNFA(const char *string, NFA::Builder *builder, NFA::StateIndex initialState, NFA::StateIndex finalState) {
-    for (const char *nextChar = string; *nextChar; ++nextChar) {
-        NFA::StateIndex nextState = NFA::getNonTerminalEdge(builder, initialState, *nextChar);
-        if (nextState < 0 || nextChar[1] == 0) {
-            nextState = nextChar[1] == 0 ? finalState : addState(builder);
-            NFA::addEdge(builder, initialState, NFA::CharSet(*nextChar), nextState);
+// The initial capacity of the token and line start arrays. It doesn't depend on the length of the
+// string, so a string with few tokens or lines, such as one that is mostly a data segment, doesn't
+// allocate arrays proportional to its length.
+static constexpr Uptr initialTokensCapacity = 1024;
+static constexpr Uptr initialLineStartsCapacity = 256;
+
+// A malloc'd array that the lexer adds elements to, and that grows geometrically as it's filled, so
+// its size is proportional to the number of elements added rather than the length of the string.
+template<typename Element> struct LexerArray {
+    Element *elements;
+    Element *next;
+    Element *end;
+
+    LexerArray(Uptr initialCapacity) {
+        elements = (Element *) malloc(sizeof(Element) * initialCapacity);
+        next = elements;
+        end = elements + initialCapacity;
+    }
+
+    ~LexerArray() {
+        free(elements);
+    }
+
+    // Ensures that numElements more elements can be added at next.
+    void reserve(Uptr numElements) {
+        if (Uptr(end - next) < numElements) {
+            grow(numElements);
         }
-        initialState = nextState;
     }
+
+    // Shrinks the array to the elements that were added, and passes its ownership to the caller,
+    // who must free it.
+    Element *release(Uptr &outNumElements) {
+        outNumElements = Uptr(next - elements);
+        Element *result = (Element *) realloc(elements, sizeof(Element) * outNumElements);
+        elements = next = end = nullptr;
+        return result;
+    }
+
+private:
+    void grow(Uptr numElements) {
+        const Uptr numAddedElements = Uptr(next - elements);
+        const Uptr capacity = std::max(Uptr(end - elements) * 2, numAddedElements + numElements);
+        elements = (Element *) realloc(elements, sizeof(Element) * capacity);
+        next = elements + numAddedElements;
+        end = elements + capacity;
+    }
+};
+
+// The lexer skips whitespace, comments and string bodies a block of 16 chars at a time. A block is
+// compared to a char to get a vector with all bits set in the chars that are equal, and the vector is
+// converted to a mask with charBlockMaskBitsPerChar bits for each char.
+static constexpr Uptr charBlockNumChars = 16;
+
+#if defined(__SSE2__) || defined(_M_X64)
+typedef __m128i CharBlock;
+static constexpr Uptr charBlockMaskBitsPerChar = 1;
+static constexpr U64 charBlockAllCharsMask = 0xffff;
+
+static inline CharBlock loadCharBlock(const char *chars, const char *string, const char *stringEnd) {
+    return _mm_load_si128(reinterpret_cast<const __m128i *>(chars));
 }
 
-StaticData::StaticData() {
-    static const std::pair<TokenType, const char *> regexpTokenPairs[] = {{t_decimalInt,   "[+\\-]?\\d+(_\\d+)*"},
-                                                                          {t_decimalFloat, "[+\\-]?\\d+(_\\d+)*\\.(\\d+(_\\d+)*)*([eE][+\\-]?\\d+(_\\d+)*)?"},
-                                                                          {t_decimalFloat, "[+\\-]?\\d+(_\\d+)*[eE][+\\-]?\\d+(_\\d+)*"},
+static inline CharBlock matchChar(CharBlock block, char c) {
+    return _mm_cmpeq_epi8(block, _mm_set1_epi8(c));
+}
 
-                                                                          {t_hexInt,       "[+\\-]?0[xX][\\da-fA-F]+(_[\\da-fA-F]+)*"},
-                                                                          {t_hexFloat,     "[+\\-]?0[xX][\\da-fA-F]+(_[\\da-fA-F]+)*\\.([\\da-fA-F]+(_[\\da-fA-F]+)*)*([pP][+\\-]?\\d+(_\\d+)*)?"},
-                                                                          {t_hexFloat,     "[+\\-]?0[xX][\\da-fA-F]+(_[\\da-fA-F]+)*[pP][+\\-]?\\d+(_\\d+)*"},
+static inline CharBlock orMatches(CharBlock a, CharBlock b) {
+    return _mm_or_si128(a, b);
+}
 
-                                                                          {t_floatNaN,     "[+\\-]?nan(:0[xX][\\da-fA-F]+(_[\\da-fA-F]+)*)?"},
-                                                                          {t_floatInf,     "[+\\-]?inf"},
+static inline U64 getMatchMask(CharBlock matches) {
+    return U64(_mm_movemask_epi8(matches));
+}
+#elif defined(__ARM_NEON)
+typedef uint8x16_t CharBlock;
+static constexpr Uptr charBlockMaskBitsPerChar = 4;
+static constexpr U64 charBlockAllCharsMask = 0x1111111111111111ull;
 
-                                                                          {t_string,       "\"([^\"\n\\\\]*(\\\\([^0-9a-fA-Fu]|[0-9a-fA-F][0-9a-fA-F]|u\\{[0-9a-fA-F]+})))*\""},
+static inline CharBlock loadCharBlock(const char *chars, const char *string, const char *stringEnd) {
+    return vld1q_u8(reinterpret_cast<const uint8_t *>(chars));
+}
 
-                                                                          {t_name,         "\\$[a-zA-Z0-9\'_+*/~=<>!?@#$%&|:`.\\-\\^\\\\]+"},
-                                                                          {t_quotedName,   "\\$\"([^\"\n\\\\]*(\\\\([^0-9a-fA-Fu]|[0-9a-fA-F][0-9a-fA-F]|u\\{[0-9a-fA-F]+})))*\""},};
-    static const std::tuple<TokenType, const char *, bool> literalTokenTuples[] = {std::make_tuple(t_leftParenthesis, "(", true), std::make_tuple(t_rightParenthesis, ")", true), std::make_tuple(t_equals, "=", true),
+static inline CharBlock matchChar(CharBlock block, char c) {
+    return vceqq_u8(block, vdupq_n_u8(U8(c)));
+}
 
-#define VISIT_TOKEN(name, _, literalString) std::make_tuple(t_##name, literalString, false),
-                                                                                   ENUM_LITERAL_TOKENS()
-#undef VISIT_TOKEN
+static inline CharBlock orMatches(CharBlock a, CharBlock b) {
+    return vorrq_u8(a, b);
+}
 
-#undef VISIT_OPERATOR_TOKEN
-#define VISIT_OPERATOR_TOKEN(_, name, nameString, ...) std::make_tuple(t_##name, nameString, false),
-                                                                                   ENUM_OPERATORS(VISIT_OPERATOR_TOKEN)
-#undef VISIT_OPERATOR_TOKEN
-    };
+static inline U64 getMatchMask(CharBlock matches) {
+    // Narrow each 16-bit lane to 8 bits, which leaves 4 bits for each char, and keep one of them.
+    const uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(matches), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0) & charBlockAllCharsMask;
+}
+#else
+struct CharBlock {
+    U8 chars[charBlockNumChars];
+};
+static constexpr Uptr charBlockMaskBitsPerChar = 1;
+static constexpr U64 charBlockAllCharsMask = 0xffff;
+
+// Unlike the vector loads, which can't fault on the bytes of an aligned block outside the string,
+// a memcpy of them is undefined, so only the chars of the block that are in the string are copied,
+// and the others are zero. The scan masks out the chars before the string's start, and always stops
+// at or before its null terminator.
+static inline CharBlock loadCharBlock(const char *chars, const char *string, const char *stringEnd) {
+    CharBlock block;
+    memset(block.chars, 0, charBlockNumChars);
+    const char *begin = chars < string ? string : chars;
+    const char *end = chars + charBlockNumChars > stringEnd ? stringEnd : chars + charBlockNumChars;
+    if (begin < end) {
+        memcpy(block.chars + (begin - chars), begin, Uptr(end - begin));
+    }
+    return block;
+}
 
-    NFA::Builder *nfaBuilder = NFA::createBuilder();
+static inline CharBlock matchChar(CharBlock block, char c) {
+    CharBlock matches;
+    for (Uptr index = 0; index < charBlockNumChars; ++index) {
+        matches.chars[index] = block.chars[index] == U8(c) ? 0xff : 0;
+    }
+    return matches;
+}
+
+static inline CharBlock orMatches(CharBlock a, CharBlock b) {
+    CharBlock matches;
+    for (Uptr index = 0; index < charBlockNumChars; ++index) {
+        matches.chars[index] = a.chars[index] | b.chars[index];
+    }
+    return matches;
+}
 
-    for (auto regexpTokenPair : regexpTokenPairs) {
-        NFA::StateIndex finalState = NFA::maximumTerminalStateIndex - (NFA::StateIndex) regexpTokenPair.first;
-        finalState = createTokenSeparatorPeekState(nfaBuilder, finalState);
-        RegExp::addToNFA(regexpTokenPair.second, nfaBuilder, 0, finalState);
+static inline U64 getMatchMask(CharBlock matches) {
+    U64 mask = 0;
+    for (Uptr index = 0; index < charBlockNumChars; ++index) {
+        mask |= U64(matches.chars[index] & 1) << index;
     }
+    return mask;
+}
+#endif
+
+// Returns the mask of the chars in the block at or after nextChar.
+static inline U64 getCharBlockStartMask(const char *block, const char *nextChar) {
+    return charBlockAllCharsMask & (~U64(0) << Uptr(nextChar - block) * charBlockMaskBitsPerChar);
+}
 
-    for (auto literalTokenTuple : literalTokenTuples) {
-        const TokenType tokenType = std::get<0>(literalTokenTuple);
-        const char *literalString = std::get<1>(literalTokenTuple);
-        const bool isTokenSeparator = std::get<2>(literalTokenTuple);
+// Returns a pointer to the first char at or after nextChar that is in the mask returned by
+// getStopMask(block). The blocks are loaded from aligned addresses, which may read past stringEnd,
+// the end of the string, but never into the next page, so the stop chars must include the null
+// terminator.
+// If lineStarts is non-null, the offset plus lineStartBias of each newline before the stop char is
+// added to it.
+template<typename GetStopMask>
+static inline const char *scanToStopChar(const char *string, const char *stringEnd, const char *nextChar, LexerArray<U32> *lineStarts, Uptr lineStartBias, GetStopMask getStopMask) {
+    const char *block = reinterpret_cast<const char *>(reinterpret_cast<Uptr>(nextChar) & ~(charBlockNumChars - 1));
+    U64 startMask = getCharBlockStartMask(block, nextChar);
+    while (true) {
+        const CharBlock chars = loadCharBlock(block, string, stringEnd);
+        const U64 stopMask = getStopMask(chars) & startMask;
 
-        NFA::StateIndex finalState = NFA::maximumTerminalStateIndex - (NFA::StateIndex) tokenType;
-        if (!isTokenSeparator) {
-            finalState = createTokenSeparatorPeekState(nfaBuilder, finalState);
+        if (lineStarts) {
+            U64 newlineMask = getMatchMask(matchChar(chars, '\n')) & startMask;
+            if (stopMask) {
+                newlineMask &= (stopMask & (~stopMask + 1)) - 1;
+            }
+            if (newlineMask) {
+                lineStarts->reserve(charBlockNumChars);
+                do {
+                    const Uptr newlineOffset = Uptr(Platform::countTrailingZeroes(newlineMask)) / charBlockMaskBitsPerChar;
+                    *lineStarts->next++ = U32(block + newlineOffset - string + lineStartBias);
+                    newlineMask &= newlineMask - 1;
+                } while (newlineMask);
+            }
         }
 
-        addLiteralToNFA(literalString, nfaBuilder, 0, finalState);
+        if (stopMask) {
+            return block + Platform::countTrailingZeroes(stopMask) / charBlockMaskBitsPerChar;
+        }
+        block += charBlockNumChars;
+        startMask = charBlockAllCharsMask;
     }
+}
 
-    nfaMachine = NFA::Machine(nfaBuilder);
+// Skips spaces, tabs, carriage returns, form feeds and newlines, adding the newlines to the line
+// starts, and returns a pointer to the first other char.
+static inline const char *skipWhitespace(const char *string, const char *stringEnd, const char *nextChar, LexerArray<U32> &lineStarts) {
+    return scanToStopChar(string, stringEnd, nextChar, &lineStarts, 1, [](CharBlock chars) {
+        const CharBlock whitespace = orMatches(orMatches(matchChar(chars, ' '), matchChar(chars, '\t')),
+                                               orMatches(orMatches(matchChar(chars, '\r'), matchChar(chars, '\f')), matchChar(chars, '\n')));
+        return ~getMatchMask(whitespace) & charBlockAllCharsMask;
+    });
+}
+
+// Returns a pointer to the first newline or null char at or after nextChar.
+static inline const char *findLineCommentEnd(const char *string, const char *stringEnd, const char *nextChar) {
+    return scanToStopChar(string, stringEnd, nextChar, nullptr, 0, [](CharBlock chars) {
+        return getMatchMask(orMatches(matchChar(chars, '\n'), matchChar(chars, 0)));
+    });
+}
+
+// Returns a pointer to the first char at or after nextChar that may begin or end a block comment, or
+// is a null char, adding the newlines before it to the line starts.
+static inline const char *findBlockCommentDelimiter(const char *string, const char *stringEnd, const char *nextChar, LexerArray<U32> &lineStarts) {
+    return scanToStopChar(string, stringEnd, nextChar, &lineStarts, 0, [](CharBlock chars) {
+        return getMatchMask(orMatches(orMatches(matchChar(chars, '('), matchChar(chars, ';')), matchChar(chars, 0)));
+    });
+}
+
+inline bool isHexDigitChar(char c) {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+inline bool isTokenSeparatorChar(char c) {
+    switch (c) {
+        case ' ':
+        case '\t':
+        case '\r':
+        case '\n':
+        case '=':
+        case '(':
+        case ')':
+        case ';':
+        case 0:
+            return true;
+        default:
+            return false;
+    };
+}
+
+// Scans a quoted string token starting at nextChar, which points to its opening quote, the same as
+// the DFA's t_string regexp. If the string and its following token separator are well-formed,
+// advances nextChar past the closing quote and returns true. Otherwise, returns false, and the DFA
+// is left to find where the token fails to match.
+static inline bool scanStringToken(const char *string, const char *stringEnd, const char *&nextChar) {
+    const char *nextStringChar = nextChar + 1;
+    while (true) {
+        nextStringChar = scanToStopChar(string, stringEnd, nextStringChar, nullptr, 0, [](CharBlock chars) {
+            return getMatchMask(orMatches(orMatches(matchChar(chars, '\"'), matchChar(chars, '\\')),
+                                          orMatches(matchChar(chars, '\n'), matchChar(chars, 0))));
+        });
+        if (*nextStringChar == '\"') {
+            if (!isTokenSeparatorChar(nextStringChar[1])) {
+                return false;
+            }
+            nextChar = nextStringChar + 1;
+            return true;
+        } else if (*nextStringChar != '\\') {
+            return false;
+        }
+
+        const char escapedChar = nextStringChar[1];
+        if (isHexDigitChar(escapedChar)) {
+            if (!isHexDigitChar(nextStringChar[2])) {
+                return false;
+            }
+            nextStringChar += 3;
+        } else if (escapedChar == 'u') {
+            if (nextStringChar[2] != '{' || !isHexDigitChar(nextStringChar[3])) {
+                return false;
+            }
+            nextStringChar += 4;
+            while (isHexDigitChar(*nextStringChar)) {
+                ++nextStringChar;
+            }
+            if (*nextStringChar != '}') {
+                return false;
+            }
+            ++nextStringChar;
+        } else if (escapedChar == 0) {
+            return false;
+        } else {
+            nextStringChar += 2;
+        }
+    };
 }
 
 inline bool isRecoveryPointChar(char c) {
@@ -139,30 +360,29 @@ Token *WAST::lex(const char *string, Uptr stringLength, LineInfo *&outLineInfo)
         Errors::fatalf("cannot lex strings with more than %u characters", UINT32_MAX);
     }
 
-    Token *tokens = (Token *) malloc(sizeof(Token) * (stringLength + 1));
-    U32 *lineStarts = (U32 *) malloc(sizeof(U32) * (stringLength + 2));
-
-    Token *nextToken = tokens;
-    U32 *nextLineStart = lineStarts;
-    *nextLineStart++ = 0;
+    // Start with a fixed capacity, and grow as needed: strings, such as data segments, may have far
+    // fewer tokens and lines than chars.
+    LexerArray<Token> tokens(initialTokensCapacity);
+    LexerArray<U32> lineStarts(initialLineStartsCapacity);
+    *lineStarts.next++ = 0;
 
     const char *nextChar = string;
     while (true) {
+        // Each iteration adds up to two tokens: an unterminated comment, and the next token.
+        tokens.reserve(2);
         while (true) {
+            nextChar = skipWhitespace(string, string + stringLength, nextChar, lineStarts);
             switch (*nextChar) {
                 case ';':
                     if (nextChar[1] != ';') {
                         goto doneSkippingWhitespace;
                     } else {
-                        nextChar += 2;
-                        while (*nextChar) {
-                            if (*nextChar == '\n') {
-                                *nextLineStart++ = U32(nextChar - string + 1);
-                                ++nextChar;
-                                break;
-                            }
+                        nextChar = findLineCommentEnd(string, string + stringLength, nextChar + 2);
+                        if (*nextChar == '\n') {
+                            lineStarts.reserve(1);
+                            *lineStarts.next++ = U32(nextChar - string + 1);
                             ++nextChar;
-                        };
+                        }
                     }
                     break;
                 case '(':
@@ -173,6 +393,7 @@ Token *WAST::lex(const char *string, Uptr stringLength, LineInfo *&outLineInfo)
                         nextChar += 2;
                         U32 commentDepth = 1;
                         while (commentDepth) {
+                            nextChar = findBlockCommentDelimiter(string, string + stringLength, nextChar, lineStarts);
                             if (nextChar[0] == ';' && nextChar[1] == ')') {
                                 --commentDepth;
                                 nextChar += 2;
@@ -180,44 +401,36 @@ Token *WAST::lex(const char *string, Uptr stringLength, LineInfo *&outLineInfo)
                                 ++commentDepth;
                                 nextChar += 2;
                             } else if (nextChar == string + stringLength - 1) {
-                                nextToken->type = t_unterminatedComment;
-                                nextToken->begin = U32(firstCommentChar - string);
-                                ++nextToken;
+                                tokens.next->type = t_unterminatedComment;
+                                tokens.next->begin = U32(firstCommentChar - string);
+                                ++tokens.next;
                                 goto doneSkippingWhitespace;
                             } else {
-                                if (*nextChar == '\n') {
-                                    *nextLineStart++ = U32(nextChar - string);
-                                }
                                 ++nextChar;
                             }
                         };
                     }
                     break;
-                case '\n':
-                    *nextLineStart++ = U32(nextChar - string + 1);
-                    ++nextChar;
-                    break;
-                case ' ':
-                case '\t':
-                case '\r':
-                case '\f':
-                    ++nextChar;
-                    break;
                 default:
                     goto doneSkippingWhitespace;
             }
         }
         doneSkippingWhitespace:
 
-        nextToken->begin = U32(nextChar - string);
+        tokens.next->begin = U32(nextChar - string);
+        if (*nextChar == '\"' && scanStringToken(string, string + stringLength, nextChar)) {
+            tokens.next->type = t_string;
+            ++tokens.next;
+            continue;
+        }
         NFA::StateIndex terminalState = staticData.nfaMachine.feed(nextChar);
         if (terminalState != NFA::unmatchedCharacterTerminal) {
-            nextToken->type = TokenType(NFA::maximumTerminalStateIndex - (NFA::StateIndex) terminalState);
-            ++nextToken;
+            tokens.next->type = TokenType(NFA::maximumTerminalStateIndex - (NFA::StateIndex) terminalState);
+            ++tokens.next;
         } else {
-            if (nextToken->begin < stringLength - 1) {
-                nextToken->type = t_unrecognized;
-                ++nextToken;
+            if (tokens.next->begin < stringLength - 1) {
+                tokens.next->type = t_unrecognized;
+                ++tokens.next;
 
                 const char *stringEnd = string + stringLength - 1;
                 while (nextChar < stringEnd && !isRecoveryPointChar(*nextChar)) {
@@ -229,19 +442,19 @@ Token *WAST::lex(const char *string, Uptr stringLength, LineInfo *&outLineInfo)
         }
     }
 
-    nextToken->type = t_eof;
-    ++nextToken;
-
-    *nextLineStart++ = U32(nextChar - string) + 1;
+    // The last iteration left room for the end token, and set its begin.
+    tokens.next->type = t_eof;
+    ++tokens.next;
 
-    const Uptr numLineStarts = nextLineStart - lineStarts;
-    const Uptr numTokens = nextToken - tokens;
-    lineStarts = (U32 *) realloc(lineStarts, sizeof(U32) * numLineStarts);
-    tokens = (Token *) realloc(tokens, sizeof(Token) * numTokens);
+    lineStarts.reserve(1);
+    *lineStarts.next++ = U32(nextChar - string) + 1;
 
-    outLineInfo = new LineInfo{lineStarts, U32(numLineStarts)};
+    Uptr numLineStarts;
+    U32 *lineStartsArray = lineStarts.release(numLineStarts);
+    outLineInfo = new LineInfo{lineStartsArray, U32(numLineStarts)};
 
-    return tokens;
+    Uptr numTokens;
+    return tokens.release(numTokens);
 }
 
 void WAST::freeTokens(Token *tokens) {
@@ -2,6 +2,7 @@
 
 #include "WAVM/IR/Operators.h"
 #include "WAVM/Inline/BasicTypes.h"
+#include "WAVM/NFA/NFA.h"
 #include "WAVM/Platform/Defines.h"
 #include "WAVM/WASTParse/WASTParse.h"
 
@@ -102,14 +103,20 @@ namespace WAVM {
         // Also returns a pointer in outLineInfo to the information necessary to resolve line/column
         // numbers for the tokens. The caller should pass the tokens and line info to
         // freeTokens/freeLineInfo, respectively, when it is done with them.
-        Token *lex(const char *string, Uptr stringLength, LineInfo *&outLineInfo);
+        // The lexer is exported so the benchmarks can measure it separately from the parser.
+        WASTPARSE_API Token *lex(const char *string, Uptr stringLength, LineInfo *&outLineInfo);
 
-        void freeTokens(Token *tokens);
+        WASTPARSE_API void freeTokens(Token *tokens);
 
-        void freeLineInfo(LineInfo *lineInfo);
+        WASTPARSE_API void freeLineInfo(LineInfo *lineInfo);
 
         const char *describeToken(TokenType tokenType);
 
+        // Builds the DFA that lex uses from the token regexps and literal strings. By default, lex
+        // loads tables that GenerateLexerTables precomputed with this at build time instead. It is
+        // exported so the benchmarks can compare the DFA's table layouts.
+        WASTPARSE_API NFA::Machine createLexerMachine();
+
         TextFileLocus calcLocusFromOffset(const char *string, const LineInfo *lineInfo, Uptr charOffset);
     }
 }
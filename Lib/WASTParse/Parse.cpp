@@ -204,12 +204,12 @@ UnresolvedFunctionType WAST::parseFunctionTypeRefAndOrDecl(CursorState *cursor,
     return result;
 }
 
-IndexedFunctionType WAST::resolveFunctionType(ModuleState *moduleState, const UnresolvedFunctionType &unresolvedType) {
+IndexedFunctionType WAST::resolveFunctionType(ParseState *parseState, ModuleState *moduleState, const UnresolvedFunctionType &unresolvedType) {
     if (!unresolvedType.reference) {
         return getUniqueFunctionTypeIndex(moduleState, unresolvedType.explicitType);
     } else {
         // Resolve the referenced type.
-        const Uptr referencedFunctionTypeIndex = resolveRef(moduleState->parseState, moduleState->typeNameToIndexMap, moduleState->module.types.size(), unresolvedType.reference);
+        const Uptr referencedFunctionTypeIndex = resolveRef(parseState, moduleState->typeNameToIndexMap, moduleState->module.types.size(), unresolvedType.reference);
 
         // Validate that if the function definition has both a type reference and explicit
         // parameter/result type declarations, they match.
@@ -217,8 +217,8 @@ IndexedFunctionType WAST::resolveFunctionType(ModuleState *moduleState, const Un
         if (hasExplicitParametersOrResultType) {
             if (referencedFunctionTypeIndex != UINTPTR_MAX &&
                 moduleState->module.types[referencedFunctionTypeIndex] != unresolvedType.explicitType) {
-                parseErrorf(moduleState->parseState, unresolvedType.reference.token, "referenced function type (%s) does not match declared parameters and "
-                                                                                     "results (%s)", asString(moduleState->module.types[referencedFunctionTypeIndex]).c_str(), asString(unresolvedType.explicitType).c_str());
+                parseErrorf(parseState, unresolvedType.reference.token, "referenced function type (%s) does not match declared parameters and "
+                                                                        "results (%s)", asString(moduleState->module.types[referencedFunctionTypeIndex]).c_str(), asString(unresolvedType.explicitType).c_str());
             }
         }
 
@@ -227,6 +227,14 @@ IndexedFunctionType WAST::resolveFunctionType(ModuleState *moduleState, const Un
 }
 
 IndexedFunctionType WAST::getUniqueFunctionTypeIndex(ModuleState *moduleState, FunctionType functionType) {
+    if (moduleState->areFunctionTypesFrozen) {
+        const Uptr *functionTypeIndex = moduleState->functionTypeToIndexMap.get(functionType);
+        if (!functionTypeIndex) {
+            throw NeedsNewFunctionTypeException();
+        }
+        return IndexedFunctionType{*functionTypeIndex};
+    }
+
     // If this type is not in the module's type table yet, add it.
     Uptr &functionTypeIndex = moduleState->functionTypeToIndexMap.getOrAdd(functionType, UINTPTR_MAX);
     if (functionTypeIndex == UINTPTR_MAX) {
@@ -256,14 +264,11 @@ bool WAST::tryParseName(CursorState *cursor, Name &outName) {
 
         wavmAssert(*nextChar == '\"');
         ++nextChar;
-        {
-            std::string quotedNameChars;
-            parseStringChars(nextChar, cursor->parseState, quotedNameChars);
-            cursor->parseState->quotedNameStrings.push_back(std::unique_ptr<std::string>{new std::string(std::move(quotedNameChars))});
-        }
-        const std::unique_ptr<std::string> &quotedName = cursor->parseState->quotedNameStrings.back();
-        wavmAssert(quotedName->size() <= UINT32_MAX);
-        outName = Name(quotedName->data(), U32(quotedName->size()), cursor->nextToken->begin);
+        std::string quotedNameChars;
+        parseStringChars(nextChar, cursor->parseState, quotedNameChars);
+        wavmAssert(quotedNameChars.size() <= UINT32_MAX);
+        const char *quotedName = cursor->parseState->arena.copyChars(quotedNameChars.data(), quotedNameChars.size());
+        outName = Name(quotedName, U32(quotedNameChars.size()), cursor->nextToken->begin);
     } else {
         // Find the first non-name character.
         while (true) {
@@ -10,6 +10,7 @@
 #include "WAVM/IR/Module.h"
 #include "WAVM/IR/Types.h"
 #include "WAVM/IR/Validate.h"
+#include "WAVM/Inline/Arena.h"
 #include "WAVM/Inline/BasicTypes.h"
 #include "WAVM/Inline/Hash.h"
 #include "WAVM/Inline/HashMap.h"
@@ -22,6 +23,11 @@ namespace WAVM {
         struct RecoverParseException {
         };
 
+        // Thrown by getUniqueFunctionTypeIndex if parsing a function body needs a function type that
+        // isn't in the module yet while function bodies are parsed in parallel.
+        struct NeedsNewFunctionTypeException {
+        };
+
         // Like WAST::Error, but only has an offset in the input string instead of a full
         // TextFileLocus.
         struct UnresolvedError {
@@ -37,7 +43,9 @@ namespace WAVM {
             const LineInfo *lineInfo;
             std::vector<UnresolvedError> unresolvedErrors;
 
-            std::vector<std::unique_ptr<std::string>> quotedNameStrings;
+            // Holds the quoted name strings, deferred callbacks and per-function name maps, which are
+            // all freed when the parse is done.
+            Arena arena;
 
             ParseState(const char *inString, const LineInfo *inLineInfo) : string(inString), lineInfo(inLineInfo) {
             }
@@ -137,6 +145,70 @@ namespace WAVM {
             IR::FunctionType explicitType;
         };
 
+        struct ModuleState;
+
+        // A function body whose parsing is deferred until all declarations have been parsed.
+        struct UnparsedFunctionBody {
+            Uptr functionIndex;
+            Uptr functionDefIndex;
+            IR::IndexedFunctionType functionTypeIndex;
+            const Token *firstBodyToken;
+            Uptr numBodyTokens;
+
+            // The names of the function's parameters, which the body's locals are added to.
+            NameToIndexMap *localNameToIndexMap;
+            std::vector<std::string> *localDisassemblyNames;
+        };
+
+        // A list of callbacks, allocated in the parse arena, that are called in the order they were
+        // added. Callbacks may be added to the list while it's being called.
+        struct ModuleCallbackList {
+            ModuleCallbackList(Arena &inArena) : arena(inArena), firstNode(nullptr), lastNodeNext(&firstNode) {
+            }
+
+            template<typename Callback> void add(Callback &&callback) {
+                typedef typename std::decay<Callback>::type CallbackType;
+                CallbackNode<CallbackType> *node = arena.create<CallbackNode<CallbackType>>(std::forward<Callback>(callback));
+                *lastNodeNext = node;
+                lastNodeNext = &node->next;
+            }
+
+            void callAll(ModuleState *moduleState) const {
+                for (Node *node = firstNode; node; node = node->next) {
+                    node->call(node, moduleState);
+                }
+            }
+
+        private:
+            struct Node {
+                Node *next;
+
+                void (*call)(Node *, ModuleState *);
+            };
+
+            template<typename Callback> struct CallbackNode : Node {
+                Callback callback;
+
+                CallbackNode(Callback &&inCallback) : callback(std::move(inCallback)) {
+                    this->next = nullptr;
+                    this->call = [](Node *node, ModuleState *moduleState) {
+                        static_cast<CallbackNode *>(node)->callback(moduleState);
+                    };
+                }
+
+                CallbackNode(const Callback &inCallback) : callback(inCallback) {
+                    this->next = nullptr;
+                    this->call = [](Node *node, ModuleState *moduleState) {
+                        static_cast<CallbackNode *>(node)->callback(moduleState);
+                    };
+                }
+            };
+
+            Arena &arena;
+            Node *firstNode;
+            Node **lastNodeNext;
+        };
+
         // State associated with parsing a module.
         struct ModuleState {
             ParseState *parseState;
@@ -156,12 +228,21 @@ namespace WAVM {
             IR::DeferredCodeValidationState deferredCodeValidationState;
 
             // Thunks that are called after parsing all types.
-            std::vector<std::function<void(ModuleState *)>> postTypeCallbacks;
+            ModuleCallbackList postTypeCallbacks;
 
             // Thunks that are called after parsing all declarations.
-            std::vector<std::function<void(ModuleState *)>> postDeclarationCallbacks;
+            ModuleCallbackList postDeclarationCallbacks;
 
-            ModuleState(ParseState *inParseState, IR::Module &inModule) : parseState(inParseState), module(inModule) {
+            // The function bodies that are parsed after the post-declaration callbacks are called.
+            std::vector<UnparsedFunctionBody> functionBodies;
+
+            // Set while function bodies are parsed in parallel, when no types may be added to the
+            // module.
+            bool areFunctionTypesFrozen = false;
+
+            ModuleState(ParseState *inParseState, IR::Module &inModule)
+                    : parseState(inParseState), module(inModule), postTypeCallbacks(inParseState->arena),
+                      postDeclarationCallbacks(inParseState->arena) {
             }
         };
 
@@ -202,7 +283,9 @@ namespace WAVM {
 
         UnresolvedFunctionType parseFunctionTypeRefAndOrDecl(CursorState *cursor, NameToIndexMap &outLocalNameToIndexMap, std::vector<std::string> &outLocalDisassemblyNames);
 
-        IR::IndexedFunctionType resolveFunctionType(ModuleState *moduleState, const UnresolvedFunctionType &unresolvedType);
+        // Reports errors to parseState instead of the module's ParseState, since the function bodies
+        // that are parsed in parallel each report errors to their thread's ParseState.
+        IR::IndexedFunctionType resolveFunctionType(ParseState *parseState, ModuleState *moduleState, const UnresolvedFunctionType &unresolvedType);
 
         IR::IndexedFunctionType getUniqueFunctionTypeIndex(ModuleState *moduleState, IR::FunctionType functionType);
 
@@ -284,6 +367,9 @@ namespace WAVM {
         // Function parsing.
         IR::FunctionDef parseFunctionDef(CursorState *cursor, const Token *funcToken);
 
+        // Parses the module's function bodies, using multiple threads if there are enough of them.
+        void parseFunctionBodies(ModuleState *moduleState);
+
         // Module parsing.
         void parseModuleBody(CursorState *cursor, IR::Module &outModule);
     }
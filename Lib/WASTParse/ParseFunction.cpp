@@ -4,18 +4,23 @@
 
 #include "Lexer.h"
 #include "Parse.h"
+#include "WAVM/Inline/ParallelFor.h"
 
 using namespace WAVM;
 using namespace WAVM::IR;
 using namespace WAVM::WAST;
 
+// Parsing function bodies on another thread has a fixed cost for starting the thread, so a thread is
+// only used for at least this many tokens of function bodies.
+static constexpr Uptr minParseTokensPerThread = 64 * 1024;
+
 namespace WAVM {
     namespace WAST {
         // State associated with parsing a function.
         struct FunctionState {
             FunctionDef &functionDef;
 
-            std::shared_ptr<NameToIndexMap> localNameToIndexMap;
+            NameToIndexMap *localNameToIndexMap;
             Uptr numLocals;
 
             NameToIndexMap branchTargetNameToIndexMap;
@@ -26,12 +31,12 @@ namespace WAVM {
             OperatorEncoderStream operationEncoder;
             CodeValidationProxyStream<OperatorEncoderStream> validatingCodeStream;
 
-            FunctionState(const std::shared_ptr<NameToIndexMap> &inLocalNameToIndexMap, FunctionDef &inFunctionDef, ModuleState *moduleState)
+            FunctionState(NameToIndexMap *inLocalNameToIndexMap, FunctionDef &inFunctionDef, ModuleState *moduleState, DeferredCodeValidationState &deferredCodeValidationState)
                     : functionDef(inFunctionDef), localNameToIndexMap(inLocalNameToIndexMap), numLocals(
                     inFunctionDef.nonParameterLocalTypes.size() +
                     moduleState->module.types[inFunctionDef.type.index].params().size()), branchTargetDepth(0),
                       operationEncoder(codeByteStream),
-                      validatingCodeStream(moduleState->module, functionDef, operationEncoder, moduleState->deferredCodeValidationState) {
+                      validatingCodeStream(moduleState->module, functionDef, operationEncoder, deferredCodeValidationState) {
             }
         };
     }
@@ -188,7 +193,7 @@ static void parseImm(CursorState *cursor, CallIndirectImm &outImm) {
     std::vector<std::string> paramDisassemblyNames;
     NameToIndexMap paramNameToIndexMap;
     const UnresolvedFunctionType unresolvedFunctionType = parseFunctionTypeRefAndOrDecl(cursor, paramNameToIndexMap, paramDisassemblyNames);
-    outImm.type.index = resolveFunctionType(cursor->moduleState, unresolvedFunctionType).index;
+    outImm.type.index = resolveFunctionType(cursor->parseState, cursor->moduleState, unresolvedFunctionType).index;
 
     // Disallow named parameters.
     if (paramNameToIndexMap.size()) {
@@ -322,7 +327,7 @@ static void parseControlImm(CursorState *cursor, Name &outBranchTargetName, Cont
         } else {
             // If there was a type reference, resolve it. This also verifies that if there were also
             // params and/or results declared inline that they match the resolved type reference.
-            const Uptr referencedFunctionTypeIndex = resolveFunctionType(cursor->moduleState, unresolvedFunctionType).index;
+            const Uptr referencedFunctionTypeIndex = resolveFunctionType(cursor->parseState, cursor->moduleState, unresolvedFunctionType).index;
             if (referencedFunctionTypeIndex != UINTPTR_MAX) {
                 wavmAssert(referencedFunctionTypeIndex < cursor->moduleState->module.types.size());
                 functionType = cursor->moduleState->module.types[referencedFunctionTypeIndex];
@@ -597,73 +602,157 @@ static void parseInstrSequence(CursorState *cursor) {
     };
 }
 
+// Parses a function body's locals and code into its FunctionDef. If the body needs a new function
+// type while the module's function types are frozen, returns false without changing the FunctionDef,
+// the disassembly names, or the errors.
+static bool parseFunctionBody(ModuleState *moduleState, ParseState *parseState, DeferredCodeValidationState &deferredCodeValidationState, const UnparsedFunctionBody &body) {
+    FunctionDef &functionDef = moduleState->module.functions.defs[body.functionDefIndex];
+    FunctionType functionType = body.functionTypeIndex.index == UINTPTR_MAX ? FunctionType() : moduleState->module.types[body.functionTypeIndex.index];
+
+    // Remember what parsing the body adds to, to undo it if the body needs a new function type.
+    const Uptr numParamDisassemblyNames = body.localDisassemblyNames->size();
+    const Uptr numErrors = parseState->unresolvedErrors.size();
+    std::vector<Name> localNames;
+
+    try {
+        // Parse the function's local variables.
+        CursorState functionCursorState(body.firstBodyToken, parseState, moduleState);
+        while (tryParseParenthesizedTagged(&functionCursorState, t_local, [&] {
+            Name localName;
+            if (tryParseName(&functionCursorState, localName)) {
+                bindName(parseState, *body.localNameToIndexMap, localName, functionType.params().size() + functionDef.nonParameterLocalTypes.size());
+                localNames.push_back(localName);
+                body.localDisassemblyNames->push_back(localName.getString());
+                functionDef.nonParameterLocalTypes.push_back(parseValueType(&functionCursorState));
+            } else {
+                while (functionCursorState.nextToken->type != t_rightParenthesis) {
+                    body.localDisassemblyNames->push_back(std::string());
+                    functionDef.nonParameterLocalTypes.push_back(parseValueType(&functionCursorState));
+                };
+            }
+        }));
+
+        // Parse the function's code.
+        FunctionState functionState(body.localNameToIndexMap, functionDef, moduleState, deferredCodeValidationState);
+        functionCursorState.functionState = &functionState;
+        const Token *validationErrorToken = body.firstBodyToken;
+        try {
+            parseInstrSequence(&functionCursorState);
+            if (parseState->unresolvedErrors.size() == numErrors) {
+                validationErrorToken = functionCursorState.nextToken;
+                functionState.validatingCodeStream.end();
+                functionState.validatingCodeStream.finishValidation();
+            }
+        } catch (ValidationException exception) {
+            parseErrorf(parseState, validationErrorToken, "%s", exception.message.c_str());
+        } catch (RecoverParseException) {
+        } catch (FatalParseException) {
+        }
+        functionDef.code = std::move(functionState.codeByteStream.getBytes());
+        moduleState->disassemblyNames.functions[body.functionIndex].locals = std::move(*body.localDisassemblyNames);
+        moduleState->disassemblyNames.functions[body.functionIndex].labels = std::move(functionState.labelDisassemblyNames);
+        return true;
+    } catch (NeedsNewFunctionTypeException) {
+        for (const Name &localName : localNames) {
+            body.localNameToIndexMap->remove(localName);
+        }
+        body.localDisassemblyNames->resize(numParamDisassemblyNames);
+        functionDef.nonParameterLocalTypes.clear();
+        parseState->unresolvedErrors.erase(parseState->unresolvedErrors.begin() + numErrors, parseState->unresolvedErrors.end());
+        return false;
+    }
+}
+
 FunctionDef WAST::parseFunctionDef(CursorState *cursor, const Token *funcToken) {
-    std::shared_ptr<std::vector<std::string>> localDisassemblyNames = std::make_shared<std::vector<std::string>>();
-    std::shared_ptr<NameToIndexMap> localNameToIndexMap = std::make_shared<NameToIndexMap>();
+    // The local names are used by the deferred callbacks, so they're allocated in the parse arena.
+    std::vector<std::string> *localDisassemblyNames = cursor->parseState->arena.create<std::vector<std::string>>();
+    NameToIndexMap *localNameToIndexMap = cursor->parseState->arena.create<NameToIndexMap>();
 
     // Parse the function type, as a reference or explicit declaration.
     const UnresolvedFunctionType unresolvedFunctionType = parseFunctionTypeRefAndOrDecl(cursor, *localNameToIndexMap, *localDisassemblyNames);
 
-    // Defer resolving the function type until all type declarations have been parsed.
+    // Skip the body, and find its tokens.
     const Uptr functionIndex = cursor->moduleState->module.functions.size();
     const Uptr functionDefIndex = cursor->moduleState->module.functions.defs.size();
     const Token *firstBodyToken = cursor->nextToken;
-    cursor->moduleState->postTypeCallbacks.push_back([functionIndex, functionDefIndex, firstBodyToken, localNameToIndexMap, localDisassemblyNames, unresolvedFunctionType](ModuleState *moduleState) {
+    findClosingParenthesis(cursor, funcToken - 1);
+    --cursor->nextToken;
+    const Uptr numBodyTokens = Uptr(cursor->nextToken - firstBodyToken);
+
+    // Defer resolving the function type until all type declarations have been parsed.
+    cursor->moduleState->postTypeCallbacks.add([functionIndex, functionDefIndex, firstBodyToken, numBodyTokens, localNameToIndexMap, localDisassemblyNames, unresolvedFunctionType](ModuleState *moduleState) {
         // Resolve the function type and set it on the FunctionDef.
-        const IndexedFunctionType functionTypeIndex = resolveFunctionType(moduleState, unresolvedFunctionType);
+        const IndexedFunctionType functionTypeIndex = resolveFunctionType(moduleState->parseState, moduleState, unresolvedFunctionType);
         moduleState->module.functions.defs[functionDefIndex].type = functionTypeIndex;
 
-        // Defer parsing the body of the function until all function types have been resolved.
-        moduleState->postDeclarationCallbacks.push_back([functionIndex, functionDefIndex, firstBodyToken, localNameToIndexMap, localDisassemblyNames, functionTypeIndex](ModuleState *moduleState) {
-            FunctionDef &functionDef = moduleState->module.functions.defs[functionDefIndex];
-            FunctionType functionType = functionTypeIndex.index ==
-                                        UINTPTR_MAX ? FunctionType() : moduleState->module.types[functionTypeIndex.index];
-
-            // Parse the function's local variables.
-            CursorState functionCursorState(firstBodyToken, moduleState->parseState, moduleState);
-            while (tryParseParenthesizedTagged(&functionCursorState, t_local, [&] {
-                Name localName;
-                if (tryParseName(&functionCursorState, localName)) {
-                    bindName(moduleState->parseState, *localNameToIndexMap, localName,
-                             functionType.params().size() + functionDef.nonParameterLocalTypes.size());
-                    localDisassemblyNames->push_back(localName.getString());
-                    functionDef.nonParameterLocalTypes.push_back(parseValueType(&functionCursorState));
-                } else {
-                    while (functionCursorState.nextToken->type != t_rightParenthesis) {
-                        localDisassemblyNames->push_back(std::string());
-                        functionDef.nonParameterLocalTypes.push_back(parseValueType(&functionCursorState));
-                    };
-                }
-            }));
-            moduleState->disassemblyNames.functions[functionIndex].locals = std::move(*localDisassemblyNames);
-
-            // Parse the function's code.
-            FunctionState functionState(localNameToIndexMap, functionDef, moduleState);
-            functionCursorState.functionState = &functionState;
-            const Token *validationErrorToken = firstBodyToken;
-            try {
-                parseInstrSequence(&functionCursorState);
-                if (!moduleState->parseState->unresolvedErrors.size()) {
-                    validationErrorToken = functionCursorState.nextToken;
-                    functionState.validatingCodeStream.end();
-                    functionState.validatingCodeStream.finishValidation();
-                }
-            } catch (ValidationException exception) {
-                parseErrorf(moduleState->parseState, validationErrorToken, "%s", exception.message.c_str());
-            } catch (RecoverParseException) {
-            } catch (FatalParseException) {
-            }
-            functionDef.code = std::move(functionState.codeByteStream.getBytes());
-            moduleState->disassemblyNames.functions[functionIndex].labels = std::move(functionState.labelDisassemblyNames);
-        });
+        // Defer parsing the body of the function until all declarations have been parsed.
+        moduleState->functionBodies.push_back({functionIndex, functionDefIndex, functionTypeIndex, firstBodyToken, numBodyTokens, localNameToIndexMap, localDisassemblyNames});
     });
 
-    // Continue parsing after the closing parenthesis.
-    findClosingParenthesis(cursor, funcToken - 1);
-    --cursor->nextToken;
-
     return {{UINTPTR_MAX},
             {},
             {},
             {}};
 }
+
+void WAST::parseFunctionBodies(ModuleState *moduleState) {
+    const std::vector<UnparsedFunctionBody> &bodies = moduleState->functionBodies;
+    Uptr numBodyTokens = 0;
+    for (const UnparsedFunctionBody &body : bodies) {
+        numBodyTokens += body.numBodyTokens;
+    }
+
+    const Uptr numThreads = getNumParallelThreads(numBodyTokens, minParseTokensPerThread);
+    if (numThreads <= 1) {
+        for (const UnparsedFunctionBody &body : bodies) {
+            errorUnless(parseFunctionBody(moduleState, moduleState->parseState, moduleState->deferredCodeValidationState, body));
+        }
+        return;
+    }
+
+    // Parse the bodies in parallel, each thread with its own ParseState and deferred validation
+    // state. The module's types can't be added to while the bodies are parsed, so the bodies that
+    // need a new function type are parsed afterward.
+    struct ThreadState {
+        ParseState parseState;
+        DeferredCodeValidationState deferredCodeValidationState;
+
+        ThreadState(const ParseState *moduleParseState) : parseState(moduleParseState->string, moduleParseState->lineInfo) {
+        }
+    };
+    std::vector<std::unique_ptr<ThreadState>> threadStates;
+    for (Uptr threadIndex = 0; threadIndex < numThreads; ++threadIndex) {
+        threadStates.emplace_back(new ThreadState(moduleState->parseState));
+    }
+
+    std::vector<std::vector<UnresolvedError>> bodyErrors(bodies.size());
+    std::vector<U8> isBodyDeferred(bodies.size(), 0);
+    moduleState->areFunctionTypesFrozen = true;
+    parallelFor(bodies.size(), numThreads, [&](Uptr threadIndex, Uptr bodyIndex) {
+        ThreadState &threadState = *threadStates[threadIndex];
+        if (parseFunctionBody(moduleState, &threadState.parseState, threadState.deferredCodeValidationState, bodies[bodyIndex])) {
+            bodyErrors[bodyIndex] = std::move(threadState.parseState.unresolvedErrors);
+            threadState.parseState.unresolvedErrors.clear();
+        } else {
+            isBodyDeferred[bodyIndex] = 1;
+        }
+    });
+    moduleState->areFunctionTypesFrozen = false;
+
+    for (const std::unique_ptr<ThreadState> &threadState : threadStates) {
+        mergeDeferredCodeValidationState(moduleState->deferredCodeValidationState, threadState->deferredCodeValidationState);
+    }
+
+    // Parse the deferred bodies, and add the errors of all the bodies in the order they'd be added
+    // by parsing the bodies serially.
+    ParseState *parseState = moduleState->parseState;
+    for (Uptr bodyIndex = 0; bodyIndex < bodies.size(); ++bodyIndex) {
+        if (isBodyDeferred[bodyIndex]) {
+            errorUnless(parseFunctionBody(moduleState, parseState, moduleState->deferredCodeValidationState, bodies[bodyIndex]));
+        } else {
+            for (UnresolvedError &error : bodyErrors[bodyIndex]) {
+                parseState->unresolvedErrors.push_back(std::move(error));
+            }
+        }
+    }
+}
@@ -206,8 +206,8 @@ static void parseImport(CursorState *cursor) {
                 cursor->moduleState->disassemblyNames.functions.back().locals = localDissassemblyNames;
 
                 // Resolve the function import type after all type declarations have been parsed.
-                cursor->moduleState->postTypeCallbacks.push_back([unresolvedFunctionType, importIndex](ModuleState *moduleState) {
-                    moduleState->module.functions.imports[importIndex].type = resolveFunctionType(moduleState, unresolvedFunctionType);
+                cursor->moduleState->postTypeCallbacks.add([unresolvedFunctionType, importIndex](ModuleState *moduleState) {
+                    moduleState->module.functions.imports[importIndex].type = resolveFunctionType(moduleState->parseState, moduleState, unresolvedFunctionType);
                 });
                 break;
             }
@@ -265,6 +265,7 @@ static void parseExport(CursorState *cursor) {
                 break;
             default:
                 parseErrorf(cursor->parseState, cursor->nextToken, "invalid export kind");
+                throw RecoverParseException();
         };
         ++cursor->nextToken;
 
@@ -277,7 +278,7 @@ static void parseExport(CursorState *cursor) {
         const Uptr exportIndex = cursor->moduleState->module.exports.size();
         cursor->moduleState->module.exports.push_back({std::move(exportName), exportKind, 0});
 
-        cursor->moduleState->postDeclarationCallbacks.push_back([=](ModuleState *moduleState) {
+        cursor->moduleState->postDeclarationCallbacks.add([=](ModuleState *moduleState) {
             Uptr &exportedObjectIndex = moduleState->module.exports[exportIndex].index;
             switch (exportKind) {
                 case ExternKind::function:
@@ -363,7 +364,7 @@ static void parseData(CursorState *cursor) {
     // Enqueue a callback that is called after all declarations are parsed to resolve the memory to
     // put the data segment in, and the base offset.
     if (isActive) {
-        cursor->moduleState->postDeclarationCallbacks.push_back([=](ModuleState *moduleState) {
+        cursor->moduleState->postDeclarationCallbacks.add([=](ModuleState *moduleState) {
             if (!moduleState->module.memories.size()) {
                 parseErrorf(moduleState->parseState, firstToken, "data segments aren't allowed in modules without any memory declarations");
             } else {
@@ -376,9 +377,9 @@ static void parseData(CursorState *cursor) {
 }
 
 static Uptr parseElemSegmentBody(CursorState *cursor, bool isActive, Reference tableRef, UnresolvedInitializerExpression baseIndex, const Token *elemToken) {
-    // Allocate the elementReferences array on the heap so it doesn't need to be copied for the
-    // post-declaration callback.
-    std::shared_ptr<std::vector<Reference>> elementReferences = std::make_shared<std::vector<Reference>>();
+    // Allocate the elementReferences array in the parse arena so it doesn't need to be copied for
+    // the post-declaration callback.
+    std::vector<Reference> *elementReferences = cursor->parseState->arena.create<std::vector<Reference>>();
 
     Reference elementRef;
     while (tryParseNameOrIndexRef(cursor, elementRef)) {
@@ -391,7 +392,7 @@ static Uptr parseElemSegmentBody(CursorState *cursor, bool isActive, Reference t
 
     // Enqueue a callback that is called after all declarations are parsed to resolve the table
     // elements' references.
-    cursor->moduleState->postDeclarationCallbacks.push_back([isActive, tableRef, elemSegmentIndex, elementReferences, elemToken, baseIndex](ModuleState *moduleState) {
+    cursor->moduleState->postDeclarationCallbacks.add([isActive, tableRef, elemSegmentIndex, elementReferences, elemToken, baseIndex](ModuleState *moduleState) {
         ElemSegment &elemSegment = moduleState->module.elemSegments[elemSegmentIndex];
 
         if (isActive) {
@@ -487,8 +488,8 @@ static void parseFunc(CursorState *cursor) {
 
         // Resolve the function import type after all type declarations have been parsed.
         const Uptr importIndex = cursor->moduleState->module.functions.imports.size();
-        cursor->moduleState->postTypeCallbacks.push_back([unresolvedFunctionType, importIndex](ModuleState *moduleState) {
-            moduleState->module.functions.imports[importIndex].type = resolveFunctionType(moduleState, unresolvedFunctionType);
+        cursor->moduleState->postTypeCallbacks.add([unresolvedFunctionType, importIndex](ModuleState *moduleState) {
+            moduleState->module.functions.imports[importIndex].type = resolveFunctionType(moduleState->parseState, moduleState, unresolvedFunctionType);
         });
         return IndexedFunctionType{UINTPTR_MAX};
     }, parseFunctionDef);
@@ -600,7 +601,7 @@ static void parseStart(CursorState *cursor) {
         parseErrorf(cursor->parseState, cursor->nextToken, "expected function name or index");
     }
 
-    cursor->moduleState->postDeclarationCallbacks.push_back([functionRef](ModuleState *moduleState) {
+    cursor->moduleState->postDeclarationCallbacks.add([functionRef](ModuleState *moduleState) {
         moduleState->module.startFunctionIndex = resolveRef(moduleState->parseState, moduleState->functionNameToIndexMap, moduleState->module.functions.size(), functionRef);
     });
 }
@@ -661,16 +662,13 @@ void WAST::parseModuleBody(CursorState *cursor, IR::Module &outModule) {
 
         // Process the callbacks requested after all type declarations have been parsed.
         if (!cursor->parseState->unresolvedErrors.size()) {
-            for (const auto &callback : cursor->moduleState->postTypeCallbacks) {
-                callback(&moduleState);
-            }
+            cursor->moduleState->postTypeCallbacks.callAll(&moduleState);
         }
 
         // Process the callbacks requested after all declarations have been parsed.
         if (!cursor->parseState->unresolvedErrors.size()) {
-            for (const auto &callback : cursor->moduleState->postDeclarationCallbacks) {
-                callback(&moduleState);
-            }
+            cursor->moduleState->postDeclarationCallbacks.callAll(&moduleState);
+            parseFunctionBodies(&moduleState);
         }
 
         // Validate the module's definitions (excluding function code, which is validated as it is
@@ -698,6 +696,10 @@ void WAST::parseModuleBody(CursorState *cursor, IR::Module &outModule) {
 }
 
 bool WAST::parseModule(const char *string, Uptr stringLength, IR::Module &outModule) {
+    if (!stringLength || string[stringLength - 1] != 0) {
+        const std::string terminatedString(string, stringLength);
+        return parseModule(terminatedString.c_str(), stringLength + 1, outModule);
+    }
 
     // Lex the string.
     LineInfo *lineInfo = nullptr;
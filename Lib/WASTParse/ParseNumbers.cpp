@@ -3,7 +3,10 @@
 
 #include "Lexer.h"
 #include "Parse.h"
+#include "PowersOfFive.h"
 #include "WAVM/Inline/FloatComponents.h"
+#include "WAVM/Platform/Intrinsic.h"
+#include "WAVM/Platform/Mutex.h"
 
 // Include the David Gay's dtoa code.
 // #define strtod and dtoa to avoid conflicting with the C standard library versions
@@ -15,6 +18,13 @@
 #define strtod parseNonSpecialF64
 #define dtoa printNonSpecialF64
 
+// Function bodies may be parsed on multiple threads, so lock dtoa's shared Bigint free lists and
+// cached powers of 5.
+static WAVM::Platform::SpinMutex dtoaLocks[2];
+#define MULTIPLE_THREADS
+#define ACQUIRE_DTOA_LOCK(n) dtoaLocks[n].lock()
+#define FREE_DTOA_LOCK(n) dtoaLocks[n].unlock()
+
 #ifdef _MSC_VER
 #pragma warning(push)
 #pragma warning(disable : 4244 4083 4706 4701 4703 4018)
@@ -43,6 +53,9 @@
 #undef NO_INFNAN_CHECK
 #undef strtod
 #undef dtoa
+#undef MULTIPLE_THREADS
+#undef ACQUIRE_DTOA_LOCK
+#undef FREE_DTOA_LOCK
 
 using namespace WAVM;
 using namespace WAVM::WAST;
@@ -190,9 +203,279 @@ template<typename DestFloat> static F64 getMaxCastableF64() {
     return f64Components.value;
 }
 
-// Parses a floating point literal, advancing nextChar past the parsed characters. Assumes it will
-// only be called for input that's already been accepted by the lexer as a float literal.
-template<typename Float> Float parseFloat(const char *&nextChar, ParseState *parseState) {
+// The exponents parsed by the fast paths saturate at this magnitude, which is far beyond the
+// exponent of any finite non-zero F64.
+static constexpr I64 maxParsedExponent = 100000;
+
+// Parses the decimal digits of an exponent, skipping underscores, and advancing nextChar past them.
+static I64 parseExponentDigits(const char *&nextChar) {
+    I64 exponent = 0;
+    while ((*nextChar >= '0' && *nextChar <= '9') || *nextChar == '_') {
+        if (*nextChar != '_' && exponent < maxParsedExponent) {
+            exponent = exponent * 10 + (*nextChar - '0');
+        }
+        ++nextChar;
+    }
+    return exponent;
+}
+
+// Returns the F64 with the given sign, biased exponent, and significand bits.
+static F64 makeF64(bool isNegative, U64 biasedExponent, U64 significand) {
+    FloatComponents<F64> components;
+    components.bits.sign = isNegative ? 1 : 0;
+    components.bits.exponent = biasedExponent;
+    components.bits.significand = significand;
+    return components.value;
+}
+
+// Tries to compute the F64 nearest to w * 10^q with the Eisel-Lemire algorithm, using the 128-bit
+// approximations of the powers of five in PowersOfFive.h. Returns false in the rare cases where the
+// approximation can't determine the correctly rounded result, so the caller must fall back to
+// strtod.
+static bool tryEiselLemire(U64 w, I64 q, bool isNegative, F64 &outF64) {
+    wavmAssert(w != 0);
+    if (q < minPowerOfFiveExponent) {
+        outF64 = makeF64(isNegative, 0, 0);
+        return true;
+    } else if (q > maxPowerOfFiveExponent) {
+        outF64 = makeF64(isNegative, 0x7ff, 0);
+        return true;
+    }
+
+    // Normalize w so its most significant bit is set, and multiply it by the normalized 5^q. Only
+    // the top 55 bits of the product are needed to round to the 53 bits of an F64 significand, so
+    // the low half of the power of five is only used if the bits just below those might carry
+    // into them.
+    const int numLeadingZeroes = int(Platform::countLeadingZeroes(w));
+    w <<= numLeadingZeroes;
+    const U64 *powerOfFive = powersOfFive[q - minPowerOfFiveExponent];
+    unsigned __int128 product = (unsigned __int128)w * powerOfFive[0];
+    U64 productHigh = U64(product >> 64);
+    U64 productLow = U64(product);
+    const U64 precisionMask = ~U64(0) >> 55;
+    if ((productHigh & precisionMask) == precisionMask) {
+        const U64 secondProductHigh = U64(((unsigned __int128)w * powerOfFive[1]) >> 64);
+        productLow += secondProductHigh;
+        if (secondProductHigh > productLow) {
+            ++productHigh;
+        }
+
+        // If the truncated product is still ambiguous, it's only known to be exact for a small
+        // range of exponents.
+        if (productLow == ~U64(0) && (q < -27 || q > 55)) {
+            return false;
+        }
+    }
+
+    // Take the top 54 bits of the product as the significand and a rounding bit, and compute the
+    // biased binary exponent from floor(log2(10^q)) = floor(q * log2(10)).
+    const int upperBit = int(productHigh >> 63);
+    U64 significand = productHigh >> (upperBit + 9);
+    I64 biasedExponent = (((152170 + 65536) * q) >> 16) + 63 + upperBit - numLeadingZeroes + 1023;
+
+    if (biasedExponent <= 0) {
+        // The result is subnormal: shift the significand right so its exponent is the minimum
+        // exponent, and round it to nearest.
+        if (-biasedExponent + 1 >= 64) {
+            outF64 = makeF64(isNegative, 0, 0);
+            return true;
+        }
+        significand >>= -biasedExponent + 1;
+        significand += significand & 1;
+        significand >>= 1;
+
+        // Rounding may carry into the implicit bit, which makes the result the smallest normal F64.
+        biasedExponent = significand < (U64(1) << 52) ? 0 : 1;
+        outF64 = makeF64(isNegative, U64(biasedExponent), significand & ((U64(1) << 52) - 1));
+        return true;
+    }
+
+    // If the product is exactly halfway between two F64s, round to the even one. This can only
+    // happen for small exponents, where 5^q is exactly representable in the table.
+    if (productLow <= 1 && q >= -4 && q <= 23 && (significand & 3) == 1 && (significand << (upperBit + 9)) == productHigh) {
+        significand &= ~U64(1);
+    }
+
+    // Round to nearest, and renormalize if the rounding carried out of the significand.
+    significand += significand & 1;
+    significand >>= 1;
+    if (significand >= (U64(2) << 52)) {
+        significand = U64(1) << 52;
+        ++biasedExponent;
+    }
+
+    if (biasedExponent >= 0x7ff) {
+        outF64 = makeF64(isNegative, 0x7ff, 0);
+    } else {
+        outF64 = makeF64(isNegative, U64(biasedExponent), significand & ((U64(1) << 52) - 1));
+    }
+    return true;
+}
+
+// Tries to parse a decimal float literal without calling strtod, advancing nextChar past the parsed
+// characters. Literals with up to 19 significant digits are converted exactly by Clinger's fast
+// path or the Eisel-Lemire algorithm. Returns false for other literals, or if the Eisel-Lemire
+// algorithm can't determine the correctly rounded result.
+static bool tryParseDecimalF64(const char *&nextChar, F64 &outF64) {
+    static constexpr Uptr maxSignificantDigits = 19;
+
+    const char *c = nextChar;
+    const bool isNegative = parseSign(c);
+
+    // Accumulate the significant digits into w, skipping any leading zeroes, and count the
+    // fractional digits in the decimal exponent.
+    U64 w = 0;
+    Uptr numSignificantDigits = 0;
+    I64 exponent = 0;
+    bool isFraction = false;
+    while (true) {
+        if (*c == '_') {
+            ++c;
+            continue;
+        } else if (*c == '.' && !isFraction) {
+            isFraction = true;
+            ++c;
+            continue;
+        } else if (*c < '0' || *c > '9') {
+            break;
+        }
+
+        const U8 digit = U8(*c - '0');
+        ++c;
+        if (isFraction) {
+            --exponent;
+        }
+        if (w == 0 && digit == 0) {
+            continue;
+        }
+        if (numSignificantDigits == maxSignificantDigits) {
+            return false;
+        }
+        w = w * 10 + digit;
+        ++numSignificantDigits;
+    }
+
+    if (*c == 'e' || *c == 'E') {
+        ++c;
+        const bool isExponentNegative = parseSign(c);
+        const I64 explicitExponent = parseExponentDigits(c);
+        exponent += isExponentNegative ? -explicitExponent : explicitExponent;
+    }
+
+    if (w == 0) {
+        outF64 = makeF64(isNegative, 0, 0);
+    } else if (w <= (U64(1) << 53) && exponent >= -22 && exponent <= 22) {
+        // Clinger's fast path: w and 10^|exponent| are both exactly representable as F64s, so a
+        // single correctly rounded multiply or divide gives the correctly rounded result.
+        static const F64 exactPowersOfTen[23] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                                 1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                                 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+        F64 value = F64(w);
+        if (exponent >= 0) {
+            value *= exactPowersOfTen[exponent];
+        } else {
+            value /= exactPowersOfTen[-exponent];
+        }
+        outF64 = isNegative ? -value : value;
+    } else if (!tryEiselLemire(w, exponent, isNegative, outF64)) {
+        return false;
+    }
+
+    nextChar = c;
+    return true;
+}
+
+// Parses a hexadecimal float literal without calling strtod, advancing nextChar past the parsed
+// characters. The hexits are exactly a binary significand, so the literal is converted by keeping
+// the 64 most significant bits of the significand and a sticky bit for any non-zero bits below
+// them, and rounding that to the nearest F64.
+static F64 parseHexF64(const char *&nextChar) {
+    const bool isNegative = parseSign(nextChar);
+    wavmAssert(nextChar[0] == '0' && (nextChar[1] == 'x' || nextChar[1] == 'X'));
+    nextChar += 2;
+
+    U64 significand = 0;
+    bool isSticky = false;
+    I64 exponent = 0;
+    bool isFraction = false;
+    U8 hexit = 0;
+    while (true) {
+        if (*nextChar == '_') {
+            ++nextChar;
+            continue;
+        } else if (*nextChar == '.' && !isFraction) {
+            isFraction = true;
+            ++nextChar;
+            continue;
+        } else if (!tryParseHexit(nextChar, hexit)) {
+            break;
+        }
+
+        if (significand >> 60 == 0) {
+            significand = (significand << 4) | hexit;
+            if (isFraction) {
+                exponent -= 4;
+            }
+        } else {
+            isSticky |= hexit != 0;
+            if (!isFraction) {
+                exponent += 4;
+            }
+        }
+    }
+
+    if (*nextChar == 'p' || *nextChar == 'P') {
+        ++nextChar;
+        const bool isExponentNegative = parseSign(nextChar);
+        const I64 explicitExponent = parseExponentDigits(nextChar);
+        exponent += isExponentNegative ? -explicitExponent : explicitExponent;
+    }
+
+    if (significand == 0) {
+        return makeF64(isNegative, 0, 0);
+    }
+
+    // Normalize the significand so its most significant bit is set, and compute the unbiased
+    // exponent of that bit.
+    const int numLeadingZeroes = int(Platform::countLeadingZeroes(significand));
+    significand <<= numLeadingZeroes;
+    const I64 unbiasedExponent = exponent - numLeadingZeroes + 63;
+    if (unbiasedExponent > 1023) {
+        return makeF64(isNegative, 0x7ff, 0);
+    }
+
+    // Shift the significand right to leave 53 bits, or fewer for a subnormal, and round the
+    // shifted out bits to nearest, ties to even.
+    const I64 numShiftedBits = 11 + (unbiasedExponent < -1022 ? -1022 - unbiasedExponent : 0);
+    if (numShiftedBits > 64) {
+        return makeF64(isNegative, 0, 0);
+    }
+    const U64 halfwayBits = U64(1) << (numShiftedBits - 1);
+    const U64 shiftedBits = numShiftedBits == 64 ? significand : significand & ((halfwayBits << 1) - 1);
+    U64 roundedSignificand = numShiftedBits == 64 ? 0 : significand >> numShiftedBits;
+    if (shiftedBits > halfwayBits || (shiftedBits == halfwayBits && (isSticky || (roundedSignificand & 1)))) {
+        ++roundedSignificand;
+    }
+
+    if (unbiasedExponent < -1022) {
+        // A subnormal that rounds up to 2^52 correctly becomes the smallest normal F64.
+        return makeF64(isNegative, roundedSignificand >> 52, roundedSignificand & ((U64(1) << 52) - 1));
+    }
+
+    I64 biasedExponent = unbiasedExponent + 1023;
+    if (roundedSignificand == (U64(1) << 53)) {
+        roundedSignificand >>= 1;
+        ++biasedExponent;
+    }
+    if (biasedExponent >= 0x7ff) {
+        return makeF64(isNegative, 0x7ff, 0);
+    }
+    return makeF64(isNegative, U64(biasedExponent), roundedSignificand & ((U64(1) << 52) - 1));
+}
+
+// Parses a floating point literal with David Gay's strtod, advancing nextChar past the parsed
+// characters. This is the correctly rounded slow path for literals the fast paths can't convert.
+static F64 parseF64WithStrtod(const char *&nextChar) {
     // Scan the token's characters for underscores, and make a copy of it without the underscores
     // for strtod.
     const char *firstChar = nextChar;
@@ -235,6 +518,22 @@ template<typename Float> Float parseFloat(const char *&nextChar, ParseState *par
     if (endChar == noUnderscoreFirstChar) {
         Errors::fatalf("strtod failed to parse number accepted by lexer");
     }
+    return f64;
+}
+
+// Parses a floating point literal, advancing nextChar past the parsed characters. Assumes it will
+// only be called for input that's already been accepted by the lexer as a float literal. F32
+// literals are parsed as an F64 that is then rounded to F32.
+template<typename Float> Float parseFloat(const char *&nextChar, ParseState *parseState) {
+    const char *firstChar = nextChar;
+    const char *afterSign = firstChar + (*firstChar == '-' || *firstChar == '+' ? 1 : 0);
+
+    F64 f64;
+    if (afterSign[0] == '0' && (afterSign[1] == 'x' || afterSign[1] == 'X')) {
+        f64 = parseHexF64(nextChar);
+    } else if (!tryParseDecimalF64(nextChar, f64)) {
+        f64 = parseF64WithStrtod(nextChar);
+    }
 
     const F64 maxCastableF64 = getMaxCastableF64<Float>();
     if (f64 < -maxCastableF64 || f64 > maxCastableF64) {
@@ -1,18 +1,29 @@
 #include <inttypes.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <string>
 #include <utility>
 #include <vector>
 #include <iostream>
 #include <fcntl.h>
+#include <sys/resource.h>
 #include <zconf.h>
+#include <algorithm>
 
 #include "WAVM/Emscripten/Emscripten.h"
 #include "WAVM/IR/Module.h"
 #include "WAVM/IR/Operators.h"
 #include "WAVM/IR/Validate.h"
 #include "WAVM/Inline/HashMap.h"
+#include "WAVM/Inline/Serialization.h"
+#include "WAVM/LLVMJIT/LLVMJIT.h"
+#include "WAVM/Platform/Clock.h"
+#include "WAVM/Platform/Memory.h"
 #include "WAVM/Runtime/Linker.h"
+#include "WAVM/Runtime/Profiler.h"
+#include "WAVM/Runtime/RuntimeData.h"
+#include "WAVM/WASMParse/WASMParse.h"
 #include "WAVM/WASTParse/WASTParse.h"
 
 using namespace WAVM;
@@ -49,28 +60,8 @@ struct RootResolver : Resolver {
         // If the import couldn't be resolved, stub it in.
         switch (type.kind) {
             case IR::ExternKind::function: {
-                // Generate a function body that just uses the unreachable op to fault if called.
-                Serialization::ArrayOutputStream codeStream;
-                OperatorEncoderStream encoder(codeStream);
-                encoder.unreachable();
-                encoder.end();
-
-                // Generate a module for the stub function.
-                IR::Module stubIRModule;
-                DisassemblyNames stubModuleNames;
-                stubIRModule.types.push_back(asFunctionType(type));
-                stubIRModule.functions.defs.push_back({{0}, {}, std::move(codeStream.getBytes()), {}});
-                stubIRModule.exports.push_back({"importStub", IR::ExternKind::function, 0});
-                stubModuleNames.functions.push_back({"importStub: " + exportName, {}, {}});
-                IR::setDisassemblyNames(stubIRModule, stubModuleNames);
-                IR::validatePreCodeSections(stubIRModule);
-                DeferredCodeValidationState deferredCodeValidationState;
-                IR::validatePostCodeSections(stubIRModule, deferredCodeValidationState);
-
-                // Instantiate the module and return the stub function instance.
-                auto stubModule = compileModule(stubIRModule);
-                auto stubModuleInstance = instantiateModule(compartment, stubModule, {}, "importStub");
-                return getInstanceExport(stubModuleInstance, "importStub");
+                // Use a function that faults like the unreachable op if called.
+                return asObject(Runtime::getUnreachableStub(asFunctionType(type)));
             }
             case IR::ExternKind::memory: {
                 return asObject(Runtime::createMemory(compartment, asMemoryType(type), std::string(exportName)));
@@ -87,9 +78,20 @@ struct RootResolver : Resolver {
     }
 };
 
+// Whether the program file should be parsed and compiled as it is read.
+static bool useStreamingCompile = false;
+
+// The file to write the number of calls to each of the program's functions to when it exits, which
+// --layout-profile reads to lay out the program's code.
+static const char *layoutProfileOutputFilename = nullptr;
+
+// The file to write the program's execution profile to when it exits, which --pgo-profile reads to
+// optimize the program's code.
+static const char *pgoProfileOutputFilename = nullptr;
+
 inline bool readFile(const char *filename, std::vector<U8> &outFileContents) {
     I32 file = open(std::string(filename).c_str(), O_RDONLY, 0);
-    if (!file) {
+    if (file == -1) {
         std::cout << "Couldn't open file: " << filename;
         return false;
     }
@@ -97,28 +99,356 @@ inline bool readFile(const char *filename, std::vector<U8> &outFileContents) {
     U64 numFileBytes64 = U64(lseek64(file, 0, SEEK_END));
     const Uptr numFileBytes = Uptr(numFileBytes64);
 
-    std::vector<U8> fileContents;
     outFileContents.resize(numFileBytes);
     lseek64(file, 0, SEEK_SET);
 
-    read(file, outFileContents.data(), numFileBytes);
+    // read may return fewer bytes than were requested, so keep reading until the whole file is read.
+    Uptr numReadBytes = 0;
+    while (numReadBytes < numFileBytes) {
+        const ssize_t result = read(file, outFileContents.data() + numReadBytes, numFileBytes - numReadBytes);
+        if (result <= 0) {
+            std::cout << "Couldn't read file: " << filename;
+            close(file);
+            return false;
+        }
+        numReadBytes += Uptr(result);
+    }
     close(file);
     return true;
 }
 
-static int run(const char *filename, char **args) {
-    std::vector<U8> fileBytes;
-    if (!readFile(filename, fileBytes)) {
+// The contents of a module file, mapped read-only instead of copied. The modules loaded from the
+// file refer to its bytes, and keep the mapping alive through backingBuffer.
+struct ModuleFileBytes {
+    const U8 *data = nullptr;
+    Uptr numBytes = 0;
+    std::shared_ptr<const void> backingBuffer;
+};
+
+static bool mapModuleFile(const char *filename, ModuleFileBytes &outFileBytes) {
+    Platform::MappedFile *mappedFile = Platform::mapFile(filename);
+    if (!mappedFile) {
+        std::cout << "Couldn't open file: " << filename;
+        return false;
+    }
+    outFileBytes.data = Platform::getMappedFileBytes(mappedFile);
+    outFileBytes.numBytes = Platform::getMappedFileNumBytes(mappedFile);
+    outFileBytes.backingBuffer = std::shared_ptr<const void>(mappedFile, &Platform::unmapFile);
+    return true;
+}
+
+inline bool writeFile(const char *filename, const std::vector<U8> &fileContents) {
+    FILE *file = fopen(filename, "wb");
+    if (!file) {
+        std::cout << "Couldn't open file: " << filename;
         return false;
     }
-    fileBytes.push_back(0);
+
+    const bool succeeded = fwrite(fileContents.data(), 1, fileContents.size(), file) == fileContents.size();
+    fclose(file);
+    return succeeded;
+}
+
+// Loads a module from a file in the WebAssembly binary format, reading the file in chunks and
+// compiling its function definitions in the background as soon as they are decoded.
+static Runtime::ModuleRef loadStreamingModule(const char *filename, const LLVMJIT::CompileOptions &compileOptions) {
+    FILE *file = fopen(filename, "rb");
+    if (!file) {
+        std::cout << "Couldn't open file: " << filename;
+        return nullptr;
+    }
+
+    IR::Module irModule;
+    Runtime::StreamingCompile *streamingCompile = Runtime::beginStreamingCompile(irModule, compileOptions);
+    WASM::StreamingModuleParser *parser = WASM::createStreamingModuleParser(irModule, [streamingCompile](Uptr functionDefIndex) {
+        Runtime::addStreamingCompileFunctionDef(streamingCompile, functionDefIndex);
+    });
+
+    std::string errorMessage;
+    bool succeeded = true;
+    std::vector<U8> chunk(64 * 1024);
+    while (succeeded) {
+        const Uptr numChunkBytes = fread(chunk.data(), 1, chunk.size(), file);
+        if (!numChunkBytes) {
+            break;
+        }
+        succeeded = WASM::addStreamingModuleBytes(parser, chunk.data(), numChunkBytes, &errorMessage);
+    };
+    if (succeeded && ferror(file)) {
+        errorMessage = "couldn't read file";
+        succeeded = false;
+    }
+    succeeded = succeeded && WASM::finishStreamingModuleParser(parser, &errorMessage);
+    WASM::destroyStreamingModuleParser(parser);
+    fclose(file);
+
+    if (!succeeded) {
+        Runtime::abortStreamingCompile(streamingCompile);
+        std::cout << "Error parsing WebAssembly binary file: " << errorMessage << std::endl;
+        return nullptr;
+    }
+    return Runtime::finishStreamingCompile(streamingCompile, std::move(irModule));
+}
+
+// Parses a module from the contents of a file containing WebAssembly text or the WebAssembly binary
+// format. A binary module refers to the file's bytes instead of copying them.
+static bool parseModuleFile(const ModuleFileBytes &fileBytes, IR::Module &outModule) {
+    if (WASM::isBinaryModule(fileBytes.data, fileBytes.numBytes)) {
+        std::string errorMessage;
+        outModule.backingBuffer = fileBytes.backingBuffer;
+        if (!WASM::parseModule(fileBytes.data, fileBytes.numBytes, outModule, &errorMessage)) {
+            std::cout << "Error parsing WebAssembly binary file: " << errorMessage << std::endl;
+            return false;
+        }
+    } else {
+        // The mapping is followed by a zero byte, which terminates the text for the lexer without
+        // copying it.
+        if (!WAST::parseModule((const char *) fileBytes.data, fileBytes.numBytes + 1, outModule)) {
+            std::cout << "Error parsing WebAssembly text file";
+            return false;
+        }
+    }
+    return true;
+}
+
+// Loads a module from a file containing WebAssembly text, the WebAssembly binary format, or a module
+// precompiled by saveCompiledModule.
+static Runtime::ModuleRef loadModule(const char *filename, const LLVMJIT::CompileOptions &compileOptions) {
+    if (useStreamingCompile) {
+        return loadStreamingModule(filename, compileOptions);
+    }
+
+    // The modules loaded from the file refer to its bytes instead of copying them.
+    ModuleFileBytes fileBytes;
+    if (!mapModuleFile(filename, fileBytes)) {
+        return nullptr;
+    }
+
+    if (Runtime::isPrecompiledModule(fileBytes.data, fileBytes.numBytes)) {
+        try {
+            return Runtime::loadPrecompiledModule(fileBytes.data, fileBytes.numBytes, fileBytes.backingBuffer);
+        } catch (const Serialization::FatalSerializationException &exception) {
+            std::cout << "Error loading precompiled module: " << exception.message << std::endl;
+            return nullptr;
+        }
+    }
 
     IR::Module irModule;
-    if (!WAST::parseModule((const char *) fileBytes.data(), fileBytes.size(), irModule)) {
-        std::cout << "Error parsing WebAssembly text file";
+    if (!parseModuleFile(fileBytes, irModule)) {
+        return nullptr;
+    }
+    if (compileOptions.functionDefCallCounts.size() &&
+        compileOptions.functionDefCallCounts.size() != irModule.functions.defs.size()) {
+        std::cout << "The layout profile has " << compileOptions.functionDefCallCounts.size() << " functions, but the program has "
+                  << irModule.functions.defs.size() << std::endl;
+        return nullptr;
+    }
+    if (compileOptions.profile && compileOptions.profile->functionDefs.size() != irModule.functions.defs.size()) {
+        std::cout << "The profile has " << compileOptions.profile->functionDefs.size() << " functions, but the program has "
+                  << irModule.functions.defs.size() << std::endl;
+        return nullptr;
+    }
+
+    // Write a perf map of the compiled functions if requested by the environment.
+    if (getenv("WAVM_PERF_MAP")) {
+        LLVMJIT::setPerfMapEnabled(true);
+    }
+
+    // Cache the compiled object code on disk if requested by the environment.
+    const char *objectCacheDirectory = getenv("WAVM_OBJECT_CACHE_DIR");
+    if (objectCacheDirectory) {
+        Runtime::setObjectCacheDirectory(objectCacheDirectory);
+    }
+
+    return Runtime::compileModule(irModule, compileOptions);
+}
+
+static int precompile(const char *filename, const char *outputFilename, const LLVMJIT::CompileOptions &compileOptions) {
+    Runtime::ModuleRef module = loadModule(filename, compileOptions);
+    if (!module) {
+        return EXIT_FAILURE;
+    }
+
+    Serialization::ArrayOutputStream stream;
+    Runtime::saveCompiledModule(module, stream);
+    return writeFile(outputFilename, stream.getBytes()) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// Reads a layout profile written by writeLayoutProfile: the number of calls to each function
+// definition, one per line.
+static bool readLayoutProfile(const char *filename, std::vector<U64> &outCallCounts) {
+    FILE *file = fopen(filename, "r");
+    if (!file) {
+        std::cout << "Couldn't open file: " << filename << std::endl;
+        return false;
+    }
+    U64 numCalls;
+    while (fscanf(file, "%" SCNu64, &numCalls) == 1) {
+        outCallCounts.push_back(numCalls);
+    }
+    const bool succeeded = feof(file) != 0;
+    fclose(file);
+    if (!succeeded) {
+        std::cout << "Error parsing layout profile: " << filename << std::endl;
+    }
+    return succeeded;
+}
+
+static bool writeLayoutProfile(const char *filename, ModuleInstance *moduleInstance) {
+    std::string profile;
+    for (const Runtime::FunctionCallCounts &counts : Runtime::getFunctionCallCounts(moduleInstance)) {
+        profile += std::to_string(counts.numCalls);
+        profile += '\n';
+    }
+    return writeFile(filename, std::vector<U8>(profile.begin(), profile.end()));
+}
+
+static bool readPGOProfile(const char *filename, LLVMJIT::CompileOptions &compileOptions) {
+    std::vector<U8> profileBytes;
+    if (!readFile(filename, profileBytes)) {
+        return false;
+    }
+    std::shared_ptr<LLVMJIT::ModuleProfile> profile = std::make_shared<LLVMJIT::ModuleProfile>();
+    try {
+        Serialization::MemoryInputStream stream(profileBytes.data(), profileBytes.size());
+        Runtime::loadModuleProfile(stream, *profile);
+    } catch (const Serialization::FatalSerializationException &exception) {
+        std::cout << "Error loading profile: " << exception.message << std::endl;
+        return false;
+    }
+    compileOptions.profile = profile;
+    return true;
+}
+
+static bool writePGOProfile(const char *filename, ModuleInstance *moduleInstance) {
+    Serialization::ArrayOutputStream stream;
+    Runtime::saveModuleProfile(Runtime::getModuleProfile(moduleInstance), stream);
+    return writeFile(filename, stream.getBytes());
+}
+
+// The number of functions --compile-stats reports.
+static constexpr Uptr maxReportedCompileStats = 20;
+
+// Compiles a module without running it, and prints the time each phase of the compile took and the
+// function definitions that took the longest to compile.
+static int reportCompileStats(const char *filename, const LLVMJIT::CompileOptions &compileOptions) {
+    ModuleFileBytes fileBytes;
+    if (!mapModuleFile(filename, fileBytes)) {
+        return EXIT_FAILURE;
+    }
+    if (Runtime::isPrecompiledModule(fileBytes.data, fileBytes.numBytes)) {
+        std::cout << "--compile-stats can't be used with a precompiled module\n";
+        return EXIT_FAILURE;
+    }
+    IR::Module irModule;
+    if (!parseModuleFile(fileBytes, irModule)) {
+        return EXIT_FAILURE;
+    }
+
+    LLVMJIT::CompileStats stats;
+    const U64 startTime = Platform::getMonotonicClock();
+    const std::vector<U8> objectCode = LLVMJIT::compileModule(irModule, compileOptions, &stats);
+    const U64 compileMicroseconds = Platform::getMonotonicClock() - startTime;
+
+    // The emit, optimize and machine code times are summed over the compile threads, so they may
+    // add up to more than the elapsed time.
+    std::cout << "Compiled " << stats.functionDefs.size() << " functions to " << objectCode.size() << " bytes of object code in "
+              << compileMicroseconds << "us\n"
+              << "  Emit IR:           " << stats.emitMicroseconds << "us\n"
+              << "  Optimize IR:       " << stats.optimizeMicroseconds << "us\n"
+              << "  Emit machine code: " << stats.machineCodeMicroseconds << "us\n";
+
+    // Rank the function definitions by the time spent emitting and optimizing them. The time spent
+    // in module passes and emitting machine code isn't attributed to functions.
+    std::vector<Uptr> functionDefIndices;
+    for (Uptr functionDefIndex = 0; functionDefIndex < stats.functionDefs.size(); ++functionDefIndex) {
+        functionDefIndices.push_back(functionDefIndex);
+    }
+    auto getFunctionMicroseconds = [&stats](Uptr functionDefIndex) {
+        return stats.functionDefs[functionDefIndex].emitMicroseconds + stats.functionDefs[functionDefIndex].optimizeMicroseconds;
+    };
+    std::sort(functionDefIndices.begin(), functionDefIndices.end(), [&](Uptr a, Uptr b) {
+        return getFunctionMicroseconds(a) > getFunctionMicroseconds(b);
+    });
+
+    IR::DisassemblyNames disassemblyNames;
+    IR::getDisassemblyNames(irModule, disassemblyNames);
+
+    std::cout << "Emit us\tOptimize us\tIR instructions\tOptimized instructions\tMachine code bytes\tFunction\n";
+    for (Uptr index = 0; index < functionDefIndices.size() && index < maxReportedCompileStats; ++index) {
+        const Uptr functionDefIndex = functionDefIndices[index];
+        const LLVMJIT::FunctionCompileStats &functionStats = stats.functionDefs[functionDefIndex];
+        const Uptr functionIndex = irModule.functions.imports.size() + functionDefIndex;
+        std::string name = functionIndex < disassemblyNames.functions.size() ? disassemblyNames.functions[functionIndex].name : "";
+        if (name.empty()) {
+            name = "<function def " + std::to_string(functionDefIndex) + ">";
+        }
+        std::cout << functionStats.emitMicroseconds << '\t' << functionStats.optimizeMicroseconds << '\t' << functionStats.numEmittedInstructions
+                  << '\t' << functionStats.numOptimizedInstructions << '\t' << functionStats.numMachineCodeBytes << '\t' << name << '\n';
+    }
+    return EXIT_SUCCESS;
+}
+
+static void reportTrap(const Trap &trap) {
+    const char *functionName = trap.function ? trap.function->mutableData->debugName.c_str() : "<unknown function>";
+    switch (trap.type) {
+        case Trap::Type::outOfBoundsMemoryAccess:
+            std::cerr << "Runtime trap: out of bounds memory access at address " << trap.memoryAddress << " in "
+                      << functionName << std::endl;
+            break;
+        case Trap::Type::stackOverflow:
+            std::cerr << "Runtime trap: stack overflow in " << functionName << std::endl;
+            break;
+        case Trap::Type::integerDivideByZeroOrOverflow:
+            std::cerr << "Runtime trap: integer divide by zero or overflow in " << functionName << std::endl;
+            break;
+        case Trap::Type::unreachable:
+            std::cerr << "Runtime trap: reached unreachable code in " << functionName << std::endl;
+            break;
+        case Trap::Type::invalidFloatOperation:
+            std::cerr << "Runtime trap: invalid conversion to integer in " << functionName << std::endl;
+            break;
+        case Trap::Type::invalidIndirectCall:
+            std::cerr << "Runtime trap: call_indirect of an out of bounds or uninitialized table element, or a function of the wrong type, in " << functionName << std::endl;
+            break;
+        case Trap::Type::misalignedAtomicMemoryAccess:
+            std::cerr << "Runtime trap: misaligned atomic memory access in " << functionName << std::endl;
+            break;
+        case Trap::Type::outOfBoundsTableAccess:
+            std::cerr << "Runtime trap: out of bounds table access in " << functionName << std::endl;
+            break;
+        case Trap::Type::outOfFuel:
+            std::cerr << "Runtime trap: ran out of fuel in " << functionName << std::endl;
+            break;
+        default:
+            Errors::unreachable();
+    };
+}
+
+// The number of functions --call-counts reports.
+static constexpr Uptr maxReportedCallCounts = 20;
+
+// Prints the functions of a module instance with the most inclusive time, or the most calls if the
+// calls weren't timed.
+static void reportCallCounts(ModuleInstance *moduleInstance, bool isTimed) {
+    std::vector<Runtime::FunctionCallCounts> callCounts = Runtime::getFunctionCallCounts(moduleInstance);
+    std::sort(callCounts.begin(), callCounts.end(), [isTimed](const Runtime::FunctionCallCounts &a, const Runtime::FunctionCallCounts &b) {
+        return isTimed ? a.inclusiveTicks > b.inclusiveTicks : a.numCalls > b.numCalls;
+    });
+
+    std::cerr << "Calls\tInclusive ticks\tFunction\n";
+    for (Uptr index = 0; index < callCounts.size() && index < maxReportedCallCounts && callCounts[index].numCalls; ++index) {
+        const Runtime::FunctionCallCounts &counts = callCounts[index];
+        std::cerr << counts.numCalls << '\t' << counts.inclusiveTicks << '\t' << counts.debugName << '\n';
     }
+}
 
-    Runtime::ModuleRef module = Runtime::compileModule(irModule);
+static int run(const char *filename, char **args, const LLVMJIT::CompileOptions &compileOptions) {
+    Runtime::ModuleRef module = loadModule(filename, compileOptions);
+    if (!module) {
+        return EXIT_FAILURE;
+    }
+    const IR::Module &irModule = Runtime::getModuleIR(module);
 
     Compartment *compartment = Runtime::createCompartment();
     Context *context = Runtime::createContext(compartment);
@@ -149,8 +479,8 @@ static int run(const char *filename, char **args) {
 
     // Call the module start function, if it has one.
     Function *startFunction = getStartFunction(moduleInstance);
-    if (startFunction) {
-        invokeFunctionChecked(context, startFunction, {});
+    if (startFunction && catchTraps([&] { invokeFunctionChecked(context, startFunction, {}); }, reportTrap)) {
+        return EXIT_FAILURE;
     }
 
     // Call the Emscripten global initalizers.
@@ -185,7 +515,38 @@ static int run(const char *filename, char **args) {
         return EXIT_FAILURE;
     }
 
-    IR::ValueTuple functionResults = invokeFunctionChecked(context, function, invokeArgs);
+    IR::ValueTuple functionResults;
+    const bool trapped = catchTraps([&] {
+        functionResults = invokeFunctionChecked(context, function, invokeArgs);
+    }, [&](const Trap &trap) {
+        // Write out the program's buffered output before the trap is reported.
+        if (emscriptenInstance) {
+            Emscripten::flushOutput(emscriptenInstance);
+        }
+        reportTrap(trap);
+    });
+    if (emscriptenInstance) {
+        Emscripten::flushOutput(emscriptenInstance);
+    }
+    if (trapped) {
+        return EXIT_FAILURE;
+    }
+
+    // Report the fuel used by the program, which starts with INT64_MAX fuel.
+    if (compileOptions.enableFuelMetering) {
+        std::cerr << "Executed " << (INT64_MAX - getFuel(context)) << " metered operators\n";
+    }
+
+    if (pgoProfileOutputFilename && !writePGOProfile(pgoProfileOutputFilename, moduleInstance)) {
+        return EXIT_FAILURE;
+    }
+    if (layoutProfileOutputFilename) {
+        if (!writeLayoutProfile(layoutProfileOutputFilename, moduleInstance)) {
+            return EXIT_FAILURE;
+        }
+    } else if (compileOptions.enableCallCounters) {
+        reportCallCounts(moduleInstance, compileOptions.enableCallTiming);
+    }
 
     if (functionResults.size() == 1 && functionResults[0].type == ValueType::i32) {
         return functionResults[0].i32;
@@ -194,11 +555,371 @@ static int run(const char *filename, char **args) {
     }
 }
 
+// The phases of running a program that --bench times separately.
+enum class BenchmarkPhase {
+    parse,
+    validate,
+    compile,
+    link,
+    instantiate,
+    invoke,
+    num
+};
+
+static const char *const benchmarkPhaseNames[] = {"parse", "validate", "compile", "link", "instantiate", "invoke"};
+
+// Returns the sample at the given percentile of the sorted samples, by the nearest-rank method.
+static U64 getPercentile(const std::vector<U64> &sortedSamples, Uptr percentile) {
+    wavmAssert(sortedSamples.size());
+    Uptr rank = (sortedSamples.size() * percentile + 99) / 100;
+    return sortedSamples[rank ? rank - 1 : 0];
+}
+
+// Returns the peak resident set size of the process in bytes.
+static U64 getPeakResidentSetSize() {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage)) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return U64(usage.ru_maxrss);
+#else
+    return U64(usage.ru_maxrss) * 1024;
+#endif
+}
+
+// Runs the program numIterations times, each time parsing, validating, compiling, linking,
+// instantiating and invoking it from scratch, and prints the minimum, median and 99th percentile
+// time of each phase, as text and, if jsonFilename is non-null, as JSON to that file. Parsing a
+// binary module validates it as it is decoded, so the validate phase times validating the parsed
+// module again by itself.
+static int bench(const char *filename, char **args, const LLVMJIT::CompileOptions &compileOptions, Uptr numIterations, const char *jsonFilename) {
+    ModuleFileBytes fileBytes;
+    if (!mapModuleFile(filename, fileBytes)) {
+        return EXIT_FAILURE;
+    }
+    if (Runtime::isPrecompiledModule(fileBytes.data, fileBytes.numBytes)) {
+        std::cout << "--bench can't be used with a precompiled module\n";
+        return EXIT_FAILURE;
+    }
+
+    std::vector<U64> phaseMicroseconds[Uptr(BenchmarkPhase::num)];
+    Uptr numObjectCodeBytes = 0;
+    for (Uptr iterationIndex = 0; iterationIndex < numIterations; ++iterationIndex) {
+        U64 phaseStartTime = Platform::getMonotonicClock();
+        auto endPhase = [&](BenchmarkPhase phase) {
+            const U64 phaseEndTime = Platform::getMonotonicClock();
+            phaseMicroseconds[Uptr(phase)].push_back(phaseEndTime - phaseStartTime);
+            phaseStartTime = phaseEndTime;
+        };
+
+        IR::Module irModule;
+        if (!parseModuleFile(fileBytes, irModule)) {
+            return EXIT_FAILURE;
+        }
+        endPhase(BenchmarkPhase::parse);
+
+        try {
+            IR::DeferredCodeValidationState deferredCodeValidationState;
+            IR::validatePreCodeSections(irModule);
+            IR::validateFunctionDefs(irModule, deferredCodeValidationState);
+            IR::validatePostCodeSections(irModule, deferredCodeValidationState);
+        } catch (const IR::ValidationException &exception) {
+            std::cout << "Error validating module: " << exception.message << std::endl;
+            return EXIT_FAILURE;
+        }
+        endPhase(BenchmarkPhase::validate);
+
+        // The previous iteration's module has been destroyed, so this compiles the module again
+        // instead of returning it from the in-process module cache.
+        Runtime::ModuleRef module = Runtime::compileModule(irModule, compileOptions);
+        numObjectCodeBytes = Runtime::getModuleObjectCodeSize(module);
+        endPhase(BenchmarkPhase::compile);
+
+        Compartment *compartment = Runtime::createCompartment();
+        Context *context = Runtime::createContext(compartment);
+        RootResolver rootResolver(compartment);
+        Emscripten::Instance *emscriptenInstance = Emscripten::instantiate(compartment, irModule);
+        if (emscriptenInstance) {
+            rootResolver.moduleNameToInstanceMap.set("env", emscriptenInstance->env);
+            rootResolver.moduleNameToInstanceMap.set("asm2wasm", emscriptenInstance->asm2wasm);
+        }
+        LinkResult linkResult = linkModule(irModule, rootResolver);
+        if (!linkResult.success) {
+            std::cout << "Failed to link module\n";
+            return EXIT_FAILURE;
+        }
+        endPhase(BenchmarkPhase::link);
+
+        ModuleInstance *moduleInstance = instantiateModule(compartment, module, std::move(linkResult.resolvedImports), filename);
+        if (!moduleInstance) {
+            return EXIT_FAILURE;
+        }
+        Function *startFunction = getStartFunction(moduleInstance);
+        if (startFunction && catchTraps([&] { invokeFunctionChecked(context, startFunction, {}); }, reportTrap)) {
+            return EXIT_FAILURE;
+        }
+        Emscripten::initializeGlobals(context, irModule, moduleInstance);
+        endPhase(BenchmarkPhase::instantiate);
+
+        Function *function = asFunctionNullable(getInstanceExport(moduleInstance, "main"));
+        if (!function) {
+            function = asFunctionNullable(getInstanceExport(moduleInstance, "_main"));
+        }
+        if (function) {
+            std::vector<Value> invokeArgs;
+            if (getFunctionType(function).params().size() == 2 && emscriptenInstance) {
+                std::vector<const char *> argStrings;
+                argStrings.push_back(filename);
+                for (char **arg = args; *arg; ++arg) {
+                    argStrings.push_back(*arg);
+                }
+                Emscripten::injectCommandArgs(emscriptenInstance, argStrings, invokeArgs);
+            }
+            const bool trapped = catchTraps([&] { invokeFunctionChecked(context, function, invokeArgs); }, reportTrap);
+            if (emscriptenInstance) {
+                Emscripten::flushOutput(emscriptenInstance);
+            }
+            if (trapped) {
+                return EXIT_FAILURE;
+            }
+        }
+        endPhase(BenchmarkPhase::invoke);
+
+        // Release the iteration's objects and free its compartment, so the next iteration doesn't
+        // reuse them, and the iterations' compartments don't accumulate.
+        delete emscriptenInstance;
+        module.reset();
+        errorUnless(Runtime::tryCollectCompartment(compartment));
+    }
+
+    const U64 peakResidentSetSize = getPeakResidentSetSize();
+
+    std::cout << "phase        min(us)   median(us)   p99(us)\n";
+    std::string json = "{\"iterations\":" + std::to_string(numIterations) + ",\"phases\":{";
+    for (Uptr phaseIndex = 0; phaseIndex < Uptr(BenchmarkPhase::num); ++phaseIndex) {
+        std::vector<U64> &samples = phaseMicroseconds[phaseIndex];
+        std::sort(samples.begin(), samples.end());
+        const U64 minMicroseconds = samples.front();
+        const U64 medianMicroseconds = getPercentile(samples, 50);
+        const U64 p99Microseconds = getPercentile(samples, 99);
+
+        char line[128];
+        snprintf(line, sizeof(line), "%-12s %-9" PRIu64 " %-12" PRIu64 " %" PRIu64 "\n", benchmarkPhaseNames[phaseIndex], minMicroseconds, medianMicroseconds, p99Microseconds);
+        std::cout << line;
+
+        json += std::string(phaseIndex ? "," : "") + "\"" + benchmarkPhaseNames[phaseIndex] + "\":{\"min_us\":" +
+                std::to_string(minMicroseconds) + ",\"median_us\":" + std::to_string(medianMicroseconds) +
+                ",\"p99_us\":" + std::to_string(p99Microseconds) + "}";
+    }
+    json += "},\"peak_rss_bytes\":" + std::to_string(peakResidentSetSize) + ",\"object_code_bytes\":" +
+            std::to_string(numObjectCodeBytes) + "}\n";
+    std::cout << "peak RSS: " << peakResidentSetSize << " bytes\n"
+              << "object code: " << numObjectCodeBytes << " bytes\n";
+
+    if (jsonFilename && !writeFile(jsonFilename, std::vector<U8>(json.begin(), json.end()))) {
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+static bool parseOptimizationLevel(const char *arg, LLVMJIT::OptimizationLevel &outLevel) {
+    if (!strcmp(arg, "-O0")) {
+        outLevel = LLVMJIT::OptimizationLevel::O0;
+    } else if (!strcmp(arg, "-O1")) {
+        outLevel = LLVMJIT::OptimizationLevel::O1;
+    } else if (!strcmp(arg, "-O2")) {
+        outLevel = LLVMJIT::OptimizationLevel::O2;
+    } else if (!strcmp(arg, "-O3")) {
+        outLevel = LLVMJIT::OptimizationLevel::O3;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+static int runWithProfiler(const char *filename, char **args, const LLVMJIT::CompileOptions &compileOptions, const char *profileFilename) {
+    if (!Runtime::Profiler::start()) {
+        std::cout << "Sampling profiler isn't supported on this platform" << std::endl;
+        return EXIT_FAILURE;
+    }
+    const int result = run(filename, args, compileOptions);
+    Runtime::Profiler::stop();
+
+    FILE *profileFile = fopen(profileFilename, "wb");
+    if (!profileFile) {
+        std::cout << "Couldn't write profile to " << profileFilename << std::endl;
+        return EXIT_FAILURE;
+    }
+    const std::string collapsedStacks = Runtime::Profiler::getCollapsedStacks();
+    fwrite(collapsedStacks.data(), 1, collapsedStacks.size(), profileFile);
+    fclose(profileFile);
+
+    std::cerr << "Profile: " << Runtime::Profiler::getNumSamples() << " samples, " << Runtime::Profiler::getNumDroppedSamples() << " dropped" << std::endl;
+    return result;
+}
+
 int main(int argc, char **argv) {
+    LLVMJIT::CompileOptions compileOptions;
+    LLVMJIT::OptimizationLevel optimizationLevel = compileOptions.optimizationLevel;
+    bool hasOptimizationLevel = false;
+    bool enableTierUp = false;
+    Uptr numBenchmarkIterations = 0;
+    const char *benchmarkJSONFilename = nullptr;
+    const char *profileFilename = nullptr;
+    while (argc >= 2) {
+        if (parseOptimizationLevel(argv[1], optimizationLevel)) {
+            hasOptimizationLevel = true;
+        } else if (!strcmp(argv[1], "--tier-up")) {
+            enableTierUp = true;
+        } else if (!strcmp(argv[1], "--lazy")) {
+            compileOptions.enableLazyCompilation = true;
+        } else if (!strcmp(argv[1], "--interpret")) {
+            compileOptions.enableInterpreter = true;
+        } else if (!strcmp(argv[1], "--bounded-memories")) {
+            compileOptions.explicitMemoryBoundsChecks = true;
+        } else if (!strcmp(argv[1], "--non-volatile-memory")) {
+            compileOptions.nonVolatileMemoryAccesses = true;
+        } else if (!strcmp(argv[1], "--interrupt-checks")) {
+            compileOptions.enableInterruptChecks = true;
+        } else if (!strcmp(argv[1], "--fuel")) {
+            compileOptions.enableFuelMetering = true;
+        } else if (!strcmp(argv[1], "--call-counts")) {
+            compileOptions.enableCallCounters = true;
+            compileOptions.enableCallTiming = true;
+        } else if (!strcmp(argv[1], "--write-layout-profile") && argc >= 3) {
+            layoutProfileOutputFilename = argv[2];
+            compileOptions.enableCallCounters = true;
+            --argc;
+            ++argv;
+        } else if (!strcmp(argv[1], "--layout-profile") && argc >= 3) {
+            if (!readLayoutProfile(argv[2], compileOptions.functionDefCallCounts)) {
+                return EXIT_FAILURE;
+            }
+            --argc;
+            ++argv;
+        } else if (!strcmp(argv[1], "--write-pgo-profile") && argc >= 3) {
+            pgoProfileOutputFilename = argv[2];
+            compileOptions.enableProfileCounters = true;
+            --argc;
+            ++argv;
+        } else if (!strcmp(argv[1], "--pgo-profile") && argc >= 3) {
+            if (!readPGOProfile(argv[2], compileOptions)) {
+                return EXIT_FAILURE;
+            }
+            --argc;
+            ++argv;
+        } else if (!strcmp(argv[1], "--streaming")) {
+            useStreamingCompile = true;
+        } else if (!strcmp(argv[1], "--no-debug-names")) {
+            Runtime::setDebugNamesEnabled(false);
+        } else if (!strcmp(argv[1], "--bench") && argc >= 3 && atoi(argv[2]) > 0) {
+            numBenchmarkIterations = Uptr(atoi(argv[2]));
+            --argc;
+            ++argv;
+        } else if (!strcmp(argv[1], "--bench-json") && argc >= 3) {
+            benchmarkJSONFilename = argv[2];
+            --argc;
+            ++argv;
+        } else if (!strcmp(argv[1], "--profile") && argc >= 3) {
+            profileFilename = argv[2];
+            compileOptions.enableFramePointers = true;
+            --argc;
+            ++argv;
+        } else {
+            break;
+        }
+        --argc;
+        ++argv;
+    }
+
+    if (enableTierUp) {
+        // With tier-up, functions are compiled quickly at first, and hot functions are recompiled
+        // at the requested optimization level.
+        compileOptions.optimizationLevel = LLVMJIT::OptimizationLevel::O0;
+        compileOptions.enableTierUp = true;
+        if (hasOptimizationLevel) {
+            compileOptions.tierUpOptimizationLevel = optimizationLevel;
+        }
+    } else {
+        compileOptions.optimizationLevel = optimizationLevel;
+    }
+    if (compileOptions.enableInterpreter && hasOptimizationLevel) {
+        // Interpreted functions are compiled at the requested optimization level once they are hot.
+        compileOptions.tierUpOptimizationLevel = optimizationLevel;
+    }
+
     if (argc < 2) {
-        std::cout << "Usage: run [programfile] [--] [arguments]\n"
-                     "  -h|--help             Display this message\n";
+        std::cout << "Usage: run [options] [programfile] [--] [arguments]\n"
+                     "       run [options] --precompile [programfile] [outputfile]\n"
+                     "       run [options] --compile-stats [programfile]\n"
+                     "  -h|--help             Display this message\n"
+                     "  -O0|-O1|-O2|-O3       Optimization level to compile the program at (default -O1)\n"
+                     "  --tier-up             Compile the program at -O0, and recompile hot functions in\n"
+                     "                        the background at the -O level (default -O2)\n"
+                     "  --lazy                Compile each of the program's functions the first time it\n"
+                     "                        is called\n"
+                     "  --interpret           Interpret the program's functions, and compile hot functions\n"
+                     "                        at the -O level (default -O2)\n"
+                     "  --bounded-memories    Bounds check memory accesses, so the program's memories only\n"
+                     "                        reserve address space for their maximum size\n"
+                     "  --non-volatile-memory Let LLVM optimize memory accesses, at the cost of eliding\n"
+                     "                        some out-of-bounds traps\n"
+                     "  --interrupt-checks    Check for interrupt requests on function entry and loop\n"
+                     "                        back-edges\n"
+                     "  --fuel                Count the operators the program executes, and print the\n"
+                     "                        count when it exits\n"
+                     "  --call-counts         Count the calls to and time spent in each of the program's\n"
+                     "                        functions, and print the top functions when it exits\n"
+                     "  --write-layout-profile <file>\n"
+                     "                        Count the calls to each of the program's functions, and\n"
+                     "                        write the counts to a file when it exits\n"
+                     "  --layout-profile <file>\n"
+                     "                        Lay out the program's code with the most called functions\n"
+                     "                        first, and the functions that weren't called last\n"
+                     "  --write-pgo-profile <file>\n"
+                     "                        Count how the program's branches and indirect calls are\n"
+                     "                        executed, and write the profile to a file when it exits\n"
+                     "  --pgo-profile <file>  Optimize the program's code for the profile in a file\n"
+                     "                        written by --write-pgo-profile\n"
+                     "  --streaming           Compile the program's functions in the background while\n"
+                     "                        reading the rest of its WebAssembly binary file\n"
+                     "  --no-debug-names      Don't give the program's functions names from its name\n"
+                     "                        section\n"
+                     "  --precompile          Compile the program to an artifact that run can load\n"
+                     "                        without parsing or compiling it again\n"
+                     "  --compile-stats       Compile the program without running it, and print the time\n"
+                     "                        each phase took and the functions that took the longest\n"
+                     "  --bench N             Parse, validate, compile, link, instantiate and run the\n"
+                     "                        program N times, and print the time each phase took\n"
+                     "  --bench-json <file>   Also write the --bench results to a file as JSON\n"
+                     "  --profile <file>      Sample the program's call stacks 100 times per second, and\n"
+                     "                        write them to a file in the collapsed stack format read by\n"
+                     "                        flamegraph.pl\n"
+                     "Environment variables:\n"
+                     "  WAVM_OBJECT_CACHE_DIR Directory to cache compiled object code in\n"
+                     "  WAVM_PERF_MAP         Write /tmp/perf-<pid>.map for profiling with Linux perf\n";
         return EXIT_FAILURE;
     }
-    return run(argv[1], argv + 2);
+    if (!strcmp(argv[1], "--precompile")) {
+        if (argc != 4) {
+            std::cout << "Usage: run [options] --precompile [programfile] [outputfile]\n";
+            return EXIT_FAILURE;
+        }
+        return precompile(argv[2], argv[3], compileOptions);
+    }
+    if (!strcmp(argv[1], "--compile-stats")) {
+        if (argc != 3) {
+            std::cout << "Usage: run [options] --compile-stats [programfile]\n";
+            return EXIT_FAILURE;
+        }
+        return reportCompileStats(argv[2], compileOptions);
+    }
+    if (numBenchmarkIterations) {
+        return bench(argv[1], argv + 2, compileOptions, numBenchmarkIterations, benchmarkJSONFilename);
+    }
+    if (profileFilename) {
+        return runWithProfiler(argv[1], argv + 2, compileOptions, profileFilename);
+    }
+    return run(argv[1], argv + 2, compileOptions);
 }